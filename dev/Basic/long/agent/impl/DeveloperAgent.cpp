@@ -30,12 +30,15 @@
 #include "behavioral/PredayLT_Logsum.hpp"
 #include "util/SharedFunctions.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 #include <random>
 
 using namespace sim_mob::long_term;
 using namespace sim_mob::event;
 using namespace sim_mob::messaging;
 using sim_mob::Entity;
+using sim_mob::RandomService;
+using sim_mob::RandomStream;
 using std::vector;
 using std::string;
 using std::map;
@@ -639,8 +642,7 @@ inline void createPotentialUnits(PotentialProject& project,const DeveloperModel*
                     }
 
                     //generate a uniformly distributed random number
-                    std::random_device rd;
-                    std::mt19937 gen(rd());
+                    RandomStream& gen = RandomService::current();
                     std::uniform_real_distribution<> dis(0.0, 1.0);
                     const double randomNum = dis(gen);
                     double pTemp = 0.0;
@@ -800,7 +802,7 @@ void DeveloperAgent::createUnitsAndBuildings(PotentialProject &project,BigSerial
             if ((*itr)->getFmParcelId() == parcel->getId()) {
                 BigSerial buildingId = (*itr)->getFmBuildingId();
                 toBeDemolishedBuildingIds.push_back((*itr)->getFmBuildingId());
-                MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_DEMOLISHED, MessageBus::MessagePtr(new DEV_InternalMsg(buildingId,futureDemolitionDate)), true);
+                MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_DEMOLISHED, MessageBus::MakeMessage<DEV_InternalMsg>(buildingId,futureDemolitionDate), true);
                 //TODO- add demolished building id's to each agent and use it within the agent
 
             }
@@ -815,7 +817,7 @@ void DeveloperAgent::createUnitsAndBuildings(PotentialProject &project,BigSerial
     std::tm toDate = getDateBySimDay(simYear,(currentTick+180));
     boost::shared_ptr<Building>building(new Building(buildingId,projectId,parcel->getId(),0,0,currentDate,toDate,BUILDING_UNCOMPLETED_WITHOUT_PREREQUISITES,project.getGrosArea(),0,0,0,0,0,0,toDate,0,0,std::string()));
     newBuildings.push_back(building);
-    MessageBus::PostMessage(this, LT_DEV_BUILDING_ADDED, MessageBus::MessagePtr(new DEV_InternalMsg(*building.get())), true);
+    MessageBus::PostMessage(this, LT_DEV_BUILDING_ADDED, MessageBus::MakeMessage<DEV_InternalMsg>(*building.get()), true);
 
     //create new units and add all the units to the newly created building.
     std::vector<PotentialUnit> units = project.getUnits();
@@ -833,7 +835,7 @@ void DeveloperAgent::createUnitsAndBuildings(PotentialProject &project,BigSerial
             double demolitionCost = (*unitsItr).getDemolitionCostPerUnit();
             int quarter = ((currentDate.tm_mon)/3) + 1; //get the current month of the simulation and divide it by 3 to determine the quarter
             writeUnitDataToFile(*unit, profit,parcel->getId(),demolitionCost,quarter);
-            MessageBus::PostMessage(this, LT_DEV_UNIT_ADDED, MessageBus::MessagePtr(new DEV_InternalMsg(*unit.get())), true);
+            MessageBus::PostMessage(this, LT_DEV_UNIT_ADDED, MessageBus::MakeMessage<DEV_InternalMsg>(*unit.get()), true);
         }
 
     }
@@ -857,7 +859,7 @@ void DeveloperAgent::createProject(PotentialProject &project, BigSerial projectI
     boost::shared_ptr<Project>fmProject(new Project(projectId,parcel->getId(),INVALID_ID,project.getDevTemplate()->getTemplateId(),EMPTY_STR,constructionDate,completionDate,constructionCost,demolitionCost,totalCost,fmLotSize,grossRatio,grossArea,0,constructionDate,projectStatus));
     writeProjectDataToFile(fmProject);
     this->fmProject = fmProject;
-    MessageBus::PostMessage(this, LT_DEV_PROJECT_ADDED, MessageBus::MessagePtr(new DEV_InternalMsg()), true);
+    MessageBus::PostMessage(this, LT_DEV_PROJECT_ADDED, MessageBus::MakeMessage<DEV_InternalMsg>(), true);
 
 }
 
@@ -876,13 +878,13 @@ void DeveloperAgent::processExistingProjects()
         for(buildingsItr = this->newBuildings.begin(); buildingsItr != this->newBuildings.end(); buildingsItr++)
         {
             (*buildingsItr)->setBuildingStatus(BUILDING_UNCOMPLETED_WITH_PREREQUISITES);
-            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_UNCOMPLETED_WITH_PREREQUISITES,MessageBus::MessagePtr(new DEV_InternalMsg((*buildingsItr)->getFmBuildingId(),std::tm())), true);
+            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_UNCOMPLETED_WITH_PREREQUISITES,MessageBus::MakeMessage<DEV_InternalMsg>((*buildingsItr)->getFmBuildingId(),std::tm()), true);
         }
 
         for(unitsItr = this->newUnits.begin(); unitsItr != this->newUnits.end(); unitsItr++)
         {
             (*unitsItr)->setConstructionStatus(UNIT_UNDER_CONSTRUCTION);
-            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_UNIT_UNDER_CONSTRUCTION,MessageBus::MessagePtr(new DEV_InternalMsg((*unitsItr)->getId())), true);
+            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_UNIT_UNDER_CONSTRUCTION,MessageBus::MakeMessage<DEV_InternalMsg>((*unitsItr)->getId()), true);
         }
         break;
     }
@@ -891,13 +893,13 @@ void DeveloperAgent::processExistingProjects()
         for(buildingsItr = this->newBuildings.begin(); buildingsItr != this->newBuildings.end(); buildingsItr++)
         {
             (*buildingsItr)->setBuildingStatus(BUILDING_NOT_LAUNCHED);
-            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_NOT_LAUNCHED,MessageBus::MessagePtr(new DEV_InternalMsg((*buildingsItr)->getFmBuildingId(),std::tm())), true);
+            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_NOT_LAUNCHED,MessageBus::MakeMessage<DEV_InternalMsg>((*buildingsItr)->getFmBuildingId(),std::tm()), true);
         }
 
         for(unitsItr = this->newUnits.begin(); unitsItr != this->newUnits.end(); unitsItr++)
         {
             (*unitsItr)->setConstructionStatus(UNIT_CONSTRUCTION_COMPLETED);
-            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_UNIT_CONSTRUCTION_COMPLETED,MessageBus::MessagePtr(new DEV_InternalMsg((*unitsItr)->getId())), true);
+            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_UNIT_CONSTRUCTION_COMPLETED,MessageBus::MakeMessage<DEV_InternalMsg>((*unitsItr)->getId()), true);
         }
         break;
     }
@@ -907,7 +909,7 @@ void DeveloperAgent::processExistingProjects()
         {
             //building launched message will be sent when at least a single unit of the building is launched for sale.
             (*buildingsItr)->setBuildingStatus(BUILDING_LAUNCHED_BUT_UNSOLD);
-            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_LAUNCHED_BUT_UNSOLD,MessageBus::MessagePtr(new DEV_InternalMsg((*buildingsItr)->getFmBuildingId(),std::tm())), true);
+            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_BUILDING_LAUNCHED_BUT_UNSOLD,MessageBus::MakeMessage<DEV_InternalMsg>((*buildingsItr)->getFmBuildingId(),std::tm()), true);
         }
             if(unitsRemain)
             {
@@ -925,8 +927,8 @@ void DeveloperAgent::processExistingProjects()
                 {
                     (*unitsItr)->setSaleStatus(UNIT_LAUNCHED_BUT_UNSOLD);
                     (*unitsItr)->setOccupancyStatus(UNIT_READY_FOR_OCCUPANCY_AND_VACANT);
-                    MessageBus::PostMessage(this, LT_STATUS_ID_DEV_NEW_UNIT_LAUNCHED_BUT_UNSOLD,MessageBus::MessagePtr(new DEV_InternalMsg((*unitsItr)->getId())), true);
-                    MessageBus::PostMessage(this, LT_STATUS_ID_DEV_UNIT_READY_FOR_OCCUPANCY_AND_VACANT,MessageBus::MessagePtr(new DEV_InternalMsg((*unitsItr)->getId())), true);
+                    MessageBus::PostMessage(this, LT_STATUS_ID_DEV_NEW_UNIT_LAUNCHED_BUT_UNSOLD,MessageBus::MakeMessage<DEV_InternalMsg>((*unitsItr)->getId()), true);
+                    MessageBus::PostMessage(this, LT_STATUS_ID_DEV_UNIT_READY_FOR_OCCUPANCY_AND_VACANT,MessageBus::MakeMessage<DEV_InternalMsg>((*unitsItr)->getId()), true);
                 }
 
             }
@@ -970,7 +972,7 @@ void DeveloperAgent::launchBTOUnits(std::tm currentDate)
     std::vector<BigSerial>  btoUnits = devModel->getBTOUnits(currentDate);
     if(btoUnits.size()>0)
     {
-        MessageBus::PostMessage(realEstateAgent, LT_DEV_BTO_UNIT_ADDED, MessageBus::MessagePtr(new HM_ActionMessage((btoUnits))), true);
+        MessageBus::PostMessage(realEstateAgent, LT_DEV_BTO_UNIT_ADDED, MessageBus::MakeMessage<HM_ActionMessage>((btoUnits)), true);
     }
 }
 
@@ -1030,7 +1032,7 @@ void DeveloperAgent::HandleMessage(Message::MessageType type, const Message& mes
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
                     boost::shared_ptr<Unit> newUnit = boost::make_shared<Unit>(*(devArgs.getUnit()));
                     devModel->addNewUnits(newUnit);
-                    MessageBus::PostMessage(realEstateAgent, LTEID_HM_UNIT_ADDED, MessageBus::MessagePtr(new HM_ActionMessage((*devArgs.getUnit()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LTEID_HM_UNIT_ADDED, MessageBus::MakeMessage<HM_ActionMessage>((*devArgs.getUnit())), true);
                     break;
                 }
                 case LT_DEV_PROJECT_ADDED:
@@ -1041,31 +1043,31 @@ void DeveloperAgent::HandleMessage(Message::MessageType type, const Message& mes
                 case LT_STATUS_ID_DEV_UNIT_UNDER_CONSTRUCTION:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_UNIT_UNDER_CONSTRUCTION, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getUnitId()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_UNIT_UNDER_CONSTRUCTION, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getUnitId())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_UNIT_CONSTRUCTION_COMPLETED:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_UNIT_CONSTRUCTION_COMPLETED, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getUnitId()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_UNIT_CONSTRUCTION_COMPLETED, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getUnitId())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_NEW_UNIT_LAUNCHED_BUT_UNSOLD:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_NEW_UNIT_LAUNCHED_BUT_UNSOLD, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getUnitId()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_NEW_UNIT_LAUNCHED_BUT_UNSOLD, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getUnitId())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_ONGOING_UNIT_LAUNCHED_BUT_UNSOLD:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_ONGOING_UNIT_LAUNCHED_BUT_UNSOLD, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getUnitId()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_ONGOING_UNIT_LAUNCHED_BUT_UNSOLD, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getUnitId())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_UNIT_READY_FOR_OCCUPANCY_AND_VACANT:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_UNIT_READY_FOR_OCCUPANCY_AND_VACANT, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getUnitId()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_UNIT_READY_FOR_OCCUPANCY_AND_VACANT, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getUnitId())), true);
                     break;
                 }
                 case LT_DEV_BUILDING_ADDED:
@@ -1073,31 +1075,31 @@ void DeveloperAgent::HandleMessage(Message::MessageType type, const Message& mes
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
                     boost::shared_ptr<Building> newBuilding = boost::make_shared<Building>(*(devArgs.getBuilding()));
                     devModel->addNewBuildings(newBuilding);
-                    MessageBus::PostMessage(realEstateAgent, LTEID_HM_BUILDING_ADDED, MessageBus::MessagePtr(new HM_ActionMessage((*devArgs.getBuilding()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LTEID_HM_BUILDING_ADDED, MessageBus::MakeMessage<HM_ActionMessage>((*devArgs.getBuilding())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_BUILDING_DEMOLISHED:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_DEMOLISHED, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getBuildingId()),(devArgs.getFutureDemolitionDate()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_DEMOLISHED, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getBuildingId()),(devArgs.getFutureDemolitionDate())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_BUILDING_UNCOMPLETED_WITH_PREREQUISITES:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_UNCOMPLETED_WITH_PREREQUISITES, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getBuildingId()),(std::tm()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_UNCOMPLETED_WITH_PREREQUISITES, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getBuildingId()),(std::tm())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_BUILDING_NOT_LAUNCHED:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_NOT_LAUNCHED, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getBuildingId()),(std::tm()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_NOT_LAUNCHED, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getBuildingId()),(std::tm())), true);
                     break;
                 }
                 case LT_STATUS_ID_DEV_BUILDING_LAUNCHED_BUT_UNSOLD:
                 {
                     const DEV_InternalMsg& devArgs = MSG_CAST(DEV_InternalMsg, message);
-                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_LAUNCHED_BUT_UNSOLD, MessageBus::MessagePtr(new HM_ActionMessage((devArgs.getBuildingId()),(std::tm()))), true);
+                    MessageBus::PostMessage(realEstateAgent, LT_STATUS_ID_HM_BUILDING_LAUNCHED_BUT_UNSOLD, MessageBus::MakeMessage<HM_ActionMessage>((devArgs.getBuildingId()),(std::tm())), true);
                     break;
                 }
                 default:break;
@@ -1174,8 +1176,8 @@ void DeveloperAgent::launchOnGoingUnitsOnDay0()
         boost::gregorian::date saleFromDate = boost::gregorian::date_from_tm(unit->getSaleFromDate());
         if(currentDateGreg == saleFromDate)
         {
-            MessageBus::PostMessage(realEstateAgent, LTEID_HM_UNIT_ADDED, MessageBus::MessagePtr(new HM_ActionMessage(*unit.get())), true);
-            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_ONGOING_UNIT_LAUNCHED_BUT_UNSOLD,MessageBus::MessagePtr(new DEV_InternalMsg(unit->getId())), true);
+            MessageBus::PostMessage(realEstateAgent, LTEID_HM_UNIT_ADDED, MessageBus::MakeMessage<HM_ActionMessage>(*unit.get()), true);
+            MessageBus::PostMessage(this, LT_STATUS_ID_DEV_ONGOING_UNIT_LAUNCHED_BUT_UNSOLD,MessageBus::MakeMessage<DEV_InternalMsg>(unit->getId()), true);
         }
     }
 }
@@ -1185,7 +1187,7 @@ void DeveloperAgent::launchPrivatePresaleUnits(std::tm currentDate)
     std::vector<BigSerial>  presaleUnits = devModel->getPrivatePresaleUnits(currentDate);
         if(presaleUnits.size()>0)
         {
-            MessageBus::PostMessage(realEstateAgent, LT_DEV_PRIVATE_PRESALE_UNIT_ADDED, MessageBus::MessagePtr(new HM_ActionMessage((presaleUnits))), true);
+            MessageBus::PostMessage(realEstateAgent, LT_DEV_PRIVATE_PRESALE_UNIT_ADDED, MessageBus::MakeMessage<HM_ActionMessage>((presaleUnits)), true);
         }
 
 }
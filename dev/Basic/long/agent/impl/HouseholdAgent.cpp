@@ -29,6 +29,7 @@
 #include "model/JobAssignmentModel.hpp"
 #include "util/PrintLog.hpp"
 #include "util/Statistics.hpp"
+#include "util/RandomService.hpp"
 #include <random>
 
 using namespace sim_mob::long_term;
@@ -314,7 +315,7 @@ void HouseholdAgent::TransferUnitToFreelanceAgent()
 
     int numFreelanceAgents = config.ltParams.workers;
 
-    int agentChosen = (float)rand() / RAND_MAX * numFreelanceAgents;
+    int agentChosen = RandomService::current().uniform() * numFreelanceAgents;
 
     HouseholdAgent *freelanceAgent = model->getFreelanceAgents()[agentChosen];
 
@@ -367,8 +368,7 @@ void HouseholdAgent::processEvent(EventId eventId, Context ctxId, const EventArg
             ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
 
             //generate a unifromly distributed random number
-            std::random_device rd;
-            std::mt19937 gen(rd());
+            RandomStream& gen = RandomService::current();
             std::uniform_real_distribution<> dis(0.0, 1.0);
             const double montecarlo = dis(gen);
 
@@ -398,8 +398,7 @@ void HouseholdAgent::processEvent(EventId eventId, Context ctxId, const EventArg
             ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
 
             //generate a unifromly distributed random number
-            std::random_device rd;
-            std::mt19937 gen(rd());
+            RandomStream& gen = RandomService::current();
             std::uniform_real_distribution<> dis(0.0, 1.0);
             const double montecarlo = dis(gen);
 
@@ -323,7 +323,7 @@ void RealEstateAgent::HandleMessage(Message::MessageType type, const Message& me
                 }
 
 
-                MessageBus::PublishEvent(LTEID_HM_BTO_UNIT_ADDED,MessageBus::EventArgsPtr(new EventArgs()));
+                MessageBus::PublishEvent(LTEID_HM_BTO_UNIT_ADDED,MessageBus::MakeEventArgs<EventArgs>());
                 break;
             }
             case LT_DEV_PRIVATE_PRESALE_UNIT_ADDED:
@@ -344,7 +344,7 @@ void RealEstateAgent::HandleMessage(Message::MessageType type, const Message& me
                     unitsById.insert(std::make_pair((unit)->getId(), unit));
                     unitIds.push_back(unitId);
                 }
-                MessageBus::PublishEvent(LTEID_HM_PRIVATE_PRESALE_UNIT_ADDED,MessageBus::EventArgsPtr(new EventArgs()));
+                MessageBus::PublishEvent(LTEID_HM_PRIVATE_PRESALE_UNIT_ADDED,MessageBus::MakeEventArgs<EventArgs>());
                 break;
             }
             default:break;
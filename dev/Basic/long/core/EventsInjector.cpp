@@ -96,21 +96,21 @@ Entity::UpdateStatus EventsInjector::update(timeslice now)
         developerAgent = lookup.getDeveloperAgentById(it->getDeveloperId());
         if(developerAgent)
         {
-            MessageBus::PublishEvent(toEventId(it->getType()), const_cast<DeveloperAgent*>(developerAgent), MessageBus::EventArgsPtr(new ExternalEventArgs(*it)));
+            MessageBus::PublishEvent(toEventId(it->getType()), const_cast<DeveloperAgent*>(developerAgent), MessageBus::MakeEventArgs<ExternalEventArgs>(*it));
         }
         else
         {
             householdAgent = lookup.getHouseholdAgentById(it->getHouseholdId());
             if (householdAgent)
             {
-                MessageBus::PublishEvent(toEventId(it->getType()), const_cast<HouseholdAgent*>(householdAgent), MessageBus::EventArgsPtr(new ExternalEventArgs(*it)));
+                MessageBus::PublishEvent(toEventId(it->getType()), const_cast<HouseholdAgent*>(householdAgent), MessageBus::MakeEventArgs<ExternalEventArgs>(*it));
             }
             else
             {
                 realEstateAgent = lookup.getRealEstateAgentById(it->getHouseholdId());
                 if (realEstateAgent)
                 {
-                    MessageBus::PublishEvent(toEventId(it->getType()), const_cast<RealEstateAgent*>(realEstateAgent), MessageBus::EventArgsPtr(new ExternalEventArgs(*it)));
+                    MessageBus::PublishEvent(toEventId(it->getType()), const_cast<RealEstateAgent*>(realEstateAgent), MessageBus::MakeEventArgs<ExternalEventArgs>(*it));
                 }
 
             }
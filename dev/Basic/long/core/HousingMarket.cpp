@@ -199,19 +199,19 @@ HousingMarket::~HousingMarket()
 void HousingMarket::addEntry(const Entry& entry)
 {
     // entry will be available only on the next tick
-    MessageBus::PostMessage(this, LTMID_HMI_ADD_ENTRY, MessageBus::MessagePtr( new HM_AddEntryMsg(Entry(entry))), true);
+    MessageBus::PostMessage(this, LTMID_HMI_ADD_ENTRY, MessageBus::MakeMessage<HM_AddEntryMsg>(Entry(entry)), true);
 }
 
 void HousingMarket::updateEntry(const HousingMarket::Entry& entry)
 {
     // entry will be available only on the next tick
-    MessageBus::PostMessage(this, LTMID_HMI_ADD_ENTRY, MessageBus::MessagePtr( new HM_AddEntryMsg(Entry(entry))), true);
+    MessageBus::PostMessage(this, LTMID_HMI_ADD_ENTRY, MessageBus::MakeMessage<HM_AddEntryMsg>(Entry(entry)), true);
 }
 
 void HousingMarket::removeEntry(const BigSerial& unitId)
 {
     // entry will be available only on the next tick
-    MessageBus::PostMessage(this, LTMID_HMI_RM_ENTRY, MessageBus::MessagePtr( new HM_RemoveEntryMsg(unitId)), true);
+    MessageBus::PostMessage(this, LTMID_HMI_RM_ENTRY, MessageBus::MakeMessage<HM_RemoveEntryMsg>(unitId), true);
 }
 
 void HousingMarket::getAvailableEntries(const IdVector& tazIds, HousingMarket::ConstEntryList& outList)
@@ -322,7 +322,7 @@ void HousingMarket::HandleMessage(Message::MessageType type, const Message& mess
                 entriesByTazId.find(tazId)->second.insert( std::make_pair(unitId, newEntry));
                 //notify subscribers. FOR NOW we are not using this.
                 //MessageBus::PublishEvent(LTEID_HM_UNIT_ADDED, this,
-                //MessageBus::EventArgsPtr(new HM_ActionEventArgs(unitId)));
+                //MessageBus::MakeEventArgs<HM_ActionEventArgs>(unitId));
 
                if( newEntry->isBTO() )
                {
@@ -364,7 +364,7 @@ void HousingMarket::HandleMessage(Message::MessageType type, const Message& mess
                 safe_delete_item(entry);
                 //notify subscribers. FOR NOW we are not using this.
                 //MessageBus::PublishEvent(LTEID_HM_UNIT_REMOVED, this,
-                //MessageBus::EventArgsPtr(new HM_ActionEventArgs(msg.unitId)));
+                //MessageBus::MakeEventArgs<HM_ActionEventArgs>(msg.unitId));
             }
             break;
         }
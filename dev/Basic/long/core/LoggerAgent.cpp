@@ -453,7 +453,7 @@ void LoggerAgent::log(LogFile outputType, const std::string& logMsg)
     boost::mutex::scoped_lock lock( mtx );
 
     // entry will be available only on the next tick
-    MessageBus::PostMessage(this, LTMID_LOG, MessageBus::MessagePtr(new LogMsg(logMsg, outputType)));
+    MessageBus::PostMessage(this, LTMID_LOG, MessageBus::MakeMessage<LogMsg>(logMsg, outputType));
 }
 
 void LoggerAgent::HandleMessage(messaging::Message::MessageType type, const messaging::Message& message)
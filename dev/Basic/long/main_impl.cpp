@@ -9,6 +9,7 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <ctime>
@@ -45,6 +46,8 @@
 #include "database/dao/HouseholdDao.hpp"
 #include "database/dao/HouseholdUnitDao.hpp"
 #include "util/HelperFunctions.hpp"
+#include "util/RandomService.hpp"
+#include "util/SlabPool.hpp"
 #include "util/Statistics.hpp"
 
 using std::cout;
@@ -91,6 +94,10 @@ int printReport(int simulationNumber, vector<Model*>& models, StopWatch& simulat
         }
         PrintOut(endl);
     }
+    //Message pools Statistics
+    std::ostringstream poolStats;
+    SlabPool::printStats(poolStats);
+    PrintOutV(poolStats.str());
     PrintOutV("##############################################################" << endl);
     return 0;
 }
@@ -249,8 +256,8 @@ void loadDataToOutputSchema(db::DB_Connection& conn,std::string &currentOutputSc
 
 void performMain(int simulationNumber, std::list<std::string>& resLogFiles)
 {
-    time_t timeInSeconds = std::time(0);
-    srand(timeInSeconds);
+    //std::rand() backs math.random in the Lua scripts; seeded from the global seed, a run is reproducible
+    srand(RandomStream(simulationNumber, RANDOM_LIBRARY_SEED)());
 
     //Initiate configuration instance
     LT_ConfigSingleton::getInstance();
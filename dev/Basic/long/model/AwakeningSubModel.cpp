@@ -19,6 +19,7 @@
 #include <vector>
 #include "util/PrintLog.hpp"
 #include "util/SharedFunctions.hpp"
+#include "util/RandomService.hpp"
 #include "agent/impl/HouseholdAgent.hpp"
 
 using namespace std;
@@ -70,7 +71,7 @@ namespace sim_mob
                 }
             }
 
-            futureTransitionRandomDraw = (double)rand()/RAND_MAX;
+            futureTransitionRandomDraw = RandomService::current().uniform();
 
             if( futureTransitionRandomDraw < futureTransitionRate )
                 futureTransitionOwn = true; //Future transition is to OWN a unit
@@ -136,7 +137,7 @@ namespace sim_mob
 
             if( config.ltParams.housingModel.awakeningModel.awakenModelRandom == true )
             {
-                float random = (float)rand() / RAND_MAX;
+                float random = RandomService::current().uniform();
 
                 if( random < 0.5 )
                     return;
@@ -179,7 +180,7 @@ namespace sim_mob
                 }
 
 
-                float r1 = (float)rand() / RAND_MAX;
+                float r1 = RandomService::current().uniform();
                 int lifestyle = 1;
 
                 if( r1 > class1 && r1 <= class1 + class2 )
@@ -191,7 +192,7 @@ namespace sim_mob
                     lifestyle = 3;
                 }
 
-                float r2 = (float)rand() / RAND_MAX;
+                float r2 = RandomService::current().uniform();
 
                 int ageCategory = 0;
 
@@ -241,7 +242,7 @@ namespace sim_mob
             {
                 double movingRate = movingProbability(household, model, true ) / 100.0;
 
-                double randomDrawMovingRate = (double)rand()/RAND_MAX;
+                double randomDrawMovingRate = RandomService::current().uniform();
 
                 if( randomDrawMovingRate > movingRate )
                     return;
@@ -277,7 +278,7 @@ namespace sim_mob
             household->setAwakenedDay(0);
             household->setLastBidStatus(0);
             household->setLastAwakenedDay(0);
-            int householdBiddingWindow = ( config.ltParams.housingModel.householdBiddingWindow ) * (double)rand() / RAND_MAX + 1;
+            int householdBiddingWindow = ( config.ltParams.housingModel.householdBiddingWindow ) * RandomService::current().uniform() + 1;
             household->setTimeOnMarket(householdBiddingWindow);
             agent->setHouseholdBiddingWindow(householdBiddingWindow);
             //note :: what happens if a household never bids during the bidding window?? where do we set the time off market for those households?
@@ -331,7 +332,7 @@ namespace sim_mob
             {
                 ExternalEvent extEv;
 
-                BigSerial householdId = (double)rand()/RAND_MAX * model->getHouseholdList()->size();
+                BigSerial householdId = RandomService::current().uniform() * model->getHouseholdList()->size();
 
                 Household *household = model->getHouseholdById(householdId);
 
@@ -368,7 +369,7 @@ namespace sim_mob
 
                 double movingRate = movingProbability(household, model, false ) / 100.0;
 
-                double movingRateRandomDraw = (double)rand()/RAND_MAX;
+                double movingRateRandomDraw = RandomService::current().uniform();
 
                 if (movingRateRandomDraw > movingRate)
                     continue;
@@ -51,6 +51,7 @@
 #include "conf/ConfigParams.hpp"
 #include "util/SharedFunctions.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 #include "SOCI_ConvertersLong.hpp"
 #include "DatabaseHelper.hpp"
 #include <random>
@@ -673,8 +674,7 @@ DeveloperModel::DeveloperList DeveloperModel::getDeveloperAgents(){
 
     for(unsigned int i = 0; i < dailyAgentFraction ; i++)
     {
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        RandomStream& gen = RandomService::current();
         std::uniform_int_distribution<int> dis(0, max_index);
         const unsigned int random_index = dis(gen);
         if (indexes.find(random_index) == indexes.end())
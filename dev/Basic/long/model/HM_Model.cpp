@@ -70,6 +70,7 @@
 #include "behavioral/PredayLT_Logsum.hpp"
 #include "util/PrintLog.hpp"
 #include "util/SharedFunctions.hpp"
+#include "util/RandomService.hpp"
 #include <random>
 #include <iostream>
 #include <boost/random/linear_congruential.hpp>
@@ -1241,11 +1242,7 @@ void HM_Model::setTaxiAccess2008(const Household *household)
     double probabilityTaxiAccess = (expTaxiAccess) / (1 + expTaxiAccess);
 
     //generate a random number with an unifrom real distribution.
-    boost::mt19937 randomNumbergenerator( time( 0 ) );
-    boost::random::uniform_real_distribution< > uniformDistribution( 0.0, 1.0 );
-    boost::variate_generator< boost::mt19937&, boost::random::uniform_real_distribution < > >
-    generateRandomNumbers( randomNumbergenerator, uniformDistribution );
-    const double randomNum = generateRandomNumbers();
+    const double randomNum = RandomService::current().uniform();
 
 
     if(randomNum < probabilityTaxiAccess)
@@ -1254,7 +1251,7 @@ void HM_Model::setTaxiAccess2008(const Household *household)
         hasTaxiAccess = true;
         AgentsLookup& lookup = AgentsLookupSingleton::getInstance();
         const HouseholdAgent* householdAgent = lookup.getHouseholdAgentById(household->getId());
-        MessageBus::PostMessage(const_cast<HouseholdAgent*>(householdAgent), LTMID_HH_TAXI_AVAILABILITY, MessageBus::MessagePtr(new Message()));
+        MessageBus::PostMessage(const_cast<HouseholdAgent*>(householdAgent), LTMID_HH_TAXI_AVAILABILITY, MessageBus::MakeMessage<Message>());
     }
     }
 }
@@ -1452,8 +1449,7 @@ void HM_Model::setTaxiAccess2012(const Household *household)
         double expTaxiAccess = exp(valueTaxiAccess);
         double probabilityTaxiAccess = (expTaxiAccess) / (1 + expTaxiAccess);
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        RandomStream& gen = RandomService::current();
         std::uniform_real_distribution<> dis(0.0, 1.0);
         const double randomNum = dis(gen);
 
@@ -1465,7 +1461,7 @@ void HM_Model::setTaxiAccess2012(const Household *household)
             hasTaxiAccess = true;
             AgentsLookup& lookup = AgentsLookupSingleton::getInstance();
             const HouseholdAgent* householdAgent = lookup.getHouseholdAgentById(household->getId());
-            MessageBus::PostMessage(const_cast<HouseholdAgent*>(householdAgent), LTMID_HH_TAXI_AVAILABILITY, MessageBus::MessagePtr(new Message()));
+            MessageBus::PostMessage(const_cast<HouseholdAgent*>(householdAgent), LTMID_HH_TAXI_AVAILABILITY, MessageBus::MakeMessage<Message>());
         }
 }
 
@@ -2034,15 +2030,13 @@ void HM_Model::startImpl()
 
             if(!resume)
             {
-                std::random_device genTimeOn;
-                std::mt19937 genRdTimeOn(genTimeOn());
+                RandomStream& genRdTimeOn = RandomService::current();
                 std::uniform_int_distribution<int> disRdTimeOn(1,  config.ltParams.housingModel.timeOnMarket);
-                timeOnMarket = disRdTimeOn(genTimeOn);
+                timeOnMarket = disRdTimeOn(genRdTimeOn);
 
-                std::random_device genTimeOff;
-                std::mt19937 genRdTimeOff(genTimeOff());
+                RandomStream& genRdTimeOff = RandomService::current();
                 std::uniform_int_distribution<int> disRdTimeOff(1,  config.ltParams.housingModel.timeOffMarket);
-                timeOffMarket = disRdTimeOff(genTimeOff);
+                timeOffMarket = disRdTimeOff(genRdTimeOff);
 
                 (*it)->setTimeOnMarket(timeOnMarket );
                 (*it)->setTimeOffMarket(timeOffMarket );
@@ -2054,7 +2048,7 @@ void HM_Model::startImpl()
                 {
                     if(!resume)
                     {
-                    float awakeningProbability = (float)rand() / RAND_MAX;
+                    float awakeningProbability = RandomService::current().uniform();
 
                     if( awakeningProbability < config.ltParams.housingModel.vacantUnitActivationProbability )
                     {
@@ -3697,10 +3691,9 @@ void HM_Model::unitsFiltering()
     PrintOutV( "[Prefilter] Total number of Condos: " << numOfCondo << std::endl );
     PrintOutV( "Total units " << units.size() << std::endl );
 
-    srand(time(0));
     for( int n = 0;  n < targetNumOfHDB; )
     {
-        int random =  (double)rand() / RAND_MAX * units.size();
+        int random =  RandomService::current().uniform() * units.size();
 
         if( units[random]->getUnitType() < LS70_APT )
         {
@@ -3711,7 +3704,7 @@ void HM_Model::unitsFiltering()
 
     for( int n = 0;  n < targetNumOfCondo; )
     {
-        int random =  (double)rand() / RAND_MAX * units.size();
+        int random =  RandomService::current().uniform() * units.size();
 
         if( units[random]->getUnitType() >= LS70_APT && units[random]->getUnitType() < LG379_RC )
         {
@@ -4506,8 +4499,7 @@ void HM_Model::addSchoolDeskToStudent(BigSerial individualId, int schoolId)
         }
         else
         {
-            std::random_device rdInGen;
-            std::mt19937 genRdInd(rdInGen());
+            RandomStream& genRdInd = RandomService::current();
             std::uniform_int_distribution<int> disRdInd(0, (sz-1));
             const unsigned int random_index = disRdInd(genRdInd);
             std::advance(range.first, random_index);
@@ -4663,8 +4655,7 @@ bool HM_Model::assignIndividualJob(BigSerial individualId, BigSerial selectedTaz
     }
     else
     {
-    std::random_device rdInGen;
-    std::mt19937 genRdInd(rdInGen());
+    RandomStream& genRdInd = RandomService::current();
     std::uniform_int_distribution<int> disRdInd(0, (sz-1));
     const unsigned int random_index = disRdInd(genRdInd);
     std::advance(range.first, random_index);
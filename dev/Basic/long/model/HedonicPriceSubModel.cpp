@@ -14,6 +14,7 @@
 #include "model/lua/LuaProvider.hpp"
 #include <limits>
 #include "core/DataManager.hpp"
+#include "util/RandomService.hpp"
 #include <util/PrintLog.hpp>
 
 using namespace sim_mob::long_term;
@@ -768,7 +769,7 @@ double HedonicPrice_SubModel::FindMaxArgConstrained(double (*f)(double , double
         delta = abs(x1 - x0);
 
         if (x1 <= lowerLimit && x1 > highLimit)
-           x0 = lowerLimit + ( rand() / (float)RAND_MAX) * ( highLimit - lowerLimit);
+           x0 = lowerLimit + RandomService::current().uniform() * ( highLimit - lowerLimit);
         else
            x0 = x1;
 
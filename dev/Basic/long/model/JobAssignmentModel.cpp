@@ -8,6 +8,7 @@
 #include "model/JobAssignmentModel.hpp"
 #include "util/SharedFunctions.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 #include "database/entity/IndLogsumJobAssignment.hpp"
 #include <iostream>
 #include <fstream>
@@ -198,8 +199,7 @@ void JobAssignmentModel::computeJobAssignmentProbability(BigSerial individualId)
 
 
     //generate a random number with uniform real distribution.
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    RandomStream& gen = RandomService::current();
     std::uniform_real_distribution<> dis(0.0, 1.0);
 
     double randomNum =  dis(gen);
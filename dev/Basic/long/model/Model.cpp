@@ -62,7 +62,7 @@ void Model::start()
         startWatch.stop();
         running = true;
         addMetadata(START_TIME, startWatch.getTime());
-        MessageBus::PublishEvent(LTEID_MODEL_STARTED, this, MessageBus::EventArgsPtr(new EventArgs()));
+        MessageBus::PublishEvent(LTEID_MODEL_STARTED, this, MessageBus::MakeEventArgs<EventArgs>());
     }
 }
 
@@ -80,7 +80,7 @@ void Model::stop()
         stopImpl();
         stopWatch.stop();
         addMetadata(STOP_TIME, stopWatch.getTime());
-        MessageBus::PublishEvent(LTEID_MODEL_STOPPED, this, MessageBus::EventArgsPtr(new EventArgs()));
+        MessageBus::PublishEvent(LTEID_MODEL_STOPPED, this, MessageBus::MakeEventArgs<EventArgs>());
     }
 }
 
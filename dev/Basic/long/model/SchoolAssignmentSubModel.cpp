@@ -10,6 +10,7 @@
 #include "message/MessageBus.hpp"
 #include "util/SharedFunctions.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 #include <random>
 
 using namespace sim_mob;
@@ -98,8 +99,7 @@ void SchoolAssignmentSubModel::assignPrimarySchool(const Household *household,Bi
     }
 
     //generate a random number with uniform real distribution.
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    RandomStream& gen = RandomService::current();
     std::uniform_real_distribution<> dis(0.0, 1.0);
     double randomNum =  dis(gen);
     double pTemp = 0;
@@ -228,8 +228,7 @@ void SchoolAssignmentSubModel::assignSecondarySchool(const Household *household,
         }
 
         //generate a random number with uniform real distribution.
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        RandomStream& gen = RandomService::current();
         std::uniform_real_distribution<> dis(0.0, 1.0);
         double randomNum =  dis(gen);
         double pTemp = 0;
@@ -372,8 +371,7 @@ void SchoolAssignmentSubModel::assignUniversity( const Household *household,BigS
         }
 
         //generate a random number with uniform real distribution.
-            std::random_device rd;
-            std::mt19937 gen(rd());
+            RandomStream& gen = RandomService::current();
             std::uniform_real_distribution<> dis(0.0, 1.0);
             double randomNum =  dis(gen);
             double pTemp = 0;
@@ -404,8 +402,7 @@ void SchoolAssignmentSubModel::assignUniversity( const Household *household,BigS
 
 
     //generate a random number with uniform real distribution.
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    RandomStream& gen = RandomService::current();
     std::uniform_real_distribution<> dis(0.0, 1.0);
     double randomNum =  dis(gen);
     double pTemp = 0;
@@ -535,8 +532,7 @@ void SchoolAssignmentSubModel::assignPolyTechnic(const Household *household,BigS
         }
 
         //generate a random number with uniform real distribution.
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        RandomStream& gen = RandomService::current();
         std::uniform_real_distribution<> dis(0.0, 1.0);
         double randomNum =  dis(gen);
         double pTemp = 0;
@@ -567,8 +563,7 @@ void SchoolAssignmentSubModel::assignPolyTechnic(const Household *household,BigS
         }
 
         //generate a random number with uniform real distribution.
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        RandomStream& gen = RandomService::current();
         std::uniform_real_distribution<> dis(0.0, 1.0);
         double randomNum =  dis(gen);
         double pTemp = 0;
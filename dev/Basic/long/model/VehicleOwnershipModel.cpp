@@ -10,6 +10,7 @@
 #include "behavioral/PredayLT_Logsum.hpp"
 #include "util/SharedFunctions.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 #include <random>
 #include <fstream>
 
@@ -76,8 +77,7 @@ void VehicleOwnershipModel::reconsiderVehicleOwnershipOption(const Household *ho
             }
 
             //generate a random number with uniform real distribution.
-            std::random_device rd;
-            std::mt19937 gen(rd());
+            RandomStream& gen = RandomService::current();
             std::uniform_real_distribution<> dis(0.0, 1.0);
 
             const double randomNum = dis(gen);
@@ -101,17 +101,17 @@ void VehicleOwnershipModel::reconsiderVehicleOwnershipOption(const Household *ho
                 //  writeVehicleOwnershipToFile(household->getId(),selecteVehicleOwnershipOtionId);
                     switch(selecteVehicleOwnershipOtionId)
                     {
-                    case 1 : MessageBus::PostMessage(hhAgent, LTMID_HH_NO_VEHICLE, MessageBus::MessagePtr(new Message()));
+                    case 1 : MessageBus::PostMessage(hhAgent, LTMID_HH_NO_VEHICLE, MessageBus::MakeMessage<Message>());
                     break;
-                    case 2 : MessageBus::PostMessage(hhAgent, LTMID_HH_PLUS1_MOTOR_ONLY, MessageBus::MessagePtr(new Message()));
+                    case 2 : MessageBus::PostMessage(hhAgent, LTMID_HH_PLUS1_MOTOR_ONLY, MessageBus::MakeMessage<Message>());
                     break;
-                    case 3 : MessageBus::PostMessage(hhAgent, LTMID_HH_OFF_PEAK_CAR_W_WO_MOTOR, MessageBus::MessagePtr(new Message()));
+                    case 3 : MessageBus::PostMessage(hhAgent, LTMID_HH_OFF_PEAK_CAR_W_WO_MOTOR, MessageBus::MakeMessage<Message>());
                     break;
-                    case 4 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_ONLY, MessageBus::MessagePtr(new Message()));
+                    case 4 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_ONLY, MessageBus::MakeMessage<Message>());
                     break;
-                    case 5 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_1PLUS_MOTOR, MessageBus::MessagePtr(new Message()));
+                    case 5 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_1PLUS_MOTOR, MessageBus::MakeMessage<Message>());
                     break;
-                    case 6 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_W_WO_MOTOR, MessageBus::MessagePtr(new Message()));
+                    case 6 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_W_WO_MOTOR, MessageBus::MakeMessage<Message>());
                     break;
                     }
                     break;
@@ -508,8 +508,7 @@ void VehicleOwnershipModel::reconsiderVehicleOwnershipOption2(Household &househo
         }
 
         //generate a random number with uniform real distribution.
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        RandomStream& gen = RandomService::current();
         std::uniform_real_distribution<> dis(0.0, 1.0);
 
         double randomNum = 0;
@@ -557,17 +556,17 @@ void VehicleOwnershipModel::reconsiderVehicleOwnershipOption2(Household &househo
                 {
                     switch(selectedVehicleOwnershipOtionId)
                     {
-                    case 0 : MessageBus::PostMessage(hhAgent, LTMID_HH_NO_VEHICLE, MessageBus::MessagePtr(new Message()));
+                    case 0 : MessageBus::PostMessage(hhAgent, LTMID_HH_NO_VEHICLE, MessageBus::MakeMessage<Message>());
                     break;
-                    case 1 : MessageBus::PostMessage(hhAgent, LTMID_HH_PLUS1_MOTOR_ONLY, MessageBus::MessagePtr(new Message()));
+                    case 1 : MessageBus::PostMessage(hhAgent, LTMID_HH_PLUS1_MOTOR_ONLY, MessageBus::MakeMessage<Message>());
                     break;
-                    case 2 : MessageBus::PostMessage(hhAgent, LTMID_HH_OFF_PEAK_CAR_W_WO_MOTOR, MessageBus::MessagePtr(new Message()));
+                    case 2 : MessageBus::PostMessage(hhAgent, LTMID_HH_OFF_PEAK_CAR_W_WO_MOTOR, MessageBus::MakeMessage<Message>());
                     break;
-                    case 3 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_ONLY, MessageBus::MessagePtr(new Message()));
+                    case 3 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_ONLY, MessageBus::MakeMessage<Message>());
                     break;
-                    case 4 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_1PLUS_MOTOR, MessageBus::MessagePtr(new Message()));
+                    case 4 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_1PLUS_MOTOR, MessageBus::MakeMessage<Message>());
                     break;
-                    case 5 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_W_WO_MOTOR, MessageBus::MessagePtr(new Message()));
+                    case 5 : MessageBus::PostMessage(hhAgent, LTMID_HH_NORMAL_CAR_W_WO_MOTOR, MessageBus::MakeMessage<Message>());
                     break;
                     }
                     break;
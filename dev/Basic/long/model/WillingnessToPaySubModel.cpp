@@ -20,6 +20,7 @@
 #include "core/AgentsLookup.hpp"
 #include "core/DataManager.hpp"
 #include "behavioral/PredayLT_Logsum.hpp"
+#include "util/RandomService.hpp"
 
 namespace sim_mob
 {
@@ -443,10 +444,7 @@ namespace sim_mob
             else
                 V = Vpriv;
 
-            boost::mt19937 rng( clock() );
-            boost::normal_distribution<> nd( 0.0, sde);
-            boost::variate_generator<boost::mt19937&,  boost::normal_distribution<> > var_nor(rng, nd);
-            wtp_e  = var_nor();
+            wtp_e  = RandomService::current().normal(0.0, sde);
 
             //needed when wtp model is expressed as log wtp
             V = exp(V);
@@ -596,10 +594,7 @@ namespace sim_mob
                                 + wtpCoeffs->getFullTimeWorkersTwoIntoLogArea() * oneTwoFullTimeWorkers * logArea
                                 + wtpCoeffs->getHhSizeworkersDiff() * hhSizeWorkersDiff;
 
-                boost::mt19937 rng( clock() );
-                boost::normal_distribution<> nd( 0.0, sde);
-                boost::variate_generator<boost::mt19937&,  boost::normal_distribution<> > var_nor(rng, nd);
-                wtp_e  = var_nor();
+                wtp_e  = RandomService::current().normal(0.0, sde);
 
                 //needed when wtp model is expressed as log wtp
                 willingnessToPay = exp(willingnessToPay);
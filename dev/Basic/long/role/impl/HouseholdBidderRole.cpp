@@ -33,6 +33,7 @@
 #include "model/HedonicPriceSubModel.hpp"
 #include "model/WillingnessToPaySubModel.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 #include "model/VehicleOwnershipModel.hpp"
 
 
@@ -52,7 +53,7 @@ namespace
      */
     inline void bid(MessageHandler* owner, const Bid& bid)
     {
-        MessageBus::PostMessage(owner, LTMID_BID, MessageBus::MessagePtr(new BidMessage(bid)));
+        MessageBus::PostMessage(owner, LTMID_BID, MessageBus::MakeMessage<BidMessage>(bid));
     }
 }
 
@@ -668,7 +669,7 @@ bool HouseholdBidderRole::pickEntryToBid()
     {
         while (screenedEntries.size() < config.ltParams.housingModel.bidderUnitChoiceset.bidderChoicesetSize)
         {
-            double randomDraw = (double) rand() / RAND_MAX * entries.size();
+            double randomDraw = RandomService::current().uniform() * entries.size();
             screenedEntries.insert(entries[randomDraw]);
         }
     }
@@ -677,7 +678,7 @@ bool HouseholdBidderRole::pickEntryToBid()
     {
         for (int n = 0; n < entries.size() && screenedEntries.size() < config.ltParams.housingModel.bidderUnitChoiceset.bidderChoicesetSize; n++)
         {
-            double randomDraw = (double) rand() / RAND_MAX;
+            double randomDraw = RandomService::current().uniform();
             int zoneHousingType = -1;
             double cummulativeProbability = 0.0;
             for (int m = 0; m < householdScreeningProbabilities.size(); m++)
@@ -701,7 +702,7 @@ bool HouseholdBidderRole::pickEntryToBid()
             if (numUnits == 0)
                 continue;
 
-            int offset = (float) rand() / RAND_MAX * (numUnits - 1);
+            int offset = RandomService::current().uniform() * (numUnits - 1);
             advance(range.first, offset); // change a random unit in that zoneHousingType
 
             const BigSerial unitId = (range.first)->second;
@@ -751,7 +752,7 @@ bool HouseholdBidderRole::pickEntryToBid()
         //Add x number of BTO units to the screenedUnit vector if the household is eligible for it
         for(int n = 0; n < config.ltParams.housingModel.bidderUnitChoiceset.bidderBTOChoicesetSize && btoEntries.size() != 0; n++)
         {
-            int offset = (float)rand() / RAND_MAX * ( btoEntries.size() - 1 );
+            int offset = RandomService::current().uniform() * ( btoEntries.size() - 1 );
 
             auto itr =  btoEntries.begin();
             std::advance( itr, offset);
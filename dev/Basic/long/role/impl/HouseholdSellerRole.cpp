@@ -32,6 +32,7 @@
 #include "database/entity/UnitSale.hpp"
 #include "database/entity/HouseholdUnit.hpp"
 #include "util/PrintLog.hpp"
+#include "util/RandomService.hpp"
 
 using namespace sim_mob;
 using namespace sim_mob::long_term;
@@ -61,7 +62,7 @@ namespace
      */
     inline void replyBid(const HouseholdAgent& agent, const Bid& bid, const ExpectationEntry& entry, const BidResponse& response, unsigned int bidsCounter)
     {
-        MessageBus::PostMessage(bid.getBidder(), LTMID_BID_RSP, MessageBus::MessagePtr(new BidMessage(bid, response)));
+        MessageBus::PostMessage(bid.getBidder(), LTMID_BID_RSP, MessageBus::MakeMessage<BidMessage>(bid, response));
         HM_Model* model = agent.getModel();
         //print bid.
         if( response == ACCEPTED || response ==  NOT_ACCEPTED || response == BETTER_OFFER)
@@ -456,7 +457,7 @@ void HouseholdSellerRole::handleReceivedBid(const Bid &bid, BigSerial unitId)
             {
                 // bids are exactly equal. Randomly choose one.
 
-                double randomDraw = (double)rand()/RAND_MAX;
+                double randomDraw = RandomService::current().uniform();
 
                 //drop the current bid
                 if(randomDraw < dHalf)
@@ -26,6 +26,7 @@
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
 #include "util/SharedFunctions.hpp"
+#include "util/RandomService.hpp"
 #include "model/HedonicPriceSubModel.hpp"
 
 using namespace sim_mob;
@@ -56,7 +57,7 @@ namespace
      */
     inline void replyBid(const RealEstateAgent& agent, const Bid& bid, const ExpectationEntry& entry, const BidResponse& response, unsigned int bidsCounter)
     {
-        MessageBus::PostMessage(bid.getBidder(), LTMID_BID_RSP, MessageBus::MessagePtr(new BidMessage(bid, response)));
+        MessageBus::PostMessage(bid.getBidder(), LTMID_BID_RSP, MessageBus::MakeMessage<BidMessage>(bid, response));
 
         if( response != NOT_AVAILABLE )
         {
@@ -375,7 +376,7 @@ void RealEstateSellerRole::HandleMessage(Message::MessageType type, const Messag
                     {
                         // bids are equal (i.e so close the difference is less that EPSILON). Randomly choose one.
 
-                        double randomDraw = (double)rand()/RAND_MAX;
+                        double randomDraw = RandomService::current().uniform();
 
                         //drop the current bid
                         if(randomDraw < dHalf)
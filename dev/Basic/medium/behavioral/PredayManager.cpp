@@ -5,8 +5,10 @@
 #include "PredayManager.hpp"
 
 #include <algorithm>
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/io.hpp>
 #include <cerrno>
@@ -25,6 +27,7 @@
 #include "database/DB_Connection.hpp"
 #include "database/DB_Config.hpp"
 #include "database/PG_BulkInserter.hpp"
+#include "database/PG_CopySink.hpp"
 #include "database/predaydao/DatabaseHelper.hpp"
 #include "database/predaydao/PopulationSqlDao.hpp"
 #include "database/predaydao/ZoneCostSqlDao.hpp"
@@ -32,7 +35,10 @@
 #include "logging/Log.hpp"
 #include "util/CSVReader.hpp"
 #include "util/LangHelpers.hpp"
+#include "util/OutputStreamer.hpp"
+#include "util/RandomService.hpp"
 #include "util/Utils.hpp"
+#include "behavioral/lua/PredayLuaProvider.hpp"
 
 using namespace std;
 using namespace sim_mob;
@@ -51,6 +57,38 @@ const std::string UPPER_LIMIT_CSV_HEADER = "upper_limit";
 
 const std::size_t NUM_INSERTS_PER_QUERY = 100000;
 
+/** size in bytes at which the activity schedule output of a thread is handed to the writer thread */
+const std::size_t ACTIVITY_SCHEDULE_BUFFER_SIZE = 1 << 20;
+/** number of full output buffers per preday thread which may wait for the writer thread */
+const std::size_t ACTIVITY_SCHEDULE_QUEUED_BUFFERS_PER_THREAD = 2;
+/** file to which the activity schedules are written when file output is enabled */
+const std::string ACTIVITY_SCHEDULE_FILE_NAME = "activity_schedule";
+
+/**
+ * id of the random stream of a preday person: FNV-1a hash of the person id
+ */
+boost::uint32_t getPersonStreamId(const std::string& personId)
+{
+	boost::uint32_t hash = 2166136261u;
+	for (std::string::const_iterator it = personId.begin(); it != personId.end(); ++it)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*it)) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * reseeds the random generator of the preday models of the calling thread from the stream of a person.
+ * Together with making the stream current, this makes the choices of a person independent of the thread simulating
+ * it and of the persons simulated before by that thread.
+ */
+void seedPredayModels(RandomStream& personRandom)
+{
+	boost::uint64_t seed = personRandom();
+	seed = (seed << 32) | personRandom();
+	PredayLuaProvider::getPredayModel().seedRandom(seed);
+}
+
 /** vector of variables to be calibrated. used only in calibration mode of Preday*/
 std::vector<CalibrationVariable> calibrationVariablesList;
 size_t numVariablesCalibrated;
@@ -104,8 +142,6 @@ public:
 	RandomSymmetricPlusMinusVector(size_t dimension) :
 			dimension(dimension)
 	{
-		//set the seed
-		srand(time(0));
 	}
 
 	/**
@@ -117,7 +153,7 @@ public:
 		randomVector.clear();
 		for (size_t i = 0; i < dimension; i++)
 		{
-			if ((rand() % 2) == 0)
+			if (RandomService::current().bernoulli(0.5))
 			{
 				randomVector.push_back(1);
 			}
@@ -474,63 +510,21 @@ void printParameters(const std::vector<CalibrationVariable>& calVarList, const s
 }
 
 /**
- * flush stream contents to file
- * @param logHandle handle to output file
- * @param strm stringstream to flush
- */
-void outputToFile(std::ofstream& logHandle, std::stringstream& strm)
-{
-	NullableOutputStream(&logHandle) << strm.str() << std::flush;
-	strm.str(std::string());
-}
-
-/**
- * constructs unique file name strings by appending serial numbers to prefix
- * @param numFiles number of file names to generate
- * @param prefix prefix string to use in file
- * @param outFileNamesList out list to populate with generated file names
+ * @return columns of the day activity schedule table, in the order of the rows written by
+ *         PredaySystem::outputActivityScheduleToStream()
  */
-void constructFileNames(size_t numFiles, const std::string& prefix, std::list<std::string>& outFileNamesList)
+std::vector<std::string> getDayActivityScheduleColumns()
 {
-	std::stringstream fileName;
-	for (unsigned i = 1; i <= numFiles; i++)
+	std::vector<std::string> columnNames = { "person_id", "tour_no", "tour_type", "stop_no", "stop_type", "stop_location",
+			"stop_zone", "stop_mode", "primary_stop", "arrival_time", "departure_time",
+			"prev_stop_location", "prev_stop_zone", "prev_stop_departure_time" };
+	if (MT_Config::getInstance().isEnergyModelEnabled())
 	{
-		fileName << prefix << i << ".log";
-		outFileNamesList.push_back(fileName.str());
-		fileName.str(std::string());
+		columnNames.push_back("drivetrain");
+		columnNames.push_back("make");
+		columnNames.push_back("model");
 	}
-}
-
-void mergeCSV_Files(const std::list<std::string>& fileNameList, const std::string& fileName)
-{
-	//This can take some time.
-	StopWatch sw;
-	sw.start();
-	std::cout << "Merging files, this can take several minutes...\n";
-
-	//One-by-one.
-	std::ofstream out(fileName.c_str(), std::ios::trunc | std::ios::binary);
-	if (!out.good())
-	{
-		throw std::runtime_error("Error: Can't write to file.");
-	}
-	for (std::list<std::string>::const_iterator it = fileNameList.begin(); it != fileNameList.end(); it++)
-	{
-		Print() << "  Merging: " << *it << std::endl;
-		std::ifstream src(it->c_str(), std::ios::binary);
-		if (src.fail())
-		{
-			throw std::runtime_error("Error: Can't read from file.");
-		}
-
-		//If src is good, this part's easy.
-		out << src.rdbuf();
-		src.close();
-	}
-	out.close();
-
-	sw.stop();
-	std::cout << "Files merged; took " << sw.getTime() << "s\n";
+	return columnNames;
 }
 
 /**
@@ -554,7 +548,8 @@ DB_Connection getDB_Connection(const DatabaseDetails& dbInfo)
 } //end anonymous namespace
 
 sim_mob::medium::PredayManager::PredayManager() :
-		mtConfig(MT_Config::getInstance()), logFile(nullptr)
+		mtConfig(MT_Config::getInstance()), logFile(nullptr), dataCacheUsable(MT_Config::getInstance().predayDataCache.enabled),
+		activityScheduleStreamed(false)
 {
 }
 
@@ -568,6 +563,11 @@ sim_mob::medium::PredayManager::~PredayManager()
 	}
 	personList.clear();
 
+	clearZoneData();
+}
+
+void sim_mob::medium::PredayManager::clearZoneData()
+{
 	// clear Zones
 	Print() << "Clearing zoneMap\n";
 	for (ZoneMap::iterator i = zoneMap.begin(); i != zoneMap.end(); i++)
@@ -575,48 +575,13 @@ sim_mob::medium::PredayManager::~PredayManager()
 		delete i->second;
 	}
 	zoneMap.clear();
+	zoneIdLookup.clear();
 
-	// clear AMCosts
-	Print() << "Clearing amCostMap\n";
-	for (CostMap::iterator i = amCostMap.begin(); i != amCostMap.end(); i++)
-	{
-		for (boost::unordered_map<int, CostParams*>::iterator j = i->second.begin(); j != i->second.end(); j++)
-		{
-			if (j->second)
-			{
-				delete j->second;
-			}
-		}
-	}
-	amCostMap.clear();
-
-	// clear PMCosts
-	Print() << "Clearing pmCostMap\n";
-	for (CostMap::iterator i = pmCostMap.begin(); i != pmCostMap.end(); i++)
-	{
-		for (boost::unordered_map<int, CostParams*>::iterator j = i->second.begin(); j != i->second.end(); j++)
-		{
-			if (j->second)
-			{
-				delete j->second;
-			}
-		}
-	}
-	pmCostMap.clear();
-
-	// clear OPCosts
-	Print() << "Clearing opCostMap\n";
-	for (CostMap::iterator i = opCostMap.begin(); i != opCostMap.end(); i++)
-	{
-		for (boost::unordered_map<int, CostParams*>::iterator j = i->second.begin(); j != i->second.end(); j++)
-		{
-			if (j->second)
-			{
-				delete j->second;
-			}
-		}
-	}
-	opCostMap.clear();
+	// clear costs
+	Print() << "Clearing skims\n";
+	amCosts.clear();
+	pmCosts.clear();
+	opCosts.clear();
 
 	// clear Zone node map
 	Print() << "Clearing zoneNodeMap\n";
@@ -630,6 +595,8 @@ sim_mob::medium::PredayManager::~PredayManager()
 		znParamsList.clear();
 	}
 	zoneNodeMap.clear();
+
+	unavailableODs.clear();
 }
 
 void sim_mob::medium::PredayManager::loadPersonIds()
@@ -646,7 +613,127 @@ void sim_mob::medium::PredayManager::loadPersonIds()
 	}
 }
 
+bool sim_mob::medium::PredayManager::openDataCache()
+{
+	if (!dataCacheUsable)
+	{
+		return false;
+	}
+	if (dataCache.isOpen())
+	{
+		return true;
+	}
+
+	DB_Connection simmobConn = getDB_Connection(ConfigManager::GetInstance().FullConfig().networkDatabase);
+	simmobConn.connect();
+	if (!simmobConn.isConnected())
+	{
+		throw std::runtime_error("simmob db connection failure!");
+	}
+	const std::string& fileName = mtConfig.predayDataCache.fileName;
+	std::string sourceKey;
+	std::string reason;
+	try
+	{
+		sourceKey = PredayDataCache::computeSourceKey(simmobConn);
+	}
+	catch (std::runtime_error& ex)
+	{
+		Warn() << "Could not check preday data cache " << fileName << " against the database: " << ex.what() << "\n";
+		dataCacheUsable = false;
+		return false;
+	}
+
+	if (dataCache.open(fileName, sourceKey, reason))
+	{
+		Print() << "Preday data cache " << fileName << " is up to date\n";
+		return true;
+	}
+
+	// export step: load everything from the database once, write it out and use the fresh file from now on
+	Print() << "Preday data cache not used: " << reason << "\nExporting zones and skims to " << fileName << "\n";
+	try
+	{
+		loadZonesFromDB();
+		loadCostsFromDB();
+		loadZoneNodesFromDB();
+		loadUnavailableODsFromDB();
+		PredayDataCache::save(fileName, sourceKey, zoneMap, ZoneSqlDao::ZoneWithoutNodeSet, zoneNodeMap, unavailableODs, amCosts, pmCosts,
+				opCosts);
+	}
+	catch (std::runtime_error& ex)
+	{
+		Warn() << "Could not export preday data cache: " << ex.what() << "\n";
+		clearZoneData();
+		dataCacheUsable = false;
+		return false;
+	}
+	clearZoneData();
+
+	if (!dataCache.open(fileName, sourceKey, reason))
+	{
+		throw std::runtime_error("exported preday data cache could not be opened: " + reason);
+	}
+	return true;
+}
+
 void sim_mob::medium::PredayManager::loadZones()
+{
+	if (openDataCache())
+	{
+		dataCache.loadZones(zoneMap, ZoneSqlDao::ZoneWithoutNodeSet);
+		for (auto& zoneMapKeyVal : zoneMap)
+		{
+			zoneIdLookup[zoneMapKeyVal.second->getZoneCode()] = zoneMapKeyVal.first;
+		}
+		Print() << "MTZ Zones loaded from cache\n";
+	}
+	else
+	{
+		loadZonesFromDB();
+	}
+}
+
+void sim_mob::medium::PredayManager::loadZoneNodes()
+{
+	if (openDataCache())
+	{
+		dataCache.loadZoneNodes(zoneNodeMap);
+		Print() << "Zones-Node mapping loaded from cache\n";
+	}
+	else
+	{
+		loadZoneNodesFromDB();
+	}
+}
+
+void sim_mob::medium::PredayManager::loadCosts()
+{
+	if (openDataCache())
+	{
+		dataCache.loadCosts(amCosts, pmCosts, opCosts);
+		Print() << "Skims mapped from cache: " << amCosts.getNumZones() << " zones, " << amCosts.getNumODs() << " OD pairs per period\n";
+	}
+	else
+	{
+		loadCostsFromDB();
+	}
+}
+
+void sim_mob::medium::PredayManager::loadUnavailableODs()
+{
+	if (openDataCache())
+	{
+		dataCache.loadUnavailableODs(unavailableODs);
+		Print() << "Unavailable ODs loaded from cache\n";
+	}
+	else
+	{
+		loadUnavailableODsFromDB();
+	}
+}
+
+void sim_mob::medium::PredayManager::loadZonesFromDB()
 {
 	DB_Connection simmobConn = getDB_Connection(ConfigManager::GetInstance().FullConfig().networkDatabase);
 	simmobConn.connect();
@@ -667,7 +754,7 @@ void sim_mob::medium::PredayManager::loadZones()
 	}
 }
 
-void sim_mob::medium::PredayManager::loadZoneNodes()
+void sim_mob::medium::PredayManager::loadZoneNodesFromDB()
 {
 	DB_Connection simmobConn = getDB_Connection(ConfigManager::GetInstance().FullConfig().networkDatabase);
 	simmobConn.connect();
@@ -698,20 +785,18 @@ void sim_mob::medium::PredayManager::loadPostcodeNodeMapping()
 	}
 }
 
-void sim_mob::medium::PredayManager::loadCosts()
+void sim_mob::medium::PredayManager::loadCostsFromDB()
 {
-	ZoneMap::size_type nZones = zoneMap.size();
-	if (nZones > 0)
+	if (zoneIdLookup.empty())
 	{
-		// if the zone data was loaded already we can reserve space for costs to speed up the loading
-		// Cost data will be available for every pair (a,b) of zones where a!=b
-		CostMap::size_type mapSz = (nZones * nZones) - nZones;
-
-		amCostMap.rehash(ceil(mapSz / amCostMap.max_load_factor()));
-		pmCostMap.rehash(ceil(mapSz / pmCostMap.max_load_factor()));
-		opCostMap.rehash(ceil(mapSz / opCostMap.max_load_factor()));
+		throw std::runtime_error("zones must be loaded before costs");
 	}
 
+	// costs are stored densely for every pair of zones, indexed in zone id order
+	amCosts.initialize(zoneIdLookup);
+	pmCosts.initialize(zoneIdLookup);
+	opCosts.initialize(zoneIdLookup);
+
 	DB_Connection simmobConn = getDB_Connection(ConfigManager::GetInstance().FullConfig().networkDatabase);
 	simmobConn.connect();
 	if (simmobConn.isConnected())
@@ -722,22 +807,24 @@ void sim_mob::medium::PredayManager::loadCosts()
 		const std::string DB_TABLE_AM_COSTS = APPLY_SCHEMA(DEMAND_SCHEMA, TABLE_NAME);
 		const std::string DB_GET_ALL_AM_COSTS = "SELECT * FROM " + DB_TABLE_AM_COSTS;
 		CostSqlDao amCostDao(simmobConn, DB_GET_ALL_AM_COSTS);
-		amCostDao.getAll(amCostMap);
+		amCostDao.getAll(amCosts);
 		Print() << "AM costs loaded\n";
 
 		TABLE_NAME = ConfigManager::GetInstanceRW().FullConfig().dbTableNamesMap["PM_cost_table"];
 		const std::string DB_TABLE_PM_COSTS = APPLY_SCHEMA(DEMAND_SCHEMA, TABLE_NAME);
 		const std::string DB_GET_ALL_PM_COSTS = "SELECT * FROM " + DB_TABLE_PM_COSTS;
 		CostSqlDao pmCostDao(simmobConn, DB_GET_ALL_PM_COSTS);
-		pmCostDao.getAll(pmCostMap);
+		pmCostDao.getAll(pmCosts);
 		Print() << "PM costs loaded\n";
 
 		TABLE_NAME = ConfigManager::GetInstanceRW().FullConfig().dbTableNamesMap["OP_cost_table"];
 		const std::string DB_TABLE_OP_COSTS = APPLY_SCHEMA(DEMAND_SCHEMA, TABLE_NAME);
 		const std::string DB_GET_ALL_OP_COSTS = "SELECT * FROM " + DB_TABLE_AM_COSTS;
 		CostSqlDao opCostDao(simmobConn, DB_GET_ALL_OP_COSTS);
-		opCostDao.getAll(opCostMap);
+		opCostDao.getAll(opCosts);
 		Print() << "OP costs loaded\n";
+		Print() << "Skims: " << amCosts.getNumZones() << " zones, " << amCosts.getNumODs() << " OD pairs per period, "
+				<< (amCosts.getMemoryUsage() + pmCosts.getMemoryUsage() + opCosts.getMemoryUsage()) / (1024 * 1024) << " MB\n";
 	}
 	else
 	{
@@ -747,7 +834,7 @@ void sim_mob::medium::PredayManager::loadCosts()
 	}
 }
 
-void sim_mob::medium::PredayManager::loadUnavailableODs()
+void sim_mob::medium::PredayManager::loadUnavailableODsFromDB()
 {
 	DB_Connection simmobConn = getDB_Connection(ConfigManager::GetInstance().FullConfig().networkDatabase);
 	simmobConn.connect();
@@ -763,16 +850,6 @@ void sim_mob::medium::PredayManager::loadUnavailableODs()
 
 void sim_mob::medium::PredayManager::dispatchLT_Persons()
 {
-	boost::thread_group threadGroup;
-	unsigned numWorkers = mtConfig.getNumPredayThreads();
-	std::list<std::string> logFileNames;
-	std::string logFileNamePrefix;
-	if (mtConfig.runningPredaySimulation())
-	{
-		logFileNamePrefix = "activity_schedule";
-	}
-	constructFileNames(numWorkers, logFileNamePrefix, logFileNames);
-
 	if(mtConfig.runningPredayLogsumComputation())
 	{
 		// logsum data source
@@ -803,77 +880,25 @@ void sim_mob::medium::PredayManager::dispatchLT_Persons()
 		}
 	}
 
-	if (numWorkers == 1)
-	{ // if single threaded execution was requested
-		if (mtConfig.runningPredaySimulation())
-		{
-			processPersonsForLT_Population(ltPersonIdList.begin(), ltPersonIdList.end(), logFileNames.front());
-		}
-		else if (mtConfig.runningPredayLogsumComputation())
-		{
-			computeLogsumsForLT_Population(ltPersonIdList.begin(), ltPersonIdList.end());
-		}
-	}
-	else
+	if (mtConfig.runningPredaySimulation())
 	{
-		LT_PersonIdList::size_type numPersons = ltPersonIdList.size();
-		LT_PersonIdList::size_type numPersonsPerThread = numPersons / numWorkers;
-		Print() << "numPersons:" << numPersons << "|numWorkers:" << numWorkers << "|numPersonsPerThread:" << numPersonsPerThread << std::endl;
-
-		/*
-		 * We are passing different iterators on the same list into the threaded
-		 * function. Each thread will iterate through a mutually exclusive and
-		 * exhaustive set of persons from the population.
-		 *
-		 * Note that each thread will iterate the same personList with different
-		 * start and end iterators. It is therefore important that none of the
-		 * threads change the personList.
-		 */
-		LT_PersonIdList::iterator first = ltPersonIdList.begin();
-		LT_PersonIdList::iterator last = ltPersonIdList.begin() + numPersonsPerThread;
-		std::list<std::string>::const_iterator fileNameIt = logFileNames.begin();
-		for (int i = 1; i <= numWorkers; i++)
+		std::vector< boost::shared_ptr<OutputSink> > sinks;
+		if (mtConfig.isFileOutputEnabled())
 		{
-			if (mtConfig.runningPredaySimulation())
-			{
-				threadGroup.create_thread(boost::bind(&PredayManager::processPersonsForLT_Population, this, first, last, (*fileNameIt)));
-				fileNameIt++;
-			}
-			else if (mtConfig.runningPredayLogsumComputation())
-			{
-				threadGroup.create_thread(boost::bind(&PredayManager::computeLogsumsForLT_Population, this, first, last));
-			}
-
-			first = last;
-			if (i + 1 == numWorkers)
-			{
-				// if the next iteration is the last take all remaining persons
-				last = ltPersonIdList.end();
-			}
-			else
-			{
-				last = last + numPersonsPerThread;
-			}
+			sinks.push_back(boost::shared_ptr<OutputSink>(new FileOutputSink(ACTIVITY_SCHEDULE_FILE_NAME)));
 		}
-		threadGroup.join_all();
+		simulateLT_Population(sinks);
 	}
-
-	// merge log files from each thread into 1 file.
-	if (mtConfig.isFileOutputEnabled())
+	else if (mtConfig.runningPredayLogsumComputation())
 	{
-		mergeCSV_Files(logFileNames, logFileNamePrefix);
+		distributePersons(ltPersonIdList.size(), boost::bind(&PredayManager::computeLogsumsForLT_Population, this, _1, _2),
+				"logsum computation");
 	}
 }
 
 
 void PredayManager::runLogSumComputation()
 {
-    boost::thread_group threadGroup;
-    unsigned numWorkers = mtConfig.getNumPredayThreads();
-    std::list<std::string> logFileNames;
-    std::string logFileNamePrefix;
-    constructFileNames(numWorkers, logFileNamePrefix, logFileNames);
-
     // logsum data source
     DB_Connection simmobConn = getDB_Connection(ConfigManager::GetInstance().FullConfig().networkDatabase);
     simmobConn.connect();
@@ -901,102 +926,50 @@ void PredayManager::runLogSumComputation()
         Print() << logsumTableName << " truncation failed!\n";
     }
 
-    if (numWorkers == 1)
-    { // if single threaded execution was requested
-        computeLogsumsForLT_Population(ltPersonIdList.begin(), ltPersonIdList.end());
-    }
-    else
+    distributePersons(ltPersonIdList.size(), boost::bind(&PredayManager::computeLogsumsForLT_Population, this, _1, _2),
+            "logsum computation");
+}
+
+
+void PredayManager::runPredaySimulation()
+{
+    std::vector< boost::shared_ptr<OutputSink> > sinks;
+    if (mtConfig.isFileOutputEnabled())
     {
-        LT_PersonIdList::size_type numPersons = ltPersonIdList.size();
-        LT_PersonIdList::size_type numPersonsPerThread = numPersons / numWorkers;
-        Print() << "numPersons:" << numPersons << "|numWorkers:" << numWorkers << "|numPersonsPerThread:" << numPersonsPerThread << std::endl;
-
-        /*
-         * We are passing different iterators on the same list into the threaded
-         * function. Each thread will iterate through a mutually exclusive and
-         * exhaustive set of persons from the population.
-         *
-         * Note that each thread will iterate the same personList with different
-         * start and end iterators. It is therefore important that none of the
-         * threads change the personList.
-         */
-        LT_PersonIdList::iterator first = ltPersonIdList.begin();
-        LT_PersonIdList::iterator last = ltPersonIdList.begin() + numPersonsPerThread;
-        std::list<std::string>::const_iterator fileNameIt = logFileNames.begin();
-        for (int i = 1; i <= numWorkers; i++)
-        {
-            threadGroup.create_thread(boost::bind(&PredayManager::computeLogsumsForLT_Population, this, first, last));
-            first = last;
-            if (i + 1 == numWorkers)
-            {
-                // if the next iteration is the last take all remaining persons
-                last = ltPersonIdList.end();
-            }
-            else
-            {
-                last = last + numPersonsPerThread;
-            }
-        }
-        threadGroup.join_all();
+        sinks.push_back(boost::shared_ptr<OutputSink>(new FileOutputSink(ACTIVITY_SCHEDULE_FILE_NAME)));
     }
 
+    // stream the schedules straight into the day activity schedule table while the persons are simulated
+    activityScheduleStreamed = false;
+    if (mtConfig.dasConfig.streamToDatabase)
+    {
+        createDayActivityScheduleTable();
+        std::string tableName = mtConfig.dasConfig.schema + "." + mtConfig.dasConfig.table;
+        sinks.push_back(boost::shared_ptr<OutputSink>(new PG_CopySink(ConfigManager::GetInstance().FullConfig().getDatabaseConnectionString(false),
+                tableName, getDayActivityScheduleColumns())));
+    }
 
+    simulateLT_Population(sinks);
+    activityScheduleStreamed = mtConfig.dasConfig.streamToDatabase;
 }
 
-
-void PredayManager::runPredaySimulation()
+void PredayManager::simulateLT_Population(const std::vector< boost::shared_ptr<OutputSink> >& sinks)
 {
-    boost::thread_group threadGroup;
-    unsigned numWorkers = mtConfig.getNumPredayThreads();
-    std::list<std::string> logFileNames;
-    std::string logFileNamePrefix;
-    logFileNamePrefix = "activity_schedule";
-    constructFileNames(numWorkers, logFileNamePrefix, logFileNames);
-    if (numWorkers == 1)
-    { // if single threaded execution was requested
-        processPersonsForLT_Population(ltPersonIdList.begin(), ltPersonIdList.end(), logFileNames.front());
-    }
-    else
+    boost::scoped_ptr<OutputStreamer> scheduleOutput;
+    if (!sinks.empty())
     {
-        LT_PersonIdList::size_type numPersons = ltPersonIdList.size();
-        LT_PersonIdList::size_type numPersonsPerThread = numPersons / numWorkers;
-        Print() << "numPersons:" << numPersons << "|numWorkers:" << numWorkers << "|numPersonsPerThread:" << numPersonsPerThread << std::endl;
-
-        /*
-         * We are passing different iterators on the same list into the threaded
-         * function. Each thread will iterate through a mutually exclusive and
-         * exhaustive set of persons from the population.
-         *
-         * Note that each thread will iterate the same personList with different
-         * start and end iterators. It is therefore important that none of the
-         * threads change the personList.
-         */
-        LT_PersonIdList::iterator first = ltPersonIdList.begin();
-        LT_PersonIdList::iterator last = ltPersonIdList.begin() + numPersonsPerThread;
-        std::list<std::string>::const_iterator fileNameIt = logFileNames.begin();
-        for (int i = 1; i <= numWorkers; i++)
-        {
-            threadGroup.create_thread(boost::bind(&PredayManager::processPersonsForLT_Population, this, first, last, (*fileNameIt)));
-            fileNameIt++;
-
-            first = last;
-            if (i + 1 == numWorkers)
-            {
-                // if the next iteration is the last take all remaining persons
-                last = ltPersonIdList.end();
-            }
-            else
-            {
-                last = last + numPersonsPerThread;
-            }
-        }
-        threadGroup.join_all();
+        size_t numThreads = mtConfig.getNumPredayThreads();
+        scheduleOutput.reset(new OutputStreamer(numThreads, ACTIVITY_SCHEDULE_BUFFER_SIZE, numThreads * ACTIVITY_SCHEDULE_QUEUED_BUFFERS_PER_THREAD, sinks));
     }
 
-    // merge log files from each thread into 1 file.
-    if (mtConfig.isFileOutputEnabled())
+    distributePersons(ltPersonIdList.size(), boost::bind(&PredayManager::processPersonsForLT_Population, this, _1, _2, scheduleOutput.get()),
+            "preday simulation");
+
+    if (scheduleOutput)
     {
-        mergeCSV_Files(logFileNames, logFileNamePrefix);
+        scheduleOutput->finish();
+        Print() << "activity schedules: " << scheduleOutput->getBytesWritten() << " bytes written; threads waited "
+                << scheduleOutput->getWaitSeconds() << "s for the writer" << std::endl;
     }
 }
 
@@ -1007,6 +980,31 @@ void PredayManager::updateDayActivityScheduleTable()
 
 	std::string tableName = mtCfg.dasConfig.schema + "." + mtCfg.dasConfig.table;
 
+	// the schedules have already been copied into the table if they were streamed during the simulation
+	if (!activityScheduleStreamed)
+	{
+		createDayActivityScheduleTable();
+
+		PG_BulkInserter bulkInserter(NUM_INSERTS_PER_QUERY);
+		bulkInserter.setInputFile(mtCfg.dasConfig.fileName);
+		bulkInserter.buildQuery(tableName, getDayActivityScheduleColumns());
+		bulkInserter.connect(ConfigManager::GetInstance().FullConfig().getDatabaseConnectionString(false));
+		bulkInserter.bulkInsert();
+	}
+
+	soci::session sql_(soci::postgresql, ConfigManager::GetInstanceRW().FullConfig().getDatabaseConnectionString(false));
+
+	/// Create Indexes and update sharing modes
+	soci::statement query = (sql_.prepare << "SELECT " << mtCfg.dasConfig.updateProc << "('" << mtCfg.dasConfig.schema << "','" << mtCfg.dasConfig.table << "');");
+	query.execute();
+
+	sql_.close();
+}
+
+void PredayManager::createDayActivityScheduleTable()
+{
+	std::string tableName = mtConfig.dasConfig.schema + "." + mtConfig.dasConfig.table;
+
 	soci::session sql_(soci::postgresql, ConfigManager::GetInstanceRW().FullConfig().getDatabaseConnectionString(false));
 	/// Delete the table if it already exists
 	soci::statement query = (sql_.prepare << "DROP TABLE IF EXISTS " << tableName);
@@ -1064,29 +1062,6 @@ void PredayManager::updateDayActivityScheduleTable()
 	query = (sql_.prepare << "ALTER TABLE " << tableName << " OWNER TO postgres");
 	query.execute();
 
-	PG_BulkInserter bulkInserter(NUM_INSERTS_PER_QUERY);
-	bulkInserter.setInputFile(mtCfg.dasConfig.fileName);
-    std::vector<std::string> columnNames;
-    if(!(MT_Config::getInstance().isEnergyModelEnabled()))
-    {
-        columnNames = {"person_id", "tour_no", "tour_type", "stop_no", "stop_type", "stop_location",
-                                                "stop_zone", "stop_mode", "primary_stop", "arrival_time", "departure_time",
-                                                "prev_stop_location", "prev_stop_zone", "prev_stop_departure_time"};
-    }
-    else
-    {
-        columnNames = {"person_id", "tour_no", "tour_type", "stop_no", "stop_type", "stop_location",
-                       "stop_zone", "stop_mode", "primary_stop", "arrival_time", "departure_time",
-                       "prev_stop_location", "prev_stop_zone", "prev_stop_departure_time","drivetrain","make","model"};
-    }
-	bulkInserter.buildQuery(tableName, columnNames);
-	bulkInserter.connect(ConfigManager::GetInstance().FullConfig().getDatabaseConnectionString(false));
-	bulkInserter.bulkInsert();
-
-	/// Create Indexes and update sharing modes
-	query = (sql_.prepare << "SELECT " << mtCfg.dasConfig.updateProc << "('" << mtCfg.dasConfig.schema << "','" << mtCfg.dasConfig.table << "');");
-	query.execute();
-
 	sql_.close();
 }
 
@@ -1164,46 +1139,27 @@ void PredayManager::updateGetPersonBetweenStoredProc()
 
 void sim_mob::medium::PredayManager::distributeAndProcessForCalibration(threadedFnPtr fnPtr)
 {
-	boost::thread_group threadGroup;
-	size_t numWorkers = mtConfig.getNumPredayThreads();
-	if (numWorkers == 1)
-	{ // if single threaded execution was requested
-		(this->*fnPtr)(personList.begin(), personList.end(), 0);
-	}
-	else
-	{
-		size_t numPersons = personList.size();
-		size_t numPersonsPerThread = numPersons / numWorkers;
-		PersonList::iterator first = personList.begin();
-		PersonList::iterator last = personList.begin() + numPersonsPerThread;
-		Print() << "numPersons:" << numPersons << "|numWorkers:" << numWorkers << "|numPersonsPerThread:" << numPersonsPerThread << std::endl;
-
-		/*
-		 * Passing different iterators on the same list into the threaded
-		 * function. So each thread will iterate mutually exclusive and
-		 * exhaustive set of persons from the population.
-		 *
-		 * Note that each thread will iterate the same personList with different
-		 * start and end iterators. It is therefore important that none of the
-		 * threads change the personList.
-		 */
-		for (size_t i = 1; i <= numWorkers; i++)
-		{
-			threadGroup.create_thread(boost::bind(fnPtr, this, first, last, i - 1));
+	distributePersons(personList.size(), boost::bind(fnPtr, this, _1, _2), "calibration");
+}
 
-			first = last;
-			if (i + 1 == numWorkers)
-			{
-				// if the next iteration is the last take all remaining persons
-				last = personList.end();
-			}
-			else
-			{
-				last = last + numPersonsPerThread;
-			}
-		}
-		threadGroup.join_all();
-	}
+void sim_mob::medium::PredayManager::distributePersons(size_t numPersons, const WorkStealingPool::WorkerFunction& worker, const std::string& jobName)
+{
+	/*
+	 * Persons are handed out to the threads in chunks. Each thread starts with a
+	 * contiguous share of the persons and steals chunks from the other threads
+	 * once it is done with its own, so that threads which happen to get cheap
+	 * persons (e.g. non-workers) help the others instead of waiting for them.
+	 *
+	 * Threads only read the person lists; none of them may change a list.
+	 */
+	WorkStealingPool pool(numPersons, mtConfig.getNumPredayThreads(), mtConfig.getPredayChunkSize());
+	Print() << jobName << " | numPersons:" << numPersons << "|numWorkers:" << pool.getNumWorkers()
+			<< "|chunkSize:" << mtConfig.getPredayChunkSize() << std::endl;
+	pool.run(worker);
+
+	std::ostringstream stats;
+	pool.printStats(stats, jobName);
+	Print() << stats.str();
 }
 
 void sim_mob::medium::PredayManager::calibratePreday()
@@ -1408,8 +1364,7 @@ void sim_mob::medium::PredayManager::loadWeightMatrix()
 	}
 }
 
-void sim_mob::medium::PredayManager::processPersonsForCalibration(const PersonList::iterator& firstPersonIt, const PersonList::iterator& oneAfterLastPersonIt,
-		size_t threadNum)
+void sim_mob::medium::PredayManager::processPersonsForCalibration(WorkStealingPool& pool, size_t threadNum)
 {
 	CalibrationStatistics& simStats = simulatedStatsVector.at(threadNum);
 	bool consoleOutput = mtConfig.isConsoleOutput();
@@ -1427,14 +1382,21 @@ void sim_mob::medium::PredayManager::processPersonsForCalibration(const PersonLi
 
     const std::unordered_map<StopType, ActivityTypeConfig>& activityTypeConfig = cfg.getActivityTypeConfigMap();
 
-	for (PersonList::iterator i = firstPersonIt; i != oneAfterLastPersonIt; i++)
+	size_t first, last;
+	while (pool.nextChunk(threadNum, first, last))
 	{
-        PredaySystem predaySystem(**i, zoneMap, zoneIdLookup, amCostMap, pmCostMap, opCostMap, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
-		predaySystem.planDay();
-		predaySystem.updateStatistics(simStats);
-		if (consoleOutput)
+		for (size_t idx = first; idx != last; idx++)
 		{
-			predaySystem.printLogs();
+			RandomStream personRandom(getPersonStreamId(personList[idx]->getPersonId()), RANDOM_PREDAY);
+			RandomService::Scope randomScope(personRandom);
+			seedPredayModels(personRandom);
+			PredaySystem predaySystem(*personList[idx], zoneMap, zoneIdLookup, amCosts, pmCosts, opCosts, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
+			predaySystem.planDay();
+			predaySystem.updateStatistics(simStats);
+			if (consoleOutput)
+			{
+				predaySystem.printLogs();
+			}
 		}
 	}
 }
@@ -1517,10 +1479,8 @@ void sim_mob::medium::PredayManager::computeWeightedGradient(const std::vector<s
 	}
 }
 
-void sim_mob::medium::PredayManager::processPersonsForLT_Population(const LT_PersonIdList::iterator& firstPersonIdIt,
-		const LT_PersonIdList::iterator& oneAfterLastPersonIdIt, const std::string& activityScheduleLog)
+void sim_mob::medium::PredayManager::processPersonsForLT_Population(WorkStealingPool& pool, size_t threadNum, OutputStreamer* scheduleOutput)
 {
-	bool outputTripchains = mtConfig.isFileOutputEnabled();
 	bool consoleOutput = mtConfig.isConsoleOutput();
 
     const ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
@@ -1553,37 +1513,42 @@ void sim_mob::medium::PredayManager::processPersonsForLT_Population(const LT_Per
 	SimmobSqlDao logsumSqlDao(simmobConn, logsumTableName, activityLogsumColumns);
 	TimeDependentTT_SqlDao tcostDao(simmobConn);
 
-	// open log file for this thread
-	std::ofstream activityScheduleLogFile(activityScheduleLog.c_str(), std::ios::trunc | std::ios::out);
 	std::stringstream activityScheduleStream;
 
-	// loop through all persons within the range and plan their day
-	for (LT_PersonIdList::iterator i = firstPersonIdIt; i != oneAfterLastPersonIdIt; i++)
+	// loop through all persons of the chunks given to this thread and plan their day
+	size_t first, last;
+	while (pool.nextChunk(threadNum, first, last))
 	{
-		PersonParams personParams;
-		populationDao.getOneById(*i, personParams);
-		if (personParams.getPersonId().empty())
-		{
-			continue;
-		} // some persons are not complete in the database
-		logsumSqlDao.getLogsumById(*i, personParams);
-		PredaySystem predaySystem(personParams, zoneMap, zoneIdLookup, amCostMap, pmCostMap, opCostMap, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
-		predaySystem.planDay();
-
-		if (outputTripchains)
+		for (size_t idx = first; idx != last; idx++)
 		{
-			predaySystem.outputActivityScheduleToStream(zoneNodeMap, activityScheduleStream);
-			outputToFile(activityScheduleLogFile, activityScheduleStream);
-		}
-		if (consoleOutput)
-		{
-			predaySystem.printLogs();
+			PersonParams personParams;
+			populationDao.getOneById(ltPersonIdList[idx], personParams);
+			if (personParams.getPersonId().empty())
+			{
+				continue;
+			} // some persons are not complete in the database
+			logsumSqlDao.getLogsumById(ltPersonIdList[idx], personParams);
+			RandomStream personRandom(getPersonStreamId(personParams.getPersonId()), RANDOM_PREDAY);
+			RandomService::Scope randomScope(personRandom);
+			seedPredayModels(personRandom);
+			PredaySystem predaySystem(personParams, zoneMap, zoneIdLookup, amCosts, pmCosts, opCosts, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
+			predaySystem.planDay();
+
+			if (scheduleOutput)
+			{
+				predaySystem.outputActivityScheduleToStream(zoneNodeMap, activityScheduleStream);
+				scheduleOutput->append(threadNum, activityScheduleStream.str());
+				activityScheduleStream.str(std::string());
+			}
+			if (consoleOutput)
+			{
+				predaySystem.printLogs();
+			}
 		}
 	}
 }
 
-void sim_mob::medium::PredayManager::computeLogsumsForCalibration(const PersonList::iterator& firstPersonIt, const PersonList::iterator& oneAfterLastPersonIt,
-		size_t threadNum)
+void sim_mob::medium::PredayManager::computeLogsumsForCalibration(WorkStealingPool& pool, size_t threadNum)
 {
 	bool consoleOutput = mtConfig.isConsoleOutput();
 	const ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
@@ -1598,20 +1563,23 @@ void sim_mob::medium::PredayManager::computeLogsumsForCalibration(const PersonLi
 	TimeDependentTT_SqlDao tcostDao(simmobConn);
 	const std::unordered_map<StopType, ActivityTypeConfig>& activityTypeConfig = cfg.getActivityTypeConfigMap();
 
-	// loop through all persons within the range and plan their day
-	for (PersonList::iterator i = firstPersonIt; i != oneAfterLastPersonIt; i++)
+	// loop through all persons of the chunks given to this thread and compute their logsums
+	size_t first, last;
+	while (pool.nextChunk(threadNum, first, last))
 	{
-		PredaySystem predaySystem(**i, zoneMap, zoneIdLookup, amCostMap, pmCostMap, opCostMap, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
-		predaySystem.computeLogsums();
-		if (consoleOutput)
+		for (size_t idx = first; idx != last; idx++)
 		{
-			predaySystem.printLogs();
+			PredaySystem predaySystem(*personList[idx], zoneMap, zoneIdLookup, amCosts, pmCosts, opCosts, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
+			predaySystem.computeLogsums();
+			if (consoleOutput)
+			{
+				predaySystem.printLogs();
+			}
 		}
 	}
 }
 
-void sim_mob::medium::PredayManager::computeLogsumsForLT_Population(const LT_PersonIdList::iterator& firstPersonIdIt,
-		const LT_PersonIdList::iterator& oneAfterLastPersonIdIt)
+void sim_mob::medium::PredayManager::computeLogsumsForLT_Population(WorkStealingPool& pool, size_t threadNum)
 {
 	bool consoleOutput = mtConfig.isConsoleOutput();
 
@@ -1644,21 +1612,25 @@ void sim_mob::medium::PredayManager::computeLogsumsForLT_Population(const LT_Per
 	SimmobSqlDao logsumSqlDao(simmobConn, logsumTableName, activityLogsumColumns);
 	TimeDependentTT_SqlDao tcostDao(simmobConn);
 
-	// loop through all persons within the range and plan their day
-	for (LT_PersonIdList::iterator i = firstPersonIdIt; i != oneAfterLastPersonIdIt; i++)
+	// loop through all persons of the chunks given to this thread and compute their logsums
+	size_t first, last;
+	while (pool.nextChunk(threadNum, first, last))
 	{
-		PersonParams personParams;
-		populationDao.getOneById(*i, personParams);
-		if (personParams.getPersonId().empty())
-		{
-			continue;
-		} // some persons are not complete in the database
-        PredaySystem predaySystem(personParams, zoneMap, zoneIdLookup, amCostMap, pmCostMap, opCostMap, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
-		predaySystem.computeLogsums();
-		logsumSqlDao.insert(personParams);
-		if (consoleOutput)
+		for (size_t idx = first; idx != last; idx++)
 		{
-			predaySystem.printLogs();
+			PersonParams personParams;
+			populationDao.getOneById(ltPersonIdList[idx], personParams);
+			if (personParams.getPersonId().empty())
+			{
+				continue;
+			} // some persons are not complete in the database
+			PredaySystem predaySystem(personParams, zoneMap, zoneIdLookup, amCosts, pmCosts, opCosts, tcostDao, unavailableODs, activityTypeConfig, cfg.getNumTravelModes());
+			predaySystem.computeLogsums();
+			logsumSqlDao.insert(personParams);
+			if (consoleOutput)
+			{
+				predaySystem.printLogs();
+			}
 		}
 	}
 }
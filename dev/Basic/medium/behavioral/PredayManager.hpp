@@ -5,16 +5,21 @@
 #pragma once
 #include <boost/unordered_map.hpp>
 #include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 #include <ostream>
 #include <sstream>
 #include <string>
 #include <vector>
 #include "behavioral/params/PersonParams.hpp"
+#include "behavioral/PredayDataCache.hpp"
+#include "behavioral/params/SkimMatrix.hpp"
 #include "behavioral/params/ZoneCostParams.hpp"
 #include "CalibrationStatistics.hpp"
 #include "config/MT_Config.hpp"
 #include "PredaySystem.hpp"
 #include "PredayClasses.hpp"
+#include "util/OutputStreamer.hpp"
+#include "util/threadpool/WorkStealingPool.hpp"
 
 namespace sim_mob
 {
@@ -154,6 +159,10 @@ public:
 
     void runPredaySimulation();
 
+    /**
+     * loads the activity schedules of the preday simulation into the day activity schedule table, unless they were
+     * streamed into it during the simulation, and runs the table update procedure
+     */
     void updateDayActivityScheduleTable();
 
     void updateGetPersonBetweenStoredProc();
@@ -167,7 +176,6 @@ public:
 private:
     typedef std::vector<PersonParams*> PersonList;
     typedef boost::unordered_map<int, ZoneParams*> ZoneMap;
-    typedef boost::unordered_map<int, boost::unordered_map<int, CostParams*> > CostMap;
 
     /*
      * It associates, to each tazId, a vector of nodes belonging to it, each represented by a
@@ -177,62 +185,97 @@ private:
     typedef std::vector<std::string> PersonIdList;
     typedef std::vector<long> LT_PersonIdList;
 
-    typedef void (PredayManager::*threadedFnPtr)(const PersonList::iterator&, const PersonList::iterator&, size_t);
+    typedef void (PredayManager::*threadedFnPtr)(WorkStealingPool&, size_t);
+
+    /**
+     * opens the zone and skim cache on first use. If the cache file is missing, stale or corrupt, the cached data
+     * is loaded from the database and exported to a fresh cache file, which is then opened.
+     * @return true if zones and skims are to be loaded from the cache; false if the cache is disabled or unusable
+     */
+    bool openDataCache();
+
+    /**
+     * database counterparts of loadZones(), loadZoneNodes(), loadCosts() and loadUnavailableODs()
+     */
+    void loadZonesFromDB();
+    void loadZoneNodesFromDB();
+    void loadCostsFromDB();
+    void loadUnavailableODsFromDB();
+
+    /**
+     * releases zones, zone nodes, skims and unavailable ODs
+     */
+    void clearZoneData();
+
+    /**
+     * drops and re-creates the day activity schedule table
+     */
+    void createDayActivityScheduleTable();
+
+    /**
+     * simulates the LT population, streaming the activity schedules of all threads to sinks while the simulation runs
+     *
+     * @param sinks destinations of the activity schedules; no schedules are output if empty
+     */
+    void simulateLT_Population(const std::vector< boost::shared_ptr<OutputSink> >& sinks);
 
     /**
      * Threaded function loop for simulation of LT population
-     * Loops through all elements in personList within the specified range and
-     * invokes the Preday system of models for each of them.
+     * Loops through the chunks of ltPersonIdList handed out by the pool and
+     * invokes the Preday system of models for each person in them.
      *
-     * @param first personIdList iterator corresponding to the first person to be
-     *              processed
-     * @param last personIdList iterator corresponding to the person after the
-     *              last person to be processed
+     * @param pool pool distributing the persons
+     * @param threadNum id of the worker thread
+     * @param scheduleOutput streamer of the activity schedules; NULL if schedules are not output
      */
-    void processPersonsForLT_Population(const LT_PersonIdList::iterator& first, const LT_PersonIdList::iterator& last, const std::string& scheduleLog);
+    void processPersonsForLT_Population(WorkStealingPool& pool, size_t threadNum, OutputStreamer* scheduleOutput);
 
     /**
      * Distributes persons to different threads and starts the threads which process the persons for calibration
      */
     void distributeAndProcessForCalibration(threadedFnPtr fnPtr);
 
+    /**
+     * Processes numPersons persons on the configured number of preday threads.
+     * Chunks of persons are balanced over the threads by work stealing; the busy
+     * and idle time of each thread is printed after all threads are done.
+     *
+     * @param numPersons number of persons in the list processed by worker
+     * @param worker threaded function loop
+     * @param jobName name of the job for the printed statistics
+     */
+    void distributePersons(size_t numPersons, const WorkStealingPool::WorkerFunction& worker, const std::string& jobName);
+
     /**
      * Threaded function loop for calibration.
-     * Loops through all elements in personList within the specified range and
-     * invokes the Preday system of models for each of them.
+     * Loops through the chunks of personList handed out by the pool and
+     * invokes the Preday system of models for each person in them.
      *
-     * @param first personList iterator corresponding to the first person to be
-     *              processed
-     * @param last personList iterator corresponding to the person after the
-     *              last person to be processed
-     * @param simStats the object to collect statistics into
+     * @param pool pool distributing the persons
+     * @param threadNum id of the worker thread
      */
-    void processPersonsForCalibration(const PersonList::iterator& first, const PersonList::iterator& last, size_t threadNum);
+    void processPersonsForCalibration(WorkStealingPool& pool, size_t threadNum);
 
     /**
      * Threaded logsum computation for LT population
-     * Loops through all elements in personIdList within the specified range and
-     * invokes logsum computations for each of them.
+     * Loops through the chunks of ltPersonIdList handed out by the pool and
+     * invokes logsum computations for each person in them.
      *
-     * @param first personIdList iterator corresponding to the first person to be
-     *              processed
-     * @param last personIdList iterator corresponding to the person after the
-     *              last person to be processed
+     * @param pool pool distributing the persons
+     * @param threadNum id of the worker thread
      */
-    void computeLogsumsForLT_Population(const LT_PersonIdList::iterator& firstPersonIdIt, const LT_PersonIdList::iterator& oneAfterLastPersonIdIt);
+    void computeLogsumsForLT_Population(WorkStealingPool& pool, size_t threadNum);
 
     /**
      * Threaded logsum computation for calibration
-     * Loops through all elements in personList within the specified range and
-     * invokes logsum computations for each of them.
+     * Loops through the chunks of personList handed out by the pool and
+     * invokes logsum computations for each person in them.
      * This function does not update new logsums in DB. Updates only in memory.
      *
-     * @param first personList iterator corresponding to the first person to be
-     *              processed
-     * @param last personList iterator corresponding to the person after the
-     *              last person to be processed
+     * @param pool pool distributing the persons
+     * @param threadNum id of the worker thread
      */
-    void computeLogsumsForCalibration(const PersonList::iterator& firstPersonIt, const PersonList::iterator& oneAfterLastPersonIt, size_t threadNum);
+    void computeLogsumsForCalibration(WorkStealingPool& pool, size_t threadNum);
 
     /**
      * loads csv containing calibration variables for preday
@@ -306,23 +349,32 @@ private:
     boost::unordered_map<int, int> zoneIdLookup;
 
     /**
-     * Map of AM Costs [origin zone, destination zone] -> CostParams*
+     * AM skims indexed by [origin zone, destination zone]
      */
-    CostMap amCostMap;
+    SkimMatrix amCosts;
 
     /**
-     * Map of PM Costs [origin zone, destination zone] -> CostParams*
+     * PM skims indexed by [origin zone, destination zone]
      */
-    CostMap pmCostMap;
+    SkimMatrix pmCosts;
 
     /**
-     * Map of Off peak Costs [origin zone, destination zone] -> CostParams*
+     * Off peak skims indexed by [origin zone, destination zone]
      */
-    CostMap opCostMap;
+    SkimMatrix opCosts;
 
     /** for each origin, has a list of unavailable destinations */
     std::vector<OD_Pair> unavailableODs;
 
+    /** binary cache of zones and skims; see openDataCache() */
+    PredayDataCache dataCache;
+
+    /** false once the cache has turned out to be unusable for this run */
+    bool dataCacheUsable;
+
+    /** true if the activity schedules of the last simulation were streamed into the day activity schedule table */
+    bool activityScheduleStreamed;
+
     /**
      * list of values computed for objective function
      * objectiveFunctionValue[i] is the objective function value for iteration i
@@ -150,12 +150,12 @@ namespace {
 
 PredaySystem::PredaySystem(PersonParams& personParams,
         const ZoneMap& zoneMap, const boost::unordered_map<int,int>& zoneIdLookup,
-        const CostMap& amCostMap, const CostMap& pmCostMap, const CostMap& opCostMap,
+        const SkimMatrix& amCosts, const SkimMatrix& pmCosts, const SkimMatrix& opCosts,
         TimeDependentTT_SqlDao& tcostDao,
         const std::vector<OD_Pair>& unavailableODs, const std::unordered_map<StopType, ActivityTypeConfig> &activityTypeConfig,
         const int numModes)
 : personParams(personParams), zoneMap(zoneMap), zoneIdLookup(zoneIdLookup),
-  amCostMap(amCostMap), pmCostMap(pmCostMap), opCostMap(opCostMap),
+  amCosts(amCosts), pmCosts(pmCosts), opCosts(opCosts),
   tcostDao(tcostDao), unavailableODs(unavailableODs),
   firstAvailableTimeIndex(FIRST_INDEX), logStream(std::stringstream::out),
   activityTypeConfigMap(activityTypeConfig), numModes(numModes)
@@ -177,8 +177,8 @@ bool sim_mob::medium::PredaySystem::predictUsualWorkLocation(bool firstOfMultipl
 	usualWorkParams.setZoneEmployment(zoneMap.at(zoneIdLookup.at(personParams.getFixedWorkLocation()))->getEmployment());
 
 	if(personParams.getHomeLocation() != personParams.getFixedWorkLocation()) {
-		usualWorkParams.setWalkDistanceAm(amCostMap.at(personParams.getHomeLocation()).at(personParams.getFixedWorkLocation())->getDistance());
-		usualWorkParams.setWalkDistancePm(pmCostMap.at(personParams.getHomeLocation()).at(personParams.getFixedWorkLocation())->getDistance());
+		usualWorkParams.setWalkDistanceAm(amCosts.at(personParams.getHomeLocation(), personParams.getFixedWorkLocation()).getDistance());
+		usualWorkParams.setWalkDistancePm(pmCosts.at(personParams.getHomeLocation(), personParams.getFixedWorkLocation()).getDistance());
 	}
 	else {
 		usualWorkParams.setWalkDistanceAm(0);
@@ -207,12 +207,12 @@ void PredaySystem::constructTourModeParams(TourModeParams& tmParams, int destina
 	tmParams.setCostIncrease(0);
 	if(personParams.getHomeLocation() != destination)
 	{
-		CostParams* amObj = amCostMap.at(personParams.getHomeLocation()).at(destination);
-		CostParams* pmObj = pmCostMap.at(destination).at(personParams.getHomeLocation());
-		tmParams.setCostPublicFirst(amObj->getPubCost());
-		tmParams.setCostPublicSecond(pmObj->getPubCost());
-		tmParams.setCostCarErpFirst(amObj->getCarCostErp());
-		tmParams.setCostCarErpSecond(pmObj->getCarCostErp());
+		const SkimMatrix::Costs amObj = amCosts.at(personParams.getHomeLocation(), destination);
+		const SkimMatrix::Costs pmObj = pmCosts.at(destination, personParams.getHomeLocation());
+		tmParams.setCostPublicFirst(amObj.getPubCost());
+		tmParams.setCostPublicSecond(pmObj.getPubCost());
+		tmParams.setCostCarErpFirst(amObj.getCarCostErp());
+		tmParams.setCostCarErpSecond(pmObj.getCarCostErp());
 
 		VehicleParams::VehicleDriveTrain powertrain = personParams.getConstVehicleParams().getDrivetrain(); // Eytan 05-27-2018
 		double operationalCost;
@@ -228,20 +228,20 @@ void PredaySystem::constructTourModeParams(TourModeParams& tmParams, int destina
 		{
 			operationalCost = cfg.operationalCostICE();
 		}
-		tmParams.setCostCarOpFirst(amObj->getDistance() * operationalCost);
-		tmParams.setCostCarOpSecond(pmObj->getDistance() * operationalCost);
-
-		tmParams.setWalkDistance1(amObj->getDistance());
-		tmParams.setWalkDistance2(pmObj->getDistance());
-		tmParams.setTtPublicIvtFirst(amObj->getPubIvt());
-		tmParams.setTtPublicIvtSecond(pmObj->getPubIvt());
-		tmParams.setTtPublicWaitingFirst(amObj->getPubWtt());
-		tmParams.setTtPublicWaitingSecond(pmObj->getPubWtt());
-		tmParams.setTtPublicWalkFirst(amObj->getPubWalkt());
-		tmParams.setTtPublicWalkSecond(pmObj->getPubWalkt());
-		tmParams.setTtCarIvtFirst(amObj->getCarIvt());
-		tmParams.setTtCarIvtSecond(pmObj->getCarIvt());
-		tmParams.setAvgTransfer((amObj->getAvgTransfer() + pmObj->getAvgTransfer())/2);
+		tmParams.setCostCarOpFirst(amObj.getDistance() * operationalCost);
+		tmParams.setCostCarOpSecond(pmObj.getDistance() * operationalCost);
+
+		tmParams.setWalkDistance1(amObj.getDistance());
+		tmParams.setWalkDistance2(pmObj.getDistance());
+		tmParams.setTtPublicIvtFirst(amObj.getPubIvt());
+		tmParams.setTtPublicIvtSecond(pmObj.getPubIvt());
+		tmParams.setTtPublicWaitingFirst(amObj.getPubWtt());
+		tmParams.setTtPublicWaitingSecond(pmObj.getPubWtt());
+		tmParams.setTtPublicWalkFirst(amObj.getPubWalkt());
+		tmParams.setTtPublicWalkSecond(pmObj.getPubWalkt());
+		tmParams.setTtCarIvtFirst(amObj.getCarIvt());
+		tmParams.setTtCarIvtSecond(pmObj.getCarIvt());
+		tmParams.setAvgTransfer((amObj.getAvgTransfer() + pmObj.getAvgTransfer())/2);
 
 		//set availabilities
         for (int mode = 1; mode <= numModes; ++mode)
@@ -249,11 +249,11 @@ void PredaySystem::constructTourModeParams(TourModeParams& tmParams, int destina
             int modeType = cfg.getTravelModeConfig(mode).type;
             if (modeType == PT_TRAVEL_MODE || modeType == PRIVATE_BUS_MODE)
             {
-                tmParams.setModeAvailability(mode, (amObj->getPubIvt() > 0 && pmObj->getPubIvt() > 0));
+                tmParams.setModeAvailability(mode, (amObj.getPubIvt() > 0 && pmObj.getPubIvt() > 0));
             }
             else if (modeType == WALK_MODE)
             {
-                tmParams.setModeAvailability(mode, (amObj->getDistance() <= WALKABLE_DISTANCE && pmObj->getDistance() <= WALKABLE_DISTANCE));
+                tmParams.setModeAvailability(mode, (amObj.getDistance() <= WALKABLE_DISTANCE && pmObj.getDistance() <= WALKABLE_DISTANCE));
             }
         }
 
@@ -449,7 +449,7 @@ void sim_mob::medium::PredaySystem::predictSubTours(Tour& parentTour)
 void PredaySystem::predictSubTourModeDestination(Tour& subTour, const Tour& parentTour)
 {
 	VehicleParams::VehicleDriveTrain powertrain = personParams.getConstVehicleParams().getDrivetrain();
-	TourModeDestinationParams stmdParams(zoneMap, amCostMap, pmCostMap, personParams, subTour.getTourType(), powertrain, numModes, unavailableODs);
+	TourModeDestinationParams stmdParams(zoneMap, amCosts, pmCosts, personParams, subTour.getTourType(), powertrain, numModes, unavailableODs);
 	stmdParams.setOrigin(parentTour.getTourDestination()); //origin is primary activity location of parentTour (not home location)
 	stmdParams.setCbdOrgZone(zoneMap.at(zoneIdLookup.at(parentTour.getTourDestination()))->getCbdDummy());
 	stmdParams.setModeForParentWorkTour(parentTour.getTourMode());
@@ -469,7 +469,7 @@ void PredaySystem::predictSubTourModeDestination(Tour& subTour, const Tour& pare
 void PredaySystem::predictTourModeDestination(Tour& tour)
 {
 	VehicleParams::VehicleDriveTrain powertrain = personParams.getConstVehicleParams().getDrivetrain();
-	TourModeDestinationParams tmdParams(zoneMap, amCostMap, pmCostMap, personParams, tour.getTourType(), powertrain, numModes, unavailableODs);
+	TourModeDestinationParams tmdParams(zoneMap, amCosts, pmCosts, personParams, tour.getTourType(), powertrain, numModes, unavailableODs);
 	tmdParams.setCbdOrgZone(zoneMap.at(zoneIdLookup.at(personParams.getHomeLocation()))->getCbdDummy());
     int modeDest = PredayLuaProvider::getPredayModel().predictTourModeDestination(personParams, activityTypeConfigMap, tmdParams);
 	int mode = tmdParams.getMode(modeDest);
@@ -536,14 +536,9 @@ TimeWindowAvailability PredaySystem::predictTourTimeOfDay(Tour& tour)
 		}
         case WALK_MODE:
 		{
-			CostParams* costObj = amCostMap.at(origin).at(destination);
-			amTT = costObj->getDistance()/PEDESTRIAN_WALK_SPEED;
-
-			costObj = pmCostMap.at(origin).at(destination);
-			pmTT = costObj->getDistance()/PEDESTRIAN_WALK_SPEED;
-
-			costObj = opCostMap.at(origin).at(destination);
-			opTT = costObj->getDistance()/PEDESTRIAN_WALK_SPEED;
+			amTT = amCosts.at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
+			pmTT = pmCosts.at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
+			opTT = opCosts.at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
 			break;
 		}
 		}
@@ -599,12 +594,12 @@ TimeWindowAvailability PredaySystem::predictTourTimeOfDay(Tour& tour)
 	int home = personParams.getHomeLocation(), primaryStopLoc = tour.getTourDestination();
 	if(home!=primaryStopLoc)
 	{
-		const CostParams* amHT1 = amCostMap.at(home).at(primaryStopLoc);
-		const CostParams* pmHT1 = pmCostMap.at(home).at(primaryStopLoc);
-		const CostParams* opHT1 = opCostMap.at(home).at(primaryStopLoc);
-		const CostParams* amHT2 = amCostMap.at(primaryStopLoc).at(home);
-		const CostParams* pmHT2 = pmCostMap.at(primaryStopLoc).at(home);
-		const CostParams* opHT2 = opCostMap.at(primaryStopLoc).at(home);
+		const SkimMatrix::Costs amHT1 = amCosts.at(home, primaryStopLoc);
+		const SkimMatrix::Costs pmHT1 = pmCosts.at(home, primaryStopLoc);
+		const SkimMatrix::Costs opHT1 = opCosts.at(home, primaryStopLoc);
+		const SkimMatrix::Costs amHT2 = amCosts.at(primaryStopLoc, home);
+		const SkimMatrix::Costs pmHT2 = pmCosts.at(primaryStopLoc, home);
+		const SkimMatrix::Costs opHT2 = opCosts.at(primaryStopLoc, home);
 
         int tourModeType = cfg.getTravelModeConfig(tour.getTourMode()).type;
 
@@ -613,12 +608,12 @@ TimeWindowAvailability PredaySystem::predictTourTimeOfDay(Tour& tour)
         case PT_TRAVEL_MODE:
         case PRIVATE_BUS_MODE:
 		{	//for Public bus, MRT/LRT, private bus
-			todParams.setCostHt1Am(amHT1->getPubCost());
-			todParams.setCostHt1Pm(pmHT1->getPubCost());
-			todParams.setCostHt1Op(opHT1->getPubCost());
-			todParams.setCostHt2Am(amHT2->getPubCost());
-			todParams.setCostHt2Pm(pmHT2->getPubCost());
-			todParams.setCostHt2Op(opHT2->getPubCost());
+			todParams.setCostHt1Am(amHT1.getPubCost());
+			todParams.setCostHt1Pm(pmHT1.getPubCost());
+			todParams.setCostHt1Op(opHT1.getPubCost());
+			todParams.setCostHt2Am(amHT2.getPubCost());
+			todParams.setCostHt2Pm(pmHT2.getPubCost());
+			todParams.setCostHt2Op(opHT2.getPubCost());
 			break;
 		}
         case PVT_CAR_MODE:
@@ -627,24 +622,24 @@ TimeWindowAvailability PredaySystem::predictTourTimeOfDay(Tour& tour)
             int numSharing = cfg.getTravelModeConfig(tour.getTourMode()).numSharing;
             double ht1ParkingRate = zoneMap.at(zoneIdLookup.at(primaryStopLoc))->getParkingRate();
 			double ht2ParkingRate = zoneMap.at(zoneIdLookup.at(home))->getParkingRate();
-            todParams.setCostHt1Am(amHT1->getCarCostErp() + ht1ParkingRate + (amHT1->getDistance()*OPERATIONAL_COST) / numSharing);
-            todParams.setCostHt1Pm(pmHT1->getCarCostErp() + ht1ParkingRate + (pmHT1->getDistance()*OPERATIONAL_COST) / numSharing);
-            todParams.setCostHt1Op(opHT1->getCarCostErp() + ht1ParkingRate + (opHT1->getDistance()*OPERATIONAL_COST) / numSharing);
-            todParams.setCostHt2Am(amHT2->getCarCostErp() + ht2ParkingRate + (amHT2->getDistance()*OPERATIONAL_COST) / numSharing);
-            todParams.setCostHt2Pm(pmHT2->getCarCostErp() + ht2ParkingRate + (pmHT2->getDistance()*OPERATIONAL_COST) / numSharing);
-            todParams.setCostHt2Op(opHT2->getCarCostErp() + ht2ParkingRate + (opHT2->getDistance()*OPERATIONAL_COST) / numSharing);
+            todParams.setCostHt1Am(amHT1.getCarCostErp() + ht1ParkingRate + (amHT1.getDistance()*OPERATIONAL_COST) / numSharing);
+            todParams.setCostHt1Pm(pmHT1.getCarCostErp() + ht1ParkingRate + (pmHT1.getDistance()*OPERATIONAL_COST) / numSharing);
+            todParams.setCostHt1Op(opHT1.getCarCostErp() + ht1ParkingRate + (opHT1.getDistance()*OPERATIONAL_COST) / numSharing);
+            todParams.setCostHt2Am(amHT2.getCarCostErp() + ht2ParkingRate + (amHT2.getDistance()*OPERATIONAL_COST) / numSharing);
+            todParams.setCostHt2Pm(pmHT2.getCarCostErp() + ht2ParkingRate + (pmHT2.getDistance()*OPERATIONAL_COST) / numSharing);
+            todParams.setCostHt2Op(opHT2.getCarCostErp() + ht2ParkingRate + (opHT2.getDistance()*OPERATIONAL_COST) / numSharing);
 			break;
         }
         case PVT_BIKE_MODE:
 		{	//motorcycle
 			double ht1ParkingRate = zoneMap.at(zoneIdLookup.at(primaryStopLoc))->getParkingRate();
 			double ht2ParkingRate = zoneMap.at(zoneIdLookup.at(home))->getParkingRate();
-			todParams.setCostHt1Am(((amHT1->getCarCostErp() + (amHT1->getDistance()*OPERATIONAL_COST))*0.5) + (ht1ParkingRate*0.65));
-			todParams.setCostHt1Pm(((pmHT1->getCarCostErp() + (pmHT1->getDistance()*OPERATIONAL_COST))*0.5) + (ht1ParkingRate*0.65));
-			todParams.setCostHt1Op(((opHT1->getCarCostErp() + (opHT1->getDistance()*OPERATIONAL_COST))*0.5) + (ht1ParkingRate*0.65));
-			todParams.setCostHt2Am(((amHT2->getCarCostErp() + (amHT2->getDistance()*OPERATIONAL_COST))*0.5) + (ht2ParkingRate*0.65));
-			todParams.setCostHt2Pm(((pmHT2->getCarCostErp() + (pmHT2->getDistance()*OPERATIONAL_COST))*0.5) + (ht2ParkingRate*0.65));
-			todParams.setCostHt2Op(((opHT2->getCarCostErp() + (opHT2->getDistance()*OPERATIONAL_COST))*0.5) + (ht2ParkingRate*0.65));
+			todParams.setCostHt1Am(((amHT1.getCarCostErp() + (amHT1.getDistance()*OPERATIONAL_COST))*0.5) + (ht1ParkingRate*0.65));
+			todParams.setCostHt1Pm(((pmHT1.getCarCostErp() + (pmHT1.getDistance()*OPERATIONAL_COST))*0.5) + (ht1ParkingRate*0.65));
+			todParams.setCostHt1Op(((opHT1.getCarCostErp() + (opHT1.getDistance()*OPERATIONAL_COST))*0.5) + (ht1ParkingRate*0.65));
+			todParams.setCostHt2Am(((amHT2.getCarCostErp() + (amHT2.getDistance()*OPERATIONAL_COST))*0.5) + (ht2ParkingRate*0.65));
+			todParams.setCostHt2Pm(((pmHT2.getCarCostErp() + (pmHT2.getDistance()*OPERATIONAL_COST))*0.5) + (ht2ParkingRate*0.65));
+			todParams.setCostHt2Op(((opHT2.getCarCostErp() + (opHT2.getDistance()*OPERATIONAL_COST))*0.5) + (ht2ParkingRate*0.65));
 			break;
 		}
         case WALK_MODE:
@@ -662,35 +657,35 @@ TimeWindowAvailability PredaySystem::predictTourTimeOfDay(Tour& tour)
 			const ZoneParams* homeZoneParams = zoneMap.at(zoneIdLookup.at(home));
 			const ZoneParams* destZoneParams = zoneMap.at(zoneIdLookup.at(primaryStopLoc));
 			double amHT1Cost = TAXI_FLAG_DOWN_PRICE
-							+ amHT1->getCarCostErp()
+							+ amHT1.getCarCostErp()
 							+ (TAXI_CENTRAL_LOCATION_SURCHARGE * homeZoneParams->getCentralDummy())
-							+ (((amHT1->getDistance()<=10)? amHT1->getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
-							+ (((amHT1->getDistance()<=10)? 0 : (amHT1->getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
+							+ (((amHT1.getDistance()<=10)? amHT1.getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
+							+ (((amHT1.getDistance()<=10)? 0 : (amHT1.getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
 			double pmHT1Cost = TAXI_FLAG_DOWN_PRICE
-							+ pmHT1->getCarCostErp()
+							+ pmHT1.getCarCostErp()
 							+ (TAXI_CENTRAL_LOCATION_SURCHARGE * homeZoneParams->getCentralDummy())
-							+ (((pmHT1->getDistance()<=10)? pmHT1->getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
-							+ (((pmHT1->getDistance()<=10)? 0 : (pmHT1->getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
+							+ (((pmHT1.getDistance()<=10)? pmHT1.getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
+							+ (((pmHT1.getDistance()<=10)? 0 : (pmHT1.getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
 			double opHT1Cost = TAXI_FLAG_DOWN_PRICE
-							+ opHT1->getCarCostErp()
+							+ opHT1.getCarCostErp()
 							+ (TAXI_CENTRAL_LOCATION_SURCHARGE * homeZoneParams->getCentralDummy())
-							+ (((opHT1->getDistance()<=10)? opHT1->getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
-							+ (((opHT1->getDistance()<=10)? 0 : (opHT1->getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
+							+ (((opHT1.getDistance()<=10)? opHT1.getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
+							+ (((opHT1.getDistance()<=10)? 0 : (opHT1.getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
 			double amHT2Cost = TAXI_FLAG_DOWN_PRICE
-							+ amHT2->getCarCostErp()
+							+ amHT2.getCarCostErp()
 							+ (TAXI_CENTRAL_LOCATION_SURCHARGE * destZoneParams->getCentralDummy())
-							+ (((amHT2->getDistance()<=10)? amHT2->getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
-							+ (((amHT2->getDistance()<=10)? 0 : (amHT2->getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
+							+ (((amHT2.getDistance()<=10)? amHT2.getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
+							+ (((amHT2.getDistance()<=10)? 0 : (amHT2.getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
 			double pmHT2Cost = TAXI_FLAG_DOWN_PRICE
-							+ pmHT2->getCarCostErp()
+							+ pmHT2.getCarCostErp()
 							+ (TAXI_CENTRAL_LOCATION_SURCHARGE * destZoneParams->getCentralDummy())
-							+ (((pmHT2->getDistance()<=10)? pmHT2->getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
-							+ (((pmHT2->getDistance()<=10)? 0 : (pmHT2->getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
+							+ (((pmHT2.getDistance()<=10)? pmHT2.getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
+							+ (((pmHT2.getDistance()<=10)? 0 : (pmHT2.getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
 			double opHT2Cost = TAXI_FLAG_DOWN_PRICE
-							+ opHT2->getCarCostErp()
+							+ opHT2.getCarCostErp()
 							+ (TAXI_CENTRAL_LOCATION_SURCHARGE * destZoneParams->getCentralDummy())
-							+ (((opHT2->getDistance()<=10)? opHT2->getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
-							+ (((opHT2->getDistance()<=10)? 0 : (opHT2->getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
+							+ (((opHT2.getDistance()<=10)? opHT2.getDistance() : 10)/UNIT_FOR_FIRST_10KM) * TAXI_UNIT_PRICE
+							+ (((opHT2.getDistance()<=10)? 0 : (opHT2.getDistance()-10))/UNIT_AFTER_10KM) * TAXI_UNIT_PRICE;
 			todParams.setCostHt1Am(amHT1Cost);
 			todParams.setCostHt1Pm(pmHT1Cost);
 			todParams.setCostHt1Op(opHT1Cost);
@@ -939,15 +934,15 @@ void PredaySystem::generateIntermediateStops(uint8_t halfTour, Tour& tour, const
 		case FIRST_HALF_TOUR:
 		{	//first half tour
 			// use AM costs for first half tour
-			CostParams* amDistanceObj = amCostMap.at(destination).at(origin); //TODO: check with Siyu
-			isgParams.setDistance(amDistanceObj->getDistance());
+			const SkimMatrix::Costs amDistanceObj = amCosts.at(destination, origin); //TODO: check with Siyu
+			isgParams.setDistance(amDistanceObj.getDistance());
 			break;
 		}
 		case SECOND_HALF_TOUR:
 		{
 			// use PM costs for first half tour
-			CostParams* pmDistanceObj = pmCostMap.at(destination).at(origin); //TODO: check with Siyu
-			isgParams.setDistance(pmDistanceObj->getDistance());
+			const SkimMatrix::Costs pmDistanceObj = pmCosts.at(destination, origin); //TODO: check with Siyu
+			isgParams.setDistance(pmDistanceObj.getDistance());
 			break;
 		}
 		}
@@ -1006,7 +1001,7 @@ void PredaySystem::generateIntermediateStops(uint8_t halfTour, Tour& tour, const
 bool PredaySystem::predictStopModeDestination(Stop* stop, int origin)
 {
 	VehicleParams::VehicleDriveTrain powertrain = personParams.getConstVehicleParams().getDrivetrain();
-	StopModeDestinationParams imdParams(zoneMap, amCostMap, pmCostMap, personParams, stop, origin, powertrain, numModes, unavailableODs);
+	StopModeDestinationParams imdParams(zoneMap, amCosts, pmCosts, personParams, stop, origin, powertrain, numModes, unavailableODs);
 	imdParams.setCbdOrgZone(zoneMap.at(zoneIdLookup.at(origin))->getCbdDummy());
 	int modeDest = PredayLuaProvider::getPredayModel().predictStopModeDestination(personParams, imdParams);
 	if(modeDest == -1)
@@ -1069,9 +1064,9 @@ bool PredaySystem::predictStopTimeOfDay(Stop* stop, int destination, bool isBefo
 		}
         case WALK_MODE:
 		{
-			amTravelTime = amCostMap.at(origin).at(destination)->getDistance()/PEDESTRIAN_WALK_SPEED;
-			pmTravelTime = pmCostMap.at(origin).at(destination)->getDistance()/PEDESTRIAN_WALK_SPEED;
-			opTravelTime = opCostMap.at(origin).at(destination)->getDistance()/PEDESTRIAN_WALK_SPEED;
+			amTravelTime = amCosts.at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
+			pmTravelTime = pmCosts.at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
+			opTravelTime = opCosts.at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
 			break;
 		}
 		}
@@ -1157,9 +1152,9 @@ bool PredaySystem::predictStopTimeOfDay(Stop* stop, int destination, bool isBefo
 	if(origin != destination)
 	{
 		// calculate costs
-		CostParams* amDoc = amCostMap.at(origin).at(destination);
-		CostParams* pmDoc = pmCostMap.at(origin).at(destination);
-		CostParams* opDoc = opCostMap.at(origin).at(destination);
+		const SkimMatrix::Costs amDoc = amCosts.at(origin, destination);
+		const SkimMatrix::Costs pmDoc = pmCosts.at(origin, destination);
+		const SkimMatrix::Costs opDoc = opCosts.at(origin, destination);
 		double duration, parkingRate, costCarParking, costCarERP, costCarOP, walkDistance;
 		for(int i=FIRST_INDEX; i<=LAST_INDEX; i++)
 		{
@@ -1171,21 +1166,21 @@ bool PredaySystem::predictStopTimeOfDay(Stop* stop, int destination, bool isBefo
 
 			if(i >= AM_PEAK_LOW && i <= AM_PEAK_HIGH) // time window indexes 10 to 14 are AM Peak windows
 			{
-				costCarERP = amDoc->getCarCostErp();
-				costCarOP = amDoc->getDistance() * OPERATIONAL_COST;
-				walkDistance = amDoc->getDistance();
+				costCarERP = amDoc.getCarCostErp();
+				costCarOP = amDoc.getDistance() * OPERATIONAL_COST;
+				walkDistance = amDoc.getDistance();
 			}
 			else if (i >= PM_PEAK_LOW && i <= PM_PEAK_HIGH) // time window indexes 30 to 34 are PM Peak indexes
 			{
-				costCarERP = pmDoc->getCarCostErp();
-				costCarOP = pmDoc->getDistance() * OPERATIONAL_COST;
-				walkDistance = pmDoc->getDistance();
+				costCarERP = pmDoc.getCarCostErp();
+				costCarOP = pmDoc.getDistance() * OPERATIONAL_COST;
+				walkDistance = pmDoc.getDistance();
 			}
 			else // other time window indexes are Off Peak indexes
 			{
-				costCarERP = opDoc->getCarCostErp();
-				costCarOP = opDoc->getDistance() * OPERATIONAL_COST;
-				walkDistance = opDoc->getDistance();
+				costCarERP = opDoc.getCarCostErp();
+				costCarOP = opDoc.getDistance() * OPERATIONAL_COST;
+				walkDistance = opDoc.getDistance();
 			}
 
             int stopModeType = cfg.getTravelModeConfig(stop->getStopMode()).type;
@@ -1194,9 +1189,9 @@ bool PredaySystem::predictStopTimeOfDay(Stop* stop, int destination, bool isBefo
             case PT_TRAVEL_MODE:
             case PRIVATE_BUS_MODE:
 			{
-				if(i >= AM_PEAK_LOW && i <= AM_PEAK_HIGH) { stodParams.travelCost.push_back(amDoc->getPubCost()); }
-				else if (i >= PM_PEAK_LOW && i <= PM_PEAK_HIGH) { stodParams.travelCost.push_back(pmDoc->getPubCost()); }
-				else { stodParams.travelCost.push_back(opDoc->getPubCost()); }
+				if(i >= AM_PEAK_LOW && i <= AM_PEAK_HIGH) { stodParams.travelCost.push_back(amDoc.getPubCost()); }
+				else if (i >= PM_PEAK_LOW && i <= PM_PEAK_HIGH) { stodParams.travelCost.push_back(pmDoc.getPubCost()); }
+				else { stodParams.travelCost.push_back(opDoc.getPubCost()); }
 				break;
 			}
             case PVT_CAR_MODE:
@@ -1346,20 +1341,20 @@ double PredaySystem::fetchTravelTime(int origin, int destination, int mode,  boo
 		}
         case WALK_MODE:
 		{
-			CostParams* costObj = nullptr;
+			const SkimMatrix* skims = nullptr;
 			if(timeIdx>=AM_PEAK_LOW && timeIdx<=AM_PEAK_HIGH) // if i is in AM peak period
 			{
-				costObj = amCostMap.at(origin).at(destination);
+				skims = &amCosts;
 			}
 			else if(timeIdx>=PM_PEAK_LOW && timeIdx<=PM_PEAK_HIGH) // if i is in PM peak period
 			{
-				costObj = pmCostMap.at(origin).at(destination);
+				skims = &pmCosts;
 			}
 			else // if i is in off-peak period
 			{
-				costObj = opCostMap.at(origin).at(destination);
+				skims = &opCosts;
 			}
-			travelTime = costObj->getDistance()/PEDESTRIAN_WALK_SPEED;
+			travelTime = skims->at(origin, destination).getDistance()/PEDESTRIAN_WALK_SPEED;
 			break;
 		}
 		default:
@@ -1701,7 +1696,7 @@ void sim_mob::medium::PredaySystem::computeLogsums()
     const ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
 
 	VehicleParams::VehicleDriveTrain powertrain = personParams.getConstVehicleParams().getDrivetrain();
-	TourModeDestinationParams tmdParams(zoneMap, amCostMap, pmCostMap, personParams, NULL_STOP, powertrain, numModes, unavailableODs);
+	TourModeDestinationParams tmdParams(zoneMap, amCosts, pmCosts, personParams, NULL_STOP, powertrain, numModes, unavailableODs);
 	tmdParams.setCbdOrgZone(zoneMap.at(zoneIdLookup.at(personParams.getHomeLocation()))->getCbdDummy());
     PredayLuaProvider::getPredayModel().initializeLogsums(personParams, activityTypeConfigMap);
     PredayLuaProvider::getPredayModel().computeTourModeDestinationLogsum(personParams, activityTypeConfigMap, tmdParams, zoneMap.size());
@@ -2092,13 +2087,13 @@ void sim_mob::medium::PredaySystem::updateStatistics(CalibrationStatistics& stat
 				statsCollector.addToTripModeShareStats(stop->getStopMode(), householdFactor);
 			}
 			destination = stop->getStopLocation();
-			if(origin != destination) { statsCollector.addToTravelDistanceStats(opCostMap.at(origin).at(destination)->getDistance(), householdFactor); }
+			if(origin != destination) { statsCollector.addToTravelDistanceStats(opCosts.at(origin, destination).getDistance(), householdFactor); }
 			else { statsCollector.addToTravelDistanceStats(0, householdFactor); }
 			origin = destination;
 		}
 		//There is still one more trip from last stop to home
 		destination = personParams.getHomeLocation();
-		if(origin != destination) { statsCollector.addToTravelDistanceStats(opCostMap.at(origin).at(destination)->getDistance(), householdFactor); }
+		if(origin != destination) { statsCollector.addToTravelDistanceStats(opCosts.at(origin, destination).getDistance(), householdFactor); }
 		else { statsCollector.addToTravelDistanceStats(0, householdFactor); }
 	}
 }
@@ -36,7 +36,6 @@ class PredaySystem
 {
 private:
 	typedef boost::unordered_map<int, ZoneParams*> ZoneMap;
-	typedef boost::unordered_map<int, boost::unordered_map<int, CostParams*> > CostMap;
 	typedef boost::unordered_map<int, std::vector<ZoneNodeParams*> > ZoneNodeMap;
 	typedef std::deque<Tour> TourList;
 	typedef std::list<Stop*> StopList;
@@ -238,19 +237,19 @@ private:
 	const boost::unordered_map<int, int>& zoneIdLookup;
 
 	/**
-	 * AM Costs [origin zone, destination zone] -> CostParams*
+	 * AM skims indexed by [origin zone, destination zone]
 	 */
-	const CostMap& amCostMap;
+	const SkimMatrix& amCosts;
 
 	/**
-	 * PM Costs [origin zone, destination zone] -> CostParams*
+	 * PM skims indexed by [origin zone, destination zone]
 	 */
-	const CostMap& pmCostMap;
+	const SkimMatrix& pmCosts;
 
 	/**
-	 * OP Costs [origin zone, destination zone] -> CostParams*
+	 * OP skims indexed by [origin zone, destination zone]
 	 */
-	const CostMap& opCostMap;
+	const SkimMatrix& opCosts;
 
 	/**
 	 * map of unavailable ODs for mode destination
@@ -295,8 +294,8 @@ private:
     const int numModes;
 
 public:
-	PredaySystem(PersonParams& personParams, const ZoneMap& zoneMap, const boost::unordered_map<int, int>& zoneIdLookup, const CostMap& amCostMap,
-            const CostMap& pmCostMap, const CostMap& opCostMap, TimeDependentTT_SqlDao& tcosDao, const std::vector<OD_Pair>& unavailableODs,
+	PredaySystem(PersonParams& personParams, const ZoneMap& zoneMap, const boost::unordered_map<int, int>& zoneIdLookup, const SkimMatrix& amCosts,
+            const SkimMatrix& pmCosts, const SkimMatrix& opCosts, TimeDependentTT_SqlDao& tcosDao, const std::vector<OD_Pair>& unavailableODs,
             const std::unordered_map<StopType, ActivityTypeConfig>& activityTypeConfig, const int numModes);
 
 	virtual ~PredaySystem();
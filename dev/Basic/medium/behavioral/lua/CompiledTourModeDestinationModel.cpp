@@ -0,0 +1,386 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "CompiledTourModeDestinationModel.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+using namespace sim_mob;
+using namespace sim_mob::medium;
+
+namespace
+{
+/** modes in the order of the choice set of the scripts */
+enum Mode
+{
+    MODE_BUS,
+    MODE_MRT,
+    MODE_PRIVATE_BUS,
+    MODE_DRIVE1,
+    MODE_SHARE2,
+    MODE_SHARE3,
+    MODE_MOTOR,
+    MODE_WALK,
+    MODE_TAXI,
+    MODE_SMS,
+    MODE_RAIL_SMS,
+    MODE_SMS_POOL,
+    MODE_RAIL_SMS_POOL
+};
+
+/**
+ * names of the coefficients of tmdo.lua, by mode and term (see CompiledTourModeDestinationModel::Term).
+ * nullptr marks terms which are not part of the utility of the mode.
+ */
+const char* const TMDO_COEFFICIENTS[CompiledTourModeDestinationModel::NUM_MODES][CompiledTourModeDestinationModel::NUM_TERMS] =
+{
+    { "beta_cons_bus", "beta_cost_bus_mrt_1", "beta_cost_bus_mrt_2", "beta_tt_bus_mrt", "beta_central_bus_mrt", "beta_distance_bus_mrt",
+      "beta_female_bus", "beta_zero_bus", "beta_oneplus_bus", "beta_twoplus_bus", nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_mrt", "beta_cost_bus_mrt_1", "beta_cost_bus_mrt_2", "beta_tt_bus_mrt", "beta_central_bus_mrt", "beta_distance_bus_mrt",
+      "beta_female_mrt", "beta_zero_mrt", "beta_oneplus_mrt", "beta_twoplus_mrt", nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_private_bus", "beta_cost_private_bus_1", "beta_cost_bus_mrt_2", "beta_tt_private_bus", "beta_central_private_bus",
+      "beta_distance_private_bus", "beta_female_private_bus", "beta_zero_privatebus", "beta_oneplus_privatebus", "beta_twoplus_privatebus",
+      nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_drive1", "beta_cost_drive1_1", "beta_cost_bus_mrt_2", "beta_tt_drive1", "beta_central_drive1", "beta_distance_drive1",
+      "beta_female_drive1", "beta_zero_drive1", "beta_oneplus_drive1", "beta_twoplus_drive1", "beta_threeplus_drive1",
+      nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_share2", "beta_cost_share2_1", "beta_cost_bus_mrt_2", "beta_tt_share2", "beta_central_share2", "beta_distance_share2",
+      "beta_female_share2", "beta_zero_share2", "beta_oneplus_share2", "beta_twoplus_share2", "beta_threeplus_share2",
+      nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_share3", "beta_cost_share3_1", "beta_cost_bus_mrt_2", "beta_tt_share3", "beta_central_share3", "beta_distance_share3",
+      "beta_female_share3", "beta_zero_share3", "beta_oneplus_share3", "beta_twoplus_share3", "beta_threeplus_share3",
+      nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_motor", "beta_cost_motor_1", "beta_cost_bus_mrt_2", "beta_tt_motor", "beta_central_motor", "beta_distance_motor",
+      "beta_female_motor", "beta_zero_car_motor", "beta_oneplus_car_motor", "beta_twoplus_car_motor", nullptr,
+      "beta_zero_motor", "beta_oneplus_motor", "beta_twoplus_motor", "beta_threeplus_motor" },
+    { "beta_cons_walk", nullptr, nullptr, "beta_tt_walk", "beta_central_walk", "beta_distance_walk",
+      "beta_female_walk", "beta_zero_walk", "beta_oneplus_walk", "beta_twoplus_walk", nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_taxi", "beta_cost_taxi_1", "beta_cost_bus_mrt_2", "beta_tt_taxi", "beta_central_taxi", "beta_distance_taxi",
+      "beta_female_taxi", "beta_zero_taxi", "beta_oneplus_taxi", "beta_twoplus_taxi", nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_SMS", "beta_cost_SMS_1", "beta_cost_SMS_2", "beta_tt_SMS", "beta_central_SMS", "beta_distance_SMS",
+      "beta_female_SMS", "beta_zero_SMS", "beta_oneplus_SMS", "beta_twoplus_SMS", nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_Rail_SMS", "beta_cost_Rail_SMS_1", "beta_cost_Rail_SMS_2", "beta_tt_Rail_SMS", "beta_central_Rail_SMS",
+      "beta_distance_Rail_SMS", "beta_female_Rail_SMS", "beta_zero_Rail_SMS", "beta_oneplus_Rail_SMS", "beta_twoplus_Rail_SMS",
+      nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_SMS_Pool", "beta_cost_SMS_Pool_1", "beta_cost_SMS_Pool_2", "beta_tt_SMS_Pool", "beta_central_SMS_Pool",
+      "beta_distance_SMS_Pool", "beta_female_SMS_Pool", "beta_zero_SMS_Pool", "beta_oneplus_SMS_Pool", "beta_twoplus_SMS_Pool",
+      nullptr, nullptr, nullptr, nullptr, nullptr },
+    { "beta_cons_Rail_SMS_Pool", "beta_cost_Rail_SMS_Pool_1", "beta_cost_Rail_SMS_Pool_2", "beta_tt_Rail_SMS_Pool",
+      "beta_central_Rail_SMS_Pool", "beta_distance_Rail_SMS_Pool", "beta_female_Rail_SMS_Pool", "beta_zero_Rail_SMS_Pool",
+      "beta_oneplus_Rail_SMS_Pool", "beta_twoplus_Rail_SMS_Pool", nullptr, nullptr, nullptr, nullptr, nullptr }
+};
+
+/** name of the only model whose specification is currently replicated */
+const std::string TMDO_MODEL_NAME = "tmdo";
+
+/*
+ * Constants of the utility specification of tmdo.lua. Unlike the coefficients, they are literals in the code of the
+ * script rather than named locals, so they cannot be read from the Lua state. PredayLuaModel checks the compiled
+ * utilities against the script at startup instead (see PredayModelBackendConfig::startupChecks).
+ */
+
+/** mid points of the income categories, by income id - 1 */
+const double INCOME_MID[] = { 500.5, 1250, 1749.5, 2249.5, 2749.5, 3499.5, 4499.5, 5499.5, 6499.5, 7499.5, 8500, 0, 99999, 99999 };
+const int NUM_INCOME_CATEGORIES = sizeof(INCOME_MID) / sizeof(INCOME_MID[0]);
+
+/** access/egress distance of the rail + SMS modes */
+const double ACCESS_EGRESS_DISTANCE = 2.0;
+
+/** taxi fare: flag down fare, fare per step, step lengths up to and beyond TAXI_NEAR_DISTANCE, surcharge in the central area */
+const double TAXI_FLAG_DOWN = 3.4;
+const double TAXI_STEP_FARE = 0.22;
+const double TAXI_NEAR_DISTANCE = 10;
+const double TAXI_NEAR_STEP = 0.4;
+const double TAXI_FAR_STEP = 0.35;
+const double TAXI_CENTRAL_SURCHARGE = 3;
+
+/** SMS fares as a fraction of the taxi fare, and pooled SMS fares as a fraction of the SMS fare */
+const double SMS_FARE_FACTOR = 0.6;
+const double SMS_POOL_FARE_FACTOR = 0.7;
+
+/** taxi fare of one trip, as computed by the scripts */
+inline double getTaxiFare(double distance, double erpCost, double centralDummy)
+{
+    const double farDistance = (distance > TAXI_NEAR_DISTANCE) ? distance - TAXI_NEAR_DISTANCE : 0.0;
+    const double nearDistance = (distance > TAXI_NEAR_DISTANCE) ? TAXI_NEAR_DISTANCE : distance;
+    return TAXI_FLAG_DOWN + (farDistance / TAXI_FAR_STEP + nearDistance / TAXI_NEAR_STEP) * TAXI_STEP_FARE + erpCost
+            + centralDummy * TAXI_CENTRAL_SURCHARGE;
+}
+
+/**
+ * leaves the value of upvalue name of the function at funcIdx on top of the stack
+ * @return true if the function has the upvalue; false, leaving the stack unchanged, otherwise
+ */
+bool pushUpvalue(lua_State* state, int funcIdx, const char* name)
+{
+    for (int n = 1;; ++n)
+    {
+        const char* upvalueName = lua_getupvalue(state, funcIdx, n);
+        if (!upvalueName)
+        {
+            return false;
+        }
+        if (std::strcmp(upvalueName, name) == 0)
+        {
+            return true;
+        }
+        lua_pop(state, 1);
+    }
+}
+}
+
+CompiledTourModeDestinationModel::CompiledTourModeDestinationModel() :
+        loaded(false), numZones(0), betaLog(0), betaArea(0), betaPopulation(0)
+{
+}
+
+bool CompiledTourModeDestinationModel::load(lua_State* state, const std::string& modelName, std::string& reason)
+{
+    loaded = false;
+    if (modelName != TMDO_MODEL_NAME)
+    {
+        reason = "no compiled specification for model " + modelName;
+        return false;
+    }
+
+    const int top = lua_gettop(state);
+
+    // number of alternatives: the choice set of the script is an upvalue of choose_<model>
+    std::string funcName = "choose_" + modelName;
+    lua_getglobal(state, funcName.c_str());
+    if (!lua_isfunction(state, -1) || !pushUpvalue(state, -1, "choice") || !lua_istable(state, -1))
+    {
+        lua_settop(state, top);
+        reason = "choice set of " + funcName + " not found";
+        return false;
+    }
+    int numAlternatives = 0;
+    for (;; ++numAlternatives)
+    {
+        lua_rawgeti(state, -1, numAlternatives + 1);
+        bool end = lua_isnil(state, -1);
+        lua_pop(state, 1);
+        if (end)
+        {
+            break;
+        }
+    }
+    lua_settop(state, top);
+    if (numAlternatives == 0 || numAlternatives % NUM_MODES != 0)
+    {
+        std::stringstream msg;
+        msg << "choice set of " << funcName << " has " << numAlternatives << " alternatives; expected a multiple of " << NUM_MODES;
+        reason = msg.str();
+        return false;
+    }
+
+    // coefficients: the beta_ locals of the script are upvalues of its computeUtilities function
+    funcName = "compute_logsum_" + modelName;
+    lua_getglobal(state, funcName.c_str());
+    if (!lua_isfunction(state, -1) || !pushUpvalue(state, -1, "computeUtilities") || !lua_isfunction(state, -1))
+    {
+        lua_settop(state, top);
+        reason = "computeUtilities function of " + funcName + " not found";
+        return false;
+    }
+    std::map<std::string, double> betas;
+    for (int n = 1;; ++n)
+    {
+        const char* upvalueName = lua_getupvalue(state, -1, n);
+        if (!upvalueName)
+        {
+            break;
+        }
+        if (lua_type(state, -1) == LUA_TNUMBER)
+        {
+            betas[upvalueName] = lua_tonumber(state, -1);
+        }
+        lua_pop(state, 1);
+    }
+    lua_settop(state, top);
+
+    std::map<std::string, double>::const_iterator betaIt;
+    for (int mode = 0; mode < NUM_MODES; ++mode)
+    {
+        for (int term = 0; term < NUM_TERMS; ++term)
+        {
+            const char* betaName = TMDO_COEFFICIENTS[mode][term];
+            modeCoefficients[mode].value[term] = 0;
+            if (betaName)
+            {
+                betaIt = betas.find(betaName);
+                if (betaIt == betas.end())
+                {
+                    reason = std::string("coefficient ") + betaName + " not found in " + modelName;
+                    return false;
+                }
+                modeCoefficients[mode].value[term] = betaIt->second;
+            }
+        }
+    }
+    const char* const sizeBetas[] = { "beta_log", "beta_area", "beta_population" };
+    double* sizeValues[] = { &betaLog, &betaArea, &betaPopulation };
+    for (int i = 0; i < 3; ++i)
+    {
+        betaIt = betas.find(sizeBetas[i]);
+        if (betaIt == betas.end())
+        {
+            reason = std::string("coefficient ") + sizeBetas[i] + " not found in " + modelName;
+            return false;
+        }
+        *sizeValues[i] = betaIt->second;
+    }
+
+    numZones = numAlternatives / NUM_MODES;
+    loaded = true;
+    return true;
+}
+
+void CompiledTourModeDestinationModel::computeZoneVariables(TourModeDestinationParams& tmdParams, ZoneVariables& vars) const
+{
+    for (int mode = 0; mode < NUM_MODES; ++mode)
+    {
+        vars.cost[mode].resize(numZones);
+        vars.travelTime[mode].resize(numZones);
+    }
+    vars.central.resize(numZones);
+    vars.distance.resize(numZones);
+    vars.size.resize(numZones);
+
+    const double costIncrease = tmdParams.getCostIncrease();
+    const double expBetaArea = std::exp(betaArea);
+    const double expBetaPopulation = std::exp(betaPopulation);
+    for (int i = 0; i < numZones; ++i)
+    {
+        const int zone = i + 1;
+        const double d1 = tmdParams.getWalkDistance1(zone);
+        const double d2 = tmdParams.getWalkDistance2(zone);
+        const double central = tmdParams.getCentralDummy(zone);
+        const double erpFirst = tmdParams.getCostCarERPFirst(zone);
+        const double erpSecond = tmdParams.getCostCarERPSecond(zone);
+
+        const double costPublic = tmdParams.getCostPublicFirst(zone) + tmdParams.getCostPublicSecond(zone) + costIncrease;
+        const double costCarNoParking = erpFirst + erpSecond + tmdParams.getCostCarOPFirst(zone) + tmdParams.getCostCarOPSecond(zone);
+        const double parking = tmdParams.getCostCarParking(zone);
+        const double costCar = costCarNoParking + parking + costIncrease;
+        const double taxiFares = getTaxiFare(d1, erpFirst, central) + getTaxiFare(d2, erpSecond, central);
+        const double accessEgressAvg = (getTaxiFare(ACCESS_EGRESS_DISTANCE, erpFirst, central)
+                + getTaxiFare(ACCESS_EGRESS_DISTANCE, erpSecond, central)) / 2;
+
+        vars.cost[MODE_BUS][i] = costPublic;
+        vars.cost[MODE_MRT][i] = costPublic;
+        vars.cost[MODE_PRIVATE_BUS][i] = costPublic;
+        vars.cost[MODE_DRIVE1][i] = costCar;
+        vars.cost[MODE_SHARE2][i] = costCar / 2;
+        vars.cost[MODE_SHARE3][i] = costCar / 3;
+        vars.cost[MODE_MOTOR][i] = 0.5 * costCarNoParking + 0.65 * parking + costIncrease;
+        vars.cost[MODE_WALK][i] = 0;
+        vars.cost[MODE_TAXI][i] = taxiFares + costIncrease;
+        vars.cost[MODE_SMS][i] = taxiFares * SMS_FARE_FACTOR + costIncrease;
+        vars.cost[MODE_RAIL_SMS][i] = costPublic + accessEgressAvg * 2 * SMS_FARE_FACTOR;
+        vars.cost[MODE_SMS_POOL][i] = taxiFares * SMS_FARE_FACTOR * SMS_POOL_FARE_FACTOR + costIncrease;
+        vars.cost[MODE_RAIL_SMS_POOL][i] = costPublic + accessEgressAvg * 2 * SMS_FARE_FACTOR * SMS_POOL_FARE_FACTOR;
+
+        const double publicIvt = tmdParams.getTT_PublicIvtFirst(zone) + tmdParams.getTT_PublicIvtSecond(zone);
+        const double publicOut = tmdParams.getTT_PublicOutFirst(zone) + tmdParams.getTT_PublicOutSecond(zone);
+        const double carIvt = tmdParams.getTT_CarIvtFirst(zone) + tmdParams.getTT_CarIvtSecond(zone);
+        const double carTT = carIvt + 1.0 / 6;
+
+        vars.travelTime[MODE_BUS][i] = publicIvt + publicOut;
+        vars.travelTime[MODE_MRT][i] = publicIvt + publicOut;
+        vars.travelTime[MODE_PRIVATE_BUS][i] = carIvt;
+        vars.travelTime[MODE_DRIVE1][i] = carTT;
+        vars.travelTime[MODE_SHARE2][i] = carTT;
+        vars.travelTime[MODE_SHARE3][i] = carTT;
+        vars.travelTime[MODE_MOTOR][i] = carTT;
+        vars.travelTime[MODE_WALK][i] = (d1 + d2) / 5;
+        vars.travelTime[MODE_TAXI][i] = carTT;
+        vars.travelTime[MODE_SMS][i] = carTT;
+        vars.travelTime[MODE_RAIL_SMS][i] = publicIvt + publicOut / 6.0;
+        // tmdo.lua uses the SMS travel time for SMS pool
+        vars.travelTime[MODE_SMS_POOL][i] = carTT;
+        vars.travelTime[MODE_RAIL_SMS_POOL][i] = publicIvt + (ACCESS_EGRESS_DISTANCE + ACCESS_EGRESS_DISTANCE) / 60 + publicOut / 6.0 + 1.0 / 10;
+
+        vars.central[i] = central;
+        vars.distance[i] = d1 + d2;
+        vars.size[i] = betaLog * std::log(expBetaArea * tmdParams.getArea(zone) + expBetaPopulation * tmdParams.getPopulation(zone));
+    }
+}
+
+void CompiledTourModeDestinationModel::computeUtilities(const PersonParams& personParams, TourModeDestinationParams& tmdParams,
+        std::vector<double>& outUtility, std::vector<int>& outAvailability) const
+{
+    if (!loaded)
+    {
+        throw std::runtime_error("CompiledTourModeDestinationModel: model is not loaded");
+    }
+
+    const int incomeId = personParams.getIncomeId();
+    if (incomeId < 1 || incomeId > NUM_INCOME_CATEGORIES)
+    {
+        std::stringstream msg;
+        msg << "CompiledTourModeDestinationModel: invalid income id " << incomeId << " for person " << personParams.getPersonId();
+        throw std::runtime_error(msg.str());
+    }
+    const double incomeMid = INCOME_MID[incomeId - 1];
+    const double notMissingIncome = (incomeId >= 13) ? 0.0 : 1.0;
+    const double costOverIncomeFactor = 30 / (0.5 + incomeMid) * notMissingIncome;
+
+    // person level dummies, by term
+    const int vehOwnCat = personParams.getVehicleOwnershipCategory();
+    double dummies[NUM_TERMS] = { 0 };
+    dummies[TERM_CONSTANT] = 1;
+    dummies[TERM_FEMALE] = personParams.getIsFemale();
+    dummies[TERM_ZERO_CAR] = (vehOwnCat == 0 || vehOwnCat == 1 || vehOwnCat == 2);
+    dummies[TERM_ONE_PLUS_CAR] = (vehOwnCat == 3 || vehOwnCat == 4 || vehOwnCat == 5);
+    dummies[TERM_TWO_PLUS_CAR] = (vehOwnCat == 5);
+    dummies[TERM_THREE_PLUS_CAR] = (vehOwnCat == 5);
+    dummies[TERM_ZERO_MOTOR] = (vehOwnCat == 0 || vehOwnCat == 3);
+    dummies[TERM_ONE_PLUS_MOTOR] = (vehOwnCat == 1 || vehOwnCat == 2 || vehOwnCat == 4 || vehOwnCat == 5);
+    dummies[TERM_TWO_PLUS_MOTOR] = dummies[TERM_ONE_PLUS_MOTOR];
+    dummies[TERM_THREE_PLUS_MOTOR] = dummies[TERM_ONE_PLUS_MOTOR];
+
+    computeZoneVariables(tmdParams, zoneVars);
+
+    outUtility.resize(getNumAlternatives());
+    for (int mode = 0; mode < NUM_MODES; ++mode)
+    {
+        const double* beta = modeCoefficients[mode].value;
+        double personUtility = 0;
+        for (int term = 0; term < NUM_TERMS; ++term)
+        {
+            if (dummies[term] != 0)
+            {
+                personUtility += beta[term] * dummies[term];
+            }
+        }
+        const double betaCost = beta[TERM_COST] + costOverIncomeFactor * beta[TERM_COST_OVER_INCOME];
+        const double betaTT = beta[TERM_TRAVEL_TIME];
+        const double betaCentral = beta[TERM_CENTRAL];
+        const double betaDistance = beta[TERM_DISTANCE];
+
+        const double* cost = &zoneVars.cost[mode][0];
+        const double* travelTime = &zoneVars.travelTime[mode][0];
+        const double* central = &zoneVars.central[0];
+        const double* distance = &zoneVars.distance[0];
+        const double* size = &zoneVars.size[0];
+        double* utility = &outUtility[mode * numZones];
+        for (int i = 0; i < numZones; ++i)
+        {
+            utility[i] = personUtility + cost[i] * betaCost + travelTime[i] * betaTT + central[i] * betaCentral
+                    + distance[i] * betaDistance + size[i];
+        }
+    }
+
+    const int numAlternatives = getNumAlternatives();
+    outAvailability.resize(numAlternatives);
+    for (int choice = 1; choice <= numAlternatives; ++choice)
+    {
+        outAvailability[choice - 1] = tmdParams.isAvailable_TMD(choice);
+    }
+}
@@ -0,0 +1,132 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "behavioral/params/PersonParams.hpp"
+#include "behavioral/params/TourModeDestinationParams.hpp"
+#include "lua/LuaLibrary.hpp"
+
+namespace sim_mob
+{
+namespace medium
+{
+
+/**
+ * C++ evaluation of a tour mode-destination model specified in a Lua script.
+ *
+ * The model coefficients are read once from the script, after it is loaded, and the utilities of all
+ * mode x destination alternatives are then evaluated in C++ with one loop per mode over all zones.
+ * The utility specification itself is replicated here, so a script can only be evaluated by this class if its
+ * specification is one of the known ones (see load()). This is only tmdo: tmdw and tmds differ from it in more than
+ * their coefficients (size variable with employment and a different offset per mode, cost terms scaled by the missing
+ * income dummy, different SMS fares and travel times). The results are those of the script up to floating point
+ * rounding; PredayLuaModel checks this at runtime by evaluating both and comparing the choice probabilities.
+ *
+ * Only the choice set, utilities and availabilities are replaced; the probabilities, logsum and final choice are
+ * computed as in logit.lua (see MultinomialLogit).
+ */
+class CompiledTourModeDestinationModel
+{
+public:
+    /** number of modes of the tour mode-destination models */
+    static const int NUM_MODES = 13;
+
+    /** utility terms of one mode; each term is multiplied by one coefficient */
+    enum Term
+    {
+        TERM_CONSTANT,
+        TERM_COST_OVER_INCOME,
+        TERM_COST,
+        TERM_TRAVEL_TIME,
+        TERM_CENTRAL,
+        TERM_DISTANCE,
+        TERM_FEMALE,
+        TERM_ZERO_CAR,
+        TERM_ONE_PLUS_CAR,
+        TERM_TWO_PLUS_CAR,
+        TERM_THREE_PLUS_CAR,
+        TERM_ZERO_MOTOR,
+        TERM_ONE_PLUS_MOTOR,
+        TERM_TWO_PLUS_MOTOR,
+        TERM_THREE_PLUS_MOTOR,
+        NUM_TERMS
+    };
+
+    CompiledTourModeDestinationModel();
+
+    /**
+     * reads the coefficients of a model from a Lua state
+     * @param state Lua state in which the script of the model has been loaded
+     * @param modelName model name, as in choose_<modelName> and compute_logsum_<modelName>
+     * @param reason output: why the model cannot be compiled, if it cannot
+     * @return true if the specification of the model is known and all of its coefficients were found; false otherwise
+     */
+    bool load(lua_State* state, const std::string& modelName, std::string& reason);
+
+    bool isLoaded() const
+    {
+        return loaded;
+    }
+
+    /**
+     * @return number of alternatives of the choice set of the script (zones x modes)
+     */
+    int getNumAlternatives() const
+    {
+        return numZones * NUM_MODES;
+    }
+
+    /**
+     * evaluates the utilities and availabilities of all alternatives
+     * @param personParams person for whom the choice is made
+     * @param tmdParams tour mode-destination parameters
+     * @param outUtility output utility of each alternative, in the order of the choice set of the script
+     * @param outAvailability output availability of each alternative
+     */
+    void computeUtilities(const PersonParams& personParams, TourModeDestinationParams& tmdParams,
+            std::vector<double>& outUtility, std::vector<int>& outAvailability) const;
+
+private:
+    /** coefficients of one mode; terms absent from the specification of the mode have a zero coefficient */
+    struct Coefficients
+    {
+        double value[NUM_TERMS];
+    };
+
+    /** per zone variables of one person and tour, indexed by zone index - 1 */
+    struct ZoneVariables
+    {
+        std::vector<double> cost[NUM_MODES];
+        std::vector<double> travelTime[NUM_MODES];
+        std::vector<double> central;
+        std::vector<double> distance;
+        std::vector<double> size;
+    };
+
+    /**
+     * fills the per zone variables from the skims and zone attributes in tmdParams
+     */
+    void computeZoneVariables(TourModeDestinationParams& tmdParams, ZoneVariables& vars) const;
+
+    bool loaded;
+
+    /** number of zones of the choice set of the script */
+    int numZones;
+
+    Coefficients modeCoefficients[NUM_MODES];
+
+    /** coefficients of the size variable */
+    double betaLog;
+    double betaArea;
+    double betaPopulation;
+
+    /** scratch space of computeUtilities(); a model is only used by the thread which owns its Lua state */
+    mutable ZoneVariables zoneVars;
+};
+
+} // end namespace medium
+} // end namespace sim_mob
@@ -4,7 +4,12 @@
 
 #include "PredayLuaModel.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
 #include "behavioral/StopType.hpp"
+#include "config/MT_Config.hpp"
 #include "lua/LuaLibrary.hpp"
 #include "lua/third-party/luabridge/LuaBridge.h"
 #include "lua/third-party/luabridge/RefCountedObject.h"
@@ -18,6 +23,47 @@ using namespace luabridge;
 namespace
 {
 const int NUM_ZONES = 1169;
+
+/**
+ * reads the first n elements of an array which is an upvalue of a global Lua function
+ * @return false if the function or the upvalue does not exist or the upvalue is not a table; true otherwise
+ */
+template<typename T>
+bool readUpvalueArray(lua_State* state, const std::string& funcName, const char* upvalueName, std::size_t n, std::vector<T>& outValues)
+{
+    const int top = lua_gettop(state);
+    lua_getglobal(state, funcName.c_str());
+    bool found = false;
+    if (lua_isfunction(state, -1))
+    {
+        for (int up = 1;; ++up)
+        {
+            const char* name = lua_getupvalue(state, -1, up);
+            if (!name)
+            {
+                break;
+            }
+            if (std::strcmp(name, upvalueName) == 0)
+            {
+                found = lua_istable(state, -1);
+                break;
+            }
+            lua_pop(state, 1);
+        }
+    }
+    if (found)
+    {
+        outValues.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            lua_rawgeti(state, -1, i + 1);
+            outValues[i] = static_cast<T>(lua_tonumber(state, -1));
+            lua_pop(state, 1);
+        }
+    }
+    lua_settop(state, top);
+    return found;
+}
 }
 
 sim_mob::medium::PredayLuaModel::PredayLuaModel()
@@ -391,6 +437,7 @@ void sim_mob::medium::PredayLuaModel::computeTourModeLogsumEducation(PersonParam
 void sim_mob::medium::PredayLuaModel::computeTourModeDestinationLogsum(PersonParams& personParams, const std::unordered_map<int, ActivityTypeConfig> &activityTypes,
                                                                        TourModeDestinationParams& tourModeDestinationParams, int zoneSize) const
 {
+    const bool validate = (MT_Config::getInstance().predayModelBackend.backend == PredayModelBackendConfig::BACKEND_VALIDATE);
     for (const auto& activity : activityTypes)
     {
         const ActivityTypeConfig& actConfig = activity.second;
@@ -399,25 +446,36 @@ void sim_mob::medium::PredayLuaModel::computeTourModeDestinationLogsum(PersonPar
                 continue;
         }
 
-        if (actConfig.type == WORK_ACTIVITY_TYPE && !personParams.hasFixedWorkPlace())
+        if (actConfig.tourModeDestModel.empty())
+        {
+            continue;
+        }
+
+        const CompiledTourModeDestinationModel* compiledModel = getCompiledTourModeDestinationModel(actConfig.tourModeDestModel);
+        if (compiledModel && validate)
+        {
+            double logsum = validateTourModeDestination(actConfig.tourModeDestModel, *compiledModel, personParams, tourModeDestinationParams);
+            personParams.setActivityLogsum(activity.first, logsum);
+        }
+        else if (compiledModel)
         {
-            if (!actConfig.tourModeDestModel.empty())
+            if (isStartupCheckDue(actConfig.tourModeDestModel))
             {
-                std::string luaFunc = "compute_logsum_" + actConfig.tourModeDestModel;
-                LuaRef computeLogsumTMDW = getGlobal(state.get(), luaFunc.c_str());
-                LuaRef workLogSum = computeLogsumTMDW(&personParams, &tourModeDestinationParams, zoneSize);
-                personParams.setActivityLogsum(activity.first, workLogSum.cast<double>());
+                // leaves the compiled utilities and availabilities in the scratch vectors
+                validateTourModeDestination(actConfig.tourModeDestModel, *compiledModel, personParams, tourModeDestinationParams);
             }
+            else
+            {
+                compiledModel->computeUtilities(personParams, tourModeDestinationParams, utility, availability);
+            }
+            personParams.setActivityLogsum(activity.first, MultinomialLogit::computeLogsum(utility, availability));
         }
         else
         {
-            if (!actConfig.tourModeDestModel.empty())
-            {
-                 std::string luaFunc = "compute_logsum_" + actConfig.tourModeDestModel;
-                LuaRef computeLogsumTMD = getGlobal(state.get(), luaFunc.c_str());
-                LuaRef logsum = computeLogsumTMD(&personParams, &tourModeDestinationParams, zoneSize);
-                personParams.setActivityLogsum(activity.first, logsum.cast<double>());
-            }
+            std::string luaFunc = "compute_logsum_" + actConfig.tourModeDestModel;
+            LuaRef computeLogsumTMD = getGlobal(state.get(), luaFunc.c_str());
+            LuaRef logsum = computeLogsumTMD(&personParams, &tourModeDestinationParams, zoneSize);
+            personParams.setActivityLogsum(activity.first, logsum.cast<double>());
         }
     }
 }
@@ -429,6 +487,26 @@ int sim_mob::medium::PredayLuaModel::predictTourModeDestination(PersonParams& pe
 
     if(!tmdModel.empty())
     {
+        const CompiledTourModeDestinationModel* compiledModel = getCompiledTourModeDestinationModel(tmdModel);
+        if (compiledModel)
+        {
+            if (MT_Config::getInstance().predayModelBackend.backend == PredayModelBackendConfig::BACKEND_COMPILED)
+            {
+                if (isStartupCheckDue(tmdModel))
+                {
+                    // the check only runs the logsum function of the script, which draws no random numbers
+                    validateTourModeDestination(tmdModel, *compiledModel, personParams, tourModeDestinationParams);
+                }
+                else
+                {
+                    compiledModel->computeUtilities(personParams, tourModeDestinationParams, utility, availability);
+                }
+                MultinomialLogit::computeProbabilities(utility, availability, probability);
+                return MultinomialLogit::makeChoice(probability, nextRandom());
+            }
+            validateTourModeDestination(tmdModel, *compiledModel, personParams, tourModeDestinationParams);
+        }
+
         std::string luaFunc = "choose_" + tmdModel;
         LuaRef chooseTMD = getGlobal(state.get(), luaFunc.c_str());
         LuaRef retVal = chooseTMD(&personParams, &tourModeDestinationParams);
@@ -441,6 +519,109 @@ int sim_mob::medium::PredayLuaModel::predictTourModeDestination(PersonParams& pe
     }
 }
 
+void sim_mob::medium::PredayLuaModel::seedRandom(boost::uint64_t seed) const
+{
+    LogitRandom random;
+    random.seed(seed);
+    LuaRef seedRandomFn = getGlobal(state.get(), "seed_random");
+    if (!seedRandomFn.isFunction())
+    {
+        throw std::runtime_error("preday scripts do not define seed_random (see logit.lua); choices cannot be reproduced");
+    }
+    seedRandomFn(random.getStateHigh(), random.getStateLow());
+}
+
+double sim_mob::medium::PredayLuaModel::nextRandom() const
+{
+    LuaRef nextRandomFn = getGlobal(state.get(), "next_random");
+    if (!nextRandomFn.isFunction())
+    {
+        throw std::runtime_error("preday scripts do not define next_random (see logit.lua); compiled models cannot draw");
+    }
+    return nextRandomFn().cast<double>();
+}
+
+const CompiledTourModeDestinationModel* PredayLuaModel::getCompiledTourModeDestinationModel(const std::string& modelName) const
+{
+    if (MT_Config::getInstance().predayModelBackend.backend == PredayModelBackendConfig::BACKEND_LUA)
+    {
+        return nullptr;
+    }
+
+    std::map<std::string, boost::shared_ptr<CompiledTourModeDestinationModel> >::const_iterator it = compiledTmdModels.find(modelName);
+    if (it == compiledTmdModels.end())
+    {
+        boost::shared_ptr<CompiledTourModeDestinationModel> compiledModel(new CompiledTourModeDestinationModel());
+        std::string reason;
+        if (!compiledModel->load(state.get(), modelName, reason))
+        {
+            Warn() << "Preday model " << modelName << " will be evaluated in Lua: " << reason << std::endl;
+            compiledModel.reset();
+        }
+        it = compiledTmdModels.insert(std::make_pair(modelName, compiledModel)).first;
+    }
+    return it->second.get();
+}
+
+bool PredayLuaModel::isStartupCheckDue(const std::string& modelName) const
+{
+    unsigned int& numChecked = startupChecksDone[modelName];
+    if (numChecked >= MT_Config::getInstance().predayModelBackend.startupChecks)
+    {
+        return false;
+    }
+    ++numChecked;
+    return true;
+}
+
+double PredayLuaModel::validateTourModeDestination(const std::string& modelName, const CompiledTourModeDestinationModel& compiledModel,
+                                                   PersonParams& personParams, TourModeDestinationParams& tourModeDestinationParams) const
+{
+    // the script leaves the utilities and availabilities it used in its utility and availability tables
+    std::string luaFunc = "compute_logsum_" + modelName;
+    LuaRef computeLogsumTMD = getGlobal(state.get(), luaFunc.c_str());
+    LuaRef retVal = computeLogsumTMD(&personParams, &tourModeDestinationParams);
+    const double luaLogsum = retVal.cast<double>();
+
+    const std::size_t numAlternatives = compiledModel.getNumAlternatives();
+    std::vector<double> luaUtility, luaProbability;
+    std::vector<int> luaAvailability;
+    if (!readUpvalueArray(state.get(), luaFunc, "utility", numAlternatives, luaUtility)
+            || !readUpvalueArray(state.get(), luaFunc, "availability", numAlternatives, luaAvailability))
+    {
+        throw std::runtime_error("cannot validate preday model " + modelName + ": utility or availability table not found");
+    }
+    MultinomialLogit::computeProbabilities(luaUtility, luaAvailability, luaProbability);
+
+    compiledModel.computeUtilities(personParams, tourModeDestinationParams, utility, availability);
+    MultinomialLogit::computeProbabilities(utility, availability, probability);
+    const double compiledLogsum = MultinomialLogit::computeLogsum(utility, availability);
+
+    const double tolerance = MT_Config::getInstance().predayModelBackend.tolerance;
+    std::size_t worst = 0;
+    double maxDiff = 0;
+    for (std::size_t i = 0; i < numAlternatives; ++i)
+    {
+        const double diff = std::abs(probability[i] - luaProbability[i]);
+        if (diff > maxDiff || diff != diff)
+        {
+            maxDiff = diff;
+            worst = i;
+        }
+    }
+    const bool logsumsMatch = (compiledLogsum == luaLogsum) || std::abs(compiledLogsum - luaLogsum) <= tolerance * std::max(1.0, std::abs(luaLogsum));
+    if (!(maxDiff <= tolerance) || !logsumsMatch)
+    {
+        std::stringstream msg;
+        msg << "compiled preday model " << modelName << " does not match its script for person " << personParams.getPersonId()
+            << ": largest probability difference " << maxDiff << " at alternative " << worst + 1
+            << " (compiled " << probability[worst] << ", lua " << luaProbability[worst]
+            << "), logsums " << compiledLogsum << " (compiled) and " << luaLogsum << " (lua)";
+        throw std::runtime_error(msg.str());
+    }
+    return luaLogsum;
+}
+
 void PredayLuaModel::initializeLogsums(PersonParams &personParams, const std::unordered_map<int, ActivityTypeConfig> &activityTypes) const
 {
     for (const auto& activity : activityTypes)
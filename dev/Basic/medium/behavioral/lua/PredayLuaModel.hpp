@@ -3,13 +3,19 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
+#include "behavioral/MultinomialLogit.hpp"
 #include "behavioral/params/PersonParams.hpp"
 #include "behavioral/params/StopGenerationParams.hpp"
 #include "behavioral/params/TimeOfDayParams.hpp"
 #include "behavioral/params/TourModeParams.hpp"
 #include "behavioral/params/TourModeDestinationParams.hpp"
 #include "behavioral/StopType.hpp"
+#include "behavioral/lua/CompiledTourModeDestinationModel.hpp"
 #include "lua/LuaModel.hpp"
 
 namespace sim_mob
@@ -21,6 +27,13 @@ namespace medium
  * Interface between C++ layer and preday discrete choice models specified in Lua scripts.
  * This class contains a separate function for each model.
  *
+ * Depending on the preday model_backend configuration, the tour mode-destination models whose specification is
+ * known (see CompiledTourModeDestinationModel) are evaluated in C++ instead, with the coefficients of their scripts.
+ * In validation mode both evaluations are run and their choice probabilities compared; the Lua results are used.
+ * In compiled mode the first evaluations of each compiled model are still checked against its script (see
+ * PredayModelBackendConfig::startupChecks), so that a script whose specification no longer matches the compiled one
+ * stops the simulation instead of silently producing different choices.
+ *
  * \author Harish Loganathan
  */
 class PredayLuaModel: public lua::LuaModel
@@ -29,6 +42,23 @@ public:
     PredayLuaModel();
     virtual ~PredayLuaModel();
 
+    /**
+     * restarts the random draws of the choice models from a seed. The scripts and the compiled models share the
+     * generator of logit.lua.
+     *
+     * @param seed the seed
+     * @throws std::runtime_error if the scripts do not define seed_random
+     */
+    void seedRandom(boost::uint64_t seed) const;
+
+    /**
+     * draws the next number of the generator of logit.lua, for the choices made with compiled models
+     *
+     * @return uniform random number in [0, 1)
+     * @throws std::runtime_error if the scripts do not define next_random
+     */
+    double nextRandom() const;
+
     /**
      * Predicts the types of tours and intermediate stops the person is going to make.
      *
@@ -193,6 +223,45 @@ private:
      * Inherited from LuaModel
      */
     void mapClasses();
+
+    /**
+     * fetches the compiled version of a tour mode-destination model, loading it on first use
+     * @param modelName model name
+     * @return compiled model; nullptr if the model is to be evaluated by its script only
+     */
+    const CompiledTourModeDestinationModel* getCompiledTourModeDestinationModel(const std::string& modelName) const;
+
+    /**
+     * counts the startup checks of a compiled model in compiled mode
+     * @param modelName model name
+     * @return true if this evaluation of the model must also be checked against its script; false otherwise
+     */
+    bool isStartupCheckDue(const std::string& modelName) const;
+
+    /**
+     * evaluates a tour mode-destination model both ways and compares the choice probabilities and logsums.
+     * The compiled utilities, availabilities and probabilities are left in the scratch vectors.
+     * @param modelName model name
+     * @param compiledModel compiled version of the model
+     * @return logsum computed by the script
+     * @throws std::runtime_error if the results differ by more than the configured tolerance
+     */
+    double validateTourModeDestination(const std::string& modelName, const CompiledTourModeDestinationModel& compiledModel,
+                                       PersonParams& personParams, TourModeDestinationParams& tourModeDestinationParams) const;
+
+    /**
+     * compiled tour mode-destination models by model name; nullptr for models evaluated by their script only.
+     * Mutable because models are loaded lazily from the (thread specific) Lua state of this object.
+     */
+    mutable std::map<std::string, boost::shared_ptr<CompiledTourModeDestinationModel> > compiledTmdModels;
+
+    /** number of evaluations of each compiled model checked against its script so far, in compiled mode */
+    mutable std::map<std::string, unsigned int> startupChecksDone;
+
+    /** scratch space for compiled model evaluation */
+    mutable std::vector<double> utility;
+    mutable std::vector<int> availability;
+    mutable std::vector<double> probability;
 };
 } // end namespace medium
 } //end namespace sim_mob
@@ -152,9 +152,9 @@ void setModeAvailability(bool stop, const PersonParams& personParams, int numMod
 
 } // end anonymous namespace
 
-TourModeDestinationParams::TourModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, const CostMap& pmCostsMap,
+TourModeDestinationParams::TourModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, const SkimMatrix& pmCosts,
 	const PersonParams& personParams, StopType tourType, const VehicleParams::VehicleDriveTrain& powerTrain, int numModes, const std::vector<OD_Pair>& unavailableODs) :
-		ModeDestinationParams(zoneMap, amCostsMap, pmCostsMap, tourType, personParams.getHomeLocation(), powerTrain, numModes, unavailableODs),
+		ModeDestinationParams(zoneMap, amCosts, pmCosts, tourType, personParams.getHomeLocation(), powerTrain, numModes, unavailableODs),
 		modeForParentWorkTour(0), costIncrease(0)
 {
     //setCarAndMotorAvailability(false, personParams, drive1Available, motorAvailable);
@@ -172,7 +172,7 @@ double TourModeDestinationParams::getCostPublicFirst(int zoneId) const
 	{
 		return 0;
 	}
-	return amCostsMap.at(origin).at(destination)->getPubCost();
+	return amCosts.at(origin, destination).getPubCost();
 }
 
 double TourModeDestinationParams::getCostPublicSecond(int zoneId) const
@@ -182,7 +182,7 @@ double TourModeDestinationParams::getCostPublicSecond(int zoneId) const
 	{
 		return 0;
 	}
-	return pmCostsMap.at(destination).at(origin)->getPubCost();
+	return pmCosts.at(destination, origin).getPubCost();
 }
 
 double TourModeDestinationParams::getCostCarERPFirst(int zoneId) const
@@ -192,7 +192,7 @@ double TourModeDestinationParams::getCostCarERPFirst(int zoneId) const
 	{
 		return 0;
 	}
-	return amCostsMap.at(origin).at(destination)->getCarCostErp();
+	return amCosts.at(origin, destination).getCarCostErp();
 }
 
 double TourModeDestinationParams::getCostCarERPSecond(int zoneId) const
@@ -202,7 +202,7 @@ double TourModeDestinationParams::getCostCarERPSecond(int zoneId) const
 	{
 		return 0;
 	}
-	return pmCostsMap.at(destination).at(origin)->getCarCostErp();
+	return pmCosts.at(destination, origin).getCarCostErp();
 }
 
 double TourModeDestinationParams::getCostCarOPFirst(int zoneId) const
@@ -217,15 +217,15 @@ double TourModeDestinationParams::getCostCarOPFirst(int zoneId) const
 		const ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
 		if (powertrain == VehicleParams::BEV or powertrain == VehicleParams::FCV)
 		{
-			return (amCostsMap.at(origin).at(destination)->getDistance() * cfg.operationalCostBEV());
+			return (amCosts.at(origin, destination).getDistance() * cfg.operationalCostBEV());
 		}
 		else if (powertrain == VehicleParams::HEV or powertrain == VehicleParams::PHEV)
 		{
-			return (amCostsMap.at(origin).at(destination)->getDistance() * cfg.operationalCostHEV());
+			return (amCosts.at(origin, destination).getDistance() * cfg.operationalCostHEV());
 		}
 		else // resorting to ICE
 		{
-			return (amCostsMap.at(origin).at(destination)->getDistance() * cfg.operationalCostICE());
+			return (amCosts.at(origin, destination).getDistance() * cfg.operationalCostICE());
 		}
 	}
 }
@@ -242,15 +242,15 @@ double TourModeDestinationParams::getCostCarOPSecond(int zoneId) const
 		const ConfigParams& cfg = ConfigManager::GetInstance().FullConfig();
 		if (powertrain == VehicleParams::BEV or powertrain == VehicleParams::FCV)
 		{
-			return (amCostsMap.at(origin).at(destination)->getDistance() * cfg.operationalCostBEV());
+			return (amCosts.at(origin, destination).getDistance() * cfg.operationalCostBEV());
 		}
 		else if (powertrain == VehicleParams::HEV or powertrain == VehicleParams::PHEV)
 		{
-			return (amCostsMap.at(origin).at(destination)->getDistance() * cfg.operationalCostHEV());
+			return (amCosts.at(origin, destination).getDistance() * cfg.operationalCostHEV());
 		}
 		else // resorting to ICE
 		{
-			return (amCostsMap.at(origin).at(destination)->getDistance() * cfg.operationalCostICE());
+			return (amCosts.at(origin, destination).getDistance() * cfg.operationalCostICE());
 		}
 	}
 }
@@ -267,7 +267,7 @@ double TourModeDestinationParams::getWalkDistance1(int zoneId) const
 	{
 		return 0;
 	}
-	return amCostsMap.at(origin).at(destination)->getPubWalkt();
+	return amCosts.at(origin, destination).getPubWalkt();
 }
 
 double TourModeDestinationParams::getWalkDistance2(int zoneId) const
@@ -277,7 +277,7 @@ double TourModeDestinationParams::getWalkDistance2(int zoneId) const
 	{
 		return 0;
 	}
-	return pmCostsMap.at(destination).at(origin)->getPubWalkt();
+	return pmCosts.at(destination, origin).getPubWalkt();
 }
 
 double TourModeDestinationParams::getTT_PublicIvtFirst(int zoneId)
@@ -287,7 +287,7 @@ double TourModeDestinationParams::getTT_PublicIvtFirst(int zoneId)
 	{
 		return 0;
 	}
-	return amCostsMap.at(origin).at(destination)->getPubIvt();
+	return amCosts.at(origin, destination).getPubIvt();
 }
 
 double TourModeDestinationParams::getTT_PublicIvtSecond(int zoneId) const
@@ -297,7 +297,7 @@ double TourModeDestinationParams::getTT_PublicIvtSecond(int zoneId) const
 	{
 		return 0;
 	}
-	return pmCostsMap.at(destination).at(origin)->getPubIvt();
+	return pmCosts.at(destination, origin).getPubIvt();
 }
 
 double TourModeDestinationParams::getTT_CarIvtFirst(int zoneId) const
@@ -307,7 +307,7 @@ double TourModeDestinationParams::getTT_CarIvtFirst(int zoneId) const
 	{
 		return 0;
 	}
-	return amCostsMap.at(origin).at(destination)->getCarIvt();
+	return amCosts.at(origin, destination).getCarIvt();
 }
 
 double TourModeDestinationParams::getTT_CarIvtSecond(int zoneId) const
@@ -317,7 +317,7 @@ double TourModeDestinationParams::getTT_CarIvtSecond(int zoneId) const
 	{
 		return 0;
 	}
-	return pmCostsMap.at(destination).at(origin)->getCarIvt();
+	return pmCosts.at(destination, origin).getCarIvt();
 }
 
 double TourModeDestinationParams::getTT_PublicOutFirst(int zoneId) const
@@ -327,7 +327,7 @@ double TourModeDestinationParams::getTT_PublicOutFirst(int zoneId) const
 	{
 		return 0;
 	}
-	return amCostsMap.at(origin).at(destination)->getPubOut();
+	return amCosts.at(origin, destination).getPubOut();
 }
 
 double TourModeDestinationParams::getTT_PublicOutSecond(int zoneId) const
@@ -337,7 +337,7 @@ double TourModeDestinationParams::getTT_PublicOutSecond(int zoneId) const
 	{
 		return 0;
 	}
-	return pmCostsMap.at(destination).at(origin)->getPubOut();
+	return pmCosts.at(destination, origin).getPubOut();
 }
 
 double TourModeDestinationParams::getAvgTransferNumber(int zoneId) const
@@ -347,7 +347,7 @@ double TourModeDestinationParams::getAvgTransferNumber(int zoneId) const
 	{
 		return 0;
 	}
-	return (amCostsMap.at(origin).at(destination)->getAvgTransfer() + pmCostsMap.at(destination).at(origin)->getAvgTransfer()) / 2;
+	return (amCosts.at(origin, destination).getAvgTransfer() + pmCosts.at(destination, origin).getAvgTransfer()) / 2;
 }
 
 int TourModeDestinationParams::getCentralDummy(int zone) const
@@ -442,7 +442,7 @@ int TourModeDestinationParams::isAvailable_TMD(int choiceId) const
     case PT_TRAVEL_MODE:
     case PRIVATE_BUS_MODE:
     {
-        return (pmCostsMap.at(destination).at(origin)->getPubIvt() > 0 && amCostsMap.at(origin).at(destination)->getPubIvt() > 0);
+        return (pmCosts.at(destination, origin).getPubIvt() > 0 && amCosts.at(origin, destination).getPubIvt() > 0);
         break;
     }
     case PVT_CAR_MODE:
@@ -475,8 +475,8 @@ int TourModeDestinationParams::isAvailable_TMD(int choiceId) const
     }
     case WALK_MODE:
     {
-        return (amCostsMap.at(origin).at(destination)->getDistance() <= MAX_WALKING_DISTANCE
-                && pmCostsMap.at(destination).at(origin)->getDistance() <= MAX_WALKING_DISTANCE);
+        return (amCosts.at(origin, destination).getDistance() <= MAX_WALKING_DISTANCE
+                && pmCosts.at(destination, origin).getDistance() <= MAX_WALKING_DISTANCE);
         break;
     }
     }
@@ -500,9 +500,9 @@ int sim_mob::medium::TourModeDestinationParams::isCbdOrgZone() const
 	return cbdOrgZone;
 }
 
-StopModeDestinationParams::StopModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, const CostMap& pmCostsMap,
+StopModeDestinationParams::StopModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, const SkimMatrix& pmCosts,
 	const PersonParams& personParams, const Stop* stop, int originCode, const VehicleParams::VehicleDriveTrain& powerTrain, int numModes, const std::vector<OD_Pair>& unavailableODs) :
-		ModeDestinationParams(zoneMap, amCostsMap, pmCostsMap, stop->getStopType(), originCode, powerTrain, numModes, unavailableODs), 
+		ModeDestinationParams(zoneMap, amCosts, pmCosts, stop->getStopType(), originCode, powerTrain, numModes, unavailableODs), 
 		homeZone(personParams.getHomeLocation()), tourMode(stop->getParentTour().getTourMode()),
 		//firstBound(stop->isInFirstHalfTour()) //jo May12 reg restriction
  		firstBound(stop->isInFirstHalfTour()), personParams(personParams), parentTour(stop->getParentTour()) 
@@ -543,12 +543,12 @@ double StopModeDestinationParams::getCostCarOP(int zone) const
 		{
 			operational_cost = cfg.operationalCostICE();
 		}
-		return ((amCostsMap.at(origin).at(destination)->getDistance() * operational_cost 
-			+ pmCostsMap.at(origin).at(destination)->getDistance() * operational_cost)/2
-			+(amCostsMap.at(destination).at(homeZone)->getDistance() * operational_cost 
-			+ pmCostsMap.at(destination).at(homeZone)->getDistance() * operational_cost)/2
-			-(amCostsMap.at(origin).at(homeZone)->getDistance() * operational_cost 
-			+ pmCostsMap.at(origin).at(homeZone)->getDistance() * operational_cost)/2);
+		return ((amCosts.at(origin, destination).getDistance() * operational_cost 
+			+ pmCosts.at(origin, destination).getDistance() * operational_cost)/2
+			+(amCosts.at(destination, homeZone).getDistance() * operational_cost 
+			+ pmCosts.at(destination, homeZone).getDistance() * operational_cost)/2
+			-(amCosts.at(origin, homeZone).getDistance() * operational_cost 
+			+ pmCosts.at(origin, homeZone).getDistance() * operational_cost)/2);
 	}
 }
 
@@ -557,9 +557,9 @@ double StopModeDestinationParams::getCarCostERP(int zone) const
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone)
 	{ return 0; }
-	return ((amCostsMap.at(origin).at(destination)->getCarCostErp() + pmCostsMap.at(origin).at(destination)->getCarCostErp())/2
-				+(amCostsMap.at(destination).at(homeZone)->getCarCostErp() + pmCostsMap.at(destination).at(homeZone)->getCarCostErp())/2
-				-(amCostsMap.at(origin).at(homeZone)->getCarCostErp() + pmCostsMap.at(origin).at(homeZone)->getCarCostErp())/2);
+	return ((amCosts.at(origin, destination).getCarCostErp() + pmCosts.at(origin, destination).getCarCostErp())/2
+				+(amCosts.at(destination, homeZone).getCarCostErp() + pmCosts.at(destination, homeZone).getCarCostErp())/2
+				-(amCosts.at(origin, homeZone).getCarCostErp() + pmCosts.at(origin, homeZone).getCarCostErp())/2);
 }
 
 double StopModeDestinationParams::getCostPublic(int zone) const
@@ -567,9 +567,9 @@ double StopModeDestinationParams::getCostPublic(int zone) const
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone)
 	{ return 0; }
-	return ((amCostsMap.at(origin).at(destination)->getPubCost() + pmCostsMap.at(origin).at(destination)->getPubCost())/2
-				+(amCostsMap.at(destination).at(homeZone)->getPubCost() + pmCostsMap.at(destination).at(homeZone)->getPubCost())/2
-				-(amCostsMap.at(origin).at(homeZone)->getPubCost() + pmCostsMap.at(origin).at(homeZone)->getPubCost())/2);
+	return ((amCosts.at(origin, destination).getPubCost() + pmCosts.at(origin, destination).getPubCost())/2
+				+(amCosts.at(destination, homeZone).getPubCost() + pmCosts.at(destination, homeZone).getPubCost())/2
+				-(amCosts.at(origin, homeZone).getPubCost() + pmCosts.at(origin, homeZone).getPubCost())/2);
 }
 
 double StopModeDestinationParams::getTT_CarIvt(int zone) const
@@ -577,9 +577,9 @@ double StopModeDestinationParams::getTT_CarIvt(int zone) const
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone)
 	{ return 0; }
-	return ((amCostsMap.at(origin).at(destination)->getCarIvt() + pmCostsMap.at(origin).at(destination)->getCarIvt())/2
-				+(amCostsMap.at(destination).at(homeZone)->getCarIvt() + pmCostsMap.at(destination).at(homeZone)->getCarIvt())/2
-				-(amCostsMap.at(origin).at(homeZone)->getCarIvt() + pmCostsMap.at(origin).at(homeZone)->getCarIvt())/2);
+	return ((amCosts.at(origin, destination).getCarIvt() + pmCosts.at(origin, destination).getCarIvt())/2
+				+(amCosts.at(destination, homeZone).getCarIvt() + pmCosts.at(destination, homeZone).getCarIvt())/2
+				-(amCosts.at(origin, homeZone).getCarIvt() + pmCosts.at(origin, homeZone).getCarIvt())/2);
 }
 
 double StopModeDestinationParams::getTT_PubIvt(int zone) const
@@ -587,9 +587,9 @@ double StopModeDestinationParams::getTT_PubIvt(int zone) const
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone)
 	{ return 0; }
-	return ((amCostsMap.at(origin).at(destination)->getPubIvt() + pmCostsMap.at(origin).at(destination)->getPubIvt())/2
-				+(amCostsMap.at(destination).at(homeZone)->getPubIvt() + pmCostsMap.at(destination).at(homeZone)->getPubIvt())/2
-				-(amCostsMap.at(origin).at(homeZone)->getPubIvt() + pmCostsMap.at(origin).at(homeZone)->getPubIvt())/2);
+	return ((amCosts.at(origin, destination).getPubIvt() + pmCosts.at(origin, destination).getPubIvt())/2
+				+(amCosts.at(destination, homeZone).getPubIvt() + pmCosts.at(destination, homeZone).getPubIvt())/2
+				-(amCosts.at(origin, homeZone).getPubIvt() + pmCosts.at(origin, homeZone).getPubIvt())/2);
 }
 
 double StopModeDestinationParams::getTT_PubOut(int zone) const
@@ -597,18 +597,18 @@ double StopModeDestinationParams::getTT_PubOut(int zone) const
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone)
 	{ return 0; }
-	return ((amCostsMap.at(origin).at(destination)->getPubOut() + pmCostsMap.at(origin).at(destination)->getPubOut())/2
-				+(amCostsMap.at(destination).at(homeZone)->getPubOut() + pmCostsMap.at(destination).at(homeZone)->getPubOut())/2
-				-(amCostsMap.at(origin).at(homeZone)->getPubOut() + pmCostsMap.at(origin).at(homeZone)->getPubOut())/2);
+	return ((amCosts.at(origin, destination).getPubOut() + pmCosts.at(origin, destination).getPubOut())/2
+				+(amCosts.at(destination, homeZone).getPubOut() + pmCosts.at(destination, homeZone).getPubOut())/2
+				-(amCosts.at(origin, homeZone).getPubOut() + pmCosts.at(origin, homeZone).getPubOut())/2);
 }
 
 double StopModeDestinationParams::getWalkDistanceFirst(int zone) const
 {
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone) { return 0; }
-	return (amCostsMap.at(origin).at(destination)->getDistance()
-				+ amCostsMap.at(destination).at(homeZone)->getDistance()
-				- amCostsMap.at(origin).at(homeZone)->getDistance());
+	return (amCosts.at(origin, destination).getDistance()
+				+ amCosts.at(destination, homeZone).getDistance()
+				- amCosts.at(origin, homeZone).getDistance());
 }
 
 double StopModeDestinationParams::getWalkDistanceSecond(int zone) const
@@ -616,9 +616,9 @@ double StopModeDestinationParams::getWalkDistanceSecond(int zone) const
 	int destination = zoneMap.at(zone)->getZoneCode();
 	if(origin == destination || destination == homeZone || origin == homeZone)
 	{ return 0; }
-	return (pmCostsMap.at(origin).at(destination)->getDistance()
-				+ pmCostsMap.at(destination).at(homeZone)->getDistance()
-				- pmCostsMap.at(origin).at(homeZone)->getDistance());
+	return (pmCosts.at(origin, destination).getDistance()
+				+ pmCosts.at(destination, homeZone).getDistance()
+				- pmCosts.at(origin, homeZone).getDistance());
 }
 
 int StopModeDestinationParams::getCentralDummy(int zone) const
@@ -692,8 +692,8 @@ int StopModeDestinationParams::isAvailable_IMD(int choiceId) const
     case PT_TRAVEL_MODE:
     case PRIVATE_BUS_MODE:
     {
-        bool avail = (pmCostsMap.at(destination).at(origin)->getPubIvt() > 0
-                && amCostsMap.at(origin).at(destination)->getPubIvt() > 0);
+        bool avail = (pmCosts.at(destination, origin).getPubIvt() > 0
+                && amCosts.at(origin, destination).getPubIvt() > 0);
         switch(tourModeType)
         {
         case PT_TRAVEL_MODE:
@@ -761,8 +761,8 @@ int StopModeDestinationParams::isAvailable_IMD(int choiceId) const
     }
     case WALK_MODE:
     {
-        return (amCostsMap.at(origin).at(destination)->getDistance() <= MAX_WALKING_DISTANCE
-                && pmCostsMap.at(destination).at(origin)->getDistance() <= MAX_WALKING_DISTANCE);
+        return (amCosts.at(origin, destination).getDistance() <= MAX_WALKING_DISTANCE
+                && pmCosts.at(destination, origin).getDistance() <= MAX_WALKING_DISTANCE);
         break;
     }
     case TAXI_MODE:
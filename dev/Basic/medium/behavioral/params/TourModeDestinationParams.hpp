@@ -28,7 +28,7 @@ namespace medium
 class TourModeDestinationParams: public ModeDestinationParams
 {
 public:
-	TourModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, const CostMap& pmCostsMap, 
+	TourModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, const SkimMatrix& pmCosts, 
 		const PersonParams& personParams, StopType tourType, const VehicleParams::VehicleDriveTrain& powerTrain, int numModes, const std::vector<OD_Pair>& unavailableODs);
 	virtual ~TourModeDestinationParams();
 
@@ -75,8 +75,8 @@ private:
 class StopModeDestinationParams: public ModeDestinationParams
 {
 public:
-	StopModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, 
-		const CostMap& pmCostsMap, const PersonParams& personParams, const Stop* stop, 
+	StopModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, 
+		const SkimMatrix& pmCosts, const PersonParams& personParams, const Stop* stop, 
 		int originCode, const VehicleParams::VehicleDriveTrain& powerTrain, int numModes, const std::vector<OD_Pair>& unavailableODs);
 	virtual ~StopModeDestinationParams();
 	double getCostCarParking(int zone) const;
@@ -22,11 +22,11 @@ PredayCalibrationParams::PredayCalibrationParams() :
 {}
 
 MT_Config::MT_Config() :
-       regionRestrictionEnabled(false), midTermRunMode(MT_Config::MT_NONE), pedestrianWalkSpeed(0), numPredayThreads(0),
+       regionRestrictionEnabled(false), midTermRunMode(MT_Config::MT_NONE), pedestrianWalkSpeed(0), numPredayThreads(0), predayChunkSize(32),
 			configSealed(false), fileOutputEnabled(false), consoleOutput(false), predayRunMode(MT_Config::PREDAY_NONE),
 			calibrationMethodology(MT_Config::WSPSA), logsumComputationFrequency(0), supplyUpdateInterval(0),
 			activityScheduleLoadInterval(0), busCapacity(0), populationSource(db::POSTGRES), granPersonTicks(0),threadsNumInPersonLoader(0),
-			energyModelEnabled(false)
+			personLoaderLookahead(1), energyModelEnabled(false)
 {
 }
 
@@ -130,6 +130,19 @@ void MT_Config::setNumPredayThreads(unsigned numPredayThreads)
 	}
 }
 
+unsigned MT_Config::getPredayChunkSize() const
+{
+	return predayChunkSize;
+}
+
+void MT_Config::setPredayChunkSize(unsigned predayChunkSize)
+{
+	if(!configSealed)
+	{
+		this->predayChunkSize = predayChunkSize;
+	}
+}
+
 
 void MT_Config::sealConfig()
 {
@@ -313,6 +326,19 @@ void MT_Config::setThreadsNumInPersonLoader(unsigned int number)
 	}
 }
 
+unsigned int MT_Config::getPersonLoaderLookahead() const
+{
+	return personLoaderLookahead;
+}
+
+void MT_Config::setPersonLoaderLookahead(unsigned int lookahead)
+{
+	if(!configSealed)
+	{
+		personLoaderLookahead = lookahead;
+	}
+}
+
 bool MT_Config::RunningMidSupply() const {
     return (midTermRunMode == MT_Config::MT_SUPPLY);
 }
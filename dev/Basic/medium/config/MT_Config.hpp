@@ -150,6 +150,9 @@ private:
 class WorkerParams
 {
 public:
+	WorkerParams() : confluxAssignment(CONFLUX_ASSIGNMENT_GREEDY), partitionImbalanceTolerance(0.05), spinBarrier(false),
+			barrierSpinCount(4000) {}
+
 	struct WorkerConf
 	{
 		WorkerConf() : count(0), granularityMs(0) {}
@@ -157,7 +160,53 @@ public:
 		unsigned int granularityMs;
 	};
 
+	/**
+	 * Parameters for periodic migration of confluxes between workers during the run
+	 */
+	struct RebalancingConf
+	{
+		RebalancingConf() : enabled(false), intervalSec(300), imbalanceThreshold(0.1), maxMigrations(32) {}
+
+		/// is the rebalancer enabled?
+		bool enabled;
+
+		/// length of a measurement interval in seconds of simulated time
+		unsigned int intervalSec;
+
+		/// confluxes are migrated when the slowest worker exceeds the average update time by this fraction
+		double imbalanceThreshold;
+
+		/// maximum number of confluxes migrated at the end of an interval
+		unsigned int maxMigrations;
+	};
+
+	/**
+	 * Strategy used to distribute confluxes among person workers
+	 */
+	enum ConfluxAssignment
+	{
+		/// fill each worker by walking adjacent confluxes (default)
+		CONFLUX_ASSIGNMENT_GREEDY,
+		/// multilevel partitioning of the conflux graph weighted by expected link flows
+		CONFLUX_ASSIGNMENT_GRAPH_PARTITION
+	};
+
 	WorkerConf person;
+
+	/// strategy for assigning confluxes to workers
+	ConfluxAssignment confluxAssignment;
+
+	/// allowed relative excess of the heaviest worker's estimated load over the average (graph partitioning only)
+	double partitionImbalanceTolerance;
+
+	/// dynamic conflux rebalancing
+	RebalancingConf rebalancing;
+
+	/// should workers spin (then yield, then block) on the tick barriers instead of blocking immediately?
+	bool spinBarrier;
+
+	/// maximum number of spins before a worker yields at a tick barrier (spinBarrier only)
+	unsigned int barrierSpinCount;
 };
 
 struct DB_Details
@@ -304,7 +353,7 @@ struct TripChainOutputConfig
  */
 struct DAS_Config
 {
-	DAS_Config() : schema(""), table(""), updateProc(""), fileName(""), vehicleTable("")
+	DAS_Config() : schema(""), table(""), updateProc(""), fileName(""), vehicleTable(""), streamToDatabase(false)
 	{}
 
 	std::string schema;
@@ -312,6 +361,49 @@ struct DAS_Config
 	std::string updateProc;
 	std::string fileName;
 	std::string vehicleTable; // Eytan Gross
+
+	/// Flag to check whether the schedules are copied into the table while preday runs, rather than from fileName afterwards
+	bool streamToDatabase;
+};
+
+/**
+ * Structure to store the config of the preday zone and skim cache
+ */
+struct PredayDataCacheConfig
+{
+	PredayDataCacheConfig() : enabled(false), fileName("")
+	{}
+
+	/// Flag to check whether zones and skims are loaded from (and exported to) the cache file
+	bool enabled;
+	/// Path of the cache file
+	std::string fileName;
+};
+
+/**
+ * Structure to store the config of the evaluation of preday models
+ */
+struct PredayModelBackendConfig
+{
+	enum Backend
+	{
+		/// all models are evaluated by their Lua scripts
+		BACKEND_LUA,
+		/// models with a compiled specification are evaluated in C++, others by their Lua scripts
+		BACKEND_COMPILED,
+		/// models with a compiled specification are evaluated both ways and the choice probabilities compared
+		BACKEND_VALIDATE
+	};
+
+	PredayModelBackendConfig() : backend(BACKEND_LUA), tolerance(1e-6), startupChecks(100)
+	{}
+
+	Backend backend;
+	/// Largest admissible difference between the compiled and Lua choice probabilities in validation mode
+	double tolerance;
+	/// Number of evaluations of each compiled model (per preday thread) which are also run by the Lua script and
+	/// compared in compiled mode, before the script is no longer run. 0 disables the check.
+	unsigned int startupChecks;
 };
 
 
@@ -391,6 +483,20 @@ public:
 	 */
 	void setNumPredayThreads(unsigned numPredayThreads);
 
+	/**
+	 * Retrieves number of persons handed to a preday thread at a time
+	 *
+	 * @return chunk size
+	 */
+	unsigned getPredayChunkSize() const;
+
+	/**
+	 * Sets number of persons handed to a preday thread at a time
+	 *
+	 * @param predayChunkSize chunk size
+	 */
+	void setPredayChunkSize(unsigned predayChunkSize);
+
 	/**
 	 * the object of this class gets sealed when this function is called. No more changes will be allowed via the  setters
 	 */
@@ -800,6 +906,18 @@ public:
 	 */
 	void setThreadsNumInPersonLoader(unsigned int number);
 
+	/**
+	 * get number of demand intervals loaded ahead of the simulation by the person loader
+	 * @return the number of intervals; 0 if the demand is loaded synchronously
+	 */
+	unsigned int getPersonLoaderLookahead() const;
+
+	/**
+	 * set number of demand intervals loaded ahead of the simulation by the person loader
+	 * @param lookahead is the number of intervals; 0 to load the demand synchronously
+	 */
+	void setPersonLoaderLookahead(unsigned int lookahead);
+
 	/**
 	 * Enumerator for mid term run mode
 	 */
@@ -826,6 +944,12 @@ public:
 	/// Day Activity Schedule config information
 	DAS_Config dasConfig;
 
+	/// Preday zone and skim cache config information
+	PredayDataCacheConfig predayDataCache;
+
+	/// Preday model evaluation config information
+	PredayModelBackendConfig predayModelBackend;
+
 private:
 	/**
 	 * Constructor
@@ -856,6 +980,9 @@ private:
 	/// num of threads to run for preday
 	unsigned numPredayThreads;
 
+	/// num of persons handed to a preday thread at a time
+	unsigned predayChunkSize;
+
 	/// flag to indicate whether output files need to be enabled
 	bool fileOutputEnabled;
 
@@ -871,6 +998,9 @@ private:
 	/** the threads number in person loader*/
 	unsigned int threadsNumInPersonLoader;
 
+	/** number of demand intervals loaded ahead of the simulation by the person loader*/
+	unsigned int personLoaderLookahead;
+
 	/// supply update interval in frames
 	unsigned supplyUpdateInterval;
 
@@ -20,6 +20,7 @@
 namespace
 {
 const int DEFAULT_NUM_THREADS_DEMAND = 2; // default number of threads for demand
+const int DEFAULT_PREDAY_CHUNK_SIZE = 32; // default number of persons handed to a preday thread at a time
 const unsigned NUM_METERS_IN_KM = 1000;
 const unsigned NUM_SECONDS_IN_AN_HOUR = 3600;
 
@@ -147,6 +148,7 @@ void ParseMidTermConfigFile::processSupplyNode(xercesc::DOMElement* node)
 	processDwellTimeElement(GetSingleElementByName(node, "dwell_time_parameters", true));
 	processWalkSpeedElement(GetSingleElementByName(node, "pedestrian_walk_speed", true));
 	processThreadsNumInPersonLoaderElement(GetSingleElementByName(node, "thread_number_in_person_loader", true));
+	processPersonLoaderLookaheadElement(GetSingleElementByName(node, "person_loader_lookahead"));
 	processStatisticsOutputNode(GetSingleElementByName(node, "output_statistics", true));
 	processBusCapactiyElement(GetSingleElementByName(node, "bus_default_capacity", true));
 	processSpeedDensityParamsNode(GetSingleElementByName(node, "speed_density_params", true));
@@ -169,6 +171,12 @@ void ParseMidTermConfigFile::processPredayNode(xercesc::DOMElement* node)
 
 	childNode = GetSingleElementByName(node, "threads", true);
 	mtCfg.setNumPredayThreads(ParseUnsignedInt(GetNamedAttributeValue(childNode, "value", true), DEFAULT_NUM_THREADS_DEMAND));
+	unsigned int chunkSize = ParseUnsignedInt(GetNamedAttributeValue(childNode, "chunk_size", false), DEFAULT_PREDAY_CHUNK_SIZE);
+	if (chunkSize == 0)
+	{
+		throw std::runtime_error("Invalid value for <threads chunk_size=\"0\">. Expected: \"positive value\"");
+	}
+	mtCfg.setPredayChunkSize(chunkSize);
 
 	if(mtCfg.runningPredaySimulation() || mtCfg.RunningMidFullLoop() || mtCfg.RunningMidPredayFull() )
 	{
@@ -190,6 +198,26 @@ void ParseMidTermConfigFile::processPredayNode(xercesc::DOMElement* node)
 	//jo {Apr12 for vehicle table
 	mtCfg.dasConfig.vehicleTable = ParseString(GetNamedAttributeValue(childNode, "vehicleTable", true));
 	//}jo
+	mtCfg.dasConfig.streamToDatabase = ParseBoolean(GetNamedAttributeValue(childNode, "stream", false), false);
+
+	childNode = GetSingleElementByName(node, "data_cache", false);
+	if (childNode)
+	{
+		mtCfg.predayDataCache.enabled = ParseBoolean(GetNamedAttributeValue(childNode, "enabled", true));
+		mtCfg.predayDataCache.fileName = ParseString(GetNamedAttributeValue(childNode, "file", true));
+	}
+
+	childNode = GetSingleElementByName(node, "model_backend", false);
+	if (childNode)
+	{
+		std::string backend = ParseString(GetNamedAttributeValue(childNode, "value", true));
+		if (backend == "lua") { mtCfg.predayModelBackend.backend = PredayModelBackendConfig::BACKEND_LUA; }
+		else if (backend == "compiled") { mtCfg.predayModelBackend.backend = PredayModelBackendConfig::BACKEND_COMPILED; }
+		else if (backend == "validate") { mtCfg.predayModelBackend.backend = PredayModelBackendConfig::BACKEND_VALIDATE; }
+		else { throw std::runtime_error("Inadmissible value for preday model_backend. Expected lua, compiled or validate"); }
+		mtCfg.predayModelBackend.tolerance = ParseFloat(GetNamedAttributeValue(childNode, "tolerance", false), 1e-6);
+		mtCfg.predayModelBackend.startupChecks = ParseUnsignedInt(GetNamedAttributeValue(childNode, "startup_checks", false), 100);
+	}
 
 	ModelScriptsMap luaModelsMap = processModelScriptsNode(GetSingleElementByName(node, "model_scripts", true));
 	cfg.predayLuaScriptsMap = luaModelsMap;
@@ -449,6 +477,16 @@ void ParseMidTermConfigFile::processThreadsNumInPersonLoaderElement(xercesc::DOM
 	mtCfg.setThreadsNumInPersonLoader(num);
 }
 
+void ParseMidTermConfigFile::processPersonLoaderLookaheadElement(xercesc::DOMElement* node)
+{
+	if(!node)
+	{
+		return;
+	}
+
+	mtCfg.setPersonLoaderLookahead(ParseUnsignedInt(GetNamedAttributeValue(node, "value", true), 1));
+}
+
 void ParseMidTermConfigFile::processBusCapactiyElement(xercesc::DOMElement* node)
 {
 	mtCfg.setBusCapacity(ParseUnsignedInt(GetNamedAttributeValue(node, "value", true), nullptr));
@@ -621,6 +659,9 @@ void ParseMidTermConfigFile::processGenericPropsNode(DOMElement *node)
 void ParseMidTermConfigFile::processWorkersNode(DOMElement *node)
 {
 	processWorkerPersonNode(GetSingleElementByName(node, "person", true));
+	processConfluxAssignmentNode(GetSingleElementByName(node, "conflux_assignment"));
+	processConfluxRebalancingNode(GetSingleElementByName(node, "conflux_rebalancing"));
+	processWorkerBarrierNode(GetSingleElementByName(node, "barrier"));
 }
 
 void ParseMidTermConfigFile::processWorkerPersonNode(DOMElement *node)
@@ -629,6 +670,79 @@ void ParseMidTermConfigFile::processWorkerPersonNode(DOMElement *node)
 	mtCfg.workers.person.granularityMs = ParseGranularitySingle(GetNamedAttributeValue(node, "granularity"));
 }
 
+void ParseMidTermConfigFile::processConfluxAssignmentNode(DOMElement *node)
+{
+	if (!node)
+	{
+		mtCfg.workers.confluxAssignment = WorkerParams::CONFLUX_ASSIGNMENT_GREEDY;
+		return;
+	}
+
+	std::string method = ParseString(GetNamedAttributeValue(node, "method"), "greedy");
+	if (method == "greedy")
+	{
+		mtCfg.workers.confluxAssignment = WorkerParams::CONFLUX_ASSIGNMENT_GREEDY;
+	}
+	else if (method == "graph_partition")
+	{
+		mtCfg.workers.confluxAssignment = WorkerParams::CONFLUX_ASSIGNMENT_GRAPH_PARTITION;
+	}
+	else
+	{
+		std::stringstream msg;
+		msg << "Invalid value for <conflux_assignment method=\"" << method
+		    << "\">. Expected: \"greedy\" or \"graph_partition\"";
+		throw std::runtime_error(msg.str());
+	}
+
+	mtCfg.workers.partitionImbalanceTolerance = ParseFloat(GetNamedAttributeValue(node, "imbalance_tolerance", false), 0.05f);
+	if (mtCfg.workers.partitionImbalanceTolerance < 0)
+	{
+		std::stringstream msg;
+		msg << "Invalid value for <conflux_assignment imbalance_tolerance=\"" << mtCfg.workers.partitionImbalanceTolerance
+		    << "\">. Expected: \"non negative value\"";
+		throw std::runtime_error(msg.str());
+	}
+}
+
+void ParseMidTermConfigFile::processConfluxRebalancingNode(DOMElement *node)
+{
+	WorkerParams::RebalancingConf& rebalancing = mtCfg.workers.rebalancing;
+	if (!node)
+	{
+		rebalancing.enabled = false;
+		return;
+	}
+
+	rebalancing.enabled = ParseBoolean(GetNamedAttributeValue(node, "enabled", false), false);
+	if (!rebalancing.enabled)
+	{
+		return;
+	}
+
+	rebalancing.intervalSec = ParseUnsignedInt(GetNamedAttributeValue(node, "interval", false), 300);
+	if (rebalancing.intervalSec == 0)
+	{
+		throw std::runtime_error("Invalid value for <conflux_rebalancing interval=\"0\">. Expected: \"positive value (seconds)\"");
+	}
+
+	rebalancing.imbalanceThreshold = ParseFloat(GetNamedAttributeValue(node, "imbalance_threshold", false), 0.1f);
+	if (rebalancing.imbalanceThreshold < 0)
+	{
+		std::stringstream msg;
+		msg << "Invalid value for <conflux_rebalancing imbalance_threshold=\"" << rebalancing.imbalanceThreshold
+		    << "\">. Expected: \"non negative value\"";
+		throw std::runtime_error(msg.str());
+	}
+
+	rebalancing.maxMigrations = ParseUnsignedInt(GetNamedAttributeValue(node, "max_migrations", false), 32);
+}
+
+void ParseMidTermConfigFile::processWorkerBarrierNode(DOMElement *node)
+{
+	ParseWorkerBarrier(node, mtCfg.workers.spinBarrier, mtCfg.workers.barrierSpinCount);
+}
+
 void ParseMidTermConfigFile::processScreenLineNode(DOMElement *node)
 {
 	if(node)
@@ -122,6 +122,13 @@ private:
 	 */
 	void processThreadsNumInPersonLoaderElement(xercesc::DOMElement* node);
 
+	/**
+	 * processes the number of demand intervals loaded ahead of the simulation by the person loader
+	 *
+	 * @param node corresponding to the person_loader_lookahead element inside xml file; may be null
+	 */
+	void processPersonLoaderLookaheadElement(xercesc::DOMElement* node);
+
 	/**
      * processes model scripts element in config xml
      *
@@ -183,6 +190,27 @@ private:
 	 */
 	void processWorkerPersonNode(xercesc::DOMElement* node);
 
+	/**
+	 * processes the conflux_assignment element (optional) in config xml
+	 *
+	 * @param node node corresponding to the conflux_assignment element inside xml file
+	 */
+	void processConfluxAssignmentNode(xercesc::DOMElement* node);
+
+	/**
+	 * processes the conflux_rebalancing element (optional) in config xml
+	 *
+	 * @param node node corresponding to the conflux_rebalancing element inside xml file
+	 */
+	void processConfluxRebalancingNode(xercesc::DOMElement* node);
+
+	/**
+	 * processes the barrier element (optional) in config xml
+	 *
+	 * @param node node corresponding to the barrier element inside xml file
+	 */
+	void processWorkerBarrierNode(xercesc::DOMElement* node);
+
 	/**
 	 * processes the ScreenLine element in config xml
 	 *
@@ -93,6 +93,28 @@ void BusStopAgent::removeWaitingPerson(sim_mob::medium::WaitBusActivity* waiting
     }
 }
 
+void BusStopAgent::reRegisterHandlers(void* context)
+{
+    if (!GetContext())
+    {
+        return;
+    }
+    messaging::MessageBus::ReRegisterHandler(this, context);
+
+    for (std::list<sim_mob::medium::WaitBusActivity*>::iterator i = waitingPersons.begin(); i != waitingPersons.end(); i++)
+    {
+        messaging::MessageBus::ReRegisterHandler((*i)->getParent(), context);
+    }
+
+    for (std::list<sim_mob::medium::Passenger*>::iterator i = alightingPersons.begin(); i != alightingPersons.end(); i++)
+    {
+        if ((*i)->getParent()->GetContext())
+        {
+            messaging::MessageBus::ReRegisterHandler((*i)->getParent(), context);
+        }
+    }
+}
+
 void BusStopAgent::addAlightingPerson(sim_mob::medium::Passenger* passenger)
 {
     Person_MT* person = passenger->getParent();
@@ -146,7 +168,7 @@ Entity::UpdateStatus BusStopAgent::frame_tick(timeslice now)
                             if (twinStopAgent)
                             {
                                 messaging::MessageBus::SendMessage(twinStopAgent, MSG_WAITING_PERSON_ARRIVAL,
-                                        messaging::MessageBus::MessagePtr(new ArrivalAtStopMessage(person)));
+                                        messaging::MessageBus::MakeMessage<ArrivalAtStopMessage>(person));
                             }
                         }
                         else
@@ -160,7 +182,7 @@ Entity::UpdateStatus BusStopAgent::frame_tick(timeslice now)
                 {
                     Conflux* conflux = parentSegmentStats->getParentConflux();
                     messaging::MessageBus::PostMessage(conflux, sim_mob::medium::MSG_PEDESTRIAN_TRANSFER_REQUEST,
-                            messaging::MessageBus::MessagePtr(new PersonMessage(person)));
+                            messaging::MessageBus::MakeMessage<PersonMessage>(person));
                     ret = true;
                 }
                 else if (role->roleType == Role<Person_MT>::RL_PASSENGER && val.status == UpdateStatus::RS_DONE)
@@ -192,7 +214,7 @@ Entity::UpdateStatus BusStopAgent::frame_tick(timeslice now)
     waitingCnt.currTime = DailyTime(now.ms()).getStrRepr();
     waitingCnt.count = waitingPersons.size();
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_WAITING_PERSON_COUNT,
-                                            messaging::MessageBus::MessagePtr(new WaitingCountMessage(waitingCnt)));
+                                            messaging::MessageBus::MakeMessage<WaitingCountMessage>(waitingCnt));
 
     for(auto* busDriver : servingDrivers)
     {
@@ -298,7 +320,7 @@ void BusStopAgent::storeWaitingTime(sim_mob::medium::WaitBusActivity* waitingAct
     personWaitInfo.busLines = waitingActivity->getBusLines();
     personWaitInfo.deniedBoardingCount = waitingActivity->getDeniedBoardingCount();
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_WAITING,
-            messaging::MessageBus::MessagePtr(new PersonWaitingTimeMessage(personWaitInfo)));
+            messaging::MessageBus::MakeMessage<PersonWaitingTimeMessage>(personWaitInfo));
 }
 
 void BusStopAgent::boardWaitingPersons(BusDriver* busDriver)
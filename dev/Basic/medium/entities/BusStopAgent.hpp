@@ -46,6 +46,13 @@ public:
      */
     void removeWaitingPerson(sim_mob::medium::WaitBusActivity* waitingActivity);
 
+    /**
+     * moves the message handlers of this agent and of the persons waiting or alighting at this stop
+     * into the given message context. Handlers which are not registered yet are left untouched.
+     * @param context the new message context
+     */
+    void reRegisterHandlers(void* context);
+
     /**
      * add person who is alighting at this stop
      * @param person person who is alighting at this bus stop
@@ -7,8 +7,9 @@
 #include "conf/ConfigManager.hpp"
 #include "entities/misc/TaxiTrip.hpp"
 #include "entities/Person_MT.hpp"
+#include "util/RandomService.hpp"
 
-#include <random>
+#include <algorithm>
 
 using namespace std;
 using namespace sim_mob;
@@ -60,8 +61,8 @@ void FleetController_MT::initialise(std::set<sim_mob::Entity *> &agentList)
         }
 
         if (randomisedTaxiFleet.size() > maxFleetSize) {
-            auto rng = std::default_random_engine {};
-            std::shuffle(std::begin(randomisedTaxiFleet), std::end(randomisedTaxiFleet), rng);
+            RandomStream fleetRandom(controllerID, RANDOM_FLEET);
+            std::shuffle(std::begin(randomisedTaxiFleet), std::end(randomisedTaxiFleet), fleetRandom);
             randomisedTaxiFleet.resize(maxFleetSize);
         }
 
@@ -6,6 +6,8 @@
 #include "MT_PersonLoader.hpp"
 
 #include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
 #include <boost/lexical_cast.hpp>
 #include <cmath>
 #include <functional>
@@ -231,6 +233,20 @@ void setActivityStartEnd(sim_mob::Activity* activity, double startInterval, doub
 	activity->endTime = sim_mob::DailyTime(randomEndTime);
 }
 
+/**
+ * @param loadStart half hour window starting a load interval
+ * @return the half hour window starting the following load interval
+ */
+double getFollowingLoadStart(double loadStart)
+{
+	double next = loadStart + DEFAULT_LOAD_INTERVAL + DEFAULT_LOAD_INTERVAL;
+	if(next > LAST_30MIN_WINDOW_OF_DAY)
+	{
+		next = next - TWENTY_FOUR_HOURS; //next day starts at 3.25
+	}
+	return next;
+}
+
 DB_Connection getDB_Connection(const DatabaseDetails& dbInfo)
 {
 	const std::string& dbId = dbInfo.database;
@@ -243,6 +259,30 @@ DB_Connection getDB_Connection(const DatabaseDetails& dbInfo)
 	return DB_Connection(sim_mob::db::POSTGRES, dbConfig);
 }
 
+/**
+ * moves the trip chains of a map into a vector, in person id order
+ * @param tripChainMap trip chains by person id; emptied
+ * @param tripChains output trip chains
+ */
+void orderTripChains(std::unordered_map<std::string, std::vector<TripChainItem*> >& tripChainMap,
+		std::vector<std::vector<TripChainItem*> >& tripChains)
+{
+	std::vector<std::string> personIds;
+	personIds.reserve(tripChainMap.size());
+	for(std::unordered_map<std::string, std::vector<TripChainItem*> >::const_iterator it=tripChainMap.begin(); it!=tripChainMap.end(); it++)
+	{
+		personIds.push_back(it->first);
+	}
+	std::sort(personIds.begin(), personIds.end());
+
+	tripChains.resize(personIds.size());
+	for(size_t i = 0; i < personIds.size(); i++)
+	{
+		tripChains[i].swap(tripChainMap[personIds[i]]);
+	}
+	tripChainMap.clear();
+}
+
 }//anon namespace
 
 /**
@@ -257,71 +297,87 @@ public:
 	CellLoader():isLoadPersonInfo(false) {}
 
 	/**
-	 * function executed by each CellLoader thread
+	 * function executed by each CellLoader thread: loads the information of its persons
 	 */
 	void operator()(void)
 	{
 		id = boost::this_thread::get_id();
 		ConfigParams& cfg = ConfigManager::GetInstanceRW().FullConfig();
 
-		for (size_t i = 0; i < tripChainList.size(); i++)
+		for (size_t i = 0; i < persons.size(); i++)
+		{
+			Person_MT* person = persons[i];
+			if(isLoadPersonInfo)
+			{
+				if(person->getDatabaseId().find_first_not_of("0123456789-") == std::string::npos)
+				{   // to eliminate any dummy persons we include for background traffic
+					// person ids from long-term population are numeric
+					std::string::size_type sz;
+					DB_Connection populationConn = getDB_Connection(cfg.populationDatabase);
+					populationConn.connect();
+					if (!populationConn.isConnected())
+					{
+						throw std::runtime_error("connection to LT population database failed");
+					}
+					PopulationSqlDao populationDao(populationConn);
+					long long personId = std::stol(person->getDatabaseId(), &sz); //gets the numerical part before '-' from the person id
+					PersonParams personInfo;
+					populationDao.getOneById(personId, personInfo);
+					if (MT_Config::getInstance().isEnergyModelEnabled())
+					{
+						if (MT_Config::getInstance().getEnergyModel()->getModelType() == "tripenergy")
+						{
+							struct0_T vehicleStruct = MT_Config::getInstance().getEnergyModel()->initVehicleStruct(personInfo.getVehicleParams().getModel());
+							personInfo.getVehicleParams().setVehicleStruct(vehicleStruct);
+						}
+						else if (MT_Config::getInstance().getEnergyModel()->getModelType() == "simple")
+						{
+							std::string vehicleDriveTrainString ;
+							VehicleParams vp = personInfo.getVehicleParams();
+							switch (vp.getDrivetrain())
+							{
+							case VehicleParams::ICE : vehicleDriveTrainString = "ICE"; break;
+							case VehicleParams::HEV : vehicleDriveTrainString = "HEV"; break;
+							case VehicleParams::PHEV : vehicleDriveTrainString = "PHEV"; break;
+							case VehicleParams::BEV : vehicleDriveTrainString = "BEV"; break;
+							case VehicleParams::FCV : vehicleDriveTrainString = "FCV"; break;
+							default : vehicleDriveTrainString = "ICE"; break;
+							}
+							struct0_T vehicleStruct = MT_Config::getInstance().getEnergyModel()->initVehicleStruct(vehicleDriveTrainString);
+							personInfo.getVehicleParams().setVehicleStruct(vehicleStruct);
+						}
+					}
+					person->setPersonInfo(personInfo);
+				}
+			}
+		}
+	}
+
+	/**
+	 * constructs the persons of trip chains on the calling thread, in the order of the trip chains, so that their ids
+	 * follow that order; the information of the persons is then loaded by parallel threads
+	 * @param tripChains trip chains of the persons; emptied
+	 * @param outPersonsLoaded output persons, in the order of their trip chains
+	 * @return the number of output persons
+	 */
+	static int load(std::vector<std::vector<TripChainItem*> >& tripChains, std::vector<Person_MT*>& outPersonsLoaded)
+	{
+		ConfigParams& cfg = ConfigManager::GetInstanceRW().FullConfig();
+		std::vector<Person_MT*> persons;
+		for (size_t i = 0; i < tripChains.size(); i++)
 		{
-			std::vector<TripChainItem*>& personTripChain = tripChainList[i];
+			std::vector<TripChainItem*>& personTripChain = tripChains[i];
 			if (personTripChain.empty()) { continue; }
 			Person_MT* person = new Person_MT("DAS_TripChain", cfg.mutexStategy(), personTripChain);
 			if (!person->getTripChain().empty())
 			{
 				//Set the usage of in-simulation travel times
 				//Generate random number between 0 and 100 (indicates percentage)
-				int randomInt = Utils::generateInt(0, 100);
+				int randomInt = person->getRandomStream().uniformInt(0, 100);
 				if(randomInt <= cfg.simulation.inSimulationTTUsage)
 				{
 					person->setUseInSimulationTravelTime(true);
 				}
-
-				if(isLoadPersonInfo)
-				{
-					if(person->getDatabaseId().find_first_not_of("0123456789-") == std::string::npos)
-					{   // to eliminate any dummy persons we include for background traffic
-						// person ids from long-term population are numeric
-						std::string::size_type sz;
-						DB_Connection populationConn = getDB_Connection(cfg.populationDatabase);
-						populationConn.connect();
-						if (!populationConn.isConnected())
-						{
-							throw std::runtime_error("connection to LT population database failed");
-						}
-						PopulationSqlDao populationDao(populationConn);
-						long long personId = std::stol(person->getDatabaseId(), &sz); //gets the numerical part before '-' from the person id
-						PersonParams personInfo;
-						populationDao.getOneById(personId, personInfo);
-						if (MT_Config::getInstance().isEnergyModelEnabled())
-						{
-							if (MT_Config::getInstance().getEnergyModel()->getModelType() == "tripenergy")
-							{
-								struct0_T vehicleStruct = MT_Config::getInstance().getEnergyModel()->initVehicleStruct(personInfo.getVehicleParams().getModel());
-								personInfo.getVehicleParams().setVehicleStruct(vehicleStruct);
-							}
-							else if (MT_Config::getInstance().getEnergyModel()->getModelType() == "simple")
-							{
-								std::string vehicleDriveTrainString ;
-								VehicleParams vp = personInfo.getVehicleParams();
-								switch (vp.getDrivetrain())
-								{
-								case VehicleParams::ICE : vehicleDriveTrainString = "ICE"; break;
-								case VehicleParams::HEV : vehicleDriveTrainString = "HEV"; break;
-								case VehicleParams::PHEV : vehicleDriveTrainString = "PHEV"; break;
-								case VehicleParams::BEV : vehicleDriveTrainString = "BEV"; break;
-								case VehicleParams::FCV : vehicleDriveTrainString = "FCV"; break;
-								default : vehicleDriveTrainString = "ICE"; break;
-								}
-								struct0_T vehicleStruct = MT_Config::getInstance().getEnergyModel()->initVehicleStruct(vehicleDriveTrainString);
-								personInfo.getVehicleParams().setVehicleStruct(vehicleStruct);
-							}
-						}
-						person->setPersonInfo(personInfo);
-					}
-				}
 				persons.push_back(person);
 			}
 			else
@@ -329,40 +385,33 @@ public:
 				safe_delete_item(person);
 			}
 		}
-	}
+		tripChains.clear();
 
-	static int load(std::unordered_map<std::string, std::vector<TripChainItem*> >& tripChainMap, std::vector<Person_MT*>& outPersonsLoaded)
-	{
 		unsigned int numThreads = MT_Config::getInstance().getThreadsNumInPersonLoader();
-		int personsPerThread = tripChainMap.size() / numThreads;
 		CellLoader thread[numThreads];
 		boost::thread_group threadGroup;
-		int thIdx = 0;
-		for(std::unordered_map<std::string, std::vector<TripChainItem*> >::iterator tcMapIt=tripChainMap.begin(); tcMapIt!=tripChainMap.end(); tcMapIt++, thIdx=(thIdx+1)%numThreads)
+		for (size_t i = 0; i < persons.size(); i++)
 		{
-			thread[thIdx].tripChainList.push_back(tcMapIt->second);
+			thread[i % numThreads].persons.push_back(persons[i]);
 		}
 		for (int i = 0; i < numThreads; i++)
 		{
 			threadGroup.add_thread(new boost::thread(boost::ref(thread[i])));
 		}
 		threadGroup.join_all();
-		for (int i = 0; i < numThreads; i++)
-		{
-			outPersonsLoaded.insert(outPersonsLoaded.end(), thread[i].persons.begin(), thread[i].persons.end());
-		}
+		outPersonsLoaded.insert(outPersonsLoaded.end(), persons.begin(), persons.end());
 		return outPersonsLoaded.size();
 	}
 
 private:
 	std::vector<Person_MT*> persons;
-	std::vector<std::vector<TripChainItem*> > tripChainList;
 	boost::thread::id id;
 	bool isLoadPersonInfo;
 };
 
 MT_PersonLoader::MT_PersonLoader(std::set<sim_mob::Entity*>& activeAgents, StartTimePriorityQueue& pendinAgents)
-	: PeriodicPersonLoader(activeAgents, pendinAgents),isLoadPersonInfo(false)
+	: PeriodicPersonLoader(activeAgents, pendinAgents),isLoadPersonInfo(false),
+	  lookahead(MT_Config::getInstance().getPersonLoaderLookahead()), prefetchStart(0.0), demandRandom(0, RANDOM_DEMAND)
 {
 	ConfigParams& cfg = ConfigManager::GetInstanceRW().FullConfig();
 	dataLoadInterval = SECONDS_IN_ONE_HOUR; //1 hour by default. TODO: must be configurable.
@@ -370,6 +419,11 @@ MT_PersonLoader::MT_PersonLoader(std::set<sim_mob::Entity*>& activeAgents, Start
 	nextLoadStart = getHalfHourWindow(cfg.simulation.simStartTime.getValue()/1000);
 	storedProcName = cfg.getDatabaseProcMappings().procedureMappings["day_activity_schedule"];
 	freightStoredProcName = cfg.getDatabaseProcMappings().procedureMappings["freight_trips"];
+	if(!storedProcName.empty())
+	{
+		prefetchStart = nextLoadStart;
+		prefetcher.reset(new Prefetcher<IntervalDemand>(boost::bind(&MT_PersonLoader::produceInterval, this, _1, _2), lookahead));
+	}
 
 	if(isLoadPersonInfo){
 		DB_Connection populationConn = getDB_Connection(cfg.populationDatabase);
@@ -386,6 +440,19 @@ MT_PersonLoader::MT_PersonLoader(std::set<sim_mob::Entity*>& activeAgents, Start
 
 MT_PersonLoader::~MT_PersonLoader()
 {
+	if(prefetcher)
+	{
+		//intervals loaded ahead of the end of the simulation
+		std::vector<IntervalDemand> pending;
+		prefetcher->stop(pending);
+		for(std::vector<IntervalDemand>::iterator it = pending.begin(); it != pending.end(); it++)
+		{
+			for(size_t i = 0; i < it->tripChains.size(); i++)
+			{
+				clear_delete_vector(it->tripChains[i]);
+			}
+		}
+	}
 }
 
 void MT_PersonLoader::makeSubTrip(const soci::row& r, Trip* parentTrip, unsigned short subTripNo)
@@ -581,8 +648,10 @@ void MT_PersonLoader::loadMRT_Demand()
 		variablesReader.getNextRow(variableRow, false);
 	}
 
+	vector<vector<TripChainItem*> > orderedTripChains;
+	orderTripChains(tripchains, orderedTripChains);
 	vector<Person_MT*> persons;
-	int personsLoaded = CellLoader::load(tripchains, persons);
+	int personsLoaded = CellLoader::load(orderedTripChains, persons);
 	for (vector<Person_MT*>::iterator i = persons.begin(); i != persons.end();i++)
 	{
 		addOrStashPerson(*i);
@@ -591,19 +660,12 @@ void MT_PersonLoader::loadMRT_Demand()
 	Print() << "PersonLoader:: MRT loaded " << personsLoaded << endl;
 	Print() << "active_agents: " << activeAgents.size() << " | pending_agents: "<< pendingAgents.size() << endl;
 }
-void MT_PersonLoader::loadPersonDemand()
+void MT_PersonLoader::loadInterval(soci::session& sql_, double start, IntervalDemand& demand) const
 {
-	if(storedProcName.empty())
-	{
-		loadMRT_Demand();
-		return;
-	}
-    //Our SQL statement
+	//Our SQL statement
 	stringstream query;
-    ConfigParams& cfg = ConfigManager::GetInstanceRW().FullConfig();
-	double end = nextLoadStart + DEFAULT_LOAD_INTERVAL;
-	query << "select * from " << storedProcName << "(" << nextLoadStart << "," << end << ")";
-	soci::session sql_(soci::postgresql, cfg.getDatabaseConnectionString(false));
+	double end = start + DEFAULT_LOAD_INTERVAL;
+	query << "select * from " << storedProcName << "(" << start << "," << end << ")";
 
 	soci::rowset<soci::row> rs = (sql_.prepare << query.str());
 	unordered_map<string, vector<TripChainItem*> > tripchains;
@@ -623,11 +685,11 @@ void MT_PersonLoader::loadPersonDemand()
 			personTripChain.push_back(constructedTrip);
 
 			//Record the number of trips loaded
-            cfg.numTripsLoaded++;
+			demand.numTripsLoaded++;
 		}
 		else
 		{
-            cfg.numTripsNotLoaded++;
+			demand.numTripsNotLoaded++;
 			continue;
 		}
 
@@ -638,13 +700,13 @@ void MT_PersonLoader::loadPersonDemand()
 	}
 
 	//Record the total number of persons loaded from the day activity schedule
-    cfg.numPersonsLoaded += tripchains.size();
+	demand.numPersonsLoaded = tripchains.size();
 
 	if (!freightStoredProcName.empty())
 	{
 		//Our SQL statement
 		stringstream freightQuery;
-		freightQuery << "select * from " << freightStoredProcName << "(" << nextLoadStart << "," << end << ")";
+		freightQuery << "select * from " << freightStoredProcName << "(" << start << "," << end << ")";
 		std::string freightSql_str = freightQuery.str();
 
 		soci::rowset<soci::row> rsFreight = (sql_.prepare << freightSql_str);
@@ -666,19 +728,55 @@ void MT_PersonLoader::loadPersonDemand()
 		}
 	}
 
-	vector<Person_MT*> persons;
-	int personsLoaded = CellLoader::load(tripchains, persons);
+	demand.start = start;
+	orderTripChains(tripchains, demand.tripChains);
+}
 
+void MT_PersonLoader::produceInterval(std::size_t index, IntervalDemand& demand)
+{
+	if(!prefetchSession)
+	{
+		prefetchSession.reset(new soci::session(soci::postgresql, ConfigManager::GetInstance().FullConfig().getDatabaseConnectionString(false)));
+	}
+
+	//the trip and activity times are drawn from a stream of their own, whatever thread loads the interval
+	RandomService::Scope randomScope(demandRandom);
+	loadInterval(*prefetchSession, prefetchStart, demand);
+	prefetchStart = getFollowingLoadStart(prefetchStart);
+}
+
+void MT_PersonLoader::addInterval(IntervalDemand& demand)
+{
+	vector<Person_MT*> persons;
+	CellLoader::load(demand.tripChains, persons);
 	for(vector<Person_MT*>::iterator i=persons.begin(); i!=persons.end(); i++)
 	{
 		addOrStashPerson(*i);
 	}
 
+	ConfigParams& cfg = ConfigManager::GetInstanceRW().FullConfig();
+	cfg.numTripsLoaded += demand.numTripsLoaded;
+	cfg.numTripsNotLoaded += demand.numTripsNotLoaded;
+	cfg.numPersonsLoaded += demand.numPersonsLoaded;
+
 	//update next load start
-	nextLoadStart = end + DEFAULT_LOAD_INTERVAL;
-	if(nextLoadStart > LAST_30MIN_WINDOW_OF_DAY)
+	nextLoadStart = getFollowingLoadStart(demand.start);
+}
+
+void MT_PersonLoader::loadPersonDemand()
+{
+	if(storedProcName.empty())
 	{
-		nextLoadStart = nextLoadStart - TWENTY_FOUR_HOURS; //next day starts at 3.25
+		loadMRT_Demand();
+		return;
 	}
-}
 
+	boost::chrono::steady_clock::time_point waitStart = boost::chrono::steady_clock::now();
+	IntervalDemand demand;
+	prefetcher->take(demand);
+	double stall = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - waitStart).count();
+	stallTimes.push_back(stall);
+	Print() << "PersonLoader:: interval " << demand.start << " loaded " << demand.tripChains.size()
+			<< " persons; simulation waited " << stall << "s for them" << endl;
+	addInterval(demand);
+}
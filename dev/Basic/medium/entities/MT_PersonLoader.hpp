@@ -3,18 +3,30 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #pragma once
+#include <cstddef>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
 #include <soci/soci.h>
 #include <soci/postgresql/soci-postgresql.h>
 #include "entities/PersonLoader.hpp"
 #include "entities/misc/TripChain.hpp"
+#include "util/Prefetcher.hpp"
+#include "util/RandomService.hpp"
 
 namespace sim_mob
 {
 namespace medium
 {
+class Person_MT;
+
 /**
  * Sub-class of PersonLoader tailored for loading mid-term persons from day activity schedule
  *
+ * The trip chains of the next intervals are queried by a background thread, up to the configured lookahead, while
+ * the current interval simulates. loadPersonDemand() constructs the persons of an interval from its trip chains, in
+ * person id order, so that their ids do not depend on the timing of the background thread, and records how long it
+ * had to wait for the trip chains.
+ *
  * \author Harish Loganathan
  * \zhang huai peng
  */
@@ -28,12 +40,61 @@ public:
      * load activity schedules for next interval
      */
     virtual void loadPersonDemand();
+
+    /**
+     * @return the time in seconds the simulation waited for the demand of each interval, in loading order
+     */
+    const std::vector<double>& getStallTimes() const
+    {
+        return stallTimes;
+    }
+
 protected:
     /**
      * load MRT demand
      */
     void loadMRT_Demand();
 private:
+    /** trip chains loaded for a demand interval, waiting to be handed over to the simulation */
+    struct IntervalDemand
+    {
+        IntervalDemand() : start(0.0), numTripsLoaded(0), numTripsNotLoaded(0), numPersonsLoaded(0)
+        {
+        }
+
+        /** half hour window starting the interval (see getHalfHourWindow) */
+        double start;
+
+        /** trip chain of each person of the interval, in person id order */
+        std::vector<std::vector<TripChainItem*> > tripChains;
+
+        unsigned int numTripsLoaded;
+        unsigned int numTripsNotLoaded;
+        unsigned int numPersonsLoaded;
+    };
+
+    /**
+     * queries the trip chains of an interval
+     * @param sql session to query
+     * @param start half hour window starting the interval
+     * @param demand output demand of the interval
+     */
+    void loadInterval(soci::session& sql, double start, IntervalDemand& demand) const;
+
+    /**
+     * producer of the prefetcher: loads the interval starting at prefetchStart, and moves prefetchStart to the next
+     * interval. Runs on the prefetching thread; must not touch the simulation.
+     * @param index index of the interval since the start of the simulation
+     * @param demand output demand of the interval
+     */
+    void produceInterval(std::size_t index, IntervalDemand& demand);
+
+    /**
+     * constructs the persons of an interval and hands them over to the simulation, and moves to the next interval
+     * @param demand the demand of the interval
+     */
+    void addInterval(IntervalDemand& demand);
+
     /**
      * makes a single sub trip for trip (for now)
      * @param r row from database table
@@ -71,6 +132,24 @@ private:
 
     /**indicate whether load personal info*/
     bool isLoadPersonInfo;
+
+    /** number of intervals loaded ahead of the simulation; 0 to load synchronously */
+    unsigned int lookahead;
+
+    /** start of the next interval to load; used by produceInterval() only */
+    double prefetchStart;
+
+    /** session of produceInterval(), opened by its first call and kept for all the intervals */
+    boost::scoped_ptr<soci::session> prefetchSession;
+
+    /** stream of the random trip and activity times drawn by produceInterval() */
+    RandomStream demandRandom;
+
+    /** loads the intervals ahead of the simulation; null if the demand is loaded from the MRT trips file */
+    boost::scoped_ptr< Prefetcher<IntervalDemand> > prefetcher;
+
+    /** time waited for each interval, in seconds */
+    std::vector<double> stallTimes;
 };
 
 } // namespace medium
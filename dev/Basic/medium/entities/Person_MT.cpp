@@ -749,7 +749,7 @@ void Person_MT::EnRouteToNextTrip(const std::string& stationName, const DailyTim
 		rerouteInfo.isPT_loaded = isLoaded;
 		rerouteInfo.currentTime = now.getStrRepr();
 		messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-				STORE_PERSON_REROUTE, messaging::MessageBus::MessagePtr(new PT_RerouteInfoMessage(rerouteInfo)), true);
+				STORE_PERSON_REROUTE, messaging::MessageBus::MakeMessage<PT_RerouteInfoMessage>(rerouteInfo), true);
 		currSubTrip = subTrips.begin();
 		isFirstTick = true;
 	}
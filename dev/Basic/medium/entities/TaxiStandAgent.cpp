@@ -210,7 +210,7 @@ void TaxiStandAgent::storeWaitingTime(Person_MT* waitingPerson) const
             personWaitInfo.deniedBoardingCount = 0;
             personWaitInfo.waitingTime = waitingTime/1000;
             messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_WAITING,
-                    messaging::MessageBus::MessagePtr(new PersonWaitingTimeMessage(personWaitInfo)));
+                    messaging::MessageBus::MakeMessage<PersonWaitingTimeMessage>(personWaitInfo));
         }
     }
 }
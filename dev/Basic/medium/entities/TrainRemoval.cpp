@@ -118,7 +118,7 @@ namespace medium
             trainController->handleTrainReturnAfterTripCompletition((*itr)->getParent());
             itr = trainsToBeRemoved.erase(itr);
             //messaging::MessageBus::PostMessage(TrainController<Person_MT>::getInstance(),
-                                        //MSG_TRAIN_BACK_DEPOT, messaging::MessageBus::MessagePtr(new TrainMessage((*itr)->getParent())));
+                                        //MSG_TRAIN_BACK_DEPOT, messaging::MessageBus::MakeMessage<TrainMessage>((*itr)->getParent()));
         }
     }
 }
@@ -388,7 +388,7 @@ namespace medium
                 {
                     (*itr)->setNextRequested(TrainDriver::REQUESTED_TO_DEPOT);
                     messaging::MessageBus::PostMessage(TrainController<Person_MT>::getInstance(),
-                    MSG_TRAIN_BACK_DEPOT, messaging::MessageBus::MessagePtr(new TrainMessage((*itr)->getParent())));
+                    MSG_TRAIN_BACK_DEPOT, messaging::MessageBus::MakeMessage<TrainMessage>((*itr)->getParent()));
                     itr++;
                 }
                 pendingDrivers.clear();
@@ -486,7 +486,7 @@ namespace medium
                 }
             }
         }
-        messaging::MessageBus::PostMessage(this,INSERT_UNSCHEDULED_TRAIN,messaging::MessageBus::MessagePtr(new TrainDriverMessage(nullptr)));
+        messaging::MessageBus::PostMessage(this,INSERT_UNSCHEDULED_TRAIN,messaging::MessageBus::MakeMessage<TrainDriverMessage>(nullptr));
     }
 
     void TrainStationAgent::setLastDriver(std::string lineId,TrainDriver *driver)
@@ -507,7 +507,7 @@ namespace medium
             while (itPassenger != it->second.end() && parentConflux)
             {
                 messaging::MessageBus::PostMessage(parentConflux,
-                        PASSENGER_LEAVE_FRM_PLATFORM, messaging::MessageBus::MessagePtr(new PersonMessage((*itPassenger)->getParent())));
+                        PASSENGER_LEAVE_FRM_PLATFORM, messaging::MessageBus::MakeMessage<PersonMessage>((*itPassenger)->getParent()));
                 itPassenger = it->second.erase(itPassenger);
             }
         }
@@ -540,10 +540,10 @@ namespace medium
         {
             messaging::MessageBus::SubscribeEvent(EVT_DISRUPTION_CHANGEROUTE, this, *it);
             messaging::MessageBus::PublishInstantaneousEvent(EVT_DISRUPTION_CHANGEROUTE, this,
-                    messaging::MessageBus::EventArgsPtr(new ReRouteEventArgs(stationName,current.getValue())));
+                    messaging::MessageBus::MakeEventArgs<ReRouteEventArgs>(stationName,current.getValue()));
             messaging::MessageBus::UnSubscribeEvent(EVT_DISRUPTION_CHANGEROUTE, this, *it);
             messaging::MessageBus::PostMessage(parentConflux,
-                                PASSENGER_LEAVE_FRM_PLATFORM, messaging::MessageBus::MessagePtr(new PersonMessage(*it)));
+                                PASSENGER_LEAVE_FRM_PLATFORM, messaging::MessageBus::MakeMessage<PersonMessage>(*it));
         }
     }
     void TrainStationAgent::updateWaitPersons()
@@ -805,7 +805,7 @@ Entity::UpdateStatus TrainStationAgent::frame_tick(timeslice now)
                 {
 
                     messaging::MessageBus::PostMessage(this,TRAIN_ARRIVAL_AT_ENDPOINT,
-                                            messaging::MessageBus::MessagePtr(new TrainDriverMessage((*it))));
+                                            messaging::MessageBus::MakeMessage<TrainDriverMessage>((*it)));
                 }
                 it = trainDriver.erase(it);
                 it--;
@@ -925,7 +925,7 @@ Entity::UpdateStatus TrainStationAgent::frame_tick(timeslice now)
                 {
                     messaging::MessageBus::SubscribeEvent(EVT_DISRUPTION_STATION, this, *it);
                     messaging::MessageBus::PublishInstantaneousEvent(EVT_DISRUPTION_STATION, this,
-                            messaging::MessageBus::EventArgsPtr(new DisruptionEventArgs(*disruptionParam)));
+                            messaging::MessageBus::MakeEventArgs<DisruptionEventArgs>(*disruptionParam));
                     messaging::MessageBus::UnSubscribeEvent(EVT_DISRUPTION_STATION, this, *it);
                 }
             }
@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <string>
 #include <boost/algorithm/string.hpp>
+#include <boost/chrono.hpp>
 #include <sstream>
 #include <vector>
 #include <entities/roles/driver/OnCallDriverFacets.hpp>
@@ -40,6 +41,7 @@
 #include "entities/roles/driver/TrainDriverFacets.hpp"
 #include "entities/vehicle/VehicleBase.hpp"
 #include "entities/TrainController.hpp"
+#include "entities/TravelTimeManager.hpp"
 #include "event/args/EventArgs.hpp"
 #include "event/EventPublisher.hpp"
 #include "event/SystemEvents.hpp"
@@ -73,9 +75,33 @@ namespace
 {
 const double INFINITESIMAL_DOUBLE = 0.000001;
 const double PASSENGER_CAR_UNIT = 400.0; //cm; 4 m.
-const double MAX_DOUBLE = std::numeric_limits<double>::max();
 const double SHORT_SEGMENT_LENGTH_LIMIT = 5 * sim_mob::PASSENGER_CAR_UNIT; // 5 times a car's length
 const short EVADE_VQ_BOUNDS_THRESHOLD_TICKS = 24; //upper limit of number of ticks for which VQ size limit can reject a person from entering next link
+const double CONFLUX_BASE_UPDATE_COST = 1.0; //constant part of the estimated update cost of a conflux
+const double MAX_CONGESTION_RATIO = 4.0; //upper limit of historical to default travel time ratio used in load estimates
+
+/**
+ * ratio of historical to default travel time of a link, clamped to [1, MAX_CONGESTION_RATIO].
+ * 1 is returned if the travel times of the link are not known.
+ */
+double getCongestionRatio(const Link* lnk, const DailyTime& time)
+{
+    const TravelTimeManager* ttMgr = TravelTimeManager::getInstance();
+    try
+    {
+        double defaultTT = ttMgr->getDefaultLinkTT(lnk);
+        double historicalTT = ttMgr->getLinkTT(lnk, time);
+        if (defaultTT > 0 && historicalTT > 0)
+        {
+            return Utils::clamp(historicalTT / defaultTT, 1.0, MAX_CONGESTION_RATIO);
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        //no travel times for this link; treat it as uncongested
+    }
+    return 1.0;
+}
 }
 
 void sim_mob::medium::sortPersonsDecreasingRemTime(std::deque<Person_MT*>& personList)
@@ -95,7 +121,7 @@ std::unordered_map<const Node *,Conflux *> Conflux::nodeConfluxMap;
 Conflux::Conflux(Node* confluxNode, const MutexStrategy& mtxStrat, int id, bool isLoader) :
         Agent(mtxStrat, id), confluxNode(confluxNode), parentWorkerAssigned(false), currFrame(0, 0), isLoader(isLoader), numUpdatesThisTick(0),
         tickTimeInS(ConfigManager::GetInstance().FullConfig().baseGranSecond()), evadeVQ_Bounds(false), segStatsOutput(std::string()),
-        lnkStatsOutput(std::string())
+        lnkStatsOutput(std::string()), updateTime(0)
 {
     nodeConfluxMap[confluxNode] = this;
 
@@ -405,6 +431,7 @@ UpdateStatus Conflux::update(timeslice frameNumber)
         }
         else
         {
+            boost::chrono::steady_clock::time_point updateStart = boost::chrono::steady_clock::now();
             resetPositionOfLastUpdatedAgentOnLanes();
             resetPersonRemTimes(); //reset the remaining times of persons in lane infinity and VQ if required.
             processAgents(frameNumber); //process all agents in this conflux for this tick
@@ -416,6 +443,7 @@ UpdateStatus Conflux::update(timeslice frameNumber)
 
             setLastUpdatedFrame(frameNumber.frame());
             numUpdatesThisTick = 1;
+            updateTime += boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - updateStart).count();
             return UpdateStatus::ContinueIncomplete;
         }
     }
@@ -451,7 +479,7 @@ void Conflux::loadPersons()
         Conflux* conflux = Conflux::findStartingConflux(person, nextTickMS);
         if (conflux)
         {
-            messaging::MessageBus::PostMessage(conflux, MSG_PERSON_LOAD, messaging::MessageBus::MessagePtr(new PersonMessage(person)));
+            messaging::MessageBus::PostMessage(conflux, MSG_PERSON_LOAD, messaging::MessageBus::MakeMessage<PersonMessage>(person));
         }
         /*else
         {
@@ -462,13 +490,13 @@ void Conflux::loadPersons()
 
 void Conflux::processAgents(timeslice frameNumber)
 {
-    PersonList orderedPersons;
+    orderedPersons.clear();
     getAllPersonsUsingTopCMerge(orderedPersons); //merge on-road agents of this conflux into a single list
     orderedPersons.insert(orderedPersons.end(), activityPerformers.begin(), activityPerformers.end()); // append activity performers
     orderedPersons.insert(orderedPersons.end(), travelingPersons.begin(), travelingPersons.end());
     orderedPersons.insert(orderedPersons.end(), brokenPersons.begin(), brokenPersons.end());
 
-    for (PersonList::iterator personIt = orderedPersons.begin(); personIt != orderedPersons.end(); personIt++) //iterate and update all persons
+    for (std::vector<Person_MT*>::iterator personIt = orderedPersons.begin(); personIt != orderedPersons.end(); personIt++) //iterate and update all persons
     {
         (*personIt)->currTick = currFrame;
         updateAgent(*personIt);
@@ -532,6 +560,9 @@ void Conflux::updateAgent(Person_MT* person)
     //let the person know which worker is (indirectly) managing him
     person->currWorkerProvider = currWorkerProvider;
 
+    //draws made while the person moves come from his own stream
+    RandomService::Scope randomScope(person->getRandomStream());
+
     //capture person info before update
 
     PersonProps beforeUpdate(person, this);
@@ -633,7 +664,7 @@ bool Conflux::handleRoleChange(PersonProps& beforeUpdate, PersonProps& afterUpda
             if (taxiStandAgent)
             {
                 messaging::MessageBus::SendMessage(taxiStandAgent, MSG_WAITING_PERSON_ARRIVAL,
-                                                   messaging::MessageBus::MessagePtr(new ArrivalAtStopMessage(person)));
+                                                   messaging::MessageBus::MakeMessage<ArrivalAtStopMessage>(person));
             }
             else
             {
@@ -663,7 +694,7 @@ bool Conflux::handleRoleChange(PersonProps& beforeUpdate, PersonProps& afterUpda
             else //post a message to the next conflux to handover this person for thread safety
             {
                 sim_mob::messaging::MessageBus::PostMessage(afterUpdate.segStats->getParentConflux(), sim_mob::medium::MSG_PERSON_TRANSFER,
-                        sim_mob::messaging::MessageBus::MessagePtr(new PersonTransferMessage(person, afterUpdate.segStats, afterUpdate.lane)));
+                        sim_mob::messaging::MessageBus::MakeMessage<PersonTransferMessage>(person, afterUpdate.segStats, afterUpdate.lane));
             }
         }
         else
@@ -1248,6 +1279,99 @@ const std::vector<SegmentStats*>& sim_mob::medium::Conflux::findSegStats(const R
     return segmentAgents.find(rdSeg)->second;
 }
 
+double Conflux::getEstimatedUpdateCost(const DailyTime& time) const
+{
+    double cost = CONFLUX_BASE_UPDATE_COST;
+    for (UpstreamSegmentStatsMap::const_iterator upstreamIt = upstreamSegStatsMap.begin(); upstreamIt != upstreamSegStatsMap.end(); upstreamIt++)
+    {
+        double storagePCU = 0;
+        const SegmentStatsList& segStatsList = upstreamIt->second;
+        for (SegmentStatsList::const_iterator statsIt = segStatsList.begin(); statsIt != segStatsList.end(); statsIt++)
+        {
+            storagePCU += (*statsIt)->getNumVehicleLanes() * (*statsIt)->getLength() / sim_mob::PASSENGER_CAR_UNIT;
+        }
+        cost += storagePCU * getCongestionRatio(upstreamIt->first, time);
+    }
+    return cost;
+}
+
+double Conflux::getExpectedLinkFlow(const Link* lnk, const DailyTime& time) const
+{
+    UpstreamSegmentStatsMap::const_iterator upstreamIt = upstreamSegStatsMap.find(lnk);
+    if (upstreamIt == upstreamSegStatsMap.end() || upstreamIt->second.empty())
+    {
+        return 0.0;
+    }
+    //vehicles leave the link through its last segment stats
+    return upstreamIt->second.back()->getCapacity() * getCongestionRatio(lnk, time);
+}
+
+double Conflux::collectUpdateTime()
+{
+    double res = updateTime;
+    updateTime = 0;
+    return res;
+}
+
+bool Conflux::isMigratable() const
+{
+    if (isLoader || !stationAgents.empty() || !parkingAgents.empty())
+    {
+        return false;
+    }
+    for (UpstreamSegmentStatsMap::const_iterator upstreamIt = upstreamSegStatsMap.begin(); upstreamIt != upstreamSegStatsMap.end(); upstreamIt++)
+    {
+        const SegmentStatsList& linkSegments = upstreamIt->second;
+        for (SegmentStatsList::const_iterator segIt = linkSegments.begin(); segIt != linkSegments.end(); segIt++)
+        {
+            if ((*segIt)->hasTaxiStandAgents())
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Conflux::onWorkerEnter()
+{
+    void* context = GetContext();
+    if (!context)
+    {
+        return;
+    }
+
+    //persons in virtual queues are excluded; they already belong to the context of the downstream conflux
+    PersonList hostedPersons, tmpAgents;
+    for (UpstreamSegmentStatsMap::iterator upstreamIt = upstreamSegStatsMap.begin(); upstreamIt != upstreamSegStatsMap.end(); upstreamIt++)
+    {
+        const SegmentStatsList& linkSegments = upstreamIt->second;
+        for (SegmentStatsList::const_iterator segIt = linkSegments.begin(); segIt != linkSegments.end(); segIt++)
+        {
+            tmpAgents.clear();
+            (*segIt)->getPersons(tmpAgents);
+            hostedPersons.insert(hostedPersons.end(), tmpAgents.begin(), tmpAgents.end());
+            (*segIt)->reRegisterHandlers(context);
+        }
+    }
+    hostedPersons.insert(hostedPersons.end(), activityPerformers.begin(), activityPerformers.end());
+    hostedPersons.insert(hostedPersons.end(), pedestrianList.begin(), pedestrianList.end());
+    hostedPersons.insert(hostedPersons.end(), mrt.begin(), mrt.end());
+    hostedPersons.insert(hostedPersons.end(), travelingPersons.begin(), travelingPersons.end());
+    hostedPersons.insert(hostedPersons.end(), brokenPersons.begin(), brokenPersons.end());
+    hostedPersons.insert(hostedPersons.end(), stashedPersons.begin(), stashedPersons.end());
+
+    for (PersonList::iterator personIt = hostedPersons.begin(); personIt != hostedPersons.end(); personIt++)
+    {
+        Person_MT* person = *personIt;
+        if (person->GetContext())
+        {
+            messaging::MessageBus::ReRegisterHandler(person, context);
+        }
+        person->currWorkerProvider = currWorkerProvider;
+    }
+}
+
 LinkStats& Conflux::getLinkStats(const Link* lnk)
 {
     if(!lnk)
@@ -1457,7 +1581,7 @@ void Conflux::HandleMessage(messaging::Message::MessageType type, const messagin
     case MSG_WAKEUP_SHIFT_END:
     {
         const PersonMessage &msg = MSG_CAST(PersonMessage, message);
-        MessageBus::PostMessage(msg.person, MSG_WAKEUP_SHIFT_END, MessageBus::MessagePtr(new PersonMessage(msg.person)));
+        MessageBus::PostMessage(msg.person, MSG_WAKEUP_SHIFT_END, MessageBus::MakeMessage<PersonMessage>(msg.person));
         break;
     }
     default:
@@ -1561,7 +1685,7 @@ Entity::UpdateStatus Conflux::switchTripChainItem(Person_MT* person)
             {
                 throw std::runtime_error("Pedestrian role facets not/incorrectly initialized");
             }
-            messaging::MessageBus::PostMessage(destinationConflux, MSG_PEDESTRIAN_TRANSFER_REQUEST, messaging::MessageBus::MessagePtr(new PersonMessage(person)));
+            messaging::MessageBus::PostMessage(destinationConflux, MSG_PEDESTRIAN_TRANSFER_REQUEST, messaging::MessageBus::MakeMessage<PersonMessage>(person));
             break;
         }
         }
@@ -1762,7 +1886,7 @@ void Conflux::assignPersonToStationAgent(Person_MT* person)
                 std::string stationNo = platform->getStationNo();
                 Agent* stationAgent = TrainController<Person_MT>::getAgentFromStation(stationNo);
                 messaging::MessageBus::PostMessage(stationAgent,PASSENGER_ARRIVAL_AT_PLATFORM,
-                        messaging::MessageBus::MessagePtr(new PersonMessage(person)));
+                        messaging::MessageBus::MakeMessage<PersonMessage>(person));
             } else {
                 throw std::runtime_error("waiting train activity role don't exist.");
             }
@@ -1807,7 +1931,7 @@ void Conflux::assignPersonToBusStopAgent(Person_MT* person)
         BusStopAgent* busStopAgent = BusStopAgent::getBusStopAgentForStop(stop);
         if (busStopAgent)
         {
-            messaging::MessageBus::SendMessage(busStopAgent, MSG_WAITING_PERSON_ARRIVAL, messaging::MessageBus::MessagePtr(new ArrivalAtStopMessage(person)));
+            messaging::MessageBus::SendMessage(busStopAgent, MSG_WAITING_PERSON_ARRIVAL, messaging::MessageBus::MakeMessage<ArrivalAtStopMessage>(person));
         }
     }
 }
@@ -1822,7 +1946,7 @@ void Conflux::assignPersonToPedestrianlist(Person_MT* person)
         pedestrianList.push_back(person);
         uint32_t travelTime = role->getTravelTime();
         unsigned int tick = ConfigManager::GetInstance().FullConfig().baseGranMS();
-        messaging::MessageBus::PostMessage(this, MSG_WAKEUP_PEDESTRIAN, messaging::MessageBus::MessagePtr(new PersonMessage(person)), false, travelTime / tick);
+        messaging::MessageBus::PostMessage(this, MSG_WAKEUP_PEDESTRIAN, messaging::MessageBus::MakeMessage<PersonMessage>(person), false, travelTime / tick);
     }
 }
 
@@ -1907,7 +2031,7 @@ void Conflux::assignPersonToMRT(Person_MT* person)
         passengerRole->setEndPoint(person->currSubTrip->destination);
         passengerRole->Movement()->startTravelTimeMetric();
         unsigned int tick = ConfigManager::GetInstance().FullConfig().baseGranMS();
-        messaging::MessageBus::PostMessage(this, MSG_WAKEUP_MRT_PAX, messaging::MessageBus::MessagePtr(new PersonMessage(person)), false, travelTime / tick);
+        messaging::MessageBus::PostMessage(this, MSG_WAKEUP_MRT_PAX, messaging::MessageBus::MakeMessage<PersonMessage>(person), false, travelTime / tick);
     }
 }
 
@@ -1928,7 +2052,7 @@ void Conflux::stashPerson(Person_MT* person)
             person->setStartTime(currFrame.ms());
             person->getRole()->setTravelTime(travelTime);
             unsigned int tick = ConfigManager::GetInstance().FullConfig().baseGranMS();
-            messaging::MessageBus::PostMessage(this, MSG_WAKEUP_STASHED_PERSON, messaging::MessageBus::MessagePtr(new PersonMessage(person)), false,
+            messaging::MessageBus::PostMessage(this, MSG_WAKEUP_STASHED_PERSON, messaging::MessageBus::MakeMessage<PersonMessage>(person), false,
                     travelTime / tick);
         }
     }
@@ -2091,10 +2215,11 @@ PersonCount Conflux::countPersons() const
     return count;
 }
 
-void Conflux::getAllPersonsUsingTopCMerge(std::deque<Person_MT*>& mergedPersonDeque)
+void Conflux::getAllPersonsUsingTopCMerge(std::vector<Person_MT*>& mergedPersons)
 {
     SegmentStats* segStats = nullptr;
-    std::vector<PersonList> allPersonLists;
+    linkPersons.clear();
+    linkPersonsEnds.clear();
     int sumCapacity = 0;
 
     //need to calculate the time to intersection for each vehicle.
@@ -2104,7 +2229,6 @@ void Conflux::getAllPersonsUsingTopCMerge(std::deque<Person_MT*>& mergedPersonDe
         const SegmentStatsList& upstreamSegments = upStrmSegMapIt->second;
         sumCapacity += (int) (ceil((*upstreamSegments.rbegin())->getCapacity()));
         double totalTimeToSegEnd = 0;
-        std::deque<Person_MT*> oneDeque;
         for (SegmentStatsList::const_reverse_iterator rdSegIt = upstreamSegments.rbegin(); rdSegIt != upstreamSegments.rend(); rdSegIt++)
         {
             segStats = (*rdSegIt);
@@ -2115,82 +2239,26 @@ void Conflux::getAllPersonsUsingTopCMerge(std::deque<Person_MT*>& mergedPersonDe
                 speed = INFINITESIMAL_DOUBLE;
             }
             segStats->updateLinkDrivingTimes(totalTimeToSegEnd);
-            PersonList tmpAgents;
-            segStats->topCMergeLanesInSegment(tmpAgents);
+            segStats->topCMergeLanesInSegment(linkPersons);
             totalTimeToSegEnd += segStats->getLength() / speed;
-            oneDeque.insert(oneDeque.end(), tmpAgents.begin(), tmpAgents.end());
         }
-        allPersonLists.push_back(oneDeque);
+        linkPersonsEnds.push_back(linkPersons.size());
     }
 
-    topCMergeDifferentLinksInConflux(mergedPersonDeque, allPersonLists, sumCapacity);
-}
-
-void Conflux::topCMergeDifferentLinksInConflux(std::deque<Person_MT*>& mergedPersonDeque, std::vector<std::deque<Person_MT*> >& allPersonLists, int capacity)
-{
-    std::vector<std::deque<Person_MT*>::iterator> iteratorLists;
-
-    //init location
-    size_t dequeSize = allPersonLists.size();
-    for (std::vector<std::deque<Person_MT*> >::iterator it = allPersonLists.begin(); it != allPersonLists.end(); ++it)
+    //the persons of all links are in place; the sequences can point into linkPersons
+    linkMerge.clear();
+    std::size_t linkBegin = 0;
+    for (std::vector<std::size_t>::const_iterator endIt = linkPersonsEnds.begin(); endIt != linkPersonsEnds.end(); endIt++)
     {
-        iteratorLists.push_back(((*it)).begin());
+        linkMerge.addSequence(linkPersons.begin() + linkBegin, linkPersons.begin() + (*endIt));
+        linkBegin = *endIt;
     }
 
     //pick the Top C
-    for (size_t c = 0; c < capacity; c++)
-    {
-        double minVal = MAX_DOUBLE;
-        Person_MT* currPerson = nullptr;
-        std::vector<std::pair<int, Person_MT*> > equiTimeList;
-        for (size_t i = 0; i < dequeSize; i++)
-        {
-            if (iteratorLists[i] != (allPersonLists[i]).end())
-            {
-                currPerson = (*(iteratorLists[i]));
-                if (currPerson->drivingTimeToEndOfLink == minVal)
-                {
-                    equiTimeList.push_back(std::make_pair(i, currPerson));
-                }
-                else if (currPerson->drivingTimeToEndOfLink < minVal)
-                {
-                    minVal = (*iteratorLists[i])->drivingTimeToEndOfLink;
-                    equiTimeList.clear();
-                    equiTimeList.push_back(std::make_pair(i, currPerson));
-                }
-            }
-        }
-
-        if (equiTimeList.empty())
-        {
-            return; //no more vehicles
-        }
-        else
-        {
-            //we have to randomly choose from persons in equiDistantList
-            size_t numElements = equiTimeList.size();
-            std::pair<int, Person_MT*> chosenPair;
-            if (numElements == 1)
-            {
-                chosenPair = equiTimeList.front();
-            }
-            else
-            {
-                int chosenIdx = rand() % numElements;
-                chosenPair = equiTimeList[chosenIdx];
-            }
-            iteratorLists.at(chosenPair.first)++;
-            mergedPersonDeque.push_back(chosenPair.second);
-        }
-    }
-
-    //After pick the Top C, there are still some vehicles left in the deque
-    for (size_t i = 0; i < dequeSize; i++)
+    if (linkMerge.mergeTopC(static_cast<std::size_t>(sumCapacity), DrivingTimeToLinkEnd(), getRandomStream(), mergedPersons))
     {
-        if (iteratorLists[i] != (allPersonLists[i]).end())
-        {
-            mergedPersonDeque.insert(mergedPersonDeque.end(), iteratorLists[i], (allPersonLists[i]).end());
-        }
+        //After picking the Top C, append the vehicles left in the lists
+        linkMerge.appendRest(mergedPersons);
     }
 }
 //
@@ -2952,6 +3020,25 @@ void Conflux::CreateConfluxes()
         }
     }
     CreateLaneGroups();
+
+    //report the memory held by the lane state of the network
+    size_t numLanes = 0;
+    size_t laneStateBytes = 0;
+    for (std::set<Conflux*>::const_iterator cfxIt = confluxes.begin(); cfxIt != confluxes.end(); cfxIt++)
+    {
+        const UpstreamSegmentStatsMap& upSegsMap = (*cfxIt)->upstreamSegStatsMap;
+        for (UpstreamSegmentStatsMap::const_iterator upSegsMapIt = upSegsMap.begin(); upSegsMapIt != upSegsMap.end(); upSegsMapIt++)
+        {
+            const SegmentStatsList& segStatsList = upSegsMapIt->second;
+            for (SegmentStatsList::const_iterator segStatsIt = segStatsList.begin(); segStatsIt != segStatsList.end(); segStatsIt++)
+            {
+                numLanes += (*segStatsIt)->getLaneTable().size();
+                laneStateBytes += (*segStatsIt)->getLaneStateBytes();
+            }
+        }
+    }
+    Print() << "Lane state: " << numLanes << " lanes, " << laneStateBytes << " bytes ("
+            << (numLanes ? laneStateBytes / numLanes : 0) << " bytes per lane)" << std::endl;
 }
 
 void Conflux::CreateLaneGroups()
@@ -15,6 +15,8 @@
 #include "geospatial/network/Lane.hpp"
 #include "message/Message.hpp"
 #include "message/MT_Message.hpp"
+#include "util/DailyTime.hpp"
+#include "util/TopCMerge.hpp"
 #include "SegmentStats.hpp"
 
 namespace sim_mob
@@ -214,6 +216,32 @@ static std::unordered_map<const Node *,Conflux *> nodeConfluxMap;
      */
     std::string lnkStatsOutput;
 
+    /**
+     * wall-clock time (in microseconds) spent in the worker-side update of this conflux since the last call to collectUpdateTime()
+     */
+    double updateTime;
+
+    /**
+     * persons of this conflux in the order of their update in the current tick.
+     * This and the following buffers are reused in every tick.
+     */
+    std::vector<Person_MT*> orderedPersons;
+
+    /**
+     * on-road persons of the upstream links in the order of their update within each link, link after link
+     */
+    std::vector<Person_MT*> linkPersons;
+
+    /**
+     * position in linkPersons of the end of the persons of each upstream link
+     */
+    std::vector<std::size_t> linkPersonsEnds;
+
+    /**
+     * merger of the persons of the different upstream links
+     */
+    TopCMerge<std::vector<Person_MT*>::const_iterator> linkMerge;
+
     /**
      * updates agents in this conflux
      */
@@ -395,6 +423,12 @@ protected:
      */
     virtual void frame_output(timeslice now);
 
+    /**
+     * Moves the message handlers of all persons and bus stop agents hosted by this conflux
+     * into the message context of this conflux. Called when the conflux is (re-)assigned to a worker.
+     */
+    virtual void onWorkerEnter();
+
 public:
     Conflux(Node* confluxNode, const MutexStrategy& mtxStrat, int id=-1, bool isLoader=false);
     virtual ~Conflux() ;
@@ -510,6 +544,38 @@ public:
      */
     LinkStats& getLinkStats(const Link* lnk);
 
+    /**
+     * estimates the relative cost of updating this conflux in a tick.
+     * The estimate is the vehicle storage of all upstream lanes (in PCUs) scaled by the historical
+     * congestion ratio of each link at the given time, plus a constant per-conflux overhead.
+     * @param time time of day for which the estimate is required
+     * @return estimated update cost
+     */
+    double getEstimatedUpdateCost(const DailyTime& time) const;
+
+    /**
+     * estimates the flow of vehicles out of an upstream link of this conflux.
+     * The estimate is the output capacity of the link scaled by its historical congestion ratio at the given time.
+     * @param lnk upstream link of this conflux
+     * @param time time of day for which the estimate is required
+     * @return estimated flow in vehicles/s
+     */
+    double getExpectedLinkFlow(const Link* lnk, const DailyTime& time) const;
+
+    /**
+     * returns the wall-clock time spent in updating this conflux since the previous call and restarts the count
+     * @return update time in microseconds
+     */
+    double collectUpdateTime();
+
+    /**
+     * checks whether this conflux can be moved to another worker in the middle of the simulation.
+     * Loader confluxes and confluxes hosting train station, parking or taxi stand agents are pinned to their
+     * worker since these agents keep state (event subscriptions, queues of persons) tied to the worker's thread.
+     * @return true if this conflux can be migrated; false otherwise
+     */
+    bool isMigratable() const;
+
     /**
      * gets current speed of segStats
      * @param segStats seg stats for which speed is requested
@@ -610,19 +676,10 @@ public:
     PersonCount countPersons() const;
 
     /**
-     * get an ordered list of all persons in this conflux
-     * @param mergedPersonDeque output list that must contain the merged list of persons
-     */
-    void getAllPersonsUsingTopCMerge(std::deque<Person_MT*>& mergedPersonDeque);
-
-    /**
-     * merges the ordered list of persons on each link of the conflux into 1
-     * @param mergedPersonDeque output list that must contain the merged list of persons
-     * @param allPersonLists list of list of persons to merge
-     * @param capacity capacity till which the relative ordering of persons is important
+     * get an ordered list of all on-road persons in this conflux
+     * @param mergedPersons output list which the merged list of persons is appended to
      */
-    void topCMergeDifferentLinksInConflux(std::deque<Person_MT*>& mergedPersonDeque,
-            std::vector< std::deque<Person_MT*> >& allPersonLists, int capacity);
+    void getAllPersonsUsingTopCMerge(std::vector<Person_MT*>& mergedPersons);
 
     /**
      * get number of persons in lane infinities of this conflux
@@ -0,0 +1,222 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "ConfluxRebalancer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include "entities/conflux/Conflux.hpp"
+#include "logging/ControllerLog.hpp"
+#include "logging/Log.hpp"
+#include "workers/WorkGroup.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::medium;
+
+void WorkerLoadStats::print(std::ostream& os) const
+{
+    os << "tick: " << intervalEndTick
+       << " | workers: " << updateTimes.size()
+       << " | total update time (ms): " << (totalTime / 1000.0)
+       << " | max (ms): " << (maxTime / 1000.0)
+       << " | min (ms): " << (minTime / 1000.0)
+       << " | imbalance: " << std::fixed << std::setprecision(2) << (imbalance * 100.0) << "%"
+       << " | confluxes migrated: " << numMigrations << "\n";
+    os.unsetf(std::ios_base::floatfield);
+    os << std::setprecision(6) << "update times (ms):";
+    for (std::vector<double>::const_iterator it = updateTimes.begin(); it != updateTimes.end(); it++)
+    {
+        os << " " << (*it / 1000.0);
+    }
+    os << "\n";
+}
+
+ConfluxRebalancer::ConfluxRebalancer(WorkGroup* workGroup, const WorkerParams::RebalancingConf& params, unsigned int baseGranMS) :
+        workGroup(workGroup), params(params), ticksPerInterval(1)
+{
+    if (!workGroup)
+    {
+        throw std::runtime_error("ConfluxRebalancer: work group is null");
+    }
+    if (baseGranMS > 0)
+    {
+        ticksPerInterval = std::max<uint32_t>(1, (params.intervalSec * 1000) / baseGranMS);
+    }
+}
+
+void ConfluxRebalancer::update(uint32_t currTick)
+{
+    if ((currTick + 1) % ticksPerInterval != 0)
+    {
+        return;
+    }
+
+    if (neighbours.empty())
+    {
+        buildNeighbourhood();
+    }
+
+    WorkerLoadStats stats;
+    stats.intervalEndTick = currTick;
+    rebalance(stats);
+    history.push_back(stats);
+
+    std::stringstream report;
+    report << "Conflux rebalancing ";
+    stats.print(report);
+    Print() << report.str();
+    ControllerLog() << report.str();
+}
+
+void ConfluxRebalancer::buildNeighbourhood()
+{
+    std::map<Conflux*, std::set<Conflux*> > adjacency;
+    for (unsigned int wrkrIdx = 0; wrkrIdx < workGroup->size(); wrkrIdx++)
+    {
+        const std::vector<Entity*>& entities = workGroup->getWorkerEntities(wrkrIdx);
+        for (std::vector<Entity*>::const_iterator entIt = entities.begin(); entIt != entities.end(); entIt++)
+        {
+            Conflux* cfx = dynamic_cast<Conflux*>(*entIt);
+            if (!cfx)
+            {
+                continue;
+            }
+            adjacency[cfx];
+            std::set<Conflux*>& connected = cfx->getConnectedConfluxes();
+            for (std::set<Conflux*>::const_iterator cnIt = connected.begin(); cnIt != connected.end(); cnIt++)
+            {
+                if (*cnIt != cfx)
+                {
+                    adjacency[cfx].insert(*cnIt);
+                    adjacency[*cnIt].insert(cfx);
+                }
+            }
+        }
+    }
+
+    for (std::map<Conflux*, std::set<Conflux*> >::const_iterator adjIt = adjacency.begin(); adjIt != adjacency.end(); adjIt++)
+    {
+        neighbours[adjIt->first].assign(adjIt->second.begin(), adjIt->second.end());
+    }
+}
+
+void ConfluxRebalancer::rebalance(WorkerLoadStats& stats)
+{
+    const unsigned int numWorkers = workGroup->size();
+    workGroup->collectWorkerUpdateTimes(stats.updateTimes);
+    if (numWorkers == 0)
+    {
+        return;
+    }
+
+    //confluxes of each worker along with the time spent in updating them during the interval
+    std::vector< std::vector<Conflux*> > workerConfluxes(numWorkers);
+    std::map<Conflux*, unsigned int> owner;
+    std::map<Conflux*, double> cost;
+    for (unsigned int wrkrIdx = 0; wrkrIdx < numWorkers; wrkrIdx++)
+    {
+        const std::vector<Entity*>& entities = workGroup->getWorkerEntities(wrkrIdx);
+        for (std::vector<Entity*>::const_iterator entIt = entities.begin(); entIt != entities.end(); entIt++)
+        {
+            Conflux* cfx = dynamic_cast<Conflux*>(*entIt);
+            if (cfx)
+            {
+                workerConfluxes[wrkrIdx].push_back(cfx);
+                owner[cfx] = wrkrIdx;
+                cost[cfx] = cfx->collectUpdateTime();
+            }
+        }
+    }
+
+    std::vector<double> loads = stats.updateTimes;
+    stats.totalTime = 0.0;
+    for (std::vector<double>::const_iterator it = loads.begin(); it != loads.end(); it++)
+    {
+        stats.totalTime += *it;
+    }
+    stats.maxTime = *std::max_element(loads.begin(), loads.end());
+    stats.minTime = *std::min_element(loads.begin(), loads.end());
+    const double avgTime = stats.totalTime / numWorkers;
+    stats.imbalance = (avgTime > 0.0) ? (stats.maxTime / avgTime - 1.0) : 0.0;
+
+    if (stats.imbalance <= params.imbalanceThreshold)
+    {
+        return;
+    }
+
+    const double maxAllowed = avgTime * (1.0 + params.imbalanceThreshold);
+    while (stats.numMigrations < params.maxMigrations)
+    {
+        unsigned int donor = std::max_element(loads.begin(), loads.end()) - loads.begin();
+        unsigned int receiver = std::min_element(loads.begin(), loads.end()) - loads.begin();
+        if (loads[donor] <= maxAllowed)
+        {
+            break;
+        }
+
+        //moving a conflux of cost c lowers the maximum only if c is smaller than the gap between donor and receiver.
+        //The ideal conflux closes half the gap. Confluxes bordering the receiver's region are preferred to keep
+        //the exchange of persons between workers low.
+        const double gap = loads[donor] - loads[receiver];
+        std::vector<Conflux*>& donorConfluxes = workerConfluxes[donor];
+        std::vector<Conflux*>::iterator best = donorConfluxes.end();
+        bool bestIsAdjacent = false;
+        double bestDeviation = 0.0;
+        for (std::vector<Conflux*>::iterator cfxIt = donorConfluxes.begin(); cfxIt != donorConfluxes.end(); cfxIt++)
+        {
+            Conflux* cfx = *cfxIt;
+            double cfxCost = cost[cfx];
+            if (cfxCost <= 0.0 || cfxCost >= gap || !cfx->isMigratable())
+            {
+                continue;
+            }
+
+            bool adjacent = false;
+            const std::vector<Conflux*>& cfxNeighbours = neighbours[cfx];
+            for (std::vector<Conflux*>::const_iterator nbIt = cfxNeighbours.begin(); nbIt != cfxNeighbours.end(); nbIt++)
+            {
+                std::map<Conflux*, unsigned int>::const_iterator ownerIt = owner.find(*nbIt);
+                if (ownerIt != owner.end() && ownerIt->second == receiver)
+                {
+                    adjacent = true;
+                    break;
+                }
+            }
+
+            double deviation = std::abs(cfxCost - gap / 2.0);
+            if (best == donorConfluxes.end() || (adjacent && !bestIsAdjacent)
+                    || (adjacent == bestIsAdjacent && deviation < bestDeviation))
+            {
+                best = cfxIt;
+                bestIsAdjacent = adjacent;
+                bestDeviation = deviation;
+            }
+        }
+
+        if (best == donorConfluxes.end())
+        {
+            break;
+        }
+
+        Conflux* migrant = *best;
+        if (!workGroup->migrateEntity(migrant, receiver))
+        {
+            std::stringstream msg;
+            msg << "ConfluxRebalancer: could not move conflux " << migrant->getConfluxNode()->getNodeId()
+                << " from worker " << donor << " to worker " << receiver;
+            throw std::runtime_error(msg.str());
+        }
+
+        loads[donor] -= cost[migrant];
+        loads[receiver] += cost[migrant];
+        owner[migrant] = receiver;
+        donorConfluxes.erase(best);
+        workerConfluxes[receiver].push_back(migrant);
+        stats.numMigrations++;
+    }
+}
@@ -0,0 +1,122 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <stdint.h>
+#include <vector>
+#include "config/MT_Config.hpp"
+
+namespace sim_mob
+{
+class WorkGroup;
+
+namespace medium
+{
+class Conflux;
+
+/**
+ * Load statistics of the person workers over one rebalancing interval
+ */
+struct WorkerLoadStats
+{
+    WorkerLoadStats() : intervalEndTick(0), totalTime(0.0), maxTime(0.0), minTime(0.0), imbalance(0.0), numMigrations(0)
+    {
+    }
+
+    /** last tick of the interval */
+    uint32_t intervalEndTick;
+
+    /** wall-clock time (microseconds) spent by each worker in updating its entities, indexed by worker */
+    std::vector<double> updateTimes;
+
+    /** sum of the update times of all workers */
+    double totalTime;
+
+    /** update time of the slowest worker */
+    double maxTime;
+
+    /** update time of the fastest worker */
+    double minTime;
+
+    /** update time of the slowest worker divided by the average update time, minus 1. 0 indicates perfect balance */
+    double imbalance;
+
+    /** number of confluxes migrated at the end of the interval */
+    unsigned int numMigrations;
+
+    /**
+     * prints the stats as a human readable report
+     * @param os stream to print to
+     */
+    void print(std::ostream& os) const;
+};
+
+/**
+ * Periodically moves confluxes between the person workers to even out their update times.
+ *
+ * Every worker measures the wall-clock time it spends in updating its entities and every conflux measures
+ * the time spent in its own update. At the end of each interval, if the slowest worker exceeds the average
+ * by more than the configured threshold, confluxes are moved from the slowest worker to the fastest one,
+ * preferring confluxes which are adjacent to confluxes already managed by the fastest worker. A conflux carries
+ * all the persons and bus stop agents it hosts along with it.
+ *
+ * update() must be called by the main thread once every tick while all workers are waiting on a barrier.
+ */
+class ConfluxRebalancer
+{
+public:
+    /**
+     * @param workGroup work group of the person workers
+     * @param params rebalancing parameters
+     * @param baseGranMS length of a tick in milliseconds
+     */
+    ConfluxRebalancer(WorkGroup* workGroup, const WorkerParams::RebalancingConf& params, unsigned int baseGranMS);
+
+    /**
+     * measures the loads and rebalances the workers at the end of every interval
+     * @param currTick the tick which was just completed
+     */
+    void update(uint32_t currTick);
+
+    /**
+     * @return load statistics of every completed interval
+     */
+    const std::vector<WorkerLoadStats>& getHistory() const
+    {
+        return history;
+    }
+
+private:
+    /**
+     * builds the undirected adjacency of all confluxes managed by the workers
+     */
+    void buildNeighbourhood();
+
+    /**
+     * collects the loads of the last interval and migrates confluxes if the imbalance is too large
+     * @param stats output statistics of the interval
+     */
+    void rebalance(WorkerLoadStats& stats);
+
+    /** work group of the person workers */
+    WorkGroup* workGroup;
+
+    /** rebalancing parameters */
+    const WorkerParams::RebalancingConf params;
+
+    /** number of ticks in an interval */
+    uint32_t ticksPerInterval;
+
+    /** statistics of every completed interval */
+    std::vector<WorkerLoadStats> history;
+
+    /** confluxes adjacent (upstream or downstream) to each conflux */
+    std::map<Conflux*, std::vector<Conflux*> > neighbours;
+};
+
+}
+}
@@ -4,9 +4,13 @@
 
 #include "SegmentStats.hpp"
 
+#include <algorithm>
+#include <functional>
+
 #include "conf/ConfigManager.hpp"
 #include "config/MT_Config.hpp"
 #include "entities/BusStopAgent.hpp"
+#include "entities/conflux/Conflux.hpp"
 #include "entities/roles/driver/OnHailDriverFacets.hpp"
 #include "entities/TaxiStandAgent.hpp"
 //aa{
@@ -30,6 +34,13 @@ const double METERS_IN_KM = 1000.0;
 
 const double SINGLE_LANE_SEGMENT_CAPACITY = 1200.0; //veh/hr. suggested by Yang Lu on 11-Oct-2014
 const double DOUBLE_LANE_SEGMENT_CAPACITY = 3000.0; //veh/hr. suggested by Yang Lu on 11-Oct-2014
+
+/** @return the bytes of the heap allocation of a vector */
+template<typename T>
+std::size_t getHeapBytes(const std::vector<T>& values)
+{
+	return values.capacity() * sizeof(T);
+}
 }
 
 bool GreaterDistToSegmentEnd::operator ()(const Person_MT* x, const Person_MT* y) const
@@ -45,6 +56,70 @@ bool GreaterDistToSegmentEnd::operator ()(const Person_MT* x, const Person_MT* y
 	return (x->distanceToEndOfSegment > y->distanceToEndOfSegment);
 }
 
+LaneTable::LaneTable(unsigned int numLanes, double length) :
+		numLanes(numLanes), length(length), reals(NUM_REAL_FIELDS * numLanes, 0.0), counts(NUM_COUNT_FIELDS * numLanes, 0),
+		outputCounters(numLanes, 0), lanes(numLanes, nullptr), flags(numLanes, 0)
+{
+	std::fill_n(column(LAST_UPDATED_POSITION), numLanes, -1.0);
+}
+
+void LaneTable::setLane(unsigned int index, const Lane* lane, bool isLaneInfinity)
+{
+	lanes[index] = lane;
+	flags[index] = (lane->isPedestrianLane() ? FLAG_PEDESTRIAN_LANE : 0) | (isLaneInfinity ? FLAG_LANE_INFINITY : 0);
+}
+
+//density will be computed in vehicles/meter-lane for the moving part of the lane
+double LaneTable::getDensity(unsigned int index) const
+{
+	double density = 0.0;
+	double queueLength = get(QUEUE_LENGTH, index);
+	double movingPartLength = length - queueLength;
+	double movingPCUs = (get(TOTAL_LENGTH, index) - queueLength) / PASSENGER_CAR_UNIT;
+
+	if (movingPartLength > PASSENGER_CAR_UNIT)
+	{
+		density = movingPCUs / movingPartLength;
+	}
+	else
+	{
+		density = 1 / PASSENGER_CAR_UNIT;
+	}
+	return density;
+}
+
+void LaneTable::updateOutputCounter(unsigned int index, double updateInterval)
+{
+	const double outputFlowRate = get(OUTPUT_FLOW_RATE, index);
+	double& fraction = get(FRACTION, index);
+	int tmp = int(outputFlowRate * updateInterval);
+	fraction += outputFlowRate * updateInterval - tmp;
+	if (fraction >= 1.0)
+	{
+		fraction -= 1.0;
+		outputCounters[index] = tmp + 1;
+	}
+	else
+	{
+		outputCounters[index] = tmp;
+	}
+}
+
+void LaneTable::updateAcceptRate(unsigned int index, double speed, unsigned int numSegmentLanes)
+{
+	const double outputFlowRate = get(OUTPUT_FLOW_RATE, index);
+	double acceptRateA = (outputFlowRate > 0) ? (1.0 / outputFlowRate) : 0.0;
+	double acceptRateB = PASSENGER_CAR_UNIT / (numSegmentLanes * speed);
+	get(ACCEPT_RATE, index) = std::max(acceptRateA, acceptRateB);
+}
+
+std::size_t LaneTable::getMemoryBytes() const
+{
+	//the header is held by the segment stats; each of the five vectors is an allocation of its own
+	return sizeof(LaneTable) + getHeapBytes(reals) + getHeapBytes(counts) + getHeapBytes(outputCounters) + getHeapBytes(lanes)
+			+ getHeapBytes(flags);
+}
+
 ///*
 // * The parameters - min density, jam density, alpha and beta -
 // * must be obtained for each road segment from an external source (XML/Database)
@@ -85,27 +160,12 @@ SupplyParams::SupplyParams(const RoadSegment* rdSeg, double statsLength) :
 SegmentStats::SegmentStats(const RoadSegment* rdSeg, Conflux* parentConflux, double statslengthInM) :
 		roadSegment(rdSeg), length(statslengthInM), segDensity(0.0), segFlow(0), numPersons(0), statsNumberInSegment(1), supplyParams(rdSeg, statslengthInM), orderBySetting(
 				SEGMENT_ORDERING_BY_DISTANCE_TO_INTERSECTION), parentConflux(parentConflux),
-				totalEnergy(0), totalDistance(0),  energySamples(0)//aa: I added this line
+				totalEnergy(0), totalDistance(0),  energySamples(0),//aa: I added this line
+				laneTable(rdSeg->getLanes().size() + 1, statslengthInM)
 {
 	segVehicleSpeed = roadSegment->getMaxSpeed();
 	numVehicleLanes = 0;
 
-	// initialize LaneAgents in the map
-	std::vector<const Lane*>::const_iterator laneIt = rdSeg->getLanes().begin();
-	while (laneIt != rdSeg->getLanes().end())
-	{
-		LaneStats* lnStats = new LaneStats(*laneIt, length);
-		laneStatsMap.insert(std::make_pair(*laneIt, lnStats));
-		lnStats->initLaneParams(segVehicleSpeed, supplyParams.getCapacity());
-		if (!(*laneIt)->isPedestrianLane())
-		{
-			numVehicleLanes++;
-			outermostLane = *laneIt;
-		}
-		lnStats->setParentStats(this);
-		laneIt++;
-	}
-
 	/*
 	 * Any lane with an id ending with 9 is laneInfinity of the road segment.
 	 * This lane is available only to the SegmentStats and not the parent RoadSegment.
@@ -121,17 +181,37 @@ SegmentStats::SegmentStats(const RoadSegment* rdSeg, Conflux* parentConflux, dou
 	laneInfinity->setRoadSegmentId(rdSeg->getRoadSegmentId());
 	laneInfinity->setParentSegment(const_cast<RoadSegment*>(rdSeg));
 	laneInfinity->setWidth(0);
-	LaneStats* lnInfStats = new LaneStats(laneInfinity, statslengthInM, true);
-	laneStatsMap.insert(std::make_pair(laneInfinity, lnInfStats));
-	lnInfStats->setParentStats(this);
+
+	// lanes are indexed densely in the order of laneStatsMap, so that the loops over the lane table visit the lanes
+	// in the same order as the loops over the map
+	std::vector<const Lane*> lanes(rdSeg->getLanes().begin(), rdSeg->getLanes().end());
+	lanes.push_back(laneInfinity);
+	std::sort(lanes.begin(), lanes.end(), std::less<const Lane*>());
+	laneStatsList.reserve(lanes.size());
+	for (unsigned int index = 0; index < lanes.size(); index++)
+	{
+		laneStatsList.push_back(LaneStats(lanes[index], &laneTable, index, (lanes[index] == laneInfinity)));
+		LaneStats* lnStats = &laneStatsList.back();
+		laneStatsMap.insert(std::make_pair(lanes[index], lnStats));
+		lnStats->setParentStats(this);
+	}
+
+	// initialize the lane params of the lanes of the segment
+	std::vector<const Lane*>::const_iterator laneIt = rdSeg->getLanes().begin();
+	while (laneIt != rdSeg->getLanes().end())
+	{
+		laneStatsMap.at(*laneIt)->initLaneParams(segVehicleSpeed, supplyParams.getCapacity());
+		if (!(*laneIt)->isPedestrianLane())
+		{
+			numVehicleLanes++;
+			outermostLane = *laneIt;
+		}
+		laneIt++;
+	}
 }
 
 SegmentStats::~SegmentStats()
 {
-	for (LaneStatsMap::iterator i = laneStatsMap.begin(); i != laneStatsMap.end(); i++)
-	{
-		safe_delete_item(i->second);
-	}
 	for (BusStopAgentList::iterator i = busStopAgents.begin(); i != busStopAgents.end(); i++)
 	{
 		(*i)->currWorkerProvider = nullptr;
@@ -158,18 +238,18 @@ void SegmentStats::updateBusStopAgents(timeslice now)
 void SegmentStats::addAgent(const Lane* lane, Person_MT* p)
 {
 	boost::unique_lock<boost::recursive_mutex> lock(mutexPersonManagement);
-	laneStatsMap.find(lane)->second->addPerson(p);
+	findLaneStats(lane)->addPerson(p);
 	numPersons++; //record addition to segment
 }
 
 bool SegmentStats::removeAgent(const Lane* lane, Person_MT* p, bool wasQueuing, double vehicleLength)
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::removeAgent lane not found in segment stats");
 	}
-	bool removed = laneIt->second->removePerson(p, wasQueuing, vehicleLength);
+	bool removed = laneStats->removePerson(p, wasQueuing, vehicleLength);
 	if (removed)
 	{
 		numPersons--;
@@ -179,24 +259,24 @@ bool SegmentStats::removeAgent(const Lane* lane, Person_MT* p, bool wasQueuing,
 
 void SegmentStats::updateQueueStatus(const Lane* lane, Person_MT* p)
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		std::stringstream out("");
 		out << "SegmentStats::updateQueueStatus lane not found in segment stats. Segment[" << roadSegment->getRoadSegmentId() << "] index" << statsNumberInSegment;
 		throw std::runtime_error(out.str());
 	}
-	laneIt->second->updateQueueStatus(p);
+	laneStats->updateQueueStatus(p);
 }
 
 std::deque<Person_MT*>& SegmentStats::getPersons(const Lane* lane)
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getPersons lane not found in segment stats");
 	}
-	return laneIt->second->laneAgents;
+	return laneStats->laneAgents;
 }
 
 std::vector<const BusStop*>& SegmentStats::getBusStops()
@@ -235,6 +315,14 @@ void SegmentStats::initializeBusStops()
 	}
 }
 
+void SegmentStats::reRegisterHandlers(void* context)
+{
+	for (BusStopAgentList::iterator stopAgIt = busStopAgents.begin(); stopAgIt != busStopAgents.end(); stopAgIt++)
+	{
+		(*stopAgIt)->reRegisterHandlers(context);
+	}
+}
+
 void SegmentStats::addBusDriverToStop(Person_MT* driver, const BusStop* stop)
 {
 	if (stop && hasBusStop(stop))
@@ -266,9 +354,9 @@ void SegmentStats::removeBusDriverFromStop(Person_MT* driver, const BusStop* sto
 
 void SegmentStats::getPersons(std::deque<Person_MT*>& segAgents)
 {
-	for (LaneStatsMap::iterator lnStMpIt = laneStatsMap.begin(); lnStMpIt != laneStatsMap.end(); lnStMpIt++)
+	for (std::vector<LaneStats>::iterator lnIt = laneStatsList.begin(); lnIt != laneStatsList.end(); lnIt++)
 	{
-		PersonList& lnAgents = lnStMpIt->second->laneAgents;
+		PersonList& lnAgents = lnIt->laneAgents;
 		segAgents.insert(segAgents.end(), lnAgents.begin(), lnAgents.end());
 	}
 
@@ -282,135 +370,71 @@ void SegmentStats::getPersons(std::deque<Person_MT*>& segAgents)
 
 void SegmentStats::getInfinityPersons(std::deque<Person_MT*>& segAgents)
 {
-	PersonList& lnAgents = laneStatsMap.find(laneInfinity)->second->laneAgents;
+	PersonList& lnAgents = findLaneStats(laneInfinity)->laneAgents;
 	segAgents.insert(segAgents.end(), lnAgents.begin(), lnAgents.end());
 }
 
-void SegmentStats::topCMergeLanesInSegment(PersonList& mergedPersonList)
+void SegmentStats::topCMergeLanesInSegment(std::vector<Person_MT*>& mergedPersons)
 {
-	mergedPersonList.clear();
 	//Bus drivers go in the front of the list, because bus stops are (virtually) located at the end of the segment
 	for (BusStopList::const_reverse_iterator stopIt = busStops.rbegin(); stopIt != busStops.rend(); stopIt++)
 	{
 		const BusStop* stop = *stopIt;
 		PersonList& driversAtStop = busDrivers.at(stop);
-		for (PersonList::iterator pIt = driversAtStop.begin(); pIt != driversAtStop.end(); pIt++)
-		{
-			mergedPersonList.push_back(*pIt);
-		}
+		mergedPersons.insert(mergedPersons.end(), driversAtStop.begin(), driversAtStop.end());
 	}
 
-	int capacity = (int) (ceil(supplyParams.getCapacity()));
-	//init iterator list to the front of each lane
-	std::vector<PersonList::iterator> iteratorLists;
-	for (LaneStatsMap::iterator lnIt = laneStatsMap.begin(); lnIt != laneStatsMap.end(); lnIt++)
+	laneMerge.clear();
+	LaneStats* lnInfStats = nullptr;
+	for (unsigned int index = 0; index < laneStatsList.size(); index++)
 	{
-		if(!lnIt->second->isLaneInfinity())
+		PersonList& lnAgents = laneStatsList[index].laneAgents;
+		if (laneTable.isLaneInfinity(index))
 		{
-			iteratorLists.push_back(lnIt->second->laneAgents.begin());
+			lnInfStats = &laneStatsList[index];
+		}
+		else
+		{
+			laneMerge.addSequence(lnAgents.begin(), lnAgents.end());
 		}
 	}
 
 	//pick the Top C
-	for (int c = 0; c < capacity; c++)
+	int capacity = (int) (ceil(supplyParams.getCapacity()));
+	if (capacity > 0)
 	{
-		double minVal = std::numeric_limits<double>::max();
-		Person_MT* currPerson = nullptr;
-		std::vector<std::pair<int, Person_MT*> > equiDistantList;
-		int i = 0;
-		for (LaneStatsMap::iterator lnIt = laneStatsMap.begin(); lnIt != laneStatsMap.end(); lnIt++)
+		if (orderBySetting == SEGMENT_ORDERING_BY_DISTANCE_TO_INTERSECTION)
 		{
-			if(!lnIt->second->isLaneInfinity())
-			{
-				PersonList& personsInLane = lnIt->second->laneAgents;
-				if (iteratorLists[i] != personsInLane.end())
-				{
-					currPerson = (*(iteratorLists[i]));
-					if (orderBySetting == SEGMENT_ORDERING_BY_DISTANCE_TO_INTERSECTION)
-					{
-						if (currPerson->distanceToEndOfSegment == minVal)
-						{
-							equiDistantList.push_back(std::make_pair(i, currPerson));
-						}
-						else if (currPerson->distanceToEndOfSegment < minVal)
-						{
-							minVal = currPerson->distanceToEndOfSegment;
-							equiDistantList.clear();
-							equiDistantList.push_back(std::make_pair(i, currPerson));
-						}
-					}
-					else if (orderBySetting == SEGMENT_ORDERING_BY_DRIVING_TIME_TO_INTERSECTION)
-					{
-						if (currPerson->drivingTimeToEndOfLink == minVal)
-						{
-							equiDistantList.push_back(std::make_pair(i, currPerson));
-						}
-						else if (currPerson->drivingTimeToEndOfLink < minVal)
-						{
-							minVal = currPerson->drivingTimeToEndOfLink;
-							equiDistantList.clear();
-							equiDistantList.push_back(std::make_pair(i, currPerson));
-						}
-					}
-				}
-				i++;
-			}
+			laneMerge.mergeTopC(capacity, DistToSegmentEnd(), parentConflux->getRandomStream(), mergedPersons);
 		}
-
-		if (!equiDistantList.empty())
+		else if (orderBySetting == SEGMENT_ORDERING_BY_DRIVING_TIME_TO_INTERSECTION)
 		{
-			//we have to randomly choose from persons in equiDistantList
-			size_t numElements = equiDistantList.size();
-			std::pair<int, Person_MT*> chosenPair;
-			if (numElements == 1)
-			{
-				chosenPair = equiDistantList.front();
-			}
-			else
-			{
-				int chosenIdx = rand() % numElements;
-				chosenPair = equiDistantList[chosenIdx];
-			}
-			iteratorLists.at(chosenPair.first)++;
-			mergedPersonList.push_back(chosenPair.second);
+			laneMerge.mergeTopC(capacity, DrivingTimeToLinkEnd(), parentConflux->getRandomStream(), mergedPersons);
 		}
 	}
 
 	//After picking the Top C, just append the remaining vehicles in the output list
-	int i = 0;
-	for (LaneStatsMap::iterator lnIt = laneStatsMap.begin(); lnIt != laneStatsMap.end(); lnIt++)
-	{
-		if(!lnIt->second->isLaneInfinity())
-		{
-			PersonList& personsInLane = lnIt->second->laneAgents;
-			if (iteratorLists[i] != personsInLane.end())
-			{
-				mergedPersonList.insert(mergedPersonList.end(), iteratorLists[i], personsInLane.end());
-			}
-			i++;
-		}
-	}
+	laneMerge.appendRest(mergedPersons);
 
-	//insert lane infinity persons at the tail of mergedPersonList
-	LaneStats* lnInfStats =  laneStatsMap[laneInfinity];
-	mergedPersonList.insert(mergedPersonList.end(), lnInfStats->laneAgents.begin(), lnInfStats->laneAgents.end());
+	//insert lane infinity persons at the tail of mergedPersons
+	mergedPersons.insert(mergedPersons.end(), lnInfStats->laneAgents.begin(), lnInfStats->laneAgents.end());
 }
 
 std::pair<unsigned int, unsigned int> SegmentStats::getLaneAgentCounts(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getLaneAgentCounts lane not found in segment stats");
 	}
-	return std::make_pair(laneIt->second->getQueuingAgentsCount(), laneIt->second->getMovingAgentsCount());
+	return std::make_pair(laneStats->getQueuingAgentsCount(), laneStats->getMovingAgentsCount());
 }
 
 double SegmentStats::getLaneQueueLength(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
+	LaneStats* laneStats = findLaneStats(lane);
 
-	if (laneIt == laneStatsMap.end())
+	if (!laneStats)
 	{
 		std::stringstream msg;
 		msg << "SegmentStats::getLaneQueueLength() - Lane " << lane->getLaneId()
@@ -418,59 +442,54 @@ double SegmentStats::getLaneQueueLength(const Lane* lane) const
 		throw std::runtime_error(msg.str());
 	}
 
-	return laneIt->second->getQueueLength();
+	return laneStats->getQueueLength();
 }
 
 double SegmentStats::getLaneMovingLength(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getLaneMovingLength lane not found in segment stats");
 	}
-	return laneIt->second->getMovingLength();
+	return laneStats->getMovingLength();
 }
 
 double SegmentStats::getLaneTotalVehicleLength(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getLaneTotalVehicleLength lane not found in segment stats");
 	}
-	return laneIt->second->getTotalVehicleLength();
+	return laneStats->getTotalVehicleLength();
 }
 
 unsigned int SegmentStats::numAgentsInLane(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::numAgentsInLane lane not found in segment stats");
 	}
-	return laneIt->second->getNumPersons();
+	return laneStats->getNumPersons();
 }
 
 unsigned int SegmentStats::numMovingInSegment(bool hasVehicle) const
 {
 	unsigned int movingCounts = 0;
-	const std::vector<const Lane*>& segLanes = roadSegment->getLanes();
-	std::vector<const Lane*>::const_iterator laneIt = segLanes.begin();
-	while (laneIt != segLanes.end())
+	const unsigned int* numLanePersons = laneTable.column(LaneTable::NUM_PERSONS);
+	const unsigned int* queueCounts = laneTable.column(LaneTable::QUEUE_COUNT);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		if ((hasVehicle && !(*laneIt)->isPedestrianLane()) || (!hasVehicle && (*laneIt)->isPedestrianLane()))
+		if (!laneTable.isLaneInfinity(index) && hasVehicle != laneTable.isPedestrianLane(index))
 		{
-			LaneStatsMap::const_iterator laneStatsIt = laneStatsMap.find(*laneIt);
-			if (laneStatsIt != laneStatsMap.end())
-			{
-				movingCounts = movingCounts + laneStatsIt->second->getMovingAgentsCount();
-			}
-			else
+			if (numLanePersons[index] < queueCounts[index])
 			{
-				throw std::runtime_error("SegmentStats::numMovingInSegment called with invalid laneStats.");
+				laneStatsList[index].getMovingAgentsCount(); //throws with the persons of the lane
 			}
+			movingCounts = movingCounts + (numLanePersons[index] - queueCounts[index]);
 		}
-		laneIt++;
 	}
 	return movingCounts;
 }
@@ -478,11 +497,17 @@ unsigned int SegmentStats::numMovingInSegment(bool hasVehicle) const
 double SegmentStats::getMovingLength() const
 {
 	double movingLength = 0;
-	for (LaneStatsMap::const_iterator laneStatsIt = laneStatsMap.begin(); laneStatsIt != laneStatsMap.end(); laneStatsIt++)
+	const double* totalLengths = laneTable.column(LaneTable::TOTAL_LENGTH);
+	const double* queueLengths = laneTable.column(LaneTable::QUEUE_LENGTH);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		if (!laneStatsIt->second->isLaneInfinity() && !laneStatsIt->first->isPedestrianLane())
+		if (laneTable.isVehicleLane(index))
 		{
-			movingLength = movingLength + laneStatsIt->second->getMovingLength();
+			if (totalLengths[index] < queueLengths[index])
+			{
+				laneStatsList[index].getMovingLength(); //throws with the persons of the lane
+			}
+			movingLength = movingLength + (totalLengths[index] - queueLengths[index]);
 		}
 	}
 	return movingLength;
@@ -491,11 +516,12 @@ double SegmentStats::getMovingLength() const
 double SegmentStats::getQueueLength() const
 {
 	double queueLength = 0;
-	for (LaneStatsMap::const_iterator laneStatsIt = laneStatsMap.begin(); laneStatsIt != laneStatsMap.end(); laneStatsIt++)
+	const double* queueLengths = laneTable.column(LaneTable::QUEUE_LENGTH);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		if (!laneStatsIt->second->isLaneInfinity() && !laneStatsIt->first->isPedestrianLane())
+		if (laneTable.isVehicleLane(index))
 		{
-			queueLength = queueLength + laneStatsIt->second->getQueueLength();
+			queueLength = queueLength + queueLengths[index];
 		}
 	}
 	return queueLength;
@@ -503,11 +529,10 @@ double SegmentStats::getQueueLength() const
 
 bool SegmentStats::hasQueue() const
 {
-	for (LaneStatsMap::const_iterator laneStatsIt = laneStatsMap.begin(); laneStatsIt != laneStatsMap.end(); laneStatsIt++)
+	const double* queueLengths = laneTable.column(LaneTable::QUEUE_LENGTH);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		if (!laneStatsIt->second->isLaneInfinity()
-				&& !laneStatsIt->first->isPedestrianLane()
-				&& laneStatsIt->second->getQueueLength() > 0.0)
+		if (laneTable.isVehicleLane(index) && queueLengths[index] > 0.0)
 		{
 			return true;
 		}
@@ -518,11 +543,12 @@ bool SegmentStats::hasQueue() const
 double SegmentStats::getTotalVehicleLength() const
 {
 	double totalLength = 0;
-	for (LaneStatsMap::const_iterator laneStatsIt = laneStatsMap.begin(); laneStatsIt != laneStatsMap.end(); laneStatsIt++)
+	const double* totalLengths = laneTable.column(LaneTable::TOTAL_LENGTH);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		if (!laneStatsIt->second->isLaneInfinity() && !laneStatsIt->first->isPedestrianLane())
+		if (laneTable.isVehicleLane(index))
 		{
-			totalLength = totalLength + laneStatsIt->second->getTotalVehicleLength();
+			totalLength = totalLength + totalLengths[index];
 		}
 	}
 	return totalLength;
@@ -547,23 +573,10 @@ double SegmentStats::getDensity(bool hasVehicle)
 	return density;
 }
 
-//density will be computed in vehicles/meter-lane for the moving part of the lane
 double LaneStats::getDensity()
 {
-	double density = 0.0;
-	double queueLength = getQueueLength();
-	double movingPartLength = length - queueLength;
-	double movingPCUs = getMovingLength() / PASSENGER_CAR_UNIT;
-
-	if (movingPartLength > PASSENGER_CAR_UNIT)
-	{
-		density = movingPCUs / movingPartLength;
-	}
-	else
-	{
-		density = 1 / PASSENGER_CAR_UNIT;
-	}
-	return density;
+	getMovingLength(); //checks the lengths of the lane
+	return table().getDensity(index());
 }
 
 //density will be computed in vehicles/lane-km for the full segment
@@ -579,23 +592,13 @@ double SegmentStats::getTotalDensity(bool hasVehicle)
 unsigned int SegmentStats::numQueuingInSegment(bool hasVehicle) const
 {
 	unsigned int queuingCounts = 0;
-	const std::vector<const Lane*>& segLanes = roadSegment->getLanes();
-	std::vector<const Lane*>::const_iterator lane = segLanes.begin();
-	while (lane != segLanes.end())
+	const unsigned int* queueCounts = laneTable.column(LaneTable::QUEUE_COUNT);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		if ((hasVehicle && !(*lane)->isPedestrianLane()) || (!hasVehicle && (*lane)->isPedestrianLane()))
+		if (!laneTable.isLaneInfinity(index) && hasVehicle != laneTable.isPedestrianLane(index))
 		{
-			LaneStatsMap::const_iterator laneStatsIt = laneStatsMap.find(*lane);
-			if (laneStatsIt != laneStatsMap.end())
-			{
-				queuingCounts = queuingCounts + laneStatsIt->second->getQueuingAgentsCount();
-			}
-			else
-			{
-				throw std::runtime_error("SegmentStats::numQueueingInSegment was called with invalid laneStats!");
-			}
+			queuingCounts = queuingCounts + queueCounts[index];
 		}
-		lane++;
 	}
 	return queuingCounts;
 }
@@ -672,11 +675,13 @@ double SegmentStats::getEnergy() const
 
 unsigned int LaneStats::getQueuingAgentsCount() const
 {
-	return queueCount;
+	return table().get(LaneTable::QUEUE_COUNT, index());
 }
 
 unsigned int LaneStats::getMovingAgentsCount() const
 {
+	const unsigned int numPersons = getNumPersons();
+	const unsigned int queueCount = getQueuingAgentsCount();
 	if (numPersons < queueCount)
 	{
 		printAgents();
@@ -690,6 +695,8 @@ unsigned int LaneStats::getMovingAgentsCount() const
 
 double LaneStats::getMovingLength() const
 {
+	const double totalLength = getTotalVehicleLength();
+	const double queueLength = getQueueLength();
 	if (totalLength < queueLength)
 	{
 		printAgents();
@@ -703,8 +710,12 @@ double LaneStats::getMovingLength() const
 
 void LaneStats::addPerson(Person_MT* p)
 {
+	unsigned int& numPersons = table().get(LaneTable::NUM_PERSONS, index());
+	unsigned int& queueCount = table().get(LaneTable::QUEUE_COUNT, index());
+	double& totalLength = table().get(LaneTable::TOTAL_LENGTH, index());
+	double& queueLength = table().get(LaneTable::QUEUE_LENGTH, index());
 	VehicleBase* vehicle = nullptr;
-	if (laneInfinity)
+	if (isLaneInfinity())
 	{
 		laneAgents.push_back(p);
 		numPersons++;
@@ -752,8 +763,12 @@ void LaneStats::addPerson(Person_MT* p)
 
 void LaneStats::updateQueueStatus(Person_MT* p)
 {
+	const Lane* lane = getLane();
+	const unsigned int numPersons = getNumPersons();
+	unsigned int& queueCount = table().get(LaneTable::QUEUE_COUNT, index());
+	double& queueLength = table().get(LaneTable::QUEUE_LENGTH, index());
 	VehicleBase* vehicle = p->getRole()->getResource();
-	if (!laneInfinity && vehicle)
+	if (!isLaneInfinity() && vehicle)
 	{
 		if (p->isQueuing)
 		{
@@ -786,8 +801,13 @@ bool LaneStats::removePerson(Person_MT* p, bool wasQueuing, double vehicleLength
 	if (pIt != laneAgents.end())
 	{
 		laneAgents.erase(pIt);
-		if (!laneInfinity)
+		if (!isLaneInfinity())
 		{
+			const Lane* lane = getLane();
+			unsigned int& numPersons = table().get(LaneTable::NUM_PERSONS, index());
+			unsigned int& queueCount = table().get(LaneTable::QUEUE_COUNT, index());
+			double& totalLength = table().get(LaneTable::TOTAL_LENGTH, index());
+			double& queueLength = table().get(LaneTable::QUEUE_LENGTH, index());
 			numPersons--; //record removal
 			totalLength = totalLength - vehicleLength;
 			if (wasQueuing)
@@ -815,19 +835,19 @@ bool LaneStats::removePerson(Person_MT* p, bool wasQueuing, double vehicleLength
 
 void LaneStats::initLaneParams(double vehSpeed, const double capacity)
 {
-	size_t numLanes = lane->getParentSegment()->getLanes().size();
+	size_t numLanes = getLane()->getParentSegment()->getLanes().size();
 	if (numLanes > 0)
 	{
 		double orig = capacity / numLanes;
-		laneParams->setOrigOutputFlowRate(orig);
+		laneParams.setOrigOutputFlowRate(orig);
 	}
-	laneParams->outputFlowRate = laneParams->origOutputFlowRate;
+	laneParams.setOutputFlowRate(laneParams.getOrigOutputFlowRate());
 
 	// As per Yang Lu's suggestion for short segment correction
-	if (length < SHORT_SEGMENT_LENGTH_LIMIT)
+	if (getLength() < SHORT_SEGMENT_LENGTH_LIMIT)
 	{
-		laneParams->origOutputFlowRate = LARGE_OUTPUT_FLOW_RATE;
-		laneParams->outputFlowRate = LARGE_OUTPUT_FLOW_RATE;
+		laneParams.setOrigOutputFlowRate(LARGE_OUTPUT_FLOW_RATE);
+		laneParams.setOutputFlowRate(LARGE_OUTPUT_FLOW_RATE);
 	}
 
 	updateOutputCounter();
@@ -836,41 +856,29 @@ void LaneStats::initLaneParams(double vehSpeed, const double capacity)
 
 void LaneStats::updateOutputFlowRate(double newFlowRate)
 {
-	laneParams->outputFlowRate = newFlowRate;
+	laneParams.setOutputFlowRate(newFlowRate);
 }
 
 void LaneStats::updateOutputCounter()
 {
 	double updateInterval = MT_Config::getInstance().getSupplyUpdateInterval() *
 			ConfigManager::GetInstance().FullConfig().baseGranSecond();
-	int tmp = int(laneParams->outputFlowRate * updateInterval);
-	laneParams->fraction += laneParams->outputFlowRate * updateInterval - tmp;
-	if (laneParams->fraction >= 1.0)
-	{
-		laneParams->fraction -= 1.0;
-		laneParams->outputCounter = tmp + 1;
-	}
-	else
-	{
-		laneParams->outputCounter = tmp;
-	}
+	table().updateOutputCounter(index(), updateInterval);
 }
 
 void LaneStats::updateAcceptRate(double speed, unsigned int numLanes)
 {
-	double acceptRateA = (laneParams->outputFlowRate > 0) ? (1.0 / laneParams->outputFlowRate) : 0.0;
-	double acceptRateB = PASSENGER_CAR_UNIT / (numLanes * speed);
-	laneParams->acceptRate = std::max(acceptRateA, acceptRateB);
+	table().updateAcceptRate(index(), speed, numLanes);
 }
 
 LaneParams* SegmentStats::getLaneParams(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getLaneParams lane not found in segment stats");
 	}
-	return laneIt->second->laneParams;
+	return &laneStats->laneParams;
 }
 
 double SegmentStats::speedDensityFunction(const double segDensity) const
@@ -909,13 +917,12 @@ double SegmentStats::speedDensityFunction(const double segDensity) const
 
 void SegmentStats::restoreLaneParams(const Lane* lane)
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::restoreLaneParams lane not found in segment stats");
 	}
-	LaneStats* laneStats = laneIt->second;
-	laneStats->updateOutputFlowRate(getLaneParams(lane)->origOutputFlowRate);
+	laneStats->updateOutputFlowRate(laneStats->laneParams.getOrigOutputFlowRate());
 	laneStats->updateOutputCounter();
 	segDensity = getDensity(true);
 	double upSpeed = speedDensityFunction(segDensity);
@@ -924,12 +931,11 @@ void SegmentStats::restoreLaneParams(const Lane* lane)
 
 void SegmentStats::updateLaneParams(const Lane* lane, double newOutputFlowRate)
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::updateLaneParams lane not found in segment stats");
 	}
-	LaneStats* laneStats = laneIt->second;
 	laneStats->updateOutputFlowRate(newOutputFlowRate);
 	laneStats->updateOutputCounter();
 	segDensity = getDensity(true);
@@ -942,17 +948,25 @@ void SegmentStats::updateLaneParams(timeslice frameNumber)
 	segDensity = getDensity(true);
 	segVehicleSpeed = speedDensityFunction(segDensity);
 	//need to update segPedSpeed in future
-	LaneStatsMap::iterator it = laneStatsMap.begin();
-	for (; it != laneStatsMap.end(); ++it)
+	const double updateInterval = MT_Config::getInstance().getSupplyUpdateInterval() *
+			ConfigManager::GetInstance().FullConfig().baseGranSecond();
+	const double* totalLengths = laneTable.column(LaneTable::TOTAL_LENGTH);
+	const double* queueLengths = laneTable.column(LaneTable::QUEUE_LENGTH);
+	double* initialQueueLengths = laneTable.column(LaneTable::INITIAL_QUEUE_LENGTH);
+	double* laneVehSpeeds = laneTable.column(LaneTable::VEHICLE_SPEED);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
 		//filtering out the pedestrian lanes for now
-		if (!(it->first)->isPedestrianLane())
+		if (!laneTable.isPedestrianLane(index))
 		{
-			LaneStats *laneStats = it->second;
-			laneStats->setLaneVehSpeed(speedDensityFunction(laneStats->getDensity()));
-			laneStats->updateOutputCounter();
-			laneStats->updateAcceptRate(segVehicleSpeed, numVehicleLanes);
-			laneStats->setInitialQueueLength(laneStats->getQueueLength());
+			if (totalLengths[index] < queueLengths[index])
+			{
+				laneStatsList[index].getMovingLength(); //throws with the persons of the lane
+			}
+			laneVehSpeeds[index] = speedDensityFunction(laneTable.getDensity(index));
+			laneTable.updateOutputCounter(index, updateInterval);
+			laneTable.updateAcceptRate(index, segVehicleSpeed, numVehicleLanes);
+			initialQueueLengths[index] = queueLengths[index];
 		}
 	}
 }
@@ -1069,45 +1083,47 @@ bool SegmentStats::hasBusStop() const
 
 double SegmentStats::getPositionOfLastUpdatedAgentInLane(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getPositionOfLastUpdatedAgentInLane lane not found in segment stats");
 	}
-	return laneIt->second->getPositionOfLastUpdatedAgent();
+	return laneStats->getPositionOfLastUpdatedAgent();
 }
 
 void SegmentStats::setPositionOfLastUpdatedAgentInLane(double positionOfLastUpdatedAgentInLane, const Lane* lane)
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::setPositionOfLastUpdatedAgentInLane lane not found in segment stats");
 	}
-	laneIt->second->setPositionOfLastUpdatedAgent(positionOfLastUpdatedAgentInLane);
+	laneStats->setPositionOfLastUpdatedAgent(positionOfLastUpdatedAgentInLane);
 }
 
-std::map<const Lane*, LaneStats*> SegmentStats::getLaneStats() const
+const std::map<const Lane*, LaneStats*>& SegmentStats::getLaneStats() const
 {
 	return laneStatsMap;
 }
 
+std::size_t SegmentStats::getLaneStateBytes() const
+{
+	return laneTable.getMemoryBytes() + getHeapBytes(laneStatsList);
+}
+
 double SegmentStats::getInitialQueueLength(const Lane* lane) const
 {
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getInitialQueueLength lane not found in segment stats");
 	}
-	return laneIt->second->getInitialQueueLength();
+	return laneStats->getInitialQueueLength();
 }
 
 void SegmentStats::resetPositionOfLastUpdatedAgentOnLanes()
 {
-	for (LaneStatsMap::iterator i = laneStatsMap.begin(); i != laneStatsMap.end(); i++)
-	{
-		i->second->setPositionOfLastUpdatedAgent(-1.0);
-	}
+	std::fill_n(laneTable.column(LaneTable::LAST_UPDATED_POSITION), laneTable.size(), -1.0);
 }
 
 void SegmentStats::incrementSegFlow()
@@ -1123,9 +1139,11 @@ void SegmentStats::resetSegFlow()
 unsigned int SegmentStats::computeExpectedOutputPerTick()
 {
 	float count = 0;
-	for (LaneStatsMap::iterator i = laneStatsMap.begin(); i != laneStatsMap.end(); i++)
+	const double baseGranSecond = ConfigManager::GetInstance().FullConfig().baseGranSecond();
+	const double* outputFlowRates = laneTable.column(LaneTable::OUTPUT_FLOW_RATE);
+	for (unsigned int index = 0; index < laneTable.size(); index++)
 	{
-		count += i->second->laneParams->getOutputFlowRate() * ConfigManager::GetInstance().FullConfig().baseGranSecond();
+		count += outputFlowRates[index] * baseGranSecond;
 	}
 	return std::ceil(count);
 }
@@ -1141,14 +1159,14 @@ void SegmentStats::updateLinkDrivingTimes(double drivingTimeToEndOfLink)
 
 	for (auto lnIt = roadSegment->getLanes().begin(); lnIt != roadSegment->getLanes().end(); lnIt++)
 	{
-		PersonList& lnAgents = laneStatsMap.find(*lnIt)->second->laneAgents;
+		PersonList& lnAgents = findLaneStats(*lnIt)->laneAgents;
 		for (PersonList::const_iterator pIt = lnAgents.begin(); pIt != lnAgents.end(); pIt++)
 		{
 			Person_MT* person = (*pIt);
 			person->drivingTimeToEndOfLink = (person->distanceToEndOfSegment / speed) + drivingTimeToEndOfLink;
 		}
 	}
-	PersonList& lnAgents = laneStatsMap.find(laneInfinity)->second->laneAgents;
+	PersonList& lnAgents = findLaneStats(laneInfinity)->laneAgents;
 	for (PersonList::const_iterator pIt = lnAgents.begin(); pIt != lnAgents.end(); pIt++)
 	{
 		Person_MT* person = (*pIt);
@@ -1208,12 +1226,12 @@ bool SegmentStats::isConnectedToDownstreamLink(const Link* downstreamLink, const
 	{
 		return false;
 	}
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		throw std::runtime_error("SegmentStats::getInitialQueueLength lane not found in segment stats");
 	}
-	const std::set<const Link*>& downStreamLinks = laneIt->second->getDownstreamLinks();
+	const std::set<const Link*>& downStreamLinks = laneStats->getDownstreamLinks();
 	return (downStreamLinks.find(downstreamLink) != downStreamLinks.end());
 }
 
@@ -1291,7 +1309,7 @@ void SegmentStats::printDownstreamLinks() const
 void LaneStats::printAgents() const
 {
 	std::stringstream debugMsgs;
-	debugMsgs << "Lane: " << lane->getLaneId();
+	debugMsgs << "Lane: " << getLane()->getLaneId();
 	for (PersonList::const_iterator i = laneAgents.begin(); i != laneAgents.end(); i++)
 	{
 		debugMsgs << "|" << (*i)->getDatabaseId() ;
@@ -1333,6 +1351,7 @@ void LaneStats::printAgents() const
 
 void LaneStats::verifyOrdering() const
 {
+	const Lane* lane = getLane();
 	double distance = -1.0;
 	for (PersonList::const_iterator i = laneAgents.begin(); i != laneAgents.end(); i++)
 	{
@@ -1366,12 +1385,12 @@ Person_MT* SegmentStats::dequeue(const Person_MT* person, const Lane* lane, bool
 	{
 		return nullptr;
 	}
-	LaneStatsMap::const_iterator laneIt = laneStatsMap.find(lane);
-	if (laneIt == laneStatsMap.end())
+	LaneStats* laneStats = findLaneStats(lane);
+	if (!laneStats)
 	{
 		return nullptr;
 	}
-    Person_MT* dequeuedPerson = laneIt->second->dequeue(person, isQueuingBfrUpdate, vehicleLength);
+    Person_MT* dequeuedPerson = laneStats->dequeue(person, isQueuingBfrUpdate, vehicleLength);
     if (dequeuedPerson)
     {
        numPersons--; // record removal from segment
@@ -1398,8 +1417,13 @@ Person_MT* LaneStats::dequeue(const Person_MT* person, bool isQueuingBfrUpdate,
 		Print() << debugMsgs.str();
 		return nullptr;
 	}
+	const Lane* lane = getLane();
+	unsigned int& numPersons = table().get(LaneTable::NUM_PERSONS, index());
+	unsigned int& queueCount = table().get(LaneTable::QUEUE_COUNT, index());
+	double& totalLength = table().get(LaneTable::TOTAL_LENGTH, index());
+	double& queueLength = table().get(LaneTable::QUEUE_LENGTH, index());
 	Person_MT* dequeuedPerson = nullptr;
-	if (laneInfinity)
+	if (isLaneInfinity())
 	{
 		PersonList::iterator it;
 		for (it = laneAgents.begin(); it != laneAgents.end(); it++)
@@ -1457,6 +1481,7 @@ void LaneStats::addDownstreamLinks(const std::set<const Link*>& downStreamLinks)
 
 void LaneParams::decrementOutputCounter()
 {
+	int& outputCounter = table->getOutputCounter(index);
 	if (outputCounter > 0)
 	{
 		outputCounter--;
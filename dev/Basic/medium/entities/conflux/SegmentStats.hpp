@@ -13,6 +13,7 @@
 #include "geospatial/network/Link.hpp"
 #include "geospatial/network/PT_Stop.hpp"
 #include "geospatial/network/TaxiStand.hpp"
+#include "util/TopCMerge.hpp"
 
 namespace sim_mob
 {
@@ -36,6 +37,28 @@ struct GreaterDistToSegmentEnd: public std::greater<Person_MT*>
 	bool operator()(const Person_MT* x, const Person_MT* y) const;
 };
 
+/**
+ * key of a person in the top C merges ordering by distance to end of segment
+ */
+struct DistToSegmentEnd
+{
+	double operator()(const Person_MT* person) const
+	{
+		return person->distanceToEndOfSegment;
+	}
+};
+
+/**
+ * key of a person in the top C merges ordering by driving time to end of link
+ */
+struct DrivingTimeToLinkEnd
+{
+	double operator()(const Person_MT* person) const
+	{
+		return person->drivingTimeToEndOfLink;
+	}
+};
+
 /*
  * SupplyParams is the place holder for storing the parameters of the
  * speed density function for this road segment.
@@ -92,70 +115,262 @@ private:
 };
 
 /**
- * Data structure to store lane specific parameters for supply.
+ * Supply state of the lanes of a segment stats, packed with one contiguous array per field.
+ * The lanes are indexed densely, in the order of the lane stats map of the segment stats (lane infinity included),
+ * so that the per tick supply updates of the segment stats run as loops over plain arrays.
+ */
+class LaneTable
+{
+public:
+	/** real valued fields of a lane */
+	enum RealField
+	{
+		QUEUE_LENGTH,           ///<queuing length of the lane in m
+		TOTAL_LENGTH,           ///<total length of vehicles in the lane in m
+		INITIAL_QUEUE_LENGTH,   ///<queuing length at the start of the current tick in m
+		LAST_UPDATED_POSITION,  ///<end position of the last updated person in the lane
+		VEHICLE_SPEED,          ///<speed of vehicles in the lane for each frame in m/s
+		OUTPUT_FLOW_RATE,       ///<output flow rate in vehicles/s
+		ORIG_OUTPUT_FLOW_RATE,  ///<original output flow rate in vehicles/s
+		ACCEPT_RATE,            ///<accept rate of the lane
+		FRACTION,               ///<fractional output carried over between updates of the output counter
+		LAST_ACCEPT_TIME,       ///<time at which the lane last accepted a vehicle
+		NUM_REAL_FIELDS
+	};
+
+	/** counters of a lane */
+	enum CountField
+	{
+		QUEUE_COUNT,            ///<number of persons queuing in the lane
+		NUM_PERSONS,            ///<number of persons in the lane
+		NUM_COUNT_FIELDS
+	};
+
+	/**
+	 * @param numLanes number of lanes in the table, including lane infinity
+	 * @param length length of the lanes in m (corresponds to length of the segment stats)
+	 */
+	LaneTable(unsigned int numLanes, double length);
+
+	/**
+	 * sets the lane at a dense index
+	 * @param index dense index of the lane
+	 * @param lane geospatial lane
+	 * @param isLaneInfinity whether lane is the lane infinity of the segment stats
+	 */
+	void setLane(unsigned int index, const Lane* lane, bool isLaneInfinity);
+
+	/**
+	 * finds the dense index of a lane
+	 * @param lane the lane to find
+	 * @return index of lane; size() if lane is not in this table
+	 */
+	unsigned int find(const Lane* lane) const
+	{
+		unsigned int index = 0;
+		while (index < numLanes && lanes[index] != lane)
+		{
+			index++;
+		}
+		return index;
+	}
+
+	unsigned int size() const
+	{
+		return numLanes;
+	}
+
+	double getLength() const
+	{
+		return length;
+	}
+
+	const Lane* getLane(unsigned int index) const
+	{
+		return lanes[index];
+	}
+
+	bool isLaneInfinity(unsigned int index) const
+	{
+		return (flags[index] & FLAG_LANE_INFINITY);
+	}
+
+	bool isPedestrianLane(unsigned int index) const
+	{
+		return (flags[index] & FLAG_PEDESTRIAN_LANE);
+	}
+
+	/** @return true if the lane is a proper lane meant for vehicles */
+	bool isVehicleLane(unsigned int index) const
+	{
+		return (flags[index] == 0);
+	}
+
+	double* column(RealField field)
+	{
+		return &reals[field * numLanes];
+	}
+
+	const double* column(RealField field) const
+	{
+		return &reals[field * numLanes];
+	}
+
+	const unsigned int* column(CountField field) const
+	{
+		return &counts[field * numLanes];
+	}
+
+	double& get(RealField field, unsigned int index)
+	{
+		return reals[field * numLanes + index];
+	}
+
+	double get(RealField field, unsigned int index) const
+	{
+		return reals[field * numLanes + index];
+	}
+
+	unsigned int& get(CountField field, unsigned int index)
+	{
+		return counts[field * numLanes + index];
+	}
+
+	unsigned int get(CountField field, unsigned int index) const
+	{
+		return counts[field * numLanes + index];
+	}
+
+	int& getOutputCounter(unsigned int index)
+	{
+		return outputCounters[index];
+	}
+
+	/**
+	 * computes the density of the moving part of a lane
+	 * @param index dense index of the lane
+	 * @return density in PCU/lane-m
+	 */
+	double getDensity(unsigned int index) const;
+
+	/**
+	 * updates the output counter of a lane
+	 * @param index dense index of the lane
+	 * @param updateInterval supply update interval in s
+	 */
+	void updateOutputCounter(unsigned int index, double updateInterval);
+
+	/**
+	 * updates the accept rate of a lane
+	 * @param index dense index of the lane
+	 * @param speed lane speed in m/s
+	 * @param numSegmentLanes number of lanes in the parent segment stats
+	 */
+	void updateAcceptRate(unsigned int index, double speed, unsigned int numSegmentLanes);
+
+	/**
+	 * @return number of bytes held by this table: its header and its columns
+	 */
+	std::size_t getMemoryBytes() const;
+
+private:
+	/** bits of the lane flags */
+	enum LaneFlag
+	{
+		FLAG_PEDESTRIAN_LANE = 1, FLAG_LANE_INFINITY = 2
+	};
+
+	/** number of lanes in the table */
+	unsigned int numLanes;
+
+	/** length of the lanes in m */
+	double length;
+
+	/** real valued fields, one column of numLanes values per RealField */
+	std::vector<double> reals;
+
+	/** counters, one column of numLanes values per CountField */
+	std::vector<unsigned int> counts;
+
+	/** output counter of each lane */
+	std::vector<int> outputCounters;
+
+	/** geospatial lane of each lane */
+	std::vector<const Lane*> lanes;
+
+	/** LaneFlag bits of each lane */
+	std::vector<unsigned char> flags;
+};
+
+/**
+ * Lane specific parameters for supply.
+ * The parameters are stored in the lane table of the segment stats; this class gives access to those of one lane.
  *
  * \author Melani Jayasuriya
  */
 class LaneParams
 {
 	friend class LaneStats;
-	friend class SegmentStats;
 
 private:
-	double outputFlowRate; //vehicles/s
-	double origOutputFlowRate; //vehicles/s
-	int outputCounter;
-	double acceptRate;
-	double fraction;
-	double lastAcceptTime;
+	/** table storing the parameters */
+	LaneTable* table;
+
+	/** dense index of the lane in table */
+	unsigned int index;
 
 public:
-	LaneParams() :
-			outputFlowRate(0.0), origOutputFlowRate(0.0), outputCounter(0), acceptRate(0.0), fraction(0.0), lastAcceptTime(0.0)
+	LaneParams(LaneTable* table, unsigned int index) :
+			table(table), index(index)
 	{
 	}
 
 	double getOutputFlowRate()
 	{
-		return outputFlowRate;
+		return table->get(LaneTable::OUTPUT_FLOW_RATE, index);
 	}
 	int getOutputCounter()
 	{
-		return outputCounter;
+		return table->getOutputCounter(index);
 	}
 	double getAcceptRate()
 	{
-		return acceptRate;
+		return table->get(LaneTable::ACCEPT_RATE, index);
 	}
 
 	void setOutputCounter(int count)
 	{
-		outputCounter = count;
+		table->getOutputCounter(index) = count;
 	}
 	void decrementOutputCounter();
 	void setOutputFlowRate(double output)
 	{
-		outputFlowRate = output;
+		table->get(LaneTable::OUTPUT_FLOW_RATE, index) = output;
 	}
 	void setOrigOutputFlowRate(double orig)
 	{
-		origOutputFlowRate = orig;
+		table->get(LaneTable::ORIG_OUTPUT_FLOW_RATE, index) = orig;
+	}
+	double getOrigOutputFlowRate()
+	{
+		return table->get(LaneTable::ORIG_OUTPUT_FLOW_RATE, index);
 	}
 
 	void setLastAccept(double lastAccept)
 	{
-		lastAcceptTime = lastAccept;
+		table->get(LaneTable::LAST_ACCEPT_TIME, index) = lastAccept;
 	}
 	double getLastAccept()
 	{
-		return lastAcceptTime;
+		return table->get(LaneTable::LAST_ACCEPT_TIME, index);
 	}
 };
 
 /**
  * Data structure to store persons in a lane. Persons are maintained with relative
  * ordering which reflects their positions in the lane during simulation.
- * The queuing and moving counts of the lane is also tracked by this class.
+ * The queuing and moving counts of the lane is also tracked by this class; like the other
+ * scalar state of the lane, they are stored in the lane table of the parent segment stats.
  * Used by mid term supply.
  *
  * \author Harish Loganathan
@@ -166,56 +381,37 @@ private:
 	//typedefs
 	typedef std::deque<Person_MT*> PersonList;
 
-	/** number of persons queueing in lane */
-	unsigned int queueCount;
-
-	/** number of queuing persons at the start of the current tick */
-	double initialQueueLength;
-
-	/** end position of the last updated person in this lane */
-	double positionOfLastUpdatedAgent;
-
-	/** geospatial lane corresponding to this lane stats */
-	const Lane* lane;
-
-	/** virtual lane to hold newly starting persons */
-	const bool laneInfinity;
-
-	/** length of the lane in m (corresponds to length of segment stats of this lane stats) */
-	double length;
-
-	/** counter to track number of persons in this lane */
-	unsigned int numPersons;
-
-	/** tracks the queuing length of this segment in m*/
-	double queueLength;
-
-	/** tracks the moving length of this segment in m*/
-	double totalLength;
-
 	/** set of downstream links connected to this lanestats */
 	std::set<const Link*> connectedDownstreamLinks;
 
-	/** speed of vehicles in the lane for each frame in m/s */
-	double laneVehSpeed;
-
 	/**
 	 * pointer to parent segment stats owning this lane stats
 	 */
 	const SegmentStats* parentStats;
 
-public:
-	PersonList laneAgents;
+	LaneTable& table() const
+	{
+		return *laneParams.table;
+	}
 
-	LaneStats(const Lane* laneInSegment, double length, bool isLaneInfinity = false) :
-			queueCount(0), initialQueueLength(0), laneParams(new LaneParams()), positionOfLastUpdatedAgent(-1.0), lane(laneInSegment), length(length),
-			laneInfinity(isLaneInfinity), numPersons(0), queueLength(0), totalLength(0), parentStats(nullptr)
+	unsigned int index() const
 	{
+		return laneParams.index;
 	}
 
-	~LaneStats()
+public:
+	PersonList laneAgents;
+
+	/**
+	 * @param laneInSegment geospatial lane corresponding to this lane stats
+	 * @param laneTable lane table of the parent segment stats
+	 * @param index dense index of this lane stats in laneTable
+	 * @param isLaneInfinity whether this lane stats is the virtual lane holding newly starting persons
+	 */
+	LaneStats(const Lane* laneInSegment, LaneTable* laneTable, unsigned int index, bool isLaneInfinity = false) :
+			parentStats(nullptr), laneParams(laneTable, index)
 	{
-		safe_delete_item(laneParams);
+		laneTable->setLane(index, laneInSegment, isLaneInfinity);
 	}
 
 	/**
@@ -322,54 +518,54 @@ public:
 
 	double getTotalVehicleLength() const
 	{
-		return totalLength;
+		return table().get(LaneTable::TOTAL_LENGTH, index());
 	}
 
 	double getQueueLength() const
 	{
-		return queueLength;
+		return table().get(LaneTable::QUEUE_LENGTH, index());
 	}
 
 	double getMovingLength() const;
 
 	double getInitialQueueLength() const
 	{
-		return initialQueueLength;
+		return table().get(LaneTable::INITIAL_QUEUE_LENGTH, index());
 	}
 
 	void setInitialQueueLength(double initialQueueLength)
 	{
-		this->initialQueueLength = initialQueueLength;
+		table().get(LaneTable::INITIAL_QUEUE_LENGTH, index()) = initialQueueLength;
 	}
 
 	double getPositionOfLastUpdatedAgent() const
 	{
-		return positionOfLastUpdatedAgent;
+		return table().get(LaneTable::LAST_UPDATED_POSITION, index());
 	}
 
 	void setPositionOfLastUpdatedAgent(double positionOfLastUpdatedAgent)
 	{
-		this->positionOfLastUpdatedAgent = positionOfLastUpdatedAgent;
+		table().get(LaneTable::LAST_UPDATED_POSITION, index()) = positionOfLastUpdatedAgent;
 	}
 
 	const Lane* getLane() const
 	{
-		return lane;
+		return table().getLane(index());
 	}
 
 	const bool isLaneInfinity() const
 	{
-		return laneInfinity;
+		return table().isLaneInfinity(index());
 	}
 
 	double getLength() const
 	{
-		return length;
+		return table().getLength();
 	}
 
 	unsigned int getNumPersons() const
 	{
-		return numPersons;
+		return table().get(LaneTable::NUM_PERSONS, index());
 	}
 
 	const SegmentStats* getParentStats() const
@@ -384,20 +580,20 @@ public:
 
 	void setLaneVehSpeed(double speed)
 	{
-		laneVehSpeed = speed;
+		table().get(LaneTable::VEHICLE_SPEED, index()) = speed;
 	}
 
 	const double getLaneVehSpeed(bool hasVehicle) const
 	{
 		if(hasVehicle)
 		{
-			return laneVehSpeed;
+			return table().get(LaneTable::VEHICLE_SPEED, index());
 		}
 		return 0.0;
 	}
 
 	/** parameters for this lane */
-	LaneParams* laneParams;
+	LaneParams laneParams;
 };
 
 /**
@@ -457,6 +653,12 @@ protected:
 	 */
 	LaneStatsMap laneStatsMap;
 
+	/** supply state of the lanes, indexed by the dense lane index (the order of laneStatsMap) */
+	LaneTable laneTable;
+
+	/** LaneStats of the lanes, indexed by the dense lane index. laneStatsMap and laneGroup point into this list. */
+	std::vector<LaneStats> laneStatsList;
+
 	/**taxiStandAgents for taxi-stand agents in this segment stats*/
 	std::vector<TaxiStandAgent*> taxiStandAgents;
 
@@ -501,11 +703,30 @@ protected:
 	 */
 	std::map<const Link*, std::vector<LaneStats*> > laneGroup;
 
+	/**
+	 * merger of the persons of the lanes, reused in every tick
+	 */
+	TopCMerge<PersonList::iterator> laneMerge;
+
 	/**
 	 * mutex for adding agents to lanes 
 	 */
 	boost::recursive_mutex mutexPersonManagement;
 
+	/**
+	 * finds the lane stats of lane
+	 * @param lane the lane to find
+	 * @return the lane stats of lane; nullptr if lane is not in this segment stats
+	 */
+	LaneStats* findLaneStats(const Lane* lane) const
+	{
+		const unsigned int index = laneTable.find(lane);
+		if (index < laneStatsList.size())
+		{
+			return const_cast<LaneStats*>(&laneStatsList[index]);
+		}
+		return nullptr;
+	}
 
 	//aa{ For energy per-segment computation
 	// modified ZN -- 2/21/2018
@@ -638,6 +859,22 @@ public:
 	 */
 	void initializeBusStops();
 
+	/**
+	 * moves the message handlers of the bus stop agents in this segment stats (and the persons waiting
+	 * or alighting at those stops) into the given message context
+	 * @param context the message context of the worker which now manages the parent conflux
+	 */
+	void reRegisterHandlers(void* context);
+
+	/**
+	 * checks whether this segment stats has taxi-stand agents
+	 * @return true if there are taxi-stand agents in this segment stats; false otherwise
+	 */
+	bool hasTaxiStandAgents() const
+	{
+		return !taxiStandAgents.empty();
+	}
+
 	/**
 	 * add bus driver to stop
 	 * @param driver the bus driver to be added
@@ -713,9 +950,9 @@ public:
 	/**
 	 * merges the persons in segment in one list, thus forming the order in which
 	 * those persons need to be updated in this tick
-	 * @param mergedPersonList output list of persons to be populated
+	 * @param mergedPersons output list which the persons are appended to
 	 */
-	void topCMergeLanesInSegment(PersonList& mergedPersonList);
+	void topCMergeLanesInSegment(std::vector<Person_MT*>& mergedPersons);
 
 	/**
 	 * returns the queuing and moiving persons count in lane
@@ -990,7 +1227,17 @@ public:
 	 */
 	Lane* laneInfinity;
 
-	std::map<const Lane*, LaneStats*> getLaneStats() const ;
+	const std::map<const Lane*, LaneStats*>& getLaneStats() const;
+
+	const LaneTable& getLaneTable() const
+	{
+		return laneTable;
+	}
+
+	/**
+	 * @return number of bytes held by the lane state of this segment stats (lane table and LaneStats)
+	 */
+	std::size_t getLaneStateBytes() const;
 };
 } // namespace medium
 } // namespace sim_mob
@@ -34,7 +34,7 @@ void IncidentManager::publishDisruption(timeslice now)
     while (it != disruptions.end()) {
         if ((*it).startTime.getValue() < current.getValue()) {
             messaging::MessageBus::PublishEvent(event::EVT_CORE_MRT_DISRUPTION, this,
-                    messaging::MessageBus::EventArgsPtr(new event::DisruptionEventArgs(*it)));
+                    messaging::MessageBus::MakeEventArgs<event::DisruptionEventArgs>(*it));
             it = disruptions.erase(it);
         } else {
             it++;
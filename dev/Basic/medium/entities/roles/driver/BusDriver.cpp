@@ -169,7 +169,7 @@ void BusDriver::storeArrivalTime(const std::string& current, const std::string&
 		arrivalInfo.dwellTimeSecs = (DailyTime(waitTime)).getValue() / 1000.0;
 		arrivalInfo.pctOccupancy = (((double)passengerList.size())/MT_Config::getInstance().getBusCapacity()) * 100.0;
 		arrivalInfo.stopNo = busStopNo;
-		messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_BUS_ARRIVAL, messaging::MessageBus::MessagePtr(new PT_ArrivalTimeMessage(arrivalInfo)));
+		messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_BUS_ARRIVAL, messaging::MessageBus::MakeMessage<PT_ArrivalTimeMessage>(arrivalInfo));
 		this->busSequenceNumber++;
 	}
 }
@@ -194,7 +194,7 @@ void BusDriver::storeAlightInfo(const sim_mob::medium::Passenger* passenger,cons
         personAlightTimeInfo.serviceLine= BusLineId;
         personAlightTimeInfo.alightTime = currentTime;    //person allight time (==current time)
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_ALIGHTING,
-                                           messaging::MessageBus::MessagePtr(new PT_PassengerAlightInfoMessage(personAlightTimeInfo)));
+                                           messaging::MessageBus::MakeMessage<PT_PassengerAlightInfoMessage>(personAlightTimeInfo));
     }
 
 }
@@ -154,7 +154,7 @@ void sim_mob::medium::Driver::collectTravelTime()
         personTravelTime.travelTime = ((double) activity->getTravelTime())/1000.0;
         personTravelTime.arrivalTime = DailyTime(activity->getArrivalTime()).getStrRepr();
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                                           STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                                           STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
     }
 
     personTravelTime.tripStartPoint = (*(parent->currTripChainItem))->startLocationId;
@@ -178,6 +178,6 @@ void sim_mob::medium::Driver::collectTravelTime()
 
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
                                        STORE_PERSON_TRAVEL_TIME,
-                                       messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)),
+                                       messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime),
                                        true);
 }
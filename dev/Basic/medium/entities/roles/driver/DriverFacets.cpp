@@ -469,6 +469,11 @@ bool DriverMovement::initializePath()
 			bool useInSimulationTT = parentDriver->parent->usesInSimulationTravelTime();
 			wp_path = PrivateTrafficRouteChoice::getInstance()->getPath(currSubTrip, false, nullptr, useInSimulationTT);
 		}
+		else if (parentDriver->parent->usesInSimulationTravelTime())
+		{
+			const StreetDirectory& stdir = StreetDirectory::Instance();
+			wp_path = stdir.SearchInSimulationDrivingPath<Node, Node>(*(parentDriver->origin).node, *(parentDriver->goal).node);
+		}
 		else
 		{
 			const StreetDirectory& stdir = StreetDirectory::Instance();
@@ -1728,16 +1733,6 @@ bool DriverMovement::canJoinPaths(std::vector<WayPoint> & newPath, std::vector<c
 //	return res;
 }
 
-//todo put this in the utils(and code style!)
-boost::mt19937 myOwngen;
-
-int roll_die(int l, int r)
-{
-	boost::uniform_int<> dist(l, r);
-	boost::variate_generator<boost::mt19937&, boost::uniform_int<> > die(myOwngen, dist);
-	return die();
-}
-
 void DriverMovement::reroute()
 {
 	rerouter->reroute();
@@ -1860,7 +1855,7 @@ void DriverMovement::reroute(const InsertIncidentMessage &msg)
 	//todo, put a distribution function here. For testing now, give it the last new path for now
 	std::map<const Node*, std::vector<const SegmentStats*> >::iterator it(deTourOptions.begin());
 
-	int cnt = roll_die(0, deTourOptions.size() - 1);
+	int cnt = Utils::generateInt(0, deTourOptions.size() - 1);
 	int dbgIndx = cnt;
 	while (cnt)
 	{
@@ -19,8 +19,6 @@ namespace medium
 struct DriverUpdateParams : public UpdateParams {
     DriverUpdateParams()
     : UpdateParams(), secondsInTick(0.0), elapsedSeconds(0.0) {}
-    explicit DriverUpdateParams(boost::mt19937& gen)
-    : UpdateParams(gen), secondsInTick(0.0), elapsedSeconds(0.0){}
 
     /**
      * resets this update params.
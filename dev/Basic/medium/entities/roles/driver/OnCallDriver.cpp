@@ -397,7 +397,7 @@ void OnCallDriver::subscribeToController()
     }
 #endif
 
-    MessageBus::PostMessage(*it, MSG_DRIVER_SUBSCRIBE, MessageBus::MessagePtr(new DriverSubscribeMessage(parent)));
+    MessageBus::PostMessage(*it, MSG_DRIVER_SUBSCRIBE, MessageBus::MakeMessage<DriverSubscribeMessage>(parent));
 
 #ifndef NDEBUG
     ControllerLog() << "OnCallDriver " << parent->getDatabaseId() << "(" << parent << ")"
@@ -483,7 +483,7 @@ void OnCallDriver::sendAvailableMessage()
     for(auto ctrlr : subscribedControllers)
     {
         MessageBus::PostMessage(ctrlr, MSG_DRIVER_AVAILABLE,
-                                MessageBus::MessagePtr(new DriverAvailableMessage(parent)));
+                                MessageBus::MakeMessage<DriverAvailableMessage>(parent));
     }
 }
 
@@ -493,7 +493,7 @@ void OnCallDriver::sendStatusMessage()
     for(auto ctrlr : subscribedControllers)
     {
         MessageBus::PostMessage(ctrlr, MSG_DRIVER_SCHEDULE_STATUS,
-                                MessageBus::MessagePtr(new DriverScheduleStatusMsg(parent)));
+                                MessageBus::MakeMessage<DriverScheduleStatusMsg>(parent));
     }
 }
 
@@ -519,7 +519,7 @@ void OnCallDriver::sendWakeUpShiftEndMsg()
     unsigned int tick = ConfigManager::GetInstance().FullConfig().baseGranMS();
 
     medium::Conflux *cflx = movement->getMesoPathMover().getCurrSegStats()->getParentConflux();
-    MessageBus::PostMessage(cflx, MSG_WAKEUP_SHIFT_END, MessageBus::MessagePtr(new PersonMessage(parent)),
+    MessageBus::PostMessage(cflx, MSG_WAKEUP_SHIFT_END, MessageBus::MakeMessage<PersonMessage>(parent),
                                 false, timeToShiftEnd / tick);
 }
 
@@ -686,7 +686,7 @@ void OnCallDriver::endShift()
     for(auto ctrlr : subscribedControllers)
     {
         MessageBus::PostMessage(ctrlr, MSG_DRIVER_SHIFT_END,
-                                MessageBus::MessagePtr(new DriverShiftCompleted(parent)));
+                                MessageBus::MakeMessage<DriverShiftCompleted>(parent));
     }
 
     passengerInteractedDropOff=0;
@@ -371,7 +371,7 @@ void TaxiDriver::processNextScheduleItem(bool isMoveToNextScheduleItem)
         {
             //Inform the controller that one schedule item has been completed
             MessageBus::PostMessage(controller, MSG_DRIVER_SCHEDULE_STATUS,
-                                    MessageBus::MessagePtr(new DriverScheduleStatusMsg(parent)) );
+                                    MessageBus::MakeMessage<DriverScheduleStatusMsg>(parent) );
 
             //aa!!: This message is sent with 1-slot delay. It means that, for one time slot, the controller
             //          copy of the schedule and the actual schedule on the driver are different. It means that
@@ -393,7 +393,7 @@ void TaxiDriver::processNextScheduleItem(bool isMoveToNextScheduleItem)
                             << "is at the end of its shift. Time = " << parent->currTick << std::endl;
 
             MessageBus::PostMessage(controller, MSG_DRIVER_SHIFT_END,
-                                    MessageBus::MessagePtr(new DriverShiftCompleted(parent)));
+                                    MessageBus::MakeMessage<DriverShiftCompleted>(parent));
 
             if((currScheduleItem - 1)->scheduleItemType != PARK)
             {
@@ -427,7 +427,7 @@ void TaxiDriver::processNextScheduleItem(bool isMoveToNextScheduleItem)
             taxiDriverMovement->setOriginNode(currNode);
 
             Conflux *conflux = Conflux::getConfluxFromNode(taxiDriverMovement->getCurrentNode());
-            MessageBus::PostMessage(conflux, MSG_PERSON_LOAD, MessageBus::MessagePtr(new PersonMessage(parent)));
+            MessageBus::PostMessage(conflux, MSG_PERSON_LOAD, MessageBus::MakeMessage<PersonMessage>(parent));
 
             getResource()->setMoving(true);
         }
@@ -608,8 +608,8 @@ void TaxiDriver::processNextScheduleItem(bool isMoveToNextScheduleItem)
                 if(!hasDriverShiftEnded())
                 {
                     MessageBus::PostMessage(controller, MSG_DRIVER_AVAILABLE,
-                                            MessageBus::MessagePtr(new DriverAvailableMessage(
-                                                    taxiDriverMovement->getParentDriver()->parent)));
+                                            MessageBus::MakeMessage<DriverAvailableMessage>(
+                                                    taxiDriverMovement->getParentDriver()->parent));
                 }
 
                 const SegmentStats *currSegStat = taxiDriverMovement->getParentDriver()->getParent()->getCurrSegStats();
@@ -703,7 +703,7 @@ TaxiDriver::~TaxiDriver()
             it != taxiDriverMovement->getSubscribedControllers().end(); ++it)
         {
             MessageBus::PostMessage(*it, MSG_DRIVER_UNSUBSCRIBE,
-                                    MessageBus::MessagePtr(new DriverUnsubscribeMessage(parent)));
+                                    MessageBus::MakeMessage<DriverUnsubscribeMessage>(parent));
         }
     }
     ControllerLog()<< __FILE__ <<":" <<__LINE__<<":" <<__FUNCTION__<< ": Driver "<< parent->getDatabaseId()<<
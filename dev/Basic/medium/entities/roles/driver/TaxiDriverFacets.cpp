@@ -109,7 +109,7 @@ void TaxiDriverMovement::subscribeToOrIgnoreController(
 #endif
 
 			MessageBus::PostMessage(itController->second, MSG_DRIVER_SUBSCRIBE,
-			                        MessageBus::MessagePtr(new DriverSubscribeMessage(parentTaxiDriver->getParent())));
+			                        MessageBus::MakeMessage<DriverSubscribeMessage>(parentTaxiDriver->getParent()));
 
 #ifndef NDEBUG
 			ControllerLog() << "Driver " << parentDriver->getParent()->getDatabaseId()
@@ -321,7 +321,7 @@ bool TaxiDriverMovement::moveToNextSegment(DriverUpdateParams &params)
 			for (auto it = subscribedControllers.begin(); it != subscribedControllers.end(); ++it)
 			{
 				MessageBus::PostMessage(*it, MSG_DRIVER_AVAILABLE,
-										MessageBus::MessagePtr(new DriverAvailableMessage(parentTaxiDriver->getParent())));
+										MessageBus::MakeMessage<DriverAvailableMessage>(parentTaxiDriver->getParent()));
 			}
 		}
 
@@ -737,7 +737,7 @@ void TaxiDriverMovement::setCruisingMode()
 		for (auto it = subscribedControllers.begin(); it != subscribedControllers.end(); ++it)
 		{
 			MessageBus::PostMessage(*it, MSG_DRIVER_AVAILABLE,
-			                        MessageBus::MessagePtr(new DriverAvailableMessage(parentTaxiDriver->parent)));
+			                        MessageBus::MakeMessage<DriverAvailableMessage>(parentTaxiDriver->parent));
 		}
 	}
 
@@ -809,7 +809,7 @@ void TrainDriver::storeWaitingTime(WaitTrainActivity* waitingActivity, timeslice
 	personWaitInfo.busLineBoarded = waitingActivity->getTrainLine();
 	personWaitInfo.deniedBoardingCount = waitingActivity->getDeniedBoardingCount();
 	messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_WAITING,
-			messaging::MessageBus::MessagePtr(new PersonWaitingTimeMessage(personWaitInfo)));
+			messaging::MessageBus::MakeMessage<PersonWaitingTimeMessage>(personWaitInfo));
 }
 void TrainDriver::setArrivalTime(const std::string& currentTime)
 {
@@ -844,7 +844,7 @@ void TrainDriver::storeArrivalTime(const std::string& currentTime, const std::st
 		const ConfigParams& config = ConfigManager::GetInstance().FullConfig();
 		arrivalInfo.pctOccupancy = (((double)passengerList.size())/maxCapacity) * 100.0;
 		arrivalInfo.stopNo = platform->getPlatformNo();
-		messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_BUS_ARRIVAL, messaging::MessageBus::MessagePtr(new PT_ArrivalTimeMessage(arrivalInfo)));
+		messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_BUS_ARRIVAL, messaging::MessageBus::MakeMessage<PT_ArrivalTimeMessage>(arrivalInfo));
 	}
 }
 int TrainDriver::boardPassenger(std::list<WaitTrainActivity*>& boardingPassenger,timeslice now)
@@ -927,8 +927,7 @@ void TrainMovement::frame_tick()
 						std::string stationNo = platform->getStationNo();
 						Agent *stationAgent = TrainController<Person_MT>::getAgentFromStation(stationNo);
 						messaging::MessageBus::PostMessage(stationAgent, TRAIN_MOVE_AT_UTURN_PLATFORM,
-						                                   messaging::MessageBus::MessagePtr(
-								                                   new TrainDriverMessage(parentDriver, true)));
+						                                   messaging::MessageBus::MakeMessage<TrainDriverMessage>(parentDriver, true));
 
 						parentDriver->setNextRequested(TrainDriver::REQUESTED_TAKE_UTURN);
 					}
@@ -1096,9 +1095,8 @@ void TrainMovement::frame_tick()
 													stationNo);
 											messaging::MessageBus::PostMessage(stationAgent,
 											                                   TRAIN_MOVE_AT_UTURN_PLATFORM,
-											                                   messaging::MessageBus::MessagePtr(
-													                                   new TrainDriverMessage(
-															                                   parentDriver, true)));
+											                                   messaging::MessageBus::MakeMessage<TrainDriverMessage>(
+															                                   parentDriver, true));
 											//pass message for Uturn
 										}
 
@@ -1150,8 +1148,7 @@ void TrainMovement::frame_tick()
 			std::string stationNo = platform->getStationNo();
 			Agent *stationAgent = TrainController<Person_MT>::getAgentFromStation(stationNo);
 			messaging::MessageBus::PostMessage(stationAgent, TRAIN_MOVE_AT_UTURN_PLATFORM,
-			                                   messaging::MessageBus::MessagePtr(
-					                                   new TrainDriverMessage(parentDriver, true)));
+			                                   messaging::MessageBus::MakeMessage<TrainDriverMessage>(parentDriver, true));
 			break;
 		}
 
@@ -2073,8 +2070,7 @@ bool TrainMovement::leaveFromPlaform()
 		std::string stationNo = next->getStationNo();
 		Agent *stationAgent = TrainController<Person_MT>::getAgentFromStation(stationNo);
 		messaging::MessageBus::PostMessage(stationAgent, TRAIN_MOVETO_NEXT_PLATFORM,
-		                                   messaging::MessageBus::MessagePtr(
-				                                   new TrainDriverMessage(parentDriver, true)));
+		                                   messaging::MessageBus::MakeMessage<TrainDriverMessage>(parentDriver, true));
 		//log start time to next stretch to platform
 		TrainUpdateParams &params = parentDriver->getParams();
 		startTimeOfNextStationStretch = params.now.ms() + params.secondsInTick;
@@ -2178,8 +2174,7 @@ void TrainMovement::reAssignTrainsToStationAgent(Platform *prevPlatfrom, Platfor
 			TrainUpdateParams &params = parentDriver->getParams();
 			setNoMoveTimeslice(params.now.ms());
 			messaging::MessageBus::PostMessage(trainStationAgent, TRAIN_MOVETO_NEXT_PLATFORM,
-			                                   messaging::MessageBus::MessagePtr(
-					                                   new TrainDriverMessage(parentDriver, true)));
+			                                   messaging::MessageBus::MakeMessage<TrainDriverMessage>(parentDriver, true));
 			Agent *stationAgentOld = TrainController<sim_mob::medium::Person_MT>::getInstance()->getAgentFromStation(
 					prevPlatfrom->getStationNo());
 			TrainStationAgent *trainStationAgentOld = dynamic_cast<TrainStationAgent *>(stationAgentOld);
@@ -2256,7 +2251,7 @@ void TrainMovement::arrivalAtStartPlaform() const
 	std::string stationNo = next->getStationNo();
 	Agent *stationAgent = TrainController<Person_MT>::getAgentFromStation(stationNo);
 	messaging::MessageBus::PostMessage(stationAgent, TRAIN_ARRIVAL_AT_STARTPOINT,
-	                                   messaging::MessageBus::MessagePtr(new TrainDriverMessage(parentDriver)));
+	                                   messaging::MessageBus::MakeMessage<TrainDriverMessage>(parentDriver));
 }
 
 void TrainMovement::arrivalAtEndPlatform() const
@@ -116,7 +116,7 @@ void sim_mob::medium::Passenger::collectTravelTime()
         personTravelTime.travelTime = ((double) activity->getTravelTime())/1000.0;
         personTravelTime.arrivalTime = DailyTime(activity->getArrivalTime()).getStrRepr();
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                                           STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                                           STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
     }
     personTravelTime.tripStartPoint = (*(parent->currTripChainItem))->startLocationId;
     personTravelTime.tripEndPoint = (*(parent->currTripChainItem))->endLocationId;
@@ -185,7 +185,7 @@ void sim_mob::medium::Passenger::collectTravelTime()
     }
 
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-            STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+            STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 
     if(roleType == Role<Person_MT>::RL_TRAINPASSENGER)
     {
@@ -209,7 +209,7 @@ void sim_mob::medium::Passenger::collectWalkingTime()
     unsigned int arriveTime = parent->getRole()->getArrivalTime()+parent->getRole()->getTravelTime();
     personTravelTime.arrivalTime = DailyTime(arriveTime).getStrRepr();
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 }
 
 }
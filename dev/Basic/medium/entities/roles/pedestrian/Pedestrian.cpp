@@ -71,7 +71,7 @@ void sim_mob::medium::Pedestrian::collectTravelTime()
         personTravelTime.travelTime = ((double) activity->getTravelTime())/1000.0;
         personTravelTime.arrivalTime = DailyTime(activity->getArrivalTime()).getStrRepr();
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
     }
 
     if(!parent->currSubTrip->isTT_Walk)
@@ -87,8 +87,7 @@ void sim_mob::medium::Pedestrian::collectTravelTime()
         personTravelTime.travelTime = totalTravelTimeMS / 1000.0;
         personTravelTime.arrivalTime = DailyTime(parent->getRole()->getArrivalTime()).getStrRepr();
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                                           STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(
-                        new PersonTravelTimeMessage(personTravelTime)), true);
+                                           STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
     }
 }
 
@@ -189,7 +189,7 @@ void PedestrianMovement::frame_init()
         if (startConflux)
         {
             MessageBus::PostMessage(startConflux, MSG_TRAVELER_TRANSFER,
-                                    MessageBus::MessagePtr(new PersonMessage(person)));
+                                    MessageBus::MakeMessage<PersonMessage>(person));
         }
     }
     else // both origin and destination must be nodes
@@ -280,7 +280,7 @@ void PedestrianMovement::frame_tick()
                 if (start)
                 {
                     MessageBus::PostMessage(start, MSG_TRAVELER_TRANSFER,
-                                            MessageBus::MessagePtr(new PersonMessage(parentPedestrian->parent)));
+                                            MessageBus::MakeMessage<PersonMessage>(parentPedestrian->parent));
                 }
             }
             else
@@ -83,7 +83,7 @@ void WaitTaxiActivity::collectTravelTime()
     personTravelTime.travelTime = ((double) parent->getRole()->getTravelTime())/1000.0; //convert to seconds
     personTravelTime.arrivalTime = DailyTime(parent->getRole()->getArrivalTime()).getStrRepr();
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 }
 
 void WaitTaxiActivity::increaseWaitingTime(unsigned int timeMs)
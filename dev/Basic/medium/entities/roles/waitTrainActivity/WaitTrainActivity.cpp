@@ -67,7 +67,7 @@ void sim_mob::medium::WaitTrainActivity::collectTravelTime()
     personTravelTime.travelTime = ((double) parent->getRole()->getTravelTime())/1000.0; //convert to seconds
     personTravelTime.arrivalTime = DailyTime(parent->getRole()->getArrivalTime()).getStrRepr();
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 }
 
 void sim_mob::medium::WaitTrainActivity::collectWalkingTime()
@@ -86,7 +86,7 @@ void sim_mob::medium::WaitTrainActivity::collectWalkingTime()
     unsigned int arriveTime = parent->getRole()->getArrivalTime();
     personTravelTime.arrivalTime = DailyTime(arriveTime).getStrRepr();
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
     arriveTime += walkingTimeToPlatform*1000;
     parent->getRole()->setArrivalTime(arriveTime);
 }
@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <boost/bind.hpp>
 
 // added to access the lua function: to set the seed before the start of the preday run
 #include "behavioral/lua/PredayLuaProvider.hpp"
@@ -33,6 +34,7 @@
 #include "entities/BusController.hpp"
 #include "entities/TrainController.hpp"
 #include "entities/BusStopAgent.hpp"
+#include "entities/conflux/ConfluxRebalancer.hpp"
 #include "entities/TrainStationAgent.hpp"
 #include "entities/ClosedLoopRunManager.hpp"
 #include "entities/MT_PersonLoader.hpp"
@@ -51,12 +53,16 @@
 #include "geospatial/aimsun/Loader.hpp"
 #include "geospatial/network/RoadNetwork.hpp"
 #include "geospatial/streetdir/A_StarPublicTransitShortestPathImpl.hpp"
+#include "geospatial/streetdir/StreetDirectory.hpp"
 #include "logging/ControllerLog.hpp"
 #include "partitions/PartitionManager.hpp"
 #include "path/PathSetManager.hpp"
 #include "path/PathSetParam.hpp"
 #include "path/PT_PathSetManager.hpp"
 #include "path/PT_RouteChoiceLuaModel.hpp"
+#include "util/GraphPartitioner.hpp"
+#include "util/RandomService.hpp"
+#include "util/SlabPool.hpp"
 #include "util/Utils.hpp"
 #include "workers/WorkGroupManager.hpp"
 #include "behavioral/ServiceController.hpp"
@@ -151,23 +157,94 @@ bool assignConfluxToWorkerRecursive(WorkGroup* workGrp, Conflux* conflux, unsign
 	return workerFilled;
 }
 
+/**
+ * assigns confluxes to workers by partitioning the conflux graph.
+ * Each worker is a partition; the confluxes are the vertices of the graph, weighted by their estimated
+ * update cost; and each link between two confluxes is an edge weighted by the expected flow of vehicles
+ * on that link. The partitioner minimises the expected flow of persons between workers (i.e. the number
+ * of PersonTransferMessages) while balancing the estimated update cost of the workers.
+ * The cut size and load imbalance of the resulting assignment are reported.
+ *
+ * @param workGrp the work group containing workers which must take confluxes
+ */
+void assignConfluxToWorkersByPartitioning(WorkGroup* workGrp)
+{
+	//Using confluxes by reference as we clear the set after assigning them to workers
+	std::set<Conflux*>& confluxes = MT_Config::getInstance().getConfluxes();
+	const std::map<const Node*, Conflux*>& nodeConfluxesMap = MT_Config::getInstance().getConfluxNodes();
+	const WorkerParams& workerParams = MT_Config::getInstance().getWorkerParams();
+	const DailyTime& simStartTime = ConfigManager::GetInstance().FullConfig().simStartTime();
+	size_t numWorkers = workGrp->size();
+
+	GraphPartitioner partitioner;
+	std::vector<Conflux*> confluxList(confluxes.begin(), confluxes.end());
+	std::map<const Conflux*, size_t> confluxIndex;
+	for (std::vector<Conflux*>::const_iterator cfxIt = confluxList.begin(); cfxIt != confluxList.end(); cfxIt++)
+	{
+		confluxIndex[*cfxIt] = partitioner.addVertex((*cfxIt)->getEstimatedUpdateCost(simStartTime));
+	}
+
+	const std::map<unsigned int, Link*>& linkMap = RoadNetwork::getInstance()->getMapOfIdVsLinks();
+	for (std::map<unsigned int, Link*>::const_iterator lnkIt = linkMap.begin(); lnkIt != linkMap.end(); lnkIt++)
+	{
+		const Link* lnk = lnkIt->second;
+		std::map<const Node*, Conflux*>::const_iterator fromIt = nodeConfluxesMap.find(lnk->getFromNode());
+		std::map<const Node*, Conflux*>::const_iterator toIt = nodeConfluxesMap.find(lnk->getToNode());
+		if (fromIt == nodeConfluxesMap.end() || toIt == nodeConfluxesMap.end())
+		{
+			continue; // link's start node need not necessarily have a conflux
+		}
+		//lnk is owned by the conflux at its end node. persons entering lnk are transferred to that conflux
+		//from the conflux at its start node, which owns the upstream links feeding lnk
+		partitioner.addEdge(confluxIndex.at(fromIt->second), confluxIndex.at(toIt->second),
+				toIt->second->getExpectedLinkFlow(lnk, simStartTime));
+	}
+
+	std::vector<unsigned int> parts = partitioner.partition(numWorkers, workerParams.partitionImbalanceTolerance);
+	for (size_t i = 0; i < confluxList.size(); i++)
+	{
+		Conflux* cfx = confluxList[i];
+		if (workGrp->assignWorker(cfx, parts[i]))
+		{
+			cfx->setParentWorkerAssigned();
+		}
+		else
+		{
+			throw std::runtime_error("worker assignment failed for conflux");
+		}
+	}
+	confluxes.clear();
+
+	for (unsigned wrkrIdx = 0; wrkrIdx < numWorkers; wrkrIdx++)
+	{
+		assignConfluxLoaderToWorker(workGrp, wrkrIdx);
+	}
+
+	std::stringstream report;
+	report << "Conflux graph partitioning (" << confluxList.size() << " confluxes, " << numWorkers << " workers)\n";
+	partitioner.computeStats(parts, numWorkers).print(report);
+	Print() << report.str();
+	ControllerLog() << report.str();
+}
+
 /**
  * adds each conflux to the managedEntities list of workers.
  * This function attempts to assign all adjacent confluxes to the same worker.
  *
- * Future work:
- * If this assignment performs badly, we might want to think of a heuristics based optimization algorithm
- * which improves this assignment. We can indeed model this problem as a graph partitioning problem. Each
- * worker is a partition; the confluxes can be modeled as the nodes of the graph; and the edges will represent
- * the flow of vehicles between confluxes. Our objective is to minimize the (expected) flow of agents from one
- * partition to the other. We can try to fit the Kernighan-Lin algorithm or Fiduccia-Mattheyses algorithm
- * for partitioning, if it works. This is a little more complex due to the variable flow rates of vehicles
- * (edge weights); might require more thinking.
+ * If graph partitioning is enabled in the config, the assignment is delegated to
+ * assignConfluxToWorkersByPartitioning(), which models the assignment as a graph partitioning problem
+ * over the conflux graph with expected link flows as edge weights.
  *
  * @param workGrp the work group containing workers which must take confluxes
  */
 void assignConfluxToWorkers(WorkGroup* workGrp)
 {
+	if (MT_Config::getInstance().getWorkerParams().confluxAssignment == WorkerParams::CONFLUX_ASSIGNMENT_GRAPH_PARTITION)
+	{
+		assignConfluxToWorkersByPartitioning(workGrp);
+		return;
+	}
+
 	//Using confluxes by reference as we remove items as and when we assign them to a worker
 	std::set<Conflux*>& confluxes = MT_Config::getInstance().getConfluxes();
 	size_t numWorkers = workGrp->size();
@@ -340,6 +417,10 @@ bool performMainSupply(const std::string& configFileName, std::list<std::string>
 	{ //Begin scope: WorkGroups
 	WorkGroupManager wgMgr;
 	wgMgr.setSingleThreadMode(false);
+	if (mtConfig.getWorkerParams().spinBarrier)
+	{
+		wgMgr.setBarrierStrategy(FlexiBarrier::SPIN_THEN_BLOCK, mtConfig.getWorkerParams().barrierSpinCount);
+	}
 
 	//Work Group specifications
 	//Mid-term is not using Aura Manager at the moment. Therefore setting it to nullptr
@@ -408,6 +489,19 @@ bool performMainSupply(const std::string& configFileName, std::list<std::string>
 	        << config.getDatabaseProcMappings().procedureMappings["day_activity_schedule"] << std::endl;
 	Print() << "\nSimulating...\n";
 
+	//periodic migration of confluxes between workers (if enabled)
+	ConfluxRebalancer* confluxRebalancer = nullptr;
+	if (mtConfig.getWorkerParams().rebalancing.enabled)
+	{
+		confluxRebalancer = new ConfluxRebalancer(personWorkers, mtConfig.getWorkerParams().rebalancing, config.baseGranMS());
+	}
+
+	//Route the InSimulation queries with the link travel times of the interval which just ended
+	if (config.simulation.travelTimeRefreshInterval > 0)
+	{
+		wgMgr.setFlipBuffersCallback(boost::bind(&StreetDirectory::refreshInSimulationTravelTimesAfterTick, &StreetDirectory::Instance(), _1));
+	}
+
 	//Start work groups and all threads.
 	wgMgr.startAllWorkGroups();
 
@@ -465,6 +559,11 @@ bool performMainSupply(const std::string& configFileName, std::list<std::string>
 			TrainRemoval *trainRemovalInstance=TrainRemoval::getInstance();
 			trainRemovalInstance->removeTrainsBeforeNextFrameTick();
 			TrainServiceControllerLuaProvider::getTrainControllerModel()->useServiceController((dailyTime+DailyTime(5000)).getStrRepr());
+			//workers are waiting on the message bus barrier; confluxes can be moved safely before messages are distributed
+			if (confluxRebalancer)
+			{
+				confluxRebalancer->update(currTick);
+			}
 			wgMgr.waitAllGroups_DistributeMessages(removedEntities);
 			wgMgr.waitAllGroups_MacroTimeTick();
 
@@ -493,6 +592,7 @@ bool performMainSupply(const std::string& configFileName, std::list<std::string>
 	Print() << "100%\n\nTime required to execute the simulation: "
 	        << DailyTime((uint32_t) loop_time).getStrRepr() << std::endl;
 
+	safe_delete_item(confluxRebalancer);
 	BusStopAgent::removeAllBusStopAgents();
 	sim_mob::PathSetParam::resetInstance();
 
@@ -513,6 +613,10 @@ bool performMainSupply(const std::string& configFileName, std::list<std::string>
 	Print() << "\nNumber of trips [demand] completed: " << config.numTripsCompleted;
 	Print() << "\n\nNumber of persons loaded: " << config.numPersonsLoaded << endl;
 
+	std::stringstream poolStats;
+	SlabPool::printStats(poolStats);
+	Print() << poolStats.str();
+
 	if(config.numPathNotFound > 0)
 	{
 		Print() << "Persons not simulated as the path was not found [Refer to warn.log for more details]: "
@@ -859,7 +963,6 @@ bool performMidFullLoop(const std::string& configFileName, std::list<std::string
  */
 bool performMainMed(const std::string& configFileName, const std::string& mtConfigFileName, std::list<std::string>& resLogFiles)
 {
-	std::srand(clock()); // set random seed for RNGs
 	cout <<"Starting SimMobility, version " << SIMMOB_VERSION << endl;
 	cout << "\nLoading the configuration files: " << configFileName << ", " << mtConfigFileName << endl;
 
@@ -869,6 +972,9 @@ bool performMainMed(const std::string& configFileName, const std::string& mtConf
 	//load configuration file for mid-term
 	ParseMidTermConfigFile parseMT_Cfg(mtConfigFileName, MT_Config::getInstance(), ConfigManager::GetInstanceRW().FullConfig());
 
+	//set random seed for the generator of the C library, from the global seed read from the configuration
+	std::srand(RandomStream(0, RANDOM_LIBRARY_SEED)());
+
 	//Enable or disable logging (all together, for now).
 	//NOTE: This may seem like an odd place to put this, but it makes sense in context.
 	//      OutputEnabled is always set to the correct value, regardless of whether ConfigParams()
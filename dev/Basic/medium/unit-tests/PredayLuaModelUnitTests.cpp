@@ -0,0 +1,56 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <string>
+
+#include "behavioral/lua/PredayLuaModel.hpp"
+#include "behavioral/MultinomialLogit.hpp"
+#include "lua/third-party/luabridge/LuaBridge.h"
+
+#include "PredayLuaModelUnitTests.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::medium;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PredayLuaModelUnitTests);
+
+namespace {
+///Run from dev/Basic, as the simulator is.
+const std::string LOGIT_SCRIPT = "scripts/lua/mid/behavior_vc/logit.lua";
+
+///Gives access to the Lua state, to make a choice the way the scripts of the models do.
+class ScriptedModel : public PredayLuaModel {
+public:
+    ///Chooses among a single alternative with make_final_choice, which draws one number.
+    int makeLuaChoice() const {
+        luabridge::LuaRef probability = luabridge::newTable(state.get());
+        probability[1] = 1.0;
+        return luabridge::getGlobal(state.get(), "make_final_choice")(probability).cast<int>();
+    }
+};
+}
+
+void unit_tests::PredayLuaModelUnitTests::test_CompiledDrawFollowsLuaDraw()
+{
+    const boost::uint64_t seed = 0x123456789AULL;
+    ScriptedModel model;
+    model.loadFile(LOGIT_SCRIPT);
+    model.initialize();
+
+    LogitRandom expected;
+    expected.seed(seed);
+    const double luaDraw = expected.next();
+    const double nextDraw = expected.next();
+
+    //The compiled draw does not reuse the number drawn by the script.
+    model.seedRandom(seed);
+    CPPUNIT_ASSERT_EQUAL(1, model.makeLuaChoice());
+    const double compiledDraw = model.nextRandom();
+    CPPUNIT_ASSERT(compiledDraw != luaDraw);
+    CPPUNIT_ASSERT_EQUAL(nextDraw, compiledDraw);
+
+    //Seeding again restarts the one sequence.
+    model.seedRandom(seed);
+    CPPUNIT_ASSERT_EQUAL(luaDraw, model.nextRandom());
+}
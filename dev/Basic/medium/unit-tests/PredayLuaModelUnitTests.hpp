@@ -0,0 +1,28 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the random draws shared by the preday Lua scripts and the compiled choice models.
+ */
+class PredayLuaModelUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///A compiled draw following a Lua draw of the same person continues the sequence of logit.lua.
+    void test_CompiledDrawFollowsLuaDraw();
+
+private:
+    CPPUNIT_TEST_SUITE(PredayLuaModelUnitTests);
+        CPPUNIT_TEST(test_CompiledDrawFollowsLuaDraw);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,258 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "config/MT_Config.hpp"
+#include "entities/conflux/SegmentStats.hpp"
+#include "entities/Person_MT.hpp"
+#include "entities/roles/Role.hpp"
+#include "entities/vehicle/VehicleBase.hpp"
+#include "geospatial/network/Lane.hpp"
+#include "geospatial/network/Link.hpp"
+#include "geospatial/network/RoadSegment.hpp"
+
+#include "SegmentStatsUnitTests.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::medium;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::SegmentStatsUnitTests);
+
+namespace {
+const unsigned int NUM_LANES = 4;
+const double SEGMENT_LENGTH = 200.0;
+
+///Role giving its person a vehicle of a given length, as the driver roles do.
+class VehicleRole : public Role<Person_MT> {
+public:
+    VehicleRole(Person_MT* person, double vehicleLength) : Role<Person_MT>(person, std::string("VehicleRole")) {
+        setResource(new VehicleBase(VehicleBase::CAR, vehicleLength, 2.0));
+    }
+
+    virtual Role<Person_MT>* clone(Person_MT* person) const {
+        return new VehicleRole(person, currResource->getLengthInM());
+    }
+
+    virtual std::vector<BufferedBase*> getSubscriptionParams() {
+        return std::vector<BufferedBase*>();
+    }
+
+    virtual void make_frame_tick_params(timeslice now) {
+    }
+};
+
+///A segment of a link, with its lanes.
+struct Segment {
+    Segment() {
+        //speed density parameters of the category of the link, as in the supply configuration
+        SpeedDensityParams params;
+        params.setAlpha(1.8);
+        params.setBeta(1.9);
+        params.setJamDensity(0.2);
+        params.setMinDensity(0.04);
+        MT_Config::getInstance().setSpeedDensityParam(link.getLinkCategory(), params);
+        MT_Config::getInstance().setSupplyUpdateInterval(5);
+
+        segment = new RoadSegment();
+        segment->setRoadSegmentId(11);
+        segment->setParentLink(&link);
+        segment->setMaxSpeed(60.0);
+        segment->setCapacity(1800 * NUM_LANES);
+        for (unsigned int i = 0; i < NUM_LANES; i++) {
+            Lane* lane = new Lane();
+            lane->setLaneId(110 + i);
+            lane->setRoadSegmentId(11);
+            lane->setParentSegment(segment);
+            segment->addLane(lane);
+        }
+    }
+
+    ~Segment() {
+        //also deletes the lanes
+        delete segment;
+    }
+
+    Link link;
+    RoadSegment* segment;
+};
+
+///The persons of a test, owning them.
+struct Persons {
+    ~Persons() {
+        for (std::vector<Person_MT*>::iterator it = persons.begin(); it != persons.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    Person_MT* add(double vehicleLength, double distanceToEndOfSegment, bool queuing) {
+        Person_MT* person = new Person_MT("SegmentStatsUnitTests", MtxStrat_Buffered);
+        if (vehicleLength > 0.0) {
+            person->setNextRole(new VehicleRole(person, vehicleLength));
+            person->changeRole();
+        }
+        person->distanceToEndOfSegment = distanceToEndOfSegment;
+        person->isQueuing = queuing;
+        persons.push_back(person);
+        return person;
+    }
+
+    std::vector<Person_MT*> persons;
+};
+
+///Sums of the state of the vehicle lanes, computed lane by lane from their LaneStats.
+struct LaneSums {
+    explicit LaneSums(const SegmentStats& stats) : queueLength(0.0), movingLength(0.0), totalLength(0.0), queuing(0),
+            moving(0), hasQueue(false) {
+        const std::map<const Lane*, LaneStats*>& laneStats = stats.getLaneStats();
+        for (std::map<const Lane*, LaneStats*>::const_iterator it = laneStats.begin(); it != laneStats.end(); ++it) {
+            const LaneStats* lnStats = it->second;
+            if (lnStats->isLaneInfinity() || it->first->isPedestrianLane()) {
+                continue;
+            }
+            queueLength += lnStats->getQueueLength();
+            movingLength += lnStats->getMovingLength();
+            totalLength += lnStats->getTotalVehicleLength();
+            queuing += lnStats->getQueuingAgentsCount();
+            moving += lnStats->getMovingAgentsCount();
+            hasQueue = hasQueue || (lnStats->getQueueLength() > 0.0);
+        }
+    }
+
+    double queueLength;
+    double movingLength;
+    double totalLength;
+    unsigned int queuing;
+    unsigned int moving;
+    bool hasQueue;
+};
+
+void assertAggregatesMatch(const SegmentStats& stats) {
+    LaneSums sums(stats);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(sums.queueLength, stats.getQueueLength(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(sums.movingLength, stats.getMovingLength(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(sums.totalLength, stats.getTotalVehicleLength(), 1e-9);
+    CPPUNIT_ASSERT_EQUAL(sums.queuing, stats.numQueuingInSegment(true));
+    CPPUNIT_ASSERT_EQUAL(sums.moving, stats.numMovingInSegment(true));
+    CPPUNIT_ASSERT_EQUAL(sums.hasQueue, stats.hasQueue());
+
+    const std::map<const Lane*, LaneStats*>& laneStats = stats.getLaneStats();
+    for (std::map<const Lane*, LaneStats*>::const_iterator it = laneStats.begin(); it != laneStats.end(); ++it) {
+        CPPUNIT_ASSERT_EQUAL(it->second->getNumPersons(), stats.numAgentsInLane(it->first));
+        CPPUNIT_ASSERT_EQUAL(it->second->getQueueLength(), stats.getLaneQueueLength(it->first));
+        CPPUNIT_ASSERT_EQUAL(it->second->getTotalVehicleLength(), stats.getLaneTotalVehicleLength(it->first));
+    }
+}
+
+const Lane* getLaneInfinity(const SegmentStats& stats) {
+    const std::map<const Lane*, LaneStats*>& laneStats = stats.getLaneStats();
+    for (std::map<const Lane*, LaneStats*>::const_iterator it = laneStats.begin(); it != laneStats.end(); ++it) {
+        if (it->second->isLaneInfinity()) {
+            return it->first;
+        }
+    }
+    return nullptr;
+}
+} //End anon namespace
+
+void unit_tests::SegmentStatsUnitTests::test_AggregatesMatchLaneStats()
+{
+    Segment segment;
+    SegmentStats stats(segment.segment, nullptr, SEGMENT_LENGTH);
+    Persons persons;
+    const std::vector<const Lane*>& lanes = segment.segment->getLanes();
+
+    CPPUNIT_ASSERT_EQUAL(NUM_LANES + 1, stats.getLaneTable().size());
+    assertAggregatesMatch(stats);
+    CPPUNIT_ASSERT(!stats.hasQueue());
+
+    //Each lane gets a different mix of moving and queuing vehicles.
+    std::vector<Person_MT*> queued;
+    for (unsigned int i = 0; i < lanes.size(); i++) {
+        for (unsigned int j = 0; j <= i; j++) {
+            bool queuing = (j % 2 == 1);
+            Person_MT* person = persons.add(4.0 + i + 0.5 * j, SEGMENT_LENGTH - 10.0 * j, queuing);
+            stats.addAgent(lanes[i], person);
+            if (queuing) {
+                queued.push_back(person);
+            }
+        }
+    }
+
+    //Persons in lane infinity are in no aggregate.
+    const Lane* laneInfinity = getLaneInfinity(stats);
+    CPPUNIT_ASSERT(laneInfinity);
+    stats.addAgent(laneInfinity, persons.add(0.0, SEGMENT_LENGTH, false));
+    stats.addAgent(laneInfinity, persons.add(0.0, SEGMENT_LENGTH, false));
+    CPPUNIT_ASSERT_EQUAL(2u, stats.numAgentsInLane(laneInfinity));
+
+    assertAggregatesMatch(stats);
+    CPPUNIT_ASSERT(stats.hasQueue());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(queued.size()), stats.numQueuingInSegment(true));
+    CPPUNIT_ASSERT_EQUAL(10u - static_cast<unsigned int>(queued.size()), stats.numMovingInSegment(true));
+
+    //Moving vehicles start queuing, queuing ones start moving.
+    Person_MT* last = stats.getPersons(lanes[3]).back();
+    last->isQueuing = !last->isQueuing;
+    stats.updateQueueStatus(lanes[3], last);
+    queued[0]->isQueuing = false;
+    stats.updateQueueStatus(lanes[1], queued[0]);
+    assertAggregatesMatch(stats);
+
+    //Removing vehicles, queuing or not, keeps the aggregates consistent.
+    Person_MT* front = stats.getPersons(lanes[2]).front();
+    CPPUNIT_ASSERT(stats.removeAgent(lanes[2], front, front->isQueuing, front->getRole()->getResource()->getLengthInM()));
+    Person_MT* queuing = queued.back();
+    CPPUNIT_ASSERT(stats.removeAgent(lanes[3], queuing, true, queuing->getRole()->getResource()->getLengthInM()));
+    assertAggregatesMatch(stats);
+
+    //Emptying the lanes brings every aggregate back to 0.
+    for (unsigned int i = 0; i < lanes.size(); i++) {
+        while (!stats.getPersons(lanes[i]).empty()) {
+            Person_MT* person = stats.getPersons(lanes[i]).front();
+            CPPUNIT_ASSERT(stats.removeAgent(lanes[i], person, person->isQueuing, person->getRole()->getResource()->getLengthInM()));
+        }
+    }
+    assertAggregatesMatch(stats);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, stats.getTotalVehicleLength(), 1e-9);
+    CPPUNIT_ASSERT_EQUAL(0u, stats.numQueuingInSegment(true));
+    CPPUNIT_ASSERT_EQUAL(0u, stats.numMovingInSegment(true));
+    CPPUNIT_ASSERT(!stats.hasQueue());
+}
+
+void unit_tests::SegmentStatsUnitTests::test_OutputCounters()
+{
+    Segment segment;
+    SegmentStats stats(segment.segment, nullptr, SEGMENT_LENGTH);
+    const std::vector<const Lane*>& lanes = segment.segment->getLanes();
+
+    for (unsigned int i = 0; i < lanes.size(); i++) {
+        stats.updateLaneParams(lanes[i], 0.25 * (i + 1));
+        stats.getLaneParams(lanes[i])->setOutputCounter(10 * (i + 1));
+    }
+    for (unsigned int i = 0; i < lanes.size(); i++) {
+        for (unsigned int j = 0; j < i; j++) {
+            stats.getLaneParams(lanes[i])->decrementOutputCounter();
+        }
+    }
+
+    //Each lane sees its own counter and flow rate, through the lane params and the lane table alike.
+    const LaneTable& table = stats.getLaneTable();
+    for (unsigned int i = 0; i < lanes.size(); i++) {
+        LaneParams* laneParams = stats.getLaneParams(lanes[i]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(10 * (i + 1) - i), laneParams->getOutputCounter());
+        CPPUNIT_ASSERT_EQUAL(0.25 * (i + 1), laneParams->getOutputFlowRate());
+        unsigned int index = table.find(lanes[i]);
+        CPPUNIT_ASSERT(index < table.size());
+        CPPUNIT_ASSERT_EQUAL(laneParams->getOutputFlowRate(), table.get(LaneTable::OUTPUT_FLOW_RATE, index));
+        CPPUNIT_ASSERT_EQUAL(laneParams->getAcceptRate(), table.get(LaneTable::ACCEPT_RATE, index));
+    }
+
+    //A lane cannot output more vehicles than its counter allows.
+    stats.getLaneParams(lanes[0])->setOutputCounter(0);
+    CPPUNIT_ASSERT_THROW(stats.getLaneParams(lanes[0])->decrementOutputCounter(), std::runtime_error);
+    CPPUNIT_ASSERT_EQUAL(19, stats.getLaneParams(lanes[1])->getOutputCounter());
+}
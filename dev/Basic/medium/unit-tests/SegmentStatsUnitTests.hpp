@@ -0,0 +1,32 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the lane table backing the lane state of SegmentStats.
+ */
+class SegmentStatsUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///The segment aggregates, read from the lane table, match the sums over the LaneStats of the lanes.
+    void test_AggregatesMatchLaneStats();
+
+    ///The output counters of the lanes are kept apart in the lane table.
+    void test_OutputCounters();
+
+private:
+    CPPUNIT_TEST_SUITE(SegmentStatsUnitTests);
+        CPPUNIT_TEST(test_AggregatesMatchLaneStats);
+        CPPUNIT_TEST(test_OutputCounters);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -18,6 +18,19 @@ local function myRand()
 	return V/D40
 end
 
+-- Restarts the generator from the state given as its high and low 20 bits (the low value must be odd).
+-- Called from C++ before each person is simulated, so that the draws made for a person do not depend on
+-- the thread simulating it or on the persons simulated before by the same thread.
+function seed_random(x1, x2)
+	X1, X2 = x1, x2
+end
+
+-- Draws the next number of the generator. Used by the choice models evaluated in C++, so that all the
+-- models of a person draw from the one sequence.
+function next_random()
+	return myRand()
+end
+
 local function calculate_multinomial_logit_probability(choices, utility, availables)
 	local probability = {}
 	local evsum = 0
@@ -0,0 +1,107 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "MultinomialLogit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace sim_mob;
+
+namespace
+{
+const double RAND_A1 = 1331;
+const double RAND_A2 = 798405;
+const double RAND_D20 = 1048576;
+const double RAND_D40 = 1099511627776;
+
+void checkSizes(const std::vector<double>& utility, const std::vector<int>& availability)
+{
+    if (availability.size() != utility.size())
+    {
+        throw std::runtime_error("MultinomialLogit: utility and availability vectors differ in length");
+    }
+}
+}
+
+double MultinomialLogit::computeProbabilities(const std::vector<double>& utility, const std::vector<int>& availability,
+        std::vector<double>& outProbability)
+{
+    checkSizes(utility, availability);
+    const std::size_t numAlternatives = utility.size();
+    outProbability.resize(numAlternatives);
+
+    double evSum = 0;
+    for (std::size_t i = 0; i < numAlternatives; ++i)
+    {
+        const double u = utility[i];
+        const double ev = (availability[i] && u == u) ? std::exp(u) : 0.0;
+        outProbability[i] = ev;
+        evSum += ev;
+    }
+    for (std::size_t i = 0; i < numAlternatives; ++i)
+    {
+        if (outProbability[i] != 0)
+        {
+            outProbability[i] /= evSum;
+        }
+    }
+    return evSum;
+}
+
+double MultinomialLogit::computeLogsum(const std::vector<double>& utility, const std::vector<int>& availability)
+{
+    checkSizes(utility, availability);
+    double evSum = 0;
+    for (std::size_t i = 0; i < utility.size(); ++i)
+    {
+        const double u = utility[i];
+        if (availability[i] && u == u)
+        {
+            evSum += std::exp(u);
+        }
+    }
+    return std::log(evSum);
+}
+
+int MultinomialLogit::makeChoice(const std::vector<double>& probability, double draw)
+{
+    if (probability.empty())
+    {
+        throw std::runtime_error("MultinomialLogit: no alternatives to choose from");
+    }
+
+    double cumulative = 0;
+    for (std::size_t i = 0; i < probability.size(); ++i)
+    {
+        const double p = probability[i];
+        cumulative += (p == p) ? p : 0.0;
+        if (cumulative >= draw)
+        {
+            return i + 1;
+        }
+    }
+    return probability.size();
+}
+
+LogitRandom::LogitRandom() : x1(0), x2(1)
+{
+}
+
+void LogitRandom::seed(boost::uint64_t seed)
+{
+    x1 = static_cast<double>((seed >> 20) & 0xFFFFF);
+    x2 = static_cast<double>((seed & 0xFFFFF) | 1);
+}
+
+double LogitRandom::next()
+{
+    const double u = x2 * RAND_A2;
+    double v = std::fmod(x1 * RAND_A2 + x2 * RAND_A1, RAND_D20);
+    v = std::fmod(v * RAND_D20 + u, RAND_D40);
+    x1 = std::floor(v / RAND_D20);
+    x2 = v - x1 * RAND_D20;
+    return v / RAND_D40;
+}
@@ -0,0 +1,99 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Multinomial logit computations for choice models evaluated in C++.
+ *
+ * The functions follow the conventions of the logit.lua helpers used by the preday scripts, so that a model
+ * evaluated here gives the same results as its script:
+ *  alternatives are numbered from 1 in the order of the utility vector,
+ *  an alternative is available if its availability flag is non zero, and
+ *  an alternative whose utility is NaN is treated as unavailable.
+ */
+class MultinomialLogit
+{
+public:
+    /**
+     * computes the choice probabilities
+     * @param utility utility of each alternative
+     * @param availability availability flag of each alternative; must be as long as utility
+     * @param outProbability output probability of each alternative; 0 for unavailable alternatives
+     * @return sum of the exponentiated utilities of the available alternatives
+     */
+    static double computeProbabilities(const std::vector<double>& utility, const std::vector<int>& availability,
+            std::vector<double>& outProbability);
+
+    /**
+     * computes the logsum (expected maximum utility)
+     * @param utility utility of each alternative
+     * @param availability availability flag of each alternative; must be as long as utility
+     * @return log of the sum of the exponentiated utilities of the available alternatives
+     *         (-infinity if no alternative is available)
+     */
+    static double computeLogsum(const std::vector<double>& utility, const std::vector<int>& availability);
+
+    /**
+     * draws an alternative
+     * @param probability probability of each alternative
+     * @param draw uniform random number in [0, 1)
+     * @return the first alternative (numbered from 1) whose cumulative probability reaches draw;
+     *         the last alternative if none does
+     */
+    static int makeChoice(const std::vector<double>& probability, double draw);
+};
+
+/**
+ * Uniform random number generator of logit.lua.
+ *
+ * A multiplicative congruential generator on 40 bits; every value it produces is exactly representable as a
+ * double, so this implementation and the script produce the same sequence from the same state.
+ * Not thread safe; use one instance per thread.
+ */
+class LogitRandom
+{
+public:
+    LogitRandom();
+
+    /**
+     * restarts the sequence from a state derived from a seed
+     * @param seed the seed; its low 40 bits make the state, with the lowest bit set to keep the full period
+     */
+    void seed(boost::uint64_t seed);
+
+    /**
+     * @return next number of the sequence, in [0, 1)
+     */
+    double next();
+
+    /**
+     * @return high 20 bits of the state (X1 of the script)
+     */
+    double getStateHigh() const
+    {
+        return x1;
+    }
+
+    /**
+     * @return low 20 bits of the state (X2 of the script)
+     */
+    double getStateLow() const
+    {
+        return x2;
+    }
+
+private:
+    /** high and low 20 bits of the state */
+    double x1;
+    double x2;
+};
+
+}
@@ -0,0 +1,453 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PredayDataCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "conf/ConfigManager.hpp"
+#include "conf/ConfigParams.hpp"
+#include "database/DB_Connection.hpp"
+#include "database/predaydao/DatabaseHelper.hpp"
+#include "soci/soci.h"
+
+using namespace sim_mob;
+
+namespace
+{
+const char CACHE_FILE_MAGIC[8] = { 'S', 'M', 'P', 'D', 'C', 'A', 'C', 'H' };
+
+/** must be incremented whenever the layout of the file or of any record changes */
+const uint32_t CACHE_FILE_VERSION = 2;
+
+/** sections of a cache file, in file order */
+enum Section
+{
+    SOURCE_KEY,
+    ZONES,
+    ZONES_WITHOUT_NODE,
+    ZONE_NODES,
+    UNAVAILABLE_ODS,
+    AM_COSTS,
+    PM_COSTS,
+    OP_COSTS,
+    NUM_SECTIONS
+};
+
+/** keys (in the table names map of the config) of the tables the cached data is loaded from */
+const char* const SOURCE_TABLES[] = { "taz_table", "taz_without_node_table", "node_taz_map_table", "AM_cost_table", "PM_cost_table",
+        "OP_cost_table", "learned_travel_time_table_car", "learned_travel_time_table_bus" };
+
+/**
+ * Header of a cache file.
+ * Every section starts at an 8 byte aligned offset. The skim sections hold a matrix written by SkimMatrix::write();
+ * every other section holds a uint64_t record count followed by the records.
+ */
+struct CacheFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numSections;
+    uint64_t fileSize;
+    /** checksum of everything after the header */
+    uint64_t checksum;
+    uint64_t sectionOffsets[NUM_SECTIONS];
+};
+
+struct ZoneRecord
+{
+    int32_t zoneId;
+    int32_t zoneCode;
+    int32_t centralDummy;
+    int32_t cbdDummy;
+    double area;
+    double population;
+    double shop;
+    double parkingRate;
+    double residentWorkers;
+    double employment;
+    double totalEnrollment;
+    double residentStudents;
+};
+
+struct ZoneNodeRecord
+{
+    int32_t zone;
+    uint32_t nodeId;
+    uint32_t nodeType;
+    uint8_t sourceNode;
+    uint8_t sinkNode;
+    uint8_t busTerminusNode;
+    uint8_t unused;
+};
+
+struct OD_Record
+{
+    int32_t origin;
+    int32_t destination;
+};
+
+/**
+ * 64 bit FNV-1a hash, applied to 8 byte words rather than single bytes
+ */
+class Checksum
+{
+public:
+    Checksum() : hash(14695981039346656037ULL)
+    {
+    }
+
+    /** @param size must be a multiple of 8 except for the last block */
+    void update(const char* data, std::size_t size)
+    {
+        uint64_t word;
+        for (std::size_t pos = 0; pos < size; pos += sizeof(word))
+        {
+            word = 0;
+            std::memcpy(&word, data + pos, std::min(sizeof(word), size - pos));
+            hash ^= word;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    uint64_t get() const
+    {
+        return hash;
+    }
+
+private:
+    uint64_t hash;
+};
+
+void writePadding(std::ostream& os)
+{
+    const char padding[8] = { 0 };
+    os.write(padding, (8 - static_cast<std::streamoff>(os.tellp()) % 8) % 8);
+}
+
+template<typename T>
+void writeSection(std::ostream& os, const std::vector<T>& records)
+{
+    uint64_t count = records.size();
+    os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    if (!records.empty())
+    {
+        os.write(reinterpret_cast<const char*>(&records[0]), records.size() * sizeof(T));
+    }
+    writePadding(os);
+}
+}
+
+PredayDataCache::PredayDataCache()
+{
+}
+
+PredayDataCache::~PredayDataCache()
+{
+}
+
+std::string PredayDataCache::computeSourceKey(db::DB_Connection& conn)
+{
+    ConfigParams& config = ConfigManager::GetInstanceRW().FullConfig();
+    const Schemas& schemas = config.schemas;
+    std::stringstream key;
+    key << "main_schema=" << schemas.main_schema << ";calibration_schema=" << schemas.calibration_schema << ";public_schema="
+            << schemas.public_schema << ";demand_schema=" << schemas.demand_schema;
+
+    soci::session& session = conn.getSession<soci::session>();
+    for (std::size_t i = 0; i < sizeof(SOURCE_TABLES) / sizeof(SOURCE_TABLES[0]); ++i)
+    {
+        const std::string table = APPLY_SCHEMA(schemas.demand_schema, config.dbTableNamesMap[SOURCE_TABLES[i]]);
+        long long numRows = 0;
+        session << "SELECT COUNT(*) FROM " + table, soci::into(numRows);
+        key << ";" << SOURCE_TABLES[i] << "=" << table << ":" << numRows;
+    }
+    return key.str();
+}
+
+bool PredayDataCache::open(const std::string& fileName, const std::string& sourceKey, std::string& reason)
+{
+    close();
+
+    boost::shared_ptr<boost::interprocess::mapped_region> fileRegion;
+    try
+    {
+        boost::interprocess::file_mapping mapping(fileName.c_str(), boost::interprocess::read_only);
+        fileRegion.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& ex)
+    {
+        reason = "could not map " + fileName + ": " + ex.what();
+        return false;
+    }
+
+    const char* base = static_cast<const char*>(fileRegion->get_address());
+    const std::size_t size = fileRegion->get_size();
+    CacheFileHeader header;
+    if (size < sizeof(header))
+    {
+        reason = fileName + " is truncated";
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != CACHE_FILE_VERSION
+            || header.numSections != NUM_SECTIONS)
+    {
+        reason = fileName + " is not a preday data cache of version " + std::to_string(CACHE_FILE_VERSION);
+        return false;
+    }
+    if (header.fileSize != size)
+    {
+        reason = fileName + " is truncated";
+        return false;
+    }
+
+    Checksum checksum;
+    checksum.update(base + sizeof(header), size - sizeof(header));
+    if (checksum.get() != header.checksum)
+    {
+        reason = fileName + " is corrupt (checksum mismatch)";
+        return false;
+    }
+
+    std::vector<std::size_t> offsets(header.sectionOffsets, header.sectionOffsets + NUM_SECTIONS);
+    for (std::size_t i = 0; i < offsets.size(); ++i)
+    {
+        if (offsets[i] < sizeof(header) || offsets[i] % 8 != 0 || offsets[i] + sizeof(uint64_t) > size)
+        {
+            reason = fileName + " is corrupt (invalid section offset)";
+            return false;
+        }
+    }
+
+    region = fileRegion;
+    sectionOffsets.swap(offsets);
+
+    std::size_t keyLength = 0;
+    const char* key = getSection(SOURCE_KEY, sizeof(char), keyLength);
+    if (std::string(key, keyLength) != sourceKey)
+    {
+        reason = fileName + " is stale; it was exported from " + std::string(key, keyLength);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PredayDataCache::close()
+{
+    region.reset();
+    sectionOffsets.clear();
+}
+
+const char* PredayDataCache::getSection(unsigned int section, std::size_t recordSize, std::size_t& outCount) const
+{
+    if (!isOpen())
+    {
+        throw std::runtime_error("PredayDataCache: no cache file is open");
+    }
+    const char* start = static_cast<const char*>(region->get_address()) + sectionOffsets[section];
+    uint64_t count = 0;
+    std::memcpy(&count, start, sizeof(count));
+    if (count > (region->get_size() - sectionOffsets[section] - sizeof(count)) / recordSize)
+    {
+        std::stringstream msg;
+        msg << "PredayDataCache: section " << section << " overruns the cache file";
+        throw std::runtime_error(msg.str());
+    }
+    outCount = count;
+    return start + sizeof(count);
+}
+
+void PredayDataCache::loadZones(ZoneMap& outZones, std::unordered_set<int>& outZonesWithoutNode) const
+{
+    std::size_t count = 0;
+    const ZoneRecord* zones = reinterpret_cast<const ZoneRecord*>(getSection(ZONES, sizeof(ZoneRecord), count));
+    for (const ZoneRecord* record = zones; record != zones + count; ++record)
+    {
+        ZoneParams* zone = new ZoneParams();
+        zone->setZoneId(record->zoneId);
+        zone->setZoneCode(record->zoneCode);
+        zone->setArea(record->area);
+        zone->setPopulation(record->population);
+        zone->setShop(record->shop);
+        zone->setCentralDummy(record->centralDummy > 0);
+        zone->setParkingRate(record->parkingRate);
+        zone->setResidentWorkers(record->residentWorkers);
+        zone->setEmployment(record->employment);
+        zone->setTotalEnrollment(record->totalEnrollment);
+        zone->setResidentStudents(record->residentStudents);
+        zone->setCbdDummy(record->cbdDummy);
+        outZones[zone->getZoneId()] = zone;
+    }
+
+    const int32_t* zonesWithoutNode = reinterpret_cast<const int32_t*>(getSection(ZONES_WITHOUT_NODE, sizeof(int32_t), count));
+    outZonesWithoutNode.insert(zonesWithoutNode, zonesWithoutNode + count);
+}
+
+void PredayDataCache::loadZoneNodes(ZoneNodeMap& outZoneNodes) const
+{
+    std::size_t count = 0;
+    const ZoneNodeRecord* nodes = reinterpret_cast<const ZoneNodeRecord*>(getSection(ZONE_NODES, sizeof(ZoneNodeRecord), count));
+    for (const ZoneNodeRecord* record = nodes; record != nodes + count; ++record)
+    {
+        ZoneNodeParams* zoneNodeParams = new ZoneNodeParams();
+        zoneNodeParams->setZone(record->zone);
+        zoneNodeParams->setNodeId(record->nodeId);
+        zoneNodeParams->setNodeType(record->nodeType);
+        zoneNodeParams->setSourceNode(record->sourceNode);
+        zoneNodeParams->setSinkNode(record->sinkNode);
+        zoneNodeParams->setBusTerminusNode(record->busTerminusNode);
+        outZoneNodes[record->zone].push_back(zoneNodeParams);
+    }
+}
+
+void PredayDataCache::loadUnavailableODs(std::vector<OD_Pair>& outODs) const
+{
+    std::size_t count = 0;
+    const OD_Record* ods = reinterpret_cast<const OD_Record*>(getSection(UNAVAILABLE_ODS, sizeof(OD_Record), count));
+    outODs.reserve(outODs.size() + count);
+    for (const OD_Record* record = ods; record != ods + count; ++record)
+    {
+        outODs.push_back(OD_Pair(record->origin, record->destination));
+    }
+}
+
+void PredayDataCache::loadCosts(SkimMatrix& amCosts, SkimMatrix& pmCosts, SkimMatrix& opCosts) const
+{
+    if (!isOpen())
+    {
+        throw std::runtime_error("PredayDataCache: no cache file is open");
+    }
+    amCosts.map(region, sectionOffsets[AM_COSTS]);
+    pmCosts.map(region, sectionOffsets[PM_COSTS]);
+    opCosts.map(region, sectionOffsets[OP_COSTS]);
+}
+
+void PredayDataCache::save(const std::string& fileName, const std::string& sourceKey, const ZoneMap& zones,
+        const std::unordered_set<int>& zonesWithoutNode, const ZoneNodeMap& zoneNodes, const std::vector<OD_Pair>& unavailableODs,
+        const SkimMatrix& amCosts, const SkimMatrix& pmCosts, const SkimMatrix& opCosts)
+{
+    const std::string tmpFileName = fileName + ".tmp";
+    std::fstream file(tmpFileName.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("PredayDataCache: could not open " + tmpFileName + " for writing");
+    }
+
+    CacheFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_FILE_VERSION;
+    header.numSections = NUM_SECTIONS;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    header.sectionOffsets[SOURCE_KEY] = file.tellp();
+    writeSection(file, std::vector<char>(sourceKey.begin(), sourceKey.end()));
+
+    //zones are written in zone id order so that the file only depends on the data
+    std::vector<ZoneRecord> zoneRecords;
+    zoneRecords.reserve(zones.size());
+    for (ZoneMap::const_iterator it = zones.begin(); it != zones.end(); ++it)
+    {
+        const ZoneParams* zone = it->second;
+        ZoneRecord record;
+        record.zoneId = zone->getZoneId();
+        record.zoneCode = zone->getZoneCode();
+        record.centralDummy = zone->getCentralDummy();
+        record.cbdDummy = zone->getCbdDummy();
+        record.area = zone->getArea();
+        record.population = zone->getPopulation();
+        record.shop = zone->getShop();
+        record.parkingRate = zone->getParkingRate();
+        record.residentWorkers = zone->getResidentWorkers();
+        record.employment = zone->getEmployment();
+        record.totalEnrollment = zone->getTotalEnrollment();
+        record.residentStudents = zone->getResidentStudents();
+        zoneRecords.push_back(record);
+    }
+    std::sort(zoneRecords.begin(), zoneRecords.end(), [](const ZoneRecord& lhs, const ZoneRecord& rhs)
+    {
+        return lhs.zoneId < rhs.zoneId;
+    });
+    header.sectionOffsets[ZONES] = file.tellp();
+    writeSection(file, zoneRecords);
+
+    std::vector<int32_t> zoneWithoutNodeRecords(zonesWithoutNode.begin(), zonesWithoutNode.end());
+    std::sort(zoneWithoutNodeRecords.begin(), zoneWithoutNodeRecords.end());
+    header.sectionOffsets[ZONES_WITHOUT_NODE] = file.tellp();
+    writeSection(file, zoneWithoutNodeRecords);
+
+    std::vector<ZoneNodeRecord> zoneNodeRecords;
+    for (ZoneNodeMap::const_iterator it = zoneNodes.begin(); it != zoneNodes.end(); ++it)
+    {
+        for (std::vector<ZoneNodeParams*>::const_iterator ndIt = it->second.begin(); ndIt != it->second.end(); ++ndIt)
+        {
+            ZoneNodeRecord record;
+            record.zone = (*ndIt)->getZone();
+            record.nodeId = (*ndIt)->getNodeId();
+            record.nodeType = (*ndIt)->getNodeType();
+            record.sourceNode = (*ndIt)->isSourceNode();
+            record.sinkNode = (*ndIt)->isSinkNode();
+            record.busTerminusNode = (*ndIt)->isBusTerminusNode();
+            record.unused = 0;
+            zoneNodeRecords.push_back(record);
+        }
+    }
+    header.sectionOffsets[ZONE_NODES] = file.tellp();
+    writeSection(file, zoneNodeRecords);
+
+    std::vector<OD_Record> odRecords;
+    odRecords.reserve(unavailableODs.size());
+    for (std::vector<OD_Pair>::const_iterator it = unavailableODs.begin(); it != unavailableODs.end(); ++it)
+    {
+        OD_Record record;
+        record.origin = it->getOrigin();
+        record.destination = it->getDestination();
+        odRecords.push_back(record);
+    }
+    header.sectionOffsets[UNAVAILABLE_ODS] = file.tellp();
+    writeSection(file, odRecords);
+
+    header.sectionOffsets[AM_COSTS] = file.tellp();
+    amCosts.write(file);
+    header.sectionOffsets[PM_COSTS] = file.tellp();
+    pmCosts.write(file);
+    header.sectionOffsets[OP_COSTS] = file.tellp();
+    opCosts.write(file);
+    header.fileSize = file.tellp();
+
+    //checksum the payload by reading it back
+    file.flush();
+    file.seekg(sizeof(header));
+    Checksum checksum;
+    std::vector<char> buffer(1 << 20);
+    while (file.read(&buffer[0], buffer.size()) || file.gcount() > 0)
+    {
+        checksum.update(&buffer[0], file.gcount());
+    }
+    file.clear();
+    header.checksum = checksum.get();
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (file.fail())
+    {
+        std::remove(tmpFileName.c_str());
+        throw std::runtime_error("PredayDataCache: error writing " + tmpFileName);
+    }
+    if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(tmpFileName.c_str());
+        throw std::runtime_error("PredayDataCache: could not replace " + fileName);
+    }
+}
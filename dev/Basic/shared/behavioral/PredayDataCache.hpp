@@ -0,0 +1,136 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "behavioral/params/SkimMatrix.hpp"
+#include "behavioral/params/ZoneCostParams.hpp"
+#include "behavioral/PredayUtils.hpp"
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace sim_mob
+{
+namespace db
+{
+class DB_Connection;
+}
+
+/**
+ * Binary cache of the zone and skim data which preday loads from the database at startup.
+ *
+ * The cache file holds the zones, the zones without nodes, the zone to node mapping, the unavailable OD pairs and
+ * the AM, PM and off peak skims. It is memory mapped read-only when opened; the skims are used in place from the
+ * mapping (see SkimMatrix::map()) while the other sections, which are small, are copied into the usual containers.
+ *
+ * Every file carries a source key describing the data it was exported from (schema names, table names and row
+ * counts of the source tables, see computeSourceKey()) along with a checksum of its contents. A file whose key
+ * does not match the current configuration and database, or whose checksum is wrong, is rejected by open();
+ * the caller is expected to load from the database and export a fresh file with save().
+ */
+class PredayDataCache
+{
+public:
+    typedef boost::unordered_map<int, ZoneParams*> ZoneMap;
+    typedef boost::unordered_map<int, std::vector<ZoneNodeParams*> > ZoneNodeMap;
+
+    PredayDataCache();
+    ~PredayDataCache();
+
+    /**
+     * builds the source key of the current configuration by counting the rows of every source table
+     * @param conn open connection to the database holding the source tables
+     * @return source key
+     */
+    static std::string computeSourceKey(db::DB_Connection& conn);
+
+    /**
+     * maps and validates a cache file. Any previously opened file is closed.
+     * @param fileName path of the cache file
+     * @param sourceKey expected source key
+     * @param reason output: why the file was rejected, if it was
+     * @return true if the file exists, is intact and matches sourceKey; false otherwise
+     */
+    bool open(const std::string& fileName, const std::string& sourceKey, std::string& reason);
+
+    bool isOpen() const
+    {
+        return region.get() != nullptr;
+    }
+
+    /**
+     * releases the mapping. Skim matrices filled by loadCosts() keep their own reference to it.
+     */
+    void close();
+
+    /**
+     * copies the zones out of the cache
+     * @param outZones output zone id -> zone map; the zones are allocated with new and owned by the caller
+     * @param outZonesWithoutNode output set of zones without nodes
+     */
+    void loadZones(ZoneMap& outZones, std::unordered_set<int>& outZonesWithoutNode) const;
+
+    /**
+     * copies the zone to node mapping out of the cache
+     * @param outZoneNodes output zone code -> nodes map; the nodes are allocated with new and owned by the caller
+     */
+    void loadZoneNodes(ZoneNodeMap& outZoneNodes) const;
+
+    /**
+     * copies the unavailable OD pairs out of the cache
+     * @param outODs output OD pairs, in sorted order
+     */
+    void loadUnavailableODs(std::vector<OD_Pair>& outODs) const;
+
+    /**
+     * maps the skims of the cache
+     * @param amCosts output AM skims
+     * @param pmCosts output PM skims
+     * @param opCosts output off peak skims
+     */
+    void loadCosts(SkimMatrix& amCosts, SkimMatrix& pmCosts, SkimMatrix& opCosts) const;
+
+    /**
+     * exports data to a cache file. The file is first written under a temporary name and then renamed,
+     * so that a concurrent reader never sees a partially written file.
+     * @param fileName path of the cache file
+     * @param sourceKey source key of the data
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void save(const std::string& fileName, const std::string& sourceKey, const ZoneMap& zones,
+            const std::unordered_set<int>& zonesWithoutNode, const ZoneNodeMap& zoneNodes, const std::vector<OD_Pair>& unavailableODs,
+            const SkimMatrix& amCosts, const SkimMatrix& pmCosts, const SkimMatrix& opCosts);
+
+private:
+    PredayDataCache(const PredayDataCache&);
+    PredayDataCache& operator=(const PredayDataCache&);
+
+    /**
+     * @param section section number
+     * @param recordSize size of each record of the section
+     * @param outCount output number of records in the section
+     * @return start of the first record of the section
+     */
+    const char* getSection(unsigned int section, std::size_t recordSize, std::size_t& outCount) const;
+
+    /** mapping of the open cache file */
+    boost::shared_ptr<boost::interprocess::mapped_region> region;
+
+    /** offset of each section in the mapping */
+    std::vector<std::size_t> sectionOffsets;
+};
+
+}
@@ -90,38 +90,9 @@ sim_mob::PredayLT_LogsumManager::~PredayLT_LogsumManager()
 		}
 		zoneMap.clear();
 
-		// clear AMCosts
-		//Print() << "Clearing amCostMap" << std::endl;
-		for(CostMap::iterator i = amCostMap.begin(); i!=amCostMap.end(); i++) {
-			for(boost::unordered_map<int, CostParams*>::iterator j = i->second.begin(); j!=i->second.end(); j++) {
-				if(j->second) {
-					delete j->second;
-				}
-			}
-		}
-		amCostMap.clear();
-
-		// clear PMCosts
-		//Print() << "Clearing pmCostMap" << std::endl;
-		for(CostMap::iterator i = pmCostMap.begin(); i!=pmCostMap.end(); i++) {
-			for(boost::unordered_map<int, CostParams*>::iterator j = i->second.begin(); j!=i->second.end(); j++) {
-				if(j->second) {
-					delete j->second;
-				}
-			}
-		}
-		pmCostMap.clear();
-
-		// clear OPCosts
-		//Print() << "Clearing opCostMap" << std::endl;
-		for(CostMap::iterator i = opCostMap.begin(); i!=opCostMap.end(); i++) {
-			for(boost::unordered_map<int, CostParams*>::iterator j = i->second.begin(); j!=i->second.end(); j++) {
-				if(j->second) {
-					delete j->second;
-				}
-			}
-		}
-		opCostMap.clear();
+		amCosts.clear();
+		pmCosts.clear();
+		opCosts.clear();
 	}
 }
 
@@ -177,22 +148,25 @@ void sim_mob::PredayLT_LogsumManager::loadCosts()
 		const std::string DB_TABLE_AM_COSTS = APPLY_SCHEMA(DEMAND_SCHEMA, TABLE_NAME);
 		const std::string DB_GET_ALL_AM_COSTS = "SELECT * FROM " + DB_TABLE_AM_COSTS;
 		CostSqlDao amCostDao(mtDbConnection, DB_GET_ALL_AM_COSTS);
-		amCostDao.getAll(amCostMap);
-		Print() << "AM costs loaded " << amCostMap.size() << std::endl;
+		amCosts.initialize(zoneIdLookup);
+		amCostDao.getAll(amCosts);
+		Print() << "AM costs loaded " << amCosts.getNumODs() << std::endl;
 
 		TABLE_NAME = ConfigManager::GetInstanceRW().FullConfig().dbTableNamesMap["PM_cost_table"];
 		const std::string DB_TABLE_PM_COSTS = APPLY_SCHEMA(DEMAND_SCHEMA, TABLE_NAME);
 		const std::string DB_GET_ALL_PM_COSTS = "SELECT * FROM " + DB_TABLE_PM_COSTS;
 		CostSqlDao pmCostDao(mtDbConnection, DB_GET_ALL_PM_COSTS);
-		pmCostDao.getAll(pmCostMap);
-		Print() << "PM costs loaded " << pmCostMap.size() << std::endl;
+		pmCosts.initialize(zoneIdLookup);
+		pmCostDao.getAll(pmCosts);
+		Print() << "PM costs loaded " << pmCosts.getNumODs() << std::endl;
 
 		TABLE_NAME = ConfigManager::GetInstanceRW().FullConfig().dbTableNamesMap["OP_cost_table"];
 		const std::string DB_TABLE_OP_COSTS = APPLY_SCHEMA(DEMAND_SCHEMA, TABLE_NAME);
 		const std::string DB_GET_ALL_OP_COSTS = "SELECT * FROM " + DB_TABLE_PM_COSTS;
 		CostSqlDao opCostDao(mtDbConnection, DB_GET_ALL_OP_COSTS);
-		opCostDao.getAll(opCostMap);
-		Print() << "OP costs loaded " << opCostMap.size() << std::endl;
+		opCosts.initialize(zoneIdLookup);
+		opCostDao.getAll(opCosts);
+		Print() << "OP costs loaded " << opCosts.getNumODs() << std::endl;
 	}
 	else
 	{
@@ -267,7 +241,7 @@ PersonParams sim_mob::PredayLT_LogsumManager::computeLogsum(long individualId, i
 	personParams.setActivityLogsum(1,0);
 	personParams.setActivityLogsum(2,0);
 
-	LogsumTourModeDestinationParams tmdParams(zoneMap, amCostMap, pmCostMap, personParams, NULL_STOP, cfg.getNumTravelModes());
+	LogsumTourModeDestinationParams tmdParams(zoneMap, amCosts, pmCosts, personParams, NULL_STOP, cfg.getNumTravelModes());
 	PredayLogsumLuaProvider::getPredayModel(luaDir).computeTourModeDestinationLogsum(personParams, cfg.getActivityTypeConfigMap(), tmdParams, zoneMap.size());
 
 	if(personParams.hasFixedWorkPlace() || personParams.isStudent())
@@ -275,8 +249,9 @@ PersonParams sim_mob::PredayLT_LogsumManager::computeLogsum(long individualId, i
 		int workLoc = workLoc = personParams.getFixedWorkLocation();
 		ZoneParams* orgZnParams = nullptr;
 		ZoneParams* destZnParams = nullptr;
-		CostParams* amCostParams = nullptr;
-		CostParams* pmCostParams = nullptr;
+		CostParams amCostParams = CostParams();
+		CostParams pmCostParams = CostParams();
+		bool hasCosts = false;
 
 		try
 		{
@@ -306,14 +281,13 @@ PersonParams sim_mob::PredayLT_LogsumManager::computeLogsum(long individualId, i
 
 		if(homeLoc != workLoc)
 		{
+			hasCosts = true;
 			try
 			{
-				amCostParams = amCostMap.at(homeLoc).at(workLoc);
+				amCosts.getCostParams(homeLoc, workLoc, amCostParams);
 			}
 			catch(...)
 			{
-				amCostParams = new CostParams();
-
 				//if( !printedError )
 				//	std::cout << "individualId: " << individualId << " " << workLoc << " or " << homeLoc << " taz cannot be found. amcostparam" << std::endl;
 
@@ -322,12 +296,10 @@ PersonParams sim_mob::PredayLT_LogsumManager::computeLogsum(long individualId, i
 
 			try
 			{
-				pmCostParams = pmCostMap.at(workLoc).at(homeLoc);
+				pmCosts.getCostParams(workLoc, homeLoc, pmCostParams);
 			}
 			catch(...)
 			{
-				pmCostParams = new CostParams();
-
 				//if( !printedError )
 				//	std::cout << "individualId: " << individualId << " " << workLoc << " or " << homeLoc << " taz cannot be found. pmcostparam" << std::endl;
 
@@ -338,13 +310,13 @@ PersonParams sim_mob::PredayLT_LogsumManager::computeLogsum(long individualId, i
 
 		if(personParams.hasFixedWorkPlace())
 		{
-			LogsumTourModeParams tmParams(orgZnParams, destZnParams, amCostParams, pmCostParams, personParams, cfg.getActivityTypeId("Work"));
+			LogsumTourModeParams tmParams(orgZnParams, destZnParams, hasCosts ? &amCostParams : nullptr, hasCosts ? &pmCostParams : nullptr, personParams, cfg.getActivityTypeId("Work"));
 			PredayLogsumLuaProvider::getPredayModel(luaDir).computeTourModeLogsum(personParams, cfg.getActivityTypeConfigMap(), tmParams);
 		}
 
         if(personParams.isStudent())
         {
-        	LogsumTourModeParams tmParams(orgZnParams, destZnParams, amCostParams, pmCostParams, personParams, cfg.getActivityTypeId("Education"));
+        	LogsumTourModeParams tmParams(orgZnParams, destZnParams, hasCosts ? &amCostParams : nullptr, hasCosts ? &pmCostParams : nullptr, personParams, cfg.getActivityTypeId("Education"));
         	PredayLogsumLuaProvider::getPredayModel(luaDir).computeTourModeLogsum(personParams, cfg.getActivityTypeConfigMap(), tmParams);
         }
 
@@ -8,6 +8,7 @@
 #include <boost/unordered_map.hpp>
 #include <vector>
 #include "params/PersonParams.hpp"
+#include "params/SkimMatrix.hpp"
 #include "params/ZoneCostParams.hpp"
 
 namespace sim_mob
@@ -21,7 +22,6 @@ class PredayLT_LogsumManager : boost::noncopyable
 {
 private:
     typedef boost::unordered_map<int, ZoneParams*> ZoneMap;
-    typedef boost::unordered_map<int, boost::unordered_map<int, CostParams*> > CostMap;
 
     /**
      * private instance of this class
@@ -36,12 +36,12 @@ private:
     boost::unordered_map<int,int> zoneIdLookup;
 
     /**
-     * Map of AM, PM and Off peak Costs [origin zone, destination zone] -> CostParams*
-     * \note these maps have (1092 zones * 1092 zones - 1092 (entries with same origin and destination is not available)) 1191372 elements
+     * AM, PM and Off peak skims indexed by [origin zone, destination zone]
+     * \note costs are available for (1092 zones * 1092 zones - 1092 (entries with same origin and destination are not available)) 1191372 OD pairs
      */
-    CostMap amCostMap;
-    CostMap pmCostMap;
-    CostMap opCostMap;
+    SkimMatrix amCosts;
+    SkimMatrix pmCosts;
+    SkimMatrix opCosts;
 
     bool dataLoadReqd;
 
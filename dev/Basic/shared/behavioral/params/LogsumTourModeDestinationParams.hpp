@@ -18,7 +18,7 @@ namespace sim_mob
 class LogsumTourModeDestinationParams: public ModeDestinationParams
 {
 public:
-    LogsumTourModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, const CostMap& pmCostsMap, const PersonParams& personParams,
+    LogsumTourModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, const SkimMatrix& pmCosts, const PersonParams& personParams,
                         StopType tourType, int numModes);
     virtual ~LogsumTourModeDestinationParams();
 
@@ -155,10 +155,10 @@ void setTourModeAvailability(const PersonParams& personParams, int numModes, std
 
 }
 
-ModeDestinationParams::ModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, 
-	const CostMap& pmCostsMap, StopType purpose, int originCode, const VehicleParams::VehicleDriveTrain& powerTrain, 
+ModeDestinationParams::ModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, 
+	const SkimMatrix& pmCosts, StopType purpose, int originCode, const VehicleParams::VehicleDriveTrain& powerTrain, 
 	int numModes, const std::vector<OD_Pair>& unavailableODs):
-		zoneMap(zoneMap), amCostsMap(amCostsMap), pmCostsMap(pmCostsMap), purpose(purpose), origin(originCode), 
+		zoneMap(zoneMap), amCosts(amCosts), pmCosts(pmCosts), purpose(purpose), origin(originCode), 
 		powertrain(powerTrain), MAX_WALKING_DISTANCE(3), cbdOrgZone(false), unavailableODs(unavailableODs), numModes(numModes)
 {
 }
@@ -198,9 +198,9 @@ bool sim_mob::ModeDestinationParams::isUnavailable(int origin, int destination)
 	return binary_search(unavailableODs.begin(), unavailableODs.end(), orgDest);
 }
 
-LogsumTourModeDestinationParams::LogsumTourModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, 
-	const CostMap& pmCostsMap, const PersonParams& personParams, StopType tourType, int numModes):
-		ModeDestinationParams(zoneMap, amCostsMap, pmCostsMap, tourType, personParams.getHomeLocation(),
+LogsumTourModeDestinationParams::LogsumTourModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, 
+	const SkimMatrix& pmCosts, const PersonParams& personParams, StopType tourType, int numModes):
+		ModeDestinationParams(zoneMap, amCosts, pmCosts, tourType, personParams.getHomeLocation(),
 		personParams.getConstVehicleParams().getDrivetrain(), // Eytan 28-May-2018
 		numModes, unavailableODsDummy), modeForParentWorkTour(0), costIncrease(1)
 {
@@ -224,7 +224,7 @@ double LogsumTourModeDestinationParams::getCostPublicFirst(int zoneId) const
 
 	try
 	{
-		result = amCostsMap.at(origin).at(destination)->getPubCost();
+		result = amCosts.at(origin, destination).getPubCost();
 	}
 	catch(...)
 	{
@@ -246,7 +246,7 @@ double LogsumTourModeDestinationParams::getCostPublicSecond(int zoneId) const
 
 	try
 	{
-		result = pmCostsMap.at(destination).at(origin)->getPubCost();
+		result = pmCosts.at(destination, origin).getPubCost();
 	}
 	catch(...)
 	{
@@ -269,7 +269,7 @@ double LogsumTourModeDestinationParams::getCostCarERPFirst(int zoneId) const
 
 	try
 	{
-		result = amCostsMap.at(origin).at(destination)->getCarCostErp();
+		result = amCosts.at(origin, destination).getCarCostErp();
 	}
 	catch(...)
 	{
@@ -291,7 +291,7 @@ double LogsumTourModeDestinationParams::getCostCarERPSecond(int zoneId) const
 
 	try
 	{
-		result = pmCostsMap.at(destination).at(origin)->getCarCostErp();
+		result = pmCosts.at(destination, origin).getCarCostErp();
 	}
 	catch(...)
 	{
@@ -326,7 +326,7 @@ double LogsumTourModeDestinationParams::getCostCarOPFirst(int zoneId) const
 	}
 	try
 	{
-		result = (amCostsMap.at(origin).at(destination)->getDistance() * operationalCost); //jo
+		result = (amCosts.at(origin, destination).getDistance() * operationalCost); //jo
 	}
 	catch(...)
 	{
@@ -361,7 +361,7 @@ double LogsumTourModeDestinationParams::getCostCarOPSecond(int zoneId) const
 	}
 	try
 	{
-		result = (pmCostsMap.at(destination).at(origin)->getDistance() * operationalCost); //jo
+		result = (pmCosts.at(destination, origin).getDistance() * operationalCost); //jo
 	}
 	catch(...)
 	{
@@ -399,7 +399,7 @@ double LogsumTourModeDestinationParams::getWalkDistance1(int zoneId) const
 
 	try
 	{
-		result = amCostsMap.at(origin).at(destination)->getPubWalkt();
+		result = amCosts.at(origin, destination).getPubWalkt();
 	}
 	catch(...)
 	{
@@ -421,7 +421,7 @@ double LogsumTourModeDestinationParams::getWalkDistance2(int zoneId) const
 
 	try
 	{
-		result = pmCostsMap.at(destination).at(origin)->getPubWalkt();
+		result = pmCosts.at(destination, origin).getPubWalkt();
 	}
 	catch(...)
 	{
@@ -443,7 +443,7 @@ double LogsumTourModeDestinationParams::getTT_PublicIvtFirst(int zoneId)
 
 	try
 	{
-		result = amCostsMap.at(origin).at(destination)->getPubIvt();
+		result = amCosts.at(origin, destination).getPubIvt();
 	}
 	catch(...)
 	{
@@ -465,7 +465,7 @@ double LogsumTourModeDestinationParams::getTT_PublicIvtSecond(int zoneId) const
 
 	try
 	{
-		result = pmCostsMap.at(destination).at(origin)->getPubIvt();
+		result = pmCosts.at(destination, origin).getPubIvt();
 	}
 	catch(...)
 	{
@@ -487,7 +487,7 @@ double LogsumTourModeDestinationParams::getTT_CarIvtFirst(int zoneId) const
 
 	try
 	{
-		result = amCostsMap.at(origin).at(destination)->getCarIvt();
+		result = amCosts.at(origin, destination).getCarIvt();
 	}
 	catch(...)
 	{
@@ -509,7 +509,7 @@ double LogsumTourModeDestinationParams::getTT_CarIvtSecond(int zoneId) const
 
 	try
 	{
-		result = pmCostsMap.at(destination).at(origin)->getCarIvt();
+		result = pmCosts.at(destination, origin).getCarIvt();
 	}
 	catch(...)
 	{
@@ -531,7 +531,7 @@ double LogsumTourModeDestinationParams::getTT_PublicOutFirst(int zoneId) const
 
 	try
 	{
-		result = amCostsMap.at(origin).at(destination)->getPubOut();
+		result = amCosts.at(origin, destination).getPubOut();
 	}
 	catch(...)
 	{
@@ -553,7 +553,7 @@ double LogsumTourModeDestinationParams::getTT_PublicOutSecond(int zoneId) const
 
 	try
 	{
-		result = pmCostsMap.at(destination).at(origin)->getPubOut();
+		result = pmCosts.at(destination, origin).getPubOut();
 	}
 	catch(...)
 	{
@@ -575,7 +575,7 @@ double LogsumTourModeDestinationParams::getAvgTransferNumber(int zoneId) const
 
 	try
 	{
-		result = (amCostsMap.at(origin).at(destination)->getAvgTransfer() + pmCostsMap.at(destination).at(origin)->getAvgTransfer()) / 2;
+		result = (amCosts.at(origin, destination).getAvgTransfer() + pmCosts.at(destination, origin).getAvgTransfer()) / 2;
 	}
 	catch(...)
 	{
@@ -727,7 +727,7 @@ int LogsumTourModeDestinationParams::isAvailable_TMD(int choiceId) const
 
         try
         {
-            result = pmCostsMap.at(destination).at(origin)->getPubIvt() > 0 && amCostsMap.at(origin).at(destination)->getPubIvt() > 0;
+            result = pmCosts.at(destination, origin).getPubIvt() > 0 && amCosts.at(origin, destination).getPubIvt() > 0;
         }
         catch(...){}
 
@@ -768,8 +768,8 @@ int LogsumTourModeDestinationParams::isAvailable_TMD(int choiceId) const
 
         try
         {
-            result =  (amCostsMap.at(origin).at(destination)->getDistance() <= MAX_WALKING_DISTANCE
-                    && pmCostsMap.at(destination).at(origin)->getDistance() <= MAX_WALKING_DISTANCE);
+            result =  (amCosts.at(origin, destination).getDistance() <= MAX_WALKING_DISTANCE
+                    && pmCosts.at(destination, origin).getDistance() <= MAX_WALKING_DISTANCE);
         }
         catch(...){}
 
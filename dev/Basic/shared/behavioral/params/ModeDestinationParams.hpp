@@ -6,6 +6,7 @@
 #include <boost/unordered_map.hpp>
 #include <map>
 #include <vector>
+#include "behavioral/params/SkimMatrix.hpp"
 #include "behavioral/params/ZoneCostParams.hpp"
 #include "behavioral/PredayUtils.hpp"
 #include "behavioral/StopType.hpp"
@@ -23,21 +24,20 @@ class ModeDestinationParams
 {
 protected:
 	typedef boost::unordered_map<int, ZoneParams*> ZoneMap;
-	typedef boost::unordered_map<int, boost::unordered_map<int, CostParams*> > CostMap;
 
 	StopType purpose;
 	int origin;
 	const double MAX_WALKING_DISTANCE;
 	const ZoneMap& zoneMap;
-	const CostMap& amCostsMap;
-	const CostMap& pmCostsMap;
+	const SkimMatrix& amCosts;
+	const SkimMatrix& pmCosts;
 	int cbdOrgZone;
 	const std::vector<OD_Pair>& unavailableODs;
 	int numModes;
 	const VehicleParams::VehicleDriveTrain& powertrain;
 
 public:
-	ModeDestinationParams(const ZoneMap& zoneMap, const CostMap& amCostsMap, const CostMap& pmCostsMap, 
+	ModeDestinationParams(const ZoneMap& zoneMap, const SkimMatrix& amCosts, const SkimMatrix& pmCosts, 
 		StopType purpose, int originCode, const VehicleParams::VehicleDriveTrain& powerTrain, // Eytan 28-May 2018
 		int numModes, const std::vector<OD_Pair>& unavailableODs);
 	virtual ~ModeDestinationParams();
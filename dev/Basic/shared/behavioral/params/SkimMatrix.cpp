@@ -0,0 +1,318 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "SkimMatrix.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+#include <utility>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+using namespace sim_mob;
+
+namespace
+{
+const char SKIM_FILE_MAGIC[8] = { 'S', 'M', 'S', 'K', 'I', 'M', '\0', '\0' };
+const uint32_t SKIM_FILE_VERSION = 2;
+
+/**
+ * Header of a skim matrix file. It is followed by
+ *  numZones int32 zone codes,
+ *  numZones^2 availability flags (one byte each),
+ *  padding up to valuesOffset, and
+ *  numAttributes * numZones^2 double values.
+ */
+struct SkimFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numZones;
+    uint32_t numAttributes;
+    uint32_t valueSize;
+    uint64_t valuesOffset;
+};
+
+uint64_t getValuesOffset(uint32_t numZones)
+{
+    uint64_t offset = sizeof(SkimFileHeader) + sizeof(int32_t) * numZones + static_cast<uint64_t>(numZones) * numZones;
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+/** size of a matrix including the padding which keeps whatever follows it 8 byte aligned */
+uint64_t getBlockSize(uint32_t numZones)
+{
+    uint64_t size = getValuesOffset(numZones) + SkimMatrix::NUM_ATTRIBUTES * sizeof(double) * static_cast<uint64_t>(numZones) * numZones;
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
+}
+
+SkimMatrix::SkimMatrix() : numCells(0), values(nullptr), availability(nullptr)
+{
+}
+
+SkimMatrix::~SkimMatrix()
+{
+}
+
+void SkimMatrix::initialize(const boost::unordered_map<int, int>& zoneIdLookup)
+{
+    std::vector< std::pair<int, int> > idCodePairs;
+    idCodePairs.reserve(zoneIdLookup.size());
+    for (boost::unordered_map<int, int>::const_iterator it = zoneIdLookup.begin(); it != zoneIdLookup.end(); ++it)
+    {
+        idCodePairs.push_back(std::make_pair(it->second, it->first));
+    }
+    std::sort(idCodePairs.begin(), idCodePairs.end());
+
+    std::vector<int> codes;
+    codes.reserve(idCodePairs.size());
+    for (std::vector< std::pair<int, int> >::const_iterator it = idCodePairs.begin(); it != idCodePairs.end(); ++it)
+    {
+        codes.push_back(it->second);
+    }
+    initialize(codes);
+}
+
+void SkimMatrix::initialize(const std::vector<int>& codes)
+{
+    clear();
+    zoneCodes = codes;
+    buildIndex();
+
+    numCells = zoneCodes.size() * zoneCodes.size();
+    ownedValues.assign(NUM_ATTRIBUTES * numCells, 0.0);
+    ownedAvailability.assign(numCells, 0);
+    values = ownedValues.empty() ? nullptr : &ownedValues[0];
+    availability = ownedAvailability.empty() ? nullptr : &ownedAvailability[0];
+}
+
+void SkimMatrix::buildIndex()
+{
+    codeToIndex.clear();
+    for (std::size_t idx = 0; idx < zoneCodes.size(); ++idx)
+    {
+        int code = zoneCodes[idx];
+        if (code < 0)
+        {
+            std::stringstream msg;
+            msg << "SkimMatrix: negative zone code " << code;
+            throw std::runtime_error(msg.str());
+        }
+        if (static_cast<std::size_t>(code) >= codeToIndex.size())
+        {
+            codeToIndex.resize(code + 1, -1);
+        }
+        if (codeToIndex[code] != -1)
+        {
+            std::stringstream msg;
+            msg << "SkimMatrix: duplicate zone code " << code;
+            throw std::runtime_error(msg.str());
+        }
+        codeToIndex[code] = idx;
+    }
+}
+
+bool SkimMatrix::setCosts(const CostParams& costs)
+{
+    if (mappedFile)
+    {
+        throw std::runtime_error("SkimMatrix: cannot modify a matrix loaded from file");
+    }
+
+    int orgIdx = getZoneIndex(costs.getOriginZone());
+    int destIdx = getZoneIndex(costs.getDestinationZone());
+    if (orgIdx < 0 || destIdx < 0)
+    {
+        return false;
+    }
+
+    std::size_t cell = static_cast<std::size_t>(orgIdx) * zoneCodes.size() + destIdx;
+    ownedValues[DISTANCE * numCells + cell] = costs.getDistance();
+    ownedValues[CAR_COST_ERP * numCells + cell] = costs.getCarCostErp();
+    ownedValues[CAR_IVT * numCells + cell] = costs.getCarIvt();
+    ownedValues[PUB_IVT * numCells + cell] = costs.getPubIvt();
+    ownedValues[PUB_WALKT * numCells + cell] = costs.getPubWalkt();
+    ownedValues[PUB_WTT * numCells + cell] = costs.getPubWtt();
+    ownedValues[PUB_COST * numCells + cell] = costs.getPubCost();
+    ownedValues[AVG_TRANSFER * numCells + cell] = costs.getAvgTransfer();
+    ownedValues[PUB_OUT * numCells + cell] = costs.getPubOut();
+    ownedAvailability[cell] = 1;
+    return true;
+}
+
+bool SkimMatrix::contains(int origin, int destination) const
+{
+    int orgIdx = getZoneIndex(origin);
+    int destIdx = getZoneIndex(destination);
+    if (orgIdx < 0 || destIdx < 0)
+    {
+        return false;
+    }
+    return availability[static_cast<std::size_t>(orgIdx) * zoneCodes.size() + destIdx];
+}
+
+void SkimMatrix::getCostParams(int origin, int destination, CostParams& outCosts) const
+{
+    Costs costs = at(origin, destination);
+    outCosts.setOriginZone(origin);
+    outCosts.setDestinationZone(destination);
+    outCosts.setOrgDest();
+    outCosts.setDistance(costs.getDistance());
+    outCosts.setCarCostErp(costs.getCarCostErp());
+    outCosts.setCarIvt(costs.getCarIvt());
+    outCosts.setPubIvt(costs.getPubIvt());
+    outCosts.setPubWalkt(costs.getPubWalkt());
+    outCosts.setPubWtt(costs.getPubWtt());
+    outCosts.setPubCost(costs.getPubCost());
+    outCosts.setAvgTransfer(costs.getAvgTransfer());
+    outCosts.setPubOut(costs.getPubOut());
+}
+
+std::size_t SkimMatrix::getNumODs() const
+{
+    if (!availability)
+    {
+        return 0;
+    }
+    return std::count(availability, availability + numCells, 1);
+}
+
+std::size_t SkimMatrix::getMemoryUsage() const
+{
+    return numCells * (NUM_ATTRIBUTES * sizeof(double) + sizeof(unsigned char))
+            + zoneCodes.size() * sizeof(int) + codeToIndex.size() * sizeof(int);
+}
+
+void SkimMatrix::clear()
+{
+    zoneCodes.clear();
+    codeToIndex.clear();
+    numCells = 0;
+    std::vector<double>().swap(ownedValues);
+    std::vector<unsigned char>().swap(ownedAvailability);
+    mappedFile.reset();
+    values = nullptr;
+    availability = nullptr;
+}
+
+void SkimMatrix::throwNoCosts(int origin, int destination)
+{
+    std::stringstream msg;
+    msg << "SkimMatrix: no costs for OD pair (" << origin << "," << destination << ")";
+    throw std::out_of_range(msg.str());
+}
+
+void SkimMatrix::saveToFile(const std::string& fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("SkimMatrix: could not open " + fileName + " for writing");
+    }
+    write(file);
+    if (!file)
+    {
+        throw std::runtime_error("SkimMatrix: error writing " + fileName);
+    }
+}
+
+void SkimMatrix::loadFromFile(const std::string& fileName)
+{
+    boost::shared_ptr<boost::interprocess::mapped_region> region;
+    try
+    {
+        boost::interprocess::file_mapping mapping(fileName.c_str(), boost::interprocess::read_only);
+        region.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& ex)
+    {
+        throw std::runtime_error("SkimMatrix: could not map " + fileName + ": " + ex.what());
+    }
+
+    try
+    {
+        map(region, 0);
+    }
+    catch (std::runtime_error& ex)
+    {
+        throw std::runtime_error(std::string(ex.what()) + " (" + fileName + ")");
+    }
+}
+
+std::size_t SkimMatrix::write(std::ostream& os) const
+{
+    SkimFileHeader header;
+    std::memcpy(header.magic, SKIM_FILE_MAGIC, sizeof(header.magic));
+    header.version = SKIM_FILE_VERSION;
+    header.numZones = zoneCodes.size();
+    header.numAttributes = NUM_ATTRIBUTES;
+    header.valueSize = sizeof(double);
+    header.valuesOffset = getValuesOffset(header.numZones);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<int32_t> codes(zoneCodes.begin(), zoneCodes.end());
+    if (!codes.empty())
+    {
+        os.write(reinterpret_cast<const char*>(&codes[0]), codes.size() * sizeof(int32_t));
+        os.write(reinterpret_cast<const char*>(availability), numCells);
+    }
+
+    uint64_t written = sizeof(header) + codes.size() * sizeof(int32_t) + numCells;
+    const char padding[8] = { 0 };
+    os.write(padding, header.valuesOffset - written);
+
+    if (numCells > 0)
+    {
+        os.write(reinterpret_cast<const char*>(values), NUM_ATTRIBUTES * numCells * sizeof(double));
+    }
+
+    written = getBlockSize(header.numZones);
+    os.write(padding, written - header.valuesOffset - NUM_ATTRIBUTES * numCells * sizeof(double));
+    return written;
+}
+
+std::size_t SkimMatrix::map(const boost::shared_ptr<boost::interprocess::mapped_region>& region, std::size_t offset)
+{
+    if (!region || offset % 8 != 0 || offset > region->get_size())
+    {
+        throw std::runtime_error("SkimMatrix: invalid offset in mapped region");
+    }
+    const char* base = static_cast<const char*>(region->get_address()) + offset;
+    const std::size_t size = region->get_size() - offset;
+    if (size < sizeof(SkimFileHeader))
+    {
+        throw std::runtime_error("SkimMatrix: skim matrix data is truncated");
+    }
+
+    SkimFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, SKIM_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != SKIM_FILE_VERSION
+            || header.numAttributes != NUM_ATTRIBUTES || header.valueSize != sizeof(double))
+    {
+        throw std::runtime_error("SkimMatrix: not a skim matrix of version " + std::to_string(SKIM_FILE_VERSION));
+    }
+
+    const uint64_t cells = static_cast<uint64_t>(header.numZones) * header.numZones;
+    const uint64_t blockSize = getBlockSize(header.numZones);
+    if (header.valuesOffset != getValuesOffset(header.numZones) || size < blockSize)
+    {
+        throw std::runtime_error("SkimMatrix: skim matrix data is truncated");
+    }
+
+    const int32_t* codes = reinterpret_cast<const int32_t*>(base + sizeof(SkimFileHeader));
+    std::vector<int> fileZoneCodes(codes, codes + header.numZones);
+
+    clear();
+    zoneCodes.swap(fileZoneCodes);
+    buildIndex();
+    numCells = cells;
+    availability = reinterpret_cast<const unsigned char*>(codes + header.numZones);
+    values = reinterpret_cast<const double*>(base + header.valuesOffset);
+    mappedFile = region;
+    return blockSize;
+}
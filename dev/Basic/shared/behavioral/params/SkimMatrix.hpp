@@ -0,0 +1,305 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "behavioral/params/ZoneCostParams.hpp"
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace sim_mob
+{
+
+/**
+ * Dense zone to zone skim matrix for one time period (AM, PM or off-peak).
+ *
+ * Zones are addressed by their zone code, as in the cost tables, and mapped to a dense index ordered by zone id
+ * (see initialize()). Each cost attribute is stored as one contiguous numZones x numZones array of doubles in
+ * origin-major order, so that iterating over destinations for a fixed origin reads sequential memory.
+ * OD pairs without costs (typically the diagonal) are tracked separately; looking them up throws std::out_of_range.
+ *
+ * A matrix can be saved to a binary file and loaded back with a single read-only memory mapping. The same binary
+ * layout can also be embedded in a larger file (see write() and map()), in which case several matrices share the
+ * mapping of that file.
+ */
+class SkimMatrix
+{
+public:
+    /** cost attributes of an OD pair, in storage order */
+    enum Attribute
+    {
+        DISTANCE,
+        CAR_COST_ERP,
+        CAR_IVT,
+        PUB_IVT,
+        PUB_WALKT,
+        PUB_WTT,
+        PUB_COST,
+        AVG_TRANSFER,
+        PUB_OUT,
+        NUM_ATTRIBUTES
+    };
+
+    /**
+     * Read-only view of the costs of one OD pair.
+     * Provides the same getters as CostParams. Valid as long as the matrix is neither modified nor destroyed.
+     */
+    class Costs
+    {
+    public:
+        double get(Attribute attribute) const
+        {
+            return cell[attribute * stride];
+        }
+
+        double getDistance() const
+        {
+            return get(DISTANCE);
+        }
+
+        double getCarCostErp() const
+        {
+            return get(CAR_COST_ERP);
+        }
+
+        double getCarIvt() const
+        {
+            return get(CAR_IVT);
+        }
+
+        double getPubIvt() const
+        {
+            return get(PUB_IVT);
+        }
+
+        double getPubWalkt() const
+        {
+            return get(PUB_WALKT);
+        }
+
+        double getPubWtt() const
+        {
+            return get(PUB_WTT);
+        }
+
+        double getPubCost() const
+        {
+            return get(PUB_COST);
+        }
+
+        double getAvgTransfer() const
+        {
+            return get(AVG_TRANSFER);
+        }
+
+        double getPubOut() const
+        {
+            return get(PUB_OUT);
+        }
+
+    private:
+        friend class SkimMatrix;
+
+        Costs(const double* cell, std::size_t stride) : cell(cell), stride(stride)
+        {
+        }
+
+        /** value of the first attribute of the OD pair */
+        const double* cell;
+
+        /** distance between two attributes of the same OD pair */
+        std::size_t stride;
+    };
+
+    SkimMatrix();
+    ~SkimMatrix();
+
+    /**
+     * sets up an empty matrix for the given zones. Any previous contents are discarded.
+     * @param zoneIdLookup zone code -> zone id map. Zones are indexed in increasing order of zone id.
+     */
+    void initialize(const boost::unordered_map<int, int>& zoneIdLookup);
+
+    /**
+     * sets up an empty matrix for the given zones. Any previous contents are discarded.
+     * @param zoneCodes zone codes in dense index order
+     */
+    void initialize(const std::vector<int>& zoneCodes);
+
+    /**
+     * stores the costs of one OD pair
+     * @param costs costs of the OD pair given by costs.getOriginZone() and costs.getDestinationZone()
+     * @return false if either zone is not part of the matrix; true otherwise
+     */
+    bool setCosts(const CostParams& costs);
+
+    /**
+     * fetches the costs of an OD pair
+     * @param origin origin zone code
+     * @param destination destination zone code
+     * @return view of the costs
+     * @throws std::out_of_range if no costs are available for the OD pair
+     */
+    Costs at(int origin, int destination) const
+    {
+        std::size_t cell = getCell(origin, destination);
+        if (!availability[cell])
+        {
+            throwNoCosts(origin, destination);
+        }
+        return Costs(values + cell, numCells);
+    }
+
+    /**
+     * @param origin origin zone code
+     * @param destination destination zone code
+     * @return true if costs are available for the OD pair; false otherwise
+     */
+    bool contains(int origin, int destination) const;
+
+    /**
+     * fills a CostParams object with the costs of an OD pair
+     * @param origin origin zone code
+     * @param destination destination zone code
+     * @param outCosts output costs
+     * @throws std::out_of_range if no costs are available for the OD pair
+     */
+    void getCostParams(int origin, int destination, CostParams& outCosts) const;
+
+    /**
+     * @param zoneCode zone code
+     * @return dense index of the zone; -1 if the zone is not part of the matrix
+     */
+    int getZoneIndex(int zoneCode) const
+    {
+        if (zoneCode < 0 || static_cast<std::size_t>(zoneCode) >= codeToIndex.size())
+        {
+            return -1;
+        }
+        return codeToIndex[zoneCode];
+    }
+
+    /**
+     * @param originIndex dense index of the origin zone
+     * @param attribute cost attribute
+     * @return the values of attribute from the origin to every zone, indexed by the dense destination index
+     */
+    const double* getRow(int originIndex, Attribute attribute) const
+    {
+        return values + attribute * numCells + originIndex * zoneCodes.size();
+    }
+
+    std::size_t getNumZones() const
+    {
+        return zoneCodes.size();
+    }
+
+    /**
+     * @return number of OD pairs with costs
+     */
+    std::size_t getNumODs() const;
+
+    /**
+     * @return approximate number of bytes held by the matrix (including mapped file contents)
+     */
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * releases all storage
+     */
+    void clear();
+
+    /**
+     * writes the matrix to a binary file
+     * @param fileName path of the file
+     */
+    void saveToFile(const std::string& fileName) const;
+
+    /**
+     * replaces the contents of this matrix with the contents of a binary file written by saveToFile().
+     * The file is memory mapped read-only; the matrix can no longer be modified with setCosts().
+     * @param fileName path of the file
+     * @throws std::runtime_error if the file cannot be read or is not a valid skim matrix file
+     */
+    void loadFromFile(const std::string& fileName);
+
+    /**
+     * writes the matrix in the binary layout of saveToFile() at the current position of a stream.
+     * The position must be a multiple of 8 bytes for the values to be aligned when the data is mapped back.
+     * @param os output stream
+     * @return number of bytes written (a multiple of 8)
+     */
+    std::size_t write(std::ostream& os) const;
+
+    /**
+     * replaces the contents of this matrix with a matrix embedded in a mapped file by write().
+     * The matrix keeps a reference to the region; it can no longer be modified with setCosts().
+     * @param region read-only mapping containing the matrix
+     * @param offset offset of the matrix in the region; must be a multiple of 8
+     * @return number of bytes occupied by the matrix in the region
+     * @throws std::runtime_error if the region does not contain a valid matrix at offset
+     */
+    std::size_t map(const boost::shared_ptr<boost::interprocess::mapped_region>& region, std::size_t offset);
+
+private:
+    SkimMatrix(const SkimMatrix&);
+    SkimMatrix& operator=(const SkimMatrix&);
+
+    /** builds the zone code -> index lookup from zoneCodes */
+    void buildIndex();
+
+    /**
+     * @return flat origin-major index of an OD pair
+     * @throws std::out_of_range if either zone is unknown
+     */
+    std::size_t getCell(int origin, int destination) const
+    {
+        int orgIdx = getZoneIndex(origin);
+        int destIdx = getZoneIndex(destination);
+        if (orgIdx < 0 || destIdx < 0)
+        {
+            throwNoCosts(origin, destination);
+        }
+        return static_cast<std::size_t>(orgIdx) * zoneCodes.size() + destIdx;
+    }
+
+    static void throwNoCosts(int origin, int destination);
+
+    /** zone codes in dense index order */
+    std::vector<int> zoneCodes;
+
+    /** zone code -> dense index; -1 for unknown codes */
+    std::vector<int> codeToIndex;
+
+    /** numZones * numZones */
+    std::size_t numCells;
+
+    /** storage when the matrix is built in memory */
+    std::vector<double> ownedValues;
+    std::vector<unsigned char> ownedAvailability;
+
+    /** storage when the matrix is loaded from a file; may be shared with other matrices mapped from the same file */
+    boost::shared_ptr<boost::interprocess::mapped_region> mappedFile;
+
+    /** NUM_ATTRIBUTES arrays of numCells values; points to ownedValues or into mappedFile */
+    const double* values;
+
+    /** numCells flags telling whether an OD pair has costs; points to ownedAvailability or into mappedFile */
+    const unsigned char* availability;
+};
+
+}
@@ -0,0 +1,78 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "BufferArena.hpp"
+
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+using namespace sim_mob;
+
+BufferArena::BufferArena(std::size_t valueSize) : valueSize(valueSize), usedSlots(0)
+{
+    if (valueSize == 0 || valueSize > MAX_VALUE_SIZE)
+    {
+        std::stringstream errStrm;
+        errStrm << "BufferArena: invalid value size " << valueSize;
+        throw std::runtime_error(errStrm.str());
+    }
+}
+
+BufferArena::~BufferArena()
+{
+    for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+    {
+        ::operator delete(*it);
+    }
+}
+
+std::size_t BufferArena::allocate(void*& current, void*& next)
+{
+    std::size_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = usedSlots;
+        if (slot == blocks.size() * SLOTS_PER_BLOCK)
+        {
+            blocks.push_back(static_cast<char*>(::operator new(2 * SLOTS_PER_BLOCK * valueSize)));
+        }
+        usedSlots++;
+    }
+
+    char* block = blocks[slot / SLOTS_PER_BLOCK];
+    std::size_t offset = (slot % SLOTS_PER_BLOCK) * valueSize;
+    current = block + offset;
+    next = block + SLOTS_PER_BLOCK * valueSize + offset;
+    return slot;
+}
+
+void BufferArena::release(std::size_t slot)
+{
+    if (slot >= usedSlots)
+    {
+        std::stringstream errStrm;
+        errStrm << "BufferArena: releasing unknown slot " << slot;
+        throw std::runtime_error(errStrm.str());
+    }
+    freeSlots.push_back(slot);
+}
+
+void BufferArena::flip()
+{
+    // released slots are copied as well; their values are never read
+    std::size_t remaining = usedSlots;
+    for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end() && remaining > 0; ++it)
+    {
+        std::size_t slots = remaining < SLOTS_PER_BLOCK ? remaining : SLOTS_PER_BLOCK;
+        std::memcpy(*it, *it + SLOTS_PER_BLOCK * valueSize, slots * valueSize);
+        remaining -= slots;
+    }
+}
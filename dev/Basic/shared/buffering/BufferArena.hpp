@@ -0,0 +1,92 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/has_trivial_assign.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Contiguous storage for the current and next values of buffered data of one size.
+ *
+ * The arena is made of blocks of SLOTS_PER_BLOCK slots. A block holds the current values of all its slots,
+ * followed by their next values, so that flipping a whole block is a single memcpy of the next half onto the
+ * current half. Blocks are never moved, so the addresses of the values of a slot stay valid until it is released.
+ *
+ * Only values which can be copied byte by byte can live in an arena (see canHold()).
+ */
+class BufferArena : private boost::noncopyable
+{
+public:
+    /** number of slots per block */
+    static const std::size_t SLOTS_PER_BLOCK = 4096;
+
+    /** largest value held in an arena, in bytes */
+    static const std::size_t MAX_VALUE_SIZE = 64;
+
+    /**
+     * @return true if values of type T can live in an arena, i.e. if they are small and trivially copyable
+     */
+    template<typename T>
+    static bool canHold()
+    {
+        return sizeof(T) <= MAX_VALUE_SIZE && boost::has_trivial_copy<T>::value && boost::has_trivial_assign<T>::value
+                && boost::has_trivial_destructor<T>::value;
+    }
+
+    /**
+     * @param valueSize size in bytes of the values of the arena
+     */
+    explicit BufferArena(std::size_t valueSize);
+    ~BufferArena();
+
+    /**
+     * reserves a slot
+     * @param current output address of the current value of the slot
+     * @param next output address of the next value of the slot
+     * @return slot id, to pass to release()
+     */
+    std::size_t allocate(void*& current, void*& next);
+
+    /**
+     * releases a slot; its values may be overwritten from then on
+     * @param slot slot id returned by allocate()
+     */
+    void release(std::size_t slot);
+
+    /**
+     * copies the next value of every slot to its current value
+     */
+    void flip();
+
+    /**
+     * @return number of slots in use
+     */
+    std::size_t size() const
+    {
+        return usedSlots - freeSlots.size();
+    }
+
+private:
+    /** size in bytes of a value */
+    std::size_t valueSize;
+
+    /** current values of SLOTS_PER_BLOCK slots, then their next values */
+    std::vector<char*> blocks;
+
+    /** number of slots handed out at least once; slots from usedSlots on have never been used */
+    std::size_t usedSlots;
+
+    /** released slots below usedSlots */
+    std::vector<std::size_t> freeSlots;
+};
+
+}
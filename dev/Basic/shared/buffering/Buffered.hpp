@@ -5,6 +5,8 @@
 #pragma once
 
 
+#include <new>
+#include "BufferArena.hpp"
 #include "BufferedDataManager.hpp"
 
 
@@ -55,7 +57,8 @@ public:
      *
      * \param value The initial value. You can also set an initial value using "force".
      */
-    explicit Buffered (const T& value = T()) : BufferedBase(), current_ (value), next_ (value) {}
+    explicit Buffered (const T& value = T()) : BufferedBase(), current_ (&currentValue_), next_ (&nextValue_),
+        currentValue_ (value), nextValue_ (value) {}
     virtual ~Buffered() {}
 
 
@@ -64,7 +67,7 @@ public:
      * also be thought of as being one flip "behind" the actual value.
      */
     const T& get() const {
-        return current_;
+        return *current_;
     }
 
     /**
@@ -72,7 +75,7 @@ public:
      * only take effect when "flip" is called.
      */
     void set (const T& value) {
-        next_ = value;
+        *next_ = value;
     }
 
 
@@ -117,7 +120,7 @@ public:
      */
     operator T() const
     {
-        return current_;
+        return *current_;
     }
 
     /**
@@ -125,17 +128,38 @@ public:
      * This is usually only needed when loading values from a config file.
      */
     void force(const T& value) {
-        next_ = current_ = value;
+        *next_ = *current_ = value;
     }
 
 
 protected:
     void flip() {
-        current_ = next_;
+        *current_ = *next_;
     }
 
-    T current_;
-    T next_;
+    std::size_t getArenaValueSize() const {
+        return BufferArena::canHold<T>() ? sizeof(T) : 0;
+    }
+
+    void relocate(void* current, void* next) {
+        if (current) {
+            current_ = new (current) T(*current_);
+            next_ = new (next) T(*next_);
+        } else {
+            currentValue_ = *current_;
+            nextValue_ = *next_;
+            current_ = &currentValue_;
+            next_ = &nextValue_;
+        }
+    }
+
+    ///Current and next value; in this object unless they were moved to a BufferArena by the manager.
+    T* current_;
+    T* next_;
+
+private:
+    T currentValue_;
+    T nextValue_;
 
 };
 
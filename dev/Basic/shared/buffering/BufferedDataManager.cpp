@@ -6,6 +6,9 @@
 
 #include <cassert>
 #include <algorithm>
+#include <stdexcept>
+
+#include "BufferArena.hpp"
 
 using namespace sim_mob;
 using std::vector;
@@ -16,12 +19,27 @@ sim_mob::BufferedBase::~BufferedBase() {
 }
 
 
+sim_mob::BufferedDataManager::BufferedDataManager() : arenaBuffering(false)
+{
+}
+
 sim_mob::BufferedDataManager::~BufferedDataManager()
 {
     //Stop managing all items
     while (managedData.begin() != managedData.end()) {
         stopManaging(*managedData.begin());
     }
+    while (arenaData.begin() != arenaData.end()) {
+        stopManaging(arenaData.begin()->first);
+    }
+}
+
+void sim_mob::BufferedDataManager::setArenaBuffering(bool enabled)
+{
+    if (getNumManaged() > 0) {
+        throw std::runtime_error("BufferedDataManager: arena buffering can only be changed while no data is managed");
+    }
+    arenaBuffering = enabled;
 }
 
 
@@ -29,13 +47,30 @@ sim_mob::BufferedDataManager::~BufferedDataManager()
 void sim_mob::BufferedDataManager::beginManaging(BufferedBase* datum)
 {
     //Only add if we're not managing it already.
-    std::set<BufferedBase*>::iterator it = managedData.find(datum);
-    if (it==managedData.end()) {
-        managedData.insert(datum);
+    if (managedData.find(datum)!=managedData.end() || arenaData.find(datum)!=arenaData.end()) {
+        return;
+    }
 
-        //Helps with debugging.
-        datum->refCount++;
+    //A datum shared with another manager stays out of the arenas; it is flipped through its slot, if any.
+    std::size_t valueSize = (arenaBuffering && datum->refCount == 0) ? datum->getArenaValueSize() : 0;
+    if (valueSize > 0) {
+        boost::shared_ptr<BufferArena>& arena = arenas[valueSize];
+        if (!arena) {
+            arena.reset(new BufferArena(valueSize));
+        }
+        void* current;
+        void* next;
+        ArenaSlot slot;
+        slot.arena = arena.get();
+        slot.slot = arena->allocate(current, next);
+        datum->relocate(current, next);
+        arenaData[datum] = slot;
+    } else {
+        managedData.insert(datum);
     }
+
+    //Helps with debugging.
+    datum->refCount++;
 }
 
 void sim_mob::BufferedDataManager::stopManaging(BufferedBase* datum)
@@ -47,6 +82,16 @@ void sim_mob::BufferedDataManager::stopManaging(BufferedBase* datum)
 
         //Helps with debugging.
         datum->refCount--;
+        return;
+    }
+
+    //The datum takes its values back before its slot is released.
+    boost::unordered_map<BufferedBase*, ArenaSlot>::iterator arenaIt = arenaData.find(datum);
+    if (arenaIt!=arenaData.end()) {
+        datum->relocate(nullptr, nullptr);
+        arenaIt->second.arena->release(arenaIt->second.slot);
+        arenaData.erase(arenaIt);
+        datum->refCount--;
     }
 }
 
@@ -67,6 +112,9 @@ void sim_mob::BufferedDataManager::stopManaging(vector<BufferedBase*> data)
 
 void sim_mob::BufferedDataManager::flip()
 {
+    for (std::map< std::size_t, boost::shared_ptr<BufferArena> >::iterator it=arenas.begin(); it!=arenas.end(); it++) {
+        it->second->flip();
+    }
     for (std::set<BufferedBase*>::iterator it=managedData.begin(); it!=managedData.end(); it++) {
         (*it)->flip();
     }
@@ -4,14 +4,19 @@
 
 #pragma once
 
+#include <cstddef>
+#include <map>
 #include <set>
 #include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 
 namespace sim_mob
 {
 
 
+class BufferArena;
 class BufferedDataManager;
 
 
@@ -51,6 +56,19 @@ protected:
      */
     virtual void flip() = 0;
 
+    /**
+     * Size in bytes of the value, if the datum can be kept in a BufferArena; 0 otherwise (the default).
+     */
+    virtual std::size_t getArenaValueSize() const {
+        return 0;
+    }
+
+    /**
+     * Moves the current and next value to the given arena slot, or back into the datum itself if both
+     * are null. Only called on data whose getArenaValueSize() is not 0.
+     */
+    virtual void relocate(void* current, void* next) {}
+
     //Allow access to protected methods by BufferedDataManager.
     friend class BufferedDataManager;
 
@@ -66,20 +84,16 @@ private:
  * updates their current values each time flip() is called. Calling flip() multiple times
  * in a row (without calling each datum's "set()" method in between) has undefined behavior.
  *
- * \todo
- * It seems sensible to have beginManaging() add the datum to a static array of raw "data", using
- * the "size" of the buffered type. The next_ and current_ values can then be represented by two
- * large static arrays, which can be flipped with a single pointer swap. Care should be taken to
- * update the arrays when they grow too big. In addition, internal segmentation will develop
- * when an item is removed through a call to stopManaging(). So, it's not a trivial feature, but
- * then again there's plenty of existing research (for dealing with general memory allocation).
- *
- * \par
- * ~Seth
+ * By default, every datum is flipped by a virtual call. With arena buffering enabled (see
+ * setArenaBuffering()), data whose values can be copied byte by byte (Buffered<int>, Shared<double>,
+ * pointers, ...) are moved into one BufferArena per value size while they are managed, and are flipped
+ * a block of values at a time. Other data are still flipped one by one. Moving the data in and out of
+ * the arenas is transparent to their users; get() and set() just read and write the arena slot.
  */
 class BufferedDataManager
 {
 public:
+    BufferedDataManager();
     virtual ~BufferedDataManager();
 
     ///Become responsible for a buffered data item.
@@ -95,9 +109,40 @@ public:
     ///Flip (update the current value of) all buffered data items under your control.
     void flip();
 
+    /**
+     * Enables or disables arena buffering for the data managed from now on.
+     * \throws std::runtime_error if some data are already managed.
+     */
+    void setArenaBuffering(bool enabled);
+
+    bool isArenaBuffering() const {
+        return arenaBuffering;
+    }
+
+    ///Number of data items managed, including those kept in arenas.
+    std::size_t getNumManaged() const {
+        return managedData.size() + arenaData.size();
+    }
+
 
 protected:
+    ///Data flipped one by one; with arena buffering, only those which cannot be kept in an arena.
     std::set<BufferedBase*> managedData;
+
+private:
+    ///Arena and slot of a datum kept in an arena.
+    struct ArenaSlot {
+        BufferArena* arena;
+        std::size_t slot;
+    };
+
+    bool arenaBuffering;
+
+    ///Arenas by value size.
+    std::map< std::size_t, boost::shared_ptr<BufferArena> > arenas;
+
+    ///Data kept in arenas.
+    boost::unordered_map<BufferedBase*, ArenaSlot> arenaData;
 };
 
 
@@ -40,7 +40,7 @@ public:
      */
     void operator++()
     {
-        ++next_;
+        ++*next_;
     }
 
     /**
@@ -51,7 +51,7 @@ public:
      */
     void operator++(int)
     {
-        ++next_;
+        ++*next_;
     }
 
     /**
@@ -62,7 +62,7 @@ public:
      */
     void operator--()
     {
-        --next_;
+        --*next_;
     }
 
     /**
@@ -73,7 +73,7 @@ public:
      */
     void operator--(int)
     {
-        --next_;
+        --*next_;
     }
 
     /**
@@ -84,7 +84,7 @@ public:
      */
     void operator+=(int delta)
     {
-        next_ += delta;
+        *next_ += delta;
     }
 
     /**
@@ -95,7 +95,7 @@ public:
      */
     void operator-=(int delta)
     {
-        next_ -= delta;
+        *next_ -= delta;
     }
 };
 
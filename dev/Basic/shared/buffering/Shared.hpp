@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include "BufferArena.hpp"
 #include "BufferedDataManager.hpp"
 
+#include <new>
 #include <boost/thread.hpp>
 
 
@@ -69,7 +71,7 @@ public:
      * \param value The initial value. You can also set an initial value using "force".
      */
     Shared (const sim_mob::MutexStrategy& mtxStrategy, const T& value = T()) : BufferedBase(),
-        current_ (value), strategy_(mtxStrategy), next_ (value) {}
+        current_ (&currentValue_), strategy_(mtxStrategy), next_ (&nextValue_), currentValue_ (value), nextValue_ (value) {}
     virtual ~Shared() {}
 
 
@@ -85,7 +87,7 @@ public:
             boost::shared_lock<boost::shared_mutex> lock_(mutex_);
             return current_;
         }*/
-        return current_;
+        return *current_;
     }
 
     T& getRW() {
@@ -96,7 +98,7 @@ public:
             boost::shared_lock<boost::shared_mutex> lock_(mutex_);
             return current_;
         }*/
-        return current_;
+        return *current_;
     }
 
 
@@ -112,7 +114,7 @@ public:
         } else if (strategy_==MtxStrat_Buffered) {
             next_ = value;
         }*/
-        next_ = value;
+        *next_ = value;
     }
 
 
@@ -168,32 +170,54 @@ public:
      * Note that calling this function is inherently unsafe in a parallel environment.
      */
     void force(const T& value) {
-        current_ = value;
+        *current_ = value;
         if (strategy_==MtxStrat_Buffered) {
-            next_ = value;
+            *next_ = value;
         }
     }
 
 protected:
     void flip() {
         if (strategy_==MtxStrat_Buffered) {
-            current_ = next_;
+            *current_ = *next_;
+        }
+    }
+
+    //Only buffered values are flipped, so only those may be moved to an arena.
+    std::size_t getArenaValueSize() const {
+        return (strategy_==MtxStrat_Buffered && BufferArena::canHold<T>()) ? sizeof(T) : 0;
+    }
+
+    void relocate(void* current, void* next) {
+        if (current) {
+            current_ = new (current) T(*current_);
+            next_ = new (next) T(*next_);
+        } else {
+            currentValue_ = *current_;
+            nextValue_ = *next_;
+            current_ = &currentValue_;
+            next_ = &nextValue_;
         }
     }
 
     //Used by both
-    T current_;
+    //Points to currentValue_, or to a BufferArena slot while the manager keeps the value there.
+    T* current_;
 
     sim_mob::MutexStrategy strategy_;
 
     //Next value to be written
     // Used by Buffered
-    T next_;
+    T* next_;
 
     //Shared ownership of reading, exclusive ownership of writing.
     // Used by Locked
     mutable boost::shared_mutex mutex_;
 
+private:
+    T currentValue_;
+    T nextValue_;
+
 
 };
 
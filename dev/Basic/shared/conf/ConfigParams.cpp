@@ -18,6 +18,7 @@
 #include "password/password.hpp"
 #include "util/ReactionTimeDistributions.hpp"
 #include "util/PassengerDistribution.hpp"
+#include "util/RandomService.hpp"
 
 using namespace sim_mob;
 
@@ -274,6 +275,7 @@ void ConfigParams::setWorkerPublisherEnabled(bool value)
 void ConfigParams::setSeedValueForRNG(unsigned int value)
 {
     simulation.seedValue = value;
+    RandomService::setSeed(value);
 }
 
 bool ConfigParams::isWorkerPublisherEnabled() const
@@ -11,6 +11,7 @@
 
 #include "conf/ConfigManager.hpp"
 #include "util/GeomHelpers.hpp"
+#include "util/RandomService.hpp"
 #include "util/XmlParseHelper.hpp"
 
 using namespace std;
@@ -749,6 +750,7 @@ void ParseConfigFile::processSimulationNode(xercesc::DOMElement *node)
 	cfg.simulation.totalWarmupMS = processTimeGranUnits(GetSingleElementByName(node, "total_warmup"));
 
 	cfg.simulation.seedValue = ParseUnsignedInt(GetNamedAttributeValue(GetSingleElementByName(node, "seedValue"), "value"), (unsigned int)101 );
+	RandomService::setSeed(cfg.simulation.seedValue);
 
 	cfg.simulation.baseGranSecond = cfg.simulation.baseGranMS / MILLISECONDS_IN_SECOND;
 
@@ -767,6 +769,7 @@ void ParseConfigFile::processSimulationNode(xercesc::DOMElement *node)
 	processWorkgroupAssignmentNode(GetSingleElementByName(node, "workgroup_assignment"));
 	processOperationalCostNode(GetSingleElementByName(node, "operational_cost")) ;
 	processMutexEnforcementNode(GetSingleElementByName(node, "mutex_enforcement"));
+	processShortestPathEngineNode(GetSingleElementByName(node, "shortest_path_engine"));
 	processClosedLoopPropertiesNode(GetSingleElementByName(node, "closed_loop"));
 
 	cfg.simulation.startingAutoAgentID =
@@ -879,6 +882,31 @@ void ParseConfigFile::processClosedLoopPropertiesNode(xercesc::DOMElement *node)
 void ParseConfigFile::processMutexEnforcementNode(xercesc::DOMElement *node)
 {
 	cfg.simulation.mutexStategy = ParseMutexStrategyEnum(GetNamedAttributeValue(node, "strategy"), MtxStrat_Buffered);
+	cfg.simulation.arenaBuffering = ParseBoolean(GetNamedAttributeValue(node, "arenas", false), false);
+}
+
+void ParseConfigFile::processShortestPathEngineNode(xercesc::DOMElement *node)
+{
+	string engine = ParseString(GetNamedAttributeValue(node, "value"), "a_star");
+
+	if (engine == "a_star")
+	{
+		cfg.simulation.contractionHierarchies = false;
+	}
+	else if (engine == "contraction_hierarchy")
+	{
+		cfg.simulation.contractionHierarchies = true;
+	}
+	else
+	{
+		stringstream msg;
+		msg << "Invalid value for <shortest_path_engine value=\""
+		    << engine << "\">. Expected: \"a_star\" or \"contraction_hierarchy\"";
+		throw runtime_error(msg.str());
+	}
+
+	cfg.simulation.shortestPathBenchmarkPairs = ParseUnsignedInt(GetNamedAttributeValue(node, "benchmark_pairs", false), (unsigned int) 0);
+	cfg.simulation.travelTimeRefreshInterval = ParseUnsignedInt(GetNamedAttributeValue(node, "refresh_interval", false), (unsigned int) 0);
 }
 
 void ParseConfigFile::processModelScriptsNode(xercesc::DOMElement *node)
@@ -210,6 +210,13 @@ private:
 	 */
 	void processMutexEnforcementNode(xercesc::DOMElement *node);
 
+	/**
+	 * Processes the shortest_path_engine element in the config file
+	 *
+	 * @param node node corresponding to the shortest_path_engine element in the xml file
+	 */
+	void processShortestPathEngineNode(xercesc::DOMElement *node);
+
 	/**
 	 * Processes the model_scripts element in the config file
 	 *
@@ -13,7 +13,8 @@ sim_mob::RawConfigParams::RawConfigParams() : mergeLogFiles(false), generateBusR
 sim_mob::SimulationParams::SimulationParams() :
     baseGranMS(0), baseGranSecond(0), totalRuntimeMS(0), totalWarmupMS(0), inSimulationTTUsage(0),
     workGroupAssigmentStrategy(WorkGroup::ASSIGN_ROUNDROBIN), startingAutoAgentID(0), operationalCostICE(0), operationalCostHEV(0), operationalCostBEV(0),
-    mutexStategy(MtxStrat_Buffered)
+    mutexStategy(MtxStrat_Buffered), arenaBuffering(false),
+    contractionHierarchies(false), shortestPathBenchmarkPairs(0), travelTimeRefreshInterval(0)
 {}
 
 
@@ -358,6 +358,18 @@ public:
     /// Locking strategy for Shared<> properties.
     sim_mob::MutexStrategy mutexStategy;
 
+    /// Keep the buffered properties of each worker in contiguous arenas (see BufferedDataManager).
+    bool arenaBuffering;
+
+    /// Answer the driving shortest path queries with contraction hierarchies instead of A* (see CH_ShortestPathImpl).
+    bool contractionHierarchies;
+
+    /// Number of random OD pairs on which to compare A* and the contraction hierarchies once the network is loaded; 0 to skip.
+    unsigned int shortestPathBenchmarkPairs;
+
+    /// Interval in seconds at which the InSimulation travel times of the contraction hierarchies are refreshed; 0 to never refresh them.
+    unsigned int travelTimeRefreshInterval;
+
     /// The settings for the closed loop manager
     ClosedLoopParams closedLoop;
 };
@@ -471,9 +483,9 @@ struct PathSetConf
      * Constructor
      */
 	PathSetConf() : enabled(false), supplyLinkFile(""), RTTT_Conf(""), DTT_Conf(""), psRetrievalWithoutBannedRegion(""), interval(0), recPS(false), reroute(false),
-			perturbationRange(std::pair<unsigned short,unsigned short>(0,0)), kspLevel(0),
+			perturbationRange(std::pair<int,int>(0,0)), kspLevel(0),
 			perturbationIteration(0), threadPoolSize(0), maxSegSpeed(0), publickShortestPathLevel(10), simulationApproachIterations(10),
-			publicPathSetEnabled(true), privatePathSetEnabled(true)
+			publicPathSetEnabled(true), privatePathSetEnabled(true), bulkFormat("csv"), bulkCheckpointInterval(60)
 	{}
 
     /// Whether pathset enabled
@@ -510,6 +522,15 @@ struct PathSetConf
     /// in case of using pathset manager in "generation" mode, the results will be outputted to this file
     std::string bulkFile;
 
+    /// format of the bulk generation output: "csv", or "binary" for per-thread binary files which can resume an interrupted generation
+    std::string bulkFormat;
+
+    /// seconds between two checkpoints of a "binary" bulk generation
+    unsigned int bulkCheckpointInterval;
+
+    /// if not empty, the pathset table into which the output of a "binary" bulk generation is loaded once completed
+    std::string bulkTable;
+
     /// data source for getting ODs for bulk pathset generation
     std::string odSourceTableName;
 
@@ -541,7 +562,7 @@ struct PathSetConf
 	int perturbationIteration;
 
     ///	range of uniform distribution in random perturbation
-	std::pair<unsigned short,unsigned short> perturbationRange;
+	std::pair<int,int> perturbationRange;
 
     ///k-shortest path level
 	int kspLevel;
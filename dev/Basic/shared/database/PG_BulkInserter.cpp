@@ -4,7 +4,8 @@
 
 using namespace sim_mob;
 
-PG_BulkInserter::PG_BulkInserter(const int numInsertsPerQuery) : numInsertsPerQuery(numInsertsPerQuery), query("")
+PG_BulkInserter::PG_BulkInserter(const int numInsertsPerQuery) :
+    inputFile(NULL), query(""), connection(NULL), numInsertsPerQuery(numInsertsPerQuery)
 {
 
 }
@@ -12,6 +13,10 @@ PG_BulkInserter::PG_BulkInserter(const int numInsertsPerQuery) : numInsertsPerQu
 PG_BulkInserter::~PG_BulkInserter()
 {
     delete inputFile;
+    if(connection)
+    {
+        PQfinish(connection);
+    }
 }
 
 bool PG_BulkInserter::connect(const std::string &connectionStr)
@@ -73,10 +78,24 @@ bool PG_BulkInserter::bulkInsert()
         }
     }
 
-    copyToDB(streamBuf);
+    return copyToDB(streamBuf);
 }
 
 bool PG_BulkInserter::copyToDB(const std::string& buffer)
+{
+    if(!beginCopy())
+    {
+        return false;
+    }
+    if(!putCopyData(buffer))
+    {
+        endCopy("PG_BulkInserter: sending rows failed");
+        return false;
+    }
+    return endCopy();
+}
+
+bool PG_BulkInserter::beginCopy()
 {
     bool retVal = true;
 
@@ -84,30 +103,51 @@ bool PG_BulkInserter::copyToDB(const std::string& buffer)
 
     if(PQresultStatus(res) != PGRES_COPY_IN)
     {
-        Print() << "PG_BulkInserter: Copy Failed\n";
+        Print() << "PG_BulkInserter: Copy Failed\n" << PQerrorMessage(connection);
         retVal = false;
     }
-    else
+    PQclear(res);
+
+    return retVal;
+}
+
+bool PG_BulkInserter::putCopyData(const std::string& buffer)
+{
+    if(buffer.empty())
     {
-        if(PQputCopyData(connection, buffer.c_str(), strlen(buffer.c_str())))
-        {
+        return true;
+    }
 
-            if (PQputCopyEnd(connection, NULL) == 1)
-            {
-                PGresult* res = PQgetResult(connection);
-                if (PQresultStatus(res) != PGRES_COMMAND_OK)
-                {
-                    Print() << PQerrorMessage(connection);
-                    retVal = false;
-                }
-            }
-            else
+    if(PQputCopyData(connection, buffer.data(), buffer.size()) != 1)
+    {
+        Print() << PQerrorMessage(connection);
+        return false;
+    }
+    return true;
+}
+
+bool PG_BulkInserter::endCopy(const char* errorMsg)
+{
+    bool retVal = (errorMsg == NULL);
+
+    if (PQputCopyEnd(connection, errorMsg) == 1)
+    {
+        PGresult* res;
+        while((res = PQgetResult(connection)) != NULL)
+        {
+            if (errorMsg == NULL && PQresultStatus(res) != PGRES_COMMAND_OK)
             {
                 Print() << PQerrorMessage(connection);
                 retVal = false;
             }
+            PQclear(res);
         }
     }
+    else
+    {
+        Print() << PQerrorMessage(connection);
+        retVal = false;
+    }
 
     return retVal;
 }
@@ -22,6 +22,26 @@ public:
     bool setInputFile(const std::string& inputFile);
 
     bool bulkInsert();
+
+    /**
+     * starts a COPY of the query built by buildQuery(); rows are then sent with putCopyData()
+     * @return true if the server accepted the COPY
+     */
+    bool beginCopy();
+
+    /**
+     * sends rows to the COPY started by beginCopy()
+     * @param buffer complete, newline terminated rows
+     * @return true on success
+     */
+    bool putCopyData(const std::string& buffer);
+
+    /**
+     * ends the COPY started by beginCopy()
+     * @param errorMsg if not NULL, the COPY is cancelled with this message and none of its rows are kept
+     * @return true if the rows were committed
+     */
+    bool endCopy(const char* errorMsg = NULL);
 private:
     std::ifstream* inputFile;
 
@@ -0,0 +1,47 @@
+#include "PG_CopySink.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace sim_mob;
+
+PG_CopySink::PG_CopySink(const std::string& connectionStr, const std::string& tableName, const std::vector<std::string>& columnNames) :
+    inserter(0), tableName(tableName), copying(false)
+{
+    if(!inserter.connect(connectionStr) || !inserter.buildQuery(tableName, columnNames) || !inserter.beginCopy())
+    {
+        std::stringstream errStrm;
+        errStrm << "PG_CopySink: cannot start copy into " << tableName;
+        throw std::runtime_error(errStrm.str());
+    }
+    copying = true;
+}
+
+PG_CopySink::~PG_CopySink()
+{
+    if(copying)
+    {
+        inserter.endCopy("output aborted");
+    }
+}
+
+void PG_CopySink::write(const std::string& data)
+{
+    if(!inserter.putCopyData(data))
+    {
+        std::stringstream errStrm;
+        errStrm << "PG_CopySink: copy into " << tableName << " failed";
+        throw std::runtime_error(errStrm.str());
+    }
+}
+
+void PG_CopySink::close()
+{
+    copying = false;
+    if(!inserter.endCopy())
+    {
+        std::stringstream errStrm;
+        errStrm << "PG_CopySink: copy into " << tableName << " failed";
+        throw std::runtime_error(errStrm.str());
+    }
+}
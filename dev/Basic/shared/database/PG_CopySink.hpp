@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "database/PG_BulkInserter.hpp"
+#include "util/OutputStreamer.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * Output sink streaming comma separated rows into a table with a single COPY ... FROM STDIN.
+ * The rows only become visible once the sink is closed; if the sink is destroyed before, the COPY is cancelled.
+ */
+class PG_CopySink : public OutputSink
+{
+public:
+    /**
+     * connects to the database and starts the COPY. Throws on failure.
+     * @param connectionStr database connection string
+     * @param tableName table to copy into, including the schema
+     * @param columnNames columns of the rows, in order
+     */
+    PG_CopySink(const std::string& connectionStr, const std::string& tableName, const std::vector<std::string>& columnNames);
+
+    virtual ~PG_CopySink();
+
+    virtual void write(const std::string& data);
+    virtual void close();
+
+private:
+    PG_BulkInserter inserter;
+    std::string tableName;
+
+    /** true while the COPY is in progress */
+    bool copying;
+};
+
+}
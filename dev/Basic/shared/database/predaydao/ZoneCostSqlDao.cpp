@@ -58,7 +58,7 @@ void CostSqlDao::toRow(CostParams& data, Parameters& outParams, bool update)
 {
 }
 
-bool CostSqlDao::getAll(boost::unordered_map<int, boost::unordered_map<int, CostParams*> >& outMap)
+bool CostSqlDao::getAll(SkimMatrix& outMatrix)
 {
 	bool hasValues = false;
 	if (isConnected())
@@ -66,12 +66,23 @@ bool CostSqlDao::getAll(boost::unordered_map<int, boost::unordered_map<int, Cost
 		Statement query(connection.getSession<soci::session>());
 		prepareStatement(defaultQueries[GET_ALL], EMPTY_PARAMS, query);
 		ResultSet rs(query);
+		CostParams costParams;
+		unsigned int numSkipped = 0;
 		for (ResultSet::const_iterator it = rs.begin(); it != rs.end(); ++it)
 		{
-			CostParams* costParams = new CostParams();
-			fromRow((*it), *costParams);
-			outMap[costParams->getOriginZone()][costParams->getDestinationZone()] = costParams;
-			hasValues = true;
+			fromRow((*it), costParams);
+			if (outMatrix.setCosts(costParams))
+			{
+				hasValues = true;
+			}
+			else
+			{
+				numSkipped++;
+			}
+		}
+		if (numSkipped > 0)
+		{
+			Warn() << numSkipped << " cost rows skipped since their origin or destination is not a known zone\n";
 		}
 	}
 	return hasValues;
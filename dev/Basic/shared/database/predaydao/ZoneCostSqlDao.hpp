@@ -8,6 +8,7 @@
 #include <string>
 #include "database/dao/SqlAbstractDao.hpp"
 #include "database/DB_Connection.hpp"
+#include "behavioral/params/SkimMatrix.hpp"
 #include "behavioral/params/ZoneCostParams.hpp"
 #include "behavioral/PredayUtils.hpp"
 #include <unordered_set>
@@ -23,16 +24,15 @@ namespace sim_mob
 class CostSqlDao : public db::SqlAbstractDao<CostParams>
 {
 public:
-    typedef boost::unordered_map<int, boost::unordered_map<int, CostParams*> > CostMap;
     CostSqlDao(db::DB_Connection& connection, const std::string& getAllQuery);
     virtual ~CostSqlDao();
 
     /**
      * getAll overload tailored for preday specific structure
-     * @param outMap 2D map of CostParams indexed by origin and destination zone
-     * @return true if outMap has been populated with at least 1 element; false otherwise
+     * @param outMatrix skim matrix to fill. Must have been initialized with the zones; rows of unknown zones are skipped
+     * @return true if outMatrix has been populated with at least 1 element; false otherwise
      */
-    bool getAll(boost::unordered_map<int, boost::unordered_map<int, CostParams*> >& outMap);
+    bool getAll(SkimMatrix& outMatrix);
 
 private:
     /**
@@ -95,7 +95,7 @@ void sim_mob::Agent::setIncrementIDStartValue(int startID, bool failIfAlreadyUse
 }
 
 sim_mob::Agent::Agent(const MutexStrategy& mtxStrat, int id) : Entity(getAndIncrementID(id)),
-mutexStrat(mtxStrat), initialized(false), xPos(mtxStrat, 0), yPos(mtxStrat, 0), toRemoved(false), lastUpdatedFrame(-1), dynamicSeed(id), currTick(0, 0)
+mutexStrat(mtxStrat), initialized(false), randomStream(getId()), xPos(mtxStrat, 0), yPos(mtxStrat, 0), toRemoved(false), lastUpdatedFrame(-1), dynamicSeed(id), currTick(0, 0)
 {
 }
 
@@ -202,6 +202,7 @@ UpdateStatus sim_mob::Agent::performUpdate(timeslice now)
 Entity::UpdateStatus sim_mob::Agent::update(timeslice now)
 {
     PROFILE_LOG_AGENT_UPDATE_BEGIN(currWorkerProvider, this, now);
+    RandomService::Scope randomScope(randomStream);
 
     //Update within an optional try/catch block.
     UpdateStatus retVal(UpdateStatus::RS_CONTINUE);
@@ -245,7 +246,7 @@ Entity::UpdateStatus sim_mob::Agent::update(timeslice now)
 
         //notify subscribers that this agent is done
         MessageBus::PublishEvent(event::EVT_CORE_AGENT_DIED, this,
-                                MessageBus::EventArgsPtr(new AgentLifeCycleEventArgs(getId(), this)));
+                                MessageBus::MakeEventArgs<AgentLifeCycleEventArgs>(getId(), this));
 
         //unsubscribes all listeners of this agent to this event.
         //(it is safe to do this here because the priority between events)
@@ -283,3 +284,8 @@ void sim_mob::Agent::onEvent(EventId eventId, Context ctxId, EventPublisher* sen
 void sim_mob::Agent::HandleMessage(messaging::Message::MessageType type, const messaging::Message& message)
 {
 }
+
+bool sim_mob::Agent::getLanePosition(WayPoint& wayPoint, double& distance) const
+{
+    return false;
+}
@@ -22,6 +22,7 @@
 #include "event/EventListener.hpp"
 #include "geospatial/RoadRunnerRegion.hpp"
 #include "logging/NullableOutputStream.hpp"
+#include "util/RandomService.hpp"
 
 namespace sim_mob
 {
@@ -35,6 +36,7 @@ class PackageUtils;
 class UnPackageUtils;
 class RoadSegment;
 class RoadRunnerRegion;
+struct WayPoint;
 
 //It is not a good design, now. Need to verify.
 //The class is used in Sim-Tree for Bottom-Up Query
@@ -87,6 +89,9 @@ private:
     /**Indicates if the agent has been initialised using the frame_init method*/
     bool initialized;
 
+    /**The random stream of the agent, current while the agent is updated*/
+    RandomStream randomStream;
+
 protected:
 
     /**Indicates if the agent is to be removed from the simulation*/
@@ -226,6 +231,18 @@ public:
      */
     virtual void HandleMessage(messaging::Message::MessageType type, const messaging::Message& message);
 
+    /**
+     * Retrieves the lane or the turning path the agent is moving on, and how far along it the agent is.
+     * Used by the spatial indices which order the agents along the lanes. Called while the spatial index is updated,
+     * possibly from several threads at once.
+     *
+     * @param wayPoint set to the lane or the turning path
+     * @param distance set to the distance covered on the lane or the turning path
+     *
+     * @return true, if the agent is on a lane or a turning path
+     */
+    virtual bool getLanePosition(WayPoint& wayPoint, double& distance) const;
+
     /**
      * Retrieves a monotonically-increasing unique ID value. Passing in a negative number will
      * always auto-assign an ID, and is recommended.
@@ -268,6 +285,17 @@ public:
         this->lastUpdatedFrame = lastUpdatedFrame;
     }
 
+    RandomStream& getRandomStream()
+    {
+        return randomStream;
+    }
+
+    /** messages are handled with the stream of the agent, as its updates */
+    virtual RandomStream* GetRandomStream()
+    {
+        return &randomStream;
+    }
+
     /**
      * This struct is used to track the Regions and Paths available to this Agent. This functionality is
      * ONLY used in RoadRunner, so putting it in Agent is not ideal. At the moment, I am not sure of the best
@@ -92,7 +92,8 @@ void sim_mob::long_term::Agent_LT::SetIncrementIDStartValue(int startID,bool fai
 }
 
 sim_mob::long_term::Agent_LT::Agent_LT( const MutexStrategy& mtxStrat, int id) : Entity(GetAndIncrementID(id)), mutexStrat(mtxStrat), initialized(false),
-                                        lastUpdatedFrame(-1),toRemoved(false), dynamic_seed(id), currTick(0,0){}
+                                        lastUpdatedFrame(-1),toRemoved(false), dynamic_seed(id), currTick(0,0),
+                                        randomStream(getId()){}
 
 sim_mob::long_term::Agent_LT::~Agent_LT(){}
 
@@ -283,6 +284,7 @@ bool sim_mob::long_term::Agent_LT::isNonspatial()
 
 Entity::UpdateStatus sim_mob::long_term::Agent_LT::update(timeslice now)
 {
+    RandomService::Scope randomScope(randomStream);
     return onFrameTick(now);
 }
 
@@ -22,6 +22,7 @@
 #include "entities/Entity.hpp"
 #include "logging/NullableOutputStream.hpp"
 #include "event/EventListener.hpp"
+#include "util/RandomService.hpp"
 
 namespace sim_mob
 {
@@ -125,6 +126,17 @@ namespace sim_mob
 
             void setLastUpdatedFrame(long lastUpdatedFrame);
 
+            RandomStream& getRandomStream()
+            {
+                return randomStream;
+            }
+
+            /** messages are handled with the stream of the agent, as its updates */
+            virtual RandomStream* GetRandomStream()
+            {
+                return &randomStream;
+            }
+
             bool isNonspatial();
 
             /**
@@ -223,6 +235,9 @@ namespace sim_mob
             std::map<std::string, std::string> configProperties;
 
             long lastUpdatedFrame; //Frame number in which the previous update of this agent took place
+
+            //Random stream of the agent, current while the agent is updated
+            RandomStream randomStream;
         };
     }
 }
@@ -5,6 +5,9 @@
 #include "AuraManager.hpp"
 
 #include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <boost/chrono/chrono.hpp>
 
 #include "entities/Entity.hpp"
 #include "entities/Agent.hpp"
@@ -12,11 +15,14 @@
 #include "geospatial/network/Point.hpp"
 #include "geospatial/network/WayPoint.hpp"
 
+#include "spatial_trees/AuraComparison.hpp"
 #include "spatial_trees/TreeImpl.hpp"
 #include "spatial_trees/rstar_tree/RStarAuraManager.hpp"
 #include "spatial_trees/simtree/SimAuraManager.hpp"
 #include "spatial_trees/rdu_tree/RDUAuraManager.hpp"
 #include "spatial_trees/packing_tree/PackingTreeAuraManager.hpp"
+#include "spatial_trees/incremental_tree/IncrementalTreeAuraManager.hpp"
+#include "spatial_trees/lane_index/LaneAuraManager.hpp"
 
 namespace sim_mob
 {
@@ -27,10 +33,11 @@ AuraManager AuraManager::instance_;
 // AuraManager
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void AuraManager::init(AuraManagerImplementation implType)
+void AuraManager::init(AuraManagerImplementation implType, unsigned int numThreads)
 {
     //Reset time tick.
     time_step = 0;
+    updateStats = UpdateStats();
 
     if (implType == IMPL_RSTAR)
     {
@@ -52,6 +59,16 @@ void AuraManager::init(AuraManagerImplementation implType)
         impl_ = new PackingTreeAuraManager();
         impl_->init();
     }
+    else if (implType == IMPL_INCREMENTAL)
+    {
+        impl_ = new IncrementalTreeAuraManager(std::max(numThreads, 1u));
+        impl_->init();
+    }
+    else if (implType == IMPL_LANE)
+    {
+        impl_ = new LaneAuraManager(std::max(numThreads, 1u));
+        impl_->init();
+    }
     else
     {
         throw std::runtime_error("Unknown AuraManager Implementation type selected.");
@@ -61,17 +78,53 @@ void AuraManager::init(AuraManagerImplementation implType)
 void AuraManager::destroy()
 {
     delete impl_;
+    if (traceFile.is_open())
+    {
+        traceFile.close();
+    }
+}
+
+void AuraManager::recordTrace(const std::string& fileName)
+{
+    traceFile.open(fileName.c_str());
+    if (!traceFile.is_open())
+    {
+        std::stringstream errStrm;
+        errStrm << "AuraManager: cannot open trace file " << fileName;
+        throw std::runtime_error(errStrm.str());
+    }
 }
 
 void AuraManager::update(const std::set<sim_mob::Entity *>& removedAgentPointers)
 {
+    if (traceFile.is_open())
+    {
+        AuraFrame frame;
+        AuraTrace::sampleAgents(Agent::all_agents, removedAgentPointers, frame);
+        AuraTrace::writeFrame(traceFile, frame);
+    }
+
     if (impl_)
     {
+        boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
         impl_->update(time_step, removedAgentPointers);
+        double seconds = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+        updateStats.numUpdates++;
+        updateStats.lastSeconds = seconds;
+        updateStats.lastSerialSeconds = std::max(seconds - impl_->getLastParallelSeconds(), 0.0);
+        updateStats.totalSeconds += updateStats.lastSeconds;
+        updateStats.totalSerialSeconds += updateStats.lastSerialSeconds;
     }
     time_step++;
 }
 
+void AuraManager::printUpdateStats(std::ostream& os) const
+{
+    os << "AuraManager: " << updateStats.numUpdates << " updates took " << updateStats.totalSeconds << " s, of which "
+       << updateStats.totalSerialSeconds << " s on a single thread\n";
+}
+
 std::vector<Agent const *> AuraManager::agentsInRect(Point const &lowerLeft, Point const &upperRight, const sim_mob::Agent *refAgent) const
 {
     std::vector<Agent const *> results;
@@ -95,6 +148,16 @@ std::vector<Agent const *> AuraManager::nearbyAgents(Point const &position, WayP
     return results;
 }
 
+void AuraManager::nearbyAgents(Point const &position, WayPoint const &wayPoint, double distanceInFront, double distanceBehind,
+                               const sim_mob::Agent *refAgent, std::vector<Agent const *> &result) const
+{
+    result.clear();
+    if (impl_)
+    {
+        impl_->nearbyAgents(position, wayPoint, distanceInFront, distanceBehind, refAgent, result);
+    }
+}
+
 void AuraManager::registerNewAgent(Agent const *one_agent)
 {
     if (impl_)
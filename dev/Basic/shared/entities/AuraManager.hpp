@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <fstream>
+#include <ostream>
+#include <set>
+#include <string>
 #include <vector>
 #include <boost/utility.hpp>
 
@@ -56,7 +60,36 @@ public:
         IMPL_RDU,
         
         /**R-Star with packing algorithm*/
-        IMPL_PACKING
+        IMPL_PACKING,
+
+        /**Packed leaves of nearby agents, updated incrementally on several threads*/
+        IMPL_INCREMENTAL,
+
+        /**Agents ordered along each lane and turning path*/
+        IMPL_LANE
+    };
+
+    /**Timing of the updates of the spatial index*/
+    struct UpdateStats
+    {
+        UpdateStats() : numUpdates(0), lastSeconds(0), lastSerialSeconds(0), totalSeconds(0), totalSerialSeconds(0)
+        {
+        }
+
+        /**Number of updates*/
+        unsigned int numUpdates;
+
+        /**Wall time of the last update*/
+        double lastSeconds;
+
+        /**Wall time of the last update during which a single thread was working*/
+        double lastSerialSeconds;
+
+        /**Wall time of all updates*/
+        double totalSeconds;
+
+        /**Wall time of all updates during which a single thread was working*/
+        double totalSerialSeconds;
     };
 
     static AuraManager& instance()
@@ -114,12 +147,22 @@ public:
     std::vector<Agent const *> nearbyAgents(Point const &position, WayPoint const &wayPoint, double distanceInFront, double distanceBehind,
                                             const Agent *refAgent) const;
 
+    /**
+     * Same as above, but stores the agents in result, so that callers querying every time step can reuse its storage.
+     *
+     * @param result cleared and filled with the agents
+     */
+    void nearbyAgents(Point const &position, WayPoint const &wayPoint, double distanceInFront, double distanceBehind,
+                      const Agent *refAgent, std::vector<Agent const *> &result) const;
+
     /**
      * Initialise the AuraManager object (to be invoked by the simulator kernel).
      *
-     * @param keepStats Keep statistics on internal operations if true.
+     * @param implType The implementation to use.
+     * @param numThreads The number of threads which may update the spatial index (IMPL_INCREMENTAL only). The
+     * workers are idle during the update, so this is typically the number of workers moving the agents.
      */
-    void init(AuraManagerImplementation implType);
+    void init(AuraManagerImplementation implType, unsigned int numThreads = 1);
 
     /**
      * Destroy the object implementing the AuraManager
@@ -132,6 +175,29 @@ public:
      */
     void registerNewAgent(Agent const *one_agent);
 
+    /**
+     * @return the timing of the updates so far. The serial time of an update is the time during which all workers
+     * but one were waiting for it to complete.
+     */
+    const UpdateStats& getUpdateStats() const
+    {
+        return updateStats;
+    }
+
+    /**
+     * Prints the timing of the updates so far
+     *
+     * @param os output stream
+     */
+    void printUpdateStats(std::ostream& os) const;
+
+    /**
+     * Records the positions of the agents at every update in a trace, which AuraComparison can replay
+     *
+     * @param fileName name of the trace file
+     */
+    void recordTrace(const std::string& fileName);
+
 private:
     AuraManager() : impl_(nullptr), time_step(0)
     {
@@ -144,6 +210,12 @@ private:
 
     //Current time step.
     int time_step;
+
+    //Timing of the updates.
+    UpdateStats updateStats;
+
+    //Trace of the agent positions, if recorded.
+    std::ofstream traceFile;
 };
 
 }
@@ -4,6 +4,7 @@
 
 #include "Entity.hpp"
 
+#include <algorithm>
 #include "buffering/BufferedDataManager.hpp"
 #include "logging/Log.hpp"
 
@@ -11,6 +12,12 @@ using std::string;
 using std::vector;
 using namespace sim_mob;
 
+namespace
+{
+/**delta buffer of the worker updating entities on the thread, if any*/
+thread_local Entity::UpdateStatus::DeltaBuffer* currentDeltaBuffer = nullptr;
+}
+
 //Implementation of our comparison function for Agents by start time.
 bool sim_mob::cmp_agent_start::operator()(const Entity* x, const Entity* y) const
 {
@@ -34,6 +41,7 @@ sim_mob::Entity::Entity(unsigned int id) :
         id(id), startTime(0), currWorkerProvider(nullptr), isFake(false), parentEntity(nullptr), isDuplicateFakeEntity(false), MessageHandler(id),
         multiUpdate(false)
 {
+    std::fill(storePositions, storePositions + NUM_STORE_SLOTS, 0);
 }
 
 sim_mob::Entity::~Entity()
@@ -55,24 +63,50 @@ vector<BufferedBase *> sim_mob::Entity::getSubscriptionList()
 
 sim_mob::Entity::UpdateStatus::UpdateStatus(UpdateStatus::RET_STATUS status, const vector<BufferedBase*>& currTickVals,
                                             const vector<BufferedBase*>& nextTickVals)
-: status(status)
+: status(status), deltaOffset(0), numToRemove(0), numToAdd(0)
 {
+    DeltaBuffer* buffer = currentDeltaBuffer;
+    if (!buffer || (currTickVals.empty() && nextTickVals.empty()))
+    {
+        return;
+    }
+
     //Any property not in the previous time tick but in the next is to be added. Any in the previous
     // but not in the next is to be removed. The rest remain throughout.
+    //These lists are a handful of items long, so they are searched linearly.
+    vector<BufferedBase*>& items = buffer->items;
+    deltaOffset = items.size();
     for (vector<BufferedBase*>::const_iterator it = currTickVals.begin(); it != currTickVals.end(); it++)
     {
-        toRemove.insert(*it);
+        if (std::find(nextTickVals.begin(), nextTickVals.end(), *it) == nextTickVals.end()
+            && std::find(items.begin() + deltaOffset, items.end(), *it) == items.end())
+        {
+            items.push_back(*it);
+            numToRemove++;
+        }
     }
-    
+
     for (vector<BufferedBase*>::const_iterator it = nextTickVals.begin(); it != nextTickVals.end(); it++)
     {
-        if (toRemove.erase(*it) == 0)
+        if (std::find(currTickVals.begin(), currTickVals.end(), *it) == currTickVals.end()
+            && std::find(items.begin() + deltaOffset + numToRemove, items.end(), *it) == items.end())
         {
-            toAdd.insert(*it);
+            items.push_back(*it);
+            numToAdd++;
         }
     }
 }
 
+sim_mob::Entity::UpdateStatus::DeltaBuffer::Scope::Scope(DeltaBuffer& buffer) : previous(currentDeltaBuffer)
+{
+    currentDeltaBuffer = &buffer;
+}
+
+sim_mob::Entity::UpdateStatus::DeltaBuffer::Scope::~Scope()
+{
+    currentDeltaBuffer = previous;
+}
+
 void sim_mob::Entity::onWorkerEnter()
 {
 }
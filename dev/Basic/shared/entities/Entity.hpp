@@ -11,6 +11,7 @@
 #include <vector>
 #include <stdexcept>
 #include <sstream>
+#include <boost/utility.hpp>
 
 #include "metrics/Frame.hpp"
 #include "util/LangHelpers.hpp"
@@ -104,9 +105,53 @@ public:
         static const UpdateStatus ContinueIncomplete;
         static const UpdateStatus Done;
 
+        /**
+         * Scratch buffer receiving the BufferedBase* items to remove/add of the statuses created by a thread.
+         * A worker makes its buffer the current buffer of its thread while it updates its entities, and clears
+         * it once their statuses are processed, so that no status allocates memory of its own.
+         */
+        class DeltaBuffer : private boost::noncopyable
+        {
+        public:
+            /**Makes a buffer the current buffer of the calling thread for the lifetime of the scope.*/
+            class Scope : private boost::noncopyable
+            {
+            public:
+                explicit Scope(DeltaBuffer& buffer);
+                ~Scope();
+
+            private:
+                DeltaBuffer* previous;
+            };
+
+            /**@return the first of the status.numToRemove items to remove*/
+            BufferedBase* const* getToRemove(const UpdateStatus& status) const
+            {
+                return items.data() + status.deltaOffset;
+            }
+
+            /**@return the first of the status.numToAdd items to add*/
+            BufferedBase* const* getToAdd(const UpdateStatus& status) const
+            {
+                return items.data() + status.deltaOffset + status.numToRemove;
+            }
+
+            /**Drops the items of all the statuses created so far.*/
+            void clear()
+            {
+                items.clear();
+            }
+
+        private:
+            friend struct UpdateStatus;
+
+            std::vector<BufferedBase*> items;
+        };
+
         /**
          * Note: Construction requires at least the return code.
-         * More complex construction takes two vectors of variables and extracts which ones are old/new.
+         * More complex construction takes two vectors of variables and extracts which ones are old/new. These are
+         * written to the current DeltaBuffer of the thread; they are dropped if the thread has none.
          */
         explicit UpdateStatus(RET_STATUS status, const std::vector<BufferedBase*>& currTickVals = std::vector<BufferedBase*>(),
                             const std::vector<BufferedBase*>& nextTickVals = std::vector<BufferedBase*>());
@@ -114,13 +159,19 @@ public:
         /**The return status*/
         RET_STATUS status;
 
-        /**BufferedBase* items to remove from the parent worker after this time tick.*/
-        std::set<BufferedBase*> toRemove;
+        /**Position of the items to remove, followed by the items to add, in the DeltaBuffer.*/
+        std::size_t deltaOffset;
+
+        /**Number of BufferedBase* items to remove from the parent worker after this time tick.*/
+        unsigned int numToRemove;
 
-        /**BufferedBase* items to add to the parent worker for the next time tick.*/
-        std::set<BufferedBase*> toAdd;
+        /**Number of BufferedBase* items to add to the parent worker for the next time tick.*/
+        unsigned int numToAdd;
     };
 
+    /**Number of entity stores (see EntityStore) an entity can be part of at the same time.*/
+    static const unsigned int NUM_STORE_SLOTS = 2;
+
     explicit Entity(unsigned int id);
     virtual ~Entity();
 
@@ -209,6 +260,11 @@ public:
     friend class Worker;
     friend class WorkerGroup;
     friend class PartitionManager;
+    friend class EntityStore;
+
+private:
+    /**Position of the entity in each of the entity stores it is part of; maintained by EntityStore.*/
+    std::size_t storePositions[NUM_STORE_SLOTS];
 };
 
 
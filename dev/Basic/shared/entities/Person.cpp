@@ -458,10 +458,8 @@ void sim_mob::Person::setPersonCharacteristics()
         highestAge = config.personCharacteristicsParams.highestAge;
     }
 
-    boost::mt19937 gen(static_cast<unsigned int> (getId() * getId()));
-    boost::uniform_int<> ageRange(lowestAge, highestAge);
-    boost::variate_generator < boost::mt19937, boost::uniform_int<int> > varAge(gen, ageRange);
-    age = (unsigned int) varAge();  
+    RandomStream personRandom(getId(), RANDOM_PERSON);
+    age = (unsigned int) personRandom.uniformInt(lowestAge, highestAge);
 }
 
 
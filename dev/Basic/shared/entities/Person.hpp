@@ -332,11 +332,6 @@ public:
         this->resetParamsRequired = resetParamsRequired;
     }
 
-    boost::mt19937& getGenerator()
-    {
-        return currWorkerProvider->getGenerator();
-    }
-
     void setNextPathPlanned(bool value)
     {
         nextPathPlanned = value;
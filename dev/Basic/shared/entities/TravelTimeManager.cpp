@@ -177,6 +177,30 @@ double sim_mob::LinkTravelTime::getInSimulationLinkTT(unsigned int downstreamLin
     return -1;
 }
 
+double sim_mob::LinkTravelTime::getInSimulationLinkTT(const DailyTime& dt) const
+{
+    TimeInterval timeInterval = getTimeInterval(dt.getValue());
+    if(timeInterval == 0)
+    {
+        return -1;
+    }
+    timeInterval -= 1;
+
+    boost::shared_lock<boost::shared_mutex> lock(ttMapMutex);
+    TimeAndCountStore::const_iterator tcIt = currentSimulationTT_Map.find(timeInterval);
+    if(tcIt == currentSimulationTT_Map.end() || tcIt->second.empty())
+    {
+        return -1;
+    }
+    const DownStreamLinkSpecificTimeAndCount_Map &tcMap = tcIt->second;
+    double totalTT = 0.0;
+    for(DownStreamLinkSpecificTimeAndCount_Map::const_iterator tcMapIt=tcMap.begin(); tcMapIt!=tcMap.end(); tcMapIt++)
+    {
+        totalTT = totalTT + tcMapIt->second.getTravelTime();
+    }
+    return (totalTT/tcMap.size());
+}
+
 void sim_mob::LinkTravelTime::dumpTravelTimesToFile(const std::string fileName) const
 {
     //  destination file
@@ -329,7 +353,15 @@ double sim_mob::TravelTimeManager::getLinkTT(const sim_mob::Link* lnk, const sim
     }
     else
     {
-        res = lnkTT.getHistoricalLinkTT(startTime);
+        if(useInSimulationTT)
+        {
+            res = lnkTT.getInSimulationLinkTT(startTime);
+        }
+
+        if(res <= 0.0)
+        {
+            res = lnkTT.getHistoricalLinkTT(startTime);
+        }
     }
 
     if (res <= 0.0)
@@ -383,6 +415,16 @@ double sim_mob::TravelTimeManager::getInSimulationLinkTT(const sim_mob::Link *ln
     return enRouteTT->getInSimulationLinkTT(lnk);
 }
 
+double sim_mob::TravelTimeManager::getInSimulationLinkTT(const sim_mob::Link *lnk, const sim_mob::DailyTime& dt) const
+{
+    std::map<unsigned int, sim_mob::LinkTravelTime>::const_iterator it = lnkTravelTimeMap.find(lnk->getLinkId());
+    if (it == lnkTravelTimeMap.end())
+    {
+        return -1;
+    }
+    return it->second.getInSimulationLinkTT(dt);
+}
+
 double sim_mob::TravelTimeManager::EnRouteTT::getInSimulationLinkTT(const sim_mob::Link *lnk) const
 {
     throw std::runtime_error("EnRouteTT::getInSimulationLinkTT not implemented");
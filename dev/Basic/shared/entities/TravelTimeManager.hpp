@@ -238,7 +238,7 @@ private:
     TimeAndCountStore currentSimulationTT_Map;
 
     /** mutex for adding travel times in currentSimulationTT_Map */
-    boost::shared_mutex ttMapMutex;
+    mutable boost::shared_mutex ttMapMutex;
 
 public:
     LinkTravelTime();
@@ -302,6 +302,14 @@ public:
      */
     double getInSimulationLinkTT(unsigned int downstreamLinkId, const DailyTime& dt) const;
 
+    /**
+     * fetches tt in seconds for the interval before the one of dt
+     * this function averages the traveltime for each downstream link and returns the average travel time
+     * @param dt time of day for which travel time is to be fetched
+     * @return tt found from currentSimulationTT_Map if available; -1 otherwise
+     */
+    double getInSimulationLinkTT(const DailyTime& dt) const;
+
     /**
      * fetches tt in seconds for provided time interval index
      * this function averages the traveltime for each downstream link and returns the average travel time
@@ -365,6 +373,15 @@ public:
      */
     double getInSimulationLinkTT(const sim_mob::Link *lnk) const;
 
+    /**
+     * returns the travel time experienced by the drivers in the current simulation, in the interval before the
+     * one of a time of day, averaged over the downstream links
+     * @param lnk target link
+     * @param dt time of day
+     * @return the travel time in seconds; -1 if no driver has crossed the link during the interval
+     */
+    double getInSimulationLinkTT(const sim_mob::Link *lnk, const sim_mob::DailyTime& dt) const;
+
     /**
      * simulation time interval in milliseconds
      */
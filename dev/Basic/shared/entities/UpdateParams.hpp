@@ -5,7 +5,6 @@
 #pragma once
 
 #include "metrics/Frame.hpp"
-#include <boost/random.hpp>
 
 namespace sim_mob
 {
@@ -17,10 +16,9 @@ namespace sim_mob
 ///Passed into Agent::frame_tick() and Agent::frame_tick_output().
 ///This class should only contain general properties; each Role should define its own subclass and return that
 /// in Agent::make_frame_tick_params().
-///Note that the mt19937 generator cannot be changed once this object is constructed.
+///Random numbers are drawn from the stream of the Agent being updated (see RandomService::current()).
 struct UpdateParams {
-    UpdateParams() : now(0,0), gen(local_gen){}
-    explicit UpdateParams(boost::mt19937& gen) : now(0,0), gen(gen) {}
+    UpdateParams() : now(0,0){}
     virtual ~UpdateParams(){
 
     }
@@ -32,10 +30,6 @@ struct UpdateParams {
 
     ///The current timeslice.
     timeslice now;
-    ///The local random number generator if no generator specified
-    boost::mt19937 local_gen;
-    ///The random number generator being used by this Agent.
-    boost::mt19937& gen;
 };
 
 
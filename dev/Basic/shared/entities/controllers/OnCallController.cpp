@@ -155,7 +155,7 @@ void OnCallController::onDriverShiftEnd(Person *driver)
         unsubscribeDriver(driver);
 
         MessageBus::PostMessage((MessageHandler *) driver, MSG_UNSUBSCRIBE_SUCCESSFUL,
-                                MessageBus::MessagePtr(new DriverUnsubscribeMessage(driver)));
+                                MessageBus::MakeMessage<DriverUnsubscribeMessage>(driver));
     }
     else
     {
@@ -164,7 +164,7 @@ void OnCallController::onDriverShiftEnd(Person *driver)
         //So, we send a delay shift-end message that forces the drivers to end their shifts only after finishing
         //the assigned schedule
         MessageBus::PostMessage((MessageHandler *) driver, MSG_DELAY_SHIFT_END,
-                                MessageBus::MessagePtr(new DelayShiftEndMessage(driver)));
+                                MessageBus::MakeMessage<DelayShiftEndMessage>(driver));
     }
 }
 
@@ -393,13 +393,11 @@ void OnCallController::assignSchedule(const Person *driver, const Schedule &sche
 
     if (!isUpdatedSchedule)
     {
-        MessageBus::PostMessage((MessageHandler *) driver, MSG_SCHEDULE_PROPOSITION, MessageBus::MessagePtr(
-                new SchedulePropositionMessage(currTick, schedule, (MessageHandler *) this)));
+        MessageBus::PostMessage((MessageHandler *) driver, MSG_SCHEDULE_PROPOSITION, MessageBus::MakeMessage<SchedulePropositionMessage>(currTick, schedule, (MessageHandler *) this));
     }
     else
     {
-        MessageBus::PostMessage((MessageHandler *) driver, MSG_SCHEDULE_UPDATE, MessageBus::MessagePtr(
-                new SchedulePropositionMessage(currTick, schedule, (MessageHandler *) this)));
+        MessageBus::PostMessage((MessageHandler *) driver, MSG_SCHEDULE_UPDATE, MessageBus::MakeMessage<SchedulePropositionMessage>(currTick, schedule, (MessageHandler *) this));
     }
 
 #ifndef NDEBUG
@@ -1091,8 +1089,8 @@ OnCallController::sendCruiseCommand(const Person *driver, const Node *nodeToCrui
 
 
     MessageBus::PostMessage((MessageHandler *) driver, MSG_SCHEDULE_PROPOSITION,
-                            MessageBus::MessagePtr(new SchedulePropositionMessage(currTick, schedule,
-                                                                                  (MessageHandler *) this)));
+                            MessageBus::MakeMessage<SchedulePropositionMessage>(currTick, schedule,
+                                                                                  (MessageHandler *) this));
 }
 
 double OnCallController::getTT(const Node *node1, const Node *node2, TT_EstimateType type) const
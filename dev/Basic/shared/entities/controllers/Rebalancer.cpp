@@ -20,6 +20,7 @@
 //#include "MobilityServiceController.hpp"
 #include "conf/ConfigManager.hpp"
 // } jo
+#include "util/RandomService.hpp"
 
 
 namespace sim_mob {
@@ -46,10 +47,10 @@ void SimpleRebalancer::rebalance(const std::vector<const Person*>& availableDriv
 {
     if (!availableDrivers.empty() && !latestStartNodes.empty() )
     {
-        int seed = 1;
-        srand(seed);
-        const Person* driver = availableDrivers[rand()%availableDrivers.size() ];
-        const Node* node = latestStartNodes[rand()%latestStartNodes.size()];
+        //drawn from the stream of the controller, which calls rebalance() while it is updated
+        RandomStream& random = RandomService::current();
+        const Person* driver = availableDrivers[random.uniformInt(0, availableDrivers.size() - 1)];
+        const Node* node = latestStartNodes[random.uniformInt(0, latestStartNodes.size() - 1)];
 
         parentController->sendCruiseCommand(driver, node, currTick );
         latestStartNodes.clear();
@@ -477,13 +478,11 @@ void KasiaRebalancer::rebalance(const std::vector<const Person*>& availableDrive
                 //                                VehicleStatus::MOVING_TO_REBALANCE, VehicleStatus::FREE);
 
                 // randomly select node in zone based on recent demand
-                int seed = 1;
-                srand(seed);
                 // const Person* driver = availableDrivers[rand()%availableDrivers.size() ];
                 int randNodeTaz; // random node in TAZ initialized here
                 const Node* node ;
                 do {
-                    node = latestStartNodes[rand()%latestStartNodes.size()];
+                    node = latestStartNodes[RandomService::current().uniformInt(0, latestStartNodes.size() - 1)];
                     randNodeTaz = node->getTazId();
                 } while (randNodeTaz != stDest);
 
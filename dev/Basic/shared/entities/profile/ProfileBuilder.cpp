@@ -142,6 +142,7 @@ void ProfileBuilder::logAuraManagerUpdateEnd(const AuraManager* auraMgr, uint32_
 {
     AuraManagerEndLogItem.currFrame = currFrame;
     AuraManagerEndLogItem.identity.first = auraMgr;
+    AuraManagerEndLogItem.serialMs = auraMgr->getUpdateStats().lastSerialSeconds * 1000;
     logGeneric(AuraManagerEndLogItem);
 }
 
@@ -349,6 +350,9 @@ void ProfileBuilder::logGeneric(const LogItem& item)
     if (item.numAgents >= 0) {
         currLog <<"\"" <<"num-agents" <<"\""      <<":" <<"\"" <<item.numAgents <<"\"" <<",";
     }
+    if (item.serialMs >= 0) {
+        currLog <<"\"" <<"serial-ms" <<"\""      <<":" <<"\"" <<item.serialMs <<"\"" <<",";
+    }
 
     //Optional properties.
     //for (std::map<std::string, std::string>::const_iterator it=props.begin(); it!=props.end(); it++) {
@@ -243,10 +243,11 @@ public:
         std::pair<const void*, std::string> secondIdentity;  //Null means don't show.
         int32_t currFrame; //-1 means don't show.
         int32_t numAgents; //-1 means don't show.
+        double serialMs; //Time spent on a single thread; negative means don't show.
 
         //Default most to off
         LogItem(const std::string& action, const std::string& identityLbl="", const std::string& secIdentLbl="") :
-            action(action), identity(nullptr, identityLbl), secondIdentity(nullptr,secIdentLbl),  currFrame(-1), numAgents(-1)
+            action(action), identity(nullptr, identityLbl), secondIdentity(nullptr,secIdentLbl),  currFrame(-1), numAgents(-1), serialMs(-1)
         {}
     };
 
@@ -13,13 +13,6 @@
 #include "util/LangHelpers.hpp"
 
 using namespace sim_mob::event;
-using boost::shared_mutex;
-using boost::shared_lock;
-using boost::upgrade_lock;
-using boost::upgrade_to_unique_lock;
-using std::map;
-using std::list;
-using std::pair;
 
 EM_EventArgs::EM_EventArgs() : EventArgs() {
 }
@@ -27,50 +20,20 @@ EM_EventArgs::EM_EventArgs() : EventArgs() {
 EM_EventArgs::~EM_EventArgs() {
 }
 
-EventManager::EventManager() : windows(TimeComparator()),
-currTime(timeslice(0, 0)) {
+EventManager::EventManager() : currTime(timeslice(0, 0)) {
     registerEvent(EM_WND_EXPIRED);
     registerEvent(EM_WND_UPDATED); // future...
 }
 
 EventManager::~EventManager() {
-    for (WindowMap::iterator itr = windows.begin(); itr != windows.end(); 
-            itr++) {
-        WindowList& wList = itr->second;
-        for (WindowList::iterator litr = wList.begin();
-                litr != wList.end(); litr++) {
-            TemporalWindow& window = *litr;
-        }
-        //clears the entry. 
-        wList.clear();
-    }
-    windows.clear();
 }
 
 void EventManager::update(const timeslice& currTime) {
-
     this->currTime = currTime;
-
-    {// synchronized scope
-        upgrade_lock<shared_mutex> upgradeLock(windowsMutex);
-        upgrade_to_unique_lock<shared_mutex> lock(upgradeLock);
-        WindowMap::iterator itr = windows.find(currTime);
-        if (itr != windows.end()) { //we have windows to update.
-            WindowList& wList = itr->second;
-            for (WindowList::iterator litr = wList.begin();
-                    litr != wList.end(); litr++) {
-                TemporalWindow& window = *litr;
-                if (window.isExpired(currTime)) {//only to confirm
-                    publish(EM_WND_EXPIRED, &window, EventArgs());
-                    // remove all subscribers for this window and event.
-                    unSubscribeAll(EM_WND_EXPIRED, &window);
-                }
-                //clears the entry. 
-                wList.clear();
-                windows.erase(currTime);
-            }
-        }
-    }
+    // windows targeting a past frame expire on the first update after 
+    // being scheduled.
+    WindowExpirer expirer(*this);
+    windows.advance(currTime.frame(), expirer);
 }
 
 void EventManager::schedule(const timeslice& target,
@@ -80,26 +43,40 @@ void EventManager::schedule(const timeslice& target,
 
 void EventManager::schedule(const timeslice& target, EventListenerPtr listener,
         Callback callback) {
-
-    {// synchronized scope
-        upgrade_lock<shared_mutex> upgradeLock(windowsMutex);
-        upgrade_to_unique_lock<shared_mutex> lock(upgradeLock);
-        WindowMap::iterator itr = windows.find(target);
-        WindowList* listPtr = nullptr;
-        if (itr == windows.end()) { // is not registered
-            MapRetVal ret = windows.insert(MapEntry(target, WindowList()));
-            listPtr = &(ret.first->second);
-        } else {
-            listPtr = &(itr->second);
-        }
-        TemporalWindow tw(currTime, target);
-        WindowList::iterator litr = listPtr->insert(listPtr->end(), tw);
-        if (callback) {
-            subscribe(EM_WND_EXPIRED, listener, callback, &(*litr));
-        } else {
-            subscribe(EM_WND_EXPIRED, listener, &(*litr));
-        }
+    if (!listener) {
+        return;
+    }
+    ScheduledWindow scheduled;
+    scheduled.window = TemporalWindow(currTime, target);
+    scheduled.listener = listener;
+    if (callback) {
+        scheduled.callback = callback;
+    } else {
+        scheduled.callback.reset(new CallbackImpl<EventListener, EventArgs>
+                (&EventListener::onEvent));
     }
+    windows.schedule(target.frame(), scheduled);
+}
+
+void EventManager::expire(ScheduledWindow& scheduled) {
+    TemporalWindow& window = scheduled.window;
+    EventArgs args;
+    // global listeners.
+    publish(EM_WND_EXPIRED, &window, args);
+    // window listener.
+    (*scheduled.callback)(scheduled.listener, EM_WND_EXPIRED, &window, this, 
+            args);
+}
+
+EventManager::ScheduledWindow::ScheduledWindow() : listener(nullptr) {
+}
+
+EventManager::WindowExpirer::WindowExpirer(EventManager& manager) 
+: manager(manager) {
+}
+
+void EventManager::WindowExpirer::operator()(ScheduledWindow& scheduled) {
+    manager.expire(scheduled);
 }
 
 /**
@@ -107,6 +84,10 @@ void EventManager::schedule(const timeslice& target, EventListenerPtr listener,
  * TEMPORAL WINDOW.
  *  
  */
+EventManager::TemporalWindow::TemporalWindow()
+: from(timeslice(0, 0)), to(timeslice(0, 0)) {
+}
+
 EventManager::TemporalWindow::TemporalWindow(const timeslice& from,
         const timeslice& to)
 : from(from), to(to) {
@@ -10,10 +10,9 @@
  */
 #pragma once
 
-#include <boost/thread.hpp>
-
 #include "EventPublisher.hpp"
 #include "metrics/Frame.hpp"
+#include "util/TimingWheel.hpp"
 
 /**
  * All external events must start with this id.
@@ -37,6 +36,9 @@ namespace sim_mob {
 
         /**
          * Event Publisher that allows time-based events. 
+         * 
+         * Windows are kept in a timing wheel keyed by frame. Any thread can 
+         * schedule a window; update() must be called by a single thread.
          */
         class EventManager : public EventPublisher {
         public:
@@ -45,6 +47,7 @@ namespace sim_mob {
 
             /**
              * Method to be called on which simulation update.
+             * Expires all the windows targeting this frame or an earlier one.
              * @param currTime current simulation time.
              */
             void update(const timeslice& currTime);
@@ -89,19 +92,6 @@ namespace sim_mob {
             void schedule(const timeslice& target, EventListenerPtr listener, 
                     Callback callback);
 
-            /**
-             * Timeslice comparator.
-             */
-            struct TimeComparator {
-
-                bool operator()(const timeslice& val1, 
-                                const timeslice& val2) const {
-                    return (val1.ms() < val2.ms() ||
-                            (val1.ms() == val2.ms() && 
-                            val1.frame() < val2.frame()));
-                }
-            };
-
             /**
              * Internal class to represent a temporal window.
              * @param from, start time.
@@ -109,6 +99,7 @@ namespace sim_mob {
              */
             class TemporalWindow {
             public:
+                TemporalWindow();
                 TemporalWindow(const timeslice& from, const timeslice& to);
                 virtual ~TemporalWindow();
 
@@ -135,15 +126,36 @@ namespace sim_mob {
                 timeslice to;
             };
 
-            typedef std::list<TemporalWindow> WindowList;
-            typedef std::map<timeslice, WindowList, TimeComparator> WindowMap;
-            typedef std::pair<WindowMap::iterator, bool> MapRetVal;
-            typedef std::pair<timeslice, WindowList> MapEntry;
+            /**
+             * A scheduled window with the listener to notify on expiry.
+             */
+            struct ScheduledWindow {
+                ScheduledWindow();
+
+                TemporalWindow window;
+                EventListenerPtr listener;
+                Callback callback;
+            };
+
+            /**
+             * Timing wheel handler: expires the windows handed back.
+             */
+            struct WindowExpirer {
+                WindowExpirer(EventManager& manager);
+                void operator()(ScheduledWindow& scheduled);
+
+                EventManager& manager;
+            };
+
+            /**
+             * Notifies the listeners of the expiry of a window.
+             * @param scheduled window.
+             */
+            void expire(ScheduledWindow& scheduled);
 
         private:
             timeslice currTime;
-            WindowMap windows;
-            mutable boost::shared_mutex windowsMutex;
+            ConcurrentTimingWheel<ScheduledWindow> windows;
         };
     }
 }
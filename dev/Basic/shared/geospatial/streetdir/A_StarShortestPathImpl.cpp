@@ -3,9 +3,13 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <queue>
 
 //for caching
+#include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
 
@@ -31,6 +35,129 @@ using namespace sim_mob;
 
 boost::shared_mutex A_StarShortestPathImpl::GraphSearchMutex;
 
+namespace
+{
+/**
+ * One-to-many Dijkstra searches over a graph, shared by the threads of A_StarShortestPathImpl::searchShortestPathCosts
+ */
+class ShortestPathCostSearch
+{
+public:
+    ShortestPathCostSearch(const StreetDirectory::Graph& graph, const vector<StreetDirectory::VertexDesc>& from,
+                           const vector<StreetDirectory::VertexDesc>& to, CostMatrix& matrix) :
+        graph(graph), from(from), to(to), matrix(matrix), isSink(boost::num_vertices(graph), false), numSinks(0)
+    {
+        for (vector<StreetDirectory::VertexDesc>::const_iterator it = to.begin(); it != to.end(); ++it)
+        {
+            if (it->valid && !isSink[it->sink])
+            {
+                isSink[it->sink] = true;
+                numSinks++;
+            }
+        }
+    }
+
+    /**
+     * Searches from the sources first, first + step, first + 2 * step...
+     */
+    void run(std::size_t first, std::size_t step) const
+    {
+        const std::size_t numVertices = boost::num_vertices(graph);
+        vector<double> dist(numVertices, CostMatrix::UNREACHABLE);
+        vector<double> cost(numVertices, CostMatrix::UNREACHABLE);
+        vector<bool> settled(numVertices, false);
+        vector<StreetDirectory::Vertex> reached;
+
+        for (std::size_t i = first; i < from.size(); i += step)
+        {
+            if (!from[i].valid)
+            {
+                continue;
+            }
+
+            search(from[i].source, dist, cost, settled, reached);
+
+            double* row = matrix.getRow(i);
+            for (std::size_t j = 0; j < to.size(); j++)
+            {
+                if (to[j].valid)
+                {
+                    row[j] = cost[to[j].sink];
+                }
+            }
+
+            for (vector<StreetDirectory::Vertex>::const_iterator it = reached.begin(); it != reached.end(); ++it)
+            {
+                dist[*it] = CostMatrix::UNREACHABLE;
+                cost[*it] = CostMatrix::UNREACHABLE;
+                settled[*it] = false;
+            }
+            reached.clear();
+        }
+    }
+
+private:
+    typedef std::pair<double, StreetDirectory::Vertex> QueueEntry;
+
+    /**
+     * Settles the vertices by increasing distance from the source, until all the sinks are settled. Records the
+     * vertices it reaches, so that the caller can reset them.
+     */
+    void search(StreetDirectory::Vertex source, vector<double>& dist, vector<double>& cost, vector<bool>& settled,
+                vector<StreetDirectory::Vertex>& reached) const
+    {
+        std::priority_queue<QueueEntry, vector<QueueEntry>, std::greater<QueueEntry> > queue;
+        dist[source] = 0;
+        cost[source] = 0;
+        reached.push_back(source);
+        queue.push(QueueEntry(0, source));
+
+        std::size_t sinksLeft = numSinks;
+        while (!queue.empty() && sinksLeft > 0)
+        {
+            StreetDirectory::Vertex u = queue.top().second;
+            queue.pop();
+            if (settled[u])
+            {
+                continue;
+            }
+            settled[u] = true;
+            if (isSink[u])
+            {
+                sinksLeft--;
+            }
+
+            StreetDirectory::Graph::out_edge_iterator edgeIt, edgeEnd;
+            for (boost::tie(edgeIt, edgeEnd) = boost::out_edges(u, graph); edgeIt != edgeEnd; ++edgeIt)
+            {
+                StreetDirectory::Vertex v = boost::target(*edgeIt, graph);
+                double weight = boost::get(boost::edge_weight, graph, *edgeIt);
+                if (dist[u] + weight < dist[v])
+                {
+                    if (dist[v] == CostMatrix::UNREACHABLE)
+                    {
+                        reached.push_back(v);
+                    }
+                    dist[v] = dist[u] + weight;
+                    cost[v] = cost[u] + ((boost::get(boost::edge_name, graph, *edgeIt).type == WayPoint::LINK) ? weight : 0);
+                    queue.push(QueueEntry(dist[v], v));
+                }
+            }
+        }
+    }
+
+    const StreetDirectory::Graph& graph;
+    const vector<StreetDirectory::VertexDesc>& from;
+    const vector<StreetDirectory::VertexDesc>& to;
+
+    /**Output; each thread writes the rows of its sources*/
+    CostMatrix& matrix;
+
+    vector<bool> isSink;
+    std::size_t numSinks;
+};
+}
+
 A_StarShortestPathImpl::A_StarShortestPathImpl(const RoadNetwork& network):isValidSegGraph(false)
 {
     if (sim_mob::ConfigManager::GetInstance().FullConfig().isGenerateBusRoutes()) {
@@ -674,6 +801,18 @@ std::vector<WayPoint> A_StarShortestPathImpl::GetShortestDrivingPath(const Stree
     }
 }
 
+void A_StarShortestPathImpl::GetShortestDrivingCosts(const vector<StreetDirectory::VertexDesc> &from, const vector<StreetDirectory::VertexDesc> &to,
+                                                     TimeRange timeRange, int randomGraphIdx, unsigned int numThreads, CostMatrix &matrix) const
+{
+    if (isValidSegGraph)
+    {
+        matrix.reset(from.size(), to.size());
+        return;
+    }
+
+    searchShortestPathCosts(drivingLinkMap, from, to, numThreads, matrix);
+}
+
 vector<WayPoint> A_StarShortestPathImpl::GetShortestDrivingPath(const StreetDirectory::VertexDesc &from, const StreetDirectory::VertexDesc &to,
                                                                 const std::vector<const RoadSegment *> &blacklist) const
 {
@@ -843,6 +982,42 @@ vector<WayPoint> A_StarShortestPathImpl::searchShortestPath(const StreetDirector
     return res;
 }
 
+void A_StarShortestPathImpl::searchShortestPathCosts(const StreetDirectory::Graph& graph, const vector<StreetDirectory::VertexDesc>& from,
+                                                     const vector<StreetDirectory::VertexDesc>& to, unsigned int numThreads, CostMatrix& matrix)
+{
+    matrix.reset(from.size(), to.size());
+    if (from.empty() || to.empty())
+    {
+        return;
+    }
+
+    //Lock for read access.
+    boost::shared_lock<boost::shared_mutex> lock(GraphSearchMutex);
+    const ShortestPathCostSearch search(graph, from, to, matrix);
+
+    if (numThreads == 0)
+    {
+        numThreads = std::max(boost::thread::hardware_concurrency(), 1u);
+    }
+    if (numThreads > from.size())
+    {
+        numThreads = from.size();
+    }
+
+    if (numThreads == 1)
+    {
+        search.run(0, 1);
+        return;
+    }
+
+    boost::thread_group threads;
+    for (unsigned int i = 0; i < numThreads; i++)
+    {
+        threads.create_thread(boost::bind(&ShortestPathCostSearch::run, &search, i, numThreads));
+    }
+    threads.join_all();
+}
+
 double A_StarShortestPathImpl::euclideanDist(const Point& pt1, const Point& pt2)
 {
     double dx = pt2.getX() - pt1.getX();
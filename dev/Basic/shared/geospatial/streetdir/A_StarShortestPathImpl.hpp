@@ -16,6 +16,7 @@
 #include <boost/utility.hpp>
 #include <boost/thread.hpp>
 
+#include "CostMatrix.hpp"
 #include "StreetDirectory.hpp"
 
 namespace sim_mob
@@ -320,6 +321,19 @@ public:
      * @return a shortest path
      */
     static std::vector<WayPoint> searchShortestPath(const StreetDirectory::Graph& graph, const StreetDirectory::Vertex& fromVertex, const StreetDirectory::Vertex& toVertex);
+    /**
+     * Computes the costs of the shortest paths from each source to each sink, as the sum of the weights of the LINK
+     * edges along the paths. Each source is searched by one Dijkstra sweep, which stops once all the sinks are
+     * settled; the sources are spread over several threads.
+     *
+     * @param graph is the graph object
+     * @param from the sources, in the order of the rows of the matrix; the invalid ones cannot reach any sink
+     * @param to the sinks, in the order of the columns of the matrix; the invalid ones cannot be reached
+     * @param numThreads the number of threads; 0 for one per core
+     * @param matrix output costs
+     */
+    static void searchShortestPathCosts(const StreetDirectory::Graph& graph, const std::vector<StreetDirectory::VertexDesc>& from,
+                                        const std::vector<StreetDirectory::VertexDesc>& to, unsigned int numThreads, CostMatrix& matrix);
 
 public:
     explicit A_StarShortestPathImpl(const RoadNetwork& network);
@@ -409,6 +423,15 @@ public:
      */
     virtual std::vector<WayPoint> GetShortestDrivingPath(const StreetDirectory::VertexDesc &from, const StreetDirectory::VertexDesc &to,
                                                         const std::vector<const Link*> &blacklist, TimeRange timeRange = Default, int randomGraphIdx = 0) const;
+    /**
+     * computes the lengths of the shortest driving paths from each origin to each destination
+     * @param from is the original vertices in the graph
+     * @param to is the destination vertices in the graph
+     * @param numThreads is the number of threads searching the paths
+     * @param matrix is the output lengths
+     */
+    virtual void GetShortestDrivingCosts(const std::vector<StreetDirectory::VertexDesc> &from, const std::vector<StreetDirectory::VertexDesc> &to,
+                                         TimeRange timeRange, int randomGraphIdx, unsigned int numThreads, CostMatrix &matrix) const;
     /**
      * Return the distance-based shortest path to drive from to another. Performs a search (currently using
      *  the A* algorithm) from one to another.
@@ -4,8 +4,6 @@
 
 #include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
-#include <boost/random/random_device.hpp>
-#include <boost/random.hpp>
 
 #include "geospatial/network/Lane.hpp"
 #include "geospatial/network/Link.hpp"
@@ -21,6 +19,7 @@
 #include "path/PathSetManager.hpp"
 #include "conf/ConfigParams.hpp"
 #include "conf/ConfigManager.hpp"
+#include "util/RandomService.hpp"
 #include "A_StarShortestTravelTimePathImpl.hpp"
 
 using std::map;
@@ -55,7 +54,9 @@ namespace
 A_StarShortestTravelTimePathImpl::A_StarShortestTravelTimePathImpl(const sim_mob::RoadNetwork& network)
 {
     //initialize random graph pool
-    int randomCount = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf().perturbationIteration;
+    //bulk generation perturbs the default graph with seeded weights instead (see PrivatePathsetGenerator::genRandPert)
+    const PathSetConf& pathSetConf = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf();
+    int randomCount = (pathSetConf.privatePathSetMode == "generation" ? 0 : pathSetConf.perturbationIteration);
     for (int i = 0; i < randomCount; ++i)
     {
         drivingMapRandomPool.push_back(StreetDirectory::Graph());
@@ -81,8 +82,11 @@ void A_StarShortestTravelTimePathImpl::initDrivingNetwork(const sim_mob::RoadNet
     NodeLookup nodeLookupHighwayBiasNormalTime;
     NodeLookup nodeLookupHighwayBiasDefault;
     std::vector<NodeLookup> nodeLookupRandomPool;
+    //the perturbations of a random graph depend only on the global seed and the index of the graph
+    std::vector<RandomStream> perturbationRandomPool;
     for (size_t i = 0; i < drivingMapRandomPool.size(); ++i) {
         nodeLookupRandomPool.push_back(NodeLookup());
+        perturbationRandomPool.push_back(RandomStream(i, RANDOM_PERTURBATION));
     }
 
     //Add our initial set of vertices. Iterate through Links to ensure no un-used Node are added.
@@ -114,7 +118,7 @@ void A_StarShortestTravelTimePathImpl::initDrivingNetwork(const sim_mob::RoadNet
 //      procAddDrivingLinks(drivingMapHighwayBiasNormalTime, iter->second, nodeLookupHighwayBiasNormalTime, drivingLinkLookupHighwayBiasNormalTime,getEdgeWeight(iter->second,HighwayBiasOffPeak));
         procAddDrivingLinks(drivingMapHighwayBiasDefault, iter->second, nodeLookupHighwayBiasDefault,drivingLinkLookupHighwayBiasDefault, drivingLinkVertexLookupHighwayBiasDefault, getEdgeWeight(iter->second,HighwayBiasDefault));
         for (size_t i = 0; i < drivingMapRandomPool.size(); ++i) {
-        procAddDrivingLinks(drivingMapRandomPool[i], iter->second,nodeLookupRandomPool[i], drivingLinkLookupRandomPool[i], drivingLinkVertexLookupRandomPool[i], getEdgeWeight(iter->second,Random));
+        procAddDrivingLinks(drivingMapRandomPool[i], iter->second,nodeLookupRandomPool[i], drivingLinkLookupRandomPool[i], drivingLinkVertexLookupRandomPool[i], getEdgeWeight(iter->second,Random,&perturbationRandomPool[i]));
         }
     }
 
@@ -148,7 +152,7 @@ void A_StarShortestTravelTimePathImpl::initDrivingNetwork(const sim_mob::RoadNet
     }
 }
 
-double A_StarShortestTravelTimePathImpl::getEdgeWeight(const sim_mob::Link* link, sim_mob::TimeRange timeRange)
+double A_StarShortestTravelTimePathImpl::getEdgeWeight(const sim_mob::Link* link, sim_mob::TimeRange timeRange, RandomStream* random)
 {
     const TravelTimeManager* ttMgr = TravelTimeManager::getInstance();
     double highwayBias = PathSetParam::getInstance()->getHighwayBias();
@@ -228,12 +232,12 @@ double A_StarShortestTravelTimePathImpl::getEdgeWeight(const sim_mob::Link* link
     }
     case sim_mob::Random:
     {
-        boost::random_device seedGen;
-        boost::mt19937 rng(seedGen());
+        if (!random)
+        {
+            throw std::runtime_error("edge weight of a random graph requested without its random stream");
+        }
         const std::pair<int, int> &range = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf().perturbationRange;
-        boost::uniform_int<> uniformInt(range.first, range.second);
-        boost::variate_generator<boost::mt19937, boost::uniform_int<> > rollDice(rng, uniformInt);
-        edgeWeight = rollDice() * ttMgr->getDefaultLinkTT(link); //randomNo * defTT
+        edgeWeight = random->uniformInt(range.first, range.second) * ttMgr->getDefaultLinkTT(link); //randomNo * defTT
         if (edgeWeight <= 0)
         {
             std::stringstream out("");
@@ -256,6 +260,7 @@ StreetDirectory::VertexDesc A_StarShortestTravelTimePathImpl::DrivingVertex(cons
     switch (timeRange)
         {
         case Default:
+        case InSimulation:
             res = DrivingVertexDefault(node);
             break;
         case HighwayBiasDefault:
@@ -276,6 +281,7 @@ StreetDirectory::VertexDesc A_StarShortestTravelTimePathImpl::DrivingVertex(cons
     switch (timeRange)
     {
         case Default:
+        case InSimulation:
             res = DrivingVertexDefault(link);
             break;
         case HighwayBiasDefault:
@@ -605,6 +611,36 @@ vector<WayPoint> A_StarShortestTravelTimePathImpl::searchShortestTTPath(const St
     return res;
 }
 
+void A_StarShortestTravelTimePathImpl::GetShortestDrivingCosts(const vector<StreetDirectory::VertexDesc>& from, const vector<StreetDirectory::VertexDesc>& to,
+                                                               TimeRange tmRange, int randomGraphId, unsigned int numThreads, CostMatrix& matrix) const
+{
+    if (tmRange == Default || tmRange == InSimulation)
+    {
+        searchShortestPathCosts(drivingMapDefault, from, to, numThreads, matrix);
+    }
+    else if (tmRange == HighwayBiasDistance)
+    {
+        searchShortestPathCosts(drivingMapHighwayBiasDistance, from, to, numThreads, matrix);
+    }
+    else if (tmRange == HighwayBiasDefault)
+    {
+        searchShortestPathCosts(drivingMapHighwayBiasDefault, from, to, numThreads, matrix);
+    }
+    else if (tmRange == Random)
+    {
+        if (randomGraphId < 0 || randomGraphId >= drivingMapRandomPool.size())
+        {
+            matrix.reset(from.size(), to.size());
+            return;
+        }
+        searchShortestPathCosts(drivingMapRandomPool[randomGraphId], from, to, numThreads, matrix);
+    }
+    else
+    {
+        throw std::runtime_error("A_StarShortestTravelTimePathImpl: unknown time range");
+    }
+}
+
 vector<sim_mob::WayPoint> A_StarShortestTravelTimePathImpl::GetShortestDrivingPath(
         const StreetDirectory::VertexDesc& from, const StreetDirectory::VertexDesc& to,
         const vector<const sim_mob::Link*>& blacklist, TimeRange tmRange,int randomGraphId) const
@@ -650,7 +686,7 @@ vector<sim_mob::WayPoint> A_StarShortestTravelTimePathImpl::GetShortestDrivingPa
 //          }
 //      }
 //      else
-        if (tmRange == Default)
+        if (tmRange == Default || tmRange == InSimulation)
         {
             LinkEdgeLookup::const_iterator lookIt = drivingLinkLookupDefault.find(*it);
             if (lookIt != drivingLinkLookupDefault.end())
@@ -733,7 +769,7 @@ vector<sim_mob::WayPoint> A_StarShortestTravelTimePathImpl::GetShortestDrivingPa
 //          return searchShortestPath(drivingMapNormalTime, fromV, toV);
 //      }
 //      else
-        if (tmRange == Default)
+        if (tmRange == Default || tmRange == InSimulation)
         {
             return searchShortestTTPath(drivingMapDefault, fromV, toV);
         }
@@ -787,7 +823,7 @@ vector<sim_mob::WayPoint> A_StarShortestTravelTimePathImpl::GetShortestDrivingPa
 //          return searchShortestPathWithBlackList(drivingMapNormalTime, fromV, toV, blacklistV);
 //      }
 //      else
-        if (tmRange == Default)
+        if (tmRange == Default || tmRange == InSimulation)
         {
             return searchShortestTTPathWithBlackList(drivingMapDefault, fromV, toV, blacklistV);
         }
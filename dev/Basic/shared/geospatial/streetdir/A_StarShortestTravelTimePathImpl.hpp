@@ -13,6 +13,7 @@ class Node;
 class Link;
 class RoadSegment;
 class RoadNetwork;
+class RandomStream;
 
 class A_StarShortestTravelTimePathImpl: public A_StarShortestPathImpl {
 public:
@@ -45,6 +46,18 @@ public:
             const std::vector<const sim_mob::Link*>& blacklist,
             sim_mob::TimeRange timeRange = sim_mob::Default, int randomGraphId = 0) const;
 
+    /**
+     * computes the travel times of the shortest travel-time driving paths from each origin to each destination
+     * @param from is the original vertices in the graph of timeRange
+     * @param to is the destination vertices in the graph of timeRange
+     * @param timeRange indicate what time range is wanted
+     * @param randomGraphId indicate the index of random-time graphs' group
+     * @param numThreads is the number of threads searching the paths
+     * @param matrix is the output travel times
+     */
+    virtual void GetShortestDrivingCosts(const std::vector<StreetDirectory::VertexDesc>& from, const std::vector<StreetDirectory::VertexDesc>& to,
+                                         sim_mob::TimeRange timeRange, int randomGraphId, unsigned int numThreads, CostMatrix& matrix) const;
+
     /**
      * Search shortest path with black list.
      *
@@ -272,9 +285,10 @@ private:
      * Get edge weight for different time range
      * @param timeRange indicate what time range is wanted
      * @param link is a pointer to the current link
+     * @param random stream drawing the perturbation of the link, for the Random time range
      * @return weight value for input time range
      */
-    double getEdgeWeight(const sim_mob::Link* link, sim_mob::TimeRange timeRange);
+    double getEdgeWeight(const sim_mob::Link* link, sim_mob::TimeRange timeRange, RandomStream* random = nullptr);
 //  /**
 //   * retrieve a vertex in the travel-time graph for the morning peak hours
 //   * @param node is a pointer to the node
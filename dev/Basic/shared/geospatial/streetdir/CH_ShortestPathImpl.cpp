@@ -0,0 +1,108 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "CH_ShortestPathImpl.hpp"
+
+#include <random>
+#include <boost/chrono.hpp>
+
+using namespace sim_mob;
+
+using std::vector;
+
+CH_ShortestPathImpl::CH_ShortestPathImpl(const RoadNetwork& network) : A_StarShortestPathImpl(network)
+{
+    if (!isValidSegGraph)
+    {
+        hierarchy.reset(new ContractionHierarchy(drivingLinkMap));
+    }
+}
+
+CH_ShortestPathImpl::~CH_ShortestPathImpl()
+{
+}
+
+vector<WayPoint> CH_ShortestPathImpl::GetShortestDrivingPath(const StreetDirectory::VertexDesc &from, const StreetDirectory::VertexDesc &to,
+                                                             const std::vector<const Link*> &blacklist, TimeRange timeRange, int randomGraphIdx) const
+{
+    if (!hierarchy || !blacklist.empty())
+    {
+        return A_StarShortestPathImpl::GetShortestDrivingPath(from, to, blacklist, timeRange, randomGraphIdx);
+    }
+
+    vector<WayPoint> res;
+    if (from.valid && to.valid)
+    {
+        hierarchy->searchShortestPath(from.source, to.sink, res);
+    }
+    return res;
+}
+
+void CH_ShortestPathImpl::benchmark(unsigned int numPairs, std::ostream &out) const
+{
+    if (!hierarchy)
+    {
+        return;
+    }
+
+    vector<StreetDirectory::Vertex> origins;
+    vector<StreetDirectory::Vertex> destinations;
+    for (NodeVertexLookup::const_iterator it = drivingNodeLookup.begin(); it != drivingNodeLookup.end(); ++it)
+    {
+        origins.push_back(it->second.first);
+        destinations.push_back(it->second.second);
+    }
+
+    benchmarkShortestPaths("distance", drivingLinkMap, *hierarchy, &A_StarShortestPathImpl::searchShortestPath, origins, destinations,
+                           numPairs, out);
+}
+
+void sim_mob::benchmarkShortestPaths(const std::string &name, const StreetDirectory::Graph &graph, const ContractionHierarchy &hierarchy,
+                                     ShortestPathSearch search, const vector<StreetDirectory::Vertex> &origins,
+                                     const vector<StreetDirectory::Vertex> &destinations, unsigned int numPairs, std::ostream &out)
+{
+    if (origins.empty() || destinations.empty() || numPairs == 0)
+    {
+        return;
+    }
+
+    //Fixed seed, so that runs on the same network query the same pairs
+    std::mt19937 rng(numPairs);
+    std::uniform_int_distribution<std::size_t> origin(0, origins.size() - 1);
+    std::uniform_int_distribution<std::size_t> destination(0, destinations.size() - 1);
+    vector< std::pair<StreetDirectory::Vertex, StreetDirectory::Vertex> > pairs(numPairs);
+    for (unsigned int i = 0; i < numPairs; i++)
+    {
+        pairs[i] = std::make_pair(origins[origin(rng)], destinations[destination(rng)]);
+    }
+
+    vector< vector<WayPoint> > aStarPaths(numPairs);
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numPairs; i++)
+    {
+        aStarPaths[i] = search(graph, pairs[i].first, pairs[i].second);
+    }
+    double aStarTime = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    vector< vector<WayPoint> > paths(numPairs);
+    start = boost::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numPairs; i++)
+    {
+        hierarchy.searchShortestPath(pairs[i].first, pairs[i].second, paths[i]);
+    }
+    double time = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    //A* may settle for a longer path when its heuristic overestimates the cost (e.g. travel times)
+    unsigned int numDifferent = 0;
+    for (unsigned int i = 0; i < numPairs; i++)
+    {
+        numDifferent += (aStarPaths[i] == paths[i]) ? 0 : 1;
+    }
+
+    out << "Shortest path benchmark, " << name << " graph (" << boost::num_vertices(graph) << " vertices, " << boost::num_edges(graph)
+        << " edges, " << hierarchy.getNumShortcuts() << " shortcuts), " << numPairs << " random OD pairs:\n"
+        << "  A*: " << aStarTime * 1e6 / numPairs << " us/query\n"
+        << "  contraction hierarchy: " << time * 1e6 / numPairs << " us/query\n"
+        << "  different paths: " << numDifferent << "\n";
+}
@@ -0,0 +1,79 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+
+#include "A_StarShortestPathImpl.hpp"
+#include "ContractionHierarchy.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * Shortest distance driving paths, answered by a contraction hierarchy of the link graph of A_StarShortestPathImpl.
+ *
+ * The queries with a blacklist are still answered by A*, as the blacklisted edges may be inside shortcuts. The
+ * segment graph (built to generate bus routes) is not contracted either.
+ */
+class CH_ShortestPathImpl : public A_StarShortestPathImpl
+{
+public:
+    explicit CH_ShortestPathImpl(const RoadNetwork& network);
+    virtual ~CH_ShortestPathImpl();
+
+    /**
+     * Retrieves the shortest driving path from the origin to the destination
+     *
+     * @param from the origin vertex
+     * @param to the destination vertex
+     * @param blacklist the links to avoid; the path is searched by A* unless it is empty
+     * @param timeRange unused
+     * @param randomGraphIdx unused
+     *
+     * @return the WayPoints of the path; empty if there is none
+     */
+    virtual std::vector<WayPoint> GetShortestDrivingPath(const StreetDirectory::VertexDesc &from, const StreetDirectory::VertexDesc &to,
+                                                         const std::vector<const Link *> &blacklist, TimeRange timeRange = Default,
+                                                         int randomGraphIdx = 0) const;
+
+    using A_StarShortestPathImpl::GetShortestDrivingPath;
+
+    /**
+     * Compares the query times of A* and of the contraction hierarchy on random OD pairs of the network
+     *
+     * @param numPairs the number of OD pairs
+     * @param out stream to print the results to
+     */
+    void benchmark(unsigned int numPairs, std::ostream &out) const;
+
+private:
+    /**The hierarchy of drivingLinkMap; null if the segment graph was built instead*/
+    boost::scoped_ptr<ContractionHierarchy> hierarchy;
+};
+
+/**A* search on a driving graph, as done by A_StarShortestPathImpl::searchShortestPath*/
+typedef std::vector<WayPoint> (*ShortestPathSearch)(const StreetDirectory::Graph &, const StreetDirectory::Vertex &, const StreetDirectory::Vertex &);
+
+/**
+ * Compares the query times of A* and of the contraction hierarchy of a graph on random OD pairs, and prints them
+ *
+ * @param name the name of the graph in the results
+ * @param graph the graph
+ * @param hierarchy the hierarchy of the graph
+ * @param search the A* search on the graph
+ * @param origins the vertices the OD pairs may start from
+ * @param destinations the vertices the OD pairs may end at
+ * @param numPairs the number of OD pairs
+ * @param out stream to print the results to
+ */
+void benchmarkShortestPaths(const std::string &name, const StreetDirectory::Graph &graph, const ContractionHierarchy &hierarchy,
+                            ShortestPathSearch search, const std::vector<StreetDirectory::Vertex> &origins,
+                            const std::vector<StreetDirectory::Vertex> &destinations, unsigned int numPairs, std::ostream &out);
+
+}
@@ -0,0 +1,121 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "CH_ShortestTravelTimePathImpl.hpp"
+
+#include "CH_ShortestPathImpl.hpp"
+#include "entities/TravelTimeManager.hpp"
+
+using namespace sim_mob;
+
+using std::vector;
+
+CH_ShortestTravelTimePathImpl::CH_ShortestTravelTimePathImpl(const RoadNetwork& network) : A_StarShortestTravelTimePathImpl(network),
+    hierarchyDefault(new ContractionHierarchy(drivingMapDefault)),
+    hierarchyHighwayBiasDistance(new ContractionHierarchy(drivingMapHighwayBiasDistance)),
+    hierarchyHighwayBiasDefault(new ContractionHierarchy(drivingMapHighwayBiasDefault))
+{
+}
+
+CH_ShortestTravelTimePathImpl::~CH_ShortestTravelTimePathImpl()
+{
+}
+
+void CH_ShortestTravelTimePathImpl::getOriginsAndDestinations(const NodeVertexLookup &lookup, vector<StreetDirectory::Vertex> &origins,
+                                                              vector<StreetDirectory::Vertex> &destinations)
+{
+    for (NodeVertexLookup::const_iterator it = lookup.begin(); it != lookup.end(); ++it)
+    {
+        origins.push_back(it->second.first);
+        destinations.push_back(it->second.second);
+    }
+}
+
+const ContractionHierarchy* CH_ShortestTravelTimePathImpl::getHierarchy(TimeRange timeRange) const
+{
+    switch (timeRange)
+    {
+    case Default:
+        return hierarchyDefault.get();
+    case HighwayBiasDistance:
+        return hierarchyHighwayBiasDistance.get();
+    case HighwayBiasDefault:
+        return hierarchyHighwayBiasDefault.get();
+    default:
+        return nullptr;
+    }
+}
+
+vector<WayPoint> CH_ShortestTravelTimePathImpl::GetShortestDrivingPath(const StreetDirectory::VertexDesc &from, const StreetDirectory::VertexDesc &to,
+                                                                       const std::vector<const Link*> &blacklist, TimeRange timeRange,
+                                                                       int randomGraphId) const
+{
+    if (timeRange == InSimulation && hierarchyInSimulation && blacklist.empty())
+    {
+        vector<WayPoint> res;
+        if (from.valid && to.valid)
+        {
+            hierarchyInSimulation->searchShortestPath(from.source, to.sink, res);
+        }
+        return res;
+    }
+
+    const ContractionHierarchy *hierarchy = getHierarchy(timeRange);
+    if (!hierarchy || !blacklist.empty())
+    {
+        return A_StarShortestTravelTimePathImpl::GetShortestDrivingPath(from, to, blacklist, timeRange, randomGraphId);
+    }
+
+    vector<WayPoint> res;
+    if (from.valid && to.valid)
+    {
+        hierarchy->searchShortestPath(from.source, to.sink, res);
+    }
+    return res;
+}
+
+void CH_ShortestTravelTimePathImpl::refreshInSimulationTravelTimes(const DailyTime &time)
+{
+    //contracted on the first refresh only, so that runs which never refresh do not pay for it
+    if (!hierarchyInSimulation)
+    {
+        hierarchyInSimulation.reset(new CustomizableContractionHierarchy(drivingMapDefault));
+    }
+
+    const TravelTimeManager *ttMgr = TravelTimeManager::getInstance();
+    const vector<WayPoint> &wayPoints = hierarchyInSimulation->getEdgeWayPoints();
+    vector<double> weights(hierarchyInSimulation->getEdgeWeights());
+
+    for (std::size_t i = 0; i < wayPoints.size(); i++)
+    {
+        if (wayPoints[i].type == WayPoint::LINK)
+        {
+            //the travel time the drivers using the in-simulation travel times expect on the link
+            weights[i] = ttMgr->getLinkTT(wayPoints[i].link, time, nullptr, true);
+        }
+    }
+
+    hierarchyInSimulation->customize(weights);
+}
+
+void CH_ShortestTravelTimePathImpl::benchmark(unsigned int numPairs, std::ostream &out) const
+{
+    vector<StreetDirectory::Vertex> origins;
+    vector<StreetDirectory::Vertex> destinations;
+    getOriginsAndDestinations(drivingNodeLookupDefault, origins, destinations);
+    benchmarkShortestPaths("default travel time", drivingMapDefault, *hierarchyDefault, &A_StarShortestTravelTimePathImpl::searchShortestTTPath,
+                           origins, destinations, numPairs, out);
+
+    origins.clear();
+    destinations.clear();
+    getOriginsAndDestinations(drivingNodeLookupHighwayBiasDistance, origins, destinations);
+    benchmarkShortestPaths("highway bias distance", drivingMapHighwayBiasDistance, *hierarchyHighwayBiasDistance,
+                           &A_StarShortestTravelTimePathImpl::searchShortestTTPath, origins, destinations, numPairs, out);
+
+    origins.clear();
+    destinations.clear();
+    getOriginsAndDestinations(drivingNodeLookupHighwayBiasDefault, origins, destinations);
+    benchmarkShortestPaths("highway bias travel time", drivingMapHighwayBiasDefault, *hierarchyHighwayBiasDefault,
+                           &A_StarShortestTravelTimePathImpl::searchShortestTTPath, origins, destinations, numPairs, out);
+}
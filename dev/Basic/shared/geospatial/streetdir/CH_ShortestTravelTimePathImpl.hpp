@@ -0,0 +1,88 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+
+#include "A_StarShortestTravelTimePathImpl.hpp"
+#include "ContractionHierarchy.hpp"
+#include "CustomizableContractionHierarchy.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * Shortest travel time driving paths, answered by contraction hierarchies of the Default, HighwayBiasDistance and
+ * HighwayBiasDefault graphs of A_StarShortestTravelTimePathImpl.
+ *
+ * The InSimulation time range is answered by a customizable contraction hierarchy of the Default graph, whose link
+ * travel times are replaced by those of the current simulation by refreshInSimulationTravelTimes(). That hierarchy is
+ * built by the first refresh; until then, the InSimulation queries are searched by A*.
+ *
+ * The Random graphs are each used by few queries, so contracting them would not pay off; they are still searched by
+ * A*, as are the queries with a blacklist.
+ */
+class CH_ShortestTravelTimePathImpl : public A_StarShortestTravelTimePathImpl
+{
+public:
+    explicit CH_ShortestTravelTimePathImpl(const RoadNetwork& network);
+    virtual ~CH_ShortestTravelTimePathImpl();
+
+    /**
+     * Retrieves the shortest travel time driving path from the origin to the destination
+     *
+     * @param from the origin vertex, in the graph of timeRange
+     * @param to the destination vertex, in the graph of timeRange
+     * @param blacklist the links to avoid; the path is searched by A* unless it is empty
+     * @param timeRange the graph to search
+     * @param randomGraphId the index of the graph in the pool, for the Random time range
+     *
+     * @return the WayPoints of the path; empty if there is none
+     */
+    virtual std::vector<WayPoint> GetShortestDrivingPath(const StreetDirectory::VertexDesc &from, const StreetDirectory::VertexDesc &to,
+                                                         const std::vector<const Link *> &blacklist, TimeRange timeRange = Default,
+                                                         int randomGraphId = 0) const;
+
+    using A_StarShortestTravelTimePathImpl::GetShortestDrivingPath;
+
+    /**
+     * Compares the query times of A* and of the contraction hierarchies on random OD pairs of the network
+     *
+     * @param numPairs the number of OD pairs, per graph
+     * @param out stream to print the results to
+     */
+    void benchmark(unsigned int numPairs, std::ostream &out) const;
+
+    /**
+     * Customizes the hierarchy of the InSimulation time range with the travel times of the links in the current
+     * simulation, in the interval before the one of a time of day, as given by TravelTimeManager::getLinkTT. The links
+     * which no driver has crossed during that interval take their historical or default travel time. Builds the
+     * hierarchy on the first call.
+     *
+     * @param time the time of day
+     */
+    void refreshInSimulationTravelTimes(const DailyTime &time);
+
+private:
+    /**
+     * @return the hierarchy of the graph of a time range; null if that graph is not contracted
+     */
+    const ContractionHierarchy* getHierarchy(TimeRange timeRange) const;
+
+    /**
+     * Appends the vertices the trips from and to the nodes of a graph start and end at
+     */
+    static void getOriginsAndDestinations(const NodeVertexLookup &lookup, std::vector<StreetDirectory::Vertex> &origins,
+                                          std::vector<StreetDirectory::Vertex> &destinations);
+
+    boost::scoped_ptr<ContractionHierarchy> hierarchyDefault;
+    boost::scoped_ptr<ContractionHierarchy> hierarchyHighwayBiasDistance;
+    boost::scoped_ptr<ContractionHierarchy> hierarchyHighwayBiasDefault;
+    boost::scoped_ptr<CustomizableContractionHierarchy> hierarchyInSimulation;
+};
+
+}
@@ -0,0 +1,594 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "ContractionHierarchy.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+using namespace sim_mob;
+
+namespace
+{
+/**Number of vertices settled by a witness search before it gives up (adding a shortcut which may not be needed)*/
+const std::size_t MAX_WITNESS_SETTLED = 500;
+
+/**Number of vertices settled by the witness searches which only estimate the priority of a vertex*/
+const std::size_t MAX_SIMULATED_WITNESS_SETTLED = 50;
+
+const double INFINITE_COST = std::numeric_limits<double>::infinity();
+
+/**Entry of the priority queues of the searches, ordered by cost*/
+typedef std::pair<double, unsigned int> HeapEntry;
+typedef std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > Heap;
+}
+
+const unsigned int ContractionHierarchy::NO_VERTEX;
+
+struct ContractionHierarchy::Builder
+{
+    explicit Builder(std::size_t numVertices) :
+        outArcs(numVertices), inArcs(numVertices), contracted(numVertices, false), numContractedNeighbours(numVertices, 0), level(numVertices, 0),
+        distance(numVertices, 0), reached(numVertices, 0), target(numVertices, 0), searchId(0)
+    {
+    }
+
+    /**
+     * Adds an arc, or lowers the weight of the arc already joining the same vertices
+     *
+     * @return true, if the arc was added or its weight lowered
+     */
+    bool addArc(unsigned int tail, unsigned int head, double weight, unsigned int middle, unsigned int wayPoint)
+    {
+        std::vector<Arc> &out = outArcs[tail];
+        for (std::size_t i = 0; i < out.size(); i++)
+        {
+            if (out[i].vertex == head)
+            {
+                if (out[i].weight <= weight)
+                {
+                    return false;
+                }
+
+                out[i].weight = weight;
+                out[i].middle = middle;
+                out[i].wayPoint = wayPoint;
+
+                std::vector<Arc> &in = inArcs[head];
+                for (std::size_t j = 0; j < in.size(); j++)
+                {
+                    if (in[j].vertex == tail)
+                    {
+                        in[j] = out[i];
+                        in[j].vertex = tail;
+                    }
+                }
+                return true;
+            }
+        }
+
+        Arc arc;
+        arc.vertex = head;
+        arc.weight = weight;
+        arc.middle = middle;
+        arc.wayPoint = wayPoint;
+        out.push_back(arc);
+
+        arc.vertex = tail;
+        inArcs[head].push_back(arc);
+        return true;
+    }
+
+    /**
+     * Dijkstra search from source among the vertices not contracted, avoiding the excluded vertex, up to maxDistance.
+     * Stops as soon as the numTargets vertices marked as targets of the search are settled, or maxSettled vertices are.
+     */
+    void searchWitnesses(unsigned int source, unsigned int excluded, double maxDistance, std::size_t numTargets, std::size_t maxSettled)
+    {
+        distance[source] = 0;
+        reached[source] = searchId;
+
+        Heap heap;
+        heap.push(HeapEntry(0, source));
+        std::size_t numSettled = 0;
+
+        while (!heap.empty())
+        {
+            HeapEntry top = heap.top();
+            heap.pop();
+            if (top.first > distance[top.second])
+            {
+                continue;
+            }
+            if (top.first > maxDistance || ++numSettled > maxSettled)
+            {
+                break;
+            }
+            if (target[top.second] == searchId && --numTargets == 0)
+            {
+                break;
+            }
+
+            const std::vector<Arc> &out = outArcs[top.second];
+            for (std::vector<Arc>::const_iterator it = out.begin(); it != out.end(); ++it)
+            {
+                if (contracted[it->vertex] || it->vertex == excluded)
+                {
+                    continue;
+                }
+
+                double dist = top.first + it->weight;
+                if (reached[it->vertex] != searchId || dist < distance[it->vertex])
+                {
+                    distance[it->vertex] = dist;
+                    reached[it->vertex] = searchId;
+                    heap.push(HeapEntry(dist, it->vertex));
+                }
+            }
+        }
+    }
+
+    /**
+     * @return the distance found by the last witness search; infinity if the vertex was not reached
+     */
+    double getWitnessDistance(unsigned int vertex) const
+    {
+        return (reached[vertex] == searchId) ? distance[vertex] : INFINITE_COST;
+    }
+
+    /**
+     * Contracts a vertex, adding the shortcuts between its neighbours which are needed
+     *
+     * @param vertex the vertex to contract
+     * @param simulate if true, only counts the shortcuts without adding them
+     *
+     * @return the number of shortcuts needed
+     */
+    int contract(unsigned int vertex, bool simulate)
+    {
+        const std::vector<Arc> &in = inArcs[vertex];
+        const std::vector<Arc> &out = outArcs[vertex];
+
+        double maxOutWeight = -1;
+        for (std::vector<Arc>::const_iterator it = out.begin(); it != out.end(); ++it)
+        {
+            if (!contracted[it->vertex])
+            {
+                maxOutWeight = std::max(maxOutWeight, it->weight);
+            }
+        }
+
+        int numShortcuts = 0;
+        if (maxOutWeight < 0)
+        {
+            //No path goes through the vertex
+            return numShortcuts;
+        }
+
+        for (std::size_t i = 0; i < in.size(); i++)
+        {
+            unsigned int tail = in[i].vertex;
+            double inWeight = in[i].weight;
+            if (contracted[tail])
+            {
+                continue;
+            }
+
+            searchId++;
+            std::size_t numTargets = 0;
+            for (std::size_t j = 0; j < out.size(); j++)
+            {
+                if (!contracted[out[j].vertex] && out[j].vertex != tail && target[out[j].vertex] != searchId)
+                {
+                    target[out[j].vertex] = searchId;
+                    numTargets++;
+                }
+            }
+            if (numTargets == 0)
+            {
+                continue;
+            }
+
+            searchWitnesses(tail, vertex, inWeight + maxOutWeight, numTargets,
+                            simulate ? MAX_SIMULATED_WITNESS_SETTLED : MAX_WITNESS_SETTLED);
+
+            for (std::size_t j = 0; j < out.size(); j++)
+            {
+                unsigned int head = out[j].vertex;
+                if (contracted[head] || head == tail)
+                {
+                    continue;
+                }
+
+                double weight = inWeight + out[j].weight;
+                if (getWitnessDistance(head) > weight)
+                {
+                    numShortcuts++;
+                    if (!simulate)
+                    {
+                        addArc(tail, head, weight, vertex, NO_VERTEX);
+                    }
+                }
+            }
+        }
+        return numShortcuts;
+    }
+
+    /**
+     * Removes the arcs of a contracted vertex from the lists of its neighbours, so that the searches among the vertices
+     * not contracted skip them. The vertex keeps its own lists, whose arcs all go to higher ranked vertices.
+     */
+    void disconnect(unsigned int vertex)
+    {
+        for (std::vector<Arc>::const_iterator it = outArcs[vertex].begin(); it != outArcs[vertex].end(); ++it)
+        {
+            removeArcs(inArcs[it->vertex], vertex);
+        }
+        for (std::vector<Arc>::const_iterator it = inArcs[vertex].begin(); it != inArcs[vertex].end(); ++it)
+        {
+            removeArcs(outArcs[it->vertex], vertex);
+        }
+    }
+
+    static void removeArcs(std::vector<Arc> &arcs, unsigned int vertex)
+    {
+        for (std::size_t i = 0; i < arcs.size();)
+        {
+            if (arcs[i].vertex == vertex)
+            {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    /**
+     * Appends to neighbours the vertices not contracted joined to the vertex by an arc
+     */
+    void getNeighbours(unsigned int vertex, std::vector<unsigned int> &neighbours) const
+    {
+        neighbours.clear();
+        for (std::vector<Arc>::const_iterator it = outArcs[vertex].begin(); it != outArcs[vertex].end(); ++it)
+        {
+            if (!contracted[it->vertex])
+            {
+                neighbours.push_back(it->vertex);
+            }
+        }
+        for (std::vector<Arc>::const_iterator it = inArcs[vertex].begin(); it != inArcs[vertex].end(); ++it)
+        {
+            if (!contracted[it->vertex])
+            {
+                neighbours.push_back(it->vertex);
+            }
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    /**
+     * @return the priority of a vertex: the edge difference, plus the number of contracted neighbours and the level.
+     * The vertices of lowest priority are contracted first
+     */
+    int getPriority(unsigned int vertex)
+    {
+        int degree = 0;
+        for (std::vector<Arc>::const_iterator it = outArcs[vertex].begin(); it != outArcs[vertex].end(); ++it)
+        {
+            degree += contracted[it->vertex] ? 0 : 1;
+        }
+        for (std::vector<Arc>::const_iterator it = inArcs[vertex].begin(); it != inArcs[vertex].end(); ++it)
+        {
+            degree += contracted[it->vertex] ? 0 : 1;
+        }
+        return contract(vertex, true) - degree + numContractedNeighbours[vertex] + level[vertex];
+    }
+
+    /**Arcs by tail (vertex is the head) and by head (vertex is the tail)*/
+    std::vector<std::vector<Arc> > outArcs;
+    std::vector<std::vector<Arc> > inArcs;
+
+    std::vector<bool> contracted;
+    std::vector<int> numContractedNeighbours;
+
+    /**Length of the longest chain of contracted vertices below each vertex; keeps the hierarchy shallow*/
+    std::vector<int> level;
+
+    /**Distances found by the witness searches; only valid where reached holds the id of the last search*/
+    std::vector<double> distance;
+    std::vector<unsigned int> reached;
+
+    /**Vertices whose distance is looked for by the last witness search hold its id*/
+    std::vector<unsigned int> target;
+    unsigned int searchId;
+};
+
+struct ContractionHierarchy::QueryState
+{
+    explicit QueryState(std::size_t numVertices) : searchId(0)
+    {
+        for (int dir = 0; dir < 2; dir++)
+        {
+            distance[dir].resize(numVertices, 0);
+            next[dir].resize(numVertices, NO_VERTEX);
+            reached[dir].resize(numVertices, 0);
+        }
+    }
+
+    /**Distances from the source (index 0) and to the sink (index 1); only valid where reached holds searchId*/
+    std::vector<double> distance[2];
+
+    /**The previous vertex on the path from the source (index 0), the next vertex on the path to the sink (index 1)*/
+    std::vector<unsigned int> next[2];
+
+    std::vector<unsigned int> reached[2];
+    unsigned int searchId;
+
+    /**Priority queues of both searches, kept to reuse their storage*/
+    std::vector<HeapEntry> heap[2];
+};
+
+ContractionHierarchy::ContractionHierarchy(const StreetDirectory::Graph &graph) : numShortcuts(0)
+{
+    std::size_t numVertices = boost::num_vertices(graph);
+    Builder builder(numVertices);
+
+    //Parallel edges are reduced to the lightest one
+    StreetDirectory::Graph::edge_iterator edgeIt, edgeEnd;
+    for (boost::tie(edgeIt, edgeEnd) = boost::edges(graph); edgeIt != edgeEnd; ++edgeIt)
+    {
+        unsigned int tail = boost::source(*edgeIt, graph);
+        unsigned int head = boost::target(*edgeIt, graph);
+        if (tail == head)
+        {
+            continue;
+        }
+
+        if (builder.addArc(tail, head, boost::get(boost::edge_weight, graph, *edgeIt), NO_VERTEX, wayPoints.size()))
+        {
+            wayPoints.push_back(boost::get(boost::edge_name, graph, *edgeIt));
+        }
+    }
+
+    //Order the vertices, updating the priorities of the neighbours of each contracted vertex, and lazily the others
+    std::vector<int> priority(numVertices);
+    std::priority_queue<std::pair<int, unsigned int>, std::vector<std::pair<int, unsigned int> >, std::greater<std::pair<int, unsigned int> > > queue;
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        priority[v] = builder.getPriority(v);
+        queue.push(std::make_pair(priority[v], v));
+    }
+
+    rank.assign(numVertices, 0);
+    unsigned int nextRank = 0;
+    std::vector<unsigned int> neighbours;
+
+    while (!queue.empty())
+    {
+        std::pair<int, unsigned int> top = queue.top();
+        queue.pop();
+        unsigned int vertex = top.second;
+        if (builder.contracted[vertex] || top.first != priority[vertex])
+        {
+            continue;
+        }
+
+        int currentPriority = builder.getPriority(vertex);
+        if (currentPriority > priority[vertex] && !queue.empty() && currentPriority > queue.top().first)
+        {
+            priority[vertex] = currentPriority;
+            queue.push(std::make_pair(currentPriority, vertex));
+            continue;
+        }
+
+        builder.getNeighbours(vertex, neighbours);
+        builder.contract(vertex, false);
+        builder.contracted[vertex] = true;
+        builder.disconnect(vertex);
+        rank[vertex] = nextRank++;
+
+        for (std::vector<unsigned int>::const_iterator it = neighbours.begin(); it != neighbours.end(); ++it)
+        {
+            builder.numContractedNeighbours[*it]++;
+            builder.level[*it] = std::max(builder.level[*it], builder.level[vertex] + 1);
+            priority[*it] = builder.getPriority(*it);
+            queue.push(std::make_pair(priority[*it], *it));
+        }
+    }
+
+    //Keep the upward arcs by tail and the downward arcs by head
+    firstUpArc.resize(numVertices + 1);
+    firstDownArc.resize(numVertices + 1);
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        firstUpArc[v] = upArcs.size();
+        for (std::vector<Arc>::const_iterator it = builder.outArcs[v].begin(); it != builder.outArcs[v].end(); ++it)
+        {
+            if (rank[it->vertex] > rank[v])
+            {
+                upArcs.push_back(*it);
+                numShortcuts += (it->middle != NO_VERTEX) ? 1 : 0;
+            }
+        }
+
+        firstDownArc[v] = downArcs.size();
+        for (std::vector<Arc>::const_iterator it = builder.inArcs[v].begin(); it != builder.inArcs[v].end(); ++it)
+        {
+            if (rank[it->vertex] > rank[v])
+            {
+                downArcs.push_back(*it);
+                numShortcuts += (it->middle != NO_VERTEX) ? 1 : 0;
+            }
+        }
+    }
+    firstUpArc[numVertices] = upArcs.size();
+    firstDownArc[numVertices] = downArcs.size();
+}
+
+ContractionHierarchy::~ContractionHierarchy()
+{
+}
+
+double ContractionHierarchy::searchShortestPath(StreetDirectory::Vertex fromVertex, StreetDirectory::Vertex toVertex, std::vector<WayPoint> &path) const
+{
+    path.clear();
+    unsigned int source = fromVertex;
+    unsigned int sink = toVertex;
+    if (source >= rank.size() || sink >= rank.size())
+    {
+        return INFINITE_COST;
+    }
+    if (source == sink)
+    {
+        return 0;
+    }
+
+    QueryState *state = queryState.get();
+    if (!state)
+    {
+        state = new QueryState(rank.size());
+        queryState.reset(state);
+    }
+
+    state->searchId++;
+    unsigned int ends[2] = { source, sink };
+    for (int dir = 0; dir < 2; dir++)
+    {
+        state->distance[dir][ends[dir]] = 0;
+        state->next[dir][ends[dir]] = NO_VERTEX;
+        state->reached[dir][ends[dir]] = state->searchId;
+        state->heap[dir].clear();
+        state->heap[dir].push_back(HeapEntry(0, ends[dir]));
+    }
+
+    double bestCost = INFINITE_COST;
+    unsigned int meeting = NO_VERTEX;
+
+    //Settle the closest vertex of either search, until neither can improve the best path
+    while (!state->heap[0].empty() || !state->heap[1].empty())
+    {
+        int dir = 0;
+        if (state->heap[0].empty() || (!state->heap[1].empty() && state->heap[1].front().first < state->heap[0].front().first))
+        {
+            dir = 1;
+        }
+
+        std::vector<HeapEntry> &heap = state->heap[dir];
+        HeapEntry top = heap.front();
+        if (top.first >= bestCost)
+        {
+            break;
+        }
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        heap.pop_back();
+
+        unsigned int vertex = top.second;
+        if (top.first > state->distance[dir][vertex])
+        {
+            continue;
+        }
+
+        int other = 1 - dir;
+        if (state->reached[other][vertex] == state->searchId && top.first + state->distance[other][vertex] < bestCost)
+        {
+            bestCost = top.first + state->distance[other][vertex];
+            meeting = vertex;
+        }
+
+        const std::vector<Arc> &arcs = (dir == 0) ? upArcs : downArcs;
+        const std::vector<unsigned int> &firstArc = (dir == 0) ? firstUpArc : firstDownArc;
+        for (unsigned int i = firstArc[vertex]; i < firstArc[vertex + 1]; i++)
+        {
+            const Arc *arc = &arcs[i];
+            double dist = top.first + arc->weight;
+            if (state->reached[dir][arc->vertex] != state->searchId || dist < state->distance[dir][arc->vertex])
+            {
+                state->distance[dir][arc->vertex] = dist;
+                state->next[dir][arc->vertex] = vertex;
+                state->reached[dir][arc->vertex] = state->searchId;
+                heap.push_back(HeapEntry(dist, arc->vertex));
+                std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+            }
+        }
+    }
+
+    if (meeting == NO_VERTEX)
+    {
+        return INFINITE_COST;
+    }
+
+    //Vertices of the path in the hierarchy, from the source to the sink
+    std::vector<unsigned int> vertices;
+    for (unsigned int v = meeting; v != NO_VERTEX; v = state->next[0][v])
+    {
+        vertices.push_back(v);
+    }
+    std::reverse(vertices.begin(), vertices.end());
+    for (unsigned int v = state->next[1][meeting]; v != NO_VERTEX; v = state->next[1][v])
+    {
+        vertices.push_back(v);
+    }
+
+    for (std::size_t i = 0; i + 1 < vertices.size(); i++)
+    {
+        unpackArc(vertices[i], vertices[i + 1], path);
+    }
+    return bestCost;
+}
+
+const ContractionHierarchy::Arc* ContractionHierarchy::findArc(unsigned int tail, unsigned int head) const
+{
+    if (rank[head] > rank[tail])
+    {
+        for (unsigned int i = firstUpArc[tail]; i < firstUpArc[tail + 1]; i++)
+        {
+            if (upArcs[i].vertex == head)
+            {
+                return &upArcs[i];
+            }
+        }
+    }
+    else
+    {
+        for (unsigned int i = firstDownArc[head]; i < firstDownArc[head + 1]; i++)
+        {
+            if (downArcs[i].vertex == tail)
+            {
+                return &downArcs[i];
+            }
+        }
+    }
+    return nullptr;
+}
+
+void ContractionHierarchy::unpackArc(unsigned int tail, unsigned int head, std::vector<WayPoint> &path) const
+{
+    const Arc *arc = findArc(tail, head);
+    if (arc->middle == NO_VERTEX)
+    {
+        path.push_back(wayPoints[arc->wayPoint]);
+    }
+    else
+    {
+        unpackArc(tail, arc->middle, path);
+        unpackArc(arc->middle, head, path);
+    }
+}
+
+std::size_t ContractionHierarchy::getNumVertices() const
+{
+    return rank.size();
+}
+
+std::size_t ContractionHierarchy::getNumShortcuts() const
+{
+    return numShortcuts;
+}
@@ -0,0 +1,116 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <boost/thread/tss.hpp>
+#include <boost/utility.hpp>
+
+#include "StreetDirectory.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * Contraction hierarchy of a driving graph of the StreetDirectory, answering point-to-point shortest path queries.
+ *
+ * The vertices are contracted one at a time, the least important first (fewest shortcuts added, least contracted
+ * neighbours). Contracting a vertex adds a shortcut between two of its remaining neighbours wherever the path through
+ * it is shorter than any path found around it. A query then runs a Dijkstra search from the origin on the edges going
+ * up the hierarchy, and one from the destination on the reversed edges going up the hierarchy; both settle a few
+ * hundred vertices. The shortcuts of the path found are unpacked into the edges of the graph.
+ *
+ * The weights of the graph are read when the hierarchy is built; it must be built again if they change. Queries may
+ * run concurrently on several threads.
+ */
+class ContractionHierarchy : private boost::noncopyable
+{
+public:
+    /**
+     * Builds the hierarchy. The graph is only read by the constructor.
+     *
+     * @param graph the driving graph, weighted by the edge_weight property
+     */
+    explicit ContractionHierarchy(const StreetDirectory::Graph &graph);
+    ~ContractionHierarchy();
+
+    /**
+     * Searches the shortest path between two vertices
+     *
+     * @param fromVertex the source vertex in the graph
+     * @param toVertex the sink vertex in the graph
+     * @param path output WayPoints of the edges along the path; empty if toVertex cannot be reached
+     *
+     * @return the cost of the path; infinity if toVertex cannot be reached
+     */
+    double searchShortestPath(StreetDirectory::Vertex fromVertex, StreetDirectory::Vertex toVertex, std::vector<WayPoint> &path) const;
+
+    /**
+     * @return the number of vertices of the graph
+     */
+    std::size_t getNumVertices() const;
+
+    /**
+     * @return the number of shortcuts added to the graph
+     */
+    std::size_t getNumShortcuts() const;
+
+private:
+    /**Marks the absence of a vertex*/
+    static const unsigned int NO_VERTEX = static_cast<unsigned int> (-1);
+
+    /**An edge of the graph, or a shortcut*/
+    struct Arc
+    {
+        /**The other end of the arc: the head of an upward arc, the tail of a downward arc*/
+        unsigned int vertex;
+
+        double weight;
+
+        /**The vertex bypassed by a shortcut; NO_VERTEX for an edge of the graph*/
+        unsigned int middle;
+
+        /**Index of the WayPoint of an edge of the graph in wayPoints*/
+        unsigned int wayPoint;
+    };
+
+    /**Contracts the vertices; only used by the constructor*/
+    struct Builder;
+
+    /**Scratch space of the queries of one thread*/
+    struct QueryState;
+
+    /**
+     * Finds the arc from one vertex to another, which is either an upward arc of the tail or a downward arc of the head
+     */
+    const Arc* findArc(unsigned int tail, unsigned int head) const;
+
+    /**
+     * Appends to path the WayPoints of the edges of the graph represented by an arc
+     */
+    void unpackArc(unsigned int tail, unsigned int head, std::vector<WayPoint> &path) const;
+
+    /**Position of each vertex in the order of contraction*/
+    std::vector<unsigned int> rank;
+
+    /**Arcs going to a higher ranked vertex, by tail: the arcs of vertex v are upArcs[firstUpArc[v]..firstUpArc[v+1])*/
+    std::vector<unsigned int> firstUpArc;
+    std::vector<Arc> upArcs;
+
+    /**Arcs coming from a higher ranked vertex, by head: the arcs of vertex v are downArcs[firstDownArc[v]..firstDownArc[v+1])*/
+    std::vector<unsigned int> firstDownArc;
+    std::vector<Arc> downArcs;
+
+    /**WayPoints of the edges of the graph*/
+    std::vector<WayPoint> wayPoints;
+
+    std::size_t numShortcuts;
+
+    /**Scratch space of the queries, per thread*/
+    mutable boost::thread_specific_ptr<QueryState> queryState;
+};
+
+}
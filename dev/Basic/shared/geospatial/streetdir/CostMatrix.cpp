@@ -0,0 +1,27 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "CostMatrix.hpp"
+
+#include <limits>
+
+using namespace sim_mob;
+
+const double CostMatrix::UNREACHABLE = std::numeric_limits<double>::infinity();
+
+CostMatrix::CostMatrix() : numOrigins(0), numDestinations(0)
+{
+}
+
+CostMatrix::CostMatrix(std::size_t numOrigins, std::size_t numDestinations) : numOrigins(0), numDestinations(0)
+{
+    reset(numOrigins, numDestinations);
+}
+
+void CostMatrix::reset(std::size_t numOrigins, std::size_t numDestinations)
+{
+    this->numOrigins = numOrigins;
+    this->numDestinations = numDestinations;
+    costs.assign(numOrigins * numDestinations, UNREACHABLE);
+}
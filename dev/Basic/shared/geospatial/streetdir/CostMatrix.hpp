@@ -0,0 +1,72 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sim_mob
+{
+
+/**
+ * Dense matrix of the costs (travel times or distances) of the shortest paths from a set of origins to a set of
+ * destinations. Row i holds the costs from origin i, in the order of the destinations.
+ */
+class CostMatrix
+{
+public:
+    /**Cost of the pairs whose destination cannot be reached from the origin*/
+    static const double UNREACHABLE;
+
+    CostMatrix();
+    CostMatrix(std::size_t numOrigins, std::size_t numDestinations);
+
+    /**
+     * Changes the size of the matrix, and marks all its pairs UNREACHABLE
+     */
+    void reset(std::size_t numOrigins, std::size_t numDestinations);
+
+    std::size_t getNumOrigins() const
+    {
+        return numOrigins;
+    }
+
+    std::size_t getNumDestinations() const
+    {
+        return numDestinations;
+    }
+
+    double get(std::size_t origin, std::size_t destination) const
+    {
+        return costs[origin * numDestinations + destination];
+    }
+
+    void set(std::size_t origin, std::size_t destination, double cost)
+    {
+        costs[origin * numDestinations + destination] = cost;
+    }
+
+    /**
+     * @return the costs from an origin, indexed by destination
+     */
+    double* getRow(std::size_t origin)
+    {
+        return &costs[origin * numDestinations];
+    }
+
+    const double* getRow(std::size_t origin) const
+    {
+        return &costs[origin * numDestinations];
+    }
+
+private:
+    std::size_t numOrigins;
+    std::size_t numDestinations;
+
+    /**The costs, row by row*/
+    std::vector<double> costs;
+};
+
+}
@@ -0,0 +1,419 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "CustomizableContractionHierarchy.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+using namespace sim_mob;
+
+namespace
+{
+const double INFINITE_COST = std::numeric_limits<double>::infinity();
+
+/**Parts of the graph with at most this many vertices are not split further*/
+const std::size_t MIN_DISSECTED_SIZE = 8;
+
+/**Orders vertices by one of their coordinates*/
+class PositionOrder
+{
+public:
+    PositionOrder(const std::vector<Point> &positions, bool alongX) : positions(positions), alongX(alongX)
+    {
+    }
+
+    bool operator()(unsigned int first, unsigned int second) const
+    {
+        return alongX ? positions[first].getX() < positions[second].getX() : positions[first].getY() < positions[second].getY();
+    }
+
+private:
+    const std::vector<Point> &positions;
+    bool alongX;
+};
+}
+
+const unsigned int CustomizableContractionHierarchy::NO_VERTEX;
+
+struct CustomizableContractionHierarchy::QueryState
+{
+    explicit QueryState(std::size_t numVertices)
+    {
+        for (int dir = 0; dir < 2; dir++)
+        {
+            distance[dir].resize(numVertices, INFINITE_COST);
+            next[dir].resize(numVertices, NO_VERTEX);
+        }
+    }
+
+    /**Distances from the source (index 0) and to the sink (index 1); infinite outside of the last search*/
+    std::vector<double> distance[2];
+
+    /**The previous vertex on the path from the source (index 0), the next vertex on the path to the sink (index 1)*/
+    std::vector<unsigned int> next[2];
+};
+
+CustomizableContractionHierarchy::CustomizableContractionHierarchy(const StreetDirectory::Graph &graph)
+{
+    std::size_t numVertices = boost::num_vertices(graph);
+
+    //Neighbours of each vertex, ignoring the direction of the edges
+    std::vector< std::vector<unsigned int> > neighbours(numVertices);
+    StreetDirectory::Graph::edge_iterator edgeIt, edgeEnd;
+    for (boost::tie(edgeIt, edgeEnd) = boost::edges(graph); edgeIt != edgeEnd; ++edgeIt)
+    {
+        unsigned int tail = boost::source(*edgeIt, graph);
+        unsigned int head = boost::target(*edgeIt, graph);
+        edgeTail.push_back(tail);
+        edgeHead.push_back(head);
+        edgeWayPoints.push_back(boost::get(boost::edge_name, graph, *edgeIt));
+        edgeWeights.push_back(boost::get(boost::edge_weight, graph, *edgeIt));
+        if (tail != head)
+        {
+            neighbours[tail].push_back(head);
+            neighbours[head].push_back(tail);
+        }
+    }
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        std::sort(neighbours[v].begin(), neighbours[v].end());
+        neighbours[v].erase(std::unique(neighbours[v].begin(), neighbours[v].end()), neighbours[v].end());
+    }
+
+    //Contract the vertices in nested dissection order, connecting the remaining neighbours of each vertex
+    std::vector<Point> positions(numVertices);
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        positions[v] = boost::get(boost::vertex_name, graph, v);
+    }
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> part(numVertices, 0);
+    unsigned int numParts = 0;
+    std::vector<unsigned int> all(numVertices);
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        all[v] = v;
+    }
+    dissect(all, positions, neighbours, part, numParts, order);
+
+    rank.assign(numVertices, NO_VERTEX);
+    for (unsigned int i = 0; i < order.size(); i++)
+    {
+        rank[order[i]] = i;
+    }
+
+    std::vector< std::vector<unsigned int> > upNeighbours(numVertices);
+    std::vector<unsigned int> merged;
+    for (std::vector<unsigned int>::const_iterator vertexIt = order.begin(); vertexIt != order.end(); ++vertexIt)
+    {
+        unsigned int vertex = *vertexIt;
+        upNeighbours[vertex].swap(neighbours[vertex]);
+        const std::vector<unsigned int> &clique = upNeighbours[vertex];
+
+        for (std::vector<unsigned int>::const_iterator it = clique.begin(); it != clique.end(); ++it)
+        {
+            std::vector<unsigned int> &adjacent = neighbours[*it];
+            merged.clear();
+            std::set_union(adjacent.begin(), adjacent.end(), clique.begin(), clique.end(), std::back_inserter(merged));
+            merged.erase(std::remove(merged.begin(), merged.end(), vertex), merged.end());
+            merged.erase(std::remove(merged.begin(), merged.end(), *it), merged.end());
+            adjacent.swap(merged);
+        }
+    }
+
+    firstArc.resize(numVertices + 1);
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        firstArc[v] = arcHead.size();
+        arcHead.insert(arcHead.end(), upNeighbours[v].begin(), upNeighbours[v].end());
+    }
+    firstArc[numVertices] = arcHead.size();
+
+    //The parent of a vertex in the elimination tree is its lowest ranked upper neighbour
+    parent.assign(numVertices, NO_VERTEX);
+    for (unsigned int v = 0; v < numVertices; v++)
+    {
+        for (unsigned int i = firstArc[v]; i < firstArc[v + 1]; i++)
+        {
+            if (parent[v] == NO_VERTEX || rank[arcHead[i]] < rank[parent[v]])
+            {
+                parent[v] = arcHead[i];
+            }
+        }
+    }
+
+    //The lower triangles of the arcs, bottom up, so that customize() computes the weights of the arcs of a vertex
+    //before using them
+    for (std::vector<unsigned int>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        unsigned int vertex = *it;
+        for (unsigned int i = firstArc[vertex]; i < firstArc[vertex + 1]; i++)
+        {
+            for (unsigned int j = i + 1; j < firstArc[vertex + 1]; j++)
+            {
+                Triangle triangle;
+                triangle.vertex = vertex;
+                triangle.lowerArc = (rank[arcHead[i]] < rank[arcHead[j]]) ? i : j;
+                triangle.upperArc = (rank[arcHead[i]] < rank[arcHead[j]]) ? j : i;
+                triangle.arc = findArc(arcHead[i], arcHead[j]);
+                triangles.push_back(triangle);
+            }
+        }
+    }
+
+    customize(edgeWeights);
+}
+
+void CustomizableContractionHierarchy::dissect(std::vector<unsigned int> &vertices, const std::vector<Point> &positions,
+                                               const std::vector< std::vector<unsigned int> > &neighbours, std::vector<unsigned int> &part,
+                                               unsigned int &numParts, std::vector<unsigned int> &order)
+{
+    if (vertices.size() <= MIN_DISSECTED_SIZE)
+    {
+        order.insert(order.end(), vertices.begin(), vertices.end());
+        return;
+    }
+
+    //Split the vertices at the median of the longer side of their bounding box
+    double minX = std::numeric_limits<double>::max(), maxX = -minX, minY = minX, maxY = -minX;
+    for (std::vector<unsigned int>::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+    {
+        minX = std::min(minX, positions[*it].getX());
+        maxX = std::max(maxX, positions[*it].getX());
+        minY = std::min(minY, positions[*it].getY());
+        maxY = std::max(maxY, positions[*it].getY());
+    }
+    bool alongX = (maxX - minX >= maxY - minY);
+    std::vector<unsigned int>::iterator median = vertices.begin() + vertices.size() / 2;
+    std::nth_element(vertices.begin(), median, vertices.end(), PositionOrder(positions, alongX));
+
+    unsigned int firstPart = ++numParts;
+    unsigned int secondPart = ++numParts;
+    for (std::vector<unsigned int>::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+    {
+        part[*it] = (it < median) ? firstPart : secondPart;
+    }
+
+    //The vertices of the first half next to the second half separate them; they are contracted last
+    std::vector<unsigned int> first;
+    std::vector<unsigned int> second(median, vertices.end());
+    std::vector<unsigned int> separator;
+    for (std::vector<unsigned int>::const_iterator it = vertices.begin(); it != median; ++it)
+    {
+        bool boundary = false;
+        for (std::vector<unsigned int>::const_iterator nbIt = neighbours[*it].begin(); nbIt != neighbours[*it].end() && !boundary; ++nbIt)
+        {
+            boundary = (part[*nbIt] == secondPart);
+        }
+        (boundary ? separator : first).push_back(*it);
+    }
+
+    std::vector<unsigned int>().swap(vertices);
+    dissect(first, positions, neighbours, part, numParts, order);
+    dissect(second, positions, neighbours, part, numParts, order);
+    order.insert(order.end(), separator.begin(), separator.end());
+}
+
+CustomizableContractionHierarchy::~CustomizableContractionHierarchy()
+{
+}
+
+const std::vector<WayPoint>& CustomizableContractionHierarchy::getEdgeWayPoints() const
+{
+    return edgeWayPoints;
+}
+
+const std::vector<double>& CustomizableContractionHierarchy::getEdgeWeights() const
+{
+    return edgeWeights;
+}
+
+void CustomizableContractionHierarchy::customize(const std::vector<double> &weights)
+{
+    boost::shared_ptr<Metric> customized(new Metric());
+    for (int dir = 0; dir < 2; dir++)
+    {
+        customized->weight[dir].assign(arcHead.size(), INFINITE_COST);
+        customized->middle[dir].assign(arcHead.size(), NO_VERTEX);
+        customized->edge[dir].assign(arcHead.size(), NO_VERTEX);
+    }
+    std::vector<double> *weight = customized->weight;
+
+    //The lightest edge between each pair of vertices
+    for (unsigned int e = 0; e < edgeTail.size(); e++)
+    {
+        if (edgeTail[e] == edgeHead[e])
+        {
+            continue;
+        }
+
+        unsigned int arc = findArc(edgeTail[e], edgeHead[e]);
+        int dir = (rank[edgeTail[e]] < rank[edgeHead[e]]) ? UP : DOWN;
+        if (weights[e] < weight[dir][arc])
+        {
+            weight[dir][arc] = weights[e];
+            customized->edge[dir][arc] = e;
+        }
+    }
+
+    //Shorter paths through the lowest vertex of each triangle
+    for (std::vector<Triangle>::const_iterator it = triangles.begin(); it != triangles.end(); ++it)
+    {
+        double up = weight[DOWN][it->lowerArc] + weight[UP][it->upperArc];
+        if (up < weight[UP][it->arc])
+        {
+            weight[UP][it->arc] = up;
+            customized->middle[UP][it->arc] = it->vertex;
+        }
+
+        double down = weight[DOWN][it->upperArc] + weight[UP][it->lowerArc];
+        if (down < weight[DOWN][it->arc])
+        {
+            weight[DOWN][it->arc] = down;
+            customized->middle[DOWN][it->arc] = it->vertex;
+        }
+    }
+
+    boost::mutex::scoped_lock lock(metricMutex);
+    metric = customized;
+}
+
+double CustomizableContractionHierarchy::searchShortestPath(StreetDirectory::Vertex fromVertex, StreetDirectory::Vertex toVertex,
+                                                            std::vector<WayPoint> &path) const
+{
+    path.clear();
+    unsigned int source = fromVertex;
+    unsigned int sink = toVertex;
+    if (source >= rank.size() || sink >= rank.size())
+    {
+        return INFINITE_COST;
+    }
+    if (source == sink)
+    {
+        return 0;
+    }
+
+    boost::shared_ptr<const Metric> current;
+    {
+        boost::mutex::scoped_lock lock(metricMutex);
+        current = metric;
+    }
+
+    QueryState *state = queryState.get();
+    if (!state)
+    {
+        state = new QueryState(rank.size());
+        queryState.reset(state);
+    }
+
+    //The vertices reached going up the hierarchy from a vertex are its ancestors in the elimination tree. Each
+    //search scans them bottom up, instead of settling them by distance.
+    unsigned int ends[2] = { source, sink };
+    for (int dir = 0; dir < 2; dir++)
+    {
+        std::vector<double> &distance = state->distance[dir];
+        const std::vector<double> &weight = current->weight[dir];
+        distance[ends[dir]] = 0;
+        state->next[dir][ends[dir]] = NO_VERTEX;
+
+        for (unsigned int vertex = ends[dir]; vertex != NO_VERTEX; vertex = parent[vertex])
+        {
+            if (distance[vertex] == INFINITE_COST)
+            {
+                continue;
+            }
+            for (unsigned int i = firstArc[vertex]; i < firstArc[vertex + 1]; i++)
+            {
+                double dist = distance[vertex] + weight[i];
+                if (dist < distance[arcHead[i]])
+                {
+                    distance[arcHead[i]] = dist;
+                    state->next[dir][arcHead[i]] = vertex;
+                }
+            }
+        }
+    }
+
+    //The shortest path goes through the common ancestor closest to both ends
+    double bestCost = INFINITE_COST;
+    unsigned int meeting = NO_VERTEX;
+    for (unsigned int vertex = source; vertex != NO_VERTEX; vertex = parent[vertex])
+    {
+        double cost = state->distance[0][vertex] + state->distance[1][vertex];
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            meeting = vertex;
+        }
+    }
+
+    if (meeting != NO_VERTEX)
+    {
+        //Vertices of the path in the hierarchy, from the source to the sink
+        std::vector<unsigned int> vertices;
+        for (unsigned int v = meeting; v != NO_VERTEX; v = state->next[0][v])
+        {
+            vertices.push_back(v);
+        }
+        std::reverse(vertices.begin(), vertices.end());
+        for (unsigned int v = state->next[1][meeting]; v != NO_VERTEX; v = state->next[1][v])
+        {
+            vertices.push_back(v);
+        }
+
+        for (std::size_t i = 0; i + 1 < vertices.size(); i++)
+        {
+            unpackArc(*current, vertices[i], vertices[i + 1], path);
+        }
+    }
+
+    for (int dir = 0; dir < 2; dir++)
+    {
+        for (unsigned int vertex = ends[dir]; vertex != NO_VERTEX; vertex = parent[vertex])
+        {
+            state->distance[dir][vertex] = INFINITE_COST;
+        }
+    }
+    return bestCost;
+}
+
+unsigned int CustomizableContractionHierarchy::findArc(unsigned int first, unsigned int second) const
+{
+    if (rank[first] > rank[second])
+    {
+        std::swap(first, second);
+    }
+    std::vector<unsigned int>::const_iterator begin = arcHead.begin() + firstArc[first];
+    std::vector<unsigned int>::const_iterator end = arcHead.begin() + firstArc[first + 1];
+    return std::lower_bound(begin, end, second) - arcHead.begin();
+}
+
+void CustomizableContractionHierarchy::unpackArc(const Metric &metric, unsigned int tail, unsigned int head, std::vector<WayPoint> &path) const
+{
+    unsigned int arc = findArc(tail, head);
+    int dir = (rank[tail] < rank[head]) ? UP : DOWN;
+    unsigned int middle = metric.middle[dir][arc];
+    if (middle == NO_VERTEX)
+    {
+        path.push_back(edgeWayPoints[metric.edge[dir][arc]]);
+    }
+    else
+    {
+        unpackArc(metric, tail, middle, path);
+        unpackArc(metric, middle, head, path);
+    }
+}
+
+std::size_t CustomizableContractionHierarchy::getNumVertices() const
+{
+    return rank.size();
+}
+
+std::size_t CustomizableContractionHierarchy::getNumArcs() const
+{
+    return arcHead.size();
+}
@@ -0,0 +1,184 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/utility.hpp>
+
+#include "StreetDirectory.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * Contraction hierarchy of a driving graph whose weights can be replaced without contracting the graph again.
+ *
+ * Unlike ContractionHierarchy, the order of the vertices and the shortcuts only depend on the topology of the graph:
+ * the vertices are ordered by nested dissection of their positions, and contracting a vertex connects all its remaining
+ * neighbours. The weights are then computed by customize(), in one pass over the triangles of the hierarchy, which
+ * takes a small fraction of the time needed to build it. Queries go up the hierarchy from both ends, as in
+ * ContractionHierarchy, but scan the ancestors of the ends in the elimination tree instead of running Dijkstra
+ * searches.
+ *
+ * Queries may run concurrently on several threads, including while the hierarchy is customized: they use the weights
+ * of the last customization which completed before they started.
+ */
+class CustomizableContractionHierarchy : private boost::noncopyable
+{
+public:
+    /**
+     * Builds the hierarchy, and customizes it with the edge_weight of the graph. The graph is only read by the
+     * constructor.
+     *
+     * @param graph the driving graph
+     */
+    explicit CustomizableContractionHierarchy(const StreetDirectory::Graph &graph);
+    ~CustomizableContractionHierarchy();
+
+    /**
+     * @return the WayPoints of the edges of the graph, in the order of the weights given to customize()
+     */
+    const std::vector<WayPoint>& getEdgeWayPoints() const;
+
+    /**
+     * @return the edge_weight of the edges of the graph, in the order of the weights given to customize()
+     */
+    const std::vector<double>& getEdgeWeights() const;
+
+    /**
+     * Replaces the weights of the edges of the graph
+     *
+     * @param edgeWeights the new weight of each edge, in the order of getEdgeWayPoints(); infinity to close an edge
+     */
+    void customize(const std::vector<double> &edgeWeights);
+
+    /**
+     * Searches the shortest path between two vertices, with the weights of the last customization
+     *
+     * @param fromVertex the source vertex in the graph
+     * @param toVertex the sink vertex in the graph
+     * @param path output WayPoints of the edges along the path; empty if toVertex cannot be reached
+     *
+     * @return the cost of the path; infinity if toVertex cannot be reached
+     */
+    double searchShortestPath(StreetDirectory::Vertex fromVertex, StreetDirectory::Vertex toVertex, std::vector<WayPoint> &path) const;
+
+    /**
+     * @return the number of vertices of the graph
+     */
+    std::size_t getNumVertices() const;
+
+    /**
+     * @return the number of arcs of the hierarchy, between the pairs of vertices joined by edges or shortcuts
+     */
+    std::size_t getNumArcs() const;
+
+private:
+    /**Marks the absence of a vertex*/
+    static const unsigned int NO_VERTEX = static_cast<unsigned int> (-1);
+
+    /**
+     * A lower triangle: the arcs between a vertex and two of its higher ranked neighbours, and the arc between these
+     * neighbours
+     */
+    struct Triangle
+    {
+        /**The lowest ranked vertex*/
+        unsigned int vertex;
+
+        /**The arc to the lower ranked neighbour*/
+        unsigned int lowerArc;
+
+        /**The arc to the higher ranked neighbour*/
+        unsigned int upperArc;
+
+        /**The arc between the neighbours*/
+        unsigned int arc;
+    };
+
+    /**
+     * Weights of the arcs. Index UP of the arrays is for the direction from the lower to the higher ranked end of
+     * the arcs, index DOWN for the other direction.
+     */
+    struct Metric
+    {
+        std::vector<double> weight[2];
+
+        /**The vertex bypassed by the shortest path along the arc; NO_VERTEX if it is an edge of the graph*/
+        std::vector<unsigned int> middle[2];
+
+        /**The edge of the graph, when middle is NO_VERTEX*/
+        std::vector<unsigned int> edge[2];
+    };
+
+    enum Direction
+    {
+        UP = 0,
+        DOWN = 1
+    };
+
+    /**Scratch space of the queries of one thread*/
+    struct QueryState;
+
+    /**
+     * Orders the vertices of a part of the graph for contraction by nested dissection: both halves of the part, then
+     * the vertices which separate them
+     *
+     * @param vertices the vertices of the part; cleared
+     * @param positions the positions of all the vertices
+     * @param neighbours the neighbours of all the vertices, ignoring the direction of the edges
+     * @param part scratch space, the part of each vertex
+     * @param numParts the number of parts created so far
+     * @param order the order of contraction, to which the vertices are appended
+     */
+    static void dissect(std::vector<unsigned int> &vertices, const std::vector<Point> &positions,
+                        const std::vector< std::vector<unsigned int> > &neighbours, std::vector<unsigned int> &part,
+                        unsigned int &numParts, std::vector<unsigned int> &order);
+
+    /**
+     * @return the arc between two vertices joined by an edge or a shortcut
+     */
+    unsigned int findArc(unsigned int first, unsigned int second) const;
+
+    /**
+     * Appends to path the WayPoints of the edges of the graph represented by the arc from tail to head
+     */
+    void unpackArc(const Metric &metric, unsigned int tail, unsigned int head, std::vector<WayPoint> &path) const;
+
+    /**Position of each vertex in the order of contraction*/
+    std::vector<unsigned int> rank;
+
+    /**Arcs by lower ranked end: the arcs of vertex v are arcs firstArc[v]..firstArc[v+1], in the order of arcHead*/
+    std::vector<unsigned int> firstArc;
+
+    /**The higher ranked end of each arc*/
+    std::vector<unsigned int> arcHead;
+
+    /**Parent of each vertex in the elimination tree; NO_VERTEX for the roots*/
+    std::vector<unsigned int> parent;
+
+    /**Lower triangles, in the order of contraction of their lowest vertex*/
+    std::vector<Triangle> triangles;
+
+    /**Ends of the edges of the graph*/
+    std::vector<unsigned int> edgeTail;
+    std::vector<unsigned int> edgeHead;
+
+    std::vector<WayPoint> edgeWayPoints;
+    std::vector<double> edgeWeights;
+
+    /**The weights of the last customization; replaced under metricMutex*/
+    boost::shared_ptr<const Metric> metric;
+    mutable boost::mutex metricMutex;
+
+    /**Scratch space of the queries, per thread*/
+    mutable boost::thread_specific_ptr<QueryState> queryState;
+};
+
+}
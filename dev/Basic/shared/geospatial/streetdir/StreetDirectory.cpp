@@ -3,6 +3,9 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #include "StreetDirectory.hpp"
+
+#include <sstream>
+
 #include "geospatial/network/RoadSegment.hpp"
 #include "geospatial/network/Node.hpp"
 #include "geospatial/network/PT_Stop.hpp"
@@ -12,13 +15,17 @@
 #include "A_StarShortestPathImpl.hpp"
 #include "A_StarPublicTransitShortestPathImpl.hpp"
 #include "A_StarShortestTravelTimePathImpl.hpp"
+#include "CH_ShortestPathImpl.hpp"
+#include "CH_ShortestTravelTimePathImpl.hpp"
+#include "CostMatrix.hpp"
+#include "logging/Log.hpp"
 
 namespace sim_mob
 {
 
 StreetDirectory StreetDirectory::instance;
 
-StreetDirectory::StreetDirectory() : spImpl(nullptr), sttpImpl(nullptr), ptImpl(nullptr)
+StreetDirectory::StreetDirectory() : spImpl(nullptr), sttpImpl(nullptr), ptImpl(nullptr), inSimulationTravelTimesRefreshed(false)
 {
 }
 
@@ -40,14 +47,104 @@ StreetDirectory::~StreetDirectory()
 
 void StreetDirectory::Init(const RoadNetwork& network)
 {
+    const SimulationParams& simulation = ConfigManager::GetInstance().FullConfig().simulation;
     if (!spImpl) {
-        spImpl = new A_StarShortestPathImpl(network);
+        if (simulation.contractionHierarchies) {
+            spImpl = new CH_ShortestPathImpl(network);
+        } else {
+            spImpl = new A_StarShortestPathImpl(network);
+        }
     }
     if (!ptImpl && ConfigManager::GetInstance().FullConfig().isPublicTransitEnabled()) {
         ptImpl = new A_StarPublicTransitShortestPathImpl(PT_NetworkCreater::getInstance().PT_NetworkEdgeMap,PT_NetworkCreater::getInstance().PT_NetworkVertexMap);
     }
     if(!sttpImpl && ConfigManager::GetInstance().FullConfig().PathSetMode()){
-        sttpImpl = new A_StarShortestTravelTimePathImpl(network);
+        if (simulation.contractionHierarchies) {
+            sttpImpl = new CH_ShortestTravelTimePathImpl(network);
+        } else {
+            sttpImpl = new A_StarShortestTravelTimePathImpl(network);
+        }
+    }
+
+    if (simulation.contractionHierarchies && simulation.shortestPathBenchmarkPairs > 0) {
+        std::stringstream out;
+        if (const CH_ShortestPathImpl* impl = dynamic_cast<const CH_ShortestPathImpl*>(spImpl)) {
+            impl->benchmark(simulation.shortestPathBenchmarkPairs, out);
+        }
+        if (const CH_ShortestTravelTimePathImpl* impl = dynamic_cast<const CH_ShortestTravelTimePathImpl*>(sttpImpl)) {
+            impl->benchmark(simulation.shortestPathBenchmarkPairs, out);
+        }
+        Print() << out.str();
+    }
+}
+
+void StreetDirectory::refreshInSimulationTravelTimes(const DailyTime& time)
+{
+    if (CH_ShortestTravelTimePathImpl* impl = dynamic_cast<CH_ShortestTravelTimePathImpl*>(sttpImpl)) {
+        impl->refreshInSimulationTravelTimes(time);
+        inSimulationTravelTimesRefreshed.store(true, boost::memory_order_release);
+    }
+}
+
+void StreetDirectory::refreshInSimulationTravelTimesAfterTick(unsigned int tick)
+{
+    const ConfigParams& config = ConfigManager::GetInstance().FullConfig();
+    const unsigned int interval = config.simulation.travelTimeRefreshInterval;
+
+    //the InSimulation queries are routed with the link travel times of the interval which just ended
+    const unsigned long nextTimeMS = (tick + 1) * config.baseGranMS();
+    if (interval > 0 && nextTimeMS % (interval * 1000) == 0)
+    {
+        refreshInSimulationTravelTimes(config.simStartTime() + DailyTime(nextTimeMS));
+    }
+}
+
+void StreetDirectory::SearchShortestDrivingTimeMatrix(const std::vector<const Node*> &origins, const std::vector<const Node*> &destinations,
+                                                      CostMatrix &matrix, TimeRange timeRange, unsigned int numThreads) const
+{
+    SearchShortestDrivingMatrix(sttpImpl, origins, destinations, matrix, timeRange, numThreads);
+}
+
+void StreetDirectory::SearchShortestDrivingDistanceMatrix(const std::vector<const Node*> &origins, const std::vector<const Node*> &destinations,
+                                                          CostMatrix &matrix, unsigned int numThreads) const
+{
+    SearchShortestDrivingMatrix(spImpl, origins, destinations, matrix, Default, numThreads);
+}
+
+void StreetDirectory::SearchShortestDrivingMatrix(const ShortestPathImpl *impl, const std::vector<const Node*> &origins,
+                                                  const std::vector<const Node*> &destinations, CostMatrix &matrix, TimeRange timeRange,
+                                                  unsigned int numThreads)
+{
+    matrix.reset(origins.size(), destinations.size());
+    if (!impl)
+    {
+        return;
+    }
+
+    std::vector<VertexDesc> from;
+    from.reserve(origins.size());
+    for (std::vector<const Node*>::const_iterator it = origins.begin(); it != origins.end(); ++it)
+    {
+        from.push_back(impl->DrivingVertex(**it, timeRange));
+    }
+    std::vector<VertexDesc> to;
+    to.reserve(destinations.size());
+    for (std::vector<const Node*>::const_iterator it = destinations.begin(); it != destinations.end(); ++it)
+    {
+        to.push_back(impl->DrivingVertex(**it, timeRange));
+    }
+
+    impl->GetShortestDrivingCosts(from, to, timeRange, 0, numThreads, matrix);
+
+    for (std::size_t i = 0; i < origins.size(); i++)
+    {
+        for (std::size_t j = 0; j < destinations.size(); j++)
+        {
+            if (origins[i] == destinations[j])
+            {
+                matrix.set(i, j, 0);
+            }
+        }
     }
 }
 
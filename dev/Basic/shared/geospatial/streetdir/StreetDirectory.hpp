@@ -7,6 +7,7 @@
 #include <map>
 #include <vector>
 
+#include <boost/atomic.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/utility.hpp>
@@ -23,6 +24,8 @@ class BusStop;
 class Link;
 class RoadSegment;
 class RoadNetwork;
+class DailyTime;
+class CostMatrix;
 
 enum TimeRange
 {
@@ -35,7 +38,9 @@ enum TimeRange
     HighwayBiasEveningPeak = 6,
     HighwayBiasOffPeak = 7,
     HighwayBiasDefault = 8,
-    Random
+    Random,
+    /**Default travel times, replaced by the in-simulation travel times by StreetDirectory::refreshInSimulationTravelTimes*/
+    InSimulation
 };
 
 enum PT_CostLabel{
@@ -268,6 +273,19 @@ public:
             virtual std::vector<WayPoint> GetShortestDrivingPath(const VertexDesc &from, const VertexDesc &to, const std::vector<const Link *> &blackList,
                                                              TimeRange timeRange = Default, int randomGraphIdx = 0) const = 0;
 
+        /**
+         * Computes the costs of the shortest driving paths from each origin to each destination
+         *
+         * @param from the origin vertices in the graph; the rows of the matrix
+         * @param to the destination vertices in the graph; the columns of the matrix
+         * @param timeRange is time range, default value is peak time in the morning
+         * @param randomGraphId is random graph index, default value is 0.
+         * @param numThreads the number of threads searching from the origins in parallel; 0 for one per core
+         * @param matrix output costs, as the sum of the weights of the links along each path
+         */
+        virtual void GetShortestDrivingCosts(const std::vector<VertexDesc> &from, const std::vector<VertexDesc> &to, TimeRange timeRange,
+                                             int randomGraphIdx, unsigned int numThreads, CostMatrix &matrix) const = 0;
+
         /**
          * Prints the graph structure
          * @param outFile is a output stream is original vertex in the graph
@@ -338,6 +356,28 @@ public:
             return res;
         }
 
+    /**
+     * Return the shortest travel time path to drive from one node/link to another, with the link travel times of the
+     * current simulation (the InSimulation time range). Until these have been refreshed by
+     * refreshInSimulationTravelTimes(), returns the shortest driving path instead.
+     *
+     * @param from is a parameter to hold starting node/link
+     * @param to is a parameter to hold ending node/link
+     *
+     * @return the shortest path result.
+     */
+        template<class OriginType, class DestinationType>
+        std::vector<WayPoint> SearchInSimulationDrivingPath(const OriginType &from, const DestinationType &to) const
+        {
+            if (!inSimulationTravelTimesRefreshed.load(boost::memory_order_acquire))
+            {
+                    return SearchShortestDrivingPath<OriginType, DestinationType>(from, to);
+            }
+            VertexDesc source = DrivingTimeVertex(from, InSimulation);
+            VertexDesc sink = DrivingTimeVertex(to, InSimulation);
+            return sttpImpl->GetShortestDrivingPath(source, sink, std::vector<const Link*>(), InSimulation, 0);
+        }
+
     /**
      * Retrieves a vertex in the distance graph
      *
@@ -401,6 +441,28 @@ public:
             return res;
         }
 
+    /**
+     * Computes the travel times in seconds of the shortest travel time driving paths from each origin to each
+     * destination. Each origin is searched by a single Dijkstra sweep, which stops once all the destinations are
+     * reached; the origins are spread over several threads.
+     *
+     * @param origins the origin nodes; the rows of the matrix
+     * @param destinations the destination nodes; the columns of the matrix
+     * @param matrix output travel times; 0 when the origin is the destination, CostMatrix::UNREACHABLE when there is
+     *        no path
+     * @param timeRange is time range, default value is the default travel times
+     * @param numThreads the number of threads; 0 for one per core
+     */
+    void SearchShortestDrivingTimeMatrix(const std::vector<const Node*> &origins, const std::vector<const Node*> &destinations,
+                                         CostMatrix &matrix, TimeRange timeRange = Default, unsigned int numThreads = 0) const;
+
+    /**
+     * Computes the lengths in metres of the shortest driving paths from each origin to each destination, as
+     * SearchShortestDrivingTimeMatrix does for travel times
+     */
+    void SearchShortestDrivingDistanceMatrix(const std::vector<const Node*> &origins, const std::vector<const Node*> &destinations,
+                                             CostMatrix &matrix, unsigned int numThreads = 0) const;
+
     /**
      * Initialize the StreetDirectory object (to be invoked by the simulator kernel).
      *
@@ -408,9 +470,35 @@ public:
      */
     void Init(const RoadNetwork& network);
 
+    /**
+     * Replaces the travel times of the InSimulation time range by the link travel times of the current simulation, in
+     * the interval before the one of a time of day, for SearchInSimulationDrivingPath(). Does nothing unless the
+     * travel time paths are searched by contraction hierarchies. Must not be called while agents are updated: the
+     * simulators call it through refreshInSimulationTravelTimesAfterTick(), while the workers wait on the message bus
+     * barrier.
+     *
+     * @param time the time of day
+     */
+    void refreshInSimulationTravelTimes(const DailyTime& time);
+
+    /**
+     * Calls refreshInSimulationTravelTimes() at the end of the ticks which complete an interval of the configured
+     * refresh_interval of the shortest path engine. Meant to be set as the flip buffers callback of the WorkGroupManager.
+     *
+     * @param tick the tick which just ended
+     */
+    void refreshInSimulationTravelTimesAfterTick(unsigned int tick);
+
 private:
     StreetDirectory();
 
+    /**
+     * Fills the cost matrix of the shortest driving paths between two sets of nodes, searched by an implementation
+     */
+    static void SearchShortestDrivingMatrix(const ShortestPathImpl *impl, const std::vector<const Node*> &origins,
+                                            const std::vector<const Node*> &destinations, CostMatrix &matrix, TimeRange timeRange,
+                                            unsigned int numThreads);
+
     /**the single instance of the street directory */
     static StreetDirectory instance;
 
@@ -422,6 +510,9 @@ private:
 
         /**Public Transit implementation*/
         PublicTransitShortestPathImpl* ptImpl;
+
+    /** whether the InSimulation travel times have been refreshed at least once */
+    boost::atomic<bool> inSimulationTravelTimesRefreshed;
 };
 }
 
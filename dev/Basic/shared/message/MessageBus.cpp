@@ -11,6 +11,8 @@
 #include "MessageBus.hpp"
 
 #include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/format.hpp>
 #include <boost/function.hpp>
 #include <boost/thread/thread.hpp>
@@ -18,15 +20,18 @@
 #include <boost/unordered/unordered_map.hpp>
 #include <iostream>
 #include <list>
-#include <queue>
+#include <sstream>
+#include <vector>
 #include <conf/ConfigManager.hpp>
 #include "event/EventPublisher.hpp"
 #include "util/LangHelpers.hpp"
+#include "util/RandomService.hpp"
+#include "util/TimingWheel.hpp"
 #include "logging/Log.hpp"
 
 using namespace sim_mob::messaging;
 using namespace sim_mob::event;
-using std::priority_queue;
+using sim_mob::TimingWheel;
 using std::runtime_error;
 using std::list;
 using std::pair;
@@ -49,6 +54,8 @@ namespace {
     const unsigned int MB_MSGI_START = 1000;
     const unsigned int INTERNAL_EVENT_MSG_PRIORITY = 3;
     const unsigned int INTERNAL_EVENT_ACTION_PRIORITY = 4;
+    const std::size_t MAILBOX_BLOCK_SIZE = 256;
+    const std::size_t CACHE_LINE_SIZE = 64;
 
     const std::string REPORT_LINE = "# Id: %-25s Received: %-12s Processed: %-12s Events: %-12s Remaining: %-12s";
 
@@ -112,66 +119,231 @@ namespace {
         unsigned int triggerTime;
     } *MessageEntryPtr;
 
-    struct ComparePriority {
+    /**
+     * Orders message entries for dispatching: the highest priority first.
+     */
+    struct HigherPriority {
 
         bool operator()(const MessageEntry& t1, const MessageEntry& t2) const {
-            return (t1.priority < t2.priority);
+            return (t1.priority > t2.priority);
         }
     };
 
-    struct CompareTriggerTime {
+    struct ThreadContext;
 
-        bool operator()(const MessageEntry& t1, const MessageEntry& t2) const {
-            return (t1.triggerTime > t2.triggerTime);
+    /**
+     * Message posted with a time offset, waiting for its trigger time.
+     * @param entry the message entry.
+     * @param sender context of the thread which posted the message.
+     */
+    struct TimedMessage {
+
+        TimedMessage() : sender(nullptr) {
+        }
+
+        TimedMessage(const MessageEntry& entry, ThreadContext* sender)
+        : entry(entry), sender(sender) {
         }
+
+        MessageEntry entry;
+        ThreadContext* sender;
     };
 
-    typedef priority_queue<MessageEntry, std::deque<MessageEntry>, ComparePriority> MessageQueue;
+    typedef TimingWheel<TimedMessage> TimedMessageWheel;
+
+    class Mailbox;
+
+    /**
+     * Gets the mailbox from the sender context to the receiver context,
+     * creating it if necessary.
+     * Attention: This function must be called by the sender thread, or by the
+     * main thread while the sender waits.
+     * @param sender context.
+     * @param receiver context.
+     * @return Mailbox pointer.
+     */
+    Mailbox* GetMailbox(ThreadContext* sender, ThreadContext* receiver);
+
+    /**
+     * Unbounded single-producer/single-consumer queue of the messages posted
+     * by one thread context (the sender) to another (the receiver).
+     *
+     * The sender appends entries without any locking. Entries become visible
+     * to the receiver only when the main thread seals the mailbox in
+     * DispatchMessages(), while all other threads wait at the barrier, so
+     * that messages posted during a tick are dispatched at the beginning of
+     * the next tick. The receiver may drain sealed entries while the sender
+     * appends new ones.
+     *
+     * Entries are stored in a linked list of fixed size blocks; the receiver
+     * frees each block once it has consumed all of its entries.
+     */
+    class Mailbox {
+    public:
+
+        Mailbox(ThreadContext* sender, ThreadContext* receiver)
+        : sender(sender), receiver(receiver), tail(new Block()), tailIndex(0), posted(0),
+        sealed(0), head(tail), headIndex(0), consumed(0) {
+        }
+
+        ~Mailbox() {
+            while (head) {
+                Block* next = head->next.load(boost::memory_order_relaxed);
+                delete head;
+                head = next;
+            }
+        }
+
+        /**
+         * Appends an entry. Must be called by the sender only.
+         * @param entry to append.
+         */
+        void push(const MessageEntry& entry) {
+            if (tailIndex == MAILBOX_BLOCK_SIZE) {
+                Block* block = new Block();
+                tail->next.store(block, boost::memory_order_release);
+                tail = block;
+                tailIndex = 0;
+            }
+            tail->entries[tailIndex++] = entry;
+            posted.store(posted.load(boost::memory_order_relaxed) + 1, boost::memory_order_release);
+        }
+
+        /**
+         * Makes all entries appended so far visible to the receiver.
+         * Must be called by the main thread while the sender waits.
+         */
+        void seal() {
+            sealed.store(posted.load(boost::memory_order_acquire), boost::memory_order_release);
+        }
+
+        /**
+         * Moves all sealed entries to the given vector.
+         * Must be called by the receiver only.
+         * @param out vector to append the entries to.
+         */
+        void drain(vector<MessageEntry>& out) {
+            const boost::uint64_t limit = sealed.load(boost::memory_order_acquire);
+            while (consumed < limit) {
+                if (headIndex == MAILBOX_BLOCK_SIZE) {
+                    // the sender has moved on to the next block
+                    Block* next = head->next.load(boost::memory_order_acquire);
+                    delete head;
+                    head = next;
+                    headIndex = 0;
+                }
+                MessageEntry& entry = head->entries[headIndex++];
+                out.push_back(entry);
+                entry.message.reset();
+                consumed++;
+            }
+        }
+
+        /**
+         * Moves the entries not consumed yet whose destination handler was
+         * re-registered to another thread context to the mailbox from the
+         * same sender to that context. The moved entries are left behind as
+         * entries without destination, which the receiver skips.
+         * Must be called by the main thread while the sender and the
+         * receiver wait.
+         */
+        void redirect() {
+            Block* block = head;
+            std::size_t index = headIndex;
+            for (boost::uint64_t pos = consumed; pos < posted.load(boost::memory_order_acquire); pos++) {
+                if (index == MAILBOX_BLOCK_SIZE) {
+                    block = block->next.load(boost::memory_order_acquire);
+                    index = 0;
+                }
+                MessageEntry& entry = block->entries[index++];
+                if (entry.destination && !entry.event && !entry.processOnMainThread) {
+                    ThreadContext* destinationContext = static_cast<ThreadContext*> (entry.destination->GetContext());
+                    if (destinationContext && destinationContext != receiver) {
+                        GetMailbox(sender, destinationContext)->push(entry);
+                        entry.destination = nullptr;
+                        entry.message.reset();
+                    }
+                }
+            }
+        }
+
+        /**
+         * @return number of entries not consumed yet.
+         *         Only exact while the sender and receiver wait.
+         */
+        boost::uint64_t pending() const {
+            return posted.load(boost::memory_order_acquire) - consumed;
+        }
 
-    typedef priority_queue<MessageEntry, std::deque<MessageEntry>, CompareTriggerTime> TimebasedMessageQueue;
+        ThreadContext* GetReceiver() const {
+            return receiver;
+        }
+
+    private:
+
+        struct Block {
+
+            Block() : next(nullptr) {
+            }
+
+            MessageEntry entries[MAILBOX_BLOCK_SIZE];
+            boost::atomic<Block*> next;
+        };
+
+        ThreadContext* sender;
+        ThreadContext* receiver;
+
+        // sender side
+        Block* tail;
+        std::size_t tailIndex;
+        boost::atomic<boost::uint64_t> posted;
+        char senderPadding[CACHE_LINE_SIZE];
+
+        // written by the main thread
+        boost::atomic<boost::uint64_t> sealed;
+        char mainPadding[CACHE_LINE_SIZE];
+
+        // receiver side
+        Block* head;
+        std::size_t headIndex;
+        boost::uint64_t consumed;
+    };
 
     /**
      * Represents a thread context.
      *
      * @param threadId String id the thread identifier.
      * @param main tells the context is associated with the main thread.
-     * @param input queue for messages.
-     * @param output queue for messages.
+     * @param index position of the context in the mailbox tables.
+     * @param outboxes mailboxes to the other contexts, indexed by the receiver index.
+     * @param inboxes mailboxes from the other contexts.
      */
     struct ThreadContext {
 
         ThreadContext()
         : eventPublisher(nullptr),
-        input(ComparePriority()),
-        output(ComparePriority()),
-        futureEventList(CompareTriggerTime()),
         main(false),
+        index(0),
         receivedMessages(0),
         processedMessages(0),
         eventMessages(0) {
         }
 
         virtual ~ThreadContext() {
-            CleanUpQueue(input);
-            CleanUpQueue(output);
             safe_delete_item(eventPublisher);
         }
 
-        /**
-         * Cleanup the given queue reference.
-         * @param queue to clean up.
-         */
-        void CleanUpQueue(MessageQueue& queue) {
-            while (!queue.empty()) {
-                queue.pop();
-            }
-        }
-
         boost::thread::id threadId;
         bool main;
-        MessageQueue input;
-        MessageQueue output;
-        TimebasedMessageQueue futureEventList;
+        std::size_t index;
+        //written by this thread only
+        vector<Mailbox*> outboxes;
+        //read by this thread only; new mailboxes are added by the main thread
+        vector<Mailbox*> inboxes;
+        //messages being dispatched by this thread
+        vector<MessageEntry> dispatchBuffer;
+        //messages posted with a time offset since the last DispatchMessages()
+        TimedMessageWheel::Batch timedMessages;
         //event publisher for each thread context.
         EventPublisher* eventPublisher;
         // statistics
@@ -321,6 +493,30 @@ namespace {
      */
     ThreadContext* GetThreadContext();
 
+    /**
+     * Hands the mailboxes created since the last call over to their receivers.
+     * Attention: This function must be called by the main thread while all
+     * other threads wait.
+     */
+    void handOverNewMailboxes();
+
+    /**
+     * Puts the given entry in the mailboxes of its receivers.
+     * @param entry to route.
+     * @param context of the sender.
+     */
+    void route(const MessageEntry& entry, ThreadContext* context);
+
+    /**
+     * Routes the timed messages handed back by the timing wheel.
+     */
+    struct TimedMessageRouter {
+
+        void operator()(TimedMessage& timed) {
+            route(timed.entry, timed.sender);
+        }
+    };
+
     void deleteContext(ThreadContext* ctx){}
     /**
      * Deletes all contexts in the system
@@ -339,6 +535,20 @@ namespace {
     boost::thread_specific_ptr<ThreadContext> threadContext (deleteContext);
     ContextList threadContexts;
     boost::shared_mutex contextsMutex;
+    ThreadContext* mainThreadContext = nullptr;
+    std::size_t nextContextIndex = 0;
+
+    //mailboxes created since the last DispatchMessages()
+    vector<Mailbox*> newMailboxes;
+    //all mailboxes handed to their receivers
+    vector<Mailbox*> allMailboxes;
+    boost::mutex mailboxesMutex;
+
+    //messages posted with a time offset, by trigger time; used by the main thread only
+    TimedMessageWheel timedMessageWheel;
+
+    //set when a handler is re-registered to another thread context since the last DispatchMessages()
+    boost::atomic<bool> handlersMoved(false);
 }// anonymous namespace
 
 /***************************************************************************
@@ -353,7 +563,13 @@ void MessageBus::RegisterMainThread() {
         mainContext->main = true;
         GetInstance().context = static_cast<void*> (mainContext);
         threadContext.reset(mainContext);
-        threadContexts.push_back(mainContext);
+        {// thread-safe scope
+            upgrade_lock<shared_mutex> upgradeLock(contextsMutex);
+            upgrade_to_unique_lock<shared_mutex> lock(upgradeLock);
+            mainContext->index = nextContextIndex++;
+            threadContexts.push_back(mainContext);
+            mainThreadContext = mainContext;
+        }
         RegisterHandler(dynamic_cast<MessageHandler*> (mainContext->eventPublisher));
     } else {
         throw runtime_error("MessageBus - Main thread already has a context associated.");
@@ -369,6 +585,8 @@ void MessageBus::UnRegisterMainThread() {
 
     GetInstance().context = nullptr;
     deleteAllContexts();
+    // the context is gone; allow the main thread to register again
+    threadContext.reset();
 }
 
 void MessageBus::RegisterThread() {
@@ -380,6 +598,7 @@ void MessageBus::RegisterThread() {
         {// thread-safe scope
             upgrade_lock<shared_mutex> upgradeLock(contextsMutex);
             upgrade_to_unique_lock<shared_mutex> lock(upgradeLock);
+            context->index = nextContextIndex++;
             threadContexts.push_back(context);
         }
         threadContext.reset(context);
@@ -436,10 +655,21 @@ void MessageBus::ReRegisterHandler(MessageHandler* handler, void* newContext)
         {
             throw runtime_error("MessageBus - invalid thread context passed for re-registration");
         }
-        handler->context = newContext;
+        if (handler->context != newContext)
+        {
+            // the messages already posted to the old context are moved in the next DispatchMessages()
+            handler->context = newContext;
+            handlersMoved.store(true, boost::memory_order_relaxed);
+        }
     }
 }
 
+void* MessageBus::GetCurrentContext()
+{
+    CheckThreadContext();
+    return static_cast<void*>(GetThreadContext());
+}
+
 void MessageBus::DistributeMessages() {
     CheckMainThread();
     DispatchMessages();
@@ -447,60 +677,37 @@ void MessageBus::DistributeMessages() {
     ThreadDispatchMessages();
 }
 
-void dispatch(const MessageEntry& entry, ThreadContext* &context,ThreadContext* &mainContext)
-{
-    if (entry.event) {
-        context->eventMessages++;
-        //if it is an event then we need to distribute the event for all
-        //publishers in the system.
-        ContextList::iterator lstItr1 = threadContexts.begin();
-        while (lstItr1 != threadContexts.end()) {
-            ThreadContext* ctx = (*lstItr1);
-            //main context will receive the original message
-            //for other the message entry is cloned.
-            MessageEntry newEntry(entry);
-            newEntry.destination = dynamic_cast<MessageHandler*> (ctx->eventPublisher);
-            ctx->input.push(newEntry);
-            lstItr1++;
-        }
-    } else {               // it is a regular/single message
-        context->receivedMessages++;
-        if (entry.processOnMainThread) {
-            mainContext->input.push(entry);
-        } else {
-            ThreadContext* destinationContext = static_cast<ThreadContext*> (entry.destination->GetContext());
-            if (destinationContext) {
-                destinationContext->input.push(entry);
-            }
-        }
-    }
-};
-
 void MessageBus::DispatchMessages() {
     CheckMainThread();
     ThreadContext* mainContext = GetThreadContext();
     if (mainContext) {
         currentTime++;
+        // all threads wait, so the main thread can take their timed messages 
+        // and post them on their behalf.
         ContextList::iterator lstItr = threadContexts.begin();
         while (lstItr != threadContexts.end()) {
-            ThreadContext* context = (*lstItr);
-            while (!context->output.empty()) {
-                const MessageEntry& entry = context->output.top();
-                dispatch(entry, context, mainContext);
-                // internal messages go to the input queue of the main context.
-                context->output.pop();
-            }
-            while (!context->futureEventList.empty()) {
-                const MessageEntry& entry = context->futureEventList.top();
-                if (entry.triggerTime <= currentTime) {
-                    dispatch(entry, context, mainContext);
-                    context->futureEventList.pop();
-                } else {
-                    break;
-                }
-            }
+            timedMessageWheel.scheduleAll((*lstItr)->timedMessages);
             lstItr++;
         }
+        TimedMessageRouter router;
+        timedMessageWheel.advance(currentTime, router);
+
+        handOverNewMailboxes();
+
+        // messages posted to handlers which have moved to another thread context since are
+        // delivered to the new context in this distribution rather than forwarded in the next one
+        if (handlersMoved.exchange(false, boost::memory_order_relaxed)) {
+            const std::size_t numMailboxes = allMailboxes.size();
+            for (std::size_t i = 0; i < numMailboxes; i++) {
+                allMailboxes[i]->redirect();
+            }
+            handOverNewMailboxes();
+        }
+
+        // messages posted so far are dispatched in the next ThreadDispatchMessages() calls.
+        for (vector<Mailbox*>::iterator it = allMailboxes.begin(); it != allMailboxes.end(); ++it) {
+            (*it)->seal();
+        }
     }
 }
 
@@ -509,25 +716,36 @@ void MessageBus::ThreadDispatchMessages() {
     //gets main collector;
     ThreadContext* context = GetThreadContext();
     if (context) {
-        while (!context->input.empty()) {
-            const MessageEntry& entry = context->input.top();
+        vector<MessageEntry>& entries = context->dispatchBuffer;
+        for (vector<Mailbox*>::iterator it = context->inboxes.begin(); it != context->inboxes.end(); ++it) {
+            (*it)->drain(entries);
+        }
+        // messages from all senders are ordered by priority only here
+        std::stable_sort(entries.begin(), entries.end(), HigherPriority());
+
+        for (vector<MessageEntry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+            const MessageEntry& entry = *it;
             if (entry.destination && entry.message.get()) {
                 ThreadContext* destinationContext = static_cast<ThreadContext*> (entry.destination->context);
-                if (!entry.processOnMainThread && context->threadId != destinationContext->threadId) {
+                if (!entry.processOnMainThread && destinationContext != context) {
                     //The recepient of the message has moved to a different thread context
-                    //This is possible in MT, but not in LT or ST
+                    //since the message was posted. This is possible in MT, but not in LT or ST
                     if(ConfigManager::GetInstance().FullConfig().RunningMidTerm()) {
                         //Forward the message to the correct thread
-                        PostMessage(entry.destination, entry.type, entry.message, entry.processOnMainThread);
+                        if (destinationContext) {
+                            PostMessage(entry.destination, entry.type, entry.message, entry.processOnMainThread);
+                        }
                     } else {
                         throw runtime_error("Thread contexts inconsistency.");
                     }
+                } else {
+                    RandomService::Scope randomScope(entry.destination->GetRandomStream());
+                    entry.destination->HandleMessage(entry.type, *(entry.message.get()));
                 }
-                entry.destination->HandleMessage(entry.type, *(entry.message.get()));
+                context->processedMessages++;
             }
-            context->input.pop();
-            context->processedMessages++;
         }
+        entries.clear();
     }
 }
 
@@ -552,12 +770,12 @@ void MessageBus::PostMessage(MessageHandler* destination, Message::MessageType t
             entry.processOnMainThread = processOnMainThread;
             if (timeOffset == 0)
             {
-                context->output.push(entry);
+                route(entry, context);
             }
             else
             {
                 entry.triggerTime = currentTime + timeOffset;
-                context->futureEventList.push(entry);
+                context->timedMessages.push_back(std::make_pair(entry.triggerTime, TimedMessage(entry, context)));
             }
         }
     }
@@ -661,7 +879,7 @@ void MessageBus::PublishEvent(event::EventId id, event::Context ctx, EventArgsPt
     CheckThreadContext();
     ThreadContext* context = GetThreadContext();
     if (context) {
-        PostMessage(nullptr, MSGI_PUBLISH_EVENT, MessagePtr(new InternalEventMessage(id, ctx, args)));
+        PostMessage(nullptr, MSGI_PUBLISH_EVENT, MakeMessage<InternalEventMessage>(id, ctx, args));
     }
 }
 
@@ -713,7 +931,70 @@ namespace {
         return threadContext.get();
     }
 
+    Mailbox* GetMailbox(ThreadContext* sender, ThreadContext* receiver) {
+        if (receiver->index >= sender->outboxes.size()) {
+            sender->outboxes.resize(receiver->index + 1, nullptr);
+        }
+        Mailbox*& mailbox = sender->outboxes[receiver->index];
+        if (!mailbox) {
+            mailbox = new Mailbox(sender, receiver);
+            boost::mutex::scoped_lock lock(mailboxesMutex);
+            newMailboxes.push_back(mailbox);
+        }
+        return mailbox;
+    }
+
+    void handOverNewMailboxes() {
+        boost::mutex::scoped_lock lock(mailboxesMutex);
+        for (vector<Mailbox*>::iterator it = newMailboxes.begin(); it != newMailboxes.end(); ++it) {
+            (*it)->GetReceiver()->inboxes.push_back(*it);
+            allMailboxes.push_back(*it);
+        }
+        newMailboxes.clear();
+    }
+
+    void route(const MessageEntry& entry, ThreadContext* context) {
+        if (entry.event) {
+            context->eventMessages++;
+            //if it is an event then we need to distribute the event for all
+            //publishers in the system.
+            shared_lock<shared_mutex> lock(contextsMutex);
+            ContextList::iterator lstItr = threadContexts.begin();
+            while (lstItr != threadContexts.end()) {
+                ThreadContext* ctx = (*lstItr);
+                MessageEntry newEntry(entry);
+                newEntry.destination = dynamic_cast<MessageHandler*> (ctx->eventPublisher);
+                GetMailbox(context, ctx)->push(newEntry);
+                lstItr++;
+            }
+        } else {               // it is a regular/single message
+            context->receivedMessages++;
+            if (entry.processOnMainThread) {
+                GetMailbox(context, mainThreadContext)->push(entry);
+            } else {
+                ThreadContext* destinationContext = static_cast<ThreadContext*> (entry.destination->GetContext());
+                if (destinationContext) {
+                    GetMailbox(context, destinationContext)->push(entry);
+                }
+            }
+        }
+    }
+
     void deleteAllContexts() {
+        {
+            boost::mutex::scoped_lock lock(mailboxesMutex);
+            allMailboxes.insert(allMailboxes.end(), newMailboxes.begin(), newMailboxes.end());
+            newMailboxes.clear();
+            for (vector<Mailbox*>::iterator it = allMailboxes.begin(); it != allMailboxes.end(); ++it) {
+                delete *it;
+            }
+            allMailboxes.clear();
+        }
+        mainThreadContext = nullptr;
+        nextContextIndex = 0;
+        handlersMoved.store(false, boost::memory_order_relaxed);
+        timedMessageWheel.clear();
+
         ContextList::iterator itr = threadContexts.begin();
         while (itr != threadContexts.end()) {
             ThreadContext* ctx = (*itr);
@@ -736,7 +1017,10 @@ namespace {
         while (itr != threadContexts.end()) {
             ThreadContext* ctx = (*itr);
             if (ctx) {
-                long long int remaining = (ctx->input.size() + ctx->output.size());
+                long long int remaining = 0;
+                for (vector<Mailbox*>::iterator it = ctx->inboxes.begin(); it != ctx->inboxes.end(); ++it) {
+                    remaining += (*it)->pending();
+                }
                 boost::format fmtr = boost::format(REPORT_LINE);
                 fmtr % ctx->threadId %
                         ctx->receivedMessages %
@@ -769,6 +1053,10 @@ namespace {
         long long int balance = abs((long long int)((totalProcessed - totalReceived - (totalEvents * numThreads)) - totalRemaining));
         PrintOut("Balance (Should be 0):  " << balance << std::endl);
         PrintOut(endl);
+        std::ostringstream poolStats;
+        sim_mob::SlabPool::printStats(poolStats);
+        PrintOut(poolStats.str());
+        PrintOut(endl);
         PrintOut("##############################################################" << endl);
         PrintOut(endl);
     }
@@ -11,8 +11,11 @@
 #pragma once
 #include "MessageHandler.hpp"
 #include "event/EventListener.hpp"
+#include "util/SlabPool.hpp"
 #include <boost/thread.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
+#include <utility>
 
 namespace sim_mob {
 
@@ -27,11 +30,42 @@ namespace sim_mob {
          * workers still waiting in the frameTick barrier. Otherwise we cannot guarantee 
          * the thread-safety for the internal messages and main thread messages. 
          * 
+         * Messages travel through one single-producer/single-consumer mailbox per
+         * (sender thread, receiver thread) pair. Posting appends to the mailbox of
+         * the receiver without locking; DistributeMessages only makes the messages
+         * posted so far visible to the receivers, which order them by priority
+         * when they dispatch them.
+         * 
          */
         class MessageBus : public MessageHandler {
         public:
             typedef boost::shared_ptr<Message> MessagePtr;
             typedef boost::shared_ptr<event::EventArgs> EventArgsPtr;
+
+            /**
+             * Creates a message in the pool of the current thread (see SlabPool).
+             * The message and its reference count share one pooled block, which
+             * goes back to the pool of the sender when the last reference is
+             * dropped, usually by the receiver right after dispatch.
+             * Use it instead of MessagePtr(new T(...)) for frequent messages.
+             * @param args arguments of the constructor of T.
+             * @return the new message.
+             */
+            template<typename T, typename... Args>
+            static MessagePtr MakeMessage(Args&&... args) {
+                return boost::allocate_shared<T>(SlabAllocator<T>(), std::forward<Args>(args)...);
+            }
+
+            /**
+             * Creates event data in the pool of the current thread, as MakeMessage.
+             * @param args arguments of the constructor of T.
+             * @return the new event data.
+             */
+            template<typename T, typename... Args>
+            static EventArgsPtr MakeEventArgs(Args&&... args) {
+                return boost::allocate_shared<T>(SlabAllocator<T>(), std::forward<Args>(args)...);
+            }
+
             /**
              * Registers the main thread that will manage all MessageBus system.
              * Attention: You must call this function using the main thread.
@@ -88,18 +122,28 @@ namespace sim_mob {
              * note: this function is for convenience in cases where agents are managed by other agents.
              * note: the new context can be obtained from the managing entity.
              * note: it is the caller's responsibility to ensure that the correct context is passed
+             * note: messages already posted to the handler are moved to the new context by the next
+             * DistributeMessages(), so they are still dispatched in the next tick.
              * @param handler MessageHandler to update
              * @param newContext the new context to register the handler into
              * @throws runtime_exception if the current thread context is not registered
              */
             static void ReRegisterHandler(MessageHandler* handler, void* newContext);
 
+            /**
+             * Gets the context of the calling thread.
+             * note: the returned value is opaque. It is meant to be handed over to
+             * another thread which later moves handlers into this context with ReRegisterHandler().
+             * @return context of the calling thread
+             * @throws runtime_exception if the thread that calls is not registered.
+             */
+            static void* GetCurrentContext();
+
             /**
              * MessageBus distributes all messages for all registered threads.
-             * Collects all messages from output queues of all thread contexts and
-             * copies them to the output queue of the main message handler.
-             * After that messages are distributed for the correspondent
-             * thread input queue.
+             * Releases the messages posted by all thread contexts since the
+             * last call (and delayed messages which are due) to their receivers,
+             * then dispatches the messages of the main thread.
              * 
              * Note: All internal messages are processed before all custom messages.
              * Attention: This function should be called by the main thread.
@@ -117,9 +161,10 @@ namespace sim_mob {
             static void ThreadDispatchMessages();
 
             /**
-             * Posts a message on the current thread output queue.
-             * The message will be posted & processed on the right queue
-             * after the DistributeMessages() and ThreadDispatchMessages() calls.
+             * Posts a message in the mailbox from the current thread to the
+             * thread of the target (or to the main thread).
+             * The message will be processed by that thread after the
+             * DistributeMessages() and ThreadDispatchMessages() calls.
              * @param target of the message.
              * @param type of the message.
              * @param message to send.
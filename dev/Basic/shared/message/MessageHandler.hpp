@@ -15,6 +15,8 @@
 namespace sim_mob
 {
 
+class RandomStream;
+
 namespace messaging
 {
 
@@ -44,6 +46,15 @@ public:
      */
     unsigned int GetId() const;
 
+    /**
+     * Gets the random stream used while the handler handles its messages.
+     * @return the stream, or null to draw from the current stream of the dispatching thread.
+     */
+    virtual RandomStream* GetRandomStream()
+    {
+        return nullptr;
+    }
+
     void* GetContext() const
     {
         return context;
@@ -0,0 +1,510 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "BulkPathSetWriter.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <boost/thread/locks.hpp>
+#include "geospatial/network/Link.hpp"
+#include "logging/Log.hpp"
+#include "util/OutputStreamer.hpp"
+#include "util/VarInt.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+const char MAGIC[] = { 'S', 'M', 'P', 'S' };
+const boost::uint64_t FORMAT_VERSION = 1;
+
+/** largest number of bytes of a variable length integer */
+const std::size_t MAX_VARINT_SIZE = 10;
+
+enum PathFlags
+{
+    MIN_DISTANCE = 1 << 0,
+    MIN_SIGNALS = 1 << 1,
+    MIN_RIGHT_TURNS = 1 << 2,
+    MAX_HIGHWAY_USAGE = 1 << 3,
+    VALID_PATH = 1 << 4,
+    SHORTEST_PATH = 1 << 5,
+    MIN_TRAVEL_TIME = 1 << 6
+};
+
+void writeDouble(double value, std::vector<boost::uint8_t>& bytes)
+{
+    boost::uint8_t raw[sizeof(double)];
+    std::memcpy(raw, &value, sizeof(double));
+    bytes.insert(bytes.end(), raw, raw + sizeof(double));
+}
+
+double readDouble(const boost::uint8_t*& next)
+{
+    double value = 0.0;
+    std::memcpy(&value, next, sizeof(double));
+    next += sizeof(double);
+    return value;
+}
+
+std::string getCheckpointFile(const std::string& basePath)
+{
+    return basePath + ".checkpoint";
+}
+
+/** size of the blocks of rows written to the sink by loadShards() */
+const std::size_t LOAD_BLOCK_SIZE = 1 << 20;
+
+/**
+ * appends a text value to a row of COPY ... FROM STDIN, escaping the characters which would end the value (the path
+ * ids hold commas)
+ */
+void appendCopyValue(const std::string& value, std::ostream& row)
+{
+    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    {
+        switch (*it)
+        {
+        case '\\':
+        case ',':
+            row << '\\' << *it;
+            break;
+        case '\n':
+            row << "\\n";
+            break;
+        case '\r':
+            row << "\\r";
+            break;
+        default:
+            row << *it;
+        }
+    }
+}
+
+/** removes the shard files from the first index on, left by an earlier generation */
+void removeShardFiles(const std::string& basePath, std::size_t first)
+{
+    for (std::size_t i = first; boost::filesystem::exists(BulkPathSetWriter::getShardFile(basePath, i)); ++i)
+    {
+        boost::filesystem::remove(BulkPathSetWriter::getShardFile(basePath, i));
+    }
+}
+}
+
+BulkPathSetWriter::BulkPathSetWriter(const std::string& basePath, std::size_t numODs, unsigned int checkpointInterval) :
+        basePath(basePath), checkpointInterval(checkpointInterval), completed(numODs, false), numCompleted(0),
+        numResumed(0), startTime(Clock::now()), lastCheckpointTime(startTime), lastCheckpointCompleted(0)
+{
+    loadCheckpoint();
+    numResumed = numCompleted;
+    lastCheckpointCompleted = numCompleted;
+}
+
+BulkPathSetWriter::~BulkPathSetWriter()
+{
+    for (std::vector<boost::shared_ptr<Shard> >::iterator it = shards.begin(); it != shards.end(); ++it)
+    {
+        if ((*it)->file)
+        {
+            std::fclose((*it)->file);
+        }
+    }
+}
+
+std::string BulkPathSetWriter::getShardFile(const std::string& basePath, std::size_t shard)
+{
+    std::stringstream name;
+    name << basePath << "." << shard << ".bin";
+    return name.str();
+}
+
+void BulkPathSetWriter::loadCheckpoint()
+{
+    std::ifstream in(getCheckpointFile(basePath).c_str());
+    if (!in)
+    {
+        removeShardFiles(basePath, 0);
+        return;
+    }
+
+    std::string tag;
+    std::size_t numODs = 0;
+    if (!(in >> tag >> numODs) || tag != "numODs" || numODs != completed.size())
+    {
+        std::stringstream msg;
+        msg << "BulkPathSetWriter: checkpoint " << getCheckpointFile(basePath) << " does not belong to a generation of "
+            << completed.size() << " ODs; remove it to restart the generation";
+        throw std::runtime_error(msg.str());
+    }
+
+    std::size_t index = 0;
+    boost::uint64_t committedSize = 0;
+    std::size_t first = 0, last = 0;
+    while (in >> tag)
+    {
+        if (tag == "shard" && in >> index >> committedSize && index == shards.size())
+        {
+            boost::shared_ptr<Shard> shard(new Shard());
+            shard->name = getShardFile(basePath, index);
+            shard->committedSize = committedSize;
+            if (boost::filesystem::exists(shard->name))
+            {
+                boost::filesystem::resize_file(shard->name, committedSize);
+            }
+            else if (committedSize > 0)
+            {
+                throw std::runtime_error("BulkPathSetWriter: missing output file " + shard->name);
+            }
+            shards.push_back(shard);
+            freeShards.push_back(shard);
+        }
+        else if (tag == "done" && in >> first >> last && first <= last && last < completed.size())
+        {
+            for (std::size_t i = first; i <= last; ++i)
+            {
+                completed[i] = true;
+            }
+            numCompleted += last - first + 1;
+        }
+        else
+        {
+            throw std::runtime_error("BulkPathSetWriter: invalid checkpoint " + getCheckpointFile(basePath));
+        }
+    }
+    removeShardFiles(basePath, shards.size());
+    Print() << "Resuming bulk pathset generation: " << numCompleted << " of " << completed.size()
+            << " ODs already generated\n";
+}
+
+void BulkPathSetWriter::saveCheckpoint()
+{
+    const std::string file = getCheckpointFile(basePath);
+    const std::string tmpFile = file + ".tmp";
+    {
+        std::ofstream out(tmpFile.c_str(), std::ios::trunc);
+        out << "numODs " << completed.size() << "\n";
+        for (std::size_t i = 0; i < shards.size(); ++i)
+        {
+            out << "shard " << i << " " << shards[i]->committedSize << "\n";
+        }
+        for (std::size_t i = 0; i < completed.size(); ++i)
+        {
+            if (completed[i])
+            {
+                std::size_t first = i;
+                while (i + 1 < completed.size() && completed[i + 1])
+                {
+                    ++i;
+                }
+                out << "done " << first << " " << i << "\n";
+            }
+        }
+        out.flush();
+        if (!out)
+        {
+            throw std::runtime_error("BulkPathSetWriter: cannot write checkpoint " + tmpFile);
+        }
+    }
+    //Replace the previous checkpoint at once, so that an interruption leaves one of the two in place
+    if (std::rename(tmpFile.c_str(), file.c_str()) != 0)
+    {
+        throw std::runtime_error("BulkPathSetWriter: cannot replace checkpoint " + file);
+    }
+}
+
+void BulkPathSetWriter::reportProgress(const Clock::time_point& now)
+{
+    double recentSeconds = boost::chrono::duration<double>(now - lastCheckpointTime).count();
+    double totalSeconds = boost::chrono::duration<double>(now - startTime).count();
+    std::size_t recent = numCompleted - lastCheckpointCompleted;
+    std::size_t total = numCompleted - numResumed;
+    Print() << "Bulk pathset generation: " << numCompleted << " of " << completed.size() << " ODs generated, "
+            << (recentSeconds > 0 ? recent / recentSeconds : 0.0) << " ODs/s since the last checkpoint, "
+            << (totalSeconds > 0 ? total / totalSeconds : 0.0) << " ODs/s overall\n";
+    lastCheckpointTime = now;
+    lastCheckpointCompleted = numCompleted;
+}
+
+BulkPathSetWriter::Shard& BulkPathSetWriter::getShard()
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    boost::shared_ptr<Shard>& shard = threadShards[boost::this_thread::get_id()];
+    if (shard)
+    {
+        return *shard;
+    }
+
+    if (!freeShards.empty())
+    {
+        shard = freeShards.back();
+        freeShards.pop_back();
+    }
+    else
+    {
+        shard.reset(new Shard());
+        shard->name = getShardFile(basePath, shards.size());
+        shards.push_back(shard);
+    }
+
+    if (shard->committedSize > 0)
+    {
+        shard->file = std::fopen(shard->name.c_str(), "r+b");
+        if (shard->file && std::fseek(shard->file, 0, SEEK_END) != 0)
+        {
+            std::fclose(shard->file);
+            shard->file = nullptr;
+        }
+        shard->size = shard->committedSize;
+    }
+    else
+    {
+        std::vector<boost::uint8_t> header(MAGIC, MAGIC + sizeof(MAGIC));
+        varint::writeUnsigned(FORMAT_VERSION, header);
+        shard->file = std::fopen(shard->name.c_str(), "wb");
+        if (shard->file && std::fwrite(&header[0], 1, header.size(), shard->file) != header.size())
+        {
+            std::fclose(shard->file);
+            shard->file = nullptr;
+        }
+        shard->size = header.size();
+    }
+
+    if (!shard->file)
+    {
+        throw std::runtime_error("BulkPathSetWriter: cannot open output file " + shard->name);
+    }
+    return *shard;
+}
+
+bool BulkPathSetWriter::isCompleted(std::size_t odIndex) const
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return odIndex < completed.size() && completed[odIndex];
+}
+
+std::size_t BulkPathSetWriter::getNumCompleted() const
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return numCompleted;
+}
+
+void BulkPathSetWriter::write(unsigned int origin, unsigned int destination, const std::set<SinglePath*, SinglePath>& paths)
+{
+    std::vector<boost::uint8_t> bytes;
+    std::size_t numPaths = 0;
+    for (std::set<SinglePath*, SinglePath>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+    {
+        if ((*it)->isNeedSave2DB)
+        {
+            ++numPaths;
+        }
+    }
+    varint::writeUnsigned(origin, bytes);
+    varint::writeUnsigned(destination, bytes);
+    varint::writeUnsigned(numPaths, bytes);
+
+    for (std::set<SinglePath*, SinglePath>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+    {
+        const SinglePath* sp = *it;
+        if (!sp->isNeedSave2DB)
+        {
+            continue;
+        }
+        varint::writeUnsigned(sp->scenario.size(), bytes);
+        bytes.insert(bytes.end(), sp->scenario.begin(), sp->scenario.end());
+        writeDouble(sp->partialUtility, bytes);
+        writeDouble(sp->pathSize, bytes);
+        varint::writeSigned(sp->signalNumber, bytes);
+        varint::writeSigned(sp->rightTurnNumber, bytes);
+        writeDouble(sp->length, bytes);
+        writeDouble(sp->highWayDistance, bytes);
+        writeDouble(sp->travelTime, bytes);
+        bytes.push_back(static_cast<boost::uint8_t>((sp->minDistance ? MIN_DISTANCE : 0) | (sp->minSignals ? MIN_SIGNALS : 0)
+                | (sp->minRightTurns ? MIN_RIGHT_TURNS : 0) | (sp->maxHighWayUsage ? MAX_HIGHWAY_USAGE : 0)
+                | (sp->validPath ? VALID_PATH : 0) | (sp->shortestPath ? SHORTEST_PATH : 0)
+                | (sp->minTravelTime ? MIN_TRAVEL_TIME : 0)));
+
+        varint::writeUnsigned(sp->links ? sp->links->size() : 0, bytes);
+        if (sp->links)
+        {
+            boost::int64_t previous = 0;
+            for (CompactPath::const_iterator linkIt = sp->links->begin(); linkIt != sp->links->end(); ++linkIt)
+            {
+                boost::int64_t linkId = (*linkIt)->getLinkId();
+                varint::writeSigned(linkId - previous, bytes);
+                previous = linkId;
+            }
+        }
+    }
+
+    Shard& shard = getShard();
+    if (std::fwrite(&bytes[0], 1, bytes.size(), shard.file) != bytes.size())
+    {
+        throw std::runtime_error("BulkPathSetWriter: cannot write to " + shard.name);
+    }
+    shard.size += bytes.size();
+}
+
+void BulkPathSetWriter::complete(std::size_t odIndex)
+{
+    Shard& shard = getShard();
+    if (std::fflush(shard.file) != 0)
+    {
+        throw std::runtime_error("BulkPathSetWriter: cannot write to " + shard.name);
+    }
+
+    boost::unique_lock<boost::mutex> lock(mutex);
+    shard.committedSize = shard.size;
+    if (odIndex < completed.size() && !completed[odIndex])
+    {
+        completed[odIndex] = true;
+        ++numCompleted;
+    }
+
+    Clock::time_point now = Clock::now();
+    if (now - lastCheckpointTime >= checkpointInterval)
+    {
+        saveCheckpoint();
+        reportProgress(now);
+    }
+}
+
+void BulkPathSetWriter::finish()
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    saveCheckpoint();
+    double seconds = boost::chrono::duration<double>(Clock::now() - startTime).count();
+    Print() << "Bulk pathset generation finished: " << numCompleted << " of " << completed.size() << " ODs generated, "
+            << (seconds > 0 ? (numCompleted - numResumed) / seconds : 0.0) << " ODs/s\n";
+}
+
+void BulkPathSetWriter::readShard(const std::string& shardFile, std::vector<BulkPathSetRecord>& pathSets)
+{
+    std::ifstream in(shardFile.c_str(), std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("BulkPathSetWriter: cannot read " + shardFile);
+    }
+    std::vector<boost::uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::size_t size = bytes.size();
+
+    //Padding, so that a truncated record is detected after decoding it rather than read past the buffer
+    bytes.resize(size + MAX_VARINT_SIZE + sizeof(double), 0);
+    const boost::uint8_t* next = &bytes[0];
+    const boost::uint8_t* end = next + size;
+
+    if (size < sizeof(MAGIC) || std::memcmp(next, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw std::runtime_error("BulkPathSetWriter: " + shardFile + " is not a pathset file");
+    }
+    next += sizeof(MAGIC);
+    if (varint::readUnsigned(next) != FORMAT_VERSION)
+    {
+        throw std::runtime_error("BulkPathSetWriter: unsupported format version in " + shardFile);
+    }
+
+    while (next < end)
+    {
+        BulkPathSetRecord pathSet;
+        pathSet.origin = static_cast<unsigned int>(varint::readUnsigned(next));
+        pathSet.destination = static_cast<unsigned int>(varint::readUnsigned(next));
+        boost::uint64_t numPaths = varint::readUnsigned(next);
+        for (boost::uint64_t i = 0; i < numPaths && next <= end; ++i)
+        {
+            BulkPathRecord path;
+            boost::uint64_t scenarioSize = varint::readUnsigned(next);
+            if (scenarioSize > static_cast<boost::uint64_t>(end - next))
+            {
+                break;
+            }
+            path.scenario.assign(next, next + scenarioSize);
+            next += scenarioSize;
+            path.partialUtility = readDouble(next);
+            path.pathSize = readDouble(next);
+            path.signalNumber = static_cast<int>(varint::readSigned(next));
+            path.rightTurnNumber = static_cast<int>(varint::readSigned(next));
+            path.length = readDouble(next);
+            path.highWayDistance = readDouble(next);
+            path.travelTime = readDouble(next);
+            boost::uint8_t flags = *next++;
+            path.minDistance = flags & MIN_DISTANCE;
+            path.minSignals = flags & MIN_SIGNALS;
+            path.minRightTurns = flags & MIN_RIGHT_TURNS;
+            path.maxHighWayUsage = flags & MAX_HIGHWAY_USAGE;
+            path.validPath = flags & VALID_PATH;
+            path.shortestPath = flags & SHORTEST_PATH;
+            path.minTravelTime = flags & MIN_TRAVEL_TIME;
+
+            boost::uint64_t numLinks = varint::readUnsigned(next);
+            boost::int64_t linkId = 0;
+            for (boost::uint64_t j = 0; j < numLinks && next <= end; ++j)
+            {
+                linkId += varint::readSigned(next);
+                path.linkIds.push_back(static_cast<unsigned int>(linkId));
+            }
+            pathSet.paths.push_back(path);
+        }
+        if (next > end || pathSet.paths.size() != numPaths)
+        {
+            throw std::runtime_error("BulkPathSetWriter: " + shardFile + " is truncated");
+        }
+        pathSets.push_back(pathSet);
+    }
+}
+
+const std::vector<std::string>& BulkPathSetWriter::getTableColumns()
+{
+    static const char* names[] = { "pathset_origin_node", "pathset_dest_node", "scenario", "path", "partial_utility",
+                                   "path_size", "signal_number", "right_turn_number", "length", "highway_distance",
+                                   "min_distance", "min_signal", "min_right_turn", "max_highway_usage", "valid_path",
+                                   "shortest_path", "default_travel_time", "min_default_tt" };
+    static const std::vector<std::string> columns(names, names + sizeof(names) / sizeof(names[0]));
+    return columns;
+}
+
+std::size_t BulkPathSetWriter::loadShards(const std::string& basePath, OutputSink& sink)
+{
+    std::size_t numPaths = 0;
+    for (std::size_t shard = 0; boost::filesystem::exists(getShardFile(basePath, shard)); ++shard)
+    {
+        std::vector<BulkPathSetRecord> pathSets;
+        readShard(getShardFile(basePath, shard), pathSets);
+
+        //the values are formatted as in the csv output
+        std::stringstream rows;
+        for (std::vector<BulkPathSetRecord>::const_iterator psIt = pathSets.begin(); psIt != pathSets.end(); ++psIt)
+        {
+            for (std::vector<BulkPathRecord>::const_iterator it = psIt->paths.begin(); it != psIt->paths.end(); ++it)
+            {
+                std::stringstream pathId;
+                for (std::vector<unsigned int>::const_iterator linkIt = it->linkIds.begin(); linkIt != it->linkIds.end(); ++linkIt)
+                {
+                    pathId << *linkIt << ",";
+                }
+
+                rows << psIt->origin << "," << psIt->destination << ",";
+                appendCopyValue(it->scenario, rows);
+                rows << ",";
+                appendCopyValue(pathId.str(), rows);
+                rows << "," << it->partialUtility << "," << it->pathSize << "," << it->signalNumber << ","
+                     << it->rightTurnNumber << "," << it->length << "," << it->highWayDistance << ","
+                     << it->minDistance << "," << it->minSignals << "," << it->minRightTurns << ","
+                     << it->maxHighWayUsage << "," << it->validPath << "," << it->shortestPath << ","
+                     << it->travelTime << "," << it->minTravelTime << "\n";
+                numPaths++;
+            }
+            if (rows.tellp() >= static_cast<std::streamoff>(LOAD_BLOCK_SIZE))
+            {
+                sink.write(rows.str());
+                rows.str(std::string());
+            }
+        }
+        sink.write(rows.str());
+    }
+    return numPaths;
+}
@@ -0,0 +1,214 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/utility.hpp>
+#include "path/Path.hpp"
+
+namespace sim_mob
+{
+
+class OutputSink;
+
+/** a path read back from the output of bulk pathset generation */
+struct BulkPathRecord
+{
+    BulkPathRecord() :
+            partialUtility(0.0), pathSize(0.0), signalNumber(0), rightTurnNumber(0), length(0.0), highWayDistance(0.0),
+            travelTime(0.0), minDistance(false), minSignals(false), minRightTurns(false), maxHighWayUsage(false),
+            validPath(false), shortestPath(false), minTravelTime(false)
+    {
+    }
+
+    std::string scenario;
+    std::vector<unsigned int> linkIds;
+    double partialUtility;
+    double pathSize;
+    int signalNumber;
+    int rightTurnNumber;
+    double length;
+    double highWayDistance;
+    double travelTime;
+    bool minDistance;
+    bool minSignals;
+    bool minRightTurns;
+    bool maxHighWayUsage;
+    bool validPath;
+    bool shortestPath;
+    bool minTravelTime;
+};
+
+/** a pathset read back from the output of bulk pathset generation */
+struct BulkPathSetRecord
+{
+    BulkPathSetRecord() : origin(0), destination(0)
+    {
+    }
+
+    unsigned int origin;
+    unsigned int destination;
+    std::vector<BulkPathRecord> paths;
+};
+
+/**
+ * Binary output of bulk pathset generation, which can resume an interrupted generation.
+ *
+ * Each thread writing pathsets appends them to a shard file of its own, "<base>.<n>.bin", so that the generator
+ * threads never share a stream. A shard starts with a magic number and a format version, followed by the pathsets:
+ * the origin and destination node ids and the number of paths, then for each path its scenario, its attributes (the
+ * columns of the csv output) and its link ids, stored as the difference to the previous link id. Integers are
+ * variable length (see util/VarInt.hpp); doubles are stored in the byte order of the generating machine.
+ *
+ * The ODs of a generation are numbered by the caller, in an order which must not change between runs. A thread calls
+ * complete() once it has written all the pathsets of an OD; the completed ODs and the size of the shards they were
+ * written to are saved every checkpoint interval into "<base>.checkpoint". A writer created on the same base file
+ * reloads the checkpoint, truncates the shards to their checkpointed sizes (dropping the pathsets of the ODs which
+ * were not completed) and appends to them.
+ */
+class BulkPathSetWriter : private boost::noncopyable
+{
+public:
+    /**
+     * @param basePath base name of the output files
+     * @param numODs number of ODs of the generation
+     * @param checkpointInterval seconds between checkpoints (and progress reports)
+     * @throws std::runtime_error if a checkpoint exists for a different number of ODs, or cannot be read
+     */
+    BulkPathSetWriter(const std::string& basePath, std::size_t numODs, unsigned int checkpointInterval);
+
+    ~BulkPathSetWriter();
+
+    /**
+     * @param odIndex index of an OD
+     * @return true if the OD was completed by a previous run
+     */
+    bool isCompleted(std::size_t odIndex) const;
+
+    /**
+     * appends the paths of a pathset which are to be stored to the shard of the calling thread
+     * @param origin id of the origin node
+     * @param destination id of the destination node
+     * @param paths the paths
+     * @throws std::runtime_error if the shard cannot be written
+     */
+    void write(unsigned int origin, unsigned int destination, const std::set<SinglePath*, SinglePath>& paths);
+
+    /**
+     * marks an OD as completed, with all the pathsets written by the calling thread so far. Writes a checkpoint when
+     * the checkpoint interval has elapsed.
+     * @param odIndex index of the OD
+     * @throws std::runtime_error if the shard cannot be flushed, or the checkpoint cannot be written
+     */
+    void complete(std::size_t odIndex);
+
+    /**
+     * writes a last checkpoint and reports the throughput of the generation
+     */
+    void finish();
+
+    /**
+     * @return the number of completed ODs, including those completed by previous runs
+     */
+    std::size_t getNumCompleted() const;
+
+    /**
+     * @param basePath base name of the output files
+     * @param shard index of a shard
+     * @return the name of the shard file
+     */
+    static std::string getShardFile(const std::string& basePath, std::size_t shard);
+
+    /**
+     * reads back a shard file
+     * @param shardFile name of the shard file
+     * @param pathSets output pathsets; the pathsets of the file are appended
+     * @throws std::runtime_error if the file cannot be read or is not a valid shard
+     */
+    static void readShard(const std::string& shardFile, std::vector<BulkPathSetRecord>& pathSets);
+
+    /**
+     * @return the columns of the rows written by loadShards(), which are those of the csv output
+     */
+    static const std::vector<std::string>& getTableColumns();
+
+    /**
+     * loads the output of a generation into the pathset table: the shards are read back one at a time, and their
+     * paths written to the sink as comma separated rows in the format of COPY ... FROM STDIN
+     * @param basePath base name of the output files
+     * @param sink output sink of the rows, e.g. a PG_CopySink on the pathset table; not closed
+     * @return the number of paths written
+     * @throws std::runtime_error if a shard cannot be read, or the sink fails
+     */
+    static std::size_t loadShards(const std::string& basePath, OutputSink& sink);
+
+private:
+    /** output file of a thread */
+    struct Shard
+    {
+        Shard() : file(nullptr), size(0), committedSize(0)
+        {
+        }
+
+        std::string name;
+        std::FILE* file;
+
+        /** bytes written; only accessed by the thread of the shard */
+        boost::uint64_t size;
+
+        /** bytes holding the pathsets of completed ODs; only accessed under the mutex of the writer */
+        boost::uint64_t committedSize;
+    };
+
+    typedef boost::chrono::steady_clock Clock;
+
+    /** finds the shard of the calling thread, opening one if needed */
+    Shard& getShard();
+
+    /** reloads the checkpoint, if any */
+    void loadCheckpoint();
+
+    /** saves the completed ODs and the committed shard sizes; called under the mutex */
+    void saveCheckpoint();
+
+    /** prints the progress of the generation; called under the mutex */
+    void reportProgress(const Clock::time_point& now);
+
+    const std::string basePath;
+    const boost::chrono::seconds checkpointInterval;
+
+    /** guards the members below */
+    mutable boost::mutex mutex;
+
+    std::vector<boost::shared_ptr<Shard> > shards;
+
+    /** shards reloaded from a checkpoint, not yet taken by a thread */
+    std::vector<boost::shared_ptr<Shard> > freeShards;
+
+    boost::unordered_map<boost::thread::id, boost::shared_ptr<Shard> > threadShards;
+
+    /** completion flag of each OD */
+    std::vector<bool> completed;
+    std::size_t numCompleted;
+
+    /** number of ODs completed by previous runs */
+    std::size_t numResumed;
+
+    Clock::time_point startTime;
+    Clock::time_point lastCheckpointTime;
+    std::size_t lastCheckpointCompleted;
+};
+
+}
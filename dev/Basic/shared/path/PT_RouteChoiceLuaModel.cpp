@@ -22,6 +22,7 @@
 #include "lua/LuaLibrary.hpp"
 #include "lua/third-party/luabridge/LuaBridge.h"
 #include "lua/third-party/luabridge/RefCountedObject.h"
+#include "PathSetCache.hpp"
 #include "PT_PathSetManager.hpp"
 #include "PT_RouteChoiceLuaModel.hpp"
 #include "SOCI_Converters.hpp"
@@ -328,7 +329,21 @@ void PT_RouteChoiceLuaModel::loadPT_PathSet(int origin, int dest, const DailyTim
     const PT_Statistics* ptStats = PT_Statistics::getInstance();
 
     std::vector<sim_mob::PT_Path> paths;
-    loadPT_PathsetFromDB(*dbSession, ptPathsetStoredProcName, origin, dest, paths, type);
+    PathSetCache& cache = PathSetCache::getInstance();
+    const PathSetCache::Cache::KeyType key = cache.makeKey(origin, dest, curTime, PathSetCache::PUBLIC_TRANSIT + type);
+    PathSetCache::Cache::ValueType cached;
+    if (cache.find(key, cached) && cached->procedure == ptPathsetStoredProcName)
+    {
+        paths = cached->publicTransitPaths; //copied, as their travel times are computed below
+    }
+    else
+    {
+        loadPT_PathsetFromDB(*dbSession, ptPathsetStoredProcName, origin, dest, paths, type);
+        boost::shared_ptr<CachedPathSet> entry(new CachedPathSet());
+        entry->publicTransitPaths = paths;
+        entry->procedure = ptPathsetStoredProcName;
+        cache.insert(key, entry);
+    }
     for(auto& path : paths)
     {
         std::vector<PT_NetworkEdge> pathEdges = path.getPathEdges();
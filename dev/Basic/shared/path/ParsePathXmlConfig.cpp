@@ -140,6 +140,23 @@ void sim_mob::ParsePathXmlConfig::processPrivatePathsetNode(xercesc::DOMElement*
 
         xercesc::DOMElement* bulk = GetSingleElementByName(pvtConfNode, "bulk_generation_output_file", true);
         cfg.bulkFile = ParseString(GetNamedAttributeValue(bulk, "name"), "");
+        cfg.bulkFormat = ParseString(GetNamedAttributeValue(bulk, "format", false), "csv");
+        if (cfg.bulkFormat != "csv" && cfg.bulkFormat != "binary")
+        {
+            stringstream msg;
+            msg << "Invalid value for <bulk_generation_output_file format=\""
+                << cfg.bulkFormat << "\">. Expected: \"csv\" or \"binary\"";
+            throw runtime_error(msg.str());
+        }
+        cfg.bulkCheckpointInterval = ParseUnsignedInt(GetNamedAttributeValue(bulk, "checkpoint_interval", false), 60);
+        cfg.bulkTable = ParseString(GetNamedAttributeValue(bulk, "table", false), "");
+        if (!cfg.bulkTable.empty() && cfg.bulkFormat != "binary")
+        {
+            stringstream msg;
+            msg << "Invalid value for <bulk_generation_output_file table=\""
+                << cfg.bulkTable << "\">. Expected: format=\"binary\" when loading the output into a table";
+            throw runtime_error(msg.str());
+        }
     }
 
     xercesc::DOMElement* tableNode = GetSingleElementByName(pvtConfNode, "tables", true);
@@ -218,8 +235,32 @@ void sim_mob::ParsePathXmlConfig::processPrivatePathsetNode(xercesc::DOMElement*
             std::vector<std::string> rangeStrVec;
             std::string rangerStr = ParseString(GetNamedAttributeValue(random, "uniform_range"), "0,0");
             boost::split(rangeStrVec, rangerStr, boost::is_any_of(","));
-            cfg.perturbationRange.first = boost::lexical_cast<int>(rangeStrVec[0]);
-            cfg.perturbationRange.second = boost::lexical_cast<int>(rangeStrVec[1]);
+            try
+            {
+                if (rangeStrVec.size() != 2)
+                {
+                    throw boost::bad_lexical_cast();
+                }
+                cfg.perturbationRange.first = boost::lexical_cast<int>(boost::trim_copy(rangeStrVec[0]));
+                cfg.perturbationRange.second = boost::lexical_cast<int>(boost::trim_copy(rangeStrVec[1]));
+            }
+            catch (const boost::bad_lexical_cast&)
+            {
+                stringstream msg;
+                msg << "Invalid value for <random_perturbation uniform_range=\"" << rangerStr
+                    << "\">. Expected: \"min,max\"";
+                throw runtime_error(msg.str());
+            }
+
+            //the factors multiply the link travel times, so that they must be positive when perturbing
+            const int minFactor = (cfg.perturbationIteration > 0 ? 1 : 0);
+            if (cfg.perturbationRange.first < minFactor || cfg.perturbationRange.second < cfg.perturbationRange.first)
+            {
+                stringstream msg;
+                msg << "Invalid value for <random_perturbation uniform_range=\"" << rangerStr
+                    << "\">. Expected: " << minFactor << " <= min <= max";
+                throw runtime_error(msg.str());
+            }
         }
 
         //K-shortest Path
@@ -33,7 +33,7 @@ const short MAX_TRANSFERS = 4;
 sim_mob::SinglePath::SinglePath() :
         purpose(work), utility(0.0), pathSize(0.0), travelCost(0.0), partialUtility(0.0), signalNumber(0.0), rightTurnNumber(0.0), length(0.0), travelTime(0.0), highWayDistance(
                 0.0), validPath(true), minTravelTime(0), minDistance(0), minSignals(0), minRightTurns(0), maxHighWayUsage(0), shortestPath(0),
-                path(std::vector<sim_mob::WayPoint>()), isNeedSave2DB(false)
+                isNeedSave2DB(false)
 {
 }
 
@@ -42,7 +42,7 @@ sim_mob::SinglePath::SinglePath(const SinglePath& source) :
                 source.signalNumber), rightTurnNumber(source.rightTurnNumber), length(source.length), travelTime(source.travelTime), pathSetId(
                 source.pathSetId), highWayDistance(source.highWayDistance), minTravelTime(source.minTravelTime), minDistance(source.minDistance), minSignals(
                 source.minSignals), minRightTurns(source.minRightTurns), maxHighWayUsage(source.maxHighWayUsage), shortestPath(source.shortestPath), partialUtility(
-                source.partialUtility), scenario(source.scenario)
+                source.partialUtility), scenario(source.scenario), links(source.links)
 {
     isNeedSave2DB = false;
 
@@ -60,14 +60,15 @@ bool sim_mob::SinglePath::includesLinks(const std::set<const sim_mob::Link*>& ln
     {
         return false;
     } //trivial case
-    BOOST_FOREACH(const sim_mob::WayPoint& wp, this->path)
+    if (!links)
     {
-        BOOST_FOREACH(const sim_mob::Link* lnk, lnks)
+        return false;
+    }
+    for (const sim_mob::Link* lnk : *links)
+    {
+        if (lnks.find(lnk) != lnks.end())
         {
-            if (wp.link == lnk)
-            {
-                return true;
-            }
+            return true;
         }
     }
     return false;
@@ -75,18 +76,11 @@ bool sim_mob::SinglePath::includesLinks(const std::set<const sim_mob::Link*>& ln
 
 bool sim_mob::SinglePath::includesLink(const sim_mob::Link* lnk) const
 {
-    if (!lnk)
+    if (!lnk || !links)
     {
         return false;
     }
-    for(const auto& wp : this->path)
-    {
-        if (wp.link == lnk)
-        {
-            return true;
-        }
-    }
-    return false;
+    return links->contains(lnk);
 }
 
 ///given a path of alternative nodes and Links, keep Links, loose the nodes
@@ -104,13 +98,20 @@ void sim_mob::SinglePath::filterOutNodes(std::vector<sim_mob::WayPoint>& input,
     std::copy(FilterIterator(input.begin(), input.end()), FilterIterator(input.end(), input.end()), std::back_inserter(output));
 }
 
+void sim_mob::SinglePath::setPath(const std::vector<sim_mob::WayPoint>& wp)
+{
+    links = PathPool::getInstance().intern(wp);
+}
+
 void sim_mob::SinglePath::init(std::vector<sim_mob::WayPoint>& wpPath)
 {
     //step-1 fill in the path
-    filterOutNodes(wpPath, this->path);
+    std::vector<sim_mob::WayPoint> linkPath;
+    filterOutNodes(wpPath, linkPath);
+    links = PathPool::getInstance().intern(linkPath);
 
     //sanity check
-    if (this->path.empty())
+    if (linkPath.empty())
     {
         std::stringstream err("");
         err << "empty path [OD:" << this->pathSetId << "][PATH:" << this->id << "][Graph Output type chain:\n";
@@ -129,14 +130,14 @@ void sim_mob::SinglePath::init(std::vector<sim_mob::WayPoint>& wpPath)
     //highway distance
     highWayDistance = sim_mob::calculateHighWayDistance(this);
     //length
-    length = sim_mob::generatePathLength(path);
+    length = sim_mob::generatePathLength(linkPath);
     //default travel time
-    travelTime = sim_mob::calculateSinglePathDefaultTT(path);
+    travelTime = sim_mob::calculateSinglePathDefaultTT(linkPath);
 }
 
 void sim_mob::SinglePath::clear()
 {
-    path.clear();
+    links.reset();
 //  shortestSegPath.clear();
     id = "";
     pathSetId = "";
@@ -155,6 +156,21 @@ void sim_mob::SinglePath::clear()
     maxHighWayUsage = 0;
 }
 
+sim_mob::PathSet::PathSet(const PathSet &source) :
+        oriPath(nullptr), isNeedSave2DB(false), logsum(source.logsum), subTrip(source.subTrip), id(source.id),
+        scenario(source.scenario), hasPath(source.hasPath), nonCDB_OD(source.nonCDB_OD)
+{
+    for (const sim_mob::SinglePath* sp : source.pathChoices)
+    {
+        sim_mob::SinglePath* copy = new sim_mob::SinglePath(*sp);
+        pathChoices.insert(pathChoices.end(), copy);
+        if (sp == source.oriPath)
+        {
+            oriPath = copy;
+        }
+    }
+}
+
 sim_mob::PathSet::~PathSet()
 {
     //logger << "[DELET PATHSET " << id << "] [" << pathChoices.size() << "  SINGLEPATH]" << std::endl;
@@ -166,11 +182,11 @@ sim_mob::PathSet::~PathSet()
 
 short sim_mob::PathSet::addOrDeleteSinglePath(sim_mob::SinglePath* s)
 {
-    if(s->id.empty()) { return 0; }
-    if (!s || s->path.empty()) { return 0; }
-    if (s->path.begin()->link->getFromNodeId() != subTrip.origin.node->getNodeId())
+    //paths traversing a link twice are not kept
+    if (!s || !s->hasLinks() || s->links->hasLoop()) { return 0; }
+    if (s->links->front()->getFromNodeId() != subTrip.origin.node->getNodeId())
     {
-        std::cerr << s->scenario << " path begins with " << s->path.begin()->link->getFromNodeId() << " while pathset begins with " << subTrip.origin.node->getNodeId() << std::endl;
+        std::cerr << s->scenario << " path begins with " << s->links->front()->getFromNodeId() << " while pathset begins with " << subTrip.origin.node->getNodeId() << std::endl;
         throw std::runtime_error("Mismatch");
     }
 
@@ -191,14 +207,13 @@ short sim_mob::PathSet::addOrDeleteSinglePath(sim_mob::SinglePath* s)
 
 double sim_mob::calculateHighWayDistance(sim_mob::SinglePath *sp)
 {
-    if (!sp)
+    if (!sp || !sp->links)
     {
         return 0.0;
     }
     double res = 0.0;
-    for (int i = 0; i < sp->path.size(); ++i)
+    for (const sim_mob::Link* lnk : *sp->links)
     {
-        const sim_mob::Link* lnk = sp->path[i].link;
         if (lnk->getLinkType() == LinkType::LINK_TYPE_EXPRESSWAY)
         {
             res += lnk->getLength();
@@ -209,7 +224,7 @@ double sim_mob::calculateHighWayDistance(sim_mob::SinglePath *sp)
 
 void sim_mob::countRightTurnsAndSignals(sim_mob::SinglePath *sp)
 {
-    if (sp->path.size() < 2) //trivial case
+    if (!sp->links || sp->links->size() < 2) //trivial case
     {
         sp->rightTurnNumber = 0;
         sp->signalNumber = 0;
@@ -218,15 +233,15 @@ void sim_mob::countRightTurnsAndSignals(sim_mob::SinglePath *sp)
 
     int rightTurnNumber = 0;
     int signalNumber = 0;
-    std::vector<sim_mob::WayPoint>::iterator pathIt = sp->path.begin();
+    sim_mob::CompactPath::const_iterator pathIt = sp->links->begin();
     ++pathIt;
-    for (std::vector<sim_mob::WayPoint>::iterator it = sp->path.begin(); it != sp->path.end(); ++it)
+    for (sim_mob::CompactPath::const_iterator it = sp->links->begin(); it != sp->links->end(); ++it)
     {
-        const Link* currentLink = it->link;
+        const Link* currentLink = *it;
         const Link* targetLink = nullptr;
-        if (pathIt != sp->path.end())
+        if (pathIt != sp->links->end())
         {
-            targetLink = pathIt->link;
+            targetLink = *pathIt;
         }
         else
         {
@@ -303,29 +318,6 @@ double sim_mob::calculateSinglePathDefaultTT(const std::vector<sim_mob::WayPoint
     return res; //secs
 }
 
-std::string sim_mob::makePathString(const std::vector<sim_mob::WayPoint>& wp)
-{
-    std::stringstream str("");
-    std::set<unsigned int> pathLinks;
-    for (std::vector<sim_mob::WayPoint>::const_iterator it = wp.begin(); it != wp.end(); it++)
-    {
-        if (it->type == WayPoint::LINK)
-        {
-            unsigned int linkId = it->link->getLinkId();
-            if(pathLinks.insert(linkId).second)
-            {
-                str << linkId << ",";
-            }
-            else
-            {
-                //there is a link which is traversed twice in the path => loop in path
-                return std::string(); //return empty path
-            }
-        }
-    }
-    return str.str();
-}
-
 std::string sim_mob::makePT_PathString(const std::vector<PT_NetworkEdge> &path)
 {
     std::stringstream str("");
@@ -8,6 +8,7 @@
 #include "entities/misc/TripChain.hpp"
 #include "entities/params/PT_NetworkEntities.hpp"
 #include "geospatial/streetdir/StreetDirectory.hpp"
+#include "PathPool.hpp"
 
 namespace sim_mob
 {
@@ -55,24 +56,18 @@ double generatePathLength(const std::vector<sim_mob::WayPoint>& wp);
  */
 double calculateSinglePathDefaultTT(const std::vector<sim_mob::WayPoint>& wp);
 
-/**
- * Constructs a string of comma separated link-ids from a waypoint path
- * @param wp input waypoint path
- * @return csv of link-ids od links in wp
- */
-std::string makePathString(const std::vector<WayPoint>& wp);
 std::string makePT_PathString(const std::vector<PT_NetworkEdge> &path);
 std::string makePT_PathSetString(const std::vector<PT_NetworkEdge> &path);
 
 class SinglePath
 {
 public:
-    /// path representation
-    std::vector<sim_mob::WayPoint> path;
+    /// path representation, shared with the other paths having the same links
+    PathPool::PathPtr links;
 
     bool isNeedSave2DB;
     std::string scenario;
-    std::string id;   //id: seg1id_seg2id_seg3id
+    std::string id;   //id: link1id,link2id,link3id, (only set for the paths loaded from the database; see getId())
     std::string pathSetId;
 
     double travelCost;
@@ -107,9 +102,33 @@ public:
     void init(std::vector<WayPoint>& wpPools);
     void clear();
 
+    /**
+     * sets the links of the path, without computing its attributes
+     * @param wp the path; only its link way points are kept
+     */
+    void setPath(const std::vector<WayPoint>& wp);
+
+    /**
+     * @return true if the path has at least one link
+     */
+    bool hasLinks() const
+    {
+        return links && !links->empty();
+    }
+
+    /**
+     * @return the comma separated link ids of the path, as written to the pathset tables; built from the links
+     * unless the path was loaded with its id
+     */
+    std::string getId() const
+    {
+        return (id.empty() && links ? links->toString() : id);
+    }
+
+    ///orders the paths of a pathset by their ids, comparing the link sequences without building the ids
      bool operator() (const SinglePath* lhs, const SinglePath* rhs) const
      {
-         return lhs->id < rhs->id;
+         return CompactPath::lessByIds(lhs->links.get(), rhs->links.get());
      }
 
     ///does these SinglePath include the any of given RoadSegment(s)
@@ -187,11 +206,11 @@ public:
 class PathSet
 {
 public:
-    PathSet():  logsum(0.0),hasPath(false),bestPath(nullptr),oriPath(nullptr),isNeedSave2DB(false),id(""),nonCDB_OD(false) {pathChoices.clear();}
+    PathSet():  logsum(0.0),hasPath(false),oriPath(nullptr),isNeedSave2DB(false),id(""),nonCDB_OD(false) {pathChoices.clear();}
     ~PathSet();
 
     short addOrDeleteSinglePath(sim_mob::SinglePath* s);
-    std::vector<WayPoint>* bestPath;  //best choice
+    PathPool::PathPtr bestPath;  //best choice; expanded into way points by the caller adopting it
     SinglePath* oriPath;  // shortest path with all segments
     std::set<sim_mob::SinglePath*, sim_mob::SinglePath> pathChoices;
     boost::shared_mutex pathChoicesMutex;
@@ -203,7 +222,12 @@ public:
     std::string scenario;
     bool hasPath;
     bool nonCDB_OD;
-    PathSet(boost::shared_ptr<sim_mob::PathSet> &ps);
+
+    /**
+     * copies a pathset and each of its paths; the best path is not copied
+     * @param source the pathset to copy
+     */
+    explicit PathSet(const PathSet &source);
 };
 
 //Public Transit path
@@ -0,0 +1,268 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PathPool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include "geospatial/network/Link.hpp"
+#include "geospatial/network/RoadNetwork.hpp"
+#include "util/VarInt.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+const boost::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const boost::uint64_t FNV_PRIME = 1099511628211ULL;
+}
+
+const Link* CompactPath::const_iterator::operator*() const
+{
+    return pool->getLink(index);
+}
+
+void CompactPath::const_iterator::decode()
+{
+    index = static_cast<boost::uint32_t>(index + varint::readSigned(next));
+}
+
+CompactPath::CompactPath(const PathPool& pool, std::vector<boost::uint8_t>& bytes, std::size_t numLinks,
+        boost::uint32_t lastIndex, bool loop, boost::uint64_t hash) :
+        pool(pool), numLinks(numLinks), lastIndex(lastIndex), loop(loop), hash(hash)
+{
+    this->bytes.swap(bytes);
+}
+
+const Link* CompactPath::front() const
+{
+    return *begin();
+}
+
+const Link* CompactPath::back() const
+{
+    return pool.getLink(lastIndex);
+}
+
+bool CompactPath::contains(const Link* lnk) const
+{
+    boost::uint32_t target = 0;
+    if (!lnk || !pool.findIndex(lnk, target))
+    {
+        return false;
+    }
+    const boost::uint8_t* next = bytes.empty() ? nullptr : &bytes[0];
+    boost::uint32_t index = 0;
+    for (std::size_t i = 0; i < numLinks; ++i)
+    {
+        index = static_cast<boost::uint32_t>(index + varint::readSigned(next));
+        if (index == target)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CompactPath::toWayPoints(std::vector<WayPoint>& wayPoints) const
+{
+    wayPoints.clear();
+    wayPoints.reserve(numLinks);
+    for (const_iterator it = begin(); it != end(); ++it)
+    {
+        wayPoints.push_back(WayPoint(*it));
+    }
+}
+
+std::string CompactPath::toString() const
+{
+    std::stringstream str("");
+    for (const_iterator it = begin(); it != end(); ++it)
+    {
+        str << (*it)->getLinkId() << ",";
+    }
+    return str.str();
+}
+
+bool CompactPath::lessByIds(const CompactPath* lhs, const CompactPath* rhs)
+{
+    if (lhs == rhs || !rhs || rhs->empty())
+    {
+        return false;
+    }
+    if (!lhs)
+    {
+        return true;
+    }
+
+    const_iterator lhsIt = lhs->begin();
+    const_iterator rhsIt = rhs->begin();
+    for (; lhsIt != lhs->end() && rhsIt != rhs->end(); ++lhsIt, ++rhsIt)
+    {
+        unsigned int lhsId = (*lhsIt)->getLinkId();
+        unsigned int rhsId = (*rhsIt)->getLinkId();
+        if (lhsId != rhsId)
+        {
+            //',' sorts before the digits, so the first differing id decides, and an id sorts before its extensions
+            char lhsDigits[16];
+            char rhsDigits[16];
+            int lhsLength = std::sprintf(lhsDigits, "%u,", lhsId);
+            int rhsLength = std::sprintf(rhsDigits, "%u,", rhsId);
+            return std::lexicographical_compare(lhsDigits, lhsDigits + lhsLength, rhsDigits, rhsDigits + rhsLength);
+        }
+    }
+
+    //one path is a prefix of the other
+    return (lhsIt == lhs->end() && rhsIt != rhs->end());
+}
+
+PathPool::PathPool(const std::map<unsigned int, Link*>& linksMap)
+{
+    links.reserve(linksMap.size());
+    for (std::map<unsigned int, Link*>::const_iterator it = linksMap.begin(); it != linksMap.end(); ++it)
+    {
+        indices[it->second] = static_cast<boost::uint32_t>(links.size());
+        links.push_back(it->second);
+    }
+}
+
+PathPool& PathPool::getInstance()
+{
+    //Never destroyed, so that the paths still referenced when the program exits can be released
+    static PathPool* instance = new PathPool(RoadNetwork::getInstance()->getMapOfIdVsLinks());
+    return *instance;
+}
+
+bool PathPool::findIndex(const Link* lnk, boost::uint32_t& index) const
+{
+    boost::unordered_map<const Link*, boost::uint32_t>::const_iterator it = indices.find(lnk);
+    if (it == indices.end())
+    {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+PathPool::PathPtr PathPool::intern(const std::vector<WayPoint>& wayPoints)
+{
+    std::vector<boost::uint32_t> pathIndices;
+    pathIndices.reserve(wayPoints.size());
+    for (std::vector<WayPoint>::const_iterator it = wayPoints.begin(); it != wayPoints.end(); ++it)
+    {
+        if (it->type == WayPoint::LINK)
+        {
+            boost::uint32_t index = 0;
+            if (!findIndex(it->link, index))
+            {
+                std::stringstream msg;
+                msg << "PathPool: link " << it->link->getLinkId() << " is not part of the network";
+                throw std::runtime_error(msg.str());
+            }
+            pathIndices.push_back(index);
+        }
+    }
+    return internIndices(pathIndices);
+}
+
+PathPool::PathPtr PathPool::intern(const std::vector<const Link*>& pathLinks)
+{
+    std::vector<boost::uint32_t> pathIndices;
+    pathIndices.reserve(pathLinks.size());
+    for (std::vector<const Link*>::const_iterator it = pathLinks.begin(); it != pathLinks.end(); ++it)
+    {
+        boost::uint32_t index = 0;
+        if (!findIndex(*it, index))
+        {
+            std::stringstream msg;
+            msg << "PathPool: link " << (*it)->getLinkId() << " is not part of the network";
+            throw std::runtime_error(msg.str());
+        }
+        pathIndices.push_back(index);
+    }
+    return internIndices(pathIndices);
+}
+
+PathPool::PathPtr PathPool::internIndices(const std::vector<boost::uint32_t>& pathIndices)
+{
+    if (pathIndices.empty())
+    {
+        return PathPtr();
+    }
+
+    std::vector<boost::uint8_t> bytes;
+    bytes.reserve(pathIndices.size() * 2);
+    boost::int64_t previous = 0;
+    for (std::vector<boost::uint32_t>::const_iterator it = pathIndices.begin(); it != pathIndices.end(); ++it)
+    {
+        varint::writeSigned(static_cast<boost::int64_t>(*it) - previous, bytes);
+        previous = *it;
+    }
+
+    boost::uint64_t hash = FNV_OFFSET_BASIS;
+    for (std::vector<boost::uint8_t>::const_iterator it = bytes.begin(); it != bytes.end(); ++it)
+    {
+        hash = (hash ^ *it) * FNV_PRIME;
+    }
+
+    std::vector<boost::uint32_t> sorted(pathIndices);
+    std::sort(sorted.begin(), sorted.end());
+    bool loop = (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end());
+
+    //Declared before the lock, so that the references are dropped (possibly releasing a path) after unlocking
+    PathPtr res;
+    std::vector<PathPtr> others;
+    Shard& shard = getShard(hash);
+    boost::unique_lock<boost::mutex> lock(shard.mutex);
+    typedef boost::unordered_multimap<boost::uint64_t, Entry>::iterator EntryIt;
+    std::pair<EntryIt, EntryIt> range = shard.paths.equal_range(hash);
+    for (EntryIt it = range.first; it != range.second; ++it)
+    {
+        PathPtr path = it->second.second.lock();
+        if (path && path->bytes == bytes)
+        {
+            res = path;
+            return res;
+        }
+        others.push_back(path);
+    }
+
+    const CompactPath* path = new CompactPath(*this, bytes, pathIndices.size(), pathIndices.back(), loop, hash);
+    res = PathPtr(path, boost::bind(&PathPool::release, this, _1));
+    shard.paths.insert(std::make_pair(hash, Entry(path, res)));
+    return res;
+}
+
+void PathPool::release(const CompactPath* path)
+{
+    {
+        Shard& shard = getShard(path->getHash());
+        boost::unique_lock<boost::mutex> lock(shard.mutex);
+        typedef boost::unordered_multimap<boost::uint64_t, Entry>::iterator EntryIt;
+        std::pair<EntryIt, EntryIt> range = shard.paths.equal_range(path->getHash());
+        for (EntryIt it = range.first; it != range.second; ++it)
+        {
+            if (it->second.first == path)
+            {
+                shard.paths.erase(it);
+                break;
+            }
+        }
+    }
+    delete path;
+}
+
+std::size_t PathPool::size() const
+{
+    std::size_t res = 0;
+    for (std::size_t i = 0; i < NUM_SHARDS; ++i)
+    {
+        boost::unique_lock<boost::mutex> lock(shards[i].mutex);
+        res += shards[i].paths.size();
+    }
+    return res;
+}
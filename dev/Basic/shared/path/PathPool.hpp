@@ -0,0 +1,288 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/utility.hpp>
+#include <boost/weak_ptr.hpp>
+#include "geospatial/network/WayPoint.hpp"
+
+namespace sim_mob
+{
+
+class Link;
+class PathPool;
+
+/**
+ * Immutable link sequence of a path.
+ *
+ * The links are stored by their index in the PathPool which created the path: the first index, followed by the
+ * difference between each index and the previous one, each zigzag-encoded as a variable length integer of 7 bits per
+ * byte. Paths are only created by PathPool::intern, which shares one CompactPath between all paths having the same
+ * links.
+ */
+class CompactPath : private boost::noncopyable
+{
+public:
+    /** forward iterator over the links of a path, decoding them on the fly */
+    class const_iterator : public std::iterator<std::forward_iterator_tag, const Link*>
+    {
+    public:
+        const_iterator() : next(nullptr), remaining(0), index(0), pool(nullptr)
+        {
+        }
+
+        const Link* operator*() const;
+
+        const_iterator& operator++()
+        {
+            if (--remaining > 0)
+            {
+                decode();
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator res(*this);
+            ++(*this);
+            return res;
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return remaining == rhs.remaining;
+        }
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return remaining != rhs.remaining;
+        }
+
+    private:
+        friend class CompactPath;
+
+        const_iterator(const boost::uint8_t* next, std::size_t remaining, const PathPool* pool) :
+                next(next), remaining(remaining), index(0), pool(pool)
+        {
+            if (remaining > 0)
+            {
+                decode();
+            }
+        }
+
+        /** reads the next difference and applies it to the current index */
+        void decode();
+
+        const boost::uint8_t* next;
+        std::size_t remaining;
+        boost::uint32_t index;
+        const PathPool* pool;
+    };
+
+    const_iterator begin() const
+    {
+        return const_iterator(bytes.empty() ? nullptr : &bytes[0], numLinks, &pool);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    /**
+     * @return the number of links of the path
+     */
+    std::size_t size() const
+    {
+        return numLinks;
+    }
+
+    bool empty() const
+    {
+        return numLinks == 0;
+    }
+
+    /**
+     * @return the first link of the path
+     */
+    const Link* front() const;
+
+    /**
+     * @return the last link of the path
+     */
+    const Link* back() const;
+
+    /**
+     * @return true if a link appears more than once in the path
+     */
+    bool hasLoop() const
+    {
+        return loop;
+    }
+
+    /**
+     * @return hash of the link sequence; identical sequences have identical hashes in every run
+     */
+    boost::uint64_t getHash() const
+    {
+        return hash;
+    }
+
+    /**
+     * @return the number of bytes of the encoded link sequence
+     */
+    std::size_t getEncodedSize() const
+    {
+        return bytes.size();
+    }
+
+    /**
+     * checks whether the path goes through a link
+     * @param lnk the link
+     * @return true if lnk is one of the links of the path
+     */
+    bool contains(const Link* lnk) const;
+
+    /**
+     * expands the path into link WayPoints
+     * @param wayPoints output way points; replaced by the links of the path
+     */
+    void toWayPoints(std::vector<WayPoint>& wayPoints) const;
+
+    /**
+     * @return the comma separated link ids of the path, as stored in the pathset tables
+     */
+    std::string toString() const;
+
+    /**
+     * orders paths as their toString() strings compare, without building the strings. Null paths compare as empty
+     * strings.
+     */
+    static bool lessByIds(const CompactPath* lhs, const CompactPath* rhs);
+
+private:
+    friend class PathPool;
+
+    CompactPath(const PathPool& pool, std::vector<boost::uint8_t>& bytes, std::size_t numLinks, boost::uint32_t lastIndex,
+            bool loop, boost::uint64_t hash);
+
+    /** the pool which interned the path, and which translates the indices into links */
+    const PathPool& pool;
+
+    /** the encoded link indices */
+    std::vector<boost::uint8_t> bytes;
+
+    boost::uint32_t numLinks;
+
+    /** index of the last link, kept for back() */
+    boost::uint32_t lastIndex;
+
+    bool loop;
+
+    boost::uint64_t hash;
+};
+
+/**
+ * Interns the link sequences of paths as CompactPath objects, so that all paths having the same links share one
+ * encoding. Links are indexed by their position among the links of the network sorted by id.
+ *
+ * Interned paths are removed from the pool when the last reference to them is dropped.
+ */
+class PathPool : private boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<const CompactPath> PathPtr;
+
+    /**
+     * @param linksMap the links which can be part of the interned paths, by id
+     */
+    explicit PathPool(const std::map<unsigned int, Link*>& linksMap);
+
+    /**
+     * @return the pool of the links of the road network
+     */
+    static PathPool& getInstance();
+
+    /**
+     * interns the link way points of a path; way points of other types are ignored
+     * @param wayPoints the path
+     * @return the shared encoding of the links of the path; null if the path has no link
+     * @throws std::runtime_error if a link of the path is not known to the pool
+     */
+    PathPtr intern(const std::vector<WayPoint>& wayPoints);
+
+    /**
+     * interns a link sequence
+     * @param links the links of the path
+     * @return the shared encoding of the links; null if there is no link
+     * @throws std::runtime_error if a link is not known to the pool
+     */
+    PathPtr intern(const std::vector<const Link*>& links);
+
+    /**
+     * @return the number of distinct paths in the pool
+     */
+    std::size_t size() const;
+
+    /**
+     * @param index index of a link in the pool
+     * @return the link
+     */
+    const Link* getLink(boost::uint32_t index) const
+    {
+        return links[index];
+    }
+
+    /**
+     * @param lnk a link
+     * @param index output index of the link in the pool
+     * @return true if the link is known to the pool
+     */
+    bool findIndex(const Link* lnk, boost::uint32_t& index) const;
+
+private:
+    static const std::size_t NUM_SHARDS = 16;
+
+    /** an interned path; the raw pointer identifies the entry after the weak pointer expires */
+    typedef std::pair<const CompactPath*, boost::weak_ptr<const CompactPath> > Entry;
+
+    /** part of the interned paths, selected by hash */
+    struct Shard
+    {
+        mutable boost::mutex mutex;
+        boost::unordered_multimap<boost::uint64_t, Entry> paths;
+    };
+
+    /** interns a sequence of link indices */
+    PathPtr internIndices(const std::vector<boost::uint32_t>& indices);
+
+    /** deleter of the interned paths; removes them from their shard */
+    void release(const CompactPath* path);
+
+    Shard& getShard(boost::uint64_t hash)
+    {
+        return shards[hash % NUM_SHARDS];
+    }
+
+    /** the links, by index */
+    std::vector<const Link*> links;
+
+    /** the indices, by link */
+    boost::unordered_map<const Link*, boost::uint32_t> indices;
+
+    Shard shards[NUM_SHARDS];
+};
+
+}
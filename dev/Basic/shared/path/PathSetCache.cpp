@@ -0,0 +1,52 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "PathSetCache.hpp"
+
+#include <algorithm>
+#include "conf/ConfigManager.hpp"
+#include "conf/ConfigParams.hpp"
+#include "util/DailyTime.hpp"
+
+using namespace sim_mob;
+
+namespace
+{
+/** maximum number of cached pathsets, over all the kinds and threads */
+const std::size_t CACHE_CAPACITY = 20000;
+}
+
+PathSetCache::PathSetCache() :
+        cache(CACHE_CAPACITY),
+        intervalMS(std::max(ConfigManager::GetInstance().FullConfig().getPathSetConf().interval, 0) * 1000)
+{
+}
+
+PathSetCache& PathSetCache::getInstance()
+{
+    static PathSetCache instance;
+    return instance;
+}
+
+PathSetCache::Cache::KeyType PathSetCache::makeKey(unsigned int origin, unsigned int destination,
+                                                   const DailyTime &departure, unsigned int kind) const
+{
+    unsigned int interval = (intervalMS > 0 ? departure.getValue() / intervalMS : 0);
+    return Cache::makeKey(origin, destination, interval, kind);
+}
+
+bool PathSetCache::find(const Cache::KeyType &key, Cache::ValueType &value) const
+{
+    return cache.find(key, value);
+}
+
+void PathSetCache::insert(const Cache::KeyType &key, const Cache::ValueType &value)
+{
+    cache.insert(key, value);
+}
+
+PathSetCache::Cache::Statistics PathSetCache::getStatistics() const
+{
+    return cache.getStatistics();
+}
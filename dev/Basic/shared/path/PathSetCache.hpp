@@ -0,0 +1,97 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "Path.hpp"
+#include "util/ShardedCache.hpp"
+
+namespace sim_mob
+{
+
+class DailyTime;
+
+/**
+ * A pathset loaded from the database, as cached by PathSetCache. Never modified once cached.
+ */
+struct CachedPathSet
+{
+    /** the private traffic paths; null if the database has no path for the OD */
+    boost::shared_ptr<const PathSet> privatePathSet;
+
+    /** the public transit paths, with their edges */
+    std::vector<PT_Path> publicTransitPaths;
+
+    /** the stored procedure the public transit paths were loaded by, which is chosen by the caller */
+    std::string procedure;
+};
+
+/**
+ * Cache of the pathsets loaded from the database, shared by the private traffic and public transit route choice of all
+ * the threads.
+ *
+ * Entries are keyed by origin and destination node, time interval of the departure (of the width of the pathset
+ * interval) and the kind of pathset, so that each pathset is loaded once per interval by the whole process instead of
+ * once per thread. Cached pathsets are shared between threads: callers copy them before computing their travel times
+ * and utilities.
+ */
+class PathSetCache
+{
+public:
+    typedef ShardedCache<const CachedPathSet> Cache;
+
+    /** kinds of cached pathsets; a public transit pathset is of kind PUBLIC_TRANSIT plus its network type */
+    enum Kind
+    {
+        PRIVATE = 0,
+        PRIVATE_WITHOUT_RESTRICTED_REGION = 1,
+        PRIVATE_STUDY_AREA = 2,
+        PUBLIC_TRANSIT = 3
+    };
+
+    /** @return the cache of the process */
+    static PathSetCache& getInstance();
+
+    /**
+     * makes the key of a pathset
+     * @param origin id of the origin node
+     * @param destination id of the destination node
+     * @param departure departure time
+     * @param kind kind of the pathset
+     * @return the key
+     */
+    Cache::KeyType makeKey(unsigned int origin, unsigned int destination, const DailyTime &departure,
+                           unsigned int kind) const;
+
+    /**
+     * looks a pathset up
+     * @param key key of the pathset
+     * @param value output pathset, if found
+     * @return true if the pathset was found
+     */
+    bool find(const Cache::KeyType &key, Cache::ValueType &value) const;
+
+    /**
+     * records a pathset
+     * @param key key of the pathset
+     * @param value the pathset
+     */
+    void insert(const Cache::KeyType &key, const Cache::ValueType &value);
+
+    /** @return the access statistics of the cache */
+    Cache::Statistics getStatistics() const;
+
+private:
+    PathSetCache();
+
+    Cache cache;
+
+    /** width of the time intervals, in milliseconds; 0 if the pathset interval is not configured */
+    const unsigned int intervalMS;
+};
+
+}
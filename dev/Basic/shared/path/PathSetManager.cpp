@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cmath>
 #include <boost/algorithm/string.hpp>
+#include <boost/chrono.hpp>
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
@@ -19,6 +20,7 @@
 
 #include "conf/ConfigManager.hpp"
 #include "conf/ConfigParams.hpp"
+#include "database/PG_CopySink.hpp"
 #include "entities/PersonLoader.hpp"
 #include "entities/roles/RoleFacets.hpp"
 #include "geospatial/aimsun/Loader.hpp"
@@ -33,6 +35,7 @@
 #include "geospatial/streetdir/KShortestPathImpl.hpp"
 #include "message/MessageBus.hpp"
 #include "Path.hpp"
+#include "path/BulkPathSetWriter.hpp"
 #include "path/PathSetThreadPool.hpp"
 #include "SOCI_Converters.hpp"
 #include "util/threadpool/Threadpool.hpp"
@@ -128,7 +131,7 @@ sim_mob::SinglePath* findShortestPathContainingLink(const std::set<sim_mob::Sing
     double tmp = 0.0;
     for (sim_mob::SinglePath* sp : pathChoices)
     {
-        if (sp->path.empty())
+        if (!sp->hasLinks())
         {
             throw std::runtime_error("path is Empty");
         }
@@ -171,14 +174,13 @@ void generatePathSize(boost::shared_ptr<sim_mob::PathSet>&ps)
         uniquePath = true; //this variable checks if a path has No common segments with the rest of the pathset
         double size = 0.0;
 
-        if (sp->path.empty())
+        if (!sp->hasLinks())
         {
             throw std::runtime_error("unexpected empty path in singlepath object");
         }
         // For each link a in the path:
-        for (std::vector<WayPoint>::iterator pathIt = sp->path.begin(); pathIt != sp->path.end(); ++pathIt)
+        for (const sim_mob::Link* lnk : *sp->links)
         {
-            const sim_mob::Link* lnk = pathIt->link;
             sim_mob::SinglePath* minSp = findShortestPathContainingLink(ps->pathChoices, lnk);
             if (!minSp)
             {
@@ -195,7 +197,7 @@ void generatePathSize(boost::shared_ptr<sim_mob::PathSet>&ps)
                 if (spj->includesLink(lnk))
                 {
                     sum += minL / (spj->length);
-                    if (sp->id != spj->id)
+                    if (sp != spj)
                     {
                         uniquePath = false;
                     }
@@ -275,18 +277,19 @@ double getPathTravelCost(sim_mob::SinglePath *sp, const sim_mob::DailyTime & sta
 {
     sim_mob::DailyTime tripStartTime(startTime_);
     double res = 0.0;
-    for (std::vector<WayPoint>::iterator pathIt = sp->path.begin(); pathIt != sp->path.end(); pathIt++)
+    for (sim_mob::CompactPath::const_iterator pathIt = sp->links->begin(); pathIt != sp->links->end(); pathIt++)
     {
-        unsigned long lnkId = (pathIt)->link->getLinkId();
+        unsigned long lnkId = (*pathIt)->getLinkId();
         const Link* nextLink = nullptr;
-        std::vector<WayPoint>::iterator itNextLink = pathIt + 1;
-        if (itNextLink != sp->path.end())
+        sim_mob::CompactPath::const_iterator itNextLink = pathIt;
+        ++itNextLink;
+        if (itNextLink != sp->links->end())
         {
-            nextLink = itNextLink->link;
+            nextLink = *itNextLink;
         }
 
         //get travel time for this link
-        double lnkTT = sim_mob::TravelTimeManager::getInstance()->getLinkTT((pathIt)->link, tripStartTime, nextLink, useInSimulationTT);
+        double lnkTT = sim_mob::TravelTimeManager::getInstance()->getLinkTT(*pathIt, tripStartTime, nextLink, useInSimulationTT);
         tripStartTime = tripStartTime + sim_mob::DailyTime(lnkTT * 1000);
 
         std::map<int, sim_mob::ERP_Section*>::iterator erpSectionIt = sim_mob::PathSetParam::getInstance()->ERP_SectionPool.find(lnkId);
@@ -366,15 +369,29 @@ void sim_mob::PathSetManager::clearPathSet(boost::shared_ptr<sim_mob::PathSet>&
     ps->pathChoices.clear();
 }
 
-void sim_mob::PrivateTrafficRouteChoice::cachePathSet(boost::shared_ptr<sim_mob::PathSet>& ps)
+void sim_mob::PrivateTrafficRouteChoice::cachePathSet(unsigned int origin, unsigned int destination,
+        const sim_mob::DailyTime &departure, PathSetCache::Kind kind, const boost::shared_ptr<sim_mob::PathSet> &ps)
 {
-    return;
-    cacheLRU.insert(ps->id, ps);
+    boost::shared_ptr<CachedPathSet> entry(new CachedPathSet());
+    if (ps)
+    {
+        entry->privatePathSet.reset(new sim_mob::PathSet(*ps));
+    }
+    PathSetCache &cache = PathSetCache::getInstance();
+    cache.insert(cache.makeKey(origin, destination, departure, kind), entry);
 }
 
-bool sim_mob::PrivateTrafficRouteChoice::findCachedPathSet(std::string key, boost::shared_ptr<sim_mob::PathSet> &value)
+bool sim_mob::PrivateTrafficRouteChoice::findCachedPathSet(unsigned int origin, unsigned int destination,
+        const sim_mob::DailyTime &departure, PathSetCache::Kind kind, boost::shared_ptr<const sim_mob::PathSet> &value) const
 {
-    return cacheLRU.find(key, value);
+    PathSetCache &cache = PathSetCache::getInstance();
+    PathSetCache::Cache::ValueType entry;
+    if (!cache.find(cache.makeKey(origin, destination, departure, kind), entry))
+    {
+        return false;
+    }
+    value = entry->privatePathSet;
+    return true;
 }
 
 void sim_mob::PrivatePathsetGenerator::setPathSetTags(boost::shared_ptr<sim_mob::PathSet>& ps) const
@@ -624,28 +641,34 @@ void sim_mob::PrivatePathsetGenerator::onGeneratePathSet(boost::shared_ptr<PathS
     //store in into the database
     if (!ps->nonCDB_OD)
     {
-        pathSetParam->storeSinglePath(ps->pathChoices);
+        if (bulkWriter)
+        {
+            bulkWriter->write(ps->subTrip.origin.node->getNodeId(), ps->subTrip.destination.node->getNodeId(), ps->pathChoices);
+        }
+        else
+        {
+            pathSetParam->storeSinglePath(ps->pathChoices);
+        }
     }
 }
 double sim_mob::PrivateTrafficRouteChoice::getOD_TravelTime(unsigned int origin, unsigned int destination, const sim_mob::DailyTime& curTime)
 {
     double shortestPathTravelTime = 0.0;
     if (origin == destination) { return 0.0; }
-    std::string fromToID = getFromToString(origin, destination);
-    if (noPathODs.find(fromToID)) { return 0.0; }
 
-    sim_mob::SinglePath* shortestPath = nullptr;
+    const sim_mob::SinglePath* shortestPath = nullptr;
+    boost::shared_ptr<const sim_mob::PathSet> cached;
     boost::shared_ptr<sim_mob::PathSet> pathset;
-    bool pathsetFound = findCachedPathSet(fromToID, pathset);
-    if(pathsetFound)
+    if (findCachedPathSet(origin, destination, curTime, PathSetCache::PRIVATE, cached))
     {
-        shortestPath = pathset->oriPath;
+        if (!cached) { return 0.0; }
+        shortestPath = cached->oriPath;
     }
     else
     {
         sim_mob::HasPath pathsetRetrievalStatus = PSM_UNKNOWN;
-        sim_mob::PathSet* tmpPathset = new sim_mob::PathSet();
-        pathset.reset(tmpPathset);
+        std::string fromToID = getFromToString(origin, destination);
+        pathset.reset(new sim_mob::PathSet());
         pathset->id = fromToID;
         pathsetRetrievalStatus = loadPathsetFromDB(*getSession(), fromToID, pathset->pathChoices, psRetrieval);
         if(pathsetRetrievalStatus == PSM_HASPATH)
@@ -654,14 +677,16 @@ double sim_mob::PrivateTrafficRouteChoice::getOD_TravelTime(unsigned int origin,
             {
                 if (sp->shortestPath)
                 {
-                    shortestPath = sp;
+                    pathset->oriPath = sp;
                     break;
                 }
             }
+            shortestPath = pathset->oriPath;
+            cachePathSet(origin, destination, curTime, PathSetCache::PRIVATE, pathset);
         }
         else
         {
-            noPathODs.insert(fromToID); //note pathset unavailability
+            cachePathSet(origin, destination, curTime, PathSetCache::PRIVATE, boost::shared_ptr<sim_mob::PathSet>()); //note pathset unavailability
         }
     }
 
@@ -683,21 +708,20 @@ double sim_mob::PrivateTrafficRouteChoice::getOD_TravelTime_StudyArea(unsigned i
     const RoadNetwork* rdnw = RoadNetwork::getInstance();
     double shortestPathTravelTime = 0.0;
     if (origin == destination) { return 0.0; }
-    std::string fromToID = getFromToString(origin, destination);
-    if (noPathODs.find(fromToID)) { return 0.0; }
 
-    sim_mob::SinglePath* shortestPath = nullptr;
+    const sim_mob::SinglePath* shortestPath = nullptr;
+    boost::shared_ptr<const sim_mob::PathSet> cached;
     boost::shared_ptr<sim_mob::PathSet> pathset;
-    bool pathsetFound = findCachedPathSet(fromToID, pathset);
-    if(pathsetFound)
+    if (findCachedPathSet(origin, destination, curTime, PathSetCache::PRIVATE_STUDY_AREA, cached))
     {
-        shortestPath = pathset->oriPath;
+        if (!cached) { return 0.0; }
+        shortestPath = cached->oriPath;
     }
     else
     {
         sim_mob::HasPath pathsetRetrievalStatus = PSM_UNKNOWN;
-        sim_mob::PathSet* tmpPathset = new sim_mob::PathSet();
-        pathset.reset(tmpPathset);
+        std::string fromToID = getFromToString(origin, destination);
+        pathset.reset(new sim_mob::PathSet());
         pathset->id = fromToID;
         if(rdnw->IsMovementInStudyArea(origin,destination))
         {
@@ -723,14 +747,16 @@ double sim_mob::PrivateTrafficRouteChoice::getOD_TravelTime_StudyArea(unsigned i
             {
                 if (sp->shortestPath)
                 {
-                    shortestPath = sp;
+                    pathset->oriPath = sp;
                     break;
                 }
             }
+            shortestPath = pathset->oriPath;
+            cachePathSet(origin, destination, curTime, PathSetCache::PRIVATE_STUDY_AREA, pathset);
         }
         else
         {
-            noPathODs.insert(fromToID); //note pathset unavailability
+            cachePathSet(origin, destination, curTime, PathSetCache::PRIVATE_STUDY_AREA, boost::shared_ptr<sim_mob::PathSet>()); //note pathset unavailability
         }
     }
 
@@ -751,19 +777,17 @@ double sim_mob::PrivateTrafficRouteChoice::getShortestPathTravelTime(const Node*
 {
     double shortestPathTravelTime = 0.0;
     if (origin->getNodeId() == destination->getNodeId()) { return 0.0; }
-    std::string fromToID = getFromToString(origin->getNodeId(), destination->getNodeId());
-    if (noPathODs.find(fromToID)) { return 0.0; }
 
-    sim_mob::SinglePath* shortestPath = nullptr;
-    boost::shared_ptr<sim_mob::PathSet> pathset;
-    bool pathsetFound = findCachedPathSet(fromToID, pathset);
-    if(pathsetFound)
+    const sim_mob::SinglePath* shortestPath = nullptr;
+    boost::shared_ptr<const sim_mob::PathSet> cached;
+    if (findCachedPathSet(origin->getNodeId(), destination->getNodeId(), curTime, PathSetCache::PRIVATE, cached))
     {
-        shortestPath = pathset->oriPath;
+        if (!cached) { return 0.0; }
+        shortestPath = cached->oriPath;
     }
     else
     {
-        std::vector<WayPoint> wayPointSequence = StreetDirectory::Instance().SearchShortestDrivingPath<Node,Node>(*origin,*destination);
+        std::vector<WayPoint> wayPointSequence = StreetDirectory::Instance().SearchInSimulationDrivingPath<Node,Node>(*origin,*destination);
         std::vector<WayPoint> wayPointSequenceCleaned;
         for (WayPoint wp:wayPointSequence)
         {
@@ -773,8 +797,9 @@ double sim_mob::PrivateTrafficRouteChoice::getShortestPathTravelTime(const Node*
 
         if ( !wayPointSequenceCleaned.empty() )
         {
-            shortestPath = new SinglePath();
-            shortestPath->path =wayPointSequenceCleaned;
+            SinglePath* path = new SinglePath();
+            path->setPath(wayPointSequenceCleaned);
+            shortestPath = path;
         }
     }
 
@@ -814,11 +839,17 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
     {
         return false;
     }
-    std::string fromToID = getFromToString(fromNode->getNodeId(), toNode->getNodeId());
-    if (noPathODs.find(fromToID))
+    const unsigned int origin = fromNode->getNodeId();
+    const unsigned int destination = toNode->getNodeId();
+    const PathSetCache::Kind kind = (nonCBD_OD ? PathSetCache::PRIVATE_WITHOUT_RESTRICTED_REGION : PathSetCache::PRIVATE);
+    boost::shared_ptr<const sim_mob::PathSet> cached;
+    bool pathsetCached = findCachedPathSet(origin, destination, st.startTime, kind, cached);
+    if (pathsetCached && !cached)
     {
         return false;
     }
+    //the cache only holds pathsets loaded without black list
+    const bool cacheable = useCache && blackListedLinks.empty();
 
     boost::shared_ptr<sim_mob::PathSet> pathset;
 
@@ -828,21 +859,23 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
      * cache should never be filled with paths containing permanent black listed segments
      */
     std::set<const sim_mob::Link*> emptyBlkLst = std::set<const sim_mob::Link*>(); //sometimes you don't need a black list at all!
-    if (useCache && findCachedPathSet(fromToID, pathset))
+    if (cacheable && pathsetCached)
     {
+        pathset.reset(new sim_mob::PathSet(*cached)); //copied, as the cached pathset is shared with the other threads
         pathset->subTrip = st; //at least for the travel start time, subtrip is needed
         onPathSetRetrieval(pathset, enRoute, useInSimulationTT);
         //no need to supply permanent blacklist
         bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
         if (pathChosen)
         {
-            res = *(pathset->bestPath);
+            pathset->bestPath->toWayPoints(res);
             return true;
         }
     }
 
     //step-2:check  DB
     sim_mob::HasPath hasPath = PSM_UNKNOWN;
+    std::string fromToID = getFromToString(origin, destination);
     pathset.reset(new sim_mob::PathSet());
     pathset->subTrip = st;
     pathset->id = fromToID;
@@ -869,17 +902,16 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
                 break;
             }
         }
+        if (cacheable)
+        {
+            cachePathSet(origin, destination, st.startTime, kind, pathset);
+        }
         //  no need of processing and storing blacklisted paths
         onPathSetRetrieval(pathset, enRoute);
         bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
         if (pathChosen)
         {
-            res = *(pathset->bestPath);
-            //cache
-            if (useCache)
-            {
-                cachePathSet(pathset);
-            }
+            pathset->bestPath->toWayPoints(res);
             return true;
         }
         break;
@@ -888,7 +920,10 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
     case PSM_NOGOODPATH: // or if no good path available
     default: // or if anything else
     {
-        noPathODs.insert(fromToID); //note pathset unavailability
+        if (blackListedLinks.empty())
+        {
+            cachePathSet(origin, destination, st.startTime, kind, boost::shared_ptr<sim_mob::PathSet>()); //note pathset unavailability
+        }
         break;
     }
     };
@@ -914,11 +949,17 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
     {
         return false;
     }
-    std::string fromToID = getFromToString(fromNode->getNodeId(), toNode->getNodeId());
-    if (noPathODs.find(fromToID))
+    const unsigned int origin = fromNode->getNodeId();
+    const unsigned int destination = toNode->getNodeId();
+    const PathSetCache::Kind kind = (nonCBD_OD ? PathSetCache::PRIVATE_WITHOUT_RESTRICTED_REGION : PathSetCache::PRIVATE_STUDY_AREA);
+    boost::shared_ptr<const sim_mob::PathSet> cached;
+    bool pathsetCached = findCachedPathSet(origin, destination, st.startTime, kind, cached);
+    if (pathsetCached && !cached)
     {
         return false;
     }
+    //the cache only holds pathsets loaded without black list
+    const bool cacheable = useCache && blackListedLinks.empty();
 
     boost::shared_ptr<sim_mob::PathSet> pathset;
 
@@ -928,21 +969,23 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
      * cache should never be filled with paths containing permanent black listed segments
      */
     std::set<const sim_mob::Link*> emptyBlkLst = std::set<const sim_mob::Link*>(); //sometimes you don't need a black list at all!
-    if (useCache && findCachedPathSet(fromToID, pathset))
+    if (cacheable && pathsetCached)
     {
+        pathset.reset(new sim_mob::PathSet(*cached)); //copied, as the cached pathset is shared with the other threads
         pathset->subTrip = st; //at least for the travel start time, subtrip is needed
         onPathSetRetrieval(pathset, enRoute, useInSimulationTT);
         //no need to supply permanent blacklist
         bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
         if (pathChosen)
         {
-            res = *(pathset->bestPath);
+            pathset->bestPath->toWayPoints(res);
             return true;
         }
     }
 
     //step-2:check  DB
     sim_mob::HasPath hasPath = PSM_UNKNOWN;
+    std::string fromToID = getFromToString(origin, destination);
     pathset.reset(new sim_mob::PathSet());
     pathset->subTrip = st;
     pathset->id = fromToID;
@@ -988,17 +1031,16 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
                     break;
                 }
             }
+            if (cacheable)
+            {
+                cachePathSet(origin, destination, st.startTime, kind, pathset);
+            }
             //  no need of processing and storing blacklisted paths
             onPathSetRetrieval(pathset, enRoute);
             bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
             if (pathChosen)
             {
-                res = *(pathset->bestPath);
-                //cache
-                if (useCache)
-                {
-                    cachePathSet(pathset);
-                }
+                pathset->bestPath->toWayPoints(res);
                 return true;
             }
             break;
@@ -1007,7 +1049,10 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPath(std::vector<sim_mob::WayPoi
         case PSM_NOGOODPATH: // or if no good path available
         default: // or if anything else
         {
-            noPathODs.insert(fromToID); //note pathset unavailability
+            if (blackListedLinks.empty())
+            {
+                cachePathSet(origin, destination, st.startTime, kind, boost::shared_ptr<sim_mob::PathSet>()); //note pathset unavailability
+            }
             break;
         }
     };
@@ -1020,9 +1065,7 @@ void sim_mob::PrivateTrafficRouteChoice::filterPathsetsByLastLink(boost::shared_
     std::set<sim_mob::SinglePath*, sim_mob::SinglePath>::iterator itr = pathset->pathChoices.begin();
     while (itr != pathset->pathChoices.end() )
     {
-        std::vector<sim_mob::WayPoint> path = (*itr)->path;
-        sim_mob::WayPoint wayPoint = path.back();
-        const Link* link =wayPoint.link;
+        const Link* link = (*itr)->links->back();
         if(link==lastLink)
         {
             itr++;
@@ -1059,11 +1102,17 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
     {
         return false;
     }
-    std::string fromToID = getFromToString(fromNode->getNodeId(), toNode->getNodeId());
-    if (noPathODs.find(fromToID))
+    const unsigned int origin = fromNode->getNodeId();
+    const unsigned int destination = toNode->getNodeId();
+    const PathSetCache::Kind kind = (nonCBD_OD ? PathSetCache::PRIVATE_WITHOUT_RESTRICTED_REGION : PathSetCache::PRIVATE);
+    boost::shared_ptr<const sim_mob::PathSet> cached;
+    bool pathsetCached = findCachedPathSet(origin, destination, st.startTime, kind, cached);
+    if (pathsetCached && !cached)
     {
         return false;
     }
+    //the cache only holds pathsets loaded without black list
+    const bool cacheable = useCache && blackListedLinks.empty();
 
     //boost::shared_ptr<sim_mob::PathSet> pathset;
 
@@ -1073,8 +1122,9 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
      * cache should never be filled with paths containing permanent black listed segments
      */
     std::set<const sim_mob::Link*> emptyBlkLst = std::set<const sim_mob::Link*>(); //sometimes you don't need a black list at all!
-    if (useCache && findCachedPathSet(fromToID, pathset))
+    if (cacheable && pathsetCached)
     {
+        pathset.reset(new sim_mob::PathSet(*cached)); //copied, as the cached pathset is shared with the other threads
         pathset->subTrip = st; //at least for the travel start time, subtrip is needed
         onPathSetRetrieval(pathset, enRoute, useInSimulationTT);
         //no need to supply permanent blacklist
@@ -1082,13 +1132,14 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
         bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
         if (pathChosen)
         {
-            res = *(pathset->bestPath);
+            pathset->bestPath->toWayPoints(res);
             return true;
         }
     }
 
     //step-2:check  DB
     sim_mob::HasPath hasPath = PSM_UNKNOWN;
+    std::string fromToID = getFromToString(origin, destination);
     pathset.reset(new sim_mob::PathSet());
     pathset->subTrip = st;
     pathset->id = fromToID;
@@ -1115,18 +1166,17 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
                 break;
             }
         }
+        if (cacheable)
+        {
+            cachePathSet(origin, destination, st.startTime, kind, pathset);
+        }
         //  no need of processing and storing blacklisted paths
         onPathSetRetrieval(pathset, enRoute);
         filterPathsetsByLastLink(pathset, last);
         bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
         if (pathChosen)
         {
-            res = *(pathset->bestPath);
-            //cache
-            if (useCache)
-            {
-                cachePathSet(pathset);
-            }
+            pathset->bestPath->toWayPoints(res);
             return true;
         }
         break;
@@ -1135,7 +1185,10 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
     case PSM_NOGOODPATH: // or if no good path available
     default: // or if anything else
     {
-        noPathODs.insert(fromToID); //note pathset unavailability
+        if (blackListedLinks.empty())
+        {
+            cachePathSet(origin, destination, st.startTime, kind, boost::shared_ptr<sim_mob::PathSet>()); //note pathset unavailability
+        }
         break;
     }
     };
@@ -1169,11 +1222,17 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
     {
         return false;
     }
-    std::string fromToID = getFromToString(fromNode->getNodeId(), toNode->getNodeId());
-    if (noPathODs.find(fromToID))
+    const unsigned int origin = fromNode->getNodeId();
+    const unsigned int destination = toNode->getNodeId();
+    const PathSetCache::Kind kind = (nonCBD_OD ? PathSetCache::PRIVATE_WITHOUT_RESTRICTED_REGION : PathSetCache::PRIVATE_STUDY_AREA);
+    boost::shared_ptr<const sim_mob::PathSet> cached;
+    bool pathsetCached = findCachedPathSet(origin, destination, st.startTime, kind, cached);
+    if (pathsetCached && !cached)
     {
         return false;
     }
+    //the cache only holds pathsets loaded without black list
+    const bool cacheable = useCache && blackListedLinks.empty();
 
     //boost::shared_ptr<sim_mob::PathSet> pathset;
 
@@ -1183,8 +1242,9 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
      * cache should never be filled with paths containing permanent black listed segments
      */
     std::set<const sim_mob::Link*> emptyBlkLst = std::set<const sim_mob::Link*>(); //sometimes you don't need a black list at all!
-    if (useCache && findCachedPathSet(fromToID, pathset))
+    if (cacheable && pathsetCached)
     {
+        pathset.reset(new sim_mob::PathSet(*cached)); //copied, as the cached pathset is shared with the other threads
         pathset->subTrip = st; //at least for the travel start time, subtrip is needed
         onPathSetRetrieval(pathset, enRoute, useInSimulationTT);
         //no need to supply permanent blacklist
@@ -1192,13 +1252,14 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
         bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
         if (pathChosen)
         {
-            res = *(pathset->bestPath);
+            pathset->bestPath->toWayPoints(res);
             return true;
         }
     }
 
     //step-2:check  DB
     sim_mob::HasPath hasPath = PSM_UNKNOWN;
+    std::string fromToID = getFromToString(origin, destination);
     pathset.reset(new sim_mob::PathSet());
     pathset->subTrip = st;
     pathset->id = fromToID;
@@ -1242,18 +1303,17 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
                     break;
                 }
             }
+            if (cacheable)
+            {
+                cachePathSet(origin, destination, st.startTime, kind, pathset);
+            }
             //  no need of processing and storing blacklisted paths
             onPathSetRetrieval(pathset, enRoute);
             filterPathsetsByLastLink(pathset, last);
             bool pathChosen = PrivateRouteChoiceProvider::getPvtRouteChoiceModel()->getBestPathChoiceFromPathSet(pathset, partial, emptyBlkLst, enRoute, approach);
             if (pathChosen)
             {
-                res = *(pathset->bestPath);
-                //cache
-                if (useCache)
-                {
-                    cachePathSet(pathset);
-                }
+                pathset->bestPath->toWayPoints(res);
                 return true;
             }
             break;
@@ -1262,7 +1322,10 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathToLink(std::vector<sim_mob::
         case PSM_NOGOODPATH: // or if no good path available
         default: // or if anything else
         {
-            noPathODs.insert(fromToID); //note pathset unavailability
+            if (blackListedLinks.empty())
+            {
+                cachePathSet(origin, destination, st.startTime, kind, boost::shared_ptr<sim_mob::PathSet>()); //note pathset unavailability
+            }
             break;
         }
     };
@@ -1295,16 +1358,33 @@ void sim_mob::PrivatePathsetGenerator::bulkPathSetGenerator()
     }
     Print() << "OD's for pathset generation: " << odPairs.size() << std::endl;
 
+    //The ODs are numbered in the order of odPairs, which is the same in every run, so that a binary generation can resume
+    const PathSetConf& pathSetConf = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf();
+    if (pathSetConf.bulkFormat == "binary")
+    {
+        bulkWriter.reset(new BulkPathSetWriter(pathSetConf.bulkFile, odPairs.size(), pathSetConf.bulkCheckpointInterval));
+    }
+
     sim_mob::Profiler t("bulk generator details", true);
+    boost::chrono::steady_clock::time_point startTime = boost::chrono::steady_clock::now();
     int total = 0, iterCnt1 = 0, iterCnt2 = 0;
+    std::size_t odIndex = 0, numScheduled = 0;
     std::set<OD> recursiveOrigins;
     std::set<const RoadSegment*> tempBlackList;
     sim_mob::SubTrip templateSubTrip = makeTemplateSubTrip();
-    for (const OD& od : odPairs)
+    for (std::set<OD>::const_iterator odIt = odPairs.begin(); odIt != odPairs.end(); ++odIt, ++odIndex)
     {
+        const OD& od = *odIt;
         templateSubTrip.origin = od.origin;
         templateSubTrip.destination = od.destination;
-        if (!recursiveOrigins.insert(od).second)
+        {
+            boost::unique_lock<boost::mutex> lock(recursiveODsMutex);
+            if (!recursiveOrigins.insert(od).second)
+            {
+                continue;
+            }
+        }
+        if (bulkWriter && bulkWriter->isCompleted(odIndex))
         {
             continue;
         }
@@ -1313,9 +1393,41 @@ void sim_mob::PrivatePathsetGenerator::bulkPathSetGenerator()
         ps_->id = od.getOD_Str();
         ps_->scenario = scenarioName;
         ps_->subTrip = templateSubTrip;
-        threadpool_->enqueue(boost::bind(&sim_mob::PrivatePathsetGenerator::generateAllPathChoices, this, ps_, boost::ref(recursiveOrigins)));
+        threadpool_->enqueue(boost::bind(&sim_mob::PrivatePathsetGenerator::generateBulkPathSet, this, ps_, odIndex, boost::ref(recursiveOrigins)));
+        numScheduled++;
     }
     threadpool_->wait();
+
+    if (bulkWriter)
+    {
+        bulkWriter->finish();
+        bulkWriter.reset();
+
+        //the pathsets are loaded once all the ODs are generated, so that an interrupted generation loads nothing
+        if (!pathSetConf.bulkTable.empty())
+        {
+            PG_CopySink sink(sim_mob::ConfigManager::GetInstance().FullConfig().getDatabaseConnectionString(false),
+                             pathSetConf.bulkTable, BulkPathSetWriter::getTableColumns());
+            std::size_t numPaths = BulkPathSetWriter::loadShards(pathSetConf.bulkFile, sink);
+            sink.close();
+            Print() << "Bulk pathset generation: " << numPaths << " paths loaded into " << pathSetConf.bulkTable << "\n";
+        }
+    }
+    else
+    {
+        double seconds = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - startTime).count();
+        Print() << "Bulk pathset generation: " << numScheduled << " ODs generated in " << seconds << " seconds, "
+                << (seconds > 0 ? numScheduled / seconds : 0.0) << " ODs/s\n";
+    }
+}
+
+void sim_mob::PrivatePathsetGenerator::generateBulkPathSet(boost::shared_ptr<sim_mob::PathSet> ps, std::size_t odIndex, std::set<OD> &recursiveODs)
+{
+    generateAllPathChoices(ps, recursiveODs);
+    if (bulkWriter)
+    {
+        bulkWriter->complete(odIndex);
+    }
 }
 
 int sim_mob::PrivatePathsetGenerator::genK_ShortestPath(boost::shared_ptr<sim_mob::PathSet> &ps, std::set<sim_mob::SinglePath*, sim_mob::SinglePath> &KSP_Storage)
@@ -1327,13 +1439,11 @@ int sim_mob::PrivatePathsetGenerator::genK_ShortestPath(boost::shared_ptr<sim_mo
     for (int i = 0; i < ksp.size(); ++i)
     {
         std::vector<sim_mob::WayPoint> &path_ = ksp[i];
-        std::string id = sim_mob::makePathString(path_);
         std::stringstream out("");
         out << ps->scenario << "KSHP-" << i;
         sim_mob::SinglePath *s = new sim_mob::SinglePath();
         // fill data
         s->isNeedSave2DB = true;
-        s->id = id;
         s->pathSetId = fromToID;
         s->init(path_);
         s->scenario = ps->scenario + out.str();
@@ -1351,14 +1461,13 @@ int sim_mob::PrivatePathsetGenerator::genSDLE(boost::shared_ptr<sim_mob::PathSet
     StreetDirectory::VertexDesc from = impl->DrivingVertex(*ps->subTrip.origin.node);
     StreetDirectory::VertexDesc to = impl->DrivingVertex(*ps->subTrip.destination.node);
     int cnt = 0;
-    if (ps->oriPath && !ps->oriPath->path.empty())
+    if (ps->oriPath && ps->oriPath->hasLinks())
     {
-        for (std::vector<sim_mob::WayPoint>::iterator it = ps->oriPath->path.begin(); it != ps->oriPath->path.end() ;
-                ++it)
+        for (const sim_mob::Link* lnk : *ps->oriPath->links)
         {
-            if (it->link != curLink)
+            if (lnk != curLink)
             {
-                curLink = it->link;
+                curLink = lnk;
                 PathSetWorkerThread * work = new PathSetWorkerThread();
                 //introducing the profiling time accumulator
                 //the above declared profiler will become a profiling time accumulator of ALL workers in this loop
@@ -1409,7 +1518,7 @@ int sim_mob::PrivatePathsetGenerator::genSTTLE(boost::shared_ptr<sim_mob::PathSe
 
 
     int cnt = 0;
-    if (pathTT && !pathTT->path.empty())
+    if (pathTT && pathTT->hasLinks())
     {
         pathTT->scenario = "STTLE-SP";
         pathTT->pathSetId = ps->id;
@@ -1419,11 +1528,11 @@ int sim_mob::PrivatePathsetGenerator::genSTTLE(boost::shared_ptr<sim_mob::PathSe
         work->pathSet = ps;
         STTLE_Storage.push_back(work); //store STT path as well
 
-        for (std::vector<sim_mob::WayPoint>::iterator it(pathTT->path.begin());
-                it != pathTT->path.end(); ++it){
-            if (it->link != curLink)
+        for (const sim_mob::Link* lnk : *pathTT->links)
+        {
+            if (lnk != curLink)
             {
-                curLink = it->link;
+                curLink = lnk;
                 PathSetWorkerThread *work = new PathSetWorkerThread();
                 work->graph = &sttpImpl->drivingLinkMap;
                 work->linkLookup = &sttpImpl->drivingLinkLookupDefault;
@@ -1432,7 +1541,7 @@ int sim_mob::PrivatePathsetGenerator::genSTTLE(boost::shared_ptr<sim_mob::PathSe
                 work->fromNode = ps->subTrip.origin.node;
                 work->toNode = ps->subTrip.destination.node;
                 blackList.clear();
-                blackList.insert(it->link);
+                blackList.insert(lnk);
                 work->excludedLinks = blackList;
                 work->pathSet = ps;
                 std::stringstream out("");
@@ -1469,7 +1578,7 @@ int sim_mob::PrivatePathsetGenerator::genSTTHBLE(boost::shared_ptr<sim_mob::Path
     StreetDirectory::VertexDesc from = sttpImpl->DrivingVertex(*ps->subTrip.origin.node, sim_mob::HighwayBiasDefault, 0);
     StreetDirectory::VertexDesc to = sttpImpl->DrivingVertex(*ps->subTrip.destination.node,sim_mob::HighwayBiasDefault, 0);
     int cnt = 0;
-    if (sinPathHighwayBias && !sinPathHighwayBias->path.empty())
+    if (sinPathHighwayBias && sinPathHighwayBias->hasLinks())
     {
         sinPathHighwayBias->scenario = "STTHLE-SP";
         sinPathHighwayBias->pathSetId = ps->id;
@@ -1480,12 +1589,11 @@ int sim_mob::PrivatePathsetGenerator::genSTTHBLE(boost::shared_ptr<sim_mob::Path
         STTHBLE_Storage.push_back(work); //store STTHB path as well
 
 
-        for (std::vector<sim_mob::WayPoint>::iterator it(sinPathHighwayBias->path.begin());
-                it != sinPathHighwayBias->path.end(); ++it)
+        for (const sim_mob::Link* lnk : *sinPathHighwayBias->links)
         {
-            if (it->link != curLink)
+            if (lnk != curLink)
             {
-                curLink = it->link;
+                curLink = lnk;
                 PathSetWorkerThread* work = new PathSetWorkerThread();
                 work->graph = &sttpImpl->drivingMapHighwayBiasDefault;
                 work->linkLookup = &sttpImpl->drivingLinkLookupHighwayBiasDefault;
@@ -1494,7 +1602,7 @@ int sim_mob::PrivatePathsetGenerator::genSTTHBLE(boost::shared_ptr<sim_mob::Path
                 work->fromNode = ps->subTrip.origin.node;
                 work->toNode = ps->subTrip.destination.node;
                 blackList.clear();
-                blackList.insert(it->link);
+                blackList.insert(lnk);
                 work->excludedLinks = blackList;
                 work->pathSet = ps;
                 std::stringstream out("");
@@ -1527,12 +1635,18 @@ int sim_mob::PrivatePathsetGenerator::genRandPert(boost::shared_ptr<sim_mob::Pat
     std::string fromToID(getFromToString(ps->subTrip.origin.node->getNodeId(), ps->subTrip.destination.node->getNodeId()));
     A_StarShortestTravelTimePathImpl * sttpImpl = (A_StarShortestTravelTimePathImpl*) stdir.getTravelTimeImpl();
     // generate random path
-    int randCnt = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf().perturbationIteration;
+    const PathSetConf& pathSetConf = sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf();
+    /*
+     * in "generation" mode, the perturbed travel times are drawn from a seed derived from the OD and the iteration,
+     * on the default graph, so that a (resumed) bulk generation yields the same paths whatever the thread of the OD
+     */
+    const bool seeded = (pathSetConf.privatePathSetMode == "generation");
+    int randCnt = pathSetConf.perturbationIteration;
     int cnt = 0;
     for (int i = 0; i < randCnt; ++i)
     {
-            StreetDirectory::VertexDesc from = sttpImpl->DrivingVertex(*ps->subTrip.origin.node, sim_mob::Random, i);
-            StreetDirectory::VertexDesc to = sttpImpl->DrivingVertex(*ps->subTrip.destination.node, sim_mob::Random,  i);
+        StreetDirectory::VertexDesc from = sttpImpl->DrivingVertex(*ps->subTrip.origin.node, (seeded ? sim_mob::Default : sim_mob::Random), i);
+        StreetDirectory::VertexDesc to = sttpImpl->DrivingVertex(*ps->subTrip.destination.node, (seeded ? sim_mob::Default : sim_mob::Random), i);
         if (!(from.valid && to.valid))
         {
             std::cout << "Invalid VertexDesc\n";
@@ -1541,8 +1655,19 @@ int sim_mob::PrivatePathsetGenerator::genRandPert(boost::shared_ptr<sim_mob::Pat
         PathSetWorkerThread *work = new PathSetWorkerThread();
         //introducing the profiling time accumulator
         //the above declared profiler will become a profiling time accumulator of ALL workeres in this loop
-        work->graph = &sttpImpl->drivingMapRandomPool[i];
-        work->linkLookup = &sttpImpl->drivingLinkLookupRandomPool[i];
+        if (seeded)
+        {
+            work->graph = &sttpImpl->drivingMapDefault;
+            work->linkLookup = &sttpImpl->drivingLinkLookupDefault;
+            work->perturbationSeed = PathSetWorkerThread::makePerturbationSeed(ps->subTrip.origin.node->getNodeId(),
+                    ps->subTrip.destination.node->getNodeId(), i);
+            work->perturbationRange = pathSetConf.perturbationRange;
+        }
+        else
+        {
+            work->graph = &sttpImpl->drivingMapRandomPool[i];
+            work->linkLookup = &sttpImpl->drivingLinkLookupRandomPool[i];
+        }
         work->fromVertex = from.source;
         work->toVertex = to.sink;
         work->fromNode = ps->subTrip.origin.node;
@@ -1731,16 +1856,14 @@ int sim_mob::PrivatePathsetGenerator::generateAllPathChoices(boost::shared_ptr<s
     std::set<const Node*> newOrigins = std::set<const Node*>();
     for (sim_mob::SinglePath *sp : ps->pathChoices)
     {
-        if (sp->path.size() <= 1) { continue; }
+        if (!sp->links || sp->links->size() <= 1) { continue; }
         const sim_mob::Node * linkEnd = nullptr;
         //skip the origin and destination node(first and last one)
-        std::vector<WayPoint>::iterator it = sp->path.begin();
+        sim_mob::CompactPath::const_iterator it = sp->links->begin();
         it++;
-        std::vector<WayPoint>::iterator itEnd = sp->path.end();
-        itEnd--;
-        for (; it != itEnd; it++)
+        for (std::size_t i = 1; i + 1 < sp->links->size(); i++, it++)
         {
-            const sim_mob::Node * newFrom = it->link->getToNode();
+            const sim_mob::Node * newFrom = (*it)->getToNode();
             // All segments of the link have the same link end node. Skip if already chosen
             if (linkEnd == newFrom)
             {
@@ -1750,10 +1873,13 @@ int sim_mob::PrivatePathsetGenerator::generateAllPathChoices(boost::shared_ptr<s
             {
                 linkEnd = newFrom;
             }
-            //check if the new OD you want to process is not already scheduled for processing by previous iterations(todo: or even by other threads!)
-            if (recursiveODs.insert(OD(newFrom, ps->subTrip.destination.node)).second == false)
+            //check if the new OD you want to process is not already scheduled for processing by previous iterations or by other threads
             {
-                continue;
+                boost::unique_lock<boost::mutex> lock(recursiveODsMutex);
+                if (recursiveODs.insert(OD(newFrom, ps->subTrip.destination.node)).second == false)
+                {
+                    continue;
+                }
             }
             //Now we have a new qualified Origin. note it down for further processing
             newOrigins.insert(newFrom);
@@ -1936,7 +2062,7 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathChoiceFromPathSet(boost::sha
     pvtpathset.clear();
     for (sim_mob::SinglePath* sp : ps->pathChoices)
     {
-        if (sp->path.empty())
+        if (!sp->hasLinks())
         {
             throw std::runtime_error("empty Path");
         }
@@ -1947,7 +2073,7 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathChoiceFromPathSet(boost::sha
         }
         
         //Check if the approach is specified for the path, if so skip the paths that do not start at the approach link
-        if(approach && sp->path.front().link != approach)
+        if(approach && sp->links->front() != approach)
         {
             continue;
         }
@@ -1985,7 +2111,7 @@ bool sim_mob::PrivateTrafficRouteChoice::getBestPathChoiceFromPathSet(boost::sha
             throw std::runtime_error(errStrm.str());
         }
         //Assigning the best path based on the index received from pvtrc lua
-        ps->bestPath = &(pvtpathset[index - 1]->path);
+        ps->bestPath = pvtpathset[index - 1]->links;
         return true;
     }
     else
@@ -2012,7 +2138,6 @@ sim_mob::SinglePath * sim_mob::PrivatePathsetGenerator::findShortestDrivingPath(
     sim_mob::SinglePath *singlePath = new SinglePath();
     singlePath->isNeedSave2DB = true;
     singlePath->init(wpPath);
-    singlePath->id = sim_mob::makePathString(wpPath);
     singlePath->scenario = scenarioName;
     singlePath->shortestPath = true;
     return singlePath;
@@ -2030,31 +2155,28 @@ sim_mob::SinglePath* sim_mob::PrivatePathsetGenerator::generateShortestTravelTim
     {
         return NULL; // no path
     }
-    // make sp id
-    std::string id = sim_mob::makePathString(wp);
-
     sim_mob::SinglePath *singlePath = new SinglePath();
     // fill data
     singlePath->isNeedSave2DB = true;
     singlePath->init(wp);
-    singlePath->id = id;
     singlePath->scenario = scenarioName;
     singlePath->pathSize = 0;
     return singlePath;
 }
 
-double sim_mob::PrivateTrafficRouteChoice::getPathTravelTime(sim_mob::SinglePath *sp, const sim_mob::DailyTime & startTime_, bool enRoute, bool useInSimulationTT)
+double sim_mob::PrivateTrafficRouteChoice::getPathTravelTime(const sim_mob::SinglePath *sp, const sim_mob::DailyTime & startTime_, bool enRoute, bool useInSimulationTT)
 {
     sim_mob::DailyTime startTime = startTime_;
     double timeSum = 0.0;
-    for (int i = 0; i < sp->path.size(); ++i)
+    for (sim_mob::CompactPath::const_iterator it = sp->links->begin(); it != sp->links->end(); ++it)
     {
         double time = 0.0;
-        const sim_mob::Link *lnk = sp->path[i].link;
+        const sim_mob::Link *lnk = *it;
         const sim_mob::Link *nextLink = nullptr;
-        if ((i + 1) < sp->path.size())
+        sim_mob::CompactPath::const_iterator itNext = it;
+        if (++itNext != sp->links->end())
         {
-            nextLink = sp->path[i + 1].link;
+            nextLink = *itNext;
         }
 // TODO: Make PrivateTrafficRouteChoice a message handler and notify it about any incidents through message. Incident manager must not be used here
 //      const sim_mob::IncidentManager * inc = IncidentManager::getInstance();
@@ -2076,7 +2198,7 @@ double sim_mob::PrivateTrafficRouteChoice::getPathTravelTime(sim_mob::SinglePath
     if (timeSum <= 0.0)
     {
         std::stringstream out("");
-        out << "No travel time for path " << sp->id;
+        out << "No travel time for path " << sp->getId();
         throw std::runtime_error(out.str());
     }
     return timeSum;
@@ -2120,7 +2242,7 @@ sim_mob::PrivateTrafficRouteChoice::PrivateTrafficRouteChoice()
         : PathSetManager(),
           psRetrieval(sim_mob::ConfigManager::GetInstance().FullConfig().getDatabaseProcMappings().procedureMappings.find("pvt_pathset")->second),
           psRetrievalWithoutRestrictedRegion(sim_mob::ConfigManager::GetInstance().FullConfig().getPathSetConf().psRetrievalWithoutBannedRegion),
-          cacheLRU(2500), ttMgr(*(sim_mob::TravelTimeManager::getInstance())), regionRestrictonEnabled(false)
+          ttMgr(*(sim_mob::TravelTimeManager::getInstance())), regionRestrictonEnabled(false)
 {
 }
 
@@ -2242,8 +2364,8 @@ sim_mob::HasPath PrivateTrafficRouteChoice::loadPathsetFromDB(soci::session& sql
 
         //create path object
         sim_mob::SinglePath *singlePath = new sim_mob::SinglePath(*it);
-        singlePath->path = boost::move(path);
-        if (singlePath->path.empty())
+        singlePath->setPath(path);
+        if (!singlePath->hasLinks())
         {
             throw std::runtime_error("Empty Path");
         }
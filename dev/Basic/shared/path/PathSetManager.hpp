@@ -8,7 +8,7 @@
 #include "geospatial/network/Link.hpp"
 #include "PathSetParam.hpp"
 #include "entities/TravelTimeManager.hpp"
-#include "util/Cache.hpp"
+#include "PathSetCache.hpp"
 #include "lua/LuaModel.hpp"
 #include "Path.hpp"
 #include "util/OneTimeFlag.hpp"
@@ -22,6 +22,8 @@ namespace batched
     class ThreadPool;
 }
 
+class BulkPathSetWriter;
+
 //FDs for RestrictedRegion
 class Node;
 class TripChainItem;
@@ -198,6 +200,12 @@ private:
     /** pool of threads for generation of paths */
     static boost::shared_ptr<sim_mob::batched::ThreadPool> threadpool_;
 
+    /** binary output of the bulk generation in progress; null when the output is csv */
+    boost::shared_ptr<BulkPathSetWriter> bulkWriter;
+
+    /** guards the ODs scheduled by bulk and recursive generation, which are shared by the generator threads */
+    boost::mutex recursiveODsMutex;
+
     /**
      * generate shortest distance path
      * @param fromNode origin
@@ -273,6 +281,14 @@ private:
      */
     void onGeneratePathSet(boost::shared_ptr<PathSet> &ps);
 
+    /**
+     * generates the pathsets of an OD of a bulk generation, and records its completion
+     * @param ps the input pathset
+     * @param odIndex index of the OD in the bulk generation
+     * @param recursiveODs ODs already scheduled for generation
+     */
+    void generateBulkPathSet(boost::shared_ptr<sim_mob::PathSet> ps, std::size_t odIndex, std::set<OD> &recursiveODs);
+
 public:
     PrivatePathsetGenerator();
     virtual ~PrivatePathsetGenerator();
@@ -315,9 +331,6 @@ public:
 class PrivateTrafficRouteChoice : public sim_mob::PathSetManager , public lua::LuaModel
 {
 private:
-    /** the pathset cache */
-    sim_mob::LRU_Cache<std::string, boost::shared_ptr<PathSet> > cacheLRU;
-
     /**
      * list of partially excluded links
      * example:like links with incidents which have to be assigned a maximum travel time
@@ -342,18 +355,27 @@ private:
     std::vector<sim_mob::SinglePath*> pvtpathset;
 
     /**
-     * cache the generated pathset
-     * @param ps pathset general information
+     * caches a pathset loaded from the database, in the pathset cache shared by all the threads
+     * @param origin id of the origin node of the pathset
+     * @param destination id of the destination node of the pathset
+     * @param departure departure time of the trip the pathset was loaded for
+     * @param kind kind of the pathset
+     * @param ps the pathset, copied before its paths are given travel times; null if the database has no path
      */
-    void cachePathSet(boost::shared_ptr<sim_mob::PathSet> &ps);
+    void cachePathSet(unsigned int origin, unsigned int destination, const sim_mob::DailyTime &departure,
+            PathSetCache::Kind kind, const boost::shared_ptr<sim_mob::PathSet> &ps);
 
     /**
-     * searches for a pathset in the cache.
-     * @param key indicates the input key
-     * @param value the result of the search
+     * searches for a pathset in the pathset cache shared by all the threads
+     * @param origin id of the origin node
+     * @param destination id of the destination node
+     * @param departure departure time of the trip
+     * @param kind kind of the pathset
+     * @param value output: the cached pathset, shared with the other threads; null if the database has no path
      * returns true/false to indicate if the search has been successful
      */
-    bool findCachedPathSet(std::string key, boost::shared_ptr<sim_mob::PathSet> &value);
+    bool findCachedPathSet(unsigned int origin, unsigned int destination, const sim_mob::DailyTime &departure,
+            PathSetCache::Kind kind, boost::shared_ptr<const sim_mob::PathSet> &value) const;
 
     /**
      * calculates the travel time of a path
@@ -364,7 +386,7 @@ private:
      * @param useInSimulationTT indicates whether in simulation travel times are to be used
      * @returns path's travel time, in seconds
      */
-    double getPathTravelTime(sim_mob::SinglePath *sp, const sim_mob::DailyTime & startTime, bool enRoute = false, bool useInSimulationTT = false);
+    double getPathTravelTime(const sim_mob::SinglePath *sp, const sim_mob::DailyTime & startTime, bool enRoute = false, bool useInSimulationTT = false);
 
     /**
      * update pathset paramenters before selecting the best path
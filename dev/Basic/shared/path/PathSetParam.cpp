@@ -64,7 +64,7 @@ void sim_mob::PathSetParam::storeSinglePath(std::set<sim_mob::SinglePath*, sim_m
                 pathsetCSV
                         << sp->pathSetId << ","
                         << ("\"" + sp->scenario  + "\"") << ","
-                        << ("\"" + sp->id + "\"") << ","
+                        << ("\"" + sp->getId() + "\"") << ","
                         << sp->partialUtility << ","
                         << sp->pathSize << ","
                         << sp->signalNumber << ","
@@ -18,6 +18,7 @@
 #include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/astar_search.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/property_map/function_property_map.hpp>
 #include <iterator>
 #include <algorithm>
 #include <vector>
@@ -27,15 +28,69 @@ using namespace std;
 namespace
 {
     //sim_mob::BasicLogger & logger = sim_mob::Logger::log("pathset.log");
+
+    /**
+     * scrambles the bits of a 64 bit integer (splitmix64 finaliser)
+     */
+    boost::uint64_t mix(boost::uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * weights of the edges of a graph, with the link edges perturbed by seeded random factors
+     */
+    struct PerturbedEdgeWeight
+    {
+        PerturbedEdgeWeight(const sim_mob::StreetDirectory::Graph* graph, boost::uint64_t seed, const std::pair<int, int>& range) :
+                graph(graph), seed(seed), range(range)
+        {
+        }
+
+        double operator()(const sim_mob::StreetDirectory::Edge& edge) const
+        {
+            double weight = boost::get(boost::edge_weight, *graph, edge);
+            const sim_mob::WayPoint& wp = boost::get(boost::edge_name, *graph, edge);
+            if (wp.type != sim_mob::WayPoint::LINK)
+            {
+                return weight;
+            }
+            return weight * sim_mob::PathSetWorkerThread::getPerturbationFactor(seed, wp.link->getLinkId(), range);
+        }
+
+        const sim_mob::StreetDirectory::Graph* graph;
+        boost::uint64_t seed;
+        std::pair<int, int> range;
+    };
 }
 
 sim_mob::PathSetWorkerThread::PathSetWorkerThread() :
-        path(NULL), linkLookup(NULL), fromNode(NULL), toNode(NULL), hasPath(false), timeBased(false), dbgStr(std::string()), graph(NULL)
+        path(NULL), linkLookup(NULL), fromNode(NULL), toNode(NULL), hasPath(false), timeBased(false), perturbationSeed(0),
+        perturbationRange(0, 0), dbgStr(std::string()), graph(NULL)
 {
 }
 
 sim_mob::PathSetWorkerThread::~PathSetWorkerThread() { }
 
+boost::uint64_t sim_mob::PathSetWorkerThread::makePerturbationSeed(unsigned int origin, unsigned int destination, unsigned int iteration)
+{
+    boost::uint64_t seed = mix(mix((static_cast<boost::uint64_t>(origin) << 32) | destination) ^ iteration);
+    return (seed != 0 ? seed : 1);
+}
+
+int sim_mob::PathSetWorkerThread::getPerturbationFactor(boost::uint64_t seed, unsigned int linkId,
+        const std::pair<int, int>& range)
+{
+    if (range.second <= range.first)
+    {
+        return range.first;
+    }
+    return range.first + static_cast<int>(mix(seed ^ mix(linkId)) % static_cast<boost::uint64_t>(range.second - range.first + 1));
+}
+
 //1.Create Blacklist
 //2.clear the shortestWayPointpath
 //3.Populate a vector<WayPoint> with a blacklist involved
@@ -72,8 +127,17 @@ void sim_mob::PathSetWorkerThread::run()
             vector<double> d(boost::num_vertices(*graph)); //Output variable
             try
             {
-                boost::astar_search(*graph, fromVertex, sim_mob::A_StarShortestTravelTimePathImpl::DistanceHeuristicGraph(graph, toVertex),
-                                    boost::predecessor_map(&p[0]).distance_map(&d[0]).visitor(sim_mob::A_StarShortestTravelTimePathImpl::GoalVisitor(toVertex)));
+                if (perturbationSeed)
+                {
+                    boost::astar_search(*graph, fromVertex, sim_mob::A_StarShortestTravelTimePathImpl::DistanceHeuristicGraph(graph, toVertex),
+                                        boost::weight_map(boost::make_function_property_map<StreetDirectory::Edge, double>(PerturbedEdgeWeight(graph, perturbationSeed, perturbationRange)))
+                                        .predecessor_map(&p[0]).distance_map(&d[0]).visitor(sim_mob::A_StarShortestTravelTimePathImpl::GoalVisitor(toVertex)));
+                }
+                else
+                {
+                    boost::astar_search(*graph, fromVertex, sim_mob::A_StarShortestTravelTimePathImpl::DistanceHeuristicGraph(graph, toVertex),
+                                        boost::predecessor_map(&p[0]).distance_map(&d[0]).visitor(sim_mob::A_StarShortestTravelTimePathImpl::GoalVisitor(toVertex)));
+                }
             }
             catch (sim_mob::A_StarShortestTravelTimePathImpl::Goal& goal)
             {
@@ -283,29 +347,21 @@ void sim_mob::PathSetWorkerThread::run()
     }
     else
     {
-        // make sp id
-        std::string id = sim_mob::makePathString(wps);
-        if (id.empty())
+        path = new sim_mob::SinglePath();
+        // fill data
+        path->isNeedSave2DB = true;
+        hasPath = true;
+        path->pathSetId = pathSet->id;
+        path->scenario = pathSet->scenario + dbgStr;
+        path->init(wps);
+        path->pathSize = 0;
+        //a link traversed twice means a loop in the path
+        if (!path->hasLinks() || path->links->hasLoop()
+                || path->links->front()->getFromNodeId() != this->pathSet->subTrip.origin.node->getNodeId())
         {
+            safe_delete_item(path);
             hasPath = false;
         }
-        else
-        {
-            path = new sim_mob::SinglePath();
-            // fill data
-            path->isNeedSave2DB = true;
-            hasPath = true;
-            path->pathSetId = pathSet->id;
-            path->scenario = pathSet->scenario + dbgStr;
-            path->init(wps);
-            path->id = id;
-            path->pathSize = 0;
-            if (this->path->path.begin()->link->getFromNodeId() != this->pathSet->subTrip.origin.node->getNodeId())
-            {
-                safe_delete_item(path);
-                hasPath = false;
-            }
-        }
     }
 }
 
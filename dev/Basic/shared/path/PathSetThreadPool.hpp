@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+#include <boost/cstdint.hpp>
 #include "path/Path.hpp"
 #include "geospatial/network/Link.hpp"
 #include "geospatial/streetdir/StreetDirectory.hpp"
@@ -19,6 +21,25 @@ public:
     PathSetWorkerThread();
     virtual ~PathSetWorkerThread();
 
+    /**
+     * derives the seed of a random perturbation of the travel times, the same in every run
+     * @param origin id of the origin node
+     * @param destination id of the destination node
+     * @param iteration index of the perturbation among those of the OD
+     * @return the seed; never 0
+     */
+    static boost::uint64_t makePerturbationSeed(unsigned int origin, unsigned int destination, unsigned int iteration);
+
+    /**
+     * draws the factor applied to the travel time of a link by a random perturbation
+     * @param seed seed of the perturbation
+     * @param linkId id of the link
+     * @param range bounds of the uniformly distributed factor
+     * @return the factor, within range
+     */
+    static int getPerturbationFactor(boost::uint64_t seed, unsigned int linkId,
+            const std::pair<int, int>& range);
+
     StreetDirectory::Graph* graph;
     StreetDirectory::Vertex fromVertex;
     StreetDirectory::Vertex toVertex;
@@ -30,6 +51,9 @@ public:
     boost::shared_ptr<sim_mob::PathSet> pathSet;
     bool hasPath;
     bool timeBased;
+    ///if not 0, the weights of the link edges of a time based graph are multiplied by getPerturbationFactor(perturbationSeed, ...)
+    boost::uint64_t perturbationSeed;
+    std::pair<int, int> perturbationRange;
     ///used by local profilers to report to the profiler in higher level.
     std::string dbgStr;
 };
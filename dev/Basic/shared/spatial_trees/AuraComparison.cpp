@@ -0,0 +1,554 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "AuraComparison.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "entities/Agent.hpp"
+#include "geospatial/network/Lane.hpp"
+#include "geospatial/network/Point.hpp"
+#include "geospatial/network/RoadNetwork.hpp"
+#include "geospatial/network/TurningPath.hpp"
+#include "geospatial/network/WayPoint.hpp"
+#include "spatial_trees/shared_funcs.hpp"
+#include "spatial_trees/TreeImpl.hpp"
+#include "spatial_trees/incremental_tree/IncrementalTreeAuraManager.hpp"
+#include "spatial_trees/lane_index/LaneAuraManager.hpp"
+#include "spatial_trees/packing_tree/PackingTreeAuraManager.hpp"
+#include "spatial_trees/rdu_tree/RDUAuraManager.hpp"
+#include "spatial_trees/rstar_tree/RStarAuraManager.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::spatial;
+
+namespace
+{
+/**Number of nearbyAgents() and agentsInRect() queries checked per frame*/
+const std::size_t MAX_NEARBY_QUERIES_PER_FRAME = 200;
+const std::size_t MAX_RECT_QUERIES_PER_FRAME = 20;
+
+/**Differences of the 2-D implementations within this distance of the border of the search rectangle are rounding*/
+const double BORDER_TOLERANCE = 1.0;
+
+typedef std::vector<const Agent *> AgentList;
+
+/**
+ * Agent replaying the recorded positions of a simulated agent
+ */
+class ReplayAgent : public Agent
+{
+public:
+    explicit ReplayAgent(unsigned int id) : Agent(MtxStrat_Buffered, id), onLane(false), distance(0), lastFrame(0)
+    {
+    }
+
+    void moveTo(const AuraSample &sample, const WayPoint *currWayPoint, unsigned int frame)
+    {
+        xPos.force(sample.x);
+        yPos.force(sample.y);
+        onLane = (currWayPoint != nullptr);
+        if (onLane)
+        {
+            wayPoint = *currWayPoint;
+            distance = sample.distance;
+        }
+        lastFrame = frame;
+    }
+
+    virtual bool getLanePosition(WayPoint &currWayPoint, double &currDistance) const
+    {
+        if (!onLane)
+        {
+            return false;
+        }
+        currWayPoint = wayPoint;
+        currDistance = distance;
+        return true;
+    }
+
+    virtual bool isNonspatial()
+    {
+        return false;
+    }
+
+    bool isOnLane() const
+    {
+        return onLane;
+    }
+
+    const WayPoint& getWayPoint() const
+    {
+        return wayPoint;
+    }
+
+    double getDistance() const
+    {
+        return distance;
+    }
+
+    unsigned int getLastFrame() const
+    {
+        return lastFrame;
+    }
+
+protected:
+    virtual Entity::UpdateStatus frame_init(timeslice now)
+    {
+        return Entity::UpdateStatus::Continue;
+    }
+
+    virtual Entity::UpdateStatus frame_tick(timeslice now)
+    {
+        return Entity::UpdateStatus::Continue;
+    }
+
+    virtual void frame_output(timeslice now)
+    {
+    }
+
+private:
+    bool onLane;
+    WayPoint wayPoint;
+    double distance;
+
+    /**Last frame in which the agent was recorded*/
+    unsigned int lastFrame;
+};
+
+/**
+ * The implementations and the agents of a replay. Puts back the agents of the simulation when the replay ends.
+ */
+struct ReplayState
+{
+    ReplayState()
+    {
+        savedAgents.swap(Agent::all_agents);
+    }
+
+    ~ReplayState()
+    {
+        for (std::vector<std::pair<std::string, TreeImpl *> >::iterator it = implementations.begin(); it != implementations.end(); ++it)
+        {
+            delete it->second;
+        }
+        for (std::map<unsigned int, ReplayAgent *>::iterator it = agents.begin(); it != agents.end(); ++it)
+        {
+            delete it->second;
+        }
+        Agent::all_agents.swap(savedAgents);
+    }
+
+    std::set<Entity *> savedAgents;
+
+    /**The implementations with the 2-D semantics, by name, then the lane index*/
+    std::vector<std::pair<std::string, TreeImpl *> > implementations;
+
+    std::map<unsigned int, ReplayAgent *> agents;
+};
+
+bool isOnBorder(const ReplayAgent *agent, const Point &lowerLeft, const Point &upperRight)
+{
+    double x = agent->xPos.get();
+    double y = agent->yPos.get();
+    return std::abs(x - lowerLeft.getX()) <= BORDER_TOLERANCE || std::abs(x - upperRight.getX()) <= BORDER_TOLERANCE
+        || std::abs(y - lowerLeft.getY()) <= BORDER_TOLERANCE || std::abs(y - upperRight.getY()) <= BORDER_TOLERANCE;
+}
+
+/**Same test as IncrementalTree::query(), which answers the rectangle part of the lane index queries*/
+bool isInRect(const ReplayAgent *agent, const Point &lowerLeft, const Point &upperRight)
+{
+    float x = agent->xPos.get();
+    float y = agent->yPos.get();
+    return x >= static_cast<float> (lowerLeft.getX()) && x <= static_cast<float> (upperRight.getX())
+        && y >= static_cast<float> (lowerLeft.getY()) && y <= static_cast<float> (upperRight.getY());
+}
+
+bool isOnWayPoint(const ReplayAgent *agent, const WayPoint &wayPoint, double from, double to)
+{
+    return agent->isOnLane() && agent->getWayPoint() == wayPoint && agent->getDistance() >= from && agent->getDistance() <= to;
+}
+
+/**
+ * Brute force search with the semantics of LaneAuraManager::nearbyAgents()
+ */
+void findNearbyOnLanes(const std::vector<const ReplayAgent *> &present, const Point &position, const WayPoint &wayPoint,
+                       double distanceInFront, double distanceBehind, AgentList &result)
+{
+    WayPoint searched[3];
+    double centres[3];
+    searched[0] = wayPoint;
+    std::size_t numSearched = 1 + getAdjacentWayPoints(wayPoint, searched + 1);
+    double length = getWayPointLength(wayPoint);
+    centres[0] = getDistanceAlong(position, wayPoint);
+    for (std::size_t i = 1; i < numSearched; i++)
+    {
+        centres[i] = (length > 0) ? centres[0] * getWayPointLength(searched[i]) / length : centres[0];
+    }
+
+    Point lowerLeft, upperRight;
+    getSearchRectangle(position, wayPoint, distanceInFront, distanceBehind, lowerLeft, upperRight);
+    bool beyondWayPoint = (centres[0] - distanceBehind < 0 || centres[0] + distanceInFront > length);
+
+    for (std::vector<const ReplayAgent *>::const_iterator it = present.begin(); it != present.end(); ++it)
+    {
+        bool found = isInRect(*it, lowerLeft, upperRight) && (beyondWayPoint || !(*it)->isOnLane());
+        for (std::size_t i = 0; i < numSearched && !found; i++)
+        {
+            found = isOnWayPoint(*it, searched[i], centres[i] - distanceBehind, centres[i] + distanceInFront);
+        }
+        if (found)
+        {
+            result.push_back(*it);
+        }
+    }
+}
+
+std::size_t countMissing(const AgentList &sorted, const AgentList &other)
+{
+    AgentList missing;
+    std::set_difference(sorted.begin(), sorted.end(), other.begin(), other.end(), std::back_inserter(missing));
+    return missing.size();
+}
+}
+
+void AuraTrace::sampleAgents(const std::set<Entity *> &agents, const std::set<Entity *> &removedAgentPointers, AuraFrame &frame)
+{
+    frame.clear();
+    for (std::set<Entity *>::const_iterator it = agents.begin(); it != agents.end(); ++it)
+    {
+        Agent *agent = dynamic_cast<Agent *> (*it);
+        if ((!agent) || agent->isNonspatial() || removedAgentPointers.find(agent) != removedAgentPointers.end())
+        {
+            continue;
+        }
+
+        AuraSample sample;
+        sample.agentId = agent->getId();
+        sample.x = agent->xPos.get();
+        sample.y = agent->yPos.get();
+
+        WayPoint wayPoint;
+        if (agent->getLanePosition(wayPoint, sample.distance))
+        {
+            if (wayPoint.type == WayPoint::LANE)
+            {
+                sample.wayPointType = AuraSample::ON_LANE;
+                sample.wayPointId = wayPoint.lane->getLaneId();
+            }
+            else
+            {
+                sample.wayPointType = AuraSample::ON_TURNING_PATH;
+                sample.wayPointId = wayPoint.turningPath->getTurningPathId();
+            }
+        }
+        frame.push_back(sample);
+    }
+}
+
+void AuraTrace::writeFrame(std::ostream &os, const AuraFrame &frame)
+{
+    std::streamsize precision = os.precision(9);
+    os << "frame " << frame.size() << "\n";
+    for (AuraFrame::const_iterator it = frame.begin(); it != frame.end(); ++it)
+    {
+        os << it->agentId << " " << it->x << " " << it->y << " " << it->wayPointType << " " << it->wayPointId << " "
+           << it->distance << "\n";
+    }
+    os.precision(precision);
+}
+
+bool AuraTrace::readFrame(std::istream &is, AuraFrame &frame)
+{
+    std::string header;
+    std::size_t numSamples = 0;
+    if (!(is >> header))
+    {
+        return false;
+    }
+    if (header != "frame" || !(is >> numSamples))
+    {
+        throw std::runtime_error("AuraTrace: expected \"frame <number of agents>\"");
+    }
+
+    frame.resize(numSamples);
+    for (AuraFrame::iterator it = frame.begin(); it != frame.end(); ++it)
+    {
+        if (!(is >> it->agentId >> it->x >> it->y >> it->wayPointType >> it->wayPointId >> it->distance))
+        {
+            throw std::runtime_error("AuraTrace: truncated frame");
+        }
+    }
+    return true;
+}
+
+void AuraTrace::readTrace(const std::string &fileName, std::vector<AuraFrame> &frames)
+{
+    std::ifstream file(fileName.c_str());
+    if (!file.is_open())
+    {
+        std::stringstream errStrm;
+        errStrm << "AuraTrace: cannot open " << fileName;
+        throw std::runtime_error(errStrm.str());
+    }
+
+    frames.clear();
+    AuraFrame frame;
+    while (readFrame(file, frame))
+    {
+        frames.push_back(frame);
+    }
+}
+
+void AuraComparison::Report::print(std::ostream &os) const
+{
+    os << "AuraManager comparison: " << numFrames << " frames, " << numNearbyQueries << " nearbyAgents and "
+       << numRectQueries << " agentsInRect queries, " << numMismatches << " mismatches, " << numBorderDifferences
+       << " differences on the border of the search rectangle\n";
+    os << "  lane index nearbyAgents: " << numLaneOnly << " agents not found by the 2-D implementations, "
+       << numRectOnly << " agents found by the 2-D implementations only\n";
+    if (numUnresolved > 0)
+    {
+        os << "  " << numUnresolved << " samples on unknown lanes or turning paths\n";
+    }
+    for (std::vector<std::string>::const_iterator it = mismatches.begin(); it != mismatches.end(); ++it)
+    {
+        os << "  " << *it << "\n";
+    }
+}
+
+AuraComparison::AuraComparison(const WayPointResolver &resolveWayPoint, unsigned int numThreads, double distanceInFront,
+                               double distanceBehind) :
+    resolveWayPoint(resolveWayPoint), numThreads(std::max(numThreads, 1u)), distanceInFront(distanceInFront),
+    distanceBehind(distanceBehind)
+{
+}
+
+bool AuraComparison::resolveNetworkWayPoint(char wayPointType, unsigned int wayPointId, WayPoint &wayPoint)
+{
+    const RoadNetwork *network = RoadNetwork::getInstance();
+    if (wayPointType == AuraSample::ON_LANE)
+    {
+        std::map<unsigned int, Lane *>::const_iterator it = network->getMapOfIdVsLanes().find(wayPointId);
+        if (it != network->getMapOfIdVsLanes().end())
+        {
+            wayPoint = WayPoint(it->second);
+            return true;
+        }
+    }
+    else if (wayPointType == AuraSample::ON_TURNING_PATH)
+    {
+        std::map<unsigned int, TurningPath *>::const_iterator it = network->getMapOfIdvsTurningPaths().find(wayPointId);
+        if (it != network->getMapOfIdvsTurningPaths().end())
+        {
+            wayPoint = WayPoint(it->second);
+            return true;
+        }
+    }
+    return false;
+}
+
+AuraComparison::Report AuraComparison::replay(const std::vector<AuraFrame> &frames) const
+{
+    Report report;
+    ReplayState state;
+    state.implementations.push_back(std::make_pair(std::string("rstar"), static_cast<TreeImpl *> (new RStarAuraManager())));
+    state.implementations.push_back(std::make_pair(std::string("rdu"), static_cast<TreeImpl *> (new RDUAuraManager())));
+    state.implementations.push_back(std::make_pair(std::string("packing-tree"), static_cast<TreeImpl *> (new PackingTreeAuraManager())));
+    state.implementations.push_back(std::make_pair(std::string("incremental-tree"), static_cast<TreeImpl *> (new IncrementalTreeAuraManager(numThreads))));
+    state.implementations.push_back(std::make_pair(std::string("lane-index"), static_cast<TreeImpl *> (new LaneAuraManager(numThreads))));
+    const std::size_t numRectImpls = state.implementations.size() - 1;
+
+    for (std::vector<std::pair<std::string, TreeImpl *> >::iterator it = state.implementations.begin(); it != state.implementations.end(); ++it)
+    {
+        it->second->init();
+    }
+
+    std::vector<AgentList> results(state.implementations.size());
+    AgentList expected;
+
+    for (unsigned int frameNo = 1; frameNo <= frames.size(); frameNo++)
+    {
+        const AuraFrame &frame = frames[frameNo - 1];
+        report.numFrames++;
+
+        //Move the agents to their recorded positions
+        std::vector<const ReplayAgent *> present;
+        std::vector<ReplayAgent *> newAgents;
+        for (AuraFrame::const_iterator sample = frame.begin(); sample != frame.end(); ++sample)
+        {
+            ReplayAgent *&agent = state.agents[sample->agentId];
+            if (!agent)
+            {
+                agent = new ReplayAgent(sample->agentId);
+                Agent::all_agents.insert(agent);
+                newAgents.push_back(agent);
+            }
+
+            WayPoint wayPoint;
+            bool onLane = (sample->wayPointType != AuraSample::NOT_ON_LANE) && resolveWayPoint(sample->wayPointType, sample->wayPointId, wayPoint);
+            if (sample->wayPointType != AuraSample::NOT_ON_LANE && !onLane)
+            {
+                report.numUnresolved++;
+            }
+            agent->moveTo(*sample, onLane ? &wayPoint : nullptr, frameNo);
+            present.push_back(agent);
+        }
+
+        //The agents which are gone are removed by this update, and deleted after it
+        std::set<Entity *> removedAgents;
+        for (std::map<unsigned int, ReplayAgent *>::const_iterator it = state.agents.begin(); it != state.agents.end(); ++it)
+        {
+            if (it->second->getLastFrame() != frameNo)
+            {
+                removedAgents.insert(it->second);
+            }
+        }
+
+        for (std::vector<std::pair<std::string, TreeImpl *> >::iterator impl = state.implementations.begin(); impl != state.implementations.end(); ++impl)
+        {
+            for (std::vector<ReplayAgent *>::const_iterator it = newAgents.begin(); it != newAgents.end(); ++it)
+            {
+                impl->second->registerNewAgent(*it);
+            }
+            impl->second->update(frameNo, removedAgents);
+        }
+
+        for (std::set<Entity *>::iterator it = removedAgents.begin(); it != removedAgents.end(); ++it)
+        {
+            ReplayAgent *agent = static_cast<ReplayAgent *> (*it);
+            Agent::all_agents.erase(agent);
+            state.agents.erase(agent->getId());
+            delete agent;
+        }
+
+        //Query around some of the agents
+        std::vector<const ReplayAgent *> onLane;
+        for (std::vector<const ReplayAgent *>::const_iterator it = present.begin(); it != present.end(); ++it)
+        {
+            if ((*it)->isOnLane())
+            {
+                onLane.push_back(*it);
+            }
+        }
+
+        std::size_t stride = std::max<std::size_t>(1, onLane.size() / MAX_NEARBY_QUERIES_PER_FRAME);
+        for (std::size_t q = 0; q < onLane.size(); q += stride)
+        {
+            const ReplayAgent *agent = onLane[q];
+            Point position(agent->xPos.get(), agent->yPos.get());
+            const WayPoint &wayPoint = agent->getWayPoint();
+            Point lowerLeft, upperRight;
+            getSearchRectangle(position, wayPoint, distanceInFront, distanceBehind, lowerLeft, upperRight);
+            report.numNearbyQueries++;
+
+            for (std::size_t i = 0; i < state.implementations.size(); i++)
+            {
+                results[i].clear();
+                state.implementations[i].second->nearbyAgents(position, wayPoint, distanceInFront, distanceBehind, agent, results[i]);
+                std::sort(results[i].begin(), results[i].end());
+            }
+
+            bool mismatch = false;
+            for (std::size_t i = 1; i < numRectImpls; i++)
+            {
+                AgentList differences;
+                std::set_symmetric_difference(results[0].begin(), results[0].end(), results[i].begin(), results[i].end(),
+                                              std::back_inserter(differences));
+                for (AgentList::const_iterator it = differences.begin(); it != differences.end(); ++it)
+                {
+                    if (isOnBorder(static_cast<const ReplayAgent *> (*it), lowerLeft, upperRight))
+                    {
+                        report.numBorderDifferences++;
+                    }
+                    else
+                    {
+                        mismatch = true;
+                    }
+                }
+            }
+
+            expected.clear();
+            findNearbyOnLanes(present, position, wayPoint, distanceInFront, distanceBehind, expected);
+            std::sort(expected.begin(), expected.end());
+            mismatch = mismatch || (expected != results[numRectImpls]);
+            report.numLaneOnly += countMissing(results[numRectImpls], results[0]);
+            report.numRectOnly += countMissing(results[0], results[numRectImpls]);
+
+            if (mismatch)
+            {
+                report.numMismatches++;
+                if (report.mismatches.size() < MAX_DESCRIBED_MISMATCHES)
+                {
+                    std::stringstream msg;
+                    msg << "frame " << frameNo << ", nearbyAgents of agent " << agent->getId() << ":";
+                    for (std::size_t i = 0; i < state.implementations.size(); i++)
+                    {
+                        msg << " " << state.implementations[i].first << " " << results[i].size();
+                    }
+                    msg << ", expected from the lane index " << expected.size();
+                    report.mismatches.push_back(msg.str());
+                }
+            }
+        }
+
+        stride = std::max<std::size_t>(1, present.size() / MAX_RECT_QUERIES_PER_FRAME);
+        for (std::size_t q = 0; q < present.size(); q += stride)
+        {
+            const ReplayAgent *agent = present[q];
+            Point lowerLeft(agent->xPos.get() - distanceInFront, agent->yPos.get() - distanceInFront);
+            Point upperRight(agent->xPos.get() + distanceInFront, agent->yPos.get() + distanceInFront);
+            report.numRectQueries++;
+
+            for (std::size_t i = 0; i < state.implementations.size(); i++)
+            {
+                results[i] = state.implementations[i].second->agentsInRect(lowerLeft, upperRight, agent);
+                std::sort(results[i].begin(), results[i].end());
+            }
+
+            bool mismatch = false;
+            for (std::size_t i = 1; i < state.implementations.size(); i++)
+            {
+                AgentList differences;
+                std::set_symmetric_difference(results[0].begin(), results[0].end(), results[i].begin(), results[i].end(),
+                                              std::back_inserter(differences));
+                for (AgentList::const_iterator it = differences.begin(); it != differences.end(); ++it)
+                {
+                    if (isOnBorder(static_cast<const ReplayAgent *> (*it), lowerLeft, upperRight))
+                    {
+                        report.numBorderDifferences++;
+                    }
+                    else
+                    {
+                        mismatch = true;
+                    }
+                }
+            }
+
+            if (mismatch)
+            {
+                report.numMismatches++;
+                if (report.mismatches.size() < MAX_DESCRIBED_MISMATCHES)
+                {
+                    std::stringstream msg;
+                    msg << "frame " << frameNo << ", agentsInRect around agent " << agent->getId() << ":";
+                    for (std::size_t i = 0; i < state.implementations.size(); i++)
+                    {
+                        msg << " " << state.implementations[i].first << " " << results[i].size();
+                    }
+                    report.mismatches.push_back(msg.str());
+                }
+            }
+        }
+    }
+
+    return report;
+}
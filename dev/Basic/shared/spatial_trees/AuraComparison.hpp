@@ -0,0 +1,178 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+
+namespace sim_mob
+{
+
+class Entity;
+struct WayPoint;
+
+/**
+ * Position of an agent when the spatial index was updated, as recorded in a trace for AuraComparison.
+ */
+struct AuraSample
+{
+    AuraSample() : agentId(0), x(0), y(0), wayPointType(NOT_ON_LANE), wayPointId(0), distance(0)
+    {
+    }
+
+    /**Kinds of way points the agent can be on*/
+    static const char NOT_ON_LANE = '-';
+    static const char ON_LANE = 'L';
+    static const char ON_TURNING_PATH = 'T';
+
+    unsigned int agentId;
+
+    /**Position of the agent, as indexed by the 2-D implementations*/
+    int x;
+    int y;
+
+    /**NOT_ON_LANE, ON_LANE or ON_TURNING_PATH*/
+    char wayPointType;
+
+    /**Id of the lane or the turning path*/
+    unsigned int wayPointId;
+
+    /**Distance covered on the lane or the turning path*/
+    double distance;
+};
+
+/**The positions of all the agents indexed by one update*/
+typedef std::vector<AuraSample> AuraFrame;
+
+/**
+ * Reading and writing of traces of agent positions.
+ *
+ * A trace is a text file with one block per update of the spatial index: a line "frame <number of agents>", followed
+ * by one line per agent "<agent id> <x> <y> <way point type> <way point id> <distance>".
+ */
+class AuraTrace
+{
+public:
+    /**
+     * Samples the positions of the agents which the spatial index is about to index
+     *
+     * @param agents all the agents (typically Agent::all_agents)
+     * @param removedAgentPointers the agents being removed, which are not indexed
+     * @param frame output positions
+     */
+    static void sampleAgents(const std::set<Entity *> &agents, const std::set<Entity *> &removedAgentPointers, AuraFrame &frame);
+
+    /**
+     * Writes a frame to a trace
+     */
+    static void writeFrame(std::ostream &os, const AuraFrame &frame);
+
+    /**
+     * Reads the next frame of a trace
+     *
+     * @return false, if there are no more frames
+     */
+    static bool readFrame(std::istream &is, AuraFrame &frame);
+
+    /**
+     * Reads all the frames of a trace file
+     */
+    static void readTrace(const std::string &fileName, std::vector<AuraFrame> &frames);
+};
+
+/**
+ * Replays a trace of agent positions through the AuraManager implementations and checks that their results agree.
+ *
+ * Every frame updates all the implementations with the recorded positions (agents which are no longer in the frame are
+ * passed as removed agents for one update), then every agent on a lane queries the agents nearby, as a driver does, and
+ * some rectangles are queried with agentsInRect(). The implementations answering with the same 2-D semantics (R*-tree,
+ * RDU tree, packing tree and incremental tree) must return the same agents; the differences on the border of the
+ * search rectangle, where they round the coordinates differently, are counted apart. The lane index must return the
+ * same agents as the others for agentsInRect(), and the same agents as a brute force search with the semantics of
+ * LaneAuraManager for nearbyAgents(); the number of agents it returns which the 2-D implementations do not, and the
+ * other way round, is reported for information. The Sim-Tree is left out, as it needs a tree structure file matching
+ * the network.
+ */
+class AuraComparison
+{
+public:
+    /**
+     * Finds the lane or the turning path of a sample
+     *
+     * @return false, if there is no such way point
+     */
+    typedef boost::function<bool(char wayPointType, unsigned int wayPointId, WayPoint &wayPoint)> WayPointResolver;
+
+    /**Outcome of a replay*/
+    struct Report
+    {
+        Report() : numFrames(0), numNearbyQueries(0), numRectQueries(0), numMismatches(0), numBorderDifferences(0),
+            numLaneOnly(0), numRectOnly(0), numUnresolved(0)
+        {
+        }
+
+        unsigned int numFrames;
+        unsigned int numNearbyQueries;
+        unsigned int numRectQueries;
+
+        /**Number of queries whose results differ where they should not*/
+        unsigned int numMismatches;
+
+        /**Number of agents on the border of a search rectangle returned by some of the 2-D implementations only*/
+        unsigned int numBorderDifferences;
+
+        /**Number of agents returned by nearbyAgents() of the lane index only, and of the 2-D implementations only*/
+        unsigned long numLaneOnly;
+        unsigned long numRectOnly;
+
+        /**Number of samples whose way point could not be found; they are replayed as not being on a lane*/
+        unsigned long numUnresolved;
+
+        /**Descriptions of the first mismatches*/
+        std::vector<std::string> mismatches;
+
+        bool matches() const
+        {
+            return numMismatches == 0;
+        }
+
+        void print(std::ostream &os) const;
+    };
+
+    /**Number of mismatches described in the report*/
+    static const std::size_t MAX_DESCRIBED_MISMATCHES = 20;
+
+    /**
+     * @param resolveWayPoint finds the lanes and turning paths of the samples
+     * @param numThreads number of threads updating the implementations which update on several threads
+     * @param distanceInFront forward distance of the nearbyAgents() queries
+     * @param distanceBehind backward distance of the nearbyAgents() queries
+     */
+    AuraComparison(const WayPointResolver &resolveWayPoint, unsigned int numThreads = 1, double distanceInFront = 150,
+                   double distanceBehind = 50);
+
+    /**
+     * Replays the frames. Agent::all_agents is replaced by the replayed agents during the replay, so it must not be
+     * run during a simulation.
+     */
+    Report replay(const std::vector<AuraFrame> &frames) const;
+
+    /**
+     * Finds the lanes and turning paths of the samples in the road network
+     */
+    static bool resolveNetworkWayPoint(char wayPointType, unsigned int wayPointId, WayPoint &wayPoint);
+
+private:
+    WayPointResolver resolveWayPoint;
+    unsigned int numThreads;
+    double distanceInFront;
+    double distanceBehind;
+};
+
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <set>
+#include <vector>
 
 #include "metrics/Length.hpp"
 
@@ -53,6 +54,24 @@ public:
     ///Return Agents near to a given Position, with offsets (and Lane) taken into account.
     virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                     const sim_mob::Agent *refAgent) const = 0;
+
+    ///Append the Agents near to a given Position to result, reusing the storage of the caller. Implementations which
+    ///can fill result directly should override this; by default, the result of the above method is copied.
+
+    virtual void nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                              const sim_mob::Agent *refAgent, std::vector<Agent const *> &result) const
+    {
+        std::vector<Agent const *> agents = nearbyAgents(position, wayPoint, distanceInFront, distanceBehind, refAgent);
+        result.insert(result.end(), agents.begin(), agents.end());
+    }
+
+    ///Wall time (in seconds) of the last update() spent on several threads. The rest of the update ran on the
+    ///calling thread alone. Zero for implementations updating on a single thread.
+
+    virtual double getLastParallelSeconds() const
+    {
+        return 0.0;
+    }
 };
 
 }
@@ -0,0 +1,389 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "IncrementalTree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono.hpp>
+
+#include "util/threadpool/WorkStealingPool.hpp"
+
+using namespace sim_mob;
+
+namespace bgi = boost::geometry::index;
+
+namespace
+{
+/** number of entities per chunk of the parallel phase */
+const std::size_t CHUNK_SIZE = 512;
+
+/** fewer entities per thread are located on fewer threads, as handing them over would cost more than it saves */
+const std::size_t MIN_ENTITIES_PER_THREAD = 4096;
+
+double secondsSince(const boost::chrono::steady_clock::time_point& start)
+{
+    return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+}
+}
+
+/** orders slots by x */
+struct IncrementalTree::CompareX
+{
+    explicit CompareX(const std::vector<Slot>& slots) : slots(slots)
+    {
+    }
+
+    bool operator()(std::size_t a, std::size_t b) const
+    {
+        return slots[a].x < slots[b].x;
+    }
+
+    const std::vector<Slot>& slots;
+};
+
+/** orders slots by y */
+struct IncrementalTree::CompareY
+{
+    explicit CompareY(const std::vector<Slot>& slots) : slots(slots)
+    {
+    }
+
+    bool operator()(std::size_t a, std::size_t b) const
+    {
+        return slots[a].y < slots[b].y;
+    }
+
+    const std::vector<Slot>& slots;
+};
+
+const float IncrementalTree::DEFAULT_MARGIN = 5.0f;
+const double IncrementalTree::DEFAULT_REPACK_THRESHOLD = 0.25;
+const std::size_t IncrementalTree::NONE = static_cast<std::size_t>(-1);
+
+IncrementalTree::IncrementalTree(std::size_t numThreads, float margin, double repackThreshold) :
+        numThreads(numThreads), margin(margin), repackThreshold(repackThreshold), movesSinceRepack(0), updateCount(0)
+{
+    if (numThreads == 0 || margin < 0)
+    {
+        throw std::runtime_error("IncrementalTree: number of threads must be positive and margin non negative");
+    }
+    pool.reset(new WorkStealingPool(numThreads));
+}
+
+IncrementalTree::~IncrementalTree()
+{
+}
+
+void IncrementalTree::update(const std::vector<Entity*>& entities, const Locator& locate)
+{
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    updateCount++;
+    lastUpdate = UpdateStats();
+
+    // parallel phase: read the positions, find the agents which left their leaf and the leaves they are now in
+    std::size_t threads = getNumThreads(entities.size());
+    located.resize(entities.size());
+    workerResults.resize(threads);
+    for (std::vector<WorkerResult>::iterator it = workerResults.begin(); it != workerResults.end(); ++it)
+    {
+        it->moved.clear();
+        it->added.clear();
+        it->kept = 0;
+    }
+    pool->run(entities.size(), CHUNK_SIZE, threads, boost::bind(&IncrementalTree::locateChunks, this, _1, _2,
+            boost::cref(entities), boost::cref(locate), !leaves.empty()));
+
+    lastUpdate.numThreads = threads;
+    if (threads > 1)
+    {
+        lastUpdate.parallelSeconds = secondsSince(start);
+    }
+
+    for (std::vector<WorkerResult>::const_iterator it = workerResults.begin(); it != workerResults.end(); ++it)
+    {
+        lastUpdate.numKept += it->kept;
+        lastUpdate.numMoved += it->moved.size();
+        lastUpdate.numAdded += it->added.size();
+    }
+    lastUpdate.numRemoved = slotOf.size() - lastUpdate.numKept - lastUpdate.numMoved;
+    lastUpdate.numAgents = lastUpdate.numKept + lastUpdate.numMoved + lastUpdate.numAdded;
+
+    // serial phase: move the agents between leaves, or build the leaves again
+    std::size_t changes = lastUpdate.numMoved + lastUpdate.numAdded + lastUpdate.numRemoved;
+    movesSinceRepack += lastUpdate.numMoved + lastUpdate.numAdded;
+    lastUpdate.repacked = changes > 0 && (leaves.empty() || changes > repackThreshold * lastUpdate.numAgents
+            || movesSinceRepack > lastUpdate.numAgents);
+    bool updateLeaves = !lastUpdate.repacked;
+
+    if (lastUpdate.numRemoved > 0)
+    {
+        removeStale(updateLeaves);
+    }
+    for (std::vector<WorkerResult>::const_iterator it = workerResults.begin(); it != workerResults.end(); ++it)
+    {
+        for (std::vector<std::size_t>::const_iterator idx = it->moved.begin(); idx != it->moved.end(); ++idx)
+        {
+            if (updateLeaves)
+            {
+                placeSlot(located[*idx].slot, located[*idx].leaf);
+            }
+        }
+        for (std::vector<std::size_t>::const_iterator idx = it->added.begin(); idx != it->added.end(); ++idx)
+        {
+            std::size_t slot = addSlot(located[*idx]);
+            if (updateLeaves)
+            {
+                placeSlot(slot, located[*idx].leaf);
+            }
+        }
+    }
+    if (lastUpdate.repacked)
+    {
+        repack();
+    }
+
+    lastUpdate.totalSeconds = secondsSince(start);
+}
+
+std::size_t IncrementalTree::getNumThreads(std::size_t numItems) const
+{
+    return std::max<std::size_t>(1, std::min(numThreads, numItems / MIN_ENTITIES_PER_THREAD));
+}
+
+void IncrementalTree::locateChunks(WorkStealingPool& pool, std::size_t workerId, const std::vector<Entity*>& entities,
+        const Locator& locate, bool findLeaves)
+{
+    // only the slots of the agents handed to this thread are written; the map of slots and the leaves are only read
+    WorkerResult& result = workerResults[workerId];
+    std::size_t kept = 0;
+    std::size_t first, last;
+    while (pool.nextChunk(workerId, first, last))
+    {
+        for (std::size_t i = first; i != last; i++)
+        {
+            Located& loc = located[i];
+            loc.agent = locate(entities[i], loc.x, loc.y);
+            if (!loc.agent)
+            {
+                continue;
+            }
+
+            boost::unordered_map<const Agent*, std::size_t>::const_iterator found = slotOf.find(loc.agent);
+            if (found == slotOf.end())
+            {
+                loc.slot = NONE;
+                loc.leaf = findLeaves ? findLeaf(loc.x, loc.y) : NONE;
+                result.added.push_back(i);
+                continue;
+            }
+
+            loc.slot = found->second;
+            Slot& slot = slots[loc.slot];
+            slot.x = loc.x;
+            slot.y = loc.y;
+            slot.lastSeen = updateCount;
+            if (slot.leaf != NONE && boost::geometry::covered_by(TreePoint(loc.x, loc.y), leaves[slot.leaf].box))
+            {
+                kept++;
+            }
+            else
+            {
+                loc.leaf = findLeaves ? findLeaf(loc.x, loc.y) : NONE;
+                result.moved.push_back(i);
+            }
+        }
+    }
+    result.kept = kept;
+}
+
+std::size_t IncrementalTree::findLeaf(float x, float y) const
+{
+    Tree::const_query_iterator it = tree.qbegin(bgi::intersects(TreePoint(x, y)));
+    return it != tree.qend() ? it->second : NONE;
+}
+
+void IncrementalTree::removeStale(bool updateLeaves)
+{
+    for (std::size_t s = 0; s < slots.size(); s++)
+    {
+        Slot& slot = slots[s];
+        if (slot.agent && slot.lastSeen != updateCount)
+        {
+            if (updateLeaves && slot.leaf != NONE)
+            {
+                leaveLeaf(s);
+            }
+            slotOf.erase(slot.agent);
+            slot.agent = nullptr;
+            freeSlots.push_back(s);
+        }
+    }
+}
+
+std::size_t IncrementalTree::addSlot(const Located& loc)
+{
+    std::size_t s;
+    if (!freeSlots.empty())
+    {
+        s = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        s = slots.size();
+        slots.push_back(Slot());
+    }
+
+    Slot& slot = slots[s];
+    slot.agent = loc.agent;
+    slot.x = loc.x;
+    slot.y = loc.y;
+    slot.leaf = NONE;
+    slot.indexInLeaf = 0;
+    slot.lastSeen = updateCount;
+    slotOf[loc.agent] = s;
+    return s;
+}
+
+void IncrementalTree::placeSlot(std::size_t s, std::size_t leaf)
+{
+    Slot& slot = slots[s];
+    if (slot.leaf != NONE)
+    {
+        leaveLeaf(s);
+    }
+
+    if (leaf == NONE)
+    {
+        // a box extended earlier in this update may have taken in the position
+        leaf = findLeaf(slot.x, slot.y);
+    }
+    if (leaf == NONE)
+    {
+        std::vector<TreeValue> nearest;
+        tree.query(bgi::nearest(TreePoint(slot.x, slot.y), 1), std::back_inserter(nearest));
+        leaf = nearest.front().second;
+
+        TreeBox& box = leaves[leaf].box;
+        tree.remove(TreeValue(box, leaf));
+        boost::geometry::expand(box, TreeBox(TreePoint(slot.x - margin, slot.y - margin),
+                TreePoint(slot.x + margin, slot.y + margin)));
+        tree.insert(TreeValue(box, leaf));
+        lastUpdate.numExtended++;
+    }
+
+    std::vector<std::size_t>& members = leaves[leaf].members;
+    slot.leaf = leaf;
+    slot.indexInLeaf = members.size();
+    members.push_back(s);
+}
+
+void IncrementalTree::leaveLeaf(std::size_t s)
+{
+    Slot& slot = slots[s];
+    std::vector<std::size_t>& members = leaves[slot.leaf].members;
+    std::size_t lastMember = members.back();
+    members[slot.indexInLeaf] = lastMember;
+    slots[lastMember].indexInLeaf = slot.indexInLeaf;
+    members.pop_back();
+    slot.leaf = NONE;
+}
+
+void IncrementalTree::repack()
+{
+    std::vector<std::size_t> order;
+    order.reserve(slotOf.size());
+    for (std::size_t s = 0; s < slots.size(); s++)
+    {
+        if (slots[s].agent)
+        {
+            order.push_back(s);
+        }
+    }
+    std::sort(order.begin(), order.end(), CompareX(slots));
+
+    // vertical slices of about sqrt(number of leaves) leaves each
+    std::size_t numLeaves = (order.size() + LEAF_SIZE - 1) / LEAF_SIZE;
+    std::size_t leavesPerSlice = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(numLeaves))));
+    std::size_t sliceSize = std::max<std::size_t>(1, leavesPerSlice) * LEAF_SIZE;
+    std::size_t numSlices = (order.size() + sliceSize - 1) / sliceSize;
+    leaves.assign(numLeaves, Leaf());
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    std::size_t threads = std::min(getNumThreads(order.size()), std::max<std::size_t>(1, numSlices));
+    pool->run(numSlices, 1, threads, boost::bind(&IncrementalTree::packSlices, this, _1, _2, boost::ref(order),
+            sliceSize));
+    if (threads > 1)
+    {
+        lastUpdate.parallelSeconds += secondsSince(start);
+    }
+
+    std::vector<TreeValue> values;
+    values.reserve(leaves.size());
+    for (std::size_t l = 0; l < leaves.size(); l++)
+    {
+        values.push_back(TreeValue(leaves[l].box, l));
+    }
+    // the range constructor bulk loads the values with the packing algorithm
+    Tree packed(values.begin(), values.end());
+    tree.swap(packed);
+    movesSinceRepack = 0;
+}
+
+void IncrementalTree::packSlices(WorkStealingPool& pool, std::size_t workerId, std::vector<std::size_t>& order,
+        std::size_t sliceSize)
+{
+    std::size_t firstSlice, lastSlice;
+    while (pool.nextChunk(workerId, firstSlice, lastSlice))
+    {
+        for (std::size_t slice = firstSlice; slice != lastSlice; slice++)
+        {
+            std::vector<std::size_t>::iterator sliceBegin = order.begin() + slice * sliceSize;
+            std::vector<std::size_t>::iterator sliceEnd = order.begin() + std::min(order.size(), (slice + 1) * sliceSize);
+            std::sort(sliceBegin, sliceEnd, CompareY(slots));
+
+            for (std::vector<std::size_t>::iterator it = sliceBegin; it < sliceEnd; it += LEAF_SIZE)
+            {
+                std::size_t leafIdx = (it - order.begin()) / LEAF_SIZE;
+                Leaf& leaf = leaves[leafIdx];
+                leaf.members.assign(it, it + std::min<std::ptrdiff_t>(LEAF_SIZE, sliceEnd - it));
+
+                float left = slots[leaf.members.front()].x, right = left;
+                float bottom = slots[leaf.members.front()].y, top = bottom;
+                for (std::size_t m = 0; m < leaf.members.size(); m++)
+                {
+                    Slot& slot = slots[leaf.members[m]];
+                    slot.leaf = leafIdx;
+                    slot.indexInLeaf = m;
+                    left = std::min(left, slot.x);
+                    right = std::max(right, slot.x);
+                    bottom = std::min(bottom, slot.y);
+                    top = std::max(top, slot.y);
+                }
+                leaf.box = TreeBox(TreePoint(left - margin, bottom - margin), TreePoint(right + margin, top + margin));
+            }
+        }
+    }
+}
+
+void IncrementalTree::query(float left, float bottom, float right, float top, std::vector<const Agent*>& result) const
+{
+    TreeBox queryBox(TreePoint(left, bottom), TreePoint(right, top));
+    for (Tree::const_query_iterator it = tree.qbegin(bgi::intersects(queryBox)); it != tree.qend(); ++it)
+    {
+        const std::vector<std::size_t>& members = leaves[it->second].members;
+        for (std::vector<std::size_t>::const_iterator m = members.begin(); m != members.end(); ++m)
+        {
+            const Slot& slot = slots[*m];
+            if (slot.x >= left && slot.x <= right && slot.y >= bottom && slot.y <= top)
+            {
+                result.push_back(slot.agent);
+            }
+        }
+    }
+}
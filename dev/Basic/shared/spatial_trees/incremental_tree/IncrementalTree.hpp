@@ -0,0 +1,258 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace sim_mob
+{
+
+class Agent;
+class Entity;
+class WorkStealingPool;
+
+/**
+ * Spatial index of agent positions which is updated incrementally, with the per agent work spread over several
+ * threads.
+ *
+ * The agents are grouped in leaves of about LEAF_SIZE agents, built by Sort-Tile-Recursive packing: the agents are
+ * sorted by x and cut into vertical slices, and each slice is sorted by y and cut into leaves. The box of a leaf
+ * encloses the positions of its agents, widened by margin on every side, and the leaf boxes are kept in a small
+ * R-tree. Queries look up the leaves intersecting the query rectangle and check the positions of their agents.
+ *
+ * As long as an agent stays within the box of its leaf, an update only records its new position. An agent which
+ * left its leaf is moved to a leaf whose box contains its new position, or, if there is none, to the nearest leaf,
+ * whose box is then extended. An update runs in two phases:
+ * - the positions of all entities are read, checked against the boxes of their leaves, and the leaves of the
+ *   agents which left theirs are looked up, on up to numThreads threads;
+ * - the agents which changed leaves, appeared or disappeared are then moved between leaves on the calling thread.
+ *   If they make up more than repackThreshold of the agents, or if the leaves have degraded (as many agents have
+ *   changed leaves since they were built as there are agents), the leaves are built again from scratch instead.
+ *
+ * Queries may run concurrently with each other, but not with update().
+ */
+class IncrementalTree
+{
+public:
+    /**
+     * Reads the position of an entity.
+     * Returns the agent to index for the entity, setting x and y to its position, or null if the entity must not
+     * be indexed (e.g. it is not a spatial agent). Called concurrently from several threads.
+     */
+    typedef boost::function<const Agent* (Entity*, float&, float&)> Locator;
+
+    /** statistics of the last update */
+    struct UpdateStats
+    {
+        UpdateStats() : numAgents(0), numKept(0), numMoved(0), numAdded(0), numRemoved(0), numExtended(0),
+                repacked(false), numThreads(0), totalSeconds(0), parallelSeconds(0)
+        {}
+
+        /** number of agents indexed after the update */
+        std::size_t numAgents;
+        /** number of agents which stayed within the box of their leaf */
+        std::size_t numKept;
+        /** number of agents which left the box of their leaf */
+        std::size_t numMoved;
+        /** number of agents indexed for the first time */
+        std::size_t numAdded;
+        /** number of agents no longer indexed */
+        std::size_t numRemoved;
+        /** number of leaf boxes extended to take in an agent */
+        std::size_t numExtended;
+        /** true if the leaves were built again */
+        bool repacked;
+        /** number of threads of the parallel phases */
+        std::size_t numThreads;
+        /** wall time of the update */
+        double totalSeconds;
+        /** wall time of the phases run on several threads; 0 if they ran on the calling thread */
+        double parallelSeconds;
+    };
+
+    /** number of agents per leaf when the leaves are built */
+    static const std::size_t LEAF_SIZE = 32;
+
+    /** default widening of the leaf boxes, in the units of the positions (metres) */
+    static const float DEFAULT_MARGIN;
+
+    /** default fraction of changed agents beyond which the leaves are built again */
+    static const double DEFAULT_REPACK_THRESHOLD;
+
+    /**
+     * @param numThreads maximum number of threads of the parallel phases; at least 1
+     * @param margin widening of the leaf boxes on every side
+     * @param repackThreshold fraction of changed agents beyond which the leaves are built again
+     */
+    explicit IncrementalTree(std::size_t numThreads, float margin = DEFAULT_MARGIN,
+            double repackThreshold = DEFAULT_REPACK_THRESHOLD);
+
+    ~IncrementalTree();
+
+    /**
+     * Updates the index with the current positions of the given entities. Agents indexed before which are not
+     * returned by the locator for any of the entities are removed.
+     *
+     * @param entities entities to index; every entity must appear at most once
+     * @param locate reads the position of an entity
+     */
+    void update(const std::vector<Entity*>& entities, const Locator& locate);
+
+    /**
+     * Appends to result the agents whose position lies within the given rectangle (borders included).
+     */
+    void query(float left, float bottom, float right, float top, std::vector<const Agent*>& result) const;
+
+    /**
+     * @return number of agents indexed
+     */
+    std::size_t size() const
+    {
+        return slotOf.size();
+    }
+
+    /**
+     * @return statistics of the last update
+     */
+    const UpdateStats& getLastUpdateStats() const
+    {
+        return lastUpdate;
+    }
+
+private:
+    typedef boost::geometry::model::point<float, 2, boost::geometry::cs::cartesian> TreePoint;
+    typedef boost::geometry::model::box<TreePoint> TreeBox;
+    /** box of a leaf and its index */
+    typedef std::pair<TreeBox, std::size_t> TreeValue;
+    typedef boost::geometry::index::rtree<TreeValue, boost::geometry::index::quadratic<16> > Tree;
+
+    /** marks the absence of a slot or a leaf */
+    static const std::size_t NONE;
+
+    /** an indexed agent */
+    struct Slot
+    {
+        const Agent* agent;
+        /** position at the last update */
+        float x;
+        float y;
+        /** leaf of the agent, and index of the slot among the members of the leaf */
+        std::size_t leaf;
+        std::size_t indexInLeaf;
+        /** number of the last update which found the agent */
+        unsigned int lastSeen;
+    };
+
+    /** a group of nearby agents */
+    struct Leaf
+    {
+        /** encloses the positions of all members */
+        TreeBox box;
+        /** slots of the agents in the leaf */
+        std::vector<std::size_t> members;
+    };
+
+    /** result of the parallel phase for one entity */
+    struct Located
+    {
+        /** agent returned by the locator; null if the entity is not indexed */
+        const Agent* agent;
+        float x;
+        float y;
+        /** slot of the agent, if it was indexed before */
+        std::size_t slot;
+        /** a leaf whose box contains the position, for agents which need one; NONE if there is none */
+        std::size_t leaf;
+    };
+
+    /** entities found by one thread of the parallel phase */
+    struct WorkerResult
+    {
+        /** entities whose agent left the box of its leaf */
+        std::vector<std::size_t> moved;
+        /** entities whose agent is not indexed yet */
+        std::vector<std::size_t> added;
+        /** number of agents which stayed within the box of their leaf */
+        std::size_t kept;
+    };
+
+    struct CompareX;
+    struct CompareY;
+
+    /** @return number of threads for a parallel phase over numItems items */
+    std::size_t getNumThreads(std::size_t numItems) const;
+
+    /** parallel phase: reads the positions of the entities of the chunks handed to a thread */
+    void locateChunks(WorkStealingPool& pool, std::size_t workerId, const std::vector<Entity*>& entities,
+            const Locator& locate, bool findLeaves);
+
+    /** @return a leaf whose box contains the position, or NONE */
+    std::size_t findLeaf(float x, float y) const;
+
+    /** removes the agents which were not seen by the current update, taking them out of their leaves if needed */
+    void removeStale(bool updateLeaves);
+
+    /** @return a new slot for an agent, not in any leaf yet */
+    std::size_t addSlot(const Located& loc);
+
+    /** moves a slot to the leaf found for it, or to the nearest leaf, extending its box */
+    void placeSlot(std::size_t slot, std::size_t leaf);
+
+    /** takes a slot out of its leaf */
+    void leaveLeaf(std::size_t slot);
+
+    /** parallel phase of a repack: sorts the slots of the slices handed to a thread by y and cuts them into leaves */
+    void packSlices(WorkStealingPool& pool, std::size_t workerId, std::vector<std::size_t>& order,
+            std::size_t sliceSize);
+
+    /** builds the leaves again from all slots, with the Sort-Tile-Recursive algorithm */
+    void repack();
+
+    std::size_t numThreads;
+    float margin;
+    double repackThreshold;
+
+    /** threads of the parallel phases, kept from one update to the next */
+    boost::scoped_ptr<WorkStealingPool> pool;
+
+    /** boxes of the leaves */
+    Tree tree;
+
+    std::vector<Leaf> leaves;
+
+    /** indexed agents, indexed by slot; slots of removed agents have a null agent until they are reused */
+    std::vector<Slot> slots;
+
+    /** slots free for reuse */
+    std::vector<std::size_t> freeSlots;
+
+    /** slot of each indexed agent */
+    boost::unordered_map<const Agent*, std::size_t> slotOf;
+
+    /** per entity results of the parallel phase of the current update */
+    std::vector<Located> located;
+
+    /** per thread results of the parallel phase of the current update */
+    std::vector<WorkerResult> workerResults;
+
+    /** number of agents which changed leaves, or were added to a leaf, since the leaves were built */
+    std::size_t movesSinceRepack;
+
+    /** number of the current update */
+    unsigned int updateCount;
+
+    UpdateStats lastUpdate;
+};
+
+}
@@ -0,0 +1,68 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "IncrementalTreeAuraManager.hpp"
+
+#include <boost/bind.hpp>
+
+#include "entities/Agent.hpp"
+#include "geospatial/network/Point.hpp"
+#include "spatial_trees/shared_funcs.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::spatial;
+
+namespace
+{
+/**
+ * Locator of the agents to index: spatial agents which are not being removed.
+ * Only reads the entity and the (const) set of removed agents, so it can run on several threads.
+ */
+const Agent* locateAgent(Entity *entity, float &x, float &y, const std::set<Entity *> &removedAgentPointers)
+{
+    Agent *agent = dynamic_cast<Agent *> (entity);
+    if ((!agent) || agent->isNonspatial() || removedAgentPointers.find(agent) != removedAgentPointers.end())
+    {
+        return nullptr;
+    }
+
+    x = agent->xPos.get();
+    y = agent->yPos.get();
+    return agent;
+}
+}
+
+IncrementalTreeAuraManager::IncrementalTreeAuraManager(unsigned int numThreads) : tree(numThreads)
+{
+}
+
+IncrementalTreeAuraManager::~IncrementalTreeAuraManager()
+{
+}
+
+void IncrementalTreeAuraManager::update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers)
+{
+    entities.assign(Agent::all_agents.begin(), Agent::all_agents.end());
+    tree.update(entities, boost::bind(&locateAgent, _1, _2, _3, boost::cref(removedAgentPointers)));
+}
+
+std::vector<Agent const *> IncrementalTreeAuraManager::agentsInRect(const Point &lowerLeft, const Point &upperRight, const sim_mob::Agent *refAgent) const
+{
+    std::vector<Agent const *> agentsInRectangle;
+    tree.query(lowerLeft.getX(), lowerLeft.getY(), upperRight.getX(), upperRight.getY(), agentsInRectangle);
+    return agentsInRectangle;
+}
+
+std::vector<Agent const *> IncrementalTreeAuraManager::nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                                                                    const sim_mob::Agent *refAgent) const
+{
+    Point lowerLeft, upperRight;
+    getSearchRectangle(position, wayPoint, distanceInFront, distanceBehind, lowerLeft, upperRight);
+    return agentsInRect(lowerLeft, upperRight, nullptr);
+}
+
+double IncrementalTreeAuraManager::getLastParallelSeconds() const
+{
+    return tree.getLastUpdateStats().parallelSeconds;
+}
@@ -0,0 +1,79 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "spatial_trees/TreeImpl.hpp"
+#include "spatial_trees/incremental_tree/IncrementalTree.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * AuraManager implementation keeping the agents in an IncrementalTree.
+ *
+ * Unlike the other implementations, which rebuild or re-insert the whole index on a single thread every time step,
+ * the positions of the agents are checked on several threads and only the agents which left the box of their leaf
+ * are moved, so that the workers spend less time waiting for the update.
+ */
+class IncrementalTreeAuraManager : public TreeImpl
+{
+public:
+    /**
+     * @param numThreads number of threads updating the index; typically the number of workers moving the agents,
+     * which are idle during the update
+     */
+    explicit IncrementalTreeAuraManager(unsigned int numThreads);
+    virtual ~IncrementalTreeAuraManager();
+
+    /**
+     * Update all agents in the simulation.
+     *
+     * @param time_step simulation time_step
+     * @param removedAgentPointers temp container
+     *
+     * The pointers in removedAgentPointers will be deleted after this time tick; do *not* save them anywhere.
+     */
+    virtual void update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers);
+
+    /**
+     * Return a collection of agents that are located in the axially-aligned rectangle.
+     *
+     * @param lowerLeft The lower left corner of the axially-aligned search rectangle.
+     * @param upperRight The upper right corner of the axially-aligned search rectangle.
+     * @param refAgent Not used by this implementation.
+     *
+     * @return a collection of agents
+     * The caller is responsible to determine the "type" of each agent in the returned array.
+     */
+    virtual std::vector<Agent const *> agentsInRect(const Point &lowerLeft, const Point &upperRight, const sim_mob::Agent *refAgent) const;
+
+    /**
+     * Return a collection of agents that are on the left, right, front, and back of the specified
+     * position. The search rectangle is the same as that of the other implementations.
+     *
+     * @param position The center of the search rectangle.
+     * @param wayPoint The wapypoint (lane or turning path)
+     * @param distanceInFront The forward distance of the search rectangle.
+     * @param distanceBehind The backward distance of the search rectangle
+     * @param refAgent Not used by this implementation.
+     *
+     * @return a collection of agents
+     */
+    virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                                                    const sim_mob::Agent *refAgent) const;
+
+    virtual double getLastParallelSeconds() const;
+
+private:
+    IncrementalTree tree;
+
+    /** the agents of the current time step; kept to reuse its storage */
+    std::vector<Entity *> entities;
+};
+
+}
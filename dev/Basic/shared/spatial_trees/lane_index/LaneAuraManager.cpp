@@ -0,0 +1,258 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "LaneAuraManager.hpp"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono.hpp>
+
+#include "entities/Agent.hpp"
+#include "geospatial/network/Point.hpp"
+#include "geospatial/network/WayPoint.hpp"
+#include "spatial_trees/shared_funcs.hpp"
+#include "util/threadpool/WorkStealingPool.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::spatial;
+
+namespace
+{
+/** number of agents per chunk of the parallel phase locating the agents */
+const std::size_t CHUNK_SIZE = 512;
+
+/** number of lanes/turning paths per chunk of the parallel phase sorting the agents */
+const std::size_t SORT_CHUNK_SIZE = 64;
+
+/** fewer agents per thread are handled on fewer threads, as handing them over would cost more than it saves */
+const std::size_t MIN_AGENTS_PER_THREAD = 4096;
+
+double secondsSince(const boost::chrono::steady_clock::time_point &start)
+{
+    return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+}
+
+/** @return the spatial agent to index for the entity, or null */
+const Agent* getIndexedAgent(Entity *entity, const std::set<Entity *> &removedAgentPointers)
+{
+    Agent *agent = dynamic_cast<Agent *> (entity);
+    if ((!agent) || agent->isNonspatial() || removedAgentPointers.find(agent) != removedAgentPointers.end())
+    {
+        return nullptr;
+    }
+    return agent;
+}
+
+/** @return the lane or the turning path held by the way point */
+const void* getWayPointKey(const WayPoint &wayPoint)
+{
+    if (wayPoint.type == WayPoint::LANE)
+    {
+        return wayPoint.lane;
+    }
+    return wayPoint.turningPath;
+}
+
+/** Locator of all the agents to index */
+const Agent* locateAgent(Entity *entity, float &x, float &y, const std::set<Entity *> &removedAgentPointers)
+{
+    const Agent *agent = getIndexedAgent(entity, removedAgentPointers);
+    if (agent)
+    {
+        x = agent->xPos.get();
+        y = agent->yPos.get();
+    }
+    return agent;
+}
+
+/** Locator of the agents to index which are not on a lane or a turning path */
+const Agent* locateOffLaneAgent(Entity *entity, float &x, float &y, const std::set<Entity *> &removedAgentPointers)
+{
+    const Agent *agent = locateAgent(entity, x, y, removedAgentPointers);
+    WayPoint wayPoint;
+    double distance;
+    if (agent && agent->getLanePosition(wayPoint, distance))
+    {
+        return nullptr;
+    }
+    return agent;
+}
+}
+
+LaneAuraManager::LaneAuraManager(unsigned int numThreads) :
+        numThreads(numThreads), allAgents(numThreads), offLaneAgents(numThreads),
+        pool(new WorkStealingPool(numThreads)), lastParallelSeconds(0)
+{
+}
+
+LaneAuraManager::~LaneAuraManager()
+{
+}
+
+void LaneAuraManager::update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers)
+{
+    entities.assign(Agent::all_agents.begin(), Agent::all_agents.end());
+    lastParallelSeconds = 0;
+
+    //Find the lanes and turning paths of the agents
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    std::size_t threads = getNumThreads(entities.size());
+    workerLocated.resize(threads);
+    for (std::vector<std::vector<Located> >::iterator it = workerLocated.begin(); it != workerLocated.end(); ++it)
+    {
+        it->clear();
+    }
+
+    pool->run(entities.size(), CHUNK_SIZE, threads, boost::bind(&LaneAuraManager::locateChunks, this, _1, _2,
+            boost::cref(removedAgentPointers)));
+    if (threads > 1)
+    {
+        lastParallelSeconds += secondsSince(start);
+    }
+
+    //Hand the agents to their lanes and turning paths
+    for (std::vector<std::vector<LaneEntry> *>::iterator it = usedLanes.begin(); it != usedLanes.end(); ++it)
+    {
+        (*it)->clear();
+    }
+    usedLanes.clear();
+
+    std::size_t numOnLanes = 0;
+    for (std::vector<std::vector<Located> >::const_iterator it = workerLocated.begin(); it != workerLocated.end(); ++it)
+    {
+        for (std::vector<Located>::const_iterator loc = it->begin(); loc != it->end(); ++loc)
+        {
+            std::vector<LaneEntry> &entries = lanes[loc->wayPoint];
+            if (entries.empty())
+            {
+                usedLanes.push_back(&entries);
+            }
+            entries.push_back(loc->entry);
+        }
+        numOnLanes += it->size();
+    }
+
+    //Sort them along their lanes and turning paths
+    start = boost::chrono::steady_clock::now();
+    threads = std::min(getNumThreads(numOnLanes), std::max<std::size_t>(1, usedLanes.size() / SORT_CHUNK_SIZE));
+    pool->run(usedLanes.size(), SORT_CHUNK_SIZE, threads, boost::bind(&LaneAuraManager::sortChunks, this, _1, _2));
+    if (threads > 1)
+    {
+        lastParallelSeconds += secondsSince(start);
+    }
+
+    allAgents.update(entities, boost::bind(&locateAgent, _1, _2, _3, boost::cref(removedAgentPointers)));
+    offLaneAgents.update(entities, boost::bind(&locateOffLaneAgent, _1, _2, _3, boost::cref(removedAgentPointers)));
+    lastParallelSeconds += allAgents.getLastUpdateStats().parallelSeconds + offLaneAgents.getLastUpdateStats().parallelSeconds;
+}
+
+std::size_t LaneAuraManager::getNumThreads(std::size_t numItems) const
+{
+    return std::max<std::size_t>(1, std::min(numThreads, numItems / MIN_AGENTS_PER_THREAD));
+}
+
+void LaneAuraManager::locateChunks(WorkStealingPool &pool, std::size_t workerId, const std::set<Entity *> &removedAgentPointers)
+{
+    std::vector<Located> &located = workerLocated[workerId];
+    std::size_t first, last;
+    while (pool.nextChunk(workerId, first, last))
+    {
+        for (std::size_t i = first; i != last; i++)
+        {
+            const Agent *agent = getIndexedAgent(entities[i], removedAgentPointers);
+            WayPoint wayPoint;
+            Located loc;
+            if (agent && agent->getLanePosition(wayPoint, loc.entry.distance))
+            {
+                loc.wayPoint = getWayPointKey(wayPoint);
+                loc.entry.agent = agent;
+                located.push_back(loc);
+            }
+        }
+    }
+}
+
+void LaneAuraManager::sortChunks(WorkStealingPool &pool, std::size_t workerId)
+{
+    std::size_t first, last;
+    while (pool.nextChunk(workerId, first, last))
+    {
+        for (std::size_t i = first; i != last; i++)
+        {
+            std::sort(usedLanes[i]->begin(), usedLanes[i]->end());
+        }
+    }
+}
+
+std::vector<Agent const *> LaneAuraManager::agentsInRect(const Point &lowerLeft, const Point &upperRight, const sim_mob::Agent *refAgent) const
+{
+    std::vector<Agent const *> agentsInRectangle;
+    allAgents.query(lowerLeft.getX(), lowerLeft.getY(), upperRight.getX(), upperRight.getY(), agentsInRectangle);
+    return agentsInRectangle;
+}
+
+std::vector<Agent const *> LaneAuraManager::nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                                                         const sim_mob::Agent *refAgent) const
+{
+    std::vector<Agent const *> result;
+    nearbyAgents(position, wayPoint, distanceInFront, distanceBehind, refAgent, result);
+    return result;
+}
+
+void LaneAuraManager::nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                                   const sim_mob::Agent *refAgent, std::vector<Agent const *> &result) const
+{
+    std::size_t firstResult = result.size();
+    double length = getWayPointLength(wayPoint);
+    double distance = getDistanceAlong(position, wayPoint);
+
+    searchWayPoint(wayPoint, distance - distanceBehind, distance + distanceInFront, result);
+
+    WayPoint adjacent[2];
+    std::size_t numAdjacent = getAdjacentWayPoints(wayPoint, adjacent);
+    for (std::size_t i = 0; i < numAdjacent; i++)
+    {
+        //Same cross-section of the adjacent lane/turning path
+        double adjacentDistance = (length > 0) ? distance * getWayPointLength(adjacent[i]) / length : distance;
+        searchWayPoint(adjacent[i], adjacentDistance - distanceBehind, adjacentDistance + distanceInFront, result);
+    }
+
+    Point lowerLeft, upperRight;
+    getSearchRectangle(position, wayPoint, distanceInFront, distanceBehind, lowerLeft, upperRight);
+
+    if (distance - distanceBehind < 0 || distance + distanceInFront > length)
+    {
+        //The search goes on to the previous or next lanes/turning paths
+        allAgents.query(lowerLeft.getX(), lowerLeft.getY(), upperRight.getX(), upperRight.getY(), result);
+        std::sort(result.begin() + firstResult, result.end());
+        result.erase(std::unique(result.begin() + firstResult, result.end()), result.end());
+    }
+    else
+    {
+        offLaneAgents.query(lowerLeft.getX(), lowerLeft.getY(), upperRight.getX(), upperRight.getY(), result);
+    }
+}
+
+void LaneAuraManager::searchWayPoint(const WayPoint &wayPoint, double from, double to, std::vector<Agent const *> &result) const
+{
+    boost::unordered_map<const void *, std::vector<LaneEntry> >::const_iterator found = lanes.find(getWayPointKey(wayPoint));
+    if (found == lanes.end())
+    {
+        return;
+    }
+
+    const std::vector<LaneEntry> &entries = found->second;
+    LaneEntry bound;
+    bound.distance = from;
+    for (std::vector<LaneEntry>::const_iterator it = std::lower_bound(entries.begin(), entries.end(), bound);
+            it != entries.end() && it->distance <= to; ++it)
+    {
+        result.push_back(it->agent);
+    }
+}
+
+double LaneAuraManager::getLastParallelSeconds() const
+{
+    return lastParallelSeconds;
+}
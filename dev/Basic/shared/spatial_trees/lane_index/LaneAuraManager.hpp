@@ -0,0 +1,156 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "spatial_trees/TreeImpl.hpp"
+#include "spatial_trees/incremental_tree/IncrementalTree.hpp"
+
+namespace sim_mob
+{
+
+class WorkStealingPool;
+
+/**
+ * AuraManager implementation keeping the agents on each lane and turning path sorted by the distance they covered on
+ * it, as reported by Agent::getLanePosition().
+ *
+ * Nearly all the queries are made by drivers looking for the vehicles on their lane or turning path and on the
+ * adjacent ones, within some distance in front and behind. Such a query is answered by a binary search in the sorted
+ * agents of at most three lanes/turning paths instead of a search of the 2-D index of all agents:
+ * - the agents on the given lane/turning path whose distance lies within [d - distanceBehind, d + distanceInFront],
+ *   d being the distance of the given position along the lane/turning path;
+ * - the agents on the adjacent lanes/turning paths within the same window, d being scaled by the ratio of their
+ *   lengths, so that it is measured from the same cross-section;
+ * - the agents which are not on a lane (e.g. pedestrians), in the search rectangle of the other implementations.
+ * As the agents on the next or previous lanes/turning paths are not ordered along the same line, the whole search
+ * rectangle of the other implementations is searched as well whenever the window goes past the start or the end of
+ * the given lane/turning path. The result is therefore not the same as that of the other implementations: vehicles on
+ * other lanes which happen to lie within the rectangle are left out in the middle of a lane.
+ *
+ * The agents are also kept in an IncrementalTree, which answers agentsInRect().
+ */
+class LaneAuraManager : public TreeImpl
+{
+public:
+    /**
+     * @param numThreads number of threads updating the index; typically the number of workers moving the agents,
+     * which are idle during the update
+     */
+    explicit LaneAuraManager(unsigned int numThreads);
+    virtual ~LaneAuraManager();
+
+    /**
+     * Update all agents in the simulation.
+     *
+     * @param time_step simulation time_step
+     * @param removedAgentPointers temp container
+     *
+     * The pointers in removedAgentPointers will be deleted after this time tick; do *not* save them anywhere.
+     */
+    virtual void update(int time_step, const std::set<sim_mob::Entity *> &removedAgentPointers);
+
+    /**
+     * Return a collection of agents that are located in the axially-aligned rectangle.
+     *
+     * @param lowerLeft The lower left corner of the axially-aligned search rectangle.
+     * @param upperRight The upper right corner of the axially-aligned search rectangle.
+     * @param refAgent Not used by this implementation.
+     *
+     * @return a collection of agents
+     * The caller is responsible to determine the "type" of each agent in the returned array.
+     */
+    virtual std::vector<Agent const *> agentsInRect(const Point &lowerLeft, const Point &upperRight, const sim_mob::Agent *refAgent) const;
+
+    /**
+     * Return a collection of agents that are on the given lane or turning path and on the adjacent ones, within
+     * the given distances along them (see the description of the class).
+     *
+     * @param position The position of the agent searching.
+     * @param wayPoint The wapypoint (lane or turning path)
+     * @param distanceInFront The forward distance of the search.
+     * @param distanceBehind The backward distance of the search.
+     * @param refAgent Not used by this implementation.
+     *
+     * @return a collection of agents
+     */
+    virtual std::vector<Agent const *> nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                                                    const sim_mob::Agent *refAgent) const;
+
+    /**
+     * Same as above, but appends the agents to result.
+     */
+    virtual void nearbyAgents(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                              const sim_mob::Agent *refAgent, std::vector<Agent const *> &result) const;
+
+    virtual double getLastParallelSeconds() const;
+
+private:
+    /** an agent on a lane or a turning path */
+    struct LaneEntry
+    {
+        /** distance covered on the lane or turning path */
+        double distance;
+        const Agent *agent;
+
+        bool operator<(const LaneEntry &other) const
+        {
+            return distance < other.distance;
+        }
+    };
+
+    /** an agent found on a lane or a turning path by the parallel phase */
+    struct Located
+    {
+        /** the lane or the turning path */
+        const void *wayPoint;
+        LaneEntry entry;
+    };
+
+    /** @return number of threads for a parallel phase over numItems items */
+    std::size_t getNumThreads(std::size_t numItems) const;
+
+    /** parallel phase: finds the lanes/turning paths of the agents handed to a thread */
+    void locateChunks(WorkStealingPool &pool, std::size_t workerId, const std::set<Entity *> &removedAgentPointers);
+
+    /** parallel phase: sorts the agents of the lanes/turning paths handed to a thread */
+    void sortChunks(WorkStealingPool &pool, std::size_t workerId);
+
+    /** appends to result the agents of the lane/turning path whose distance lies within [from, to] */
+    void searchWayPoint(const WayPoint &wayPoint, double from, double to, std::vector<Agent const *> &result) const;
+
+    std::size_t numThreads;
+
+    /** all agents, for agentsInRect() and for the searches going past the end of a lane/turning path */
+    IncrementalTree allAgents;
+
+    /** the agents which are not on a lane or a turning path */
+    IncrementalTree offLaneAgents;
+
+    /** threads of the parallel phases, kept from one update to the next */
+    boost::scoped_ptr<WorkStealingPool> pool;
+
+    /** sorted agents of each lane and turning path, by Lane or TurningPath; emptied but kept for reuse */
+    boost::unordered_map<const void *, std::vector<LaneEntry> > lanes;
+
+    /** the lanes/turning paths with agents in the current time step */
+    std::vector<std::vector<LaneEntry> *> usedLanes;
+
+    /** the agents of the current time step; kept to reuse its storage */
+    std::vector<Entity *> entities;
+
+    /** per thread results of the parallel phase of the current update */
+    std::vector<std::vector<Located> > workerLocated;
+
+    /** wall time of the last update spent on several threads */
+    double lastParallelSeconds;
+};
+
+}
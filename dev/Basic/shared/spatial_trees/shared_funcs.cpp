@@ -4,6 +4,9 @@
 
 #include "shared_funcs.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #include "buffering/Vector2D.hpp"
@@ -190,3 +193,124 @@ void sim_mob::spatial::adjust(Point &p1, Point &p2, const Point &position, doubl
     p1 = Point(x, y);
 }
 
+
+void sim_mob::spatial::getSearchRectangle(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                                          Point &lowerLeft, Point &upperRight)
+{
+    // Find the stretch of the poly-line that <position> is in.
+    const std::vector<PolyPoint> &points = (wayPoint.type == WayPoint::LANE) ? wayPoint.lane->getPolyLine()->getPoints()
+                                                                              : wayPoint.turningPath->getPolyLine()->getPoints();
+
+    Point p1, p2;
+    for (size_t index = 0; index < points.size() - 1; index++)
+    {
+        p1 = points[index];
+        p2 = points[index + 1];
+        if (isInBetween(position, p1, p2))
+        {
+            break;
+        }
+    }
+
+    // Adjust <p1> and <p2>.  The current approach is simplistic.  <distanceInFront> and
+    // <distanceBehind> may extend beyond the stretch marked out by <p1> and <p2>.
+    adjust(p1, p2, position, distanceInFront, distanceBehind);
+
+    double halfWidth = getAdjacentPathWidth(wayPoint) / 2;
+    double left = std::min(p1.getX(), p2.getX()) - halfWidth;
+    double right = std::max(p1.getX(), p2.getX()) + halfWidth;
+    double bottom = std::min(p1.getY(), p2.getY()) - halfWidth;
+    double top = std::max(p1.getY(), p2.getY()) + halfWidth;
+
+    lowerLeft = Point(left, bottom);
+    upperRight = Point(right, top);
+}
+
+size_t sim_mob::spatial::getAdjacentWayPoints(const WayPoint &wayPoint, WayPoint adjacent[2])
+{
+    size_t count = 0;
+
+    if (wayPoint.type == WayPoint::LANE)
+    {
+        const Lane *lane = wayPoint.lane;
+        const std::vector<const Lane *> &lanes = lane->getParentSegment()->getLanes();
+        size_t index = lane->getLaneIndex();
+
+        if (index > 0)
+        {
+            adjacent[count++] = WayPoint(lanes[index - 1]);
+        }
+        if (index + 1 < lanes.size())
+        {
+            adjacent[count++] = WayPoint(lanes[index + 1]);
+        }
+    }
+    else
+    {
+        //Same choice of turnings as in getAdjacentPathWidth()
+        const TurningPath *turning = wayPoint.turningPath;
+        const TurningGroup *group = turning->getTurningGroup();
+
+        if (group->getNumTurningPaths() > 1)
+        {
+            const std::map<unsigned int, TurningPath *> *turnings = group->getTurningPaths(turning->getFromLaneId());
+            unsigned int laneId = (turnings->size() == 1) ? turning->getFromLaneId() : turning->getToLaneId();
+            unsigned int neighbours[2] = { laneId - 1, laneId + 1 };
+
+            for (size_t i = 0; i < 2; i++)
+            {
+                turnings = group->getTurningPaths(neighbours[i]);
+                if (turnings)
+                {
+                    adjacent[count++] = WayPoint(turnings->begin()->second);
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+double sim_mob::spatial::getWayPointLength(const WayPoint &wayPoint)
+{
+    return (wayPoint.type == WayPoint::LANE) ? wayPoint.lane->getLength() : wayPoint.turningPath->getLength();
+}
+
+double sim_mob::spatial::getDistanceAlong(const Point &position, const WayPoint &wayPoint)
+{
+    const std::vector<PolyPoint> &points = (wayPoint.type == WayPoint::LANE) ? wayPoint.lane->getPolyLine()->getPoints()
+                                                                              : wayPoint.turningPath->getPolyLine()->getPoints();
+
+    double covered = 0;
+    double bestDistance = 0;
+    double bestSquaredOffset = std::numeric_limits<double>::max();
+
+    for (size_t index = 0; index + 1 < points.size(); index++)
+    {
+        double xDiff = points[index + 1].getX() - points[index].getX();
+        double yDiff = points[index + 1].getY() - points[index].getY();
+        double squaredLength = xDiff * xDiff + yDiff * yDiff;
+        double length = sqrt(squaredLength);
+
+        //Closest point of the stretch, as a fraction of its length
+        double t = 0;
+        if (squaredLength > 0)
+        {
+            t = ((position.getX() - points[index].getX()) * xDiff + (position.getY() - points[index].getY()) * yDiff) / squaredLength;
+            t = std::max(0.0, std::min(1.0, t));
+        }
+
+        double xOffset = points[index].getX() + t * xDiff - position.getX();
+        double yOffset = points[index].getY() + t * yDiff - position.getY();
+        double squaredOffset = xOffset * xOffset + yOffset * yOffset;
+        if (squaredOffset < bestSquaredOffset)
+        {
+            bestSquaredOffset = squaredOffset;
+            bestDistance = covered + t * length;
+        }
+
+        covered += length;
+    }
+
+    return bestDistance;
+}
@@ -59,5 +59,46 @@ bool isInBetween(const sim_mob::Point &point, const sim_mob::Point &p1, const si
 // from <p1> to <p2>.
 void adjust(sim_mob::Point &p1, sim_mob::Point &p2, const sim_mob::Point &position, double distanceInFront, double distanceBehind);
 
+/**
+ * Calculates the search rectangle of a nearbyAgents() query: the stretch of the lane/turning path from
+ * distanceBehind behind position to distanceInFront in front of it, widened by the adjacent lanes/turning paths.
+ *
+ * @param position the position of the querying agent, on the lane/turning path
+ * @param wayPoint holds the lane or the turning path
+ * @param distanceInFront the forward distance of the search rectangle
+ * @param distanceBehind the backward distance of the search rectangle
+ * @param lowerLeft output lower left corner of the search rectangle
+ * @param upperRight output upper right corner of the search rectangle
+ */
+void getSearchRectangle(const sim_mob::Point &position, const sim_mob::WayPoint &wayPoint, double distanceInFront, double distanceBehind,
+                        sim_mob::Point &lowerLeft, sim_mob::Point &upperRight);
+
+/**
+ * Finds the lanes/turning paths on the left and right of the given lane/turning path, the same ones whose width is
+ * counted by getAdjacentPathWidth().
+ *
+ * @param wayPoint holds the lane or the turning path
+ * @param adjacent output adjacent lanes/turning paths
+ *
+ * @return the number of adjacent lanes/turning paths stored in adjacent (0 to 2)
+ */
+size_t getAdjacentWayPoints(const sim_mob::WayPoint &wayPoint, sim_mob::WayPoint adjacent[2]);
+
+/**
+ * @param wayPoint holds the lane or the turning path
+ * @return the length of the lane or the turning path
+ */
+double getWayPointLength(const sim_mob::WayPoint &wayPoint);
+
+/**
+ * Projects a position on the poly-line of a lane/turning path.
+ *
+ * @param position the position to project
+ * @param wayPoint holds the lane or the turning path
+ *
+ * @return the distance from the start of the poly-line to the point of the poly-line closest to position
+ */
+double getDistanceAlong(const sim_mob::Point &position, const sim_mob::WayPoint &wayPoint);
+
 }
 } 
@@ -94,70 +94,16 @@ std::vector<Agent const *> sim_mob::SimAuraManager::nearbyAgents(const Point &po
      * 2) upperRight
      */
 
-    // Find the stretch of the poly-line that <position> is in.
-    std::vector<PolyPoint> points;  
-    
-    if(wayPoint.type == WayPoint::LANE)
-    {
-        points = wayPoint.lane->getPolyLine()->getPoints();
-    }
-    else
-    {
-        points = wayPoint.turningPath->getPolyLine()->getPoints();
-    }
-    
-    Point p1, p2;
-    for (size_t index = 0; index < points.size() - 1; index++)
-    {
-        p1 = points[index];
-        p2 = points[index + 1];
-        if (isInBetween(position, p1, p2))
-            break;
-    }
-
-    // Adjust <p1> and <p2>.  The current approach is simplistic.  <distanceInFront> and
-    // <distanceBehind> may extend beyond the stretch marked out by <p1> and <p2>.
-    adjust(p1, p2, position, distanceInFront, distanceBehind);
+    Point lowerLeft, upperRight;
+    getSearchRectangle(position, wayPoint, distanceInFront, distanceBehind, lowerLeft, upperRight);
 
-    if (p1.getX() < 0 || p2.getX() < 0)
+    // the stretch itself (the rectangle without the adjacent lanes) must not reach negative x coordinates
+    if (lowerLeft.getX() + getAdjacentPathWidth(wayPoint) / 2 < 0)
     {
         std::vector<Agent const *> empty;
         return empty;
     }
 
-    // Calculate the search rectangle.  We use a quick and accurate method.  However the
-    // inaccuracy only makes the search rectangle bigger.
-    double left = 0, right = 0, bottom = 0, top = 0;
-    if (p1.getX() > p2.getX())
-    {
-        left = p2.getX();
-        right = p1.getX();
-    }
-    else
-    {
-        left = p1.getX();
-        right = p2.getX();
-    }
-    if (p1.getY() > p2.getY())
-    {
-        top = p1.getY();
-        bottom = p2.getY();
-    }
-    else
-    {
-        top = p2.getY();
-        bottom = p1.getY();
-    }
-
-    double halfWidth = getAdjacentPathWidth(wayPoint) / 2;
-    left -= halfWidth;
-    right += halfWidth;
-    top += halfWidth;
-    bottom -= halfWidth;
-
-    Point lowerLeft(left, bottom);
-    Point upperRight(right, top);
-
     return agentsInRect(lowerLeft, upperRight, nullptr);
 }
 
@@ -179,65 +125,8 @@ std::vector<Agent const *> sim_mob::SimAuraManager::agentsInRectBottomUpQuery(co
 std::vector<Agent const *> sim_mob::SimAuraManager::nearbyAgentsBottomUpQuery(const Point &position, const WayPoint &wayPoint, double distanceInFront, double distanceBehind,
                                                                               TreeItem* item) const
 {
-    // Find the stretch of the poly-line that <position> is in.
-    std::vector<PolyPoint> points;
-    
-    if(wayPoint.type == WayPoint::LANE)
-    {
-        points = wayPoint.lane->getPolyLine()->getPoints();
-    }
-    else
-    {
-        points = wayPoint.turningPath->getPolyLine()->getPoints();
-    }
-    
-    Point p1, p2;
-    for (size_t index = 0; index < points.size() - 1; index++)
-    {
-        p1 = points[index];
-        p2 = points[index + 1];
-        if (isInBetween(position, p1, p2))
-        {
-            break;
-        }
-    }
-
-    // Adjust <p1> and <p2>.  The current approach is simplistic.  <distanceInFront> and
-    // <distanceBehind> may extend beyond the stretch marked out by <p1> and <p2>.
-    adjust(p1, p2, position, distanceInFront, distanceBehind);
-
-    // Calculate the search rectangle.  We use a quick and accurate method.  However the
-    // inaccuracy only makes the search rectangle bigger.
-    double left = 0, right = 0, bottom = 0, top = 0;
-    if (p1.getX() > p2.getX())
-    {
-        left = p2.getX();
-        right = p1.getX();
-    }
-    else
-    {
-        left = p1.getX();
-        right = p2.getX();
-    }
-    if (p1.getY() > p2.getY())
-    {
-        top = p1.getY();
-        bottom = p2.getY();
-    }
-    else
-    {
-        top = p2.getY();
-        bottom = p1.getY();
-    }
-
-    double halfWidth = getAdjacentPathWidth(wayPoint) / 2;
-    left -= halfWidth;
-    right += halfWidth;
-    top += halfWidth;
-    bottom -= halfWidth;
-
-    Point lowerLeft(left, bottom);
-    Point upperRight(right, top);
+    Point lowerLeft, upperRight;
+    getSearchRectangle(position, wayPoint, distanceInFront, distanceBehind, lowerLeft, upperRight);
 
     return agentsInRectBottomUpQuery(lowerLeft, upperRight, item);
 }
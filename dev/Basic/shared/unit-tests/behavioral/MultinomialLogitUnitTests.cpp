@@ -0,0 +1,88 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "behavioral/MultinomialLogit.hpp"
+
+#include "MultinomialLogitUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::MultinomialLogitUnitTests);
+
+void unit_tests::MultinomialLogitUnitTests::test_ProbabilitiesAndLogsum()
+{
+    std::vector<double> utility;
+    utility.push_back(0.0);
+    utility.push_back(std::log(3.0));
+    utility.push_back(5.0);
+    utility.push_back(std::numeric_limits<double>::quiet_NaN());
+    std::vector<int> availability;
+    availability.push_back(1);
+    availability.push_back(1);
+    availability.push_back(0);
+    availability.push_back(1);
+
+    std::vector<double> probability;
+    double evSum = MultinomialLogit::computeProbabilities(utility, availability, probability);
+    CPPUNIT_ASSERT_EQUAL(utility.size(), probability.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, evSum, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, probability[0], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.75, probability[1], 1e-12);
+    CPPUNIT_ASSERT_EQUAL(0.0, probability[2]);
+    CPPUNIT_ASSERT_EQUAL(0.0, probability[3]);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::log(4.0), MultinomialLogit::computeLogsum(utility, availability), 1e-12);
+
+    availability.assign(availability.size(), 0);
+    CPPUNIT_ASSERT(std::isinf(MultinomialLogit::computeLogsum(utility, availability)));
+
+    availability.pop_back();
+    CPPUNIT_ASSERT_THROW(MultinomialLogit::computeLogsum(utility, availability), std::runtime_error);
+}
+
+void unit_tests::MultinomialLogitUnitTests::test_MakeChoice()
+{
+    std::vector<double> probability;
+    probability.push_back(0.0);
+    probability.push_back(0.25);
+    probability.push_back(0.0);
+    probability.push_back(0.75);
+
+    CPPUNIT_ASSERT_EQUAL(2, MultinomialLogit::makeChoice(probability, 0.1));
+    CPPUNIT_ASSERT_EQUAL(2, MultinomialLogit::makeChoice(probability, 0.25));
+    CPPUNIT_ASSERT_EQUAL(4, MultinomialLogit::makeChoice(probability, 0.3));
+    CPPUNIT_ASSERT_EQUAL(4, MultinomialLogit::makeChoice(probability, 0.9999));
+
+    probability.clear();
+    CPPUNIT_ASSERT_THROW(MultinomialLogit::makeChoice(probability, 0.5), std::runtime_error);
+}
+
+void unit_tests::MultinomialLogitUnitTests::test_RandomSequence()
+{
+    const double d40 = 1099511627776.0;
+    LogitRandom random;
+    CPPUNIT_ASSERT_EQUAL(1396453061.0 / d40, random.next());
+    CPPUNIT_ASSERT_EQUAL(522692289433.0 / d40, random.next());
+    CPPUNIT_ASSERT_EQUAL(418620711613.0 / d40, random.next());
+
+    //seed 0 is the initial state of the script
+    random.seed(0);
+    CPPUNIT_ASSERT_EQUAL(0.0, random.getStateHigh());
+    CPPUNIT_ASSERT_EQUAL(1.0, random.getStateLow());
+    CPPUNIT_ASSERT_EQUAL(1396453061.0 / d40, random.next());
+
+    //the same seed restarts the same sequence; the low bit of the state is always set
+    LogitRandom other;
+    random.seed(0x123456789AULL);
+    other.seed(0x123456789BULL);
+    CPPUNIT_ASSERT_EQUAL(double(0x12345), random.getStateHigh());
+    CPPUNIT_ASSERT_EQUAL(double(0x6789B), random.getStateLow());
+    for (int i = 0; i < 10; i++) {
+        CPPUNIT_ASSERT_EQUAL(other.next(), random.next());
+    }
+}
@@ -0,0 +1,36 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the multinomial logit helpers in Basic/behavioral, which must agree with logit.lua.
+ */
+class MultinomialLogitUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Probabilities and logsums of available alternatives; unavailable and NaN utility alternatives get zero.
+    void test_ProbabilitiesAndLogsum();
+
+    ///Choices follow the cumulative probabilities.
+    void test_MakeChoice();
+
+    ///The random sequence must be the one of the script generator, also after seeding.
+    void test_RandomSequence();
+
+private:
+    CPPUNIT_TEST_SUITE(MultinomialLogitUnitTests);
+        CPPUNIT_TEST(test_ProbabilitiesAndLogsum);
+        CPPUNIT_TEST(test_MakeChoice);
+        CPPUNIT_TEST(test_RandomSequence);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,181 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "behavioral/PredayDataCache.hpp"
+
+#include "PredayDataCacheUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PredayDataCacheUnitTests);
+
+namespace {
+const char* TEST_FILE = "preday_data_cache_unit_test.bin";
+const std::string SOURCE_KEY = "demand_schema=demand.;taz_table=demand.taz:2";
+
+///Two zones (ids 1 and 2, codes 10 and 20), one node per zone, one unavailable OD pair and costs between the zones.
+struct TestData
+{
+    PredayDataCache::ZoneMap zones;
+    std::unordered_set<int> zonesWithoutNode;
+    PredayDataCache::ZoneNodeMap zoneNodes;
+    std::vector<OD_Pair> unavailableODs;
+    SkimMatrix amCosts;
+    SkimMatrix pmCosts;
+    SkimMatrix opCosts;
+
+    ~TestData()
+    {
+        for (PredayDataCache::ZoneMap::iterator it = zones.begin(); it != zones.end(); ++it) {
+            delete it->second;
+        }
+        for (PredayDataCache::ZoneNodeMap::iterator it = zoneNodes.begin(); it != zoneNodes.end(); ++it) {
+            for (std::vector<ZoneNodeParams*>::iterator ndIt = it->second.begin(); ndIt != it->second.end(); ++ndIt) {
+                delete *ndIt;
+            }
+        }
+    }
+};
+
+void fillData(TestData& data)
+{
+    for (int id = 1; id <= 2; ++id) {
+        ZoneParams* zone = new ZoneParams();
+        zone->setZoneId(id);
+        zone->setZoneCode(id * 10);
+        zone->setArea(1.5 * id);
+        zone->setPopulation(1000.0 * id);
+        zone->setShop(0.0);
+        zone->setCentralDummy(id == 1);
+        zone->setParkingRate(2.0);
+        zone->setResidentWorkers(300.0);
+        zone->setEmployment(400.0 * id);
+        zone->setTotalEnrollment(50.0);
+        zone->setResidentStudents(60.0);
+        zone->setCbdDummy(id == 2);
+        data.zones[id] = zone;
+
+        ZoneNodeParams* node = new ZoneNodeParams();
+        node->setZone(id * 10);
+        node->setNodeId(100 + id);
+        node->setNodeType(1);
+        node->setSourceNode(id == 1);
+        node->setSinkNode(false);
+        node->setBusTerminusNode(id == 2);
+        data.zoneNodes[id * 10].push_back(node);
+    }
+    data.zonesWithoutNode.insert(30);
+    data.unavailableODs.push_back(OD_Pair(10, 20));
+
+    std::vector<int> codes;
+    codes.push_back(10);
+    codes.push_back(20);
+    SkimMatrix* matrices[3] = { &data.amCosts, &data.pmCosts, &data.opCosts };
+    for (int i = 0; i < 3; ++i) {
+        matrices[i]->initialize(codes);
+        CostParams costs = CostParams();
+        costs.setOriginZone(10);
+        costs.setDestinationZone(20);
+        costs.setDistance(5.0 + i);
+        costs.setCarIvt(0.25 * i);
+        matrices[i]->setCosts(costs);
+    }
+}
+
+void save(const TestData& data, const std::string& key)
+{
+    PredayDataCache::save(TEST_FILE, key, data.zones, data.zonesWithoutNode, data.zoneNodes, data.unavailableODs,
+            data.amCosts, data.pmCosts, data.opCosts);
+}
+}
+
+void unit_tests::PredayDataCacheUnitTests::test_RoundTrip()
+{
+    {
+        TestData data;
+        fillData(data);
+        save(data, SOURCE_KEY);
+    }
+
+    TestData loaded;
+    {
+        PredayDataCache cache;
+        std::string reason;
+        CPPUNIT_ASSERT_MESSAGE(reason, cache.open(TEST_FILE, SOURCE_KEY, reason));
+        cache.loadZones(loaded.zones, loaded.zonesWithoutNode);
+        cache.loadZoneNodes(loaded.zoneNodes);
+        cache.loadUnavailableODs(loaded.unavailableODs);
+        cache.loadCosts(loaded.amCosts, loaded.pmCosts, loaded.opCosts);
+    }
+
+    //the skims must stay valid after the cache is closed
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), loaded.zones.size());
+    const ZoneParams* zone = loaded.zones[2];
+    CPPUNIT_ASSERT_EQUAL(20, zone->getZoneCode());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, zone->getArea(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(800.0, zone->getEmployment(), 1e-9);
+    CPPUNIT_ASSERT_EQUAL(0, zone->getCentralDummy());
+    CPPUNIT_ASSERT_EQUAL(1, zone->getCbdDummy());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), loaded.zonesWithoutNode.count(30));
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), loaded.zoneNodes[20].size());
+    const ZoneNodeParams* node = loaded.zoneNodes[20].front();
+    CPPUNIT_ASSERT_EQUAL(102u, node->getNodeId());
+    CPPUNIT_ASSERT(!node->isSourceNode());
+    CPPUNIT_ASSERT(node->isBusTerminusNode());
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), loaded.unavailableODs.size());
+    CPPUNIT_ASSERT(loaded.unavailableODs.front() == OD_Pair(10, 20));
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, loaded.amCosts.at(10, 20).getDistance(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, loaded.opCosts.at(10, 20).getDistance(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, loaded.pmCosts.at(10, 20).getCarIvt(), 1e-6);
+    CPPUNIT_ASSERT(!loaded.pmCosts.contains(20, 10));
+
+    loaded.amCosts.clear();
+    loaded.pmCosts.clear();
+    loaded.opCosts.clear();
+    std::remove(TEST_FILE);
+}
+
+void unit_tests::PredayDataCacheUnitTests::test_Invalidation()
+{
+    PredayDataCache cache;
+    std::string reason;
+    std::remove(TEST_FILE);
+    CPPUNIT_ASSERT(!cache.open(TEST_FILE, SOURCE_KEY, reason));
+
+    {
+        TestData data;
+        fillData(data);
+        save(data, SOURCE_KEY);
+    }
+
+    //a change in the row count of a source table changes the key
+    CPPUNIT_ASSERT(!cache.open(TEST_FILE, "demand_schema=demand.;taz_table=demand.taz:3", reason));
+    CPPUNIT_ASSERT(!cache.isOpen());
+    CPPUNIT_ASSERT(cache.open(TEST_FILE, SOURCE_KEY, reason));
+    cache.close();
+
+    //flip one byte of the payload
+    {
+        std::fstream file(TEST_FILE, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        std::streamoff last = static_cast<std::streamoff>(file.tellg()) - 1;
+        file.seekg(last);
+        char byte = 0;
+        file.get(byte);
+        file.seekp(last);
+        file.put(byte ^ 0x1);
+    }
+    CPPUNIT_ASSERT(!cache.open(TEST_FILE, SOURCE_KEY, reason));
+    CPPUNIT_ASSERT(reason.find("checksum") != std::string::npos);
+
+    std::remove(TEST_FILE);
+}
@@ -0,0 +1,32 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the preday zone and skim cache in Basic/behavioral
+ */
+class PredayDataCacheUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Data exported to a cache file must be loaded back unchanged.
+    void test_RoundTrip();
+
+    ///Cache files with a different source key or with corrupted contents must be rejected.
+    void test_Invalidation();
+
+private:
+    CPPUNIT_TEST_SUITE(PredayDataCacheUnitTests);
+        CPPUNIT_TEST(test_RoundTrip);
+        CPPUNIT_TEST(test_Invalidation);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
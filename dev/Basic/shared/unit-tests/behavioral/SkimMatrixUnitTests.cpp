@@ -0,0 +1,161 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "behavioral/params/SkimMatrix.hpp"
+
+#include "SkimMatrixUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::SkimMatrixUnitTests);
+
+namespace {
+const char* TEST_FILE = "skim_matrix_unit_test.bin";
+
+CostParams makeCosts(int origin, int destination)
+{
+    CostParams costs = CostParams();
+    costs.setOriginZone(origin);
+    costs.setDestinationZone(destination);
+    costs.setDistance(origin + destination * 0.5);
+    costs.setCarCostErp(1.25);
+    costs.setCarIvt(origin * 0.1);
+    costs.setPubIvt(destination * 0.1);
+    costs.setPubWalkt(0.2);
+    costs.setPubWtt(0.3);
+    costs.setPubCost(2.5);
+    costs.setAvgTransfer(1);
+    costs.setPubOut(0.4);
+    return costs;
+}
+
+///Zone codes 10, 20, 30 with costs for every pair except the diagonal.
+void fillMatrix(SkimMatrix& matrix)
+{
+    std::vector<int> codes;
+    codes.push_back(10);
+    codes.push_back(20);
+    codes.push_back(30);
+    matrix.initialize(codes);
+    for (std::vector<int>::const_iterator org = codes.begin(); org != codes.end(); ++org) {
+        for (std::vector<int>::const_iterator dest = codes.begin(); dest != codes.end(); ++dest) {
+            if (*org != *dest) {
+                matrix.setCosts(makeCosts(*org, *dest));
+            }
+        }
+    }
+}
+
+void checkCosts(const SkimMatrix& matrix, int origin, int destination)
+{
+    CostParams expected = makeCosts(origin, destination);
+    SkimMatrix::Costs costs = matrix.at(origin, destination);
+    CPPUNIT_ASSERT_EQUAL(expected.getDistance(), costs.getDistance());
+    CPPUNIT_ASSERT_EQUAL(expected.getCarCostErp(), costs.getCarCostErp());
+    CPPUNIT_ASSERT_EQUAL(expected.getCarIvt(), costs.getCarIvt());
+    CPPUNIT_ASSERT_EQUAL(expected.getPubIvt(), costs.getPubIvt());
+    CPPUNIT_ASSERT_EQUAL(expected.getPubWalkt(), costs.getPubWalkt());
+    CPPUNIT_ASSERT_EQUAL(expected.getPubWtt(), costs.getPubWtt());
+    CPPUNIT_ASSERT_EQUAL(expected.getPubCost(), costs.getPubCost());
+    CPPUNIT_ASSERT_EQUAL(expected.getAvgTransfer(), costs.getAvgTransfer());
+    CPPUNIT_ASSERT_EQUAL(expected.getPubOut(), costs.getPubOut());
+}
+}
+
+void unit_tests::SkimMatrixUnitTests::test_Lookup()
+{
+    SkimMatrix matrix;
+    fillMatrix(matrix);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), matrix.getNumZones());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6), matrix.getNumODs());
+    checkCosts(matrix, 10, 30);
+    checkCosts(matrix, 30, 10);
+    CPPUNIT_ASSERT(!matrix.contains(20, 20));
+    CPPUNIT_ASSERT(!matrix.contains(20, 40));
+
+    try {
+        matrix.at(20, 20);
+        CPPUNIT_FAIL("Missing OD pair not detected.");
+    } catch (std::out_of_range& ex) { }
+    try {
+        matrix.at(40, 20);
+        CPPUNIT_FAIL("Unknown zone not detected.");
+    } catch (std::out_of_range& ex) { }
+
+    CPPUNIT_ASSERT(!matrix.setCosts(makeCosts(10, 40)));
+}
+
+void unit_tests::SkimMatrixUnitTests::test_ZoneIdOrder()
+{
+    //zone code -> zone id
+    boost::unordered_map<int, int> zoneIdLookup;
+    zoneIdLookup[500] = 3;
+    zoneIdLookup[7] = 1;
+    zoneIdLookup[42] = 2;
+
+    SkimMatrix matrix;
+    matrix.initialize(zoneIdLookup);
+    CPPUNIT_ASSERT_EQUAL(0, matrix.getZoneIndex(7));
+    CPPUNIT_ASSERT_EQUAL(1, matrix.getZoneIndex(42));
+    CPPUNIT_ASSERT_EQUAL(2, matrix.getZoneIndex(500));
+    CPPUNIT_ASSERT_EQUAL(-1, matrix.getZoneIndex(8));
+
+    matrix.setCosts(makeCosts(42, 7));
+    matrix.setCosts(makeCosts(42, 500));
+    const double* row = matrix.getRow(matrix.getZoneIndex(42), SkimMatrix::DISTANCE);
+    CPPUNIT_ASSERT_EQUAL(makeCosts(42, 7).getDistance(), row[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, row[1]);
+    CPPUNIT_ASSERT_EQUAL(makeCosts(42, 500).getDistance(), row[2]);
+}
+
+void unit_tests::SkimMatrixUnitTests::test_FileRoundTrip()
+{
+    {
+        SkimMatrix matrix;
+        fillMatrix(matrix);
+        matrix.saveToFile(TEST_FILE);
+    }
+
+    SkimMatrix loaded;
+    loaded.loadFromFile(TEST_FILE);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), loaded.getNumZones());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6), loaded.getNumODs());
+    checkCosts(loaded, 10, 20);
+    checkCosts(loaded, 30, 20);
+    CPPUNIT_ASSERT(!loaded.contains(10, 10));
+
+    try {
+        loaded.setCosts(makeCosts(10, 20));
+        CPPUNIT_FAIL("Mapped matrix was modified.");
+    } catch (std::runtime_error& ex) { }
+
+    loaded.clear();
+    std::remove(TEST_FILE);
+}
+
+void unit_tests::SkimMatrixUnitTests::test_InvalidFile()
+{
+    {
+        std::ofstream file(TEST_FILE);
+        file << "origin,destination,distance\n10,20,1.5\n";
+    }
+
+    SkimMatrix matrix;
+    try {
+        matrix.loadFromFile(TEST_FILE);
+        CPPUNIT_FAIL("Invalid skim file accepted.");
+    } catch (std::runtime_error& ex) { }
+    std::remove(TEST_FILE);
+
+    try {
+        matrix.loadFromFile(TEST_FILE);
+        CPPUNIT_FAIL("Missing skim file accepted.");
+    } catch (std::runtime_error& ex) { }
+}
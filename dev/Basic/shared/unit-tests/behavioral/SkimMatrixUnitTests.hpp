@@ -0,0 +1,40 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the dense preday skim matrix in Basic/behavioral/params
+ */
+class SkimMatrixUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Costs are found by zone code, exactly as stored in CostParams; pairs without costs and unknown zones throw std::out_of_range.
+    void test_Lookup();
+
+    ///Zones are indexed in zone id order, and rows are contiguous in destination index order.
+    void test_ZoneIdOrder();
+
+    ///A matrix saved to file and mapped back must return the same costs.
+    void test_FileRoundTrip();
+
+    ///Files which are not skim matrix files must be rejected.
+    void test_InvalidFile();
+
+private:
+    CPPUNIT_TEST_SUITE(SkimMatrixUnitTests);
+        CPPUNIT_TEST(test_Lookup);
+        CPPUNIT_TEST(test_ZoneIdOrder);
+        CPPUNIT_TEST(test_FileRoundTrip);
+        CPPUNIT_TEST(test_InvalidFile);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
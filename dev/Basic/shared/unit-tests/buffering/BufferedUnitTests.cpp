@@ -3,11 +3,17 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #include <cmath>
+#include <iostream>
 #include <limits>
+#include <string>
+#include <vector>
+#include <boost/chrono.hpp>
+#include <boost/shared_array.hpp>
 
 #include "buffering/Buffered.hpp"
 #include "buffering/Buffered_uint32.hpp"
 #include "buffering/BufferedDataManager.hpp"
+#include "buffering/Shared.hpp"
 #include "buffering/Vector2D.hpp"
 
 #include "BufferedUnitTests.hpp"
@@ -16,6 +22,7 @@ namespace unit_tests
 {
 
 CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::BufferedUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::BufferedBenchmarks, "Benchmarks");
 
 void BufferedUnitTests::test_default_Buffered_uint32_constructor()
 {
@@ -806,4 +813,124 @@ void BufferedUnitTests::test_the_Vector2D_float_class()
     }
 }
 
+void BufferedUnitTests::test_BufferedDataManager_arena_buffering()
+{
+    sim_mob::Buffered_uint32 integer(42);
+    sim_mob::Buffered<double> real(1.5);
+    sim_mob::Buffered<std::string> text("old");
+    sim_mob::Shared<int> shared(sim_mob::MtxStrat_Buffered, 7);
+    sim_mob::Shared<int> locked(sim_mob::MtxStrat_Locked, 9);
+
+    DataManager arenaMgr;
+    arenaMgr.setArenaBuffering(true);
+    CPPUNIT_ASSERT(arenaMgr.isArenaBuffering());
+    arenaMgr.beginManaging(&integer);
+    arenaMgr.beginManaging(&real);
+    arenaMgr.beginManaging(&text);
+    arenaMgr.beginManaging(&shared);
+    arenaMgr.beginManaging(&locked);
+    arenaMgr.beginManaging(&integer);
+    CPPUNIT_ASSERT(5 == arenaMgr.getNumManaged());
+    // Only the string and the locked value are flipped one by one.
+    CPPUNIT_ASSERT(2 == arenaMgr.managed_data_count());
+    CPPUNIT_ASSERT_THROW(arenaMgr.setArenaBuffering(false), std::runtime_error);
+
+    // Moving into the arena keeps the values.
+    CPPUNIT_ASSERT(42 == integer);
+    CPPUNIT_ASSERT(1.5 == real.get());
+    CPPUNIT_ASSERT(7 == shared.get());
+
+    integer += 3;
+    real.set(2.5);
+    text.set("new");
+    shared.set(8);
+    CPPUNIT_ASSERT(42 == integer);
+    CPPUNIT_ASSERT(7 == shared.get());
+
+    arenaMgr.flip();
+    CPPUNIT_ASSERT(45 == integer);
+    CPPUNIT_ASSERT(2.5 == real.get());
+    CPPUNIT_ASSERT("new" == text.get());
+    CPPUNIT_ASSERT(8 == shared.get());
+    CPPUNIT_ASSERT(9 == locked.get());
+
+    // Migrate a pending change to a manager without arenas and back.
+    integer++;
+    arenaMgr.stopManaging(&integer);
+    DataManager plainMgr;
+    plainMgr.beginManaging(&integer);
+    CPPUNIT_ASSERT(45 == integer);
+    arenaMgr.flip();
+    CPPUNIT_ASSERT(45 == integer);
+    plainMgr.flip();
+    CPPUNIT_ASSERT(46 == integer);
+
+    integer++;
+    plainMgr.stopManaging(&integer);
+    arenaMgr.beginManaging(&integer);
+    arenaMgr.flip();
+    CPPUNIT_ASSERT(47 == integer);
+
+    // A released slot is reused by the next datum of the same size.
+    arenaMgr.stopManaging(&shared);
+    CPPUNIT_ASSERT(8 == shared.get());
+    sim_mob::Buffered<int> other(11);
+    arenaMgr.beginManaging(&other);
+    other.set(12);
+    shared.set(13);
+    arenaMgr.flip();
+    CPPUNIT_ASSERT(12 == other.get());
+    CPPUNIT_ASSERT(8 == shared.get());
+
+    arenaMgr.stopManaging(&integer);
+    arenaMgr.stopManaging(&real);
+    arenaMgr.stopManaging(&text);
+    arenaMgr.stopManaging(&locked);
+    arenaMgr.stopManaging(&other);
+    CPPUNIT_ASSERT(0 == arenaMgr.getNumManaged());
+    CPPUNIT_ASSERT(47 == integer);
+    CPPUNIT_ASSERT(2.5 == real.get());
+}
+
+namespace
+{
+    ///Average time of a flip of numValues Buffered<int>, in microseconds.
+    double timeFlip(std::size_t numValues, bool arenas, unsigned int numFlips)
+    {
+        boost::shared_array< sim_mob::Buffered<int> > values(new sim_mob::Buffered<int>[numValues]);
+        sim_mob::BufferedDataManager mgr;
+        mgr.setArenaBuffering(arenas);
+        for (std::size_t i = 0; i < numValues; i++) {
+            mgr.beginManaging(&values[i]);
+        }
+
+        boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+        for (unsigned int f = 0; f < numFlips; f++) {
+            for (std::size_t i = 0; i < numValues; i += 7) {
+                values[i].set(f);
+            }
+            mgr.flip();
+        }
+        boost::chrono::duration<double, boost::micro> elapsed = boost::chrono::steady_clock::now() - start;
+
+        CPPUNIT_ASSERT(static_cast<int>(numFlips - 1) == values[0].get());
+        for (std::size_t i = 0; i < numValues; i++) {
+            mgr.stopManaging(&values[i]);
+        }
+        return elapsed.count() / numFlips;
+    }
+}
+
+void BufferedBenchmarks::test_flip_benchmark()
+{
+    const unsigned int numFlips = 10;
+    std::cout << "\nBufferedDataManager flip micro-benchmark (Buffered<int>, " << numFlips << " flips)\n";
+    for (std::size_t numValues = 10000; numValues <= 1000000; numValues *= 10) {
+        double perObject = timeFlip(numValues, false, numFlips);
+        double arena = timeFlip(numValues, true, numFlips);
+        std::cout << "  values: " << numValues << " | per object: " << perObject << " us/flip | arena: " << arena
+                  << " us/flip\n";
+    }
+}
+
 }
@@ -161,6 +161,15 @@ public:
      */
     void test_the_Vector2D_float_class();
 
+    /**
+     * Tests arena buffering.
+     *
+     * This test confirms that Buffered<T> and Shared<T> objects kept in arenas are flipped like
+     * the others, keep their values when they migrate to and from a manager without arenas, and
+     * that data which cannot live in an arena is still flipped one by one.
+     */
+    void test_BufferedDataManager_arena_buffering();
+
 private:
     CPPUNIT_TEST_SUITE(BufferedUnitTests);
         CPPUNIT_TEST(test_default_Buffered_uint32_constructor);
@@ -180,6 +189,26 @@ private:
         CPPUNIT_TEST(test_BufferedDataManager_doubleStopManaging);
         CPPUNIT_TEST(test_BufferedDataManager_stopManaging);
         CPPUNIT_TEST(test_the_Vector2D_float_class);
+        CPPUNIT_TEST(test_BufferedDataManager_arena_buffering);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the BufferedDataManager class; registered in the "Benchmarks" registry
+ * (SM_UnitTests --benchmarks).
+ */
+class BufferedBenchmarks : public CppUnit::TestFixture
+{
+public:
+    /**
+     * Compares the cost of a flip with and without arena buffering for 10k, 100k and 1M
+     * Buffered<int> objects, and prints the result.
+     */
+    void test_flip_benchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(BufferedBenchmarks);
+        CPPUNIT_TEST(test_flip_benchmark);
     CPPUNIT_TEST_SUITE_END();
 };
 
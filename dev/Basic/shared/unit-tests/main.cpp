@@ -26,6 +26,8 @@
 #include <cppunit/TestResultCollector.h>
 #include <cppunit/TestRunner.h>
 
+#include <string>
+
 //Additional dependencies for QXCppunit
 #ifdef SIMMOB_USE_TEST_GUI
 #include <QtGui/QApplication>
@@ -33,13 +35,30 @@
 #endif
 
 
+namespace {
+///Micro-benchmarks register themselves in this registry instead of the default one; they are
+/// slow and only print timings, so they run only when SM_UnitTests is started with --benchmarks.
+const char* BENCHMARK_REGISTRY = "Benchmarks";
+
+CppUnit::Test* makeTests(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--benchmarks") {
+            return CppUnit::TestFactoryRegistry::getRegistry(BENCHMARK_REGISTRY).makeTest();
+        }
+    }
+    return CppUnit::TestFactoryRegistry::getRegistry().makeTest();
+}
+} //End anon namespace
+
+
 int main(int argc, char *argv[])
 {
 #ifdef SIMMOB_USE_TEST_GUI
     QApplication app(argc, argv);
     QxCppUnit::TestRunner runner;
 
-    runner.addTest(CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest());
+    runner.addTest(makeTests(argc, argv));
     runner.run();
 
     return 0;
@@ -53,7 +72,7 @@ int main(int argc, char *argv[])
     controller.addListener(&progress);
 
     CppUnit::TestRunner runner;
-    runner.addTest(CppUnit::TestFactoryRegistry::getRegistry().makeTest());
+    runner.addTest(makeTests(argc, argv));
     runner.run(controller);
 
     CppUnit::CompilerOutputter outputter(&result, CppUnit::stdCOut());
@@ -0,0 +1,280 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <iostream>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+#include "message/MessageBus.hpp"
+
+#include "MessageBusUnitTests.hpp"
+
+using namespace sim_mob;
+using namespace sim_mob::messaging;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::MessageBusUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::MessageBusBenchmarks, "Benchmarks");
+
+namespace {
+const Message::MessageType TEST_MSG = MessageBus::MB_MSG_START + 1;
+
+///Message with a given priority and sequence number.
+class TestMessage : public Message {
+public:
+    TestMessage(int priority, unsigned int seq) : seq(seq) {
+        this->priority = priority;
+    }
+
+    unsigned int seq;
+};
+
+///Records the messages it handles, and the tick and thread in which it handles them.
+class RecordingHandler : public MessageHandler {
+public:
+    RecordingHandler(unsigned int id) : MessageHandler(id), tick(0) {}
+
+    virtual void HandleMessage(Message::MessageType type, const Message& message) {
+        const TestMessage& msg = MSG_CAST(TestMessage, message);
+        seqs.push_back(msg.seq);
+        ticks.push_back(tick);
+        threads.push_back(boost::this_thread::get_id());
+    }
+
+    ///Set by the owning thread before it dispatches the messages of a tick.
+    unsigned int tick;
+    std::vector<unsigned int> seqs;
+    std::vector<unsigned int> ticks;
+    std::vector<boost::thread::id> threads;
+};
+
+///Only counts the messages it handles.
+class CountingHandler : public MessageHandler {
+public:
+    CountingHandler(unsigned int id) : MessageHandler(id), received(0) {}
+
+    virtual void HandleMessage(Message::MessageType type, const Message& message) {
+        received++;
+    }
+
+    unsigned long long received;
+};
+
+///Called by worker thread *threadNum* during tick *tick*, after it dispatched the messages of the tick.
+typedef boost::function<void (unsigned int threadNum, unsigned int tick)> TickFunction;
+
+///Runs numThreads registered worker threads in lock step with the main thread, which distributes the messages
+///  between ticks, like WorkGroupManager does. Each worker registers handlers[threadNum] first.
+class BusRunner {
+public:
+    ///extraHandler, if given, is registered by thread 0 as well.
+    BusRunner(unsigned int numThreads, const std::vector<MessageHandler*>& handlers, MessageHandler* extraHandler = nullptr) :
+        numThreads(numThreads), handlers(handlers), extraHandler(extraHandler), barrier(numThreads + 1)
+    {}
+
+    ///Runs numTicks ticks of onTick; onMain is called by the main thread after each distribution.
+    void run(unsigned int numTicks, const TickFunction& onTick, const boost::function<void (unsigned int)>& onMain) {
+        boost::thread_group threads;
+        for (unsigned int i = 0; i < numThreads; i++) {
+            threads.create_thread(boost::bind(&BusRunner::work, this, i, numTicks, onTick));
+        }
+        barrier.wait(); //registration
+        for (unsigned int tick = 0; tick < numTicks; tick++) {
+            barrier.wait(); //workers done with the tick
+            MessageBus::DistributeMessages();
+            if (onMain) {
+                onMain(tick);
+            }
+            barrier.wait(); //next tick
+        }
+        threads.join_all();
+    }
+
+private:
+    void work(unsigned int threadNum, unsigned int numTicks, TickFunction onTick) {
+        MessageBus::RegisterThread();
+        MessageBus::RegisterHandler(handlers[threadNum]);
+        if (threadNum == 0 && extraHandler) {
+            MessageBus::RegisterHandler(extraHandler);
+        }
+        barrier.wait();
+        for (unsigned int tick = 0; tick < numTicks; tick++) {
+            MessageBus::ThreadDispatchMessages();
+            onTick(threadNum, tick);
+            barrier.wait();
+            barrier.wait();
+        }
+        MessageBus::UnRegisterThread();
+    }
+
+    unsigned int numThreads;
+    std::vector<MessageHandler*> handlers;
+    MessageHandler* extraHandler;
+    boost::barrier barrier;
+};
+
+///Posts from thread 0 in tick 0, then sets the tick of the handler of the calling thread for the next dispatch.
+void postInOrder(RecordingHandler& from, RecordingHandler& to, unsigned int threadNum, unsigned int tick) {
+    if (threadNum == 0 && tick == 0) {
+        //priority, seq
+        const int messages[][2] = { {5, 0}, {9, 1}, {7, 2}, {9, 3}, {5, 4}, {7, 5} };
+        for (unsigned int i = 0; i < 6; i++) {
+            MessageBus::PostMessage(&to, TEST_MSG, MessageBus::MakeMessage<TestMessage>(messages[i][0], messages[i][1]));
+        }
+    }
+    (threadNum == 0 ? from : to).tick = tick + 1;
+}
+
+void postSpecial(RecordingHandler& from, RecordingHandler& to, RecordingHandler& mainHandler, unsigned int threadNum, unsigned int tick) {
+    if (threadNum == 0 && tick == 0) {
+        MessageBus::PostMessage(&to, TEST_MSG, MessageBus::MakeMessage<TestMessage>(5, 1), false, 3);
+        MessageBus::PostMessage(&mainHandler, TEST_MSG, MessageBus::MakeMessage<TestMessage>(5, 2), true);
+        MessageBus::SendInstantaneousMessage(&from, TEST_MSG, MessageBus::MakeMessage<TestMessage>(5, 3));
+    }
+    (threadNum == 0 ? from : to).tick = tick + 1;
+}
+
+///Thread 0 posts to the handler it owns in tick 0, then moves the handler to thread 1; both threads record their ids.
+void postAndMove(RecordingHandler& moved, const std::vector<MessageHandler*>& handlers,
+        std::vector<boost::thread::id>& threadIds, unsigned int threadNum, unsigned int tick) {
+    if (threadNum == 0 && tick == 0) {
+        MessageBus::PostMessage(&moved, TEST_MSG, MessageBus::MakeMessage<TestMessage>(5, 1));
+        MessageBus::ReRegisterHandler(&moved, handlers[1]->GetContext());
+    }
+    if (threadNum == 1) {
+        moved.tick = tick + 1;
+    }
+    threadIds[threadNum] = boost::this_thread::get_id();
+}
+
+///The main thread handles its messages in the distribution after the tick; records the tick.
+void setMainTick(RecordingHandler& mainHandler, unsigned int tick) {
+    mainHandler.tick = tick + 1;
+}
+
+///Each thread posts numPerTick messages per tick, spread over the handlers of all other threads.
+void postRoundRobin(const std::vector<MessageHandler*>& handlers, unsigned int numPerTick, unsigned int numTicks,
+        unsigned int threadNum, unsigned int tick) {
+    //nothing is posted in the last tick, so that all messages are dispatched
+    if (tick + 1 == numTicks) {
+        return;
+    }
+    const unsigned int numThreads = handlers.size();
+    for (unsigned int i = 0; i < numPerTick; i++) {
+        unsigned int target = (threadNum + 1 + i % (numThreads - 1)) % numThreads;
+        MessageBus::PostMessage(handlers[target], TEST_MSG, MessageBus::MakeMessage<TestMessage>(5 + i % 3, i));
+    }
+}
+} //End anon namespace
+
+void unit_tests::MessageBusUnitTests::test_DeliveryOrder()
+{
+    MessageBus::RegisterMainThread();
+    RecordingHandler from(1), to(2);
+    std::vector<MessageHandler*> handlers;
+    handlers.push_back(&from);
+    handlers.push_back(&to);
+
+    BusRunner runner(2, handlers);
+    runner.run(3, boost::bind(postInOrder, boost::ref(from), boost::ref(to), _1, _2), boost::function<void (unsigned int)>());
+    MessageBus::UnRegisterMainThread();
+
+    const unsigned int expected[] = { 1, 3, 2, 5, 0, 4 };
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), to.seqs.size());
+    for (unsigned int i = 0; i < 6; i++) {
+        CPPUNIT_ASSERT_EQUAL(expected[i], to.seqs[i]);
+        CPPUNIT_ASSERT_EQUAL(1u, to.ticks[i]);
+    }
+    CPPUNIT_ASSERT(from.seqs.empty());
+}
+
+void unit_tests::MessageBusUnitTests::test_SpecialDelivery()
+{
+    MessageBus::RegisterMainThread();
+    RecordingHandler from(1), to(2), mainHandler(3);
+    MessageBus::RegisterHandler(&mainHandler);
+    std::vector<MessageHandler*> handlers;
+    handlers.push_back(&from);
+    handlers.push_back(&to);
+
+    BusRunner runner(2, handlers);
+    runner.run(6, boost::bind(postSpecial, boost::ref(from), boost::ref(to), boost::ref(mainHandler), _1, _2),
+            boost::bind(setMainTick, boost::ref(mainHandler), _1));
+    MessageBus::UnRegisterMainThread();
+
+    //The instantaneous message is handled at once, by the sender.
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), from.seqs.size());
+    CPPUNIT_ASSERT_EQUAL(3u, from.seqs[0]);
+    CPPUNIT_ASSERT_EQUAL(0u, from.ticks[0]);
+
+    //The main thread message is handled by the main thread in the distribution after the tick.
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), mainHandler.seqs.size());
+    CPPUNIT_ASSERT_EQUAL(2u, mainHandler.seqs[0]);
+    CPPUNIT_ASSERT_EQUAL(0u, mainHandler.ticks[0]);
+    CPPUNIT_ASSERT(mainHandler.threads[0] == boost::this_thread::get_id());
+
+    //The delayed message arrives 3 distributions after it was posted.
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), to.seqs.size());
+    CPPUNIT_ASSERT_EQUAL(1u, to.seqs[0]);
+    CPPUNIT_ASSERT_EQUAL(3u, to.ticks[0]);
+}
+
+void unit_tests::MessageBusUnitTests::test_MovedHandler()
+{
+    MessageBus::RegisterMainThread();
+    RecordingHandler first(1), second(2), moved(3);
+    std::vector<MessageHandler*> handlers;
+    handlers.push_back(&first);
+    handlers.push_back(&second);
+    handlers.push_back(&moved);
+    std::vector<boost::thread::id> threadIds(2);
+
+    //the first thread registers the moved handler too
+    std::vector<MessageHandler*> registered(handlers.begin(), handlers.begin() + 2);
+    BusRunner runner(2, registered, &moved);
+    runner.run(3, boost::bind(postAndMove, boost::ref(moved), boost::cref(handlers), boost::ref(threadIds), _1, _2),
+            boost::function<void (unsigned int)>());
+    MessageBus::UnRegisterMainThread();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), moved.seqs.size());
+    CPPUNIT_ASSERT_EQUAL(1u, moved.seqs[0]);
+    CPPUNIT_ASSERT_EQUAL(1u, moved.ticks[0]);
+    CPPUNIT_ASSERT(moved.threads[0] == threadIds[1]);
+}
+
+void unit_tests::MessageBusBenchmarks::test_Throughput()
+{
+    const unsigned int numTicks = 6;
+    const unsigned int numPerTick = 2000;
+    std::cout << "\nMessageBus micro-benchmark (" << numPerTick << " messages per thread per tick)\n";
+    for (unsigned int numThreads = 2; numThreads <= 64; numThreads *= 2) {
+        std::vector<CountingHandler> counters;
+        for (unsigned int i = 0; i < numThreads; i++) {
+            counters.push_back(CountingHandler(i + 1));
+        }
+        std::vector<MessageHandler*> handlers;
+        for (unsigned int i = 0; i < numThreads; i++) {
+            handlers.push_back(&counters[i]);
+        }
+
+        MessageBus::RegisterMainThread();
+        BusRunner runner(numThreads, handlers);
+        boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+        runner.run(numTicks, boost::bind(postRoundRobin, boost::cref(handlers), numPerTick, numTicks, _1, _2),
+                boost::function<void (unsigned int)>());
+        boost::chrono::duration<double> elapsed = boost::chrono::steady_clock::now() - start;
+        MessageBus::UnRegisterMainThread();
+
+        unsigned long long received = 0;
+        for (unsigned int i = 0; i < numThreads; i++) {
+            received += counters[i].received;
+        }
+        const unsigned long long posted = static_cast<unsigned long long>(numThreads) * numPerTick * (numTicks - 1);
+        CPPUNIT_ASSERT_EQUAL(posted, received);
+        std::cout << "  threads: " << numThreads << " | " << static_cast<unsigned long long>(posted / elapsed.count())
+                  << " messages/s\n";
+    }
+}
@@ -0,0 +1,52 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the MessageBus class in Basic/message.
+ */
+class MessageBusUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Posted messages are dispatched in the next tick, highest priority first, in posting order within a priority.
+    void test_DeliveryOrder();
+
+    ///Messages for the main thread, delayed messages and instantaneous messages.
+    void test_SpecialDelivery();
+
+    ///A message posted to a handler which moves to another thread in the same tick is handled by the new thread
+    ///  in the next tick.
+    void test_MovedHandler();
+
+private:
+    CPPUNIT_TEST_SUITE(MessageBusUnitTests);
+        CPPUNIT_TEST(test_DeliveryOrder);
+        CPPUNIT_TEST(test_SpecialDelivery);
+        CPPUNIT_TEST(test_MovedHandler);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the MessageBus class; registered in the "Benchmarks" registry (SM_UnitTests --benchmarks).
+ */
+class MessageBusBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Messages per second posted between 2 to 64 threads; all of them must be delivered.
+    void test_Throughput();
+
+private:
+    CPPUNIT_TEST_SUITE(MessageBusBenchmarks);
+        CPPUNIT_TEST(test_Throughput);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
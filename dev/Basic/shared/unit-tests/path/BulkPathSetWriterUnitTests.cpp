@@ -0,0 +1,338 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <map>
+#include <sstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+
+#include "geospatial/network/Link.hpp"
+#include "path/BulkPathSetWriter.hpp"
+#include "path/Path.hpp"
+#include "path/PathPool.hpp"
+#include "path/PathSetThreadPool.hpp"
+#include "util/OutputStreamer.hpp"
+
+#include "BulkPathSetWriterUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::BulkPathSetWriterUnitTests);
+
+namespace {
+///Links with sparse ids, as in real networks.
+struct Network {
+    explicit Network(unsigned int numLinks) {
+        for (unsigned int i = 0; i < numLinks; i++) {
+            Link* lnk = new Link();
+            lnk->setLinkId(i * 1000 + 7);
+            links.push_back(lnk);
+            linksMap[lnk->getLinkId()] = lnk;
+        }
+    }
+
+    ~Network() {
+        for (std::vector<Link*>::iterator it = links.begin(); it != links.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    std::vector<Link*> links;
+    std::map<unsigned int, Link*> linksMap;
+};
+
+///A temporary directory, removed with its content.
+struct TempDir {
+    TempDir() : path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()) {
+        boost::filesystem::create_directories(path);
+    }
+
+    ~TempDir() {
+        boost::filesystem::remove_all(path);
+    }
+
+    std::string file(const std::string& name) const {
+        return (path / name).string();
+    }
+
+    boost::filesystem::path path;
+};
+
+///The paths of a pathset, owning them.
+struct Paths {
+    ~Paths() {
+        for (std::set<SinglePath*, SinglePath>::iterator it = set.begin(); it != set.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    void add(PathPool& pool, const Network& network, unsigned int first, unsigned int numLinks, double travelTime) {
+        std::vector<const Link*> links;
+        for (unsigned int i = first; i < first + numLinks; i++) {
+            links.push_back(network.links[i]);
+        }
+        SinglePath* sp = new SinglePath();
+        sp->links = pool.intern(links);
+        sp->scenario = "test";
+        sp->isNeedSave2DB = true;
+        sp->travelTime = travelTime;
+        sp->signalNumber = numLinks;
+        sp->rightTurnNumber = -1;
+        sp->minTravelTime = (first == 0);
+        sp->validPath = true;
+        set.insert(sp);
+    }
+
+    std::set<SinglePath*, SinglePath> set;
+};
+
+std::vector<BulkPathSetRecord> readAll(const std::string& basePath) {
+    std::vector<BulkPathSetRecord> res;
+    for (std::size_t i = 0; boost::filesystem::exists(BulkPathSetWriter::getShardFile(basePath, i)); i++) {
+        BulkPathSetWriter::readShard(BulkPathSetWriter::getShardFile(basePath, i), res);
+    }
+    return res;
+}
+
+///Sink keeping the rows written to it.
+struct StringSink : public OutputSink {
+    virtual void write(const std::string& data) {
+        rows += data;
+    }
+
+    virtual void close() {
+    }
+
+    std::string rows;
+};
+
+///Splits a row of COPY ... FROM STDIN into its values, unescaping them.
+std::vector<std::string> splitCopyRow(const std::string& row) {
+    std::vector<std::string> values(1);
+    for (std::string::const_iterator it = row.begin(); it != row.end(); ++it) {
+        if (*it == '\\' && it + 1 != row.end()) {
+            values.back() += *++it;
+        } else if (*it == ',') {
+            values.push_back(std::string());
+        } else {
+            values.back() += *it;
+        }
+    }
+    return values;
+}
+
+void writeODs(BulkPathSetWriter& writer, PathPool& pool, const Network& network, unsigned int first, unsigned int count) {
+    for (unsigned int od = first; od < first + count; od++) {
+        Paths paths;
+        paths.add(pool, network, od % 50, 3, od);
+        writer.write(od, od + 1000, paths.set);
+        writer.complete(od);
+    }
+}
+} //End anon namespace
+
+void unit_tests::BulkPathSetWriterUnitTests::test_RoundTrip()
+{
+    Network network(100);
+    PathPool pool(network.linksMap);
+    TempDir dir;
+    const std::string base = dir.file("pathset");
+
+    Paths first;
+    first.add(pool, network, 0, 5, 12.5);
+    first.add(pool, network, 90, 10, 30.25);
+    Paths second;
+    second.add(pool, network, 10, 1, 1.0);
+    //Paths which are not to be saved are left out.
+    second.add(pool, network, 20, 2, 2.0);
+    for (std::set<SinglePath*, SinglePath>::iterator it = second.set.begin(); it != second.set.end(); ++it) {
+        (*it)->isNeedSave2DB = ((*it)->travelTime == 1.0);
+    }
+    {
+        BulkPathSetWriter writer(base, 2, 3600);
+        writer.write(1, 2, first.set);
+        writer.complete(0);
+        writer.write(3, 4, second.set);
+        writer.complete(1);
+        writer.finish();
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), writer.getNumCompleted());
+    }
+
+    std::vector<BulkPathSetRecord> pathSets = readAll(base);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), pathSets.size());
+    CPPUNIT_ASSERT_EQUAL(1u, pathSets[0].origin);
+    CPPUNIT_ASSERT_EQUAL(2u, pathSets[0].destination);
+    CPPUNIT_ASSERT_EQUAL(first.set.size(), pathSets[0].paths.size());
+    std::set<SinglePath*, SinglePath>::const_iterator spIt = first.set.begin();
+    for (std::size_t i = 0; i < pathSets[0].paths.size(); i++, spIt++) {
+        const BulkPathRecord& path = pathSets[0].paths[i];
+        CPPUNIT_ASSERT_EQUAL(std::string("test"), path.scenario);
+        CPPUNIT_ASSERT_EQUAL((*spIt)->travelTime, path.travelTime);
+        CPPUNIT_ASSERT_EQUAL((*spIt)->signalNumber, path.signalNumber);
+        CPPUNIT_ASSERT_EQUAL(-1, path.rightTurnNumber);
+        CPPUNIT_ASSERT_EQUAL((*spIt)->minTravelTime, path.minTravelTime);
+        CPPUNIT_ASSERT(path.validPath);
+        CPPUNIT_ASSERT(!path.shortestPath);
+        CPPUNIT_ASSERT_EQUAL((*spIt)->links->size(), path.linkIds.size());
+        CompactPath::const_iterator linkIt = (*spIt)->links->begin();
+        for (std::size_t j = 0; j < path.linkIds.size(); j++, linkIt++) {
+            CPPUNIT_ASSERT_EQUAL((*linkIt)->getLinkId(), path.linkIds[j]);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), pathSets[1].paths.size());
+    CPPUNIT_ASSERT_EQUAL(1.0, pathSets[1].paths[0].travelTime);
+
+    //A truncated file is detected.
+    const std::string shard = BulkPathSetWriter::getShardFile(base, 0);
+    boost::filesystem::resize_file(shard, boost::filesystem::file_size(shard) - 3);
+    std::vector<BulkPathSetRecord> truncated;
+    CPPUNIT_ASSERT_THROW(BulkPathSetWriter::readShard(shard, truncated), std::runtime_error);
+}
+
+void unit_tests::BulkPathSetWriterUnitTests::test_Resume()
+{
+    Network network(100);
+    PathPool pool(network.linksMap);
+    TempDir dir;
+    const std::string base = dir.file("pathset");
+    {
+        //A checkpoint at each completion
+        BulkPathSetWriter writer(base, 3, 0);
+        writeODs(writer, pool, network, 0, 1);
+
+        //Interrupted before completing the second OD
+        Paths paths;
+        paths.add(pool, network, 1, 3, 1.0);
+        writer.write(1, 1001, paths.set);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), readAll(base).size());
+
+    CPPUNIT_ASSERT_THROW(BulkPathSetWriter(base, 4, 0), std::runtime_error);
+    {
+        BulkPathSetWriter writer(base, 3, 3600);
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), writer.getNumCompleted());
+        CPPUNIT_ASSERT(writer.isCompleted(0));
+        CPPUNIT_ASSERT(!writer.isCompleted(1));
+        CPPUNIT_ASSERT(!writer.isCompleted(2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), readAll(base).size());
+
+        writeODs(writer, pool, network, 1, 2);
+        writer.finish();
+    }
+
+    std::vector<BulkPathSetRecord> pathSets = readAll(base);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), pathSets.size());
+    for (unsigned int i = 0; i < 3; i++) {
+        CPPUNIT_ASSERT_EQUAL(i, pathSets[i].origin);
+        CPPUNIT_ASSERT_EQUAL(static_cast<double>(i), pathSets[i].paths[0].travelTime);
+    }
+
+    //Nothing is left to generate.
+    BulkPathSetWriter writer(base, 3, 3600);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), writer.getNumCompleted());
+}
+
+void unit_tests::BulkPathSetWriterUnitTests::test_ThreadShards()
+{
+    Network network(100);
+    PathPool pool(network.linksMap);
+    TempDir dir;
+    const std::string base = dir.file("pathset");
+    {
+        BulkPathSetWriter writer(base, 100, 0);
+        boost::thread_group threads;
+        for (unsigned int i = 0; i < 4; i++) {
+            threads.create_thread(boost::bind(writeODs, boost::ref(writer), boost::ref(pool), boost::cref(network), i * 25, 25));
+        }
+        threads.join_all();
+        writer.finish();
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(100), writer.getNumCompleted());
+    }
+
+    CPPUNIT_ASSERT(boost::filesystem::exists(BulkPathSetWriter::getShardFile(base, 3)));
+    CPPUNIT_ASSERT(!boost::filesystem::exists(BulkPathSetWriter::getShardFile(base, 4)));
+    std::vector<BulkPathSetRecord> pathSets = readAll(base);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(100), pathSets.size());
+    std::set<unsigned int> origins;
+    for (std::vector<BulkPathSetRecord>::const_iterator it = pathSets.begin(); it != pathSets.end(); ++it) {
+        CPPUNIT_ASSERT_EQUAL(it->origin + 1000, it->destination);
+        origins.insert(it->origin);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(100), origins.size());
+}
+
+void unit_tests::BulkPathSetWriterUnitTests::test_LoadShards()
+{
+    Network network(100);
+    PathPool pool(network.linksMap);
+    TempDir dir;
+    const std::string base = dir.file("pathset");
+    {
+        BulkPathSetWriter writer(base, 50, 0);
+        boost::thread_group threads;
+        for (unsigned int i = 0; i < 2; i++) {
+            threads.create_thread(boost::bind(writeODs, boost::ref(writer), boost::ref(pool), boost::cref(network), i * 25, 25));
+        }
+        threads.join_all();
+        writer.finish();
+    }
+
+    StringSink sink;
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), BulkPathSetWriter::loadShards(base, sink));
+
+    //One row per path, from all the shards, with the columns of the csv output.
+    std::istringstream rows(sink.rows);
+    std::string row;
+    std::set<unsigned int> origins;
+    while (std::getline(rows, row)) {
+        std::vector<std::string> values = splitCopyRow(row);
+        CPPUNIT_ASSERT_EQUAL(BulkPathSetWriter::getTableColumns().size(), values.size());
+        unsigned int origin = boost::lexical_cast<unsigned int>(values[0]);
+        CPPUNIT_ASSERT_EQUAL(origin + 1000, boost::lexical_cast<unsigned int>(values[1]));
+        CPPUNIT_ASSERT_EQUAL(std::string("test"), values[2]);
+
+        //The path is stored as its link ids, each followed by a comma.
+        std::stringstream pathId;
+        for (unsigned int i = origin % 50; i < origin % 50 + 3; i++) {
+            pathId << network.links[i]->getLinkId() << ",";
+        }
+        CPPUNIT_ASSERT_EQUAL(pathId.str(), values[3]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<double>(origin), boost::lexical_cast<double>(values[16]));
+        origins.insert(origin);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), origins.size());
+}
+
+void unit_tests::BulkPathSetWriterUnitTests::test_PerturbationSeeds()
+{
+    const std::pair<int, int> range(1, 10);
+    boost::uint64_t seed = PathSetWorkerThread::makePerturbationSeed(100, 200, 0);
+    CPPUNIT_ASSERT_EQUAL(seed, PathSetWorkerThread::makePerturbationSeed(100, 200, 0));
+    CPPUNIT_ASSERT(seed != PathSetWorkerThread::makePerturbationSeed(100, 200, 1));
+    CPPUNIT_ASSERT(seed != PathSetWorkerThread::makePerturbationSeed(200, 100, 0));
+
+    std::set<int> factors;
+    unsigned int differences = 0;
+    boost::uint64_t otherSeed = PathSetWorkerThread::makePerturbationSeed(100, 200, 1);
+    for (unsigned int linkId = 0; linkId < 1000; linkId++) {
+        int factor = PathSetWorkerThread::getPerturbationFactor(seed, linkId, range);
+        CPPUNIT_ASSERT(factor >= range.first && factor <= range.second);
+        CPPUNIT_ASSERT_EQUAL(factor, PathSetWorkerThread::getPerturbationFactor(seed, linkId, range));
+        factors.insert(factor);
+        if (factor != PathSetWorkerThread::getPerturbationFactor(otherSeed, linkId, range)) {
+            differences++;
+        }
+    }
+    //Every factor of the range is drawn, and another iteration perturbs the links differently.
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(10), factors.size());
+    CPPUNIT_ASSERT(differences > 500);
+
+    CPPUNIT_ASSERT_EQUAL(5, PathSetWorkerThread::getPerturbationFactor(seed, 1, std::pair<int, int>(5, 5)));
+}
@@ -0,0 +1,44 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the BulkPathSetWriter class and the seeded random perturbation of bulk pathset generation.
+ */
+class BulkPathSetWriterUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Written pathsets read back with their attributes and links.
+    void test_RoundTrip();
+
+    ///A new writer on the same files skips the completed ODs and drops what was written after the last checkpoint.
+    void test_Resume();
+
+    ///Each thread writes to its own shard, and no pathset is lost.
+    void test_ThreadShards();
+
+    ///The pathsets of all the shards are loaded as rows of the pathset table.
+    void test_LoadShards();
+
+    ///Perturbation seeds and factors only depend on the OD, the iteration and the link.
+    void test_PerturbationSeeds();
+
+private:
+    CPPUNIT_TEST_SUITE(BulkPathSetWriterUnitTests);
+        CPPUNIT_TEST(test_RoundTrip);
+        CPPUNIT_TEST(test_Resume);
+        CPPUNIT_TEST(test_ThreadShards);
+        CPPUNIT_TEST(test_LoadShards);
+        CPPUNIT_TEST(test_PerturbationSeeds);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,182 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "geospatial/network/Link.hpp"
+#include "geospatial/network/WayPoint.hpp"
+#include "path/PathPool.hpp"
+
+#include "PathPoolUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PathPoolUnitTests);
+
+namespace {
+///Links with sparse ids, as in real networks.
+struct Network {
+    explicit Network(unsigned int numLinks) {
+        for (unsigned int i = 0; i < numLinks; i++) {
+            Link* lnk = new Link();
+            lnk->setLinkId(i * 1000 + 7);
+            links.push_back(lnk);
+            linksMap[lnk->getLinkId()] = lnk;
+        }
+    }
+
+    ~Network() {
+        for (std::vector<Link*>::iterator it = links.begin(); it != links.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    std::vector<const Link*> path(const unsigned int* indices, std::size_t size) const {
+        std::vector<const Link*> res;
+        for (std::size_t i = 0; i < size; i++) {
+            res.push_back(links[indices[i]]);
+        }
+        return res;
+    }
+
+    std::vector<Link*> links;
+    std::map<unsigned int, Link*> linksMap;
+};
+
+void internAndDrop(PathPool& pool, const Network& network, unsigned int threadId, boost::atomic<int>& wrong) {
+    for (unsigned int i = 0; i < 20000; i++) {
+        unsigned int indices[] = { i % 50, (i % 50) + 1, (i * 7 + threadId) % 3 + 60 };
+        std::vector<const Link*> links = network.path(indices, 3);
+        PathPool::PathPtr first = pool.intern(links);
+        PathPool::PathPtr second = pool.intern(links);
+        if (first != second || first->size() != 3 || first->back() != links.back()) {
+            wrong++;
+        }
+    }
+}
+} //End anon namespace
+
+void unit_tests::PathPoolUnitTests::test_RoundTrip()
+{
+    Network network(100000);
+    PathPool pool(network.linksMap);
+
+    //Small steps, large steps in both directions, and the extreme indices.
+    const unsigned int indices[] = { 5, 6, 7, 3, 90000, 90001, 12, 0, 99999, 64, 63, 8192 };
+    const std::size_t size = sizeof(indices) / sizeof(indices[0]);
+    std::vector<const Link*> links = network.path(indices, size);
+    PathPool::PathPtr path = pool.intern(links);
+
+    CPPUNIT_ASSERT(path);
+    CPPUNIT_ASSERT_EQUAL(size, path->size());
+    CPPUNIT_ASSERT(!path->hasLoop());
+    CPPUNIT_ASSERT(path->front() == links.front());
+    CPPUNIT_ASSERT(path->back() == links.back());
+    std::vector<const Link*> decoded(path->begin(), path->end());
+    CPPUNIT_ASSERT(decoded == links);
+    CPPUNIT_ASSERT(path->getEncodedSize() < size * sizeof(WayPoint) / 4);
+
+    std::vector<WayPoint> wayPoints(1);
+    path->toWayPoints(wayPoints);
+    CPPUNIT_ASSERT_EQUAL(size, wayPoints.size());
+    for (std::size_t i = 0; i < size; i++) {
+        CPPUNIT_ASSERT(wayPoints[i].type == WayPoint::LINK);
+        CPPUNIT_ASSERT(wayPoints[i].link == links[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::string("5007,6007,7007,3007,90000007,90001007,12007,7,99999007,64007,63007,8192007,"), path->toString());
+    CPPUNIT_ASSERT(path->contains(network.links[90000]));
+    CPPUNIT_ASSERT(!path->contains(network.links[4]));
+    CPPUNIT_ASSERT(!path->contains(nullptr));
+
+    //Way points other than links are ignored.
+    std::vector<WayPoint> withNodes;
+    for (std::size_t i = 0; i < size; i++) {
+        withNodes.push_back(WayPoint(static_cast<const Node*>(nullptr)));
+        withNodes.push_back(WayPoint(links[i]));
+    }
+    CPPUNIT_ASSERT(pool.intern(withNodes) == path);
+}
+
+void unit_tests::PathPoolUnitTests::test_Interning()
+{
+    Network network(100);
+    PathPool pool(network.linksMap);
+
+    const unsigned int a[] = { 1, 2, 3, 4 };
+    const unsigned int b[] = { 1, 2, 3, 5 };
+    const unsigned int loop[] = { 1, 2, 3, 1 };
+    PathPool::PathPtr first = pool.intern(network.path(a, 4));
+    PathPool::PathPtr same = pool.intern(network.path(a, 4));
+    PathPool::PathPtr other = pool.intern(network.path(b, 4));
+    CPPUNIT_ASSERT(first == same);
+    CPPUNIT_ASSERT(first != other);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), pool.size());
+
+    CPPUNIT_ASSERT(pool.intern(network.path(loop, 4))->hasLoop());
+    CPPUNIT_ASSERT(!pool.intern(std::vector<const Link*>()));
+    Link unknown;
+    std::vector<const Link*> withUnknown(1, &unknown);
+    CPPUNIT_ASSERT_THROW(pool.intern(withUnknown), std::runtime_error);
+
+    //The pool forgets the paths nobody refers to.
+    first.reset();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), pool.size());
+    same.reset();
+    other.reset();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), pool.size());
+}
+
+void unit_tests::PathPoolUnitTests::test_IdOrder()
+{
+    //Ids of different lengths (7, 1007, 10007, ...), so that the string order differs from the numeric order.
+    Network network(200);
+    PathPool pool(network.linksMap);
+
+    std::vector<PathPool::PathPtr> paths;
+    for (unsigned int i = 0; i < 300; i++) {
+        unsigned int length = 1 + (i * 7) % 5;
+        std::vector<unsigned int> indices;
+        for (unsigned int j = 0; j < length; j++) {
+            indices.push_back((i * 31 + j * 17 + (i % 3) * j) % 200);
+        }
+        paths.push_back(pool.intern(network.path(&indices[0], indices.size())));
+    }
+    //A path and its prefixes, and ids which are prefixes of each other (1, 10, 100).
+    const unsigned int prefixed[] = { 1, 10, 100, 2 };
+    for (std::size_t length = 1; length <= 4; length++) {
+        paths.push_back(pool.intern(network.path(prefixed, length)));
+    }
+    const unsigned int extended[] = { 10, 1 };
+    paths.push_back(pool.intern(network.path(extended, 2)));
+    paths.push_back(PathPool::PathPtr());
+
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        for (std::size_t j = 0; j < paths.size(); j++) {
+            std::string lhs = paths[i] ? paths[i]->toString() : std::string();
+            std::string rhs = paths[j] ? paths[j]->toString() : std::string();
+            CPPUNIT_ASSERT_EQUAL(lhs < rhs, CompactPath::lessByIds(paths[i].get(), paths[j].get()));
+        }
+    }
+}
+
+void unit_tests::PathPoolUnitTests::test_Concurrent()
+{
+    Network network(100);
+    PathPool pool(network.linksMap);
+    boost::atomic<int> wrong(0);
+    boost::thread_group threads;
+    for (unsigned int i = 0; i < 4; i++) {
+        threads.create_thread(boost::bind(internAndDrop, boost::ref(pool), boost::cref(network), i, boost::ref(wrong)));
+    }
+    threads.join_all();
+
+    CPPUNIT_ASSERT_EQUAL(0, wrong.load());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), pool.size());
+}
@@ -0,0 +1,40 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the PathPool and CompactPath classes in Basic/path.
+ */
+class PathPoolUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Interned paths decode to the links they were built from, whatever the gaps between link indices.
+    void test_RoundTrip();
+
+    ///Identical link sequences share one encoding, which leaves the pool with its last reference.
+    void test_Interning();
+
+    ///Paths are ordered as their link id strings, without building them.
+    void test_IdOrder();
+
+    ///Threads interning and dropping the same paths always share the encodings which are alive.
+    void test_Concurrent();
+
+private:
+    CPPUNIT_TEST_SUITE(PathPoolUnitTests);
+        CPPUNIT_TEST(test_RoundTrip);
+        CPPUNIT_TEST(test_Interning);
+        CPPUNIT_TEST(test_IdOrder);
+        CPPUNIT_TEST(test_Concurrent);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
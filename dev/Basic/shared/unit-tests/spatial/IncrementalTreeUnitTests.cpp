@@ -0,0 +1,265 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "spatial_trees/incremental_tree/IncrementalTree.hpp"
+
+#include "IncrementalTreeUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::IncrementalTreeUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::IncrementalTreeBenchmarks, "Benchmarks");
+
+namespace {
+///Agents moving on a plane. The tree never dereferences entities or agents, so they are addresses in a byte array.
+struct World {
+    World(std::size_t numAgents, float extent, unsigned int seed) : storage(numAgents), xs(numAgents), ys(numAgents),
+            dxs(numAgents), dys(numAgents), present(numAgents, true), extent(extent), rng(seed) {
+        std::uniform_real_distribution<float> pos(0, extent);
+        for (std::size_t i = 0; i < numAgents; i++) {
+            xs[i] = pos(rng);
+            ys[i] = pos(rng);
+        }
+    }
+
+    Entity* entity(std::size_t i) {
+        return reinterpret_cast<Entity*>(&storage[i]);
+    }
+
+    const Agent* agent(std::size_t i) const {
+        return reinterpret_cast<const Agent*>(&storage[i]);
+    }
+
+    std::vector<Entity*> entities() {
+        std::vector<Entity*> res;
+        for (std::size_t i = 0; i < storage.size(); i++) {
+            res.push_back(entity(i));
+        }
+        return res;
+    }
+
+    const Agent* locate(Entity* entity, float& x, float& y) const {
+        std::size_t i = reinterpret_cast<const char*>(entity) - &storage[0];
+        if (!present[i]) {
+            return nullptr;
+        }
+        x = xs[i];
+        y = ys[i];
+        return agent(i);
+    }
+
+    IncrementalTree::Locator locator() const {
+        return boost::bind(&World::locate, this, _1, _2, _3);
+    }
+
+    ///Gives every agent a random velocity of at most maxSpeed per step.
+    void setVelocities(float maxSpeed) {
+        std::uniform_real_distribution<float> speed(0, maxSpeed);
+        std::uniform_real_distribution<float> angle(0, 6.2831853f);
+        for (std::size_t i = 0; i < storage.size(); i++) {
+            float s = speed(rng), a = angle(rng);
+            dxs[i] = s * std::cos(a);
+            dys[i] = s * std::sin(a);
+        }
+    }
+
+    void step() {
+        for (std::size_t i = 0; i < storage.size(); i++) {
+            xs[i] += dxs[i];
+            ys[i] += dys[i];
+        }
+    }
+
+    std::vector<const Agent*> bruteForce(float left, float bottom, float right, float top) const {
+        std::vector<const Agent*> res;
+        for (std::size_t i = 0; i < storage.size(); i++) {
+            if (present[i] && xs[i] >= left && xs[i] <= right && ys[i] >= bottom && ys[i] <= top) {
+                res.push_back(agent(i));
+            }
+        }
+        return res;
+    }
+
+    std::vector<char> storage;
+    std::vector<float> xs, ys, dxs, dys;
+    std::vector<bool> present;
+    float extent;
+    std::mt19937 rng;
+};
+
+///Checks random queries of the tree against the brute force result.
+void checkQueries(const IncrementalTree& tree, World& world, std::size_t numQueries) {
+    std::uniform_real_distribution<float> pos(-world.extent * 0.1f, world.extent * 1.1f);
+    std::uniform_real_distribution<float> size(0, world.extent * 0.2f);
+    for (std::size_t q = 0; q < numQueries; q++) {
+        float left = pos(world.rng), bottom = pos(world.rng);
+        float right = left + size(world.rng), top = bottom + size(world.rng);
+        std::vector<const Agent*> expected = world.bruteForce(left, bottom, right, top);
+        std::vector<const Agent*> actual;
+        tree.query(left, bottom, right, top, actual);
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        CPPUNIT_ASSERT(expected == actual);
+    }
+}
+
+double secondsSince(const boost::chrono::steady_clock::time_point& start) {
+    return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+}
+
+///Rebuilds a packed tree of all positions, as the packing tree does every time step; returns the time taken.
+double timeRebuild(const World& world) {
+    typedef boost::geometry::model::point<float, 2, boost::geometry::cs::cartesian> Pt;
+    typedef boost::geometry::model::box<Pt> Box;
+    typedef std::pair<Box, const Agent*> Value;
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    std::vector<Value> values;
+    for (std::size_t i = 0; i < world.storage.size(); i++) {
+        Pt location(world.xs[i], world.ys[i]);
+        values.push_back(Value(Box(location, location), world.agent(i)));
+    }
+    boost::geometry::index::rtree<Value, boost::geometry::index::linear<16> > tree(values.begin(), values.end());
+    return secondsSince(start);
+}
+} //End anon namespace
+
+void unit_tests::IncrementalTreeUnitTests::test_QueryMatchesBruteForce()
+{
+    World world(20000, 100000, 1);
+    world.setVelocities(300);
+    std::vector<Entity*> entities = world.entities();
+    IncrementalTree tree(4, 500, 0.25);
+
+    std::uniform_int_distribution<std::size_t> pick(0, world.storage.size() - 1);
+    for (unsigned int t = 0; t < 30; t++) {
+        //Some agents disappear and some come back.
+        for (unsigned int i = 0; i < 50; i++) {
+            world.present[pick(world.rng)] = false;
+            world.present[pick(world.rng)] = true;
+        }
+        tree.update(entities, world.locator());
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(std::count(world.present.begin(), world.present.end(), true)), tree.size());
+        checkQueries(tree, world, 20);
+        world.step();
+    }
+}
+
+void unit_tests::IncrementalTreeUnitTests::test_IncrementalMoves()
+{
+    World world(10000, 100000, 2);
+    std::vector<Entity*> entities = world.entities();
+    IncrementalTree tree(2, 500, 0.25);
+
+    tree.update(entities, world.locator());
+    CPPUNIT_ASSERT(tree.getLastUpdateStats().repacked);
+    CPPUNIT_ASSERT_EQUAL(world.storage.size(), tree.getLastUpdateStats().numAdded);
+
+    //Moving less than the margin in total keeps every agent in the box of its leaf.
+    world.setVelocities(100);
+    for (unsigned int t = 0; t < 4; t++) {
+        world.step();
+        tree.update(entities, world.locator());
+        const IncrementalTree::UpdateStats& stats = tree.getLastUpdateStats();
+        CPPUNIT_ASSERT_EQUAL(world.storage.size(), stats.numKept);
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), stats.numMoved);
+        CPPUNIT_ASSERT(!stats.repacked);
+        checkQueries(tree, world, 20);
+    }
+
+    //A few agents jump far away; only they are moved, without rebuilding the leaves.
+    for (std::size_t i = 0; i < 10; i++) {
+        world.xs[i * 7] += 50000;
+    }
+    tree.update(entities, world.locator());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(10), tree.getLastUpdateStats().numMoved);
+    CPPUNIT_ASSERT(!tree.getLastUpdateStats().repacked);
+    checkQueries(tree, world, 50);
+}
+
+void unit_tests::IncrementalTreeUnitTests::test_RepackAndRemove()
+{
+    World world(10000, 100000, 3);
+    std::vector<Entity*> entities = world.entities();
+    IncrementalTree tree(3, 500, 0.25);
+    tree.update(entities, world.locator());
+
+    //Half of the agents leave their leaf.
+    for (std::size_t i = 0; i < world.storage.size(); i += 2) {
+        world.ys[i] += 50000;
+    }
+    tree.update(entities, world.locator());
+    CPPUNIT_ASSERT_EQUAL(world.storage.size() / 2, tree.getLastUpdateStats().numMoved);
+    CPPUNIT_ASSERT(tree.getLastUpdateStats().repacked);
+    checkQueries(tree, world, 50);
+
+    //Agents not returned by the locator, or not passed at all, are removed.
+    world.present[5] = false;
+    entities.pop_back();
+    tree.update(entities, world.locator());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), tree.getLastUpdateStats().numRemoved);
+    CPPUNIT_ASSERT_EQUAL(world.storage.size() - 2, tree.size());
+    world.present[world.storage.size() - 1] = false;
+    checkQueries(tree, world, 50);
+
+    //Nothing left.
+    tree.update(std::vector<Entity*>(), world.locator());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), tree.size());
+    std::vector<const Agent*> none;
+    tree.query(-1e9f, -1e9f, 1e9f, 1e9f, none);
+    CPPUNIT_ASSERT(none.empty());
+
+    CPPUNIT_ASSERT_THROW(IncrementalTree(0), std::runtime_error);
+}
+
+void unit_tests::IncrementalTreeBenchmarks::test_update_benchmark()
+{
+    //Vehicles moving at up to 15 m/s, with 100 ms time steps, on a 20 km square.
+    const std::size_t numAgents = 200000;
+    const unsigned int numSteps = 20;
+    World world(numAgents, 20000, 4);
+    world.setVelocities(1.5f);
+    std::vector<Entity*> entities = world.entities();
+
+    std::cout << "\nAuraManager update micro-benchmark (" << numAgents << " agents, " << numSteps << " time steps)\n";
+
+    double rebuild = 0;
+    for (unsigned int t = 0; t < numSteps; t++) {
+        rebuild += timeRebuild(world);
+    }
+    std::cout << "  packed rebuild: " << rebuild * 1000 / numSteps << " ms/step, all of it on a single thread\n";
+
+    const std::size_t threadCounts[] = { 1, 4 };
+    for (std::size_t c = 0; c < 2; c++) {
+        IncrementalTree tree(threadCounts[c]);
+        tree.update(entities, world.locator());
+        double total = 0, serial = 0;
+        std::size_t moved = 0, repacks = 0;
+        for (unsigned int t = 0; t < numSteps; t++) {
+            world.step();
+            tree.update(entities, world.locator());
+            const IncrementalTree::UpdateStats& stats = tree.getLastUpdateStats();
+            total += stats.totalSeconds;
+            serial += stats.totalSeconds - stats.parallelSeconds;
+            moved += stats.numMoved;
+            repacks += stats.repacked ? 1 : 0;
+        }
+        std::cout << "  incremental, " << threadCounts[c] << " threads: " << total * 1000 / numSteps << " ms/step, of which "
+                  << serial * 1000 / numSteps << " ms on a single thread; " << moved / numSteps << " agents moved/step, "
+                  << repacks << " rebuilds\n";
+    }
+}
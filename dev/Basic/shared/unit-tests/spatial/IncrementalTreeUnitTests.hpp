@@ -0,0 +1,52 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the IncrementalTree class in Basic/spatial_trees/incremental_tree.
+ */
+class IncrementalTreeUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Queries must return exactly the agents within the rectangle while agents move, appear and disappear.
+    void test_QueryMatchesBruteForce();
+
+    ///Agents moving within the box of their leaf must leave the leaves untouched; only agents leaving it are moved.
+    void test_IncrementalMoves();
+
+    ///High churn must build the leaves again; agents no longer returned by the locator must be removed.
+    void test_RepackAndRemove();
+
+private:
+    CPPUNIT_TEST_SUITE(IncrementalTreeUnitTests);
+        CPPUNIT_TEST(test_QueryMatchesBruteForce);
+        CPPUNIT_TEST(test_IncrementalMoves);
+        CPPUNIT_TEST(test_RepackAndRemove);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the IncrementalTree class; registered in the "Benchmarks" registry (SM_UnitTests --benchmarks).
+ */
+class IncrementalTreeBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Compares the update time, and the part of it spent on a single thread, of a full rebuild every time step
+    ///(as done by the packing tree) with the incremental update. Prints the results.
+    void test_update_benchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(IncrementalTreeBenchmarks);
+        CPPUNIT_TEST(test_update_benchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
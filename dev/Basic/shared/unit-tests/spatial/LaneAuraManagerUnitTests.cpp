@@ -0,0 +1,295 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <boost/bind.hpp>
+
+#include "entities/Agent.hpp"
+#include "geospatial/network/Lane.hpp"
+#include "geospatial/network/Point.hpp"
+#include "geospatial/network/PolyLine.hpp"
+#include "geospatial/network/RoadSegment.hpp"
+#include "geospatial/network/WayPoint.hpp"
+#include "spatial_trees/AuraComparison.hpp"
+#include "spatial_trees/lane_index/LaneAuraManager.hpp"
+#include "spatial_trees/shared_funcs.hpp"
+
+#include "LaneAuraManagerUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::LaneAuraManagerUnitTests);
+
+namespace {
+const unsigned int NUM_LANES = 3;
+const double LENGTH = 1000;
+const int LANE_SPACING = 4;
+const unsigned int FIRST_LANE_ID = 10;
+
+///A straight road segment, 1 km long along the x axis, with three lanes 4 m apart.
+struct Road {
+    Road() {
+        for (unsigned int i = 0; i < NUM_LANES; i++) {
+            PolyLine* polyLine = new PolyLine();
+            polyLine->addPoint(PolyPoint(0, 0, 0, i * LANE_SPACING, 0));
+            polyLine->addPoint(PolyPoint(0, 1, LENGTH, i * LANE_SPACING, 0));
+            polyLine->setLength(LENGTH);
+
+            Lane* lane = new Lane();
+            lane->setLaneId(FIRST_LANE_ID + i);
+            lane->setWidth(LANE_SPACING);
+            lane->setPolyLine(polyLine);
+            lane->setParentSegment(&segment);
+            segment.addLane(lane);
+            lanes.push_back(lane);
+        }
+    }
+
+    bool resolve(char wayPointType, unsigned int wayPointId, WayPoint& wayPoint) const {
+        if (wayPointType != AuraSample::ON_LANE || wayPointId < FIRST_LANE_ID || wayPointId >= FIRST_LANE_ID + NUM_LANES) {
+            return false;
+        }
+        wayPoint = WayPoint(lanes[wayPointId - FIRST_LANE_ID]);
+        return true;
+    }
+
+    ///Owns the lanes.
+    RoadSegment segment;
+    std::vector<const Lane*> lanes;
+};
+
+///An Agent at a fixed position, on a lane or not.
+class LaneAgent : public Agent {
+public:
+    LaneAgent(int x, int y, const Lane* lane, double distance) : Agent(MtxStrat_Buffered), lane(lane), distance(distance) {
+        xPos.force(x);
+        yPos.force(y);
+    }
+
+    virtual bool getLanePosition(WayPoint& wayPoint, double& currDistance) const {
+        if (!lane) {
+            return false;
+        }
+        wayPoint = WayPoint(lane);
+        currDistance = distance;
+        return true;
+    }
+
+    virtual bool isNonspatial() {
+        return false;
+    }
+
+protected:
+    virtual Entity::UpdateStatus frame_init(timeslice now) { throw std::runtime_error("frame_* methods not supported for Unit Tests."); }
+    virtual Entity::UpdateStatus frame_tick(timeslice now) { throw std::runtime_error("frame_* methods not supported for Unit Tests."); }
+    virtual void frame_output(timeslice now) { throw std::runtime_error("frame_* methods not supported for Unit Tests."); }
+
+private:
+    const Lane* lane;
+    double distance;
+};
+
+///Replaces the agents of the simulation by test agents while in scope.
+struct TestAgents {
+    TestAgents() {
+        saved.swap(Agent::all_agents);
+    }
+
+    ~TestAgents() {
+        for (std::set<Entity*>::iterator it = Agent::all_agents.begin(); it != Agent::all_agents.end(); ++it) {
+            delete *it;
+        }
+        Agent::all_agents.swap(saved);
+    }
+
+    const Agent* onLane(const Lane* lane, double distance) {
+        return add(new LaneAgent(static_cast<int>(distance), lane->getLaneIndex() * LANE_SPACING, lane, distance));
+    }
+
+    const Agent* offLane(int x, int y) {
+        return add(new LaneAgent(x, y, nullptr, 0));
+    }
+
+    const Agent* add(Agent* agent) {
+        Agent::all_agents.insert(agent);
+        return agent;
+    }
+
+    std::set<Entity*> saved;
+};
+
+std::vector<const Agent*> sorted(std::vector<const Agent*> agents) {
+    std::sort(agents.begin(), agents.end());
+    return agents;
+}
+} //End anon namespace
+
+void unit_tests::LaneAuraManagerUnitTests::test_NearbyOnLanes()
+{
+    Road road;
+    TestAgents agents;
+    const Agent* self = agents.onLane(road.lanes[1], 500);
+    const Agent* ahead = agents.onLane(road.lanes[1], 600);
+    agents.onLane(road.lanes[1], 700);
+    const Agent* left = agents.onLane(road.lanes[0], 460);
+    agents.onLane(road.lanes[2], 420);
+    agents.offLane(510, 20);
+    const Agent* pedestrian = agents.offLane(520, 6);
+
+    LaneAuraManager index(2);
+    index.update(0, std::set<Entity*>());
+
+    std::vector<const Agent*> expected;
+    expected.push_back(self);
+    expected.push_back(ahead);
+    expected.push_back(left);
+    expected.push_back(pedestrian);
+
+    Point position(500, LANE_SPACING);
+    std::vector<const Agent*> result(1, nullptr);
+    index.nearbyAgents(position, WayPoint(road.lanes[1]), 150, 50, self, result);
+    CPPUNIT_ASSERT(result.front() == nullptr);
+    result.erase(result.begin());
+    CPPUNIT_ASSERT(sorted(expected) == sorted(result));
+    CPPUNIT_ASSERT(sorted(expected) == sorted(index.nearbyAgents(position, WayPoint(road.lanes[1]), 150, 50, self)));
+
+    //Removed agents are no longer returned.
+    std::set<Entity*> removed;
+    removed.insert(const_cast<Agent*>(ahead));
+    index.update(1, removed);
+    expected.erase(std::find(expected.begin(), expected.end(), ahead));
+    CPPUNIT_ASSERT(sorted(expected) == sorted(index.nearbyAgents(position, WayPoint(road.lanes[1]), 150, 50, self)));
+}
+
+void unit_tests::LaneAuraManagerUnitTests::test_NearbyPastEndOfLane()
+{
+    Road road;
+    TestAgents agents;
+    const Agent* self = agents.onLane(road.lanes[1], 950);
+    const Agent* ahead = agents.onLane(road.lanes[1], 990);
+    agents.onLane(road.lanes[0], 880);
+    agents.onLane(road.lanes[2], 300);
+    agents.offLane(1040, 2);
+
+    LaneAuraManager index(1);
+    index.update(0, std::set<Entity*>());
+
+    Point position(950, LANE_SPACING);
+    Point lowerLeft, upperRight;
+    spatial::getSearchRectangle(position, WayPoint(road.lanes[1]), 150, 50, lowerLeft, upperRight);
+    std::vector<const Agent*> expected = index.agentsInRect(lowerLeft, upperRight, nullptr);
+    expected.push_back(self);
+    expected.push_back(ahead);
+    expected = sorted(expected);
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    CPPUNIT_ASSERT(expected == sorted(index.nearbyAgents(position, WayPoint(road.lanes[1]), 150, 50, self)));
+}
+
+void unit_tests::LaneAuraManagerUnitTests::test_TraceRoundTrip()
+{
+    std::vector<AuraFrame> frames(2);
+    for (unsigned int i = 0; i < 5; i++) {
+        AuraSample sample;
+        sample.agentId = i;
+        sample.x = 100 * i;
+        sample.y = -7;
+        if (i % 2 == 0) {
+            sample.wayPointType = AuraSample::ON_TURNING_PATH;
+            sample.wayPointId = 3000 + i;
+            sample.distance = 12.345678 * i;
+        }
+        frames[i % 2].push_back(sample);
+    }
+
+    std::stringstream trace;
+    AuraTrace::writeFrame(trace, frames[0]);
+    AuraTrace::writeFrame(trace, frames[1]);
+    AuraTrace::writeFrame(trace, AuraFrame());
+
+    AuraFrame frame;
+    for (unsigned int f = 0; f < 2; f++) {
+        CPPUNIT_ASSERT(AuraTrace::readFrame(trace, frame));
+        CPPUNIT_ASSERT_EQUAL(frames[f].size(), frame.size());
+        for (std::size_t i = 0; i < frame.size(); i++) {
+            CPPUNIT_ASSERT_EQUAL(frames[f][i].agentId, frame[i].agentId);
+            CPPUNIT_ASSERT_EQUAL(frames[f][i].x, frame[i].x);
+            CPPUNIT_ASSERT_EQUAL(frames[f][i].y, frame[i].y);
+            CPPUNIT_ASSERT_EQUAL(frames[f][i].wayPointType, frame[i].wayPointType);
+            CPPUNIT_ASSERT_EQUAL(frames[f][i].wayPointId, frame[i].wayPointId);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(frames[f][i].distance, frame[i].distance, 1e-6);
+        }
+    }
+    CPPUNIT_ASSERT(AuraTrace::readFrame(trace, frame));
+    CPPUNIT_ASSERT(frame.empty());
+    CPPUNIT_ASSERT(!AuraTrace::readFrame(trace, frame));
+
+    std::stringstream broken("frame 2\n1 2 3 L 10 5.5\n");
+    CPPUNIT_ASSERT_THROW(AuraTrace::readFrame(broken, frame), std::runtime_error);
+}
+
+void unit_tests::LaneAuraManagerUnitTests::test_ReplayMatches()
+{
+    Road road;
+    const unsigned int numAgents = 300;
+    const unsigned int numFrames = 30;
+
+    //Vehicles driving along the lanes, and pedestrians walking on the side of the road; some come and go.
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> start(0, LENGTH);
+    std::uniform_real_distribution<double> speed(0, 3);
+    std::uniform_int_distribution<unsigned int> frame(0, numFrames);
+    std::vector<double> distances(numAgents), speeds(numAgents);
+    std::vector<unsigned int> firstFrames(numAgents), lastFrames(numAgents);
+    for (unsigned int i = 0; i < numAgents; i++) {
+        distances[i] = start(rng);
+        speeds[i] = speed(rng);
+        firstFrames[i] = (i % 3 == 0) ? frame(rng) : 0;
+        lastFrames[i] = (i % 5 == 0) ? frame(rng) : numFrames;
+    }
+
+    std::vector<AuraFrame> frames(numFrames);
+    for (unsigned int f = 0; f < numFrames; f++) {
+        for (unsigned int i = 0; i < numAgents; i++) {
+            distances[i] += speeds[i];
+            if (distances[i] > LENGTH) {
+                distances[i] -= LENGTH;
+            }
+            if (f < firstFrames[i] || f > lastFrames[i]) {
+                continue;
+            }
+
+            AuraSample sample;
+            sample.agentId = 1000 + i;
+            sample.x = static_cast<int>(distances[i]);
+            if (i % 10 == 0) {
+                sample.y = -3;
+            } else {
+                sample.y = (i % NUM_LANES) * LANE_SPACING;
+                sample.wayPointType = AuraSample::ON_LANE;
+                sample.wayPointId = FIRST_LANE_ID + i % NUM_LANES;
+                sample.distance = distances[i];
+            }
+            frames[f].push_back(sample);
+        }
+    }
+
+    std::set<Entity*> simulated(Agent::all_agents);
+    AuraComparison comparison(boost::bind(&Road::resolve, &road, _1, _2, _3), 2);
+    AuraComparison::Report report = comparison.replay(frames);
+
+    std::stringstream msg;
+    report.print(msg);
+    CPPUNIT_ASSERT_MESSAGE(msg.str(), report.matches());
+    CPPUNIT_ASSERT_EQUAL(numFrames, report.numFrames);
+    CPPUNIT_ASSERT(report.numNearbyQueries > 0);
+    CPPUNIT_ASSERT(report.numRectQueries > 0);
+    CPPUNIT_ASSERT_EQUAL(0UL, report.numUnresolved);
+    CPPUNIT_ASSERT(simulated == Agent::all_agents);
+}
@@ -0,0 +1,42 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the LaneAuraManager class in Basic/spatial_trees/lane_index, and for the AuraComparison harness
+ * in Basic/spatial_trees.
+ */
+class LaneAuraManagerUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Queries must return the agents within the window on the lane and the adjacent ones, and the off-lane agents
+    ///in the search rectangle.
+    void test_NearbyOnLanes();
+
+    ///Queries whose window goes past the end of the lane must also return the agents in the search rectangle.
+    void test_NearbyPastEndOfLane();
+
+    ///Frames written to a trace must be read back unchanged.
+    void test_TraceRoundTrip();
+
+    ///Replaying moving agents through all the implementations must not find any mismatch.
+    void test_ReplayMatches();
+
+private:
+    CPPUNIT_TEST_SUITE(LaneAuraManagerUnitTests);
+        CPPUNIT_TEST(test_NearbyOnLanes);
+        CPPUNIT_TEST(test_NearbyPastEndOfLane);
+        CPPUNIT_TEST(test_TraceRoundTrip);
+        CPPUNIT_TEST(test_ReplayMatches);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
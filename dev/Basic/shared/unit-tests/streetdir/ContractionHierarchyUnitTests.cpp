@@ -0,0 +1,152 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <boost/chrono.hpp>
+
+#include "geospatial/streetdir/A_StarShortestPathImpl.hpp"
+#include "geospatial/streetdir/ContractionHierarchy.hpp"
+#include "geospatial/streetdir/CustomizableContractionHierarchy.hpp"
+
+#include "ContractionHierarchyUnitTests.hpp"
+#include "RoadGrid.hpp"
+
+using namespace sim_mob;
+using unit_tests::RoadGrid;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::ContractionHierarchyUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::ContractionHierarchyBenchmarks, "Benchmarks");
+
+void unit_tests::ContractionHierarchyUnitTests::test_PathsMatchDijkstra()
+{
+    RoadGrid grid(20, 30, 100, 7);
+    ContractionHierarchy hierarchy(grid.graph);
+    CPPUNIT_ASSERT_EQUAL(boost::num_vertices(grid.graph), hierarchy.getNumVertices());
+
+    std::uniform_int_distribution<unsigned int> vertex(0, boost::num_vertices(grid.graph) - 1);
+    std::vector<WayPoint> path;
+    for (unsigned int i = 0; i < 30; i++) {
+        StreetDirectory::Vertex source = vertex(grid.rng);
+        std::vector<double> dist = grid.dijkstra(source);
+        for (unsigned int j = 0; j < 20; j++) {
+            StreetDirectory::Vertex sink = vertex(grid.rng);
+            double cost = hierarchy.searchShortestPath(source, sink, path);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(dist[sink], cost, 1e-6);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(dist[sink], grid.checkPath(path, source, sink), 1e-6);
+            CPPUNIT_ASSERT_EQUAL(source == sink, path.empty());
+        }
+    }
+}
+
+void unit_tests::ContractionHierarchyUnitTests::test_UnreachableAndParallelEdges()
+{
+    //0 -> 1 -> 2 with a lighter parallel edge 0 -> 1; 3 is only reachable from 2 the other way round
+    RoadGrid grid(1, 1, 100, 1);
+    for (int i = 0; i < 3; i++) {
+        boost::add_vertex(grid.graph);
+    }
+    grid.storage.resize(16);
+    grid.addEdge(0, 1, 50);
+    grid.addEdge(0, 1, 20);
+    grid.addEdge(1, 2, 30);
+    grid.addEdge(3, 2, 10);
+
+    ContractionHierarchy hierarchy(grid.graph);
+    std::vector<WayPoint> path;
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50, hierarchy.searchShortestPath(0, 2, path), 1e-9);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 2, path.size());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, grid.edgeIndex(path[0]));
+
+    CPPUNIT_ASSERT(hierarchy.searchShortestPath(2, 0, path) == std::numeric_limits<double>::infinity());
+    CPPUNIT_ASSERT(path.empty());
+    CPPUNIT_ASSERT(hierarchy.searchShortestPath(0, 3, path) == std::numeric_limits<double>::infinity());
+    CPPUNIT_ASSERT(path.empty());
+}
+
+void unit_tests::ContractionHierarchyUnitTests::test_CustomizedPathsMatchDijkstra()
+{
+    RoadGrid grid(20, 30, 100, 11);
+    CustomizableContractionHierarchy hierarchy(grid.graph);
+    CPPUNIT_ASSERT_EQUAL(boost::num_vertices(grid.graph), hierarchy.getNumVertices());
+
+    std::uniform_int_distribution<unsigned int> vertex(0, boost::num_vertices(grid.graph) - 1);
+    std::uniform_real_distribution<double> congestion(0.5, 4.0);
+    std::vector<WayPoint> path;
+    for (int round = 0; round < 3; round++) {
+        for (unsigned int i = 0; i < 20; i++) {
+            StreetDirectory::Vertex source = vertex(grid.rng);
+            std::vector<double> dist = grid.dijkstra(source);
+            for (unsigned int j = 0; j < 20; j++) {
+                StreetDirectory::Vertex sink = vertex(grid.rng);
+                double cost = hierarchy.searchShortestPath(source, sink, path);
+                if (dist[sink] == std::numeric_limits<double>::max()) {
+                    CPPUNIT_ASSERT(cost == std::numeric_limits<double>::infinity());
+                    CPPUNIT_ASSERT(path.empty());
+                    continue;
+                }
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(dist[sink], cost, 1e-6);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(dist[sink], grid.checkPath(path, source, sink), 1e-6);
+            }
+        }
+
+        //New weights for the next round; closing edges may disconnect some vertices
+        const std::vector<WayPoint>& wayPoints = hierarchy.getEdgeWayPoints();
+        std::vector<double> weights(wayPoints.size());
+        for (std::size_t e = 0; e < wayPoints.size(); e++) {
+            weights[e] = (round == 1 && e % 7 == 0) ? std::numeric_limits<double>::infinity() : hierarchy.getEdgeWeights()[e] * congestion(grid.rng);
+            grid.setWeight(wayPoints[e], weights[e]);
+        }
+        hierarchy.customize(weights);
+    }
+}
+
+void unit_tests::ContractionHierarchyBenchmarks::test_query_benchmark()
+{
+    //A 10 km square with a road every 100 m
+    const unsigned int side = 100;
+    const unsigned int numQueries = 500;
+    RoadGrid grid(side, side, 100, 3);
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    ContractionHierarchy hierarchy(grid.graph);
+    double build = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    std::uniform_int_distribution<unsigned int> vertex(0, boost::num_vertices(grid.graph) - 1);
+    std::vector<std::pair<StreetDirectory::Vertex, StreetDirectory::Vertex> > pairs;
+    for (unsigned int i = 0; i < numQueries; i++) {
+        pairs.push_back(std::make_pair(vertex(grid.rng), vertex(grid.rng)));
+    }
+
+    std::vector<std::vector<WayPoint> > aStarPaths(numQueries);
+    start = boost::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numQueries; i++) {
+        aStarPaths[i] = A_StarShortestPathImpl::searchShortestPath(grid.graph, pairs[i].first, pairs[i].second);
+    }
+    double aStar = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::vector<WayPoint> > paths(numQueries);
+    start = boost::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numQueries; i++) {
+        hierarchy.searchShortestPath(pairs[i].first, pairs[i].second, paths[i]);
+    }
+    double contracted = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    for (unsigned int i = 0; i < numQueries; i++) {
+        double aStarCost = grid.checkPath(aStarPaths[i], pairs[i].first, pairs[i].second);
+        double cost = grid.checkPath(paths[i], pairs[i].first, pairs[i].second);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(aStarCost, cost, 1e-6);
+    }
+
+    std::cout << "\nShortest path benchmark (" << boost::num_vertices(grid.graph) << " vertices, " << boost::num_edges(grid.graph)
+              << " edges, " << numQueries << " random OD pairs)\n";
+    std::cout << "  contraction hierarchy built in " << build << " s, " << hierarchy.getNumShortcuts() << " shortcuts\n";
+    std::cout << "  A*: " << aStar * 1e6 / numQueries << " us/query\n";
+    std::cout << "  contraction hierarchy: " << contracted * 1e6 / numQueries << " us/query\n";
+}
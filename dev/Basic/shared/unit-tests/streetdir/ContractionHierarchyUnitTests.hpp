@@ -0,0 +1,54 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the ContractionHierarchy and CustomizableContractionHierarchy classes in Basic/geospatial/streetdir.
+ */
+class ContractionHierarchyUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Paths must be as short as those found by Dijkstra, and made of consecutive edges of the graph.
+    void test_PathsMatchDijkstra();
+
+    ///Unreachable sinks must give an empty path; parallel edges must be reduced to the lightest one.
+    void test_UnreachableAndParallelEdges();
+
+    ///Paths of the customizable hierarchy must be as short as those found by Dijkstra, before and after the weights
+    ///are replaced.
+    void test_CustomizedPathsMatchDijkstra();
+
+private:
+    CPPUNIT_TEST_SUITE(ContractionHierarchyUnitTests);
+        CPPUNIT_TEST(test_PathsMatchDijkstra);
+        CPPUNIT_TEST(test_UnreachableAndParallelEdges);
+        CPPUNIT_TEST(test_CustomizedPathsMatchDijkstra);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the ContractionHierarchy class; registered in the "Benchmarks" registry
+ * (SM_UnitTests --benchmarks).
+ */
+class ContractionHierarchyBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Compares the A* search of the StreetDirectory with the contraction hierarchy over random OD pairs on a road
+    ///grid. Prints the results.
+    void test_query_benchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(ContractionHierarchyBenchmarks);
+        CPPUNIT_TEST(test_query_benchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
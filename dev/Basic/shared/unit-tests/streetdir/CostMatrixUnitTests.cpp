@@ -0,0 +1,162 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include <boost/chrono.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "geospatial/streetdir/A_StarShortestPathImpl.hpp"
+#include "geospatial/streetdir/CostMatrix.hpp"
+
+#include "CostMatrixUnitTests.hpp"
+#include "RoadGrid.hpp"
+
+using namespace sim_mob;
+using unit_tests::RoadGrid;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::CostMatrixUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::CostMatrixBenchmarks, "Benchmarks");
+
+namespace {
+///A VertexDesc whose source and sink are the same vertex, as in the test graphs
+StreetDirectory::VertexDesc vertexDesc(StreetDirectory::Vertex v) {
+    StreetDirectory::VertexDesc desc(true);
+    desc.source = v;
+    desc.sink = v;
+    return desc;
+}
+
+///Random vertices of a graph
+std::vector<StreetDirectory::VertexDesc> randomVertices(const RoadGrid& grid, std::size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<unsigned int> vertex(0, boost::num_vertices(grid.graph) - 1);
+    std::vector<StreetDirectory::VertexDesc> res;
+    for (std::size_t i = 0; i < count; i++) {
+        res.push_back(vertexDesc(vertex(rng)));
+    }
+    return res;
+}
+}
+
+void unit_tests::CostMatrixUnitTests::test_CostsMatchDijkstra()
+{
+    RoadGrid grid(20, 30, 100, 5);
+    std::vector<StreetDirectory::VertexDesc> from = randomVertices(grid, 40, grid.rng);
+    std::vector<StreetDirectory::VertexDesc> to = randomVertices(grid, 50, grid.rng);
+    from[3] = from[7];
+    to[10] = to[20];
+    from[5] = StreetDirectory::VertexDesc(false);
+    to[8] = StreetDirectory::VertexDesc(false);
+
+    CostMatrix matrix;
+    A_StarShortestPathImpl::searchShortestPathCosts(grid.graph, from, to, 1, matrix);
+    CPPUNIT_ASSERT_EQUAL(from.size(), matrix.getNumOrigins());
+    CPPUNIT_ASSERT_EQUAL(to.size(), matrix.getNumDestinations());
+
+    for (std::size_t i = 0; i < from.size(); i++) {
+        std::vector<double> dist;
+        if (from[i].valid) {
+            dist = grid.dijkstra(from[i].source);
+        }
+        for (std::size_t j = 0; j < to.size(); j++) {
+            if (!from[i].valid || !to[j].valid) {
+                CPPUNIT_ASSERT(matrix.get(i, j) == CostMatrix::UNREACHABLE);
+            } else {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(dist[to[j].sink], matrix.get(i, j), 1e-6);
+            }
+        }
+    }
+
+    CostMatrix parallel;
+    A_StarShortestPathImpl::searchShortestPathCosts(grid.graph, from, to, 4, parallel);
+    for (std::size_t i = 0; i < from.size(); i++) {
+        for (std::size_t j = 0; j < to.size(); j++) {
+            CPPUNIT_ASSERT(matrix.get(i, j) == parallel.get(i, j));
+        }
+    }
+}
+
+void unit_tests::CostMatrixUnitTests::test_LinkCostsAndUnreachable()
+{
+    //0 -> 1 -> 2 -> 3, where 1 -> 2 is a connector; 4 is only reachable from 3 the other way round
+    RoadGrid grid(1, 1, 100, 1);
+    for (int i = 0; i < 4; i++) {
+        boost::add_vertex(grid.graph);
+    }
+    grid.storage.resize(16);
+    grid.addEdge(0, 1, 10);
+    StreetDirectory::Edge connector = boost::add_edge(1, 2, grid.graph).first;
+    boost::put(boost::edge_weight, grid.graph, connector, 1.0);
+    boost::put(boost::edge_name, grid.graph, connector, WayPoint(reinterpret_cast<const Node*>(&grid.storage[8])));
+    grid.addEdge(2, 3, 5);
+    grid.addEdge(4, 3, 7);
+
+    std::vector<StreetDirectory::VertexDesc> from;
+    from.push_back(vertexDesc(0));
+    from.push_back(vertexDesc(3));
+    std::vector<StreetDirectory::VertexDesc> to;
+    to.push_back(vertexDesc(3));
+    to.push_back(vertexDesc(0));
+    to.push_back(vertexDesc(4));
+
+    CostMatrix matrix;
+    A_StarShortestPathImpl::searchShortestPathCosts(grid.graph, from, to, 0, matrix);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(15, matrix.get(0, 0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0, matrix.get(0, 1), 1e-9);
+    CPPUNIT_ASSERT(matrix.get(0, 2) == CostMatrix::UNREACHABLE);
+    CPPUNIT_ASSERT(matrix.get(1, 1) == CostMatrix::UNREACHABLE);
+    CPPUNIT_ASSERT(matrix.getRow(1)[2] == CostMatrix::UNREACHABLE);
+}
+
+void unit_tests::CostMatrixBenchmarks::test_matrix_benchmark()
+{
+    //A 10 km square with a road every 100 m
+    const unsigned int side = 100;
+    const std::size_t numNodes = 1000;
+    const std::size_t numAStarPairs = 200;
+    RoadGrid grid(side, side, 100, 9);
+    std::vector<StreetDirectory::VertexDesc> from = randomVertices(grid, numNodes, grid.rng);
+    std::vector<StreetDirectory::VertexDesc> to = randomVertices(grid, numNodes, grid.rng);
+
+    CostMatrix matrix;
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    A_StarShortestPathImpl::searchShortestPathCosts(grid.graph, from, to, 1, matrix);
+    double serial = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    unsigned int numThreads = std::max(boost::thread::hardware_concurrency(), 1u);
+    CostMatrix parallel;
+    start = boost::chrono::steady_clock::now();
+    A_StarShortestPathImpl::searchShortestPathCosts(grid.graph, from, to, numThreads, parallel);
+    double threaded = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    //A* over a sample of the pairs, which must agree with the matrix
+    std::uniform_int_distribution<std::size_t> index(0, numNodes - 1);
+    start = boost::chrono::steady_clock::now();
+    std::vector<std::pair<std::size_t, std::size_t> > pairs;
+    std::vector<std::vector<WayPoint> > paths;
+    for (std::size_t k = 0; k < numAStarPairs; k++) {
+        std::size_t i = index(grid.rng);
+        std::size_t j = index(grid.rng);
+        pairs.push_back(std::make_pair(i, j));
+        paths.push_back(A_StarShortestPathImpl::searchShortestPath(grid.graph, from[i].source, to[j].sink));
+    }
+    double aStar = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    for (std::size_t k = 0; k < numAStarPairs; k++) {
+        std::size_t i = pairs[k].first;
+        std::size_t j = pairs[k].second;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(grid.checkPath(paths[k], from[i].source, to[j].sink), matrix.get(i, j), 1e-6);
+        CPPUNIT_ASSERT(matrix.get(i, j) == parallel.get(i, j));
+    }
+
+    std::cout << "\nCost matrix benchmark (" << boost::num_vertices(grid.graph) << " vertices, " << boost::num_edges(grid.graph)
+              << " edges, " << numNodes << "x" << numNodes << " random nodes)\n";
+    std::cout << "  A*, one search per pair: " << aStar * numNodes * numNodes / numAStarPairs << " s (extrapolated from "
+              << numAStarPairs << " pairs)\n";
+    std::cout << "  one-to-many Dijkstra, 1 thread: " << serial << " s\n";
+    std::cout << "  one-to-many Dijkstra, " << numThreads << " threads: " << threaded << " s\n";
+}
@@ -0,0 +1,47 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for A_StarShortestPathImpl::searchShortestPathCosts and the CostMatrix class in Basic/geospatial/streetdir.
+ */
+class CostMatrixUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Costs must match Dijkstra, whatever the number of threads; invalid origins and destinations are unreachable.
+    void test_CostsMatchDijkstra();
+
+    ///Only the weights of the LINK edges count in the costs; sinks which cannot be reached are unreachable.
+    void test_LinkCostsAndUnreachable();
+
+private:
+    CPPUNIT_TEST_SUITE(CostMatrixUnitTests);
+        CPPUNIT_TEST(test_CostsMatchDijkstra);
+        CPPUNIT_TEST(test_LinkCostsAndUnreachable);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the CostMatrix class; registered in the "Benchmarks" registry (SM_UnitTests --benchmarks).
+ */
+class CostMatrixBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Compares a 1000x1000 matrix with one A* search per pair, on a road grid. Prints the results.
+    void test_matrix_benchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(CostMatrixBenchmarks);
+        CPPUNIT_TEST(test_matrix_benchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,96 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <random>
+#include <vector>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "geospatial/streetdir/StreetDirectory.hpp"
+
+namespace unit_tests {
+
+///A grid of two-way roads, for the tests of the shortest path searches. The searches never dereference the WayPoints,
+///so every edge holds the address of a byte in an array, as the Link of its WayPoint.
+struct RoadGrid {
+    RoadGrid(unsigned int rows, unsigned int cols, double spacing, unsigned int seed) : rng(seed) {
+        std::uniform_real_distribution<double> detour(1.0, 1.5);
+        for (unsigned int r = 0; r < rows; r++) {
+            for (unsigned int c = 0; c < cols; c++) {
+                sim_mob::StreetDirectory::Vertex v = boost::add_vertex(graph);
+                boost::put(boost::vertex_name, graph, v, sim_mob::Point(c * spacing, r * spacing));
+            }
+        }
+
+        //Weights are at least the euclidean distance, so that the A* heuristic holds
+        storage.resize(4 * rows * cols);
+        for (unsigned int r = 0; r < rows; r++) {
+            for (unsigned int c = 0; c < cols; c++) {
+                if (c + 1 < cols) {
+                    double weight = spacing * detour(rng);
+                    addEdge(r * cols + c, r * cols + c + 1, weight);
+                    addEdge(r * cols + c + 1, r * cols + c, weight);
+                }
+                if (r + 1 < rows) {
+                    double weight = spacing * detour(rng);
+                    addEdge(r * cols + c, (r + 1) * cols + c, weight);
+                    addEdge((r + 1) * cols + c, r * cols + c, weight);
+                }
+            }
+        }
+    }
+
+    void addEdge(sim_mob::StreetDirectory::Vertex from, sim_mob::StreetDirectory::Vertex to, double weight) {
+        sim_mob::StreetDirectory::Edge edge = boost::add_edge(from, to, graph).first;
+        boost::put(boost::edge_weight, graph, edge, weight);
+        boost::put(boost::edge_name, graph, edge, sim_mob::WayPoint(reinterpret_cast<const sim_mob::Link*>(&storage[tails.size()])));
+        tails.push_back(from);
+        heads.push_back(to);
+        weights.push_back(weight);
+    }
+
+    std::size_t edgeIndex(const sim_mob::WayPoint& wp) const {
+        return reinterpret_cast<const char*>(wp.link) - &storage[0];
+    }
+
+    ///Sets the weight of the edge of a WayPoint
+    void setWeight(const sim_mob::WayPoint& wp, double weight) {
+        std::size_t edge = edgeIndex(wp);
+        boost::put(boost::edge_weight, graph, boost::edge(tails[edge], heads[edge], graph).first, weight);
+        weights[edge] = weight;
+    }
+
+    ///Distances of all vertices from a source
+    std::vector<double> dijkstra(sim_mob::StreetDirectory::Vertex source) const {
+        std::vector<double> dist(boost::num_vertices(graph));
+        boost::dijkstra_shortest_paths(graph, source, boost::distance_map(&dist[0]));
+        return dist;
+    }
+
+    ///Checks that the path is made of consecutive edges from source to sink, and returns its cost
+    double checkPath(const std::vector<sim_mob::WayPoint>& path, sim_mob::StreetDirectory::Vertex source, sim_mob::StreetDirectory::Vertex sink) const {
+        double cost = 0;
+        sim_mob::StreetDirectory::Vertex at = source;
+        for (std::vector<sim_mob::WayPoint>::const_iterator it = path.begin(); it != path.end(); ++it) {
+            std::size_t edge = edgeIndex(*it);
+            CPPUNIT_ASSERT(edge < tails.size());
+            CPPUNIT_ASSERT_EQUAL(at, tails[edge]);
+            at = heads[edge];
+            cost += weights[edge];
+        }
+        CPPUNIT_ASSERT_EQUAL(sink, at);
+        return cost;
+    }
+
+    sim_mob::StreetDirectory::Graph graph;
+    std::vector<char> storage;
+    std::vector<sim_mob::StreetDirectory::Vertex> tails;
+    std::vector<sim_mob::StreetDirectory::Vertex> heads;
+    std::vector<double> weights;
+    std::mt19937 rng;
+};
+
+}
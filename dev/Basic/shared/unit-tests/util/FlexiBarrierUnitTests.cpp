@@ -0,0 +1,162 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+
+#include "util/FlexiBarrier.hpp"
+
+#include "FlexiBarrierUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::FlexiBarrierUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::FlexiBarrierBenchmarks, "Benchmarks");
+
+namespace {
+const FlexiBarrier::Strategy STRATEGIES[] = { FlexiBarrier::BLOCKING, FlexiBarrier::SPIN_THEN_BLOCK };
+const unsigned int NUM_STRATEGIES = sizeof(STRATEGIES) / sizeof(STRATEGIES[0]);
+
+const char* strategyName(FlexiBarrier::Strategy strategy)
+{
+    return strategy == FlexiBarrier::BLOCKING ? "blocking" : "spin-then-block";
+}
+
+///Runs a number of barrier phases; after each phase, checks that every other thread has finished the previous phase.
+struct PhaseRunner {
+    PhaseRunner(FlexiBarrier& barrier, boost::atomic<unsigned int>& arrivals, unsigned int numThreads, unsigned int numPhases,
+                unsigned int amount, bool& error) :
+        barrier(barrier), arrivals(arrivals), numThreads(numThreads), numPhases(numPhases), amount(amount), error(error)
+    {}
+
+    void operator()() {
+        for (unsigned int phase = 0; phase < numPhases; phase++) {
+            arrivals.fetch_add(1);
+            barrier.wait(amount);
+            //Everyone must have arrived at this phase before anyone gets past it.
+            if (arrivals.load() < (phase + 1) * numThreads) {
+                error = true;
+            }
+        }
+    }
+
+    FlexiBarrier& barrier;
+    boost::atomic<unsigned int>& arrivals;
+    unsigned int numThreads;
+    unsigned int numPhases;
+    unsigned int amount;
+    bool& error;
+};
+
+///Time numPhases phases of numThreads threads (including the caller) on a barrier with the given strategy.
+double timePhases(FlexiBarrier::Strategy strategy, unsigned int numThreads, unsigned int numPhases)
+{
+    FlexiBarrier barrier(numThreads, strategy);
+    boost::atomic<unsigned int> arrivals(0);
+    bool error = false;
+
+    boost::thread_group threads;
+    for (unsigned int i = 1; i < numThreads; i++) {
+        threads.create_thread(PhaseRunner(barrier, arrivals, numThreads, numPhases, 1, error));
+    }
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    PhaseRunner(barrier, arrivals, numThreads, numPhases, 1, error)();
+    threads.join_all();
+    boost::chrono::duration<double, boost::micro> elapsed = boost::chrono::steady_clock::now() - start;
+
+    CPPUNIT_ASSERT_MESSAGE("Barrier released a thread too early.", !error);
+    return elapsed.count();
+}
+}
+
+void unit_tests::FlexiBarrierUnitTests::test_LeaderAndReset()
+{
+    for (unsigned int s = 0; s < NUM_STRATEGIES; s++) {
+        FlexiBarrier barrier(5, STRATEGIES[s]);
+        for (unsigned int generation = 0; generation < 3; generation++) {
+            CPPUNIT_ASSERT_MESSAGE("Contribution below threshold reported as leader.", !barrier.contribute(2));
+            CPPUNIT_ASSERT_MESSAGE("Contribution below threshold reported as leader.", !barrier.contribute(1));
+            CPPUNIT_ASSERT_MESSAGE("Final wait() not reported as leader.", barrier.wait(2));
+        }
+        CPPUNIT_ASSERT_MESSAGE("Single contribution of the full count not reported as leader.", barrier.contribute(5));
+    }
+}
+
+void unit_tests::FlexiBarrierUnitTests::test_Overflow()
+{
+    for (unsigned int s = 0; s < NUM_STRATEGIES; s++) {
+        FlexiBarrier barrier(3, STRATEGIES[s]);
+        barrier.contribute(2);
+        try {
+            barrier.contribute(2);
+            CPPUNIT_FAIL("contribute() overflow not detected.");
+        } catch (std::runtime_error& ex) { }
+        try {
+            barrier.wait(2);
+            CPPUNIT_FAIL("wait() overflow not detected.");
+        } catch (std::runtime_error& ex) { }
+
+        //The failed calls must not have changed the count.
+        CPPUNIT_ASSERT_MESSAGE("Barrier count changed by a failed call.", barrier.contribute(1));
+    }
+
+    try {
+        FlexiBarrier barrier(0, FlexiBarrier::SPIN_THEN_BLOCK);
+        CPPUNIT_FAIL("Zero count not rejected.");
+    } catch (std::runtime_error& ex) { }
+}
+
+void unit_tests::FlexiBarrierUnitTests::test_MultiThreadedPhases()
+{
+    const unsigned int numThreads = 4;
+    const unsigned int numPhases = 2000;
+
+    for (unsigned int s = 0; s < NUM_STRATEGIES; s++) {
+        //Use a small spin count so that the blocking fallback is exercised as well.
+        const unsigned int spinCounts[] = { FlexiBarrier::DEFAULT_SPIN_COUNT, 1 };
+        for (unsigned int sc = 0; sc < 2; sc++) {
+            //Three threads wait(1); the main thread contributes 2 and waits 1, mimicking WorkGroup::waitFrameTick()
+            FlexiBarrier barrier(numThreads + 2, STRATEGIES[s], spinCounts[sc]);
+            boost::atomic<unsigned int> arrivals(0);
+            bool error = false;
+
+            boost::thread_group threads;
+            for (unsigned int i = 1; i < numThreads; i++) {
+                threads.create_thread(PhaseRunner(barrier, arrivals, numThreads, numPhases, 1, error));
+            }
+            for (unsigned int phase = 0; phase < numPhases; phase++) {
+                arrivals.fetch_add(1);
+                barrier.contribute(2);
+                barrier.wait(1);
+                if (arrivals.load() < (phase + 1) * numThreads) {
+                    error = true;
+                }
+            }
+            threads.join_all();
+
+            CPPUNIT_ASSERT_MESSAGE("Barrier released a thread too early.", !error);
+        }
+    }
+}
+
+void unit_tests::FlexiBarrierBenchmarks::test_Benchmark()
+{
+    const unsigned int numPhases = 20000;
+    unsigned int maxThreads = std::max(2u, boost::thread::hardware_concurrency());
+
+    std::cout << "\nFlexiBarrier micro-benchmark (" << numPhases << " phases)\n";
+    for (unsigned int numThreads = 2; numThreads <= maxThreads; numThreads *= 2) {
+        std::cout << "  threads: " << numThreads;
+        for (unsigned int s = 0; s < NUM_STRATEGIES; s++) {
+            double micros = timePhases(STRATEGIES[s], numThreads, numPhases);
+            std::cout << " | " << strategyName(STRATEGIES[s]) << ": " << (micros / numPhases) << " us/phase";
+        }
+        std::cout << "\n";
+    }
+}
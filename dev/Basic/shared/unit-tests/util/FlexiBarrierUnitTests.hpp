@@ -0,0 +1,53 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the FlexiBarrier class in Basic/util, covering both wait strategies.
+ *   The multi-threaded tests may deadlock if the barrier is broken.
+ */
+class FlexiBarrierUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Only the call which brings the count to zero is the leader; the barrier then re-arms itself.
+    void test_LeaderAndReset();
+
+    ///Waiting or contributing more than the remaining count must throw.
+    void test_Overflow();
+
+    ///Threads must never run ahead of the barrier, with a mix of wait(1), wait(n) and contribute(n).
+    void test_MultiThreadedPhases();
+
+private:
+    CPPUNIT_TEST_SUITE(FlexiBarrierUnitTests);
+        CPPUNIT_TEST(test_LeaderAndReset);
+        CPPUNIT_TEST(test_Overflow);
+        CPPUNIT_TEST(test_MultiThreadedPhases);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the FlexiBarrier class; registered in the "Benchmarks" registry (SM_UnitTests --benchmarks).
+ */
+class FlexiBarrierBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Time many barrier phases with the blocking and the spin-then-block strategies.
+    ///Results are printed only; the test does not fail on timings.
+    void test_Benchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(FlexiBarrierBenchmarks);
+        CPPUNIT_TEST(test_Benchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
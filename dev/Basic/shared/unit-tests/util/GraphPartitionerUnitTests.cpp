@@ -0,0 +1,129 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <vector>
+
+#include "util/GraphPartitioner.hpp"
+
+#include "GraphPartitionerUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::GraphPartitionerUnitTests);
+
+namespace {
+const unsigned int GRID_SIZE = 12;
+
+///A GRID_SIZE x GRID_SIZE grid of unit vertices and unit edges.
+void makeGrid(GraphPartitioner& partitioner) {
+    for (unsigned int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        partitioner.addVertex(1.0);
+    }
+    for (unsigned int r = 0; r < GRID_SIZE; r++) {
+        for (unsigned int c = 0; c < GRID_SIZE; c++) {
+            if (c + 1 < GRID_SIZE) {
+                partitioner.addEdge(r * GRID_SIZE + c, r * GRID_SIZE + c + 1, 1.0);
+            }
+            if (r + 1 < GRID_SIZE) {
+                partitioner.addEdge(r * GRID_SIZE + c, (r + 1) * GRID_SIZE + c, 1.0);
+            }
+        }
+    }
+}
+} //End anon namespace
+
+void unit_tests::GraphPartitionerUnitTests::test_TwoCliques()
+{
+    GraphPartitioner partitioner;
+    const unsigned int cliqueSize = 5;
+    for (unsigned int i = 0; i < 2 * cliqueSize; i++) {
+        partitioner.addVertex(1.0);
+    }
+    for (unsigned int k = 0; k < 2; k++) {
+        for (unsigned int i = 0; i < cliqueSize; i++) {
+            for (unsigned int j = i + 1; j < cliqueSize; j++) {
+                partitioner.addEdge(k * cliqueSize + i, k * cliqueSize + j, 10.0);
+            }
+        }
+    }
+    partitioner.addEdge(cliqueSize - 1, cliqueSize, 1.0);
+
+    std::vector<unsigned int> parts = partitioner.partition(2, 0.0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2 * cliqueSize), parts.size());
+    for (unsigned int i = 1; i < cliqueSize; i++) {
+        CPPUNIT_ASSERT_EQUAL(parts[0], parts[i]);
+        CPPUNIT_ASSERT_EQUAL(parts[cliqueSize], parts[cliqueSize + i]);
+    }
+    CPPUNIT_ASSERT(parts[0] != parts[cliqueSize]);
+
+    PartitionStats stats = partitioner.computeStats(parts, 2);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, stats.cutWeight, 1e-9);
+    CPPUNIT_ASSERT_EQUAL(1u, stats.cutEdges);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, stats.imbalance, 1e-9);
+}
+
+void unit_tests::GraphPartitionerUnitTests::test_GridBalanceAndCut()
+{
+    GraphPartitioner partitioner;
+    makeGrid(partitioner);
+    const double tolerance = 0.05;
+    std::vector<unsigned int> parts = partitioner.partition(4, tolerance);
+    PartitionStats stats = partitioner.computeStats(parts, 4);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), stats.loads.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(double(GRID_SIZE * GRID_SIZE), stats.totalLoad, 1e-9);
+    CPPUNIT_ASSERT(stats.imbalance <= tolerance + 1e-9);
+    for (unsigned int p = 0; p < 4; p++) {
+        CPPUNIT_ASSERT(stats.loads[p] > 0.0);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(double(stats.cutEdges), stats.cutWeight, 1e-9);
+
+    //cutting the grid into quadrants cuts 2 * GRID_SIZE edges; the heuristic must stay within twice that, far below
+    //the cut of a balanced assignment that ignores the edges (here, diagonal stripes, which cut every edge)
+    CPPUNIT_ASSERT(stats.cutWeight <= 4.0 * GRID_SIZE);
+    std::vector<unsigned int> stripes(GRID_SIZE * GRID_SIZE);
+    for (unsigned int i = 0; i < stripes.size(); i++) {
+        stripes[i] = (i / GRID_SIZE + i % GRID_SIZE) % 4;
+    }
+    CPPUNIT_ASSERT(stats.cutWeight * 4.0 < partitioner.computeStats(stripes, 4).cutWeight);
+}
+
+void unit_tests::GraphPartitionerUnitTests::test_Stats()
+{
+    GraphPartitioner partitioner;
+    partitioner.addVertex(1.0);
+    partitioner.addVertex(2.0);
+    partitioner.addVertex(3.0);
+    partitioner.addVertex(6.0);
+    partitioner.addEdge(0, 1, 1.5);
+    partitioner.addEdge(1, 0, 0.5); //parallel to the edge above; each added edge is counted
+    partitioner.addEdge(1, 2, 4.0);
+    partitioner.addEdge(2, 3, 7.0);
+    partitioner.addEdge(3, 3, 100.0); //self loops are never cut
+
+    std::vector<unsigned int> parts;
+    parts.push_back(0);
+    parts.push_back(1);
+    parts.push_back(1);
+    parts.push_back(0);
+    PartitionStats stats = partitioner.computeStats(parts, 2);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(9.0, stats.cutWeight, 1e-9);
+    CPPUNIT_ASSERT_EQUAL(3u, stats.cutEdges);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(12.0, stats.totalLoad, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, stats.loads[0], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, stats.loads[1], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, stats.maxLoad, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, stats.minLoad, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0 / 6.0 - 1.0, stats.imbalance, 1e-9);
+}
+
+void unit_tests::GraphPartitionerUnitTests::test_Deterministic()
+{
+    GraphPartitioner first(7);
+    GraphPartitioner second(7);
+    makeGrid(first);
+    makeGrid(second);
+    CPPUNIT_ASSERT(first.partition(3, 0.05) == second.partition(3, 0.05));
+}
@@ -0,0 +1,40 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the GraphPartitioner class in Basic/util.
+ */
+class GraphPartitionerUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Two heavy cliques joined by a light bridge are split at the bridge, with equal loads.
+    void test_TwoCliques();
+
+    ///A grid split into four parts stays within the imbalance tolerance, with a cut close to the quadrant cut.
+    void test_GridBalanceAndCut();
+
+    ///The cut and load statistics of a given partition are computed exactly; self loops are never cut.
+    void test_Stats();
+
+    ///The same seed gives the same partition.
+    void test_Deterministic();
+
+private:
+    CPPUNIT_TEST_SUITE(GraphPartitionerUnitTests);
+        CPPUNIT_TEST(test_TwoCliques);
+        CPPUNIT_TEST(test_GridBalanceAndCut);
+        CPPUNIT_TEST(test_Stats);
+        CPPUNIT_TEST(test_Deterministic);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
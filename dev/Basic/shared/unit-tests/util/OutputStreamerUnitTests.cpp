@@ -0,0 +1,148 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "util/OutputStreamer.hpp"
+
+#include "OutputStreamerUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::OutputStreamerUnitTests);
+
+namespace {
+const std::size_t NUM_PRODUCERS = 4;
+const std::size_t LINES_PER_PRODUCER = 500;
+
+///Keeps everything written to it; optionally slow, or failing after a number of writes.
+struct RecordingSink : public OutputSink {
+    RecordingSink(unsigned int delayMs = 0, int failAfter = -1) : delayMs(delayMs), failAfter(failAfter), writes(0), closed(0) {}
+
+    virtual void write(const std::string& data) {
+        if (failAfter >= 0 && writes >= failAfter) {
+            throw std::runtime_error("sink failure");
+        }
+        if (delayMs > 0) {
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(delayMs));
+        }
+        contents.append(data);
+        writes++;
+    }
+
+    virtual void close() {
+        closed++;
+    }
+
+    unsigned int delayMs;
+    int failAfter;
+    int writes;
+    int closed;
+    std::string contents;
+};
+
+///Appends numbered lines of two fields each, one or two lines per call.
+void produce(OutputStreamer& streamer, std::size_t producerId) {
+    for (std::size_t i = 0; i < LINES_PER_PRODUCER; i += 2) {
+        std::ostringstream lines;
+        lines << producerId << "," << i << "\n" << producerId << "," << i + 1 << "\n";
+        streamer.append(producerId, lines.str());
+    }
+}
+
+///Produces, and records whether the streamer refused the output.
+void produceUntilFailure(OutputStreamer& streamer, std::size_t producerId, bool& failed) {
+    try {
+        produce(streamer, producerId);
+    } catch (const std::runtime_error&) {
+        failed = true;
+    }
+}
+
+///Checks that the text consists of the lines of all producers, each exactly once.
+void checkLines(const std::string& text) {
+    std::vector< std::vector<int> > seen(NUM_PRODUCERS, std::vector<int>(LINES_PER_PRODUCER, 0));
+    std::istringstream in(text);
+    std::string line;
+    std::size_t numLines = 0;
+    while (std::getline(in, line)) {
+        std::size_t producerId, lineNo;
+        char comma;
+        std::istringstream fields(line);
+        CPPUNIT_ASSERT(fields >> producerId >> comma >> lineNo);
+        CPPUNIT_ASSERT(producerId < NUM_PRODUCERS && lineNo < LINES_PER_PRODUCER);
+        seen[producerId][lineNo]++;
+        numLines++;
+    }
+    CPPUNIT_ASSERT_EQUAL(NUM_PRODUCERS * LINES_PER_PRODUCER, numLines);
+    for (std::size_t p = 0; p < NUM_PRODUCERS; p++) {
+        for (std::size_t i = 0; i < LINES_PER_PRODUCER; i++) {
+            CPPUNIT_ASSERT_EQUAL(1, seen[p][i]);
+        }
+    }
+}
+} //End anon namespace
+
+void unit_tests::OutputStreamerUnitTests::test_AllLinesWritten()
+{
+    const std::string fileName = "OutputStreamerUnitTests.out";
+    boost::shared_ptr<RecordingSink> slowSink(new RecordingSink(1));
+    std::vector< boost::shared_ptr<OutputSink> > sinks;
+    sinks.push_back(slowSink);
+    sinks.push_back(boost::shared_ptr<OutputSink>(new FileOutputSink(fileName)));
+
+    //Small buffers and a single queue slot make the producers wait for the slow sink.
+    OutputStreamer streamer(NUM_PRODUCERS, 100, 1, sinks);
+    boost::thread_group producers;
+    for (std::size_t p = 0; p < NUM_PRODUCERS; p++) {
+        producers.create_thread(boost::bind(produce, boost::ref(streamer), p));
+    }
+    producers.join_all();
+    streamer.finish();
+
+    CPPUNIT_ASSERT_EQUAL(1, slowSink->closed);
+    CPPUNIT_ASSERT_EQUAL(slowSink->contents.size(), streamer.getBytesWritten());
+    CPPUNIT_ASSERT(streamer.getWaitSeconds() > 0);
+    checkLines(slowSink->contents);
+
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    std::ostringstream fileContents;
+    fileContents << file.rdbuf();
+    file.close();
+    std::remove(fileName.c_str());
+    CPPUNIT_ASSERT(fileContents.str() == slowSink->contents);
+}
+
+void unit_tests::OutputStreamerUnitTests::test_SinkFailure()
+{
+    boost::shared_ptr<RecordingSink> sink(new RecordingSink(0, 3));
+    std::vector< boost::shared_ptr<OutputSink> > sinks(1, sink);
+
+    OutputStreamer streamer(1, 100, 1, sinks);
+    bool failed = false;
+    produceUntilFailure(streamer, 0, failed);
+    CPPUNIT_ASSERT(failed);
+    CPPUNIT_ASSERT_THROW(streamer.finish(), std::runtime_error);
+    CPPUNIT_ASSERT_EQUAL(0, sink->closed);
+}
+
+void unit_tests::OutputStreamerUnitTests::test_Abandoned()
+{
+    boost::shared_ptr<RecordingSink> sink(new RecordingSink());
+    {
+        std::vector< boost::shared_ptr<OutputSink> > sinks(1, sink);
+        OutputStreamer streamer(1, 100, 4, sinks);
+        produce(streamer, 0);
+    }
+    CPPUNIT_ASSERT_EQUAL(0, sink->closed);
+}
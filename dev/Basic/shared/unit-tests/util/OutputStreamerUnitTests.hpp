@@ -0,0 +1,36 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the OutputStreamer class in Basic/util.
+ */
+class OutputStreamerUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///All lines of all producers must reach every sink exactly once and unbroken, even when producers must wait.
+    void test_AllLinesWritten();
+
+    ///A failing sink must stop the producers and its error must be rethrown by finish().
+    void test_SinkFailure();
+
+    ///Sinks of a streamer destroyed before finish() must not be closed.
+    void test_Abandoned();
+
+private:
+    CPPUNIT_TEST_SUITE(OutputStreamerUnitTests);
+        CPPUNIT_TEST(test_AllLinesWritten);
+        CPPUNIT_TEST(test_SinkFailure);
+        CPPUNIT_TEST(test_Abandoned);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,121 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <stdexcept>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+
+#include "util/Prefetcher.hpp"
+
+#include "PrefetcherUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::PrefetcherUnitTests);
+
+namespace {
+///An item of the tests: its index, and the thread which produced it.
+struct Item {
+    Item() : index(0), id(0) {}
+
+    std::size_t index;
+    boost::thread::id producer;
+
+    ///Handed out by the taking thread.
+    unsigned int id;
+};
+
+///Produces items, taking longer for some of them; throws for the item of index failAt.
+struct Producer {
+    Producer(std::size_t failAt) : failAt(failAt), numProduced(0) {}
+
+    void operator()(std::size_t index, Item& item) {
+        if (index == failAt) {
+            throw std::runtime_error("producer failure");
+        }
+        boost::this_thread::sleep_for(boost::chrono::milliseconds((index * 7) % 3));
+        item.index = index;
+        item.producer = boost::this_thread::get_id();
+        numProduced++;
+    }
+
+    std::size_t failAt;
+    boost::atomic<std::size_t> numProduced;
+};
+
+const std::size_t NEVER = static_cast<std::size_t>(-1);
+
+void sleepMs(int ms) {
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(ms));
+}
+} //End anon namespace
+
+void unit_tests::PrefetcherUnitTests::test_Order()
+{
+    const unsigned int lookaheads[] = { 0, 1, 3 };
+    for (unsigned int l = 0; l < 3; l++) {
+        Producer producer(NEVER);
+        Prefetcher<Item> prefetcher(boost::ref(producer), lookaheads[l]);
+        unsigned int nextId = 100;
+        for (std::size_t i = 0; i < 12; i++) {
+            if (i % 4 == 0) {
+                sleepMs(5); //lets the producer get ahead
+            }
+            Item item;
+            prefetcher.take(item);
+            item.id = nextId++;
+            CPPUNIT_ASSERT_EQUAL(i, item.index);
+            CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(100 + i), item.id);
+            CPPUNIT_ASSERT_EQUAL(lookaheads[l] == 0, item.producer == boost::this_thread::get_id());
+        }
+    }
+}
+
+void unit_tests::PrefetcherUnitTests::test_Lookahead()
+{
+    Producer producer(NEVER);
+    Prefetcher<Item> prefetcher(boost::ref(producer), 2);
+    Item item;
+    for (std::size_t taken = 1; taken <= 3; taken++) {
+        prefetcher.take(item);
+        sleepMs(50);
+        CPPUNIT_ASSERT_EQUAL(taken + 2, producer.numProduced.load());
+    }
+}
+
+void unit_tests::PrefetcherUnitTests::test_Error()
+{
+    const unsigned int lookaheads[] = { 0, 2 };
+    for (unsigned int l = 0; l < 2; l++) {
+        Producer producer(2);
+        Prefetcher<Item> prefetcher(boost::ref(producer), lookaheads[l]);
+        Item item;
+        prefetcher.take(item);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), item.index);
+        sleepMs(20);
+        prefetcher.take(item);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), item.index);
+        CPPUNIT_ASSERT_THROW(prefetcher.take(item), std::runtime_error);
+    }
+}
+
+void unit_tests::PrefetcherUnitTests::test_Stop()
+{
+    Producer producer(NEVER);
+    Prefetcher<Item> prefetcher(boost::ref(producer), 2);
+    Item item;
+    prefetcher.take(item);
+    sleepMs(50);
+
+    std::vector<Item> pending;
+    prefetcher.stop(pending);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), pending.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), pending[0].index);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), pending[1].index);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), producer.numProduced.load());
+    CPPUNIT_ASSERT_THROW(prefetcher.take(item), std::runtime_error);
+}
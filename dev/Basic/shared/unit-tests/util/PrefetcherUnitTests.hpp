@@ -0,0 +1,41 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the Prefetcher class in Basic/util.
+ */
+class PrefetcherUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Items are taken in order whatever the lookahead and the timing of the producer, so that ids handed out by the
+    ///taking thread always follow the order of the items; only a lookahead of 0 produces on the taking thread.
+    void test_Order();
+
+    ///The producer never gets more items ahead than the lookahead.
+    void test_Lookahead();
+
+    ///An exception thrown by the producer is rethrown by take(), after the items produced before it.
+    void test_Error();
+
+    ///Stopping hands back the items produced and not taken, in order.
+    void test_Stop();
+
+private:
+    CPPUNIT_TEST_SUITE(PrefetcherUnitTests);
+        CPPUNIT_TEST(test_Order);
+        CPPUNIT_TEST(test_Lookahead);
+        CPPUNIT_TEST(test_Error);
+        CPPUNIT_TEST(test_Stop);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,225 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cmath>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "util/RandomService.hpp"
+
+#include "RandomServiceUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::RandomServiceUnitTests);
+
+namespace {
+void checkBlock(const boost::uint32_t* block, boost::uint32_t w0, boost::uint32_t w1, boost::uint32_t w2, boost::uint32_t w3) {
+    CPPUNIT_ASSERT_EQUAL(w0, block[0]);
+    CPPUNIT_ASSERT_EQUAL(w1, block[1]);
+    CPPUNIT_ASSERT_EQUAL(w2, block[2]);
+    CPPUNIT_ASSERT_EQUAL(w3, block[3]);
+}
+
+void drawCurrent(RandomStream* stream, RandomStream** current) {
+    RandomService::Scope scope(*stream);
+    *current = &RandomService::current();
+}
+void drawThreadStream(bool setId, boost::uint32_t streamId, boost::uint32_t* first) {
+    if (setId) {
+        RandomService::setThreadStreamId(streamId);
+    }
+    *first = RandomService::current()();
+}
+} //End anon namespace
+
+void unit_tests::RandomServiceUnitTests::test_PhiloxKnownAnswers()
+{
+    boost::uint32_t block[4];
+    const boost::uint32_t zeroCounter[4] = {0, 0, 0, 0};
+    const boost::uint32_t zeroKey[2] = {0, 0};
+    Philox4x32::generate(zeroCounter, zeroKey, block);
+    checkBlock(block, 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8);
+
+    const boost::uint32_t onesCounter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+    const boost::uint32_t onesKey[2] = {0xffffffff, 0xffffffff};
+    Philox4x32::generate(onesCounter, onesKey, block);
+    checkBlock(block, 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd);
+
+    const boost::uint32_t piCounter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    const boost::uint32_t piKey[2] = {0xa4093822, 0x299f31d0};
+    Philox4x32::generate(piCounter, piKey, block);
+    checkBlock(block, 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1);
+
+    //Bulk blocks are those of the consecutive counters, across the carry into the high word of the index.
+    const boost::uint32_t counter[4] = {0xfffffffa, 0, 7, 1};
+    std::vector<boost::uint32_t> blocks(4 * 11);
+    Philox4x32::generate(counter, piKey, 11, &blocks[0]);
+    for (boost::uint64_t i = 0; i < 11; i++) {
+        boost::uint64_t index = 0xfffffffaULL + i;
+        const boost::uint32_t single[4] = {static_cast<boost::uint32_t>(index), static_cast<boost::uint32_t>(index >> 32), 7, 1};
+        Philox4x32::generate(single, piKey, block);
+        checkBlock(&blocks[4 * i], block[0], block[1], block[2], block[3]);
+    }
+}
+
+void unit_tests::RandomServiceUnitTests::test_Streams()
+{
+    RandomStream stream(42, 7, RANDOM_GENERIC);
+    RandomStream same(42, 7, RANDOM_GENERIC);
+    RandomStream otherSeed(43, 7, RANDOM_GENERIC);
+    RandomStream otherId(42, 8, RANDOM_GENERIC);
+    RandomStream otherPurpose(42, 7, RANDOM_THREAD);
+    unsigned int differences[3] = {0, 0, 0};
+    for (unsigned int i = 0; i < 100; i++) {
+        boost::uint32_t word = stream();
+        CPPUNIT_ASSERT_EQUAL(word, same());
+        differences[0] += (word != otherSeed());
+        differences[1] += (word != otherId());
+        differences[2] += (word != otherPurpose());
+    }
+    CPPUNIT_ASSERT_EQUAL(100u, differences[0]);
+    CPPUNIT_ASSERT_EQUAL(100u, differences[1]);
+    CPPUNIT_ASSERT_EQUAL(100u, differences[2]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<boost::uint64_t>(100), stream.getPosition());
+
+    //Streams created without a seed take the global one.
+    const boost::uint64_t previousSeed = RandomService::getSeed();
+    RandomService::setSeed(42);
+    RandomStream global(7);
+    RandomService::setSeed(previousSeed);
+    RandomStream fresh(42, 7, RANDOM_GENERIC);
+    for (unsigned int i = 0; i < 10; i++) {
+        CPPUNIT_ASSERT_EQUAL(fresh(), global());
+    }
+}
+
+void unit_tests::RandomServiceUnitTests::test_BulkMatchesSingle()
+{
+    const std::size_t counts[] = {0, 1, 2, 3, 7, 100, 513, 2000};
+    for (unsigned int offset = 0; offset < 5; offset++) {
+        for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+            const std::size_t count = counts[c];
+            std::vector<double> values(count + 1);
+
+            RandomStream bulk(1, 2, 3);
+            RandomStream single(1, 2, 3);
+            for (unsigned int i = 0; i < offset; i++) {
+                bulk();
+                single();
+            }
+            bulk.fillUniform(&values[0], count, -2.0, 3.0);
+            for (std::size_t i = 0; i < count; i++) {
+                CPPUNIT_ASSERT_EQUAL(single.uniform(-2.0, 3.0), values[i]);
+            }
+            CPPUNIT_ASSERT_EQUAL(single.getPosition(), bulk.getPosition());
+            CPPUNIT_ASSERT_EQUAL(single(), bulk());
+
+            RandomStream bulkNormal(1, 2, 3);
+            RandomStream singleNormal(1, 2, 3);
+            for (unsigned int i = 0; i < offset; i++) {
+                bulkNormal.normal(0.0, 1.0);
+                singleNormal.normal(0.0, 1.0);
+            }
+            bulkNormal.fillLognormal(&values[0], count, 1.0, 0.5);
+            for (std::size_t i = 0; i < count; i++) {
+                CPPUNIT_ASSERT_EQUAL(singleNormal.lognormal(1.0, 0.5), values[i]);
+            }
+            CPPUNIT_ASSERT_EQUAL(singleNormal.normal(0.0, 1.0), bulkNormal.normal(0.0, 1.0));
+        }
+    }
+}
+
+void unit_tests::RandomServiceUnitTests::test_Distributions()
+{
+    RandomStream stream(5, 6, RANDOM_GENERIC);
+    const unsigned int numDraws = 200000;
+    std::vector<unsigned int> histogram(10);
+    double sum = 0.0, sumSquares = 0.0, logSum = 0.0;
+    unsigned int numTrue = 0;
+    for (unsigned int i = 0; i < numDraws; i++) {
+        double u = stream.uniform(2.0, 4.0);
+        CPPUNIT_ASSERT(u >= 2.0 && u < 4.0);
+
+        int k = stream.uniformInt(-3, 6);
+        CPPUNIT_ASSERT(k >= -3 && k <= 6);
+        histogram[k + 3]++;
+
+        double x = stream.normal(1.0, 2.0);
+        sum += x;
+        sumSquares += (x - 1.0) * (x - 1.0);
+
+        double y = stream.lognormal(0.5, 0.25);
+        CPPUNIT_ASSERT(y > 0.0);
+        logSum += std::log(y);
+
+        numTrue += stream.bernoulli(0.3);
+    }
+    for (std::size_t i = 0; i < histogram.size(); i++) {
+        CPPUNIT_ASSERT(std::abs(static_cast<double>(histogram[i]) - numDraws / 10.0) < numDraws / 100.0);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, sum / numDraws, 0.02);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, sumSquares / numDraws, 0.05);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, logSum / numDraws, 0.005);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.3, static_cast<double>(numTrue) / numDraws, 0.005);
+
+    CPPUNIT_ASSERT_EQUAL(4, stream.uniformInt(4, 4));
+    stream.uniformInt(-2147483647 - 1, 2147483647);
+}
+
+void unit_tests::RandomServiceUnitTests::test_Scope()
+{
+    RandomStream& threadStream = RandomService::current();
+    CPPUNIT_ASSERT_EQUAL(&threadStream, &RandomService::current());
+
+    RandomStream agentStream(1, 1, RANDOM_GENERIC);
+    RandomStream otherAgentStream(1, 2, RANDOM_GENERIC);
+    RandomStream* otherThreadCurrent = nullptr;
+    {
+        RandomService::Scope scope(agentStream);
+        CPPUNIT_ASSERT_EQUAL(&agentStream, &RandomService::current());
+        {
+            RandomService::Scope inner(otherAgentStream);
+            CPPUNIT_ASSERT_EQUAL(&otherAgentStream, &RandomService::current());
+        }
+        CPPUNIT_ASSERT_EQUAL(&agentStream, &RandomService::current());
+
+        boost::thread other(boost::bind(drawCurrent, &otherAgentStream, &otherThreadCurrent));
+        other.join();
+        CPPUNIT_ASSERT_EQUAL(&agentStream, &RandomService::current());
+    }
+    CPPUNIT_ASSERT_EQUAL(&otherAgentStream, otherThreadCurrent);
+    CPPUNIT_ASSERT_EQUAL(&threadStream, &RandomService::current());
+}
+
+void unit_tests::RandomServiceUnitTests::test_ThreadStreams()
+{
+    //Each thread draws its first number; the threads run one after the other, in both orders
+    boost::uint32_t draws[2][3];
+    for (unsigned int order = 0; order < 2; order++) {
+        for (unsigned int i = 0; i < 3; i++) {
+            unsigned int t = (order == 0) ? i : 2 - i;
+            boost::thread thread(boost::bind(drawThreadStream, t > 0, 6 + t, &draws[order][t]));
+            thread.join();
+        }
+    }
+
+    RandomStream unnamed(0, RANDOM_THREAD);
+    RandomStream first(7, RANDOM_THREAD);
+    RandomStream second(8, RANDOM_THREAD);
+    const boost::uint32_t expected[3] = { unnamed(), first(), second() };
+    for (unsigned int order = 0; order < 2; order++) {
+        for (unsigned int t = 0; t < 3; t++) {
+            CPPUNIT_ASSERT_EQUAL(expected[t], draws[order][t]);
+        }
+    }
+
+    RandomStream& current = RandomService::current();
+    {
+        RandomService::Scope scope(static_cast<RandomStream*>(nullptr));
+        CPPUNIT_ASSERT_EQUAL(&current, &RandomService::current());
+    }
+    CPPUNIT_ASSERT_EQUAL(&current, &RandomService::current());
+}
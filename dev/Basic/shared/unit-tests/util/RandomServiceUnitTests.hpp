@@ -0,0 +1,49 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the RandomService and RandomStream classes in Basic/util.
+ */
+class RandomServiceUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Philox blocks match the known answers of the reference implementation, one at a time and in bulk.
+    void test_PhiloxKnownAnswers();
+
+    ///Streams only depend on the seed, the stream id and the purpose.
+    void test_Streams();
+
+    ///Bulk draws give the same values as single draws, whatever the position in the stream.
+    void test_BulkMatchesSingle();
+
+    ///Draws fall in their ranges and have the expected moments.
+    void test_Distributions();
+
+    ///The stream of a scope is current on its thread only, until the scope ends.
+    void test_Scope();
+
+    ///Out of any scope, a thread draws from the stream of the id it set, or of id 0, whatever the order in which
+    ///the threads start; a null scope leaves the current stream unchanged.
+    void test_ThreadStreams();
+
+private:
+    CPPUNIT_TEST_SUITE(RandomServiceUnitTests);
+        CPPUNIT_TEST(test_PhiloxKnownAnswers);
+        CPPUNIT_TEST(test_Streams);
+        CPPUNIT_TEST(test_BulkMatchesSingle);
+        CPPUNIT_TEST(test_Distributions);
+        CPPUNIT_TEST(test_Scope);
+        CPPUNIT_TEST(test_ThreadStreams);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,158 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <limits>
+#include <set>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "util/ShardedCache.hpp"
+
+#include "ShardedCacheUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::ShardedCacheUnitTests);
+
+namespace {
+typedef ShardedCache<unsigned int> Cache;
+
+Cache::ValueType value(unsigned int v) {
+    return Cache::ValueType(new unsigned int(v));
+}
+
+///Each key maps to a value derived from it, so that readers can check what they find.
+unsigned int valueOf(const Cache::KeyType& key) {
+    return key.origin * 7 + key.destination * 3 + 1;
+}
+
+Cache::KeyType key(unsigned int i) {
+    return Cache::makeKey(i, i + 1);
+}
+
+void readWrite(Cache& cache, unsigned int threadId, unsigned int rounds, boost::atomic<int>& wrong) {
+    for (unsigned int i = 0; i < rounds; i++) {
+        Cache::KeyType key = Cache::makeKey((i + threadId) % 97, (i / 97) % 60);
+        Cache::ValueType found;
+        if (cache.find(key, found)) {
+            if (*found != valueOf(key)) {
+                wrong++;
+            }
+        } else {
+            cache.insert(key, value(valueOf(key)));
+        }
+    }
+}
+} //End anon namespace
+
+void unit_tests::ShardedCacheUnitTests::test_FindInsert()
+{
+    Cache cache(100, 4);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), cache.getNumShards());
+
+    Cache::ValueType found;
+    CPPUNIT_ASSERT(!cache.find(key(1), found));
+    for (unsigned int i = 0; i < 50; i++) {
+        cache.insert(key(i), value(i));
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), cache.size());
+    for (unsigned int i = 0; i < 50; i++) {
+        CPPUNIT_ASSERT(cache.find(key(i), found));
+        CPPUNIT_ASSERT_EQUAL(i, *found);
+    }
+
+    //Replacing a value keeps the size.
+    cache.insert(key(10), value(1000));
+    CPPUNIT_ASSERT(cache.find(key(10), found));
+    CPPUNIT_ASSERT_EQUAL(1000u, *found);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), cache.size());
+
+    Cache::Statistics stats = cache.getStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(51), stats.hits);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), stats.misses);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(51), stats.insertions);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), stats.evictions);
+}
+
+void unit_tests::ShardedCacheUnitTests::test_ClockEviction()
+{
+    Cache cache(4, 1);
+    for (unsigned int i = 0; i < 4; i++) {
+        cache.insert(key(i), value(i));
+    }
+
+    //0 and 2 get a second chance; 1 is the first unmarked entry after the hand.
+    Cache::ValueType found;
+    CPPUNIT_ASSERT(cache.find(key(0), found));
+    CPPUNIT_ASSERT(cache.find(key(2), found));
+    cache.insert(key(4), value(4));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), cache.size());
+    CPPUNIT_ASSERT(!cache.find(key(1), found));
+    CPPUNIT_ASSERT(cache.find(key(0), found));
+    CPPUNIT_ASSERT(cache.find(key(2), found));
+
+    //0 and 2 were marked again, so the hand passes over them once more and evicts 3.
+    cache.insert(key(5), value(5));
+    CPPUNIT_ASSERT(!cache.find(key(3), found));
+
+    //The hand stands on 0, still marked from the find above, and evicts 4 after it.
+    cache.insert(key(6), value(6));
+    CPPUNIT_ASSERT(!cache.find(key(4), found));
+    CPPUNIT_ASSERT(cache.find(key(5), found));
+    CPPUNIT_ASSERT(cache.find(key(6), found));
+
+    Cache::Statistics stats = cache.getStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), stats.evictions);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(7), stats.insertions);
+}
+
+void unit_tests::ShardedCacheUnitTests::test_MakeKey()
+{
+    std::set<Cache::KeyType> keys;
+    const unsigned int ids[] = { 0, 1, 2, 1000, (1u << 26), std::numeric_limits<unsigned int>::max() };
+    for (unsigned int o = 0; o < 6; o++) {
+        for (unsigned int d = 0; d < 6; d++) {
+            for (unsigned int t = 0; t < 6; t++) {
+                CPPUNIT_ASSERT(keys.insert(Cache::makeKey(ids[o], ids[d], ids[t])).second);
+                CPPUNIT_ASSERT(keys.insert(Cache::makeKey(ids[o], ids[d], ids[t], 1)).second);
+            }
+        }
+    }
+    CPPUNIT_ASSERT(Cache::makeKey(1, 2) != Cache::makeKey(2, 1));
+    CPPUNIT_ASSERT(Cache::makeKey(1, 2, 3, 4) == Cache::makeKey(1, 2, 3, 4));
+
+    //Large ids are stored and found like small ones.
+    Cache cache(10, 2);
+    Cache::KeyType large = Cache::makeKey(std::numeric_limits<unsigned int>::max(), (1u << 26) + 5, 4096);
+    cache.insert(large, value(42));
+    Cache::ValueType found;
+    CPPUNIT_ASSERT(cache.find(large, found));
+    CPPUNIT_ASSERT_EQUAL(42u, *found);
+    CPPUNIT_ASSERT(!cache.find(Cache::makeKey(std::numeric_limits<unsigned int>::max(), 5, 4096), found));
+}
+
+void unit_tests::ShardedCacheUnitTests::test_Concurrent()
+{
+    //Smaller than the number of keys, so that the threads also evict each other's entries.
+    Cache cache(4000, 8);
+    const unsigned int numThreads = 4;
+    const unsigned int rounds = 20000;
+    boost::atomic<int> wrong(0);
+    boost::thread_group threads;
+    for (unsigned int i = 0; i < numThreads; i++) {
+        threads.create_thread(boost::bind(readWrite, boost::ref(cache), i, rounds, boost::ref(wrong)));
+    }
+    threads.join_all();
+
+    CPPUNIT_ASSERT_EQUAL(0, wrong.load());
+    CPPUNIT_ASSERT(cache.size() <= 4000);
+    Cache::Statistics stats = cache.getStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(numThreads * rounds), stats.hits + stats.misses);
+    CPPUNIT_ASSERT_EQUAL(stats.misses, stats.insertions);
+    CPPUNIT_ASSERT(stats.hits > 0);
+    //find() never waits for the shard lock, only insert() can.
+    CPPUNIT_ASSERT(stats.lockWaits <= stats.insertions);
+}
@@ -0,0 +1,41 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the ShardedCache class in Basic/util.
+ */
+class ShardedCacheUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Inserted values are found again, replaced by later insertions, and counted in the statistics.
+    void test_FindInsert();
+
+    ///A full shard evicts the entries not found since the hand last passed them, in ring order.
+    void test_ClockEviction();
+
+    ///Keys are distinct per origin, destination, interval and kind, for any 32 bit id.
+    void test_MakeKey();
+
+    ///Threads finding and inserting keys at the same time always read the values stored for their keys, and the
+    ///statistics counted by each thread add up.
+    void test_Concurrent();
+
+private:
+    CPPUNIT_TEST_SUITE(ShardedCacheUnitTests);
+        CPPUNIT_TEST(test_FindInsert);
+        CPPUNIT_TEST(test_ClockEviction);
+        CPPUNIT_TEST(test_MakeKey);
+        CPPUNIT_TEST(test_Concurrent);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
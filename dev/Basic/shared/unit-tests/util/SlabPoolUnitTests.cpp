@@ -0,0 +1,193 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <cstring>
+#include <deque>
+#include <set>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "util/SlabPool.hpp"
+
+#include "SlabPoolUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::SlabPoolUnitTests);
+
+namespace {
+void freeAll(const std::vector<void*>& blocks) {
+    for (std::vector<void*>::const_iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        SlabPool::deallocate(*it);
+    }
+}
+
+///Counts its live instances.
+struct Tracked {
+    Tracked(int value, boost::atomic<int>& live) : value(value), live(live) {
+        live++;
+    }
+
+    ~Tracked() {
+        live--;
+    }
+
+    int value;
+    boost::atomic<int>& live;
+};
+
+void dropPointers(std::vector< boost::shared_ptr<Tracked> >& pointers) {
+    pointers.clear();
+}
+
+///Blocks passed from one thread to the next; each block is filled with the id of its sender and a sequence number.
+struct Exchange {
+    static const std::size_t BLOCK_SIZE = 100;
+
+    explicit Exchange(std::size_t numThreads) : queues(numThreads), mutexes(numThreads), received(0), corrupted(0) {
+    }
+
+    void run(std::size_t threadId, int rounds) {
+        std::size_t next = (threadId + 1) % queues.size();
+        for (int i = 0; i < rounds; i++) {
+            unsigned char* block = static_cast<unsigned char*>(SlabPool::allocate(BLOCK_SIZE));
+            std::memset(block, static_cast<int>(threadId * 31 + i % 7), BLOCK_SIZE);
+            {
+                boost::mutex::scoped_lock lock(mutexes[next]);
+                queues[next].push_back(std::make_pair(block, static_cast<int>(threadId * 31 + i % 7)));
+            }
+            if (i % 3 == 0) {
+                //some blocks stay with their owner
+                SlabPool::deallocate(SlabPool::allocate(BLOCK_SIZE / 2));
+            }
+            drain(threadId);
+        }
+    }
+
+    void drain(std::size_t threadId) {
+        std::deque< std::pair<unsigned char*, int> > mine;
+        {
+            boost::mutex::scoped_lock lock(mutexes[threadId]);
+            mine.swap(queues[threadId]);
+        }
+        for (std::deque< std::pair<unsigned char*, int> >::iterator it = mine.begin(); it != mine.end(); ++it) {
+            for (std::size_t b = 0; b < BLOCK_SIZE; b++) {
+                if (it->first[b] != static_cast<unsigned char>(it->second)) {
+                    corrupted++;
+                    break;
+                }
+            }
+            SlabPool::deallocate(it->first);
+            received++;
+        }
+    }
+
+    std::vector< std::deque< std::pair<unsigned char*, int> > > queues;
+    std::vector<boost::mutex> mutexes;
+    boost::atomic<int> received;
+    boost::atomic<int> corrupted;
+};
+} //End anon namespace
+
+void unit_tests::SlabPoolUnitTests::test_LocalReuse()
+{
+    SlabPool::Stats before = SlabPool::getStats();
+
+    void* first = SlabPool::allocate(24);
+    CPPUNIT_ASSERT(first);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), reinterpret_cast<std::size_t>(first) % 16);
+    SlabPool::deallocate(first);
+    CPPUNIT_ASSERT(SlabPool::allocate(20) == first);
+    SlabPool::deallocate(first);
+
+    //Blocks of different size classes do not overlap.
+    std::set<char*> starts;
+    std::vector<void*> blocks;
+    for (std::size_t size = 1; size <= SlabPool::MAX_BLOCK_SIZE; size += 37) {
+        char* block = static_cast<char*>(SlabPool::allocate(size));
+        std::memset(block, 0xAB, size);
+        CPPUNIT_ASSERT(starts.insert(block).second);
+        blocks.push_back(block);
+    }
+    freeAll(blocks);
+
+    void* large = SlabPool::allocate(SlabPool::MAX_BLOCK_SIZE + 1);
+    std::memset(large, 0, SlabPool::MAX_BLOCK_SIZE + 1);
+    SlabPool::deallocate(large);
+    SlabPool::deallocate(nullptr);
+
+    SlabPool::Stats after = SlabPool::getStats();
+    CPPUNIT_ASSERT_EQUAL(before.largeAllocations + 1, after.largeAllocations);
+    CPPUNIT_ASSERT_EQUAL(before.allocations + 2 + blocks.size(), after.allocations);
+    CPPUNIT_ASSERT_EQUAL(before.localFrees + 2 + blocks.size(), after.localFrees);
+}
+
+void unit_tests::SlabPoolUnitTests::test_RemoteFree()
+{
+    //A size class used by no other test, so that the free list of this thread is empty to start with.
+    const std::size_t size = 300;
+    const std::size_t numBlocks = 1000;
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < numBlocks; i++) {
+        blocks.push_back(SlabPool::allocate(size));
+    }
+
+    SlabPool::Stats before = SlabPool::getStats();
+    boost::thread freer(boost::bind(freeAll, boost::cref(blocks)));
+    freer.join();
+    SlabPool::Stats freed = SlabPool::getStats();
+    CPPUNIT_ASSERT_EQUAL(before.remoteFrees + numBlocks, freed.remoteFrees);
+
+    //The blocks are reused by this thread without new slabs.
+    std::set<void*> original(blocks.begin(), blocks.end());
+    std::vector<void*> again;
+    for (std::size_t i = 0; i < numBlocks; i++) {
+        again.push_back(SlabPool::allocate(size));
+        CPPUNIT_ASSERT(original.count(again.back()) == 1);
+    }
+    SlabPool::Stats after = SlabPool::getStats();
+    CPPUNIT_ASSERT_EQUAL(freed.slabs, after.slabs);
+    CPPUNIT_ASSERT(after.reclaims > freed.reclaims);
+    freeAll(again);
+}
+
+void unit_tests::SlabPoolUnitTests::test_SharedPtr()
+{
+    boost::atomic<int> live(0);
+    std::vector< boost::shared_ptr<Tracked> > pointers;
+    for (int i = 0; i < 100; i++) {
+        pointers.push_back(boost::allocate_shared<Tracked>(SlabAllocator<Tracked>(), i, boost::ref(live)));
+    }
+    CPPUNIT_ASSERT_EQUAL(100, live.load());
+    for (int i = 0; i < 100; i++) {
+        CPPUNIT_ASSERT_EQUAL(i, pointers[i]->value);
+    }
+
+    //The last references are dropped by another thread.
+    boost::thread dropper(boost::bind(dropPointers, boost::ref(pointers)));
+    dropper.join();
+    CPPUNIT_ASSERT_EQUAL(0, live.load());
+}
+
+void unit_tests::SlabPoolUnitTests::test_Concurrent()
+{
+    const std::size_t numThreads = 4;
+    const int rounds = 20000;
+    Exchange exchange(numThreads);
+    boost::thread_group threads;
+    for (std::size_t i = 0; i < numThreads; i++) {
+        threads.create_thread(boost::bind(&Exchange::run, &exchange, i, rounds));
+    }
+    threads.join_all();
+    for (std::size_t i = 0; i < numThreads; i++) {
+        exchange.drain(i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, exchange.corrupted.load());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(numThreads) * rounds, exchange.received.load());
+}
@@ -0,0 +1,40 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the SlabPool class in Basic/util.
+ */
+class SlabPoolUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///A block freed by its own thread is handed out again; large requests bypass the slabs.
+    void test_LocalReuse();
+
+    ///Blocks freed by another thread return to the pool they came from and are reused by its owner.
+    void test_RemoteFree();
+
+    ///Objects created with allocate_shared and SlabAllocator are destroyed exactly once, on any thread.
+    void test_SharedPtr();
+
+    ///Threads passing blocks to each other while allocating must not lose or corrupt any block.
+    void test_Concurrent();
+
+private:
+    CPPUNIT_TEST_SUITE(SlabPoolUnitTests);
+        CPPUNIT_TEST(test_LocalReuse);
+        CPPUNIT_TEST(test_RemoteFree);
+        CPPUNIT_TEST(test_SharedPtr);
+        CPPUNIT_TEST(test_Concurrent);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,322 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <utility>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+
+#include "util/RandomService.hpp"
+#include "util/TimingWheel.hpp"
+
+#include "TimingWheelUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::TimingWheelUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::TimingWheelBenchmarks, "Benchmarks");
+
+namespace {
+typedef boost::uint64_t Tick;
+
+///An item which knows its tick.
+struct Timed {
+    Timed() : at(0), id(0) {
+    }
+
+    Timed(Tick at, unsigned int id) : at(at), id(id) {
+    }
+
+    Tick at;
+    unsigned int id;
+};
+
+///Checks that each item is handed back at its tick, and counts the items of each id.
+template <typename Wheel>
+struct Checker {
+    Checker(const Wheel& wheel, std::size_t numIds) : wheel(wheel), handedBack(numIds, 0), late(0), early(0) {
+    }
+
+    void operator()(Timed& timed) {
+        if (timed.at < wheel.getTime()) {
+            late++;
+        } else if (timed.at > wheel.getTime()) {
+            early++;
+        }
+        handedBack[timed.id]++;
+    }
+
+    void check() const {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Items handed back late.", std::size_t(0), late);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Items handed back early.", std::size_t(0), early);
+    }
+
+    const Wheel& wheel;
+    std::vector<unsigned int> handedBack;
+    std::size_t late;
+    std::size_t early;
+};
+
+///Schedules a follow-up of each item, and an item due at the tick being handed back.
+struct Rescheduler {
+    explicit Rescheduler(TimingWheel<Timed>& wheel) : wheel(wheel), numHandedBack(0), numWrongTick(0) {
+    }
+
+    void operator()(Timed& timed) {
+        numHandedBack++;
+        if (timed.at != wheel.getTime()) {
+            numWrongTick++;
+        }
+        if (timed.id > 0) {
+            const Tick at = (timed.id % 2 == 0) ? wheel.getTime() : wheel.getTime() + 300;
+            wheel.schedule(at, Timed(at, timed.id - 1));
+        }
+    }
+
+    TimingWheel<Timed>& wheel;
+    unsigned int numHandedBack;
+    unsigned int numWrongTick;
+};
+
+void scheduleFromThread(ConcurrentTimingWheel<Timed>* wheel, unsigned int threadId, unsigned int numItems) {
+    RandomStream random(7, threadId, RANDOM_GENERIC);
+    for (unsigned int i = 0; i < numItems; i++) {
+        const Tick at = 1 + random.uniformInt(0, 5000);
+        wheel->schedule(at, Timed(at, threadId * numItems + i));
+    }
+}
+
+///Orders items by tick, the earliest first.
+struct LaterTick {
+    bool operator()(const Timed& t1, const Timed& t2) const {
+        return t1.at > t2.at;
+    }
+};
+
+///Adds up the ids of the items handed back, so that handing them back is not optimised away.
+struct Summer {
+    Summer() : sum(0) {
+    }
+
+    void operator()(Timed& timed) {
+        sum += timed.id;
+    }
+
+    boost::uint64_t sum;
+};
+
+double elapsedNanos(const boost::chrono::high_resolution_clock::time_point& start) {
+    return static_cast<double>(boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+            boost::chrono::high_resolution_clock::now() - start).count());
+}
+} //End anon namespace
+
+void unit_tests::TimingWheelUnitTests::test_Order()
+{
+    const unsigned int numItems = 20000;
+    const unsigned int steps[] = { 1, 7, 1000 };
+    for (unsigned int s = 0; s < 3; s++) {
+        TimingWheel<Timed> wheel;
+        RandomStream random(1, s, RANDOM_GENERIC);
+        for (unsigned int i = 0; i < numItems; i++) {
+            const Tick at = 1 + random.uniformInt(0, 100000);
+            wheel.schedule(at, Timed(at, i));
+        }
+        CPPUNIT_ASSERT_EQUAL(std::size_t(numItems), wheel.size());
+
+        //With steps of more than one tick, the handler sees the tick of each item as the time advances
+        Checker< TimingWheel<Timed> > checker(wheel, numItems);
+        while (wheel.getTime() < 100001) {
+            wheel.advance(wheel.getTime() + steps[s], checker);
+        }
+        checker.check();
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), wheel.size());
+        for (unsigned int i = 0; i < numItems; i++) {
+            CPPUNIT_ASSERT_EQUAL(1u, checker.handedBack[i]);
+        }
+    }
+
+    //Items scheduled for the current tick or before are due at the next advance
+    TimingWheel<Timed> wheel(50);
+    wheel.schedule(10, Timed(50, 0));
+    wheel.schedule(50, Timed(50, 1));
+    Checker< TimingWheel<Timed> > checker(wheel, 2);
+    wheel.advance(50, checker);
+    checker.check();
+    CPPUNIT_ASSERT_EQUAL(1u, checker.handedBack[0]);
+    CPPUNIT_ASSERT_EQUAL(1u, checker.handedBack[1]);
+}
+
+void unit_tests::TimingWheelUnitTests::test_Cancel()
+{
+    const unsigned int numItems = 1000;
+    TimingWheel<Timed> wheel;
+    std::vector<TimingWheel<Timed>::Handle> handles;
+    for (unsigned int i = 0; i < numItems; i++) {
+        const Tick at = 1 + (i * 37) % 700;
+        handles.push_back(wheel.schedule(at, Timed(at, i)));
+    }
+    for (unsigned int i = 0; i < numItems; i += 3) {
+        CPPUNIT_ASSERT(wheel.cancel(handles[i]));
+        CPPUNIT_ASSERT(!wheel.cancel(handles[i]));
+    }
+
+    Checker< TimingWheel<Timed> > checker(wheel, numItems);
+    wheel.advance(350, checker);
+
+    //The handles of the items handed back are reused; the old handles must not cancel the new items
+    std::vector<TimingWheel<Timed>::Handle> newHandles;
+    for (unsigned int i = 0; i < numItems; i++) {
+        if (checker.handedBack[i] > 0) {
+            CPPUNIT_ASSERT(!wheel.cancel(handles[i]));
+            newHandles.push_back(wheel.schedule(500, Timed(500, i)));
+        }
+    }
+    wheel.advance(1000, checker);
+    checker.check();
+    for (unsigned int i = 0; i < numItems; i++) {
+        const unsigned int expected = (i % 3 == 0) ? 0 : ((1 + (i * 37) % 700) <= 350 ? 2 : 1);
+        CPPUNIT_ASSERT_EQUAL(expected, checker.handedBack[i]);
+    }
+    CPPUNIT_ASSERT(!wheel.cancel(newHandles.front()));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), wheel.size());
+
+    //Cancelling everything lets the time jump to the target
+    TimingWheel<Timed>::Handle handle = wheel.schedule(5000000, Timed(5000000, 0));
+    CPPUNIT_ASSERT(wheel.cancel(handle));
+    wheel.advance(10000000, checker);
+    CPPUNIT_ASSERT_EQUAL(Tick(10000000), wheel.getTime());
+    CPPUNIT_ASSERT_EQUAL(0u, checker.handedBack[0]);
+}
+
+void unit_tests::TimingWheelUnitTests::test_Cascade()
+{
+    //Ticks at the boundaries of the wheels and of the overflow slot
+    const Tick ticks[] = { 255, 256, 257, 65535, 65536, 65537, 16777216, 16777217, 4294967295ULL, 4294967296ULL,
+                           4294967297ULL, 8589934592ULL, 8589934593ULL };
+    const unsigned int numTicks = sizeof(ticks) / sizeof(ticks[0]);
+    TimingWheel<Timed> wheel;
+    for (unsigned int i = 0; i < numTicks; i++) {
+        wheel.schedule(ticks[i], Timed(ticks[i], i));
+    }
+
+    Checker< TimingWheel<Timed> > checker(wheel, numTicks);
+    for (unsigned int i = 0; i < numTicks; i++) {
+        //Stop just before each tick, then advance to it
+        wheel.advance(ticks[i] - 1, checker);
+        CPPUNIT_ASSERT_EQUAL(0u, checker.handedBack[i]);
+        wheel.advance(ticks[i], checker);
+        CPPUNIT_ASSERT_EQUAL(1u, checker.handedBack[i]);
+    }
+    checker.check();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), wheel.size());
+
+    //Scheduling from a time which is not aligned to the wheels
+    TimingWheel<Timed> shifted(123456789);
+    for (unsigned int i = 0; i < numTicks; i++) {
+        shifted.schedule(123456789 + ticks[i], Timed(123456789 + ticks[i], i));
+    }
+    Checker< TimingWheel<Timed> > shiftedChecker(shifted, numTicks);
+    shifted.advance(123456789 + ticks[numTicks - 1], shiftedChecker);
+    shiftedChecker.check();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), shifted.size());
+}
+
+void unit_tests::TimingWheelUnitTests::test_HandlerSchedules()
+{
+    TimingWheel<Timed> wheel;
+    wheel.schedule(10, Timed(10, 6));
+    Rescheduler rescheduler(wheel);
+
+    //6 and 4 are rescheduled at the same tick, 5 and 3 300 ticks later
+    wheel.advance(10, rescheduler);
+    CPPUNIT_ASSERT_EQUAL(2u, rescheduler.numHandedBack);
+    wheel.advance(2000, rescheduler);
+    CPPUNIT_ASSERT_EQUAL(7u, rescheduler.numHandedBack);
+    CPPUNIT_ASSERT_EQUAL(0u, rescheduler.numWrongTick);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), wheel.size());
+}
+
+void unit_tests::TimingWheelUnitTests::test_Concurrent()
+{
+    const unsigned int numThreads = 4;
+    const unsigned int numItems = 20000;
+    ConcurrentTimingWheel<Timed> wheel;
+    Checker< ConcurrentTimingWheel<Timed> > checker(wheel, numThreads * numItems);
+
+    //The wheel advances while the threads schedule; none of their items is due before the threads are done
+    boost::thread_group threads;
+    for (unsigned int i = 0; i < numThreads; i++) {
+        threads.create_thread(boost::bind(scheduleFromThread, &wheel, i, numItems));
+    }
+    for (unsigned int i = 0; i < 100; i++) {
+        wheel.advance(0, checker);
+    }
+    threads.join_all();
+
+    Tick time = 0;
+    while (time <= 5001) {
+        time++;
+        wheel.advance(time, checker);
+    }
+    checker.check();
+    for (unsigned int i = 0; i < numThreads * numItems; i++) {
+        CPPUNIT_ASSERT_EQUAL(1u, checker.handedBack[i]);
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), wheel.size());
+}
+
+void unit_tests::TimingWheelBenchmarks::test_Benchmark()
+{
+    const unsigned int numItems = 1000000;
+    const Tick dayTicks = 86400;
+
+    std::vector<Tick> ticks(numItems);
+    RandomStream random(3, 0, RANDOM_GENERIC);
+    for (unsigned int i = 0; i < numItems; i++) {
+        ticks[i] = 1 + random.uniformInt(0, static_cast<int>(dayTicks) - 1);
+    }
+
+    TimingWheel<Timed> wheel;
+    boost::chrono::high_resolution_clock::time_point start = boost::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < numItems; i++) {
+        wheel.schedule(ticks[i], Timed(ticks[i], i));
+    }
+    const double wheelSchedule = elapsedNanos(start);
+    Summer wheelSum;
+    start = boost::chrono::high_resolution_clock::now();
+    for (Tick time = 1; time <= dayTicks; time++) {
+        wheel.advance(time, wheelSum);
+    }
+    const double wheelDrain = elapsedNanos(start);
+
+    std::priority_queue<Timed, std::vector<Timed>, LaterTick> queue;
+    start = boost::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < numItems; i++) {
+        queue.push(Timed(ticks[i], i));
+    }
+    const double queueSchedule = elapsedNanos(start);
+    Summer queueSum;
+    start = boost::chrono::high_resolution_clock::now();
+    for (Tick time = 1; time <= dayTicks; time++) {
+        while (!queue.empty() && queue.top().at <= time) {
+            Timed timed = queue.top();
+            queue.pop();
+            queueSum(timed);
+        }
+    }
+    const double queueDrain = elapsedNanos(start);
+
+    CPPUNIT_ASSERT_EQUAL(queueSum.sum, wheelSum.sum);
+    std::cout << "\nTimingWheel micro-benchmark (" << numItems << " items over " << dayTicks << " ticks)\n";
+    std::cout << "  timing wheel:   schedule " << (wheelSchedule / numItems) << " ns/item | drain "
+              << (wheelDrain / numItems) << " ns/item\n";
+    std::cout << "  priority queue: schedule " << (queueSchedule / numItems) << " ns/item | drain "
+              << (queueDrain / numItems) << " ns/item\n";
+}
@@ -0,0 +1,60 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the TimingWheel and ConcurrentTimingWheel classes in Basic/util.
+ */
+class TimingWheelUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Items are handed back exactly at their tick, whether the time advances one tick or many ticks at a time.
+    void test_Order();
+
+    ///Cancelled items are never handed back; stale handles cannot cancel other items.
+    void test_Cancel();
+
+    ///Items of the outer wheels and of the overflow slot cascade down and are handed back at their tick.
+    void test_Cascade();
+
+    ///The handler can schedule items, including items due at the tick being handed back.
+    void test_HandlerSchedules();
+
+    ///Items scheduled by several threads at once are all handed back at their tick.
+    void test_Concurrent();
+
+private:
+    CPPUNIT_TEST_SUITE(TimingWheelUnitTests);
+        CPPUNIT_TEST(test_Order);
+        CPPUNIT_TEST(test_Cancel);
+        CPPUNIT_TEST(test_Cascade);
+        CPPUNIT_TEST(test_HandlerSchedules);
+        CPPUNIT_TEST(test_Concurrent);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the TimingWheel class; registered in the "Benchmarks" registry (SM_UnitTests --benchmarks).
+ */
+class TimingWheelBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Micro-benchmark: 1M items scheduled over a simulated day of one second ticks, against std::priority_queue.
+    ///Results are printed only; the test does not fail on timings.
+    void test_Benchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(TimingWheelBenchmarks);
+        CPPUNIT_TEST(test_Benchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
@@ -0,0 +1,213 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "util/RandomService.hpp"
+#include "util/TopCMerge.hpp"
+
+#include "TopCMergeUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::TopCMergeUnitTests);
+
+namespace {
+///An element with its key; the elements are compared by address.
+struct Item {
+    Item() : key(0.0) {
+    }
+
+    double key;
+};
+
+struct ItemKey {
+    double operator()(const Item* item) const {
+        return item->key;
+    }
+};
+
+typedef std::deque<Item*> ItemList;
+
+///The top C merge as a linear scan of the heads at each step.
+///@return false if no head could be picked before C elements were merged.
+bool linearScanTopC(std::vector<ItemList>& lists, int capacity, RandomStream& random, std::vector<Item*>& merged) {
+    std::vector<ItemList::iterator> iterators;
+    for (std::vector<ItemList>::iterator it = lists.begin(); it != lists.end(); ++it) {
+        iterators.push_back(it->begin());
+    }
+
+    for (int c = 0; c < capacity; c++) {
+        double minVal = std::numeric_limits<double>::max();
+        std::vector<std::pair<int, Item*> > equiList;
+        for (std::size_t i = 0; i < lists.size(); i++) {
+            if (iterators[i] != lists[i].end()) {
+                Item* item = *iterators[i];
+                if (item->key == minVal) {
+                    equiList.push_back(std::make_pair(i, item));
+                } else if (item->key < minVal) {
+                    minVal = item->key;
+                    equiList.clear();
+                    equiList.push_back(std::make_pair(i, item));
+                }
+            }
+        }
+        if (equiList.empty()) {
+            return false;
+        }
+        std::pair<int, Item*> chosen = equiList.front();
+        if (equiList.size() > 1) {
+            chosen = equiList[random.uniformInt(0, equiList.size() - 1)];
+        }
+        iterators[chosen.first]++;
+        merged.push_back(chosen.second);
+    }
+
+    for (std::size_t i = 0; i < lists.size(); i++) {
+        merged.insert(merged.end(), iterators[i], lists[i].end());
+    }
+    return true;
+}
+
+bool heapTopC(TopCMerge<ItemList::iterator>& merge, std::vector<ItemList>& lists, int capacity, RandomStream& random,
+              std::vector<Item*>& merged) {
+    merge.clear();
+    for (std::vector<ItemList>::iterator it = lists.begin(); it != lists.end(); ++it) {
+        merge.addSequence(it->begin(), it->end());
+    }
+    if (capacity > 0 && !merge.mergeTopC(capacity, ItemKey(), random, merged)) {
+        return false;
+    }
+    merge.appendRest(merged);
+    return true;
+}
+
+///Fills the lists with items of keys increasing along each list, taken from few values so that heads tie often.
+void makeLists(RandomStream& random, std::vector<Item>& items, std::vector<ItemList>& lists, bool unpickable) {
+    const std::size_t numLists = 1 + random.uniformInt(0, 7);
+    lists.assign(numLists, ItemList());
+    items.assign(random.uniformInt(0, 60), Item());
+    for (std::size_t i = 0; i < items.size(); i++) {
+        items[i].key = random.uniformInt(0, 6);
+        if (unpickable && random.bernoulli(0.05)) {
+            items[i].key = random.bernoulli(0.5) ? std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::infinity();
+        }
+        lists[random.uniformInt(0, numLists - 1)].push_back(&items[i]);
+    }
+    for (std::size_t l = 0; l < numLists; l++) {
+        std::vector<double> keys;
+        for (ItemList::iterator it = lists[l].begin(); it != lists[l].end(); ++it) {
+            if ((*it)->key == (*it)->key) {
+                keys.push_back((*it)->key);
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        std::size_t k = 0;
+        for (ItemList::iterator it = lists[l].begin(); it != lists[l].end(); ++it) {
+            if ((*it)->key == (*it)->key) {
+                (*it)->key = keys[k++];
+            }
+        }
+    }
+}
+
+void checkSameAsLinearScan(bool unpickable) {
+    RandomStream scenarios(11, unpickable ? 1 : 0, RANDOM_GENERIC);
+    TopCMerge<ItemList::iterator> merge;
+    std::vector<Item> items;
+    std::vector<ItemList> lists;
+    for (unsigned int s = 0; s < 5000; s++) {
+        makeLists(scenarios, items, lists, unpickable);
+        const int capacity = scenarios.uniformInt(-2, 70);
+
+        RandomStream linearRandom(5, s, RANDOM_GENERIC);
+        std::vector<Item*> linearMerged;
+        const bool linearDone = linearScanTopC(lists, capacity, linearRandom, linearMerged);
+
+        RandomStream heapRandom(5, s, RANDOM_GENERIC);
+        std::vector<Item*> heapMerged;
+        const bool heapDone = heapTopC(merge, lists, capacity, heapRandom, heapMerged);
+
+        CPPUNIT_ASSERT_EQUAL(linearDone, heapDone);
+        CPPUNIT_ASSERT(linearMerged == heapMerged);
+        CPPUNIT_ASSERT_EQUAL(linearRandom.getPosition(), heapRandom.getPosition());
+    }
+}
+} //End anon namespace
+
+void unit_tests::TopCMergeUnitTests::test_Merge()
+{
+    Item items[7];
+    const double keys[] = { 1.0, 4.0, 9.0, 2.0, 3.0, 8.0, 5.0 };
+    for (unsigned int i = 0; i < 7; i++) {
+        items[i].key = keys[i];
+    }
+    std::vector<Item*> first, second;
+    first.push_back(&items[0]);
+    first.push_back(&items[1]);
+    first.push_back(&items[2]);
+    second.push_back(&items[3]);
+    second.push_back(&items[4]);
+    second.push_back(&items[5]);
+    second.push_back(&items[6]);
+
+    TopCMerge<std::vector<Item*>::const_iterator> merge;
+    RandomStream random(1, 0, RANDOM_GENERIC);
+    for (unsigned int round = 0; round < 2; round++) {
+        //The buffers are reused by the second round
+        merge.clear();
+        merge.addSequence(first.begin(), first.end());
+        merge.addSequence(second.begin(), second.end());
+        std::vector<Item*> merged;
+        CPPUNIT_ASSERT(merge.mergeTopC(4, ItemKey(), random, merged));
+        merge.appendRest(merged);
+
+        const unsigned int expected[] = { 0, 3, 4, 1, 2, 5, 6 };
+        CPPUNIT_ASSERT_EQUAL(std::size_t(7), merged.size());
+        for (unsigned int i = 0; i < 7; i++) {
+            CPPUNIT_ASSERT(merged[i] == &items[expected[i]]);
+        }
+    }
+    //No ties, no draws
+    CPPUNIT_ASSERT_EQUAL(boost::uint64_t(0), random.getPosition());
+
+    //Merging more elements than there are
+    merge.clear();
+    merge.addSequence(first.begin(), first.end());
+    std::vector<Item*> merged;
+    CPPUNIT_ASSERT(!merge.mergeTopC(10, ItemKey(), random, merged));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), merged.size());
+}
+
+void unit_tests::TopCMergeUnitTests::test_SameAsLinearScan()
+{
+    checkSameAsLinearScan(false);
+}
+
+void unit_tests::TopCMergeUnitTests::test_UnpickableHeads()
+{
+    checkSameAsLinearScan(true);
+
+    Item items[3];
+    items[0].key = std::numeric_limits<double>::quiet_NaN();
+    items[1].key = std::numeric_limits<double>::infinity();
+    items[2].key = 7.0;
+    std::vector<Item*> sequence;
+    for (unsigned int i = 0; i < 3; i++) {
+        sequence.push_back(&items[i]);
+    }
+    TopCMerge<std::vector<Item*>::const_iterator> merge;
+    merge.addSequence(sequence.begin() + 1, sequence.end());
+    merge.addSequence(sequence.begin(), sequence.begin() + 1);
+    RandomStream random(1, 0, RANDOM_GENERIC);
+    std::vector<Item*> merged;
+    CPPUNIT_ASSERT(!merge.mergeTopC(1, ItemKey(), random, merged));
+    CPPUNIT_ASSERT(merged.empty());
+    merge.appendRest(merged);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), merged.size());
+}
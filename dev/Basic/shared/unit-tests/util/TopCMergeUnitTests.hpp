@@ -0,0 +1,37 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the TopCMerge class in Basic/util.
+ */
+class TopCMergeUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///The first C elements are merged by key, the others follow sequence after sequence.
+    void test_Merge();
+
+    ///Merges of random sequences with many ties give the same order, and draw the same random numbers, as a linear
+    ///scan of the heads (the ordering used by the mid-term confluxes and segments).
+    void test_SameAsLinearScan();
+
+    ///Heads whose key is NaN or infinite are never picked.
+    void test_UnpickableHeads();
+
+private:
+    CPPUNIT_TEST_SUITE(TopCMergeUnitTests);
+        CPPUNIT_TEST(test_Merge);
+        CPPUNIT_TEST(test_SameAsLinearScan);
+        CPPUNIT_TEST(test_UnpickableHeads);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
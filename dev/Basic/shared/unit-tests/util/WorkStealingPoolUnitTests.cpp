@@ -0,0 +1,181 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/shared_array.hpp>
+#include <boost/thread.hpp>
+
+#include "util/threadpool/WorkStealingPool.hpp"
+
+#include "WorkStealingPoolUnitTests.hpp"
+
+using namespace sim_mob;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::WorkStealingPoolUnitTests);
+
+namespace {
+///Counts how often each item was processed; items below slowItems take a while to process.
+struct CountingWorker {
+    CountingWorker(std::size_t numItems, std::size_t slowItems) : counts(new boost::atomic<int>[numItems]), slowItems(slowItems) {
+        for (std::size_t i = 0; i < numItems; i++) {
+            counts[i] = 0;
+        }
+    }
+
+    void operator()(WorkStealingPool& pool, std::size_t workerId) {
+        std::size_t first, last;
+        while (pool.nextChunk(workerId, first, last)) {
+            for (std::size_t i = first; i != last; i++) {
+                if (i < slowItems) {
+                    boost::this_thread::sleep_for(boost::chrono::milliseconds(2));
+                }
+                counts[i]++;
+            }
+        }
+    }
+
+    boost::shared_array< boost::atomic<int> > counts;
+    std::size_t slowItems;
+};
+
+///Records the chunks in the order in which they were handed out.
+void recordChunks(WorkStealingPool& pool, std::size_t workerId, std::vector<std::size_t>& firstItems) {
+    std::size_t first, last;
+    while (pool.nextChunk(workerId, first, last)) {
+        firstItems.push_back(first);
+    }
+}
+
+///Records the thread of each worker, then counts the items.
+void recordThreads(WorkStealingPool& pool, std::size_t workerId, std::vector<boost::thread::id>& threads,
+        CountingWorker& worker) {
+    threads[workerId] = boost::this_thread::get_id();
+    worker(pool, workerId);
+}
+
+void throwOnItem(WorkStealingPool& pool, std::size_t workerId, std::size_t badItem) {
+    std::size_t first, last;
+    while (pool.nextChunk(workerId, first, last)) {
+        if (first <= badItem && badItem < last) {
+            throw std::runtime_error("bad item");
+        }
+    }
+}
+} //End anon namespace
+
+void unit_tests::WorkStealingPoolUnitTests::test_AllItemsOnce()
+{
+    //The first worker gets all slow items; the other workers must steal them to finish.
+    const std::size_t numItems = 1000;
+    WorkStealingPool pool(numItems, 4, 5);
+    CountingWorker worker(numItems, numItems / 4);
+    pool.run(boost::ref(worker));
+
+    for (std::size_t i = 0; i < numItems; i++) {
+        CPPUNIT_ASSERT_EQUAL(1, worker.counts[i].load());
+    }
+
+    //Running again processes everything again.
+    CountingWorker again(numItems, 0);
+    pool.run(boost::ref(again));
+    for (std::size_t i = 0; i < numItems; i++) {
+        CPPUNIT_ASSERT_EQUAL(1, again.counts[i].load());
+    }
+}
+
+void unit_tests::WorkStealingPoolUnitTests::test_SingleWorker()
+{
+    WorkStealingPool pool(10, 1, 3);
+    std::vector<std::size_t> firstItems;
+    pool.run(boost::bind(recordChunks, _1, _2, boost::ref(firstItems)));
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), firstItems.size());
+    for (std::size_t i = 0; i < firstItems.size(); i++) {
+        CPPUNIT_ASSERT_EQUAL(i * 3, firstItems[i]);
+    }
+
+    //No items at all.
+    WorkStealingPool empty(0, 3, 3);
+    std::vector<std::size_t> none;
+    empty.run(boost::bind(recordChunks, _1, _2, boost::ref(none)));
+    CPPUNIT_ASSERT(none.empty());
+
+    CPPUNIT_ASSERT_THROW(WorkStealingPool(10, 0, 3), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(WorkStealingPool(10, 3, 0), std::runtime_error);
+}
+
+void unit_tests::WorkStealingPoolUnitTests::test_WorkerException()
+{
+    WorkStealingPool pool(100, 3, 2);
+    CPPUNIT_ASSERT_THROW(pool.run(boost::bind(throwOnItem, _1, _2, 57)), std::runtime_error);
+
+    WorkStealingPool single(100, 1, 2);
+    CPPUNIT_ASSERT_THROW(single.run(boost::bind(throwOnItem, _1, _2, 57)), std::runtime_error);
+}
+
+void unit_tests::WorkStealingPoolUnitTests::test_Stats()
+{
+    const std::size_t numItems = 203;
+    WorkStealingPool pool(numItems, 3, 10);
+    CountingWorker worker(numItems, 30);
+    pool.run(boost::ref(worker));
+
+    const std::vector<WorkStealingPool::WorkerStats>& stats = pool.getStats();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), stats.size());
+
+    std::size_t chunks = 0, items = 0;
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        chunks += stats[i].chunks;
+        items += stats[i].items;
+        CPPUNIT_ASSERT(stats[i].stolenChunks <= stats[i].chunks);
+        CPPUNIT_ASSERT(stats[i].busySeconds >= 0);
+        CPPUNIT_ASSERT(stats[i].idleSeconds >= 0);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(21), chunks);
+    CPPUNIT_ASSERT_EQUAL(numItems, items);
+}
+
+void unit_tests::WorkStealingPoolUnitTests::test_Persistent()
+{
+    const std::size_t numWorkers = 4;
+    WorkStealingPool pool(numWorkers);
+    std::set<boost::thread::id> helperThreads;
+    for (std::size_t run = 0; run < 50; run++) {
+        const std::size_t numItems = run * 7;
+        const std::size_t numActive = 1 + run % numWorkers;
+        CountingWorker worker(numItems, 0);
+        std::vector<boost::thread::id> threads(numWorkers);
+        pool.run(numItems, 1 + run % 5, numActive, boost::bind(recordThreads, _1, _2, boost::ref(threads), boost::ref(worker)));
+
+        for (std::size_t i = 0; i < numItems; i++) {
+            CPPUNIT_ASSERT_EQUAL(1, worker.counts[i].load());
+        }
+        CPPUNIT_ASSERT_EQUAL(numActive, pool.getStats().size());
+        CPPUNIT_ASSERT(threads[0] == boost::this_thread::get_id());
+        for (std::size_t w = 1; w < numWorkers; w++) {
+            //workers which are not active are not run at all
+            CPPUNIT_ASSERT((w < numActive) == (threads[w] != boost::thread::id()));
+            if (w < numActive) {
+                helperThreads.insert(threads[w]);
+            }
+        }
+    }
+    //the helper threads are started once
+    CPPUNIT_ASSERT_EQUAL(numWorkers - 1, helperThreads.size());
+
+    CPPUNIT_ASSERT_THROW(pool.run(100, 3, numWorkers, boost::bind(throwOnItem, _1, _2, 57)), std::runtime_error);
+    CountingWorker worker(10, 0);
+    pool.run(10, 3, numWorkers, boost::ref(worker));
+    CPPUNIT_ASSERT_EQUAL(1, worker.counts[9].load());
+
+    CPPUNIT_ASSERT_THROW(pool.run(10, 3, numWorkers + 1, boost::ref(worker)), std::runtime_error);
+    CPPUNIT_ASSERT_THROW(pool.run(10, 0, 1, boost::ref(worker)), std::runtime_error);
+    WorkStealingPool batch(10, 2, 3);
+    CPPUNIT_ASSERT_THROW(batch.run(10, 3, 1, boost::ref(worker)), std::runtime_error);
+}
@@ -0,0 +1,44 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace unit_tests
+{
+
+/**
+ * Unit Tests for the WorkStealingPool class in Basic/util/threadpool.
+ */
+class WorkStealingPoolUnitTests : public CppUnit::TestFixture
+{
+public:
+    ///Every item must be processed exactly once, even if the items of one worker are much more expensive.
+    void test_AllItemsOnce();
+
+    ///A single worker runs on the calling thread and processes the chunks in order.
+    void test_SingleWorker();
+
+    ///An exception thrown by a worker must be rethrown by run().
+    void test_WorkerException();
+
+    ///Chunk and item counts of the statistics must add up to the totals.
+    void test_Stats();
+
+    ///A persistent pool reuses its threads over many runs of varying sizes and numbers of active workers.
+    void test_Persistent();
+
+private:
+    CPPUNIT_TEST_SUITE(WorkStealingPoolUnitTests);
+        CPPUNIT_TEST(test_AllItemsOnce);
+        CPPUNIT_TEST(test_SingleWorker);
+        CPPUNIT_TEST(test_WorkerException);
+        CPPUNIT_TEST(test_Stats);
+        CPPUNIT_TEST(test_Persistent);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+}
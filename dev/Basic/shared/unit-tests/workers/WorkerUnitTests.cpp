@@ -3,11 +3,13 @@
 //   license.txt   (http://opensource.org/licenses/MIT)
 
 #include <map>
+#include <iostream>
 #include <cmath>
 #include <limits>
 #include <vector>
 #include <string>
 #include <sstream>
+#include <boost/chrono.hpp>
 
 #include "buffering/Buffered.hpp"
 #include "conf/ConfigManager.hpp"
@@ -16,6 +18,7 @@
 #include "workers/WorkGroupManager.hpp"
 #include "workers/WorkGroup.hpp"
 #include "workers/Worker.hpp"
+#include "workers/EntityStore.hpp"
 #include "entities/Agent.hpp"
 #include "entities/AuraManager.hpp"
 
@@ -27,6 +30,7 @@ using std::vector;
 using namespace sim_mob;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(unit_tests::WorkerUnitTests);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(unit_tests::WorkerBenchmarks, "Benchmarks");
 
 
 //Hack around an Agent's frame_* functions.
@@ -661,6 +665,150 @@ void unit_tests::WorkerUnitTests::test_MultiGroupInteraction()
 }
 
 
+void unit_tests::WorkerUnitTests::test_EntityStore()
+{
+    vector<Agent*> agents;
+    for (int i=0; i<5; i++) {
+        agents.push_back(new IncrAgent());
+    }
+
+    //An entity can be part of two stores with different slots.
+    EntityStore all(0);
+    EntityStore some(1);
+    for (vector<Agent*>::iterator it=agents.begin(); it!=agents.end(); it++) {
+        CPPUNIT_ASSERT(all.add(*it));
+    }
+    CPPUNIT_ASSERT(!all.add(agents[2]));
+    CPPUNIT_ASSERT(some.add(agents[1]));
+    CPPUNIT_ASSERT(some.add(agents[3]));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(5), all.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), some.size());
+    CPPUNIT_ASSERT(!some.contains(agents[0]));
+    CPPUNIT_ASSERT(!some.contains(agents[4]));
+
+    //The last entity takes the place of the removed one.
+    CPPUNIT_ASSERT(all.remove(agents[1]));
+    CPPUNIT_ASSERT(!all.remove(agents[1]));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), all.size());
+    CPPUNIT_ASSERT(all[1] == agents[4]);
+    CPPUNIT_ASSERT(!all.contains(agents[1]));
+    CPPUNIT_ASSERT(some.contains(agents[1]));
+    for (int i=0; i<5; i++) {
+        CPPUNIT_ASSERT(all.contains(agents[i]) == (i != 1));
+    }
+
+    //Down to empty, removing the last entity.
+    CPPUNIT_ASSERT(all.remove(all.back()));
+    while (!all.empty()) {
+        CPPUNIT_ASSERT(all.remove(all[0]));
+    }
+    CPPUNIT_ASSERT(some.remove(agents[3]));
+    CPPUNIT_ASSERT(some[0] == agents[1]);
+
+    CPPUNIT_ASSERT_THROW(EntityStore(Entity::NUM_STORE_SLOTS), std::runtime_error);
+
+    for (vector<Agent*>::iterator it=agents.begin(); it!=agents.end(); it++) {
+        delete *it;
+    }
+}
+
+
+void unit_tests::WorkerUnitTests::test_UpdateStatusDeltas()
+{
+    Buffered<int> a, b, c, d;
+    vector<BufferedBase*> prev;
+    prev.push_back(&a);
+    prev.push_back(&b);
+    prev.push_back(&c);
+    vector<BufferedBase*> next;
+    next.push_back(&c);
+    next.push_back(&d);
+    next.push_back(&d);
+
+    //Without a buffer, the deltas are dropped.
+    Entity::UpdateStatus dropped(Entity::UpdateStatus::RS_CONTINUE, prev, next);
+    CPPUNIT_ASSERT_EQUAL(0u, dropped.numToRemove);
+    CPPUNIT_ASSERT_EQUAL(0u, dropped.numToAdd);
+
+    Entity::UpdateStatus::DeltaBuffer buffer;
+    {
+        Entity::UpdateStatus::DeltaBuffer::Scope scope(buffer);
+        Entity::UpdateStatus first(Entity::UpdateStatus::RS_CONTINUE, prev, next);
+        Entity::UpdateStatus none(Entity::UpdateStatus::RS_CONTINUE);
+        Entity::UpdateStatus second(Entity::UpdateStatus::RS_CONTINUE, next, prev);
+
+        //Items common to both lists remain, and duplicates are only counted once.
+        CPPUNIT_ASSERT_EQUAL(2u, first.numToRemove);
+        CPPUNIT_ASSERT(buffer.getToRemove(first)[0] == &a);
+        CPPUNIT_ASSERT(buffer.getToRemove(first)[1] == &b);
+        CPPUNIT_ASSERT_EQUAL(1u, first.numToAdd);
+        CPPUNIT_ASSERT(buffer.getToAdd(first)[0] == &d);
+
+        CPPUNIT_ASSERT_EQUAL(0u, none.numToRemove + none.numToAdd);
+
+        //Later statuses do not overwrite the earlier ones.
+        CPPUNIT_ASSERT_EQUAL(1u, second.numToRemove);
+        CPPUNIT_ASSERT(buffer.getToRemove(second)[0] == &d);
+        CPPUNIT_ASSERT_EQUAL(2u, second.numToAdd);
+        CPPUNIT_ASSERT(buffer.getToAdd(second)[0] == &a);
+        CPPUNIT_ASSERT(buffer.getToAdd(second)[1] == &b);
+        CPPUNIT_ASSERT(buffer.getToRemove(first)[0] == &a);
+    }
+
+    //Out of the scope, the buffer is no longer written.
+    buffer.clear();
+    Entity::UpdateStatus after(Entity::UpdateStatus::RS_CONTINUE, prev, next);
+    CPPUNIT_ASSERT_EQUAL(0u, after.numToRemove + after.numToAdd);
+}
+
+
+void unit_tests::WorkerBenchmarks::test_UpdateLoopBenchmark()
+{
+    const int numTicks = 50;
+    std::cout << "\nWorker update loop micro-benchmark (no-op agents, 1 worker, " << numTicks << " ticks)\n";
+    for (int numAgents = 1000; numAgents <= 100000; numAgents *= 10) {
+        WorkGroupManager wgm;
+        WorkGroup* mainWG = wgm.newWorkGroup(1, numTicks);
+        wgm.initAllGroups();
+        mainWG->initWorkers(nullptr);
+
+        vector<IncrAgent*> agents;
+        for (int i=0; i<numAgents; i++) {
+            IncrAgent* ag = new IncrAgent();
+            ag->setStartTime(0);
+            mainWG->assignAWorker(ag);
+            agents.push_back(ag);
+        }
+        wgm.startAllWorkGroups();
+
+        //The first tick adds the agents to the worker.
+        wgm.waitAllGroups();
+        boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+        for (int i=1; i<numTicks; i++) {
+            wgm.waitAllGroups();
+        }
+        boost::chrono::duration<double, boost::nano> loop = boost::chrono::steady_clock::now() - start;
+
+        //The bare virtual calls, for reference.
+        start = boost::chrono::steady_clock::now();
+        for (int i=1; i<numTicks; i++) {
+            for (vector<IncrAgent*>::iterator it=agents.begin(); it!=agents.end(); it++) {
+                (*it)->update(timeslice(i, i));
+            }
+        }
+        boost::chrono::duration<double, boost::nano> bare = boost::chrono::steady_clock::now() - start;
+
+        for (vector<IncrAgent*>::iterator it=agents.begin(); it!=agents.end(); it++) {
+            CPPUNIT_ASSERT_EQUAL(2*numTicks - 1, (*it)->getValue());
+        }
+
+        const double numUpdates = static_cast<double>(numAgents) * (numTicks - 1);
+        std::cout << "  agents: " << numAgents << " | worker tick: " << (loop.count() / numUpdates)
+                  << " ns/update | bare update(): " << (bare.count() / numUpdates) << " ns/update\n";
+    }
+}
+
+
 //Magic
 #undef IGNORE_AGENT_FRAME_FUNCTIONS
 
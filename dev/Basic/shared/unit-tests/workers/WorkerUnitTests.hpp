@@ -38,6 +38,12 @@ public:
     // (to avoid accidentally correct answers).
     void test_MultiGroupInteraction();
 
+    ///Entities added to and removed from entity stores, with the last entity filling the gaps.
+    void test_EntityStore();
+
+    ///Buffered types to stop/start managing written by update statuses to the current delta buffer.
+    void test_UpdateStatusDeltas();
+
 
 private:
     CPPUNIT_TEST_SUITE(WorkerUnitTests);
@@ -47,6 +53,23 @@ private:
         CPPUNIT_TEST(test_AgentStartTimes);
         CPPUNIT_TEST(test_UpdatePhases);
         CPPUNIT_TEST(test_MultiGroupInteraction);
+        CPPUNIT_TEST(test_EntityStore);
+        CPPUNIT_TEST(test_UpdateStatusDeltas);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+/**
+ * Micro-benchmarks for the Worker class; registered in the "Benchmarks" registry (SM_UnitTests --benchmarks).
+ */
+class WorkerBenchmarks : public CppUnit::TestFixture
+{
+public:
+    ///Micro-benchmark: overhead of the worker update loop per entity, with entities doing nothing.
+    void test_UpdateLoopBenchmark();
+
+private:
+    CPPUNIT_TEST_SUITE(WorkerBenchmarks);
+        CPPUNIT_TEST(test_UpdateLoopBenchmark);
     CPPUNIT_TEST_SUITE_END();
 };
 
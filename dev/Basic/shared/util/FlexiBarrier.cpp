@@ -4,16 +4,52 @@
 
 #include "FlexiBarrier.hpp"
 
+#include <algorithm>
+#include <string>
 
-sim_mob::FlexiBarrier::FlexiBarrier(unsigned int count) : m_threshold(count), m_count(count), m_generation(0)
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+///Number of times a spinning waiter yields its time slice before blocking.
+const unsigned int YIELD_COUNT = 16;
+
+///Hint to the processor that we are in a spin-wait loop.
+inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#endif
+}
+}
+
+sim_mob::FlexiBarrier::FlexiBarrier(unsigned int count, Strategy strategy, unsigned int spinCount) :
+    m_threshold(count), m_count(count), m_generation(0), m_strategy(strategy), m_maxSpins(spinCount),
+    m_atomicCount(count), m_sense(0), m_sleepers(0), m_spinLimit(spinCount)
 {
     if (count == 0) {
         throw std::runtime_error("FlexiBarrier constructor: count cannot be zero.");
     }
+
+    //Spinning on a single core only delays the thread we are waiting for.
+    if (boost::thread::hardware_concurrency() <= 1) {
+        m_maxSpins = 0;
+        m_spinLimit.store(0);
+    }
 }
 
 bool sim_mob::FlexiBarrier::wait(unsigned int amount)
 {
+    if (m_strategy == SPIN_THEN_BLOCK) {
+        unsigned int gen = 0;
+        if (arrive(amount, gen, "wait")) {
+            return true;  //Indicates you are the leader.
+        }
+        awaitGeneration(gen);
+        return false;
+    }
+
     boost::mutex::scoped_lock lock(m_mutex);
     unsigned int gen = m_generation;
     
@@ -39,7 +75,11 @@ bool sim_mob::FlexiBarrier::wait(unsigned int amount)
 
 bool sim_mob::FlexiBarrier::contribute(unsigned int amount)
 {
-    
+    if (m_strategy == SPIN_THEN_BLOCK) {
+        unsigned int gen = 0;
+        return arrive(amount, gen, "contribute");
+    }
+
     boost::mutex::scoped_lock lock(m_mutex);
     unsigned int gen = m_generation;
 
@@ -62,5 +102,69 @@ bool sim_mob::FlexiBarrier::contribute(unsigned int amount)
     return false;    //Indicates you are not the leader.
 }
 
+bool sim_mob::FlexiBarrier::arrive(unsigned int amount, unsigned int& gen, const char* caller)
+{
+    //The generation must be read before the count is decremented; once our decrement is visible the barrier may
+    //  be released at any moment. No thread can arrive for the next generation before this one is released, so
+    //  the count below always belongs to the generation read here.
+    gen = m_sense.load(boost::memory_order_acquire);
+
+    unsigned int count = m_atomicCount.load(boost::memory_order_relaxed);
+    do {
+        //Can't wait more than the amount that would get us to zero.
+        if (amount > count) {
+            std::string msg = std::string("FlexiBarrier ") + caller + "() overflow.";
+            throw std::runtime_error(msg);
+        }
+    } while (!m_atomicCount.compare_exchange_weak(count, count - amount, boost::memory_order_acq_rel, boost::memory_order_relaxed));
+
+    if (count != amount) {
+        return false;
+    }
+
+    //Last arrival: re-arm the count, then flip the sense. Waiters only touch the count again after seeing the new sense.
+    m_atomicCount.store(m_threshold, boost::memory_order_relaxed);
+    m_sense.fetch_add(1, boost::memory_order_seq_cst);
+
+    //A sleeper registers itself before re-checking the sense (both sequentially consistent), so either it sees the new
+    //  sense or we see it here. Taking the mutex ensures it is already inside m_cond.wait() when we notify.
+    if (m_sleepers.load(boost::memory_order_seq_cst) > 0) {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_cond.notify_all();
+    }
+    return true;
+}
+
+void sim_mob::FlexiBarrier::awaitGeneration(unsigned int gen)
+{
+    const unsigned int spinLimit = m_spinLimit.load(boost::memory_order_relaxed);
+    for (unsigned int i = 0; i < spinLimit; i++) {
+        if (m_sense.load(boost::memory_order_acquire) != gen) {
+            //Released while spinning; allow a little more spinning next time.
+            if (spinLimit < m_maxSpins) {
+                m_spinLimit.store(std::min(m_maxSpins, spinLimit + spinLimit / 8 + 1), boost::memory_order_relaxed);
+            }
+            return;
+        }
+        cpuRelax();
+    }
+
+    for (unsigned int i = 0; i < YIELD_COUNT; i++) {
+        if (m_sense.load(boost::memory_order_acquire) != gen) {
+            return;
+        }
+        boost::this_thread::yield();
+    }
 
+    //Spinning did not pay off; spin less next time, down to 1/16th of the configured maximum.
+    if (spinLimit > m_maxSpins / 16) {
+        m_spinLimit.store(std::max(m_maxSpins / 16, spinLimit / 2), boost::memory_order_relaxed);
+    }
 
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_sleepers.fetch_add(1, boost::memory_order_seq_cst);
+    while (m_sense.load(boost::memory_order_seq_cst) == gen) {
+        m_cond.wait(lock);
+    }
+    m_sleepers.fetch_sub(1, boost::memory_order_relaxed);
+}
@@ -17,10 +17,16 @@
  *
  * FlexiBarrier.hpp is dual-licensed under the terms of the Boost Software License (1.0), or,
  *   where applicable, under the same terms as the rest of Sim Mobility.
+ *
+ * The SPIN_THEN_BLOCK strategy is a sense-reversing barrier: the count and the generation ("sense")
+ *   live on separate cache lines, and waiters poll the generation for a while before falling back to
+ *   the condition variable. This avoids a futex round trip per worker per phase when the workers
+ *   arrive at the barrier close together, which is the common case on the tick path.
  */
 
 #pragma once
 
+#include <boost/atomic.hpp>
 #include <boost/thread.hpp>
 #include <stdexcept>
 
@@ -31,8 +37,20 @@ namespace sim_mob {
  */
 class FlexiBarrier {
 public:
+    ///How waiting threads are suspended.
+    enum Strategy {
+        BLOCKING,        ///< Wait on a condition variable straight away (default).
+        SPIN_THEN_BLOCK, ///< Spin, then yield, then wait on a condition variable.
+    };
+
+    ///Default upper limit on the number of spins before a waiting thread yields.
+    static const unsigned int DEFAULT_SPIN_COUNT = 4000;
+
     ///Create a FlexiBarrier that requires *count* to be accumulated before it passes.
-    FlexiBarrier(unsigned int count);
+    ///With SPIN_THEN_BLOCK, waiters spin for at most *spinCount* iterations before yielding and
+    ///  eventually blocking. The actual spin limit adapts between 1/16th of spinCount and spinCount
+    ///  depending on whether recent waits were released while spinning.
+    FlexiBarrier(unsigned int count, Strategy strategy = BLOCKING, unsigned int spinCount = DEFAULT_SPIN_COUNT);
 
     ///Add *amount* to the total count and wait. If this call to wait caused the count to reach zero,
     ///  then return (true) immediately and unlock all others waiting on this barrier. Otherwise, wait
@@ -43,12 +61,40 @@ public:
     ///  reach zero, then unlock all others waiting on this barrier and return (true). Otherwise, return false.
     bool contribute(unsigned int amount=1);
 
+    Strategy getStrategy() const {
+        return m_strategy;
+    }
+
 private:
+    ///Size assumed for padding the shared counters apart.
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    ///Decrement the spinning barrier's count by *amount*, releasing all waiters if it reaches zero.
+    ///Returns true if this call released the barrier. *gen* receives the generation that was arrived at.
+    bool arrive(unsigned int amount, unsigned int& gen, const char* caller);
+
+    ///Spin, yield, then block until the spinning barrier moves past generation *gen*.
+    void awaitGeneration(unsigned int gen);
+
+    //Blocking strategy; also used by spinning waiters that have given up spinning.
     boost::mutex m_mutex;
     boost::condition_variable m_cond;
     unsigned int m_threshold;
     unsigned int m_count;
     unsigned int m_generation;
+
+    Strategy m_strategy;
+    unsigned int m_maxSpins;
+
+    //Spin-then-block strategy. Each counter is written by a different set of threads, so each gets its own cache line.
+    char m_pad0[CACHE_LINE_SIZE];
+    boost::atomic<unsigned int> m_atomicCount;
+    char m_pad1[CACHE_LINE_SIZE - sizeof(boost::atomic<unsigned int>)];
+    boost::atomic<unsigned int> m_sense;
+    char m_pad2[CACHE_LINE_SIZE - sizeof(boost::atomic<unsigned int>)];
+    boost::atomic<unsigned int> m_sleepers;
+    boost::atomic<unsigned int> m_spinLimit;
+    char m_pad3[CACHE_LINE_SIZE - 2 * sizeof(boost::atomic<unsigned int>)];
 };
 
 
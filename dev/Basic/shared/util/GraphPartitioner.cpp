@@ -0,0 +1,559 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "GraphPartitioner.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using namespace sim_mob;
+
+namespace
+{
+/** marker for unmatched/unassigned vertices */
+const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+/** coarsening stops once the graph has fewer than this many vertices per part... */
+const std::size_t COARSEN_VERTICES_PER_PART = 20;
+
+/** ...or fewer than this many vertices in total */
+const std::size_t MIN_COARSEST_GRAPH_SIZE = 100;
+
+/** coarsening stops if a level removes less than 5% of the vertices */
+const double MIN_COARSENING_REDUCTION = 0.95;
+
+/** number of different initial partitions tried on the coarsest graph */
+const unsigned int NUM_INITIAL_PARTITION_TRIALS = 4;
+
+/** upper limit on the number of refinement passes at each level */
+const unsigned int MAX_REFINEMENT_PASSES = 8;
+
+/**
+ * fills perm with a random permutation of [0, n)
+ */
+void randomPermutation(std::size_t n, std::vector<std::size_t>& perm, boost::mt19937& rng)
+{
+    perm.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        perm[i] = i;
+    }
+    for (std::size_t i = n; i > 1; i--)
+    {
+        boost::uniform_int<std::size_t> dist(0, i - 1);
+        std::swap(perm[i - 1], perm[dist(rng)]);
+    }
+}
+
+/**
+ * computes the load of each part
+ */
+void computeLoads(const std::vector<double>& vwgt, const std::vector<unsigned int>& parts, unsigned int numParts, std::vector<double>& loads)
+{
+    loads.assign(numParts, 0.0);
+    for (std::size_t v = 0; v < vwgt.size(); v++)
+    {
+        loads[parts[v]] += vwgt[v];
+    }
+}
+}
+
+void PartitionStats::print(std::ostream& os) const
+{
+    os << "parts: " << loads.size()
+       << " | cut weight: " << cutWeight
+       << " | cut edges: " << cutEdges
+       << " | total load: " << totalLoad
+       << " | max load: " << maxLoad
+       << " | min load: " << minLoad
+       << " | imbalance: " << std::fixed << std::setprecision(2) << (imbalance * 100.0) << "%\n";
+    os.unsetf(std::ios_base::floatfield);
+    os << std::setprecision(6) << "loads:";
+    for (std::vector<double>::const_iterator it = loads.begin(); it != loads.end(); it++)
+    {
+        os << " " << *it;
+    }
+    os << "\n";
+}
+
+GraphPartitioner::GraphPartitioner(unsigned int seed) : seed(seed)
+{
+}
+
+std::size_t GraphPartitioner::addVertex(double weight)
+{
+    if (weight < 0)
+    {
+        throw std::runtime_error("GraphPartitioner: negative vertex weight");
+    }
+    vertexWeights.push_back(weight);
+    return vertexWeights.size() - 1;
+}
+
+void GraphPartitioner::addEdge(std::size_t u, std::size_t v, double weight)
+{
+    if (u >= vertexWeights.size() || v >= vertexWeights.size())
+    {
+        throw std::runtime_error("GraphPartitioner: edge refers to an unknown vertex");
+    }
+    if (weight < 0)
+    {
+        throw std::runtime_error("GraphPartitioner: negative edge weight");
+    }
+    if (u == v)
+    {
+        return;
+    }
+    Edge edge;
+    edge.u = u;
+    edge.v = v;
+    edge.weight = weight;
+    edges.push_back(edge);
+}
+
+void GraphPartitioner::buildGraph(Graph& graph) const
+{
+    const std::size_t n = vertexWeights.size();
+    typedef std::pair<std::size_t, double> Neighbour;
+    std::vector< std::vector<Neighbour> > adjacency(n);
+    for (std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); it++)
+    {
+        adjacency[it->u].push_back(Neighbour(it->v, it->weight));
+        adjacency[it->v].push_back(Neighbour(it->u, it->weight));
+    }
+
+    graph.vwgt = vertexWeights;
+    graph.xadj.assign(1, 0);
+    graph.adjncy.clear();
+    graph.adjwgt.clear();
+    for (std::size_t v = 0; v < n; v++)
+    {
+        std::vector<Neighbour>& nbrs = adjacency[v];
+        std::sort(nbrs.begin(), nbrs.end());
+        for (std::vector<Neighbour>::const_iterator it = nbrs.begin(); it != nbrs.end(); it++)
+        {
+            if (graph.adjncy.size() > graph.xadj.back() && graph.adjncy.back() == it->first)
+            {
+                graph.adjwgt.back() += it->second;
+            }
+            else
+            {
+                graph.adjncy.push_back(it->first);
+                graph.adjwgt.push_back(it->second);
+            }
+        }
+        graph.xadj.push_back(graph.adjncy.size());
+    }
+}
+
+void GraphPartitioner::coarsen(const Graph& fine, Graph& coarse, std::vector<std::size_t>& cmap, double maxVertexWeight, boost::mt19937& rng)
+{
+    const std::size_t n = fine.size();
+    std::vector<std::size_t> match(n, NONE);
+    std::vector<std::size_t> perm;
+    randomPermutation(n, perm, rng);
+
+    //heavy edge matching
+    for (std::vector<std::size_t>::const_iterator vIt = perm.begin(); vIt != perm.end(); vIt++)
+    {
+        const std::size_t v = *vIt;
+        if (match[v] != NONE)
+        {
+            continue;
+        }
+        std::size_t best = NONE;
+        double bestWeight = -1.0;
+        for (std::size_t e = fine.xadj[v]; e < fine.xadj[v + 1]; e++)
+        {
+            const std::size_t u = fine.adjncy[e];
+            if (match[u] == NONE && fine.adjwgt[e] > bestWeight && fine.vwgt[v] + fine.vwgt[u] <= maxVertexWeight)
+            {
+                best = u;
+                bestWeight = fine.adjwgt[e];
+            }
+        }
+        if (best != NONE)
+        {
+            match[v] = best;
+            match[best] = v;
+        }
+        else
+        {
+            match[v] = v;
+        }
+    }
+
+    //number the coarse vertices; each coarse vertex is represented by its lower numbered constituent
+    std::vector<std::size_t> representative;
+    cmap.assign(n, NONE);
+    for (std::size_t v = 0; v < n; v++)
+    {
+        if (v <= match[v])
+        {
+            cmap[v] = cmap[match[v]] = representative.size();
+            representative.push_back(v);
+        }
+    }
+
+    const std::size_t nCoarse = representative.size();
+    coarse.vwgt.assign(nCoarse, 0.0);
+    coarse.xadj.assign(1, 0);
+    coarse.adjncy.clear();
+    coarse.adjwgt.clear();
+
+    //position of each coarse neighbour in the adjacency list of the coarse vertex being built
+    std::vector<std::size_t> position(nCoarse, NONE);
+    for (std::size_t c = 0; c < nCoarse; c++)
+    {
+        const std::size_t start = coarse.adjncy.size();
+        const std::size_t constituents[2] = { representative[c], match[representative[c]] };
+        const std::size_t numConstituents = (constituents[0] == constituents[1]) ? 1 : 2;
+        for (std::size_t i = 0; i < numConstituents; i++)
+        {
+            const std::size_t v = constituents[i];
+            coarse.vwgt[c] += fine.vwgt[v];
+            for (std::size_t e = fine.xadj[v]; e < fine.xadj[v + 1]; e++)
+            {
+                const std::size_t cu = cmap[fine.adjncy[e]];
+                if (cu == c)
+                {
+                    continue;
+                }
+                if (position[cu] == NONE)
+                {
+                    position[cu] = coarse.adjncy.size();
+                    coarse.adjncy.push_back(cu);
+                    coarse.adjwgt.push_back(fine.adjwgt[e]);
+                }
+                else
+                {
+                    coarse.adjwgt[position[cu]] += fine.adjwgt[e];
+                }
+            }
+        }
+        for (std::size_t e = start; e < coarse.adjncy.size(); e++)
+        {
+            position[coarse.adjncy[e]] = NONE;
+        }
+        coarse.xadj.push_back(coarse.adjncy.size());
+    }
+}
+
+void GraphPartitioner::growInitialPartition(const Graph& graph, unsigned int numParts, std::vector<unsigned int>& parts, boost::mt19937& rng)
+{
+    const std::size_t n = graph.size();
+    const unsigned int unassigned = numParts;
+    double totalWeight = 0.0;
+    for (std::size_t v = 0; v < n; v++)
+    {
+        totalWeight += graph.vwgt[v];
+    }
+    const double target = totalWeight / numParts;
+
+    parts.assign(n, unassigned);
+    std::vector<std::size_t> seeds;
+    randomPermutation(n, seeds, rng);
+    std::vector<std::size_t>::const_iterator nextSeed = seeds.begin();
+
+    //connectivity of each unassigned vertex to the part being grown
+    std::vector<double> connectivity(n, 0.0);
+    std::vector<bool> inFrontier(n, false);
+    std::vector<std::size_t> frontier;
+
+    for (unsigned int p = 0; p + 1 < numParts; p++)
+    {
+        double load = 0.0;
+        while (load < target)
+        {
+            //pick the frontier vertex most strongly connected to the region
+            std::size_t best = NONE;
+            std::size_t bestPos = NONE;
+            for (std::size_t i = 0; i < frontier.size(); i++)
+            {
+                const std::size_t u = frontier[i];
+                if (parts[u] == unassigned && (best == NONE || connectivity[u] > connectivity[best]))
+                {
+                    best = u;
+                    bestPos = i;
+                }
+            }
+            if (best == NONE)
+            {
+                //region is disconnected from the remaining vertices; restart from a random seed
+                frontier.clear();
+                while (nextSeed != seeds.end() && parts[*nextSeed] != unassigned)
+                {
+                    nextSeed++;
+                }
+                if (nextSeed == seeds.end())
+                {
+                    break;
+                }
+                best = *nextSeed;
+            }
+            else
+            {
+                frontier[bestPos] = frontier.back();
+                frontier.pop_back();
+                connectivity[best] = 0.0;
+                inFrontier[best] = false;
+            }
+
+            parts[best] = p;
+            load += graph.vwgt[best];
+            for (std::size_t e = graph.xadj[best]; e < graph.xadj[best + 1]; e++)
+            {
+                const std::size_t u = graph.adjncy[e];
+                if (parts[u] == unassigned)
+                {
+                    if (!inFrontier[u])
+                    {
+                        inFrontier[u] = true;
+                        frontier.push_back(u);
+                    }
+                    connectivity[u] += graph.adjwgt[e];
+                }
+            }
+        }
+
+        for (std::vector<std::size_t>::const_iterator it = frontier.begin(); it != frontier.end(); it++)
+        {
+            connectivity[*it] = 0.0;
+            inFrontier[*it] = false;
+        }
+        frontier.clear();
+    }
+
+    //whatever is left goes to the last part
+    for (std::size_t v = 0; v < n; v++)
+    {
+        if (parts[v] == unassigned)
+        {
+            parts[v] = numParts - 1;
+        }
+    }
+}
+
+void GraphPartitioner::refine(const Graph& graph, unsigned int numParts, double maxLoad, std::vector<unsigned int>& parts, boost::mt19937& rng)
+{
+    const std::size_t n = graph.size();
+    std::vector<double> loads;
+    computeLoads(graph.vwgt, parts, numParts, loads);
+
+    std::vector<double> connectivity(numParts, 0.0);
+    std::vector<bool> isNeighbourPart(numParts, false);
+    std::vector<unsigned int> neighbourParts;
+    std::vector<std::size_t> perm;
+
+    for (unsigned int pass = 0; pass < MAX_REFINEMENT_PASSES; pass++)
+    {
+        unsigned int numMoves = 0;
+        randomPermutation(n, perm, rng);
+        for (std::vector<std::size_t>::const_iterator vIt = perm.begin(); vIt != perm.end(); vIt++)
+        {
+            const std::size_t v = *vIt;
+            const unsigned int from = parts[v];
+            const double weight = graph.vwgt[v];
+
+            double internal = 0.0;
+            neighbourParts.clear();
+            for (std::size_t e = graph.xadj[v]; e < graph.xadj[v + 1]; e++)
+            {
+                const unsigned int q = parts[graph.adjncy[e]];
+                if (q == from)
+                {
+                    internal += graph.adjwgt[e];
+                }
+                else
+                {
+                    if (!isNeighbourPart[q])
+                    {
+                        isNeighbourPart[q] = true;
+                        neighbourParts.push_back(q);
+                    }
+                    connectivity[q] += graph.adjwgt[e];
+                }
+            }
+            if (neighbourParts.empty())
+            {
+                continue; //interior vertex
+            }
+
+            unsigned int best = numParts;
+            double bestGain = -std::numeric_limits<double>::max();
+            for (std::vector<unsigned int>::const_iterator qIt = neighbourParts.begin(); qIt != neighbourParts.end(); qIt++)
+            {
+                const unsigned int q = *qIt;
+                const double gain = connectivity[q] - internal;
+                connectivity[q] = 0.0;
+                isNeighbourPart[q] = false;
+                if (loads[q] + weight > maxLoad)
+                {
+                    continue;
+                }
+                if (best == numParts || gain > bestGain || (gain == bestGain && loads[q] < loads[best]))
+                {
+                    best = q;
+                    bestGain = gain;
+                }
+            }
+            if (best == numParts)
+            {
+                continue;
+            }
+
+            //accept strictly improving moves, balance improving moves of zero gain and any move out of an overloaded part
+            if (bestGain > 0.0 || (bestGain == 0.0 && loads[best] + weight < loads[from]) || loads[from] > maxLoad)
+            {
+                parts[v] = best;
+                loads[from] -= weight;
+                loads[best] += weight;
+                numMoves++;
+            }
+        }
+        if (numMoves == 0)
+        {
+            break;
+        }
+    }
+}
+
+double GraphPartitioner::cutWeight(const Graph& graph, const std::vector<unsigned int>& parts)
+{
+    double cut = 0.0;
+    for (std::size_t v = 0; v < graph.size(); v++)
+    {
+        for (std::size_t e = graph.xadj[v]; e < graph.xadj[v + 1]; e++)
+        {
+            if (v < graph.adjncy[e] && parts[v] != parts[graph.adjncy[e]])
+            {
+                cut += graph.adjwgt[e];
+            }
+        }
+    }
+    return cut;
+}
+
+std::vector<unsigned int> GraphPartitioner::partition(unsigned int numParts, double imbalanceTolerance) const
+{
+    if (numParts == 0)
+    {
+        throw std::runtime_error("GraphPartitioner: number of parts must be positive");
+    }
+    const std::size_t n = vertexWeights.size();
+    if (numParts == 1 || n == 0)
+    {
+        return std::vector<unsigned int>(n, 0);
+    }
+
+    boost::mt19937 rng(seed);
+    double totalWeight = 0.0;
+    for (std::size_t v = 0; v < n; v++)
+    {
+        totalWeight += vertexWeights[v];
+    }
+    const double maxLoad = (1.0 + imbalanceTolerance) * totalWeight / numParts;
+
+    //coarsening phase
+    std::vector<Graph> levels(1);
+    std::vector< std::vector<std::size_t> > cmaps;
+    buildGraph(levels.front());
+    const std::size_t coarsenTo = std::max(COARSEN_VERTICES_PER_PART * numParts, MIN_COARSEST_GRAPH_SIZE);
+    const double maxVertexWeight = std::max(1.5 * totalWeight / coarsenTo, *std::max_element(vertexWeights.begin(), vertexWeights.end()));
+    while (levels.back().size() > coarsenTo)
+    {
+        Graph coarse;
+        std::vector<std::size_t> cmap;
+        coarsen(levels.back(), coarse, cmap, maxVertexWeight, rng);
+        if (coarse.size() > MIN_COARSENING_REDUCTION * levels.back().size())
+        {
+            break;
+        }
+        levels.push_back(Graph());
+        levels.back().xadj.swap(coarse.xadj);
+        levels.back().adjncy.swap(coarse.adjncy);
+        levels.back().adjwgt.swap(coarse.adjwgt);
+        levels.back().vwgt.swap(coarse.vwgt);
+        cmaps.push_back(std::vector<std::size_t>());
+        cmaps.back().swap(cmap);
+    }
+
+    //initial partitioning phase; keep the best of a few trials
+    const Graph& coarsest = levels.back();
+    std::vector<unsigned int> parts;
+    std::vector<double> loads;
+    double bestCut = std::numeric_limits<double>::max();
+    double bestMaxLoad = std::numeric_limits<double>::max();
+    for (unsigned int trial = 0; trial < NUM_INITIAL_PARTITION_TRIALS; trial++)
+    {
+        std::vector<unsigned int> trialParts;
+        growInitialPartition(coarsest, numParts, trialParts, rng);
+        refine(coarsest, numParts, maxLoad, trialParts, rng);
+
+        computeLoads(coarsest.vwgt, trialParts, numParts, loads);
+        const double trialMaxLoad = *std::max_element(loads.begin(), loads.end());
+        const double trialCut = cutWeight(coarsest, trialParts);
+        const bool balanced = (trialMaxLoad <= maxLoad);
+        const bool bestBalanced = (bestMaxLoad <= maxLoad);
+        if (parts.empty() || (balanced && (!bestBalanced || trialCut < bestCut)) || (!balanced && !bestBalanced && trialMaxLoad < bestMaxLoad))
+        {
+            parts.swap(trialParts);
+            bestCut = trialCut;
+            bestMaxLoad = trialMaxLoad;
+        }
+    }
+
+    //uncoarsening phase
+    for (std::size_t level = cmaps.size(); level > 0; level--)
+    {
+        const std::vector<std::size_t>& cmap = cmaps[level - 1];
+        std::vector<unsigned int> fineParts(cmap.size());
+        for (std::size_t v = 0; v < cmap.size(); v++)
+        {
+            fineParts[v] = parts[cmap[v]];
+        }
+        parts.swap(fineParts);
+        refine(levels[level - 1], numParts, maxLoad, parts, rng);
+    }
+    return parts;
+}
+
+PartitionStats GraphPartitioner::computeStats(const std::vector<unsigned int>& parts, unsigned int numParts) const
+{
+    if (parts.size() != vertexWeights.size())
+    {
+        throw std::runtime_error("GraphPartitioner: partition does not match the graph");
+    }
+
+    PartitionStats stats;
+    stats.loads.assign(numParts, 0.0);
+    for (std::size_t v = 0; v < parts.size(); v++)
+    {
+        if (parts[v] >= numParts)
+        {
+            throw std::runtime_error("GraphPartitioner: invalid part number in partition");
+        }
+        stats.loads[parts[v]] += vertexWeights[v];
+        stats.totalLoad += vertexWeights[v];
+    }
+    for (std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); it++)
+    {
+        if (parts[it->u] != parts[it->v])
+        {
+            stats.cutWeight += it->weight;
+            stats.cutEdges++;
+        }
+    }
+    if (numParts > 0)
+    {
+        stats.maxLoad = *std::max_element(stats.loads.begin(), stats.loads.end());
+        stats.minLoad = *std::min_element(stats.loads.begin(), stats.loads.end());
+        const double avgLoad = stats.totalLoad / numParts;
+        stats.imbalance = (avgLoad > 0.0) ? (stats.maxLoad / avgLoad - 1.0) : 0.0;
+    }
+    return stats;
+}
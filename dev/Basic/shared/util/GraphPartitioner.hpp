@@ -0,0 +1,182 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include <boost/random.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Summary of the quality of a k-way partition of a weighted graph.
+ */
+struct PartitionStats
+{
+    PartitionStats() : cutWeight(0.0), cutEdges(0), totalLoad(0.0), maxLoad(0.0), minLoad(0.0), imbalance(0.0)
+    {
+    }
+
+    /** sum of weights of all edges whose end points lie in different parts */
+    double cutWeight;
+
+    /** number of edges whose end points lie in different parts */
+    unsigned int cutEdges;
+
+    /** sum of the vertex weights */
+    double totalLoad;
+
+    /** load (sum of vertex weights) of the heaviest part */
+    double maxLoad;
+
+    /** load (sum of vertex weights) of the lightest part */
+    double minLoad;
+
+    /** heaviest load divided by the average load, minus 1. 0 indicates perfect balance */
+    double imbalance;
+
+    /** load of each part, indexed by part number */
+    std::vector<double> loads;
+
+    /**
+     * prints the stats as a human readable report
+     * @param os stream to print to
+     */
+    void print(std::ostream& os) const;
+};
+
+/**
+ * Multilevel k-way partitioner for undirected graphs with weighted vertices and edges.
+ *
+ * The graph is built incrementally with addVertex()/addEdge(); partition() then
+ *  1. coarsens the graph by repeatedly collapsing heavy-edge matchings,
+ *  2. computes an initial partition of the coarsest graph by greedy graph growing, and
+ *  3. projects the partition back through each level, refining it at every level with
+ *     Fiduccia-Mattheyses style boundary moves (greedy k-way refinement).
+ * The objective is to minimise the total weight of cut edges while keeping the load of every part
+ *  within (1 + imbalanceTolerance) of the average load.
+ *
+ * The partitioner is deterministic for a given seed.
+ */
+class GraphPartitioner
+{
+public:
+    GraphPartitioner(unsigned int seed = 1);
+
+    /**
+     * adds a vertex to the graph
+     * @param weight weight (load) of the vertex. Must be non-negative
+     * @return the dense index of the added vertex
+     */
+    std::size_t addVertex(double weight);
+
+    /**
+     * adds an undirected edge between two vertices. Parallel edges are merged by summing their weights.
+     * Self loops are ignored since they can never be cut.
+     * @param u index of first vertex
+     * @param v index of second vertex
+     * @param weight weight of the edge. Must be non-negative
+     */
+    void addEdge(std::size_t u, std::size_t v, double weight);
+
+    /**
+     * @return number of vertices added so far
+     */
+    std::size_t getNumVertices() const
+    {
+        return vertexWeights.size();
+    }
+
+    /**
+     * partitions the graph into numParts parts
+     * @param numParts number of parts
+     * @param imbalanceTolerance allowed relative excess of the heaviest part over the average load
+     * @return part number for each vertex, indexed by vertex index
+     */
+    std::vector<unsigned int> partition(unsigned int numParts, double imbalanceTolerance = 0.05) const;
+
+    /**
+     * computes cut and load statistics of a partition of this graph
+     * @param parts part number of each vertex
+     * @param numParts number of parts
+     * @return partition statistics
+     */
+    PartitionStats computeStats(const std::vector<unsigned int>& parts, unsigned int numParts) const;
+
+private:
+    /** graph in compressed sparse row form */
+    struct Graph
+    {
+        /** adjacency of vertex v is stored in [xadj[v], xadj[v+1]) */
+        std::vector<std::size_t> xadj;
+        std::vector<std::size_t> adjncy;
+        std::vector<double> adjwgt;
+        std::vector<double> vwgt;
+
+        std::size_t size() const
+        {
+            return vwgt.size();
+        }
+    };
+
+    /**
+     * builds the CSR form of the input graph, merging parallel edges
+     * @param graph output graph
+     */
+    void buildGraph(Graph& graph) const;
+
+    /**
+     * collapses a heavy edge matching of the fine graph into a coarse graph
+     * @param fine graph to coarsen
+     * @param coarse output coarse graph
+     * @param cmap output mapping from fine vertex to coarse vertex
+     * @param maxVertexWeight coarse vertices heavier than this are not created
+     * @param rng seed state for the visit order
+     */
+    static void coarsen(const Graph& fine, Graph& coarse, std::vector<std::size_t>& cmap, double maxVertexWeight, boost::mt19937& rng);
+
+    /**
+     * computes an initial partition by greedily growing one region per part
+     * @param graph graph to partition
+     * @param numParts number of parts
+     * @param parts output part of each vertex
+     * @param rng seed state for the choice of seeds
+     */
+    static void growInitialPartition(const Graph& graph, unsigned int numParts, std::vector<unsigned int>& parts, boost::mt19937& rng);
+
+    /**
+     * improves a partition by moving boundary vertices to the neighbouring part with the largest gain
+     * @param graph partitioned graph
+     * @param numParts number of parts
+     * @param maxLoad load limit of each part
+     * @param parts part of each vertex; updated in place
+     * @param rng seed state for the visit order
+     */
+    static void refine(const Graph& graph, unsigned int numParts, double maxLoad, std::vector<unsigned int>& parts, boost::mt19937& rng);
+
+    /**
+     * sums the weight of edges cut by a partition
+     */
+    static double cutWeight(const Graph& graph, const std::vector<unsigned int>& parts);
+
+    /** weight of each vertex */
+    std::vector<double> vertexWeights;
+
+    /** input edges (u, v, weight); merged when the graph is built */
+    struct Edge
+    {
+        std::size_t u;
+        std::size_t v;
+        double weight;
+    };
+    std::vector<Edge> edges;
+
+    /** seed for all randomised steps */
+    unsigned int seed;
+};
+
+}
@@ -0,0 +1,204 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "OutputStreamer.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono.hpp>
+
+using namespace sim_mob;
+
+FileOutputSink::FileOutputSink(const std::string& fileName) :
+        fileName(fileName), file(fileName.c_str(), std::ios::trunc | std::ios::out | std::ios::binary)
+{
+    if (!file.good())
+    {
+        std::stringstream errStrm;
+        errStrm << "FileOutputSink: cannot open " << fileName << " for writing";
+        throw std::runtime_error(errStrm.str());
+    }
+}
+
+void FileOutputSink::write(const std::string& data)
+{
+    file.write(data.data(), data.size());
+    if (!file.good())
+    {
+        std::stringstream errStrm;
+        errStrm << "FileOutputSink: error writing to " << fileName;
+        throw std::runtime_error(errStrm.str());
+    }
+}
+
+void FileOutputSink::close()
+{
+    file.close();
+    if (file.fail())
+    {
+        std::stringstream errStrm;
+        errStrm << "FileOutputSink: error closing " << fileName;
+        throw std::runtime_error(errStrm.str());
+    }
+}
+
+OutputStreamer::OutputStreamer(std::size_t numProducers, std::size_t bufferSize, std::size_t maxQueuedBuffers,
+        const std::vector< boost::shared_ptr<OutputSink> >& sinks) :
+        bufferSize(bufferSize), maxQueuedBuffers(maxQueuedBuffers), sinks(sinks), buffers(numProducers),
+        closing(false), finished(false), abandoned(false), bytesWritten(0), waitSeconds(0)
+{
+    if (numProducers == 0 || maxQueuedBuffers == 0)
+    {
+        throw std::runtime_error("OutputStreamer: number of producers and queue length must be positive");
+    }
+    for (std::vector<std::string>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+    {
+        it->reserve(bufferSize);
+    }
+    writer = boost::thread(boost::bind(&OutputStreamer::writeLoop, this));
+}
+
+OutputStreamer::~OutputStreamer()
+{
+    if (writer.joinable())
+    {
+        {
+            boost::mutex::scoped_lock lock(queueMutex);
+            closing = true;
+            abandoned = true;
+        }
+        notEmpty.notify_all();
+        writer.join();
+    }
+}
+
+void OutputStreamer::append(std::size_t producerId, const std::string& data)
+{
+    std::string& buffer = buffers.at(producerId);
+    buffer.append(data);
+    if (buffer.size() >= bufferSize && !enqueue(buffer))
+    {
+        throw std::runtime_error("OutputStreamer: writer failed; output is incomplete");
+    }
+}
+
+bool OutputStreamer::enqueue(std::string& buffer)
+{
+    boost::mutex::scoped_lock lock(queueMutex);
+    if (queue.size() >= maxQueuedBuffers && !error)
+    {
+        boost::chrono::steady_clock::time_point waitStart = boost::chrono::steady_clock::now();
+        while (queue.size() >= maxQueuedBuffers && !error)
+        {
+            notFull.wait(lock);
+        }
+        waitSeconds += boost::chrono::duration<double>(boost::chrono::steady_clock::now() - waitStart).count();
+    }
+    if (error)
+    {
+        return false;
+    }
+
+    // hand over the contents and keep the capacity of the producer buffer
+    queue.push_back(std::string());
+    queue.back().swap(buffer);
+    buffer.reserve(bufferSize);
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+void OutputStreamer::finish()
+{
+    if (finished)
+    {
+        throw std::runtime_error("OutputStreamer: finish() called twice");
+    }
+    finished = true;
+
+    for (std::vector<std::string>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+    {
+        if (!it->empty() && !enqueue(*it))
+        {
+            break;
+        }
+    }
+    {
+        boost::mutex::scoped_lock lock(queueMutex);
+        closing = true;
+    }
+    notEmpty.notify_all();
+    writer.join();
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+std::size_t OutputStreamer::getBytesWritten() const
+{
+    boost::mutex::scoped_lock lock(queueMutex);
+    return bytesWritten;
+}
+
+double OutputStreamer::getWaitSeconds() const
+{
+    boost::mutex::scoped_lock lock(queueMutex);
+    return waitSeconds;
+}
+
+void OutputStreamer::writeLoop()
+{
+    std::string block;
+    bool stopped = false;
+    try
+    {
+        while (true)
+        {
+            {
+                boost::mutex::scoped_lock lock(queueMutex);
+                while (queue.empty() && !closing)
+                {
+                    notEmpty.wait(lock);
+                }
+                if (abandoned || queue.empty())
+                {
+                    stopped = abandoned;
+                    break;
+                }
+                block.swap(queue.front());
+                queue.pop_front();
+            }
+            notFull.notify_one();
+
+            for (std::vector< boost::shared_ptr<OutputSink> >::iterator it = sinks.begin(); it != sinks.end(); ++it)
+            {
+                (*it)->write(block);
+            }
+
+            boost::mutex::scoped_lock lock(queueMutex);
+            bytesWritten += block.size();
+            block.clear();
+        }
+
+        if (!stopped)
+        {
+            for (std::vector< boost::shared_ptr<OutputSink> >::iterator it = sinks.begin(); it != sinks.end(); ++it)
+            {
+                (*it)->close();
+            }
+        }
+    }
+    catch (...)
+    {
+        boost::mutex::scoped_lock lock(queueMutex);
+        error = std::current_exception();
+        queue.clear();
+    }
+
+    // wake up producers waiting for room, which is either there now or will never come
+    notFull.notify_all();
+}
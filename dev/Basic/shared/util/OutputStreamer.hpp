@@ -0,0 +1,156 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Destination of the output of an OutputStreamer. Only the writer thread of the streamer calls a sink.
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink()
+    {
+    }
+
+    /**
+     * writes a block of complete output lines
+     * @param data lines to write
+     */
+    virtual void write(const std::string& data) = 0;
+
+    /**
+     * completes the output; called once, after the last write()
+     */
+    virtual void close() = 0;
+};
+
+/**
+ * Sink writing the output to a file
+ */
+class FileOutputSink : public OutputSink
+{
+public:
+    /**
+     * @param fileName file to write; truncated if it exists
+     */
+    explicit FileOutputSink(const std::string& fileName);
+
+    virtual void write(const std::string& data);
+    virtual void close();
+
+private:
+    std::string fileName;
+    std::ofstream file;
+};
+
+/**
+ * Collects text output from a number of producer threads and writes it to one or more sinks from a dedicated
+ * writer thread, while the producers keep running.
+ *
+ * Each producer appends to its own buffer without locking. A full buffer is handed to the writer through a queue
+ * of bounded length; a producer which finds the queue full waits for the writer to catch up, so that the memory
+ * held by the streamer stays bounded however fast the output is produced.
+ *
+ * Blocks handed to the writer are never split, so lines appended in one call to append() reach the sinks
+ * together. Blocks of different producers are written in the order in which they were handed over.
+ */
+class OutputStreamer
+{
+public:
+    /**
+     * starts the writer thread
+     * @param numProducers number of producer threads; producers are identified by 0 to numProducers - 1
+     * @param bufferSize size in bytes at which the buffer of a producer is handed to the writer
+     * @param maxQueuedBuffers number of full buffers which may wait for the writer before producers wait
+     * @param sinks sinks to write to
+     */
+    OutputStreamer(std::size_t numProducers, std::size_t bufferSize, std::size_t maxQueuedBuffers,
+            const std::vector< boost::shared_ptr<OutputSink> >& sinks);
+
+    /**
+     * stops the writer thread; the output is not completed if finish() was not called
+     */
+    ~OutputStreamer();
+
+    /**
+     * appends output of a producer. Must only be called by the thread of the producer.
+     * Throws if the writer failed.
+     * @param producerId id of the calling producer
+     * @param data complete lines to append
+     */
+    void append(std::size_t producerId, const std::string& data);
+
+    /**
+     * hands the remaining buffers of all producers to the writer, waits for the writer to write them and closes
+     * the sinks. Must be called once all producers are done. Rethrows the error of the writer, if any.
+     */
+    void finish();
+
+    /**
+     * @return number of bytes written to the sinks so far
+     */
+    std::size_t getBytesWritten() const;
+
+    /**
+     * @return total time spent by producers waiting for room in the queue, in seconds
+     */
+    double getWaitSeconds() const;
+
+private:
+    /**
+     * hands a buffer to the writer, waiting while the queue is full
+     * @return false if the writer failed; true otherwise
+     */
+    bool enqueue(std::string& buffer);
+
+    /** writer thread loop */
+    void writeLoop();
+
+    std::size_t bufferSize;
+    std::size_t maxQueuedBuffers;
+    std::vector< boost::shared_ptr<OutputSink> > sinks;
+
+    /** buffer of each producer */
+    std::vector<std::string> buffers;
+
+    /** full buffers waiting for the writer */
+    std::deque<std::string> queue;
+    mutable boost::mutex queueMutex;
+    /** signalled when a buffer is queued or the producers are done */
+    boost::condition_variable notEmpty;
+    /** signalled when the writer takes a buffer from the queue or fails */
+    boost::condition_variable notFull;
+
+    /** set once no more buffers will be queued */
+    bool closing;
+    /** set once finish() was called */
+    bool finished;
+    /** set if the streamer is destroyed before finish(); the writer then stops without closing the sinks */
+    bool abandoned;
+
+    std::size_t bytesWritten;
+    double waitSeconds;
+
+    /** error thrown by a sink; the writer stops at the first one */
+    std::exception_ptr error;
+
+    boost::thread writer;
+};
+
+}
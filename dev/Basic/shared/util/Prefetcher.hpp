@@ -0,0 +1,189 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/utility.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Produces a sequence of items on a background thread, up to a given number of items ahead of the thread taking them.
+ *
+ * The producer is called with the indices 0, 1, 2... in order, on a background thread started by the first take(). With
+ * a lookahead of 0, there is no background thread: each item is produced by take(), on the calling thread. Either way,
+ * items are taken in the order of their indices.
+ *
+ * Only the producer runs on the background thread; whatever must not depend on its timing, such as handing out ids,
+ * must be done by the taking thread on the items it takes. An exception thrown by the producer stops the background
+ * thread and is rethrown by take() once the items produced before it have been taken.
+ *
+ * T must be default constructible and swappable; the items are swapped in and out of the queue.
+ */
+template <typename T>
+class Prefetcher : private boost::noncopyable
+{
+public:
+    /** produces the item of the given index into the given default constructed item */
+    typedef boost::function<void (std::size_t, T&)> Producer;
+
+    /**
+     * @param producer the producer; called on the background thread only, one item at a time
+     * @param lookahead maximum number of items produced and not taken yet; 0 to produce the items when taken
+     */
+    Prefetcher(const Producer& producer, unsigned int lookahead) :
+            producer(producer), lookahead(lookahead), nextIndex(0), stopping(false)
+    {
+    }
+
+    /** stops the background thread; the items not taken are destroyed */
+    ~Prefetcher()
+    {
+        std::vector<T> pending;
+        stop(pending);
+    }
+
+    /**
+     * takes the next item, waiting for it to be produced if needed
+     * @param item output item, swapped with the produced one
+     * @throws the exception thrown by the producer for this item
+     */
+    void take(T& item)
+    {
+        if (lookahead == 0)
+        {
+            T produced;
+            producer(nextIndex, produced);
+            nextIndex++;
+            std::swap(item, produced);
+            return;
+        }
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        if (!thread && !stopping)
+        {
+            thread.reset(new boost::thread(boost::bind(&Prefetcher::produceLoop, this)));
+        }
+        while (ready.empty() && !error && !stopping)
+        {
+            condition.wait(lock);
+        }
+        if (ready.empty())
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            throw std::runtime_error("Prefetcher: take() after stop()");
+        }
+        std::swap(item, ready.front());
+        ready.pop_front();
+        lock.unlock();
+        condition.notify_all();
+    }
+
+    /**
+     * stops the background thread, after it has produced the item it is producing, if any
+     * @param pending output: the items produced and not taken, in order
+     */
+    void stop(std::vector<T>& pending)
+    {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        if (thread)
+        {
+            thread->join();
+            thread.reset();
+        }
+
+        while (!ready.empty())
+        {
+            pending.push_back(T());
+            std::swap(pending.back(), ready.front());
+            ready.pop_front();
+        }
+    }
+
+private:
+    /** body of the background thread */
+    void produceLoop()
+    {
+        try
+        {
+            while (true)
+            {
+                std::size_t index = 0;
+                {
+                    boost::unique_lock<boost::mutex> lock(mutex);
+                    while (!stopping && ready.size() >= lookahead)
+                    {
+                        condition.wait(lock);
+                    }
+                    if (stopping)
+                    {
+                        return;
+                    }
+                    index = nextIndex;
+                }
+
+                T produced;
+                producer(index, produced);
+                {
+                    boost::unique_lock<boost::mutex> lock(mutex);
+                    ready.push_back(T());
+                    std::swap(ready.back(), produced);
+                    nextIndex++;
+                }
+                condition.notify_all();
+            }
+        }
+        catch (...)
+        {
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                error = std::current_exception();
+            }
+            condition.notify_all();
+        }
+    }
+
+    Producer producer;
+    unsigned int lookahead;
+
+    /** the background thread; started by the first take() */
+    boost::scoped_ptr<boost::thread> thread;
+
+    /** guards the members below, shared with the background thread */
+    boost::mutex mutex;
+    boost::condition_variable condition;
+
+    /** items produced and not taken, in order */
+    std::deque<T> ready;
+
+    /** index of the next item to produce */
+    std::size_t nextIndex;
+
+    bool stopping;
+
+    /** exception which stopped the background thread */
+    std::exception_ptr error;
+};
+
+}
@@ -0,0 +1,320 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "RandomService.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <boost/atomic.hpp>
+
+using namespace sim_mob;
+
+namespace
+{
+const boost::uint32_t PHILOX_M0 = 0xD2511F53;
+const boost::uint32_t PHILOX_M1 = 0xCD9E8D57;
+const boost::uint32_t PHILOX_W0 = 0x9E3779B9;
+const boost::uint32_t PHILOX_W1 = 0xBB67AE85;
+const unsigned int PHILOX_ROUNDS = 10;
+
+/** number of blocks computed together by the bulk generation */
+const std::size_t PHILOX_LANES = 8;
+
+/** number of blocks computed at a time by the bulk draws of a stream */
+const std::size_t BULK_BLOCKS = 64;
+
+const double TWO_PI = 6.283185307179586;
+
+/** global seed; set while loading the configuration, before the streams of the agents are created */
+boost::atomic<boost::uint64_t> globalSeed(0);
+
+/** id of the stream of the thread */
+thread_local boost::uint32_t threadStreamId = 0;
+
+/** stream of the agent being updated by the thread, if any */
+thread_local RandomStream* currentStream = nullptr;
+
+/** stream of the thread, for draws made out of an agent update */
+thread_local std::unique_ptr<RandomStream> threadStream;
+
+inline double toUniform(boost::uint32_t high, boost::uint32_t low)
+{
+    return ((high >> 5) * 67108864.0 + (low >> 6)) * (1.0 / 9007199254740992.0);
+}
+}
+
+void Philox4x32::generate(const boost::uint32_t counter[4], const boost::uint32_t key[2], boost::uint32_t block[4])
+{
+    boost::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    boost::uint32_t k0 = key[0], k1 = key[1];
+    for (unsigned int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        boost::uint64_t p0 = static_cast<boost::uint64_t>(PHILOX_M0) * c0;
+        boost::uint64_t p1 = static_cast<boost::uint64_t>(PHILOX_M1) * c2;
+        c0 = static_cast<boost::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c2 = static_cast<boost::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<boost::uint32_t>(p1);
+        c3 = static_cast<boost::uint32_t>(p0);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    block[0] = c0;
+    block[1] = c1;
+    block[2] = c2;
+    block[3] = c3;
+}
+
+void Philox4x32::generate(const boost::uint32_t counter[4], const boost::uint32_t key[2], std::size_t numBlocks,
+                          boost::uint32_t* blocks)
+{
+    const boost::uint64_t firstIndex = (static_cast<boost::uint64_t>(counter[1]) << 32) | counter[0];
+
+    //The rounds are applied to a group of blocks at a time, one lane per block, so that the compiler can vectorise them
+    boost::uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES], c3[PHILOX_LANES];
+    for (std::size_t first = 0; first < numBlocks; first += PHILOX_LANES)
+    {
+        for (std::size_t lane = 0; lane < PHILOX_LANES; lane++)
+        {
+            boost::uint64_t index = firstIndex + first + lane;
+            c0[lane] = static_cast<boost::uint32_t>(index);
+            c1[lane] = static_cast<boost::uint32_t>(index >> 32);
+            c2[lane] = counter[2];
+            c3[lane] = counter[3];
+        }
+
+        boost::uint32_t k0 = key[0], k1 = key[1];
+        for (unsigned int round = 0; round < PHILOX_ROUNDS; round++)
+        {
+            for (std::size_t lane = 0; lane < PHILOX_LANES; lane++)
+            {
+                boost::uint64_t p0 = static_cast<boost::uint64_t>(PHILOX_M0) * c0[lane];
+                boost::uint64_t p1 = static_cast<boost::uint64_t>(PHILOX_M1) * c2[lane];
+                c0[lane] = static_cast<boost::uint32_t>(p1 >> 32) ^ c1[lane] ^ k0;
+                c2[lane] = static_cast<boost::uint32_t>(p0 >> 32) ^ c3[lane] ^ k1;
+                c1[lane] = static_cast<boost::uint32_t>(p1);
+                c3[lane] = static_cast<boost::uint32_t>(p0);
+            }
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        std::size_t numLanes = std::min(PHILOX_LANES, numBlocks - first);
+        boost::uint32_t* out = blocks + 4 * first;
+        for (std::size_t lane = 0; lane < numLanes; lane++)
+        {
+            out[4 * lane] = c0[lane];
+            out[4 * lane + 1] = c1[lane];
+            out[4 * lane + 2] = c2[lane];
+            out[4 * lane + 3] = c3[lane];
+        }
+    }
+}
+
+RandomStream::RandomStream(boost::uint32_t streamId, boost::uint32_t purpose) :
+        streamId(streamId), purpose(purpose), blockIndex(0), nextWord(4), spareNormal(0.0), hasSpareNormal(false)
+{
+    boost::uint64_t seed = globalSeed.load(boost::memory_order_relaxed);
+    key[0] = static_cast<boost::uint32_t>(seed);
+    key[1] = static_cast<boost::uint32_t>(seed >> 32);
+}
+
+RandomStream::RandomStream(boost::uint64_t seed, boost::uint32_t streamId, boost::uint32_t purpose) :
+        streamId(streamId), purpose(purpose), blockIndex(0), nextWord(4), spareNormal(0.0), hasSpareNormal(false)
+{
+    key[0] = static_cast<boost::uint32_t>(seed);
+    key[1] = static_cast<boost::uint32_t>(seed >> 32);
+}
+
+void RandomStream::getCounter(boost::uint32_t counter[4]) const
+{
+    counter[0] = static_cast<boost::uint32_t>(blockIndex);
+    counter[1] = static_cast<boost::uint32_t>(blockIndex >> 32);
+    counter[2] = streamId;
+    counter[3] = purpose;
+}
+
+void RandomStream::refill()
+{
+    boost::uint32_t counter[4];
+    getCounter(counter);
+    Philox4x32::generate(counter, key, buffer);
+    blockIndex++;
+    nextWord = 0;
+}
+
+int RandomStream::uniformInt(int min, int max)
+{
+    if (max <= min)
+    {
+        return min;
+    }
+
+    //Lemire's multiply and shift, rejecting the few products which would bias the result
+    const boost::uint64_t range = static_cast<boost::uint64_t>(static_cast<boost::int64_t>(max) - min) + 1;
+    if (range > 0xFFFFFFFF)
+    {
+        return static_cast<int>(static_cast<boost::int64_t>(min) + (*this)());
+    }
+    boost::uint64_t product = static_cast<boost::uint64_t>((*this)()) * range;
+    if (static_cast<boost::uint32_t>(product) < range)
+    {
+        const boost::uint32_t threshold = static_cast<boost::uint32_t>((0x100000000ULL - range) % range);
+        while (static_cast<boost::uint32_t>(product) < threshold)
+        {
+            product = static_cast<boost::uint64_t>((*this)()) * range;
+        }
+    }
+    return static_cast<int>(static_cast<boost::int64_t>(min) + static_cast<boost::int64_t>(product >> 32));
+}
+
+double RandomStream::lognormal(double location, double scale)
+{
+    return std::exp(normal(location, scale));
+}
+
+double RandomStream::standardNormal()
+{
+    if (hasSpareNormal)
+    {
+        hasSpareNormal = false;
+        return spareNormal;
+    }
+
+    double pair[2];
+    pair[0] = uniform();
+    pair[1] = uniform();
+    toStandardNormal(pair, 2);
+    spareNormal = pair[1];
+    hasSpareNormal = true;
+    return pair[0];
+}
+
+void RandomStream::toStandardNormal(double* values, std::size_t count)
+{
+    for (std::size_t i = 0; i + 1 < count; i += 2)
+    {
+        //1 - u is in (0, 1]
+        double radius = std::sqrt(-2.0 * std::log(1.0 - values[i]));
+        double angle = TWO_PI * values[i + 1];
+        values[i] = radius * std::cos(angle);
+        values[i + 1] = radius * std::sin(angle);
+    }
+}
+
+void RandomStream::fillUniform(double* values, std::size_t count, double min, double max)
+{
+    boost::uint32_t words[4 * BULK_BLOCKS + 4];
+    std::size_t done = 0;
+    while (done < count)
+    {
+        //Words left in the current block come first
+        std::size_t numWords = 0;
+        while (nextWord < 4)
+        {
+            words[numWords++] = buffer[nextWord++];
+        }
+
+        const std::size_t neededWords = 2 * (count - done);
+        const std::size_t numBlocks = (neededWords > numWords) ?
+                std::min(BULK_BLOCKS, (neededWords - numWords + 3) / 4) : 0;
+        boost::uint32_t counter[4];
+        getCounter(counter);
+        Philox4x32::generate(counter, key, numBlocks, words + numWords);
+        blockIndex += numBlocks;
+        numWords += 4 * numBlocks;
+
+        const std::size_t numValues = std::min(count - done, numWords / 2);
+        const double width = max - min;
+        for (std::size_t i = 0; i < numValues; i++)
+        {
+            values[done + i] = min + width * toUniform(words[2 * i], words[2 * i + 1]);
+        }
+        done += numValues;
+
+        //The words not drawn are the end of the last block, which becomes the current block
+        const std::size_t numLeft = numWords - 2 * numValues;
+        nextWord = 4 - numLeft;
+        std::copy(words + 2 * numValues, words + numWords, buffer + nextWord);
+    }
+}
+
+void RandomStream::fillNormal(double* values, std::size_t count, double mean, double stddev)
+{
+    std::size_t done = 0;
+    if (count > 0 && hasSpareNormal)
+    {
+        values[done++] = normal(mean, stddev);
+    }
+
+    const std::size_t numPaired = ((count - done) / 2) * 2;
+    fillUniform(values + done, numPaired);
+    toStandardNormal(values + done, numPaired);
+    for (std::size_t i = done; i < done + numPaired; i++)
+    {
+        values[i] = mean + stddev * values[i];
+    }
+    done += numPaired;
+
+    if (done < count)
+    {
+        values[done] = normal(mean, stddev);
+    }
+}
+
+void RandomStream::fillLognormal(double* values, std::size_t count, double location, double scale)
+{
+    fillNormal(values, count, location, scale);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        values[i] = std::exp(values[i]);
+    }
+}
+
+RandomService::Scope::Scope(RandomStream& stream) : previous(currentStream)
+{
+    currentStream = &stream;
+}
+
+RandomService::Scope::Scope(RandomStream* stream) : previous(currentStream)
+{
+    if (stream)
+    {
+        currentStream = stream;
+    }
+}
+
+RandomService::Scope::~Scope()
+{
+    currentStream = previous;
+}
+
+void RandomService::setSeed(boost::uint64_t seed)
+{
+    globalSeed.store(seed, boost::memory_order_relaxed);
+}
+
+boost::uint64_t RandomService::getSeed()
+{
+    return globalSeed.load(boost::memory_order_relaxed);
+}
+
+void RandomService::setThreadStreamId(boost::uint32_t streamId)
+{
+    threadStreamId = streamId;
+    threadStream.reset();
+}
+
+RandomStream& RandomService::current()
+{
+    if (currentStream)
+    {
+        return *currentStream;
+    }
+    if (!threadStream)
+    {
+        threadStream.reset(new RandomStream(threadStreamId, RANDOM_THREAD));
+    }
+    return *threadStream;
+}
@@ -0,0 +1,300 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Purpose of a random stream. Streams of the same agent with different purposes are independent, so that adding
+ * draws for one purpose does not shift the numbers drawn for another.
+ */
+enum RandomPurpose
+{
+    /** draws made while updating an agent, through RandomService::current() */
+    RANDOM_GENERIC = 0,
+
+    /** draws made by a thread outside of an agent update */
+    RANDOM_THREAD = 1,
+
+    /** draws made while a preday person is simulated; the stream id is derived from the person id */
+    RANDOM_PREDAY = 2,
+
+    /** draws of the characteristics of a person (age) when it is created; the stream id is the person id */
+    RANDOM_PERSON = 3,
+
+    /** draws of the boarding and alighting times of a short-term person; the stream id is the person id */
+    RANDOM_BOARDING = 4,
+
+    /** draws choosing the vehicles of a mobility service controller; the stream id is the controller id */
+    RANDOM_FLEET = 5,
+
+    /** draws of the trip and activity times of the demand loaded by a person loader; the stream id is 0 */
+    RANDOM_DEMAND = 6,
+
+    /** draws perturbing the link travel times of a random graph of the path sets; the stream id is the graph index */
+    RANDOM_PERTURBATION = 7,
+
+    /**
+     * seed of the generator of the C library (std::rand(), which also backs math.random in the Lua scripts);
+     * the stream id is the number of the simulation run
+     */
+    RANDOM_LIBRARY_SEED = 8
+};
+
+/**
+ * Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3",
+ * SC'11). A block of four 32 bit random words is a pure function of a 128 bit counter and a 64 bit key: there is no
+ * state to seed, and any block of any stream can be computed directly.
+ */
+class Philox4x32
+{
+public:
+    /**
+     * computes the random block of a counter
+     * @param counter the counter
+     * @param key the key
+     * @param block output block
+     */
+    static void generate(const boost::uint32_t counter[4], const boost::uint32_t key[2], boost::uint32_t block[4]);
+
+    /**
+     * computes the random blocks of consecutive counters, several counters at a time
+     * @param counter counter of the first block; counter[0] and counter[1] hold the 64 bit block index, which is
+     *      incremented for each following block
+     * @param key the key
+     * @param numBlocks number of blocks
+     * @param blocks output blocks (4 * numBlocks words)
+     */
+    static void generate(const boost::uint32_t counter[4], const boost::uint32_t key[2], std::size_t numBlocks,
+                         boost::uint32_t* blocks);
+};
+
+/**
+ * A stream of random numbers drawn from the Philox blocks of the counters (block index, stream id, purpose), under
+ * the global seed. A stream depends on nothing but these values: the same agent draws the same numbers whatever the
+ * thread updating it and the number of threads of the simulation.
+ *
+ * A stream is a uniform random bit generator, which can be used with the distributions of boost and of the standard
+ * library. The bulk methods produce the same numbers as the corresponding sequence of single draws.
+ */
+class RandomStream
+{
+public:
+    typedef boost::uint32_t result_type;
+
+    /**
+     * creates a stream under the global seed (see RandomService::setSeed)
+     * @param streamId id of the stream, usually the id of the agent owning it
+     * @param purpose purpose of the stream
+     */
+    explicit RandomStream(boost::uint32_t streamId, boost::uint32_t purpose = RANDOM_GENERIC);
+
+    /**
+     * creates a stream under the given seed
+     * @param seed the seed
+     * @param streamId id of the stream
+     * @param purpose purpose of the stream
+     */
+    RandomStream(boost::uint64_t seed, boost::uint32_t streamId, boost::uint32_t purpose);
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return 0xFFFFFFFF;
+    }
+
+    /**
+     * @return the next random word
+     */
+    result_type operator()()
+    {
+        if (nextWord == 4)
+        {
+            refill();
+        }
+        return buffer[nextWord++];
+    }
+
+    /**
+     * @return a value drawn uniformly from [0, 1), with 53 random bits
+     */
+    double uniform()
+    {
+        boost::uint64_t high = (*this)() >> 5;
+        boost::uint64_t low = (*this)() >> 6;
+        return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @param min lower limit
+     * @param max upper limit
+     * @return a value drawn uniformly from [min, max)
+     */
+    double uniform(double min, double max)
+    {
+        return min + (max - min) * uniform();
+    }
+
+    /**
+     * @param min lower limit
+     * @param max upper limit, included
+     * @return an integer drawn uniformly from [min, max]
+     */
+    int uniformInt(int min, int max);
+
+    /**
+     * @param mean mean of the distribution
+     * @param stddev standard deviation of the distribution
+     * @return a value drawn from the normal distribution
+     */
+    double normal(double mean, double stddev)
+    {
+        return mean + stddev * standardNormal();
+    }
+
+    /**
+     * @param location mean of the logarithm of the values
+     * @param scale standard deviation of the logarithm of the values
+     * @return a value drawn from the lognormal distribution
+     */
+    double lognormal(double location, double scale);
+
+    /**
+     * @param probability probability of true
+     * @return true with the given probability
+     */
+    bool bernoulli(double probability)
+    {
+        return uniform() < probability;
+    }
+
+    /**
+     * draws values uniformly from [min, max)
+     * @param values output values
+     * @param count number of values
+     * @param min lower limit
+     * @param max upper limit
+     */
+    void fillUniform(double* values, std::size_t count, double min = 0.0, double max = 1.0);
+
+    /**
+     * draws values from the normal distribution
+     * @param values output values
+     * @param count number of values
+     * @param mean mean of the distribution
+     * @param stddev standard deviation of the distribution
+     */
+    void fillNormal(double* values, std::size_t count, double mean, double stddev);
+
+    /**
+     * draws values from the lognormal distribution
+     * @param values output values
+     * @param count number of values
+     * @param location mean of the logarithm of the values
+     * @param scale standard deviation of the logarithm of the values
+     */
+    void fillLognormal(double* values, std::size_t count, double location, double scale);
+
+    /**
+     * @return the number of random words drawn from the stream
+     */
+    boost::uint64_t getPosition() const
+    {
+        return (blockIndex * 4) - (4 - nextWord);
+    }
+
+private:
+    /** computes the next block into the buffer */
+    void refill();
+
+    /** @return a value drawn from the standard normal distribution */
+    double standardNormal();
+
+    /** transforms pairs of uniform values from [0, 1) into pairs of standard normal values (Box-Muller) */
+    static void toStandardNormal(double* values, std::size_t count);
+
+    /** computes the Philox counter of the next block */
+    void getCounter(boost::uint32_t counter[4]) const;
+
+    /** Philox key: the seed */
+    boost::uint32_t key[2];
+
+    boost::uint32_t streamId;
+    boost::uint32_t purpose;
+
+    /** index of the next block to compute */
+    boost::uint64_t blockIndex;
+
+    /** the current block */
+    boost::uint32_t buffer[4];
+
+    /** index of the next word of the current block to draw */
+    unsigned int nextWord;
+
+    /** second value of the last Box-Muller pair, not drawn yet */
+    double spareNormal;
+    bool hasSpareNormal;
+};
+
+/**
+ * Access to the random streams of the simulation.
+ *
+ * While an agent is updated or handles a message, current() returns the stream of the agent; the agent update and the
+ * MessageBus set it with a Scope. Out of these, current() returns the stream of the calling thread, whose id is set
+ * with setThreadStreamId(), and is 0 for the threads which do not set it (such as the main thread). Threads drawing
+ * out of the agent updates should therefore set an id which does not depend on the order in which they start.
+ */
+class RandomService
+{
+public:
+    /** makes a stream the current stream of the calling thread for the lifetime of the scope */
+    class Scope : private boost::noncopyable
+    {
+    public:
+        explicit Scope(RandomStream& stream);
+
+        /** @param stream the stream; if null, the current stream is left unchanged */
+        explicit Scope(RandomStream* stream);
+
+        ~Scope();
+
+    private:
+        RandomStream* previous;
+    };
+
+    /**
+     * sets the global seed. Streams created before keep their seed.
+     * @param seed the seed
+     */
+    static void setSeed(boost::uint64_t seed);
+
+    /**
+     * @return the global seed
+     */
+    static boost::uint64_t getSeed();
+
+    /**
+     * sets the id of the stream of the calling thread, used out of the agent updates. The numbers drawn from the
+     * previous stream of the thread, if any, are not continued.
+     * @param streamId id of the stream
+     */
+    static void setThreadStreamId(boost::uint32_t streamId);
+
+    /**
+     * @return the current stream of the calling thread
+     */
+    static RandomStream& current();
+};
+
+}
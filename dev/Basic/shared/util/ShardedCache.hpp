@@ -0,0 +1,528 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Key of a ShardedCache: an origin-destination pair, a time interval and the kind of the cached value. Each field
+ * holds a full 32 bit id.
+ */
+struct CacheKey
+{
+    CacheKey() : origin(0), destination(0), interval(0), kind(0)
+    {}
+
+    CacheKey(boost::uint32_t origin, boost::uint32_t destination, boost::uint32_t interval, boost::uint32_t kind) :
+        origin(origin), destination(destination), interval(interval), kind(kind)
+    {}
+
+    bool operator==(const CacheKey &other) const
+    {
+        return origin == other.origin && destination == other.destination && interval == other.interval
+                && kind == other.kind;
+    }
+
+    bool operator!=(const CacheKey &other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const CacheKey &other) const
+    {
+        if (origin != other.origin)
+        {
+            return origin < other.origin;
+        }
+        if (destination != other.destination)
+        {
+            return destination < other.destination;
+        }
+        if (interval != other.interval)
+        {
+            return interval < other.interval;
+        }
+        return kind < other.kind;
+    }
+
+    boost::uint32_t origin;
+    boost::uint32_t destination;
+    boost::uint32_t interval;
+    boost::uint32_t kind;
+};
+
+/**
+ * @return a hash of the key, mixing all its bits so that keys differing only in one field spread over the shards
+ */
+inline std::size_t hash_value(const CacheKey &key)
+{
+    boost::uint64_t high = (boost::uint64_t(key.origin) << 32) | key.destination;
+    boost::uint64_t low = (boost::uint64_t(key.interval) << 32) | key.kind;
+    boost::uint64_t res = high ^ (low * 0x9e3779b97f4a7c15ULL);
+    res ^= res >> 33;
+    res *= 0xff51afd7ed558ccdULL;
+    res ^= res >> 33;
+    res *= 0xc4ceb9fe1a85ec53ULL;
+    res ^= res >> 33;
+    return static_cast<std::size_t>(res);
+}
+
+/**
+ * Index of the calling thread among the live threads, by which ShardedCache keeps the access counters of each thread
+ * apart. The index of a thread which exits is given to the next thread asking for one, so the indices stay below the
+ * number of threads alive at once.
+ */
+class CacheThreadSlot : private boost::noncopyable
+{
+public:
+    /** @return the index of the calling thread */
+    static std::size_t get()
+    {
+        static thread_local CacheThreadSlot slot;
+        return slot.index;
+    }
+
+private:
+    CacheThreadSlot()
+    {
+        Registry &registry = getRegistry();
+        boost::unique_lock<boost::mutex> lock(registry.mutex);
+        if (registry.freeIndices.empty())
+        {
+            index = registry.numIndices++;
+        }
+        else
+        {
+            index = registry.freeIndices.back();
+            registry.freeIndices.pop_back();
+        }
+    }
+
+    ~CacheThreadSlot()
+    {
+        Registry &registry = getRegistry();
+        boost::unique_lock<boost::mutex> lock(registry.mutex);
+        registry.freeIndices.push_back(index);
+    }
+
+    /** the indices given so far */
+    struct Registry
+    {
+        Registry() : numIndices(0)
+        {}
+
+        boost::mutex mutex;
+        std::size_t numIndices;
+        std::vector<std::size_t> freeIndices;
+    };
+
+    static Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    std::size_t index;
+};
+
+/**
+ * Concurrent cache of shared objects (e.g. pathsets), keyed by a CacheKey.
+ *
+ * The keys are spread over independent shards, each holding an equal part of the capacity. A shard is a hash table
+ * whose buckets are immutable chains of entries, published with atomic stores of their head. find() takes no lock:
+ * it atomically loads the head of the bucket of its key and walks the chain, which the loaded head keeps alive
+ * however the bucket changes meanwhile. insert() updates the shard under the mutex of the shard, rebuilding only the
+ * part of the chain of a bucket ahead of the entry it replaces or removes, so the writers neither block the readers
+ * nor copy the whole shard.
+ *
+ * A full shard evicts by CLOCK (second chance): entries sit in a ring, find() marks the entry it returns with an
+ * atomic flag, and the hand of the ring skips (and unmarks) the marked entries, evicting the first unmarked one.
+ *
+ * The access statistics are counted by each thread separately, in a fixed array of counters indexed by
+ * CacheThreadSlot, and summed by getStatistics(). The threads beyond MAX_COUNTING_THREADS share one set of counters.
+ */
+template <typename VAL>
+class ShardedCache : private boost::noncopyable
+{
+public:
+    typedef CacheKey KeyType;
+    typedef boost::shared_ptr<VAL> ValueType;
+
+    /** access statistics */
+    struct Statistics
+    {
+        Statistics() : hits(0), misses(0), insertions(0), evictions(0), lockWaits(0)
+        {}
+
+        /** number of find() which found their key */
+        std::size_t hits;
+        /** number of find() which did not */
+        std::size_t misses;
+        /** number of insert() */
+        std::size_t insertions;
+        /** number of entries evicted to make room for an insertion */
+        std::size_t evictions;
+        /** number of insert() which found the shard locked by another thread */
+        std::size_t lockWaits;
+    };
+
+    /** default number of shards */
+    static const std::size_t DEFAULT_NUM_SHARDS = 64;
+
+    /** number of threads whose accesses are counted separately */
+    static const std::size_t MAX_COUNTING_THREADS = 256;
+
+    /**
+     * @param capacity maximum number of entries, spread evenly over the shards
+     * @param numShards number of shards
+     */
+    explicit ShardedCache(std::size_t capacity, std::size_t numShards = DEFAULT_NUM_SHARDS) :
+        numShards(numShards > 0 ? numShards : 1), shards(new Shard[numShards > 0 ? numShards : 1]),
+        counters(new boost::atomic<Counters*>[MAX_COUNTING_THREADS + 1])
+    {
+        std::size_t shardCapacity = (capacity + this->numShards - 1) / this->numShards;
+        for (std::size_t i = 0; i < this->numShards; i++)
+        {
+            shards[i].init(shardCapacity > 0 ? shardCapacity : 1);
+        }
+        for (std::size_t i = 0; i <= MAX_COUNTING_THREADS; i++)
+        {
+            counters[i].store(nullptr, boost::memory_order_relaxed);
+        }
+    }
+
+    ~ShardedCache()
+    {
+        for (std::size_t i = 0; i <= MAX_COUNTING_THREADS; i++)
+        {
+            delete counters[i].load(boost::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * makes the key of an origin-destination pair
+     * @param origin id of the origin node
+     * @param destination id of the destination node
+     * @param interval index of the time interval; 0 for values which do not depend on time
+     * @param kind kind of the value, for caches holding several kinds of values for the same pairs
+     * @return the key
+     */
+    static KeyType makeKey(unsigned int origin, unsigned int destination, unsigned int interval = 0, unsigned int kind = 0)
+    {
+        return KeyType(origin, destination, interval, kind);
+    }
+
+    /**
+     * looks a key up, without locking
+     * @param key the key
+     * @param value output value of the key, if found
+     * @return true if the key was found
+     */
+    bool find(const KeyType &key, ValueType &value) const
+    {
+        Counters &threadCounters = getCounters();
+        std::size_t hash = hash_value(key);
+        const Shard &shard = getShard(hash);
+        boost::shared_ptr<const Node> head = boost::atomic_load(&shard.buckets[shard.getBucket(hash, numShards)]);
+
+        //the chain is immutable, and kept alive by its head
+        for (const Node *node = head.get(); node; node = node->next.get())
+        {
+            const Entry &entry = *node->entry;
+            if (entry.key == key)
+            {
+                //only written when it changes, so that the hits of an entry do not keep writing its cache line
+                if (!entry.referenced.load(boost::memory_order_relaxed))
+                {
+                    entry.referenced.store(true, boost::memory_order_relaxed);
+                }
+                value = entry.value;
+                threadCounters.increment(threadCounters.hits);
+                return true;
+            }
+        }
+        threadCounters.increment(threadCounters.misses);
+        return false;
+    }
+
+    /**
+     * records the value of a key, replacing the previous one if any. Evicts an entry of the shard of the key if
+     * it is full.
+     * @param key the key
+     * @param value the value
+     */
+    void insert(const KeyType &key, const ValueType &value)
+    {
+        Counters &threadCounters = getCounters();
+        std::size_t hash = hash_value(key);
+        Shard &shard = getShard(hash);
+        //the evicted or replaced entry is released out of the lock
+        boost::shared_ptr<Entry> released;
+        boost::unique_lock<boost::mutex> lock(shard.mutex, boost::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            threadCounters.increment(threadCounters.lockWaits);
+            lock.lock();
+        }
+
+        boost::shared_ptr<const Node> &bucket = shard.buckets[shard.getBucket(hash, numShards)];
+        boost::shared_ptr<Entry> entry(new Entry(key, value));
+        const Node *existing = findNode(bucket, key);
+        if (existing)
+        {
+            entry->position = existing->entry->position;
+            released = shard.ring[entry->position];
+            shard.ring[entry->position] = entry;
+            publish(bucket, boost::shared_ptr<const Node>(new Node(entry, without(bucket, key))));
+        }
+        else if (shard.ring.size() < shard.capacity)
+        {
+            entry->position = shard.ring.size();
+            shard.ring.push_back(entry);
+            publish(bucket, boost::shared_ptr<const Node>(new Node(entry, bucket)));
+        }
+        else
+        {
+            //every marked entry is unmarked as the hand passes, so this stops within one turn of the ring
+            while (shard.ring[shard.hand]->referenced.load(boost::memory_order_relaxed))
+            {
+                shard.ring[shard.hand]->referenced.store(false, boost::memory_order_relaxed);
+                shard.hand = (shard.hand + 1) % shard.ring.size();
+            }
+            released = shard.ring[shard.hand];
+            boost::shared_ptr<const Node> &victimBucket =
+                    shard.buckets[shard.getBucket(hash_value(released->key), numShards)];
+            publish(victimBucket, without(victimBucket, released->key));
+
+            entry->position = shard.hand;
+            shard.ring[shard.hand] = entry;
+            publish(bucket, boost::shared_ptr<const Node>(new Node(entry, bucket)));
+            shard.hand = (shard.hand + 1) % shard.ring.size();
+            threadCounters.increment(threadCounters.evictions);
+        }
+        lock.unlock();
+        threadCounters.increment(threadCounters.insertions);
+    }
+
+    /**
+     * @return the number of entries
+     */
+    std::size_t size() const
+    {
+        std::size_t res = 0;
+        for (std::size_t i = 0; i < numShards; i++)
+        {
+            boost::unique_lock<boost::mutex> lock(shards[i].mutex);
+            res += shards[i].ring.size();
+        }
+        return res;
+    }
+
+    std::size_t getNumShards() const
+    {
+        return numShards;
+    }
+
+    /**
+     * @return the statistics summed over all threads; the counts of the threads still running may lag slightly
+     */
+    Statistics getStatistics() const
+    {
+        Statistics res;
+        for (std::size_t i = 0; i <= MAX_COUNTING_THREADS; i++)
+        {
+            const Counters *slot = counters[i].load(boost::memory_order_acquire);
+            if (slot)
+            {
+                res.hits += slot->hits.load(boost::memory_order_relaxed);
+                res.misses += slot->misses.load(boost::memory_order_relaxed);
+                res.insertions += slot->insertions.load(boost::memory_order_relaxed);
+                res.evictions += slot->evictions.load(boost::memory_order_relaxed);
+                res.lockWaits += slot->lockWaits.load(boost::memory_order_relaxed);
+            }
+        }
+        return res;
+    }
+
+private:
+    /** a cached value. Only its flag changes once it is published. */
+    struct Entry
+    {
+        Entry(const KeyType &key, const ValueType &value) : key(key), value(value), referenced(false), position(0)
+        {}
+
+        const KeyType key;
+        const ValueType value;
+
+        /** set by find(), cleared by the hand of the ring */
+        mutable boost::atomic<bool> referenced;
+
+        /** position of the entry in the ring of its shard */
+        std::size_t position;
+    };
+
+    /** a link of the chain of a bucket */
+    struct Node
+    {
+        Node(const boost::shared_ptr<Entry> &entry, const boost::shared_ptr<const Node> &next) : entry(entry), next(next)
+        {}
+
+        const boost::shared_ptr<Entry> entry;
+        const boost::shared_ptr<const Node> next;
+    };
+
+    struct Shard
+    {
+        Shard() : numBuckets(1), hand(0), capacity(1)
+        {}
+
+        void init(std::size_t capacity)
+        {
+            this->capacity = capacity;
+            numBuckets = capacity;
+            buckets.reset(new boost::shared_ptr<const Node>[numBuckets]);
+            ring.reserve(capacity);
+        }
+
+        /** @return the bucket of a hash; the shard was chosen from the low part of the hash, this uses the rest */
+        std::size_t getBucket(std::size_t hash, std::size_t numShards) const
+        {
+            return (hash / numShards) % numBuckets;
+        }
+
+        /** guards the updates of the members below; the buckets are also read without it, by find() */
+        boost::mutex mutex;
+
+        /** heads of the chains of the buckets */
+        boost::scoped_array< boost::shared_ptr<const Node> > buckets;
+        std::size_t numBuckets;
+
+        /** the entries in the order of the CLOCK hand */
+        std::vector< boost::shared_ptr<Entry> > ring;
+        std::size_t hand;
+
+        /** maximum number of entries */
+        std::size_t capacity;
+    };
+
+    /** @return the node of a key in a chain, or null; called under the mutex of the shard */
+    static const Node* findNode(const boost::shared_ptr<const Node> &head, const KeyType &key)
+    {
+        for (const Node *node = head.get(); node; node = node->next.get())
+        {
+            if (node->entry->key == key)
+            {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @return a chain without the node of a key, sharing the nodes after it with the given chain; the key must be
+     *      in the chain
+     */
+    static boost::shared_ptr<const Node> without(const boost::shared_ptr<const Node> &head, const KeyType &key)
+    {
+        if (head->entry->key == key)
+        {
+            return head->next;
+        }
+        return boost::shared_ptr<const Node>(new Node(head->entry, without(head->next, key)));
+    }
+
+    /** makes a chain visible to find(); called under the mutex of the shard */
+    static void publish(boost::shared_ptr<const Node> &bucket, const boost::shared_ptr<const Node> &head)
+    {
+        boost::atomic_store(&bucket, head);
+    }
+
+    /**
+     * access counts of a thread. Only written by their thread, so incrementing them does not contend with the
+     * other threads; they are atomic so that getStatistics() can read them at any time. The counters shared by the
+     * threads beyond MAX_COUNTING_THREADS are incremented atomically instead.
+     */
+    struct Counters
+    {
+        explicit Counters(bool shared) : hits(0), misses(0), insertions(0), evictions(0), lockWaits(0), shared(shared)
+        {}
+
+        /** increments one of the counters */
+        void increment(boost::atomic<std::size_t> &counter)
+        {
+            if (shared)
+            {
+                counter.fetch_add(1, boost::memory_order_relaxed);
+            }
+            else
+            {
+                counter.store(counter.load(boost::memory_order_relaxed) + 1, boost::memory_order_relaxed);
+            }
+        }
+
+        boost::atomic<std::size_t> hits;
+        boost::atomic<std::size_t> misses;
+        boost::atomic<std::size_t> insertions;
+        boost::atomic<std::size_t> evictions;
+        boost::atomic<std::size_t> lockWaits;
+
+        /** whether several live threads write the counters */
+        const bool shared;
+    };
+
+    /** @return the counters of the calling thread, creating them on its first access */
+    Counters& getCounters() const
+    {
+        std::size_t slot = CacheThreadSlot::get();
+        if (slot > MAX_COUNTING_THREADS)
+        {
+            slot = MAX_COUNTING_THREADS;
+        }
+
+        Counters *res = counters[slot].load(boost::memory_order_acquire);
+        if (!res)
+        {
+            //only the last slot can be created by two threads at once
+            Counters *created = new Counters(slot == MAX_COUNTING_THREADS);
+            if (counters[slot].compare_exchange_strong(res, created, boost::memory_order_acq_rel))
+            {
+                res = created;
+            }
+            else
+            {
+                delete created;
+            }
+        }
+        return *res;
+    }
+
+    Shard& getShard(std::size_t hash) const
+    {
+        return shards[hash % numShards];
+    }
+
+    const std::size_t numShards;
+    boost::scoped_array<Shard> shards;
+
+    /**
+     * counters of the threads which have accessed the cache, by CacheThreadSlot; the last one is shared by the
+     * threads beyond MAX_COUNTING_THREADS. A thread reusing the slot of a thread which exited adds to its counts.
+     */
+    boost::scoped_array< boost::atomic<Counters*> > counters;
+};
+
+}
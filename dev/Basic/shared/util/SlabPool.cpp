@@ -0,0 +1,211 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "SlabPool.hpp"
+
+#include <new>
+#include <vector>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+using namespace sim_mob;
+
+namespace
+{
+/** all pools ever created; pools are never destroyed */
+std::vector<SlabPool*> allPools;
+
+/** pools of exited threads, waiting to be adopted */
+std::vector<SlabPool*> idlePools;
+
+boost::mutex poolsMutex;
+}
+
+SlabPool::SlabPool() :
+        slabCursor(nullptr), slabEnd(nullptr), slabs(0), allocations(0), localFrees(0), largeAllocations(0),
+        reclaims(0), remoteFrees(0)
+{
+    for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++)
+    {
+        freeLists[i] = nullptr;
+        remoteFreeLists[i].store(nullptr, boost::memory_order_relaxed);
+    }
+}
+
+SlabPool* SlabPool::getLocalPool()
+{
+    // pool of the current thread; released to idlePools when the thread exits
+    static boost::thread_specific_ptr<SlabPool> localPool(&SlabPool::releasePool);
+
+    SlabPool* pool = localPool.get();
+    if (!pool)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(poolsMutex);
+            if (!idlePools.empty())
+            {
+                pool = idlePools.back();
+                idlePools.pop_back();
+            }
+            else
+            {
+                pool = new SlabPool();
+                allPools.push_back(pool);
+            }
+        }
+        localPool.reset(pool);
+    }
+    return pool;
+}
+
+void SlabPool::releasePool(SlabPool* pool)
+{
+    boost::lock_guard<boost::mutex> lock(poolsMutex);
+    idlePools.push_back(pool);
+}
+
+void* SlabPool::allocate(std::size_t size)
+{
+    std::size_t blockSize = size + sizeof(BlockHeader);
+    if (size > MAX_BLOCK_SIZE)
+    {
+        BlockHeader* header = static_cast<BlockHeader*>(::operator new(blockSize));
+        header->origin = nullptr;
+        header->sizeClass = NUM_SIZE_CLASSES;
+        getLocalPool()->largeAllocations++;
+        return header + 1;
+    }
+
+    std::size_t sizeClass = (blockSize - 1) / SIZE_CLASS_STEP;
+    return getLocalPool()->allocateBlock(sizeClass);
+}
+
+void SlabPool::deallocate(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (!header->origin)
+    {
+        ::operator delete(header);
+        return;
+    }
+
+    SlabPool* pool = getLocalPool();
+    if (header->origin == pool)
+    {
+        pool->freeLocal(header);
+    }
+    else
+    {
+        pool->remoteFrees++;
+        header->origin->freeRemote(header);
+    }
+}
+
+void* SlabPool::allocateBlock(std::size_t sizeClass)
+{
+    FreeBlock* block = freeLists[sizeClass];
+    if (!block && reclaimRemote(sizeClass))
+    {
+        block = freeLists[sizeClass];
+    }
+
+    allocations++;
+    if (!block)
+    {
+        return carveBlock(sizeClass);
+    }
+
+    // the header of a free block is left untouched; the link lives in the first bytes of the block itself
+    freeLists[sizeClass] = block->next;
+    return block;
+}
+
+void SlabPool::freeLocal(BlockHeader* header)
+{
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(header + 1);
+    block->next = freeLists[header->sizeClass];
+    freeLists[header->sizeClass] = block;
+    localFrees++;
+}
+
+void SlabPool::freeRemote(BlockHeader* header)
+{
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(header + 1);
+    boost::atomic<FreeBlock*>& list = remoteFreeLists[header->sizeClass];
+    FreeBlock* head = list.load(boost::memory_order_relaxed);
+    do
+    {
+        block->next = head;
+    }
+    while (!list.compare_exchange_weak(head, block, boost::memory_order_release, boost::memory_order_relaxed));
+}
+
+bool SlabPool::reclaimRemote(std::size_t sizeClass)
+{
+    // the whole list is taken at once, so that blocks are never popped one by one concurrently with pushes (ABA)
+    if (!remoteFreeLists[sizeClass].load(boost::memory_order_relaxed))
+    {
+        return false;
+    }
+    FreeBlock* blocks = remoteFreeLists[sizeClass].exchange(nullptr, boost::memory_order_acquire);
+    if (!blocks)
+    {
+        return false;
+    }
+    freeLists[sizeClass] = blocks;
+    reclaims++;
+    return true;
+}
+
+void* SlabPool::carveBlock(std::size_t sizeClass)
+{
+    std::size_t blockSize = (sizeClass + 1) * SIZE_CLASS_STEP;
+    if (!slabCursor || slabCursor + blockSize > slabEnd)
+    {
+        // the rest of the current slab, if any, is abandoned
+        slabCursor = static_cast<char*>(::operator new(SLAB_SIZE));
+        slabEnd = slabCursor + SLAB_SIZE;
+        slabs++;
+    }
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(slabCursor);
+    slabCursor += blockSize;
+    header->origin = this;
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+SlabPool::Stats SlabPool::getStats()
+{
+    Stats stats;
+    boost::lock_guard<boost::mutex> lock(poolsMutex);
+    stats.pools = allPools.size();
+    for (std::vector<SlabPool*>::const_iterator it = allPools.begin(); it != allPools.end(); ++it)
+    {
+        const SlabPool& pool = **it;
+        stats.slabs += pool.slabs;
+        stats.allocations += pool.allocations;
+        stats.localFrees += pool.localFrees;
+        stats.remoteFrees += pool.remoteFrees;
+        stats.largeAllocations += pool.largeAllocations;
+        stats.reclaims += pool.reclaims;
+    }
+    stats.bytesReserved = stats.slabs * SLAB_SIZE;
+    return stats;
+}
+
+void SlabPool::printStats(std::ostream& os)
+{
+    Stats stats = getStats();
+    os << "Message pool: " << stats.allocations << " blocks allocated by " << stats.pools << " threads from "
+       << stats.slabs << " slabs (" << stats.bytesReserved / 1024 << " KB); "
+       << stats.localFrees << " freed by the allocating thread, " << stats.remoteFrees << " by another thread ("
+       << stats.reclaims << " reclaims); " << stats.largeAllocations << " large allocations\n";
+}
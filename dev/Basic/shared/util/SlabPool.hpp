@@ -0,0 +1,199 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <boost/atomic.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Thread caching allocator for small, short lived objects which are often freed by another thread than the one
+ * which allocated them (messages, event arguments).
+ *
+ * Every thread allocates from its own pool, without locking. A pool carves blocks of a few size classes out of
+ * large slabs and keeps one free list per size class. A block freed by the thread owning its pool goes back to the
+ * free list; a block freed by any other thread is pushed onto a lock free list of its origin pool, which the owner
+ * takes over as a whole once its own free list runs empty. Memory thus returns to the pool it came from, whichever
+ * thread frees it, and the allocating threads never contend on a global heap lock.
+ *
+ * Requests larger than the largest size class are forwarded to operator new.
+ *
+ * Pools are never destroyed: the pool of a thread which exits is handed to the next thread which needs one, along
+ * with the blocks still held by it. Slabs are only returned to the system at the end of the process.
+ */
+class SlabPool
+{
+public:
+    /** allocation statistics, summed over all pools */
+    struct Stats
+    {
+        Stats() : pools(0), slabs(0), bytesReserved(0), allocations(0), localFrees(0), remoteFrees(0),
+                largeAllocations(0), reclaims(0)
+        {}
+
+        /** number of pools, i.e. of threads which allocated or freed a block */
+        std::size_t pools;
+        /** number of slabs allocated */
+        std::size_t slabs;
+        /** bytes held in slabs */
+        std::size_t bytesReserved;
+        /** number of blocks allocated from slabs */
+        std::size_t allocations;
+        /** number of blocks freed by the thread owning their pool */
+        std::size_t localFrees;
+        /** number of blocks freed by another thread */
+        std::size_t remoteFrees;
+        /** number of requests forwarded to operator new */
+        std::size_t largeAllocations;
+        /** number of times a pool took over the blocks freed by other threads */
+        std::size_t reclaims;
+    };
+
+    /** size of a slab in bytes */
+    static const std::size_t SLAB_SIZE = 64 * 1024;
+
+    /** largest request served from slabs, in bytes */
+    static const std::size_t MAX_BLOCK_SIZE = 512;
+
+    /**
+     * allocates memory from the pool of the calling thread
+     * @param size number of bytes; blocks are aligned as by operator new
+     * @return allocated memory
+     */
+    static void* allocate(std::size_t size);
+
+    /**
+     * returns memory obtained from allocate() to its origin pool. May be called by any thread.
+     * @param ptr memory to free; ignored if null
+     */
+    static void deallocate(void* ptr);
+
+    /**
+     * sums the statistics of all pools. The counts are updated without synchronisation, so they are only exact
+     * once the threads using the pools are idle (e.g. at the end of the simulation).
+     * @return statistics of all pools
+     */
+    static Stats getStats();
+
+    /**
+     * prints the statistics of all pools
+     * @param os output stream
+     */
+    static void printStats(std::ostream& os);
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    /** precedes every block; 16 bytes so that the block keeps the alignment of the slab */
+    struct BlockHeader
+    {
+        /** pool of the block; null for blocks forwarded to operator new */
+        SlabPool* origin;
+        std::size_t sizeClass;
+    };
+
+    /** size class c holds blocks of (c + 1) * SIZE_CLASS_STEP bytes, including the header */
+    static const std::size_t SIZE_CLASS_STEP = 32;
+    static const std::size_t NUM_SIZE_CLASSES = (MAX_BLOCK_SIZE + sizeof(BlockHeader) + SIZE_CLASS_STEP - 1)
+            / SIZE_CLASS_STEP;
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    SlabPool();
+
+    /** @return pool of the calling thread, adopting an orphaned pool or creating one if it has none yet */
+    static SlabPool* getLocalPool();
+
+    /** hands the pool of an exiting thread to the next thread needing one */
+    static void releasePool(SlabPool* pool);
+
+    /** allocates a block of a size class; owner thread only */
+    void* allocateBlock(std::size_t sizeClass);
+
+    /** returns a block to the free list of its size class; owner thread only */
+    void freeLocal(BlockHeader* header);
+
+    /** returns a block of this pool freed by another thread */
+    void freeRemote(BlockHeader* header);
+
+    /** takes over the blocks of a size class freed by other threads; owner thread only */
+    bool reclaimRemote(std::size_t sizeClass);
+
+    /** carves a block of a size class from the current slab, starting a new slab if needed; owner thread only */
+    void* carveBlock(std::size_t sizeClass);
+
+    // fields used by the owner thread only
+    FreeBlock* freeLists[NUM_SIZE_CLASSES];
+    char* slabCursor;
+    char* slabEnd;
+    std::size_t slabs;
+    std::size_t allocations;
+    std::size_t localFrees;
+    std::size_t largeAllocations;
+    std::size_t reclaims;
+    /** blocks of other pools freed by the owner */
+    std::size_t remoteFrees;
+
+    /** keeps the lists written by other threads off the cache line of the owner fields */
+    char padding[CACHE_LINE_SIZE];
+
+    /** blocks freed by other threads, per size class */
+    boost::atomic<FreeBlock*> remoteFreeLists[NUM_SIZE_CLASSES];
+};
+
+/**
+ * Standard allocator drawing from SlabPool, mainly for boost::allocate_shared, which then places the object and its
+ * reference count in a single pooled block.
+ */
+template<typename T>
+class SlabAllocator
+{
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef SlabAllocator<U> other;
+    };
+
+    SlabAllocator()
+    {
+    }
+
+    template<typename U>
+    SlabAllocator(const SlabAllocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(SlabPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        SlabPool::deallocate(p);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const SlabAllocator<T>&, const SlabAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const SlabAllocator<T>&, const SlabAllocator<U>&)
+{
+    return false;
+}
+
+}
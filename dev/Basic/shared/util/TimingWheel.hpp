@@ -0,0 +1,515 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Hierarchical timing wheel (Varghese and Lauck, "Hashed and hierarchical timing wheels", SOSP'87): a scheduler of
+ * items to be handed back once the time reaches the tick they are scheduled for.
+ *
+ * The items are kept in the slots of 4 wheels of 256 slots each. The first wheel holds the items of the next 256
+ * ticks, one slot per tick; each following wheel covers a range 256 times longer. When the time reaches the range of
+ * a slot of an outer wheel, its items cascade into the inner wheels. Items further away than 2^32 ticks wait in an
+ * overflow slot. The slots are vectors, so that cascading and handing back items walk through contiguous memory;
+ * once they have grown to the largest number of items pending at once, scheduling does not allocate memory.
+ *
+ * Scheduling and cancelling take constant time. A cancelled item stays in its slot, and is dropped when its slot is
+ * handed back.
+ *
+ * Items due at the same tick are handed back in no particular order.
+ *
+ * This class is not thread-safe; see ConcurrentTimingWheel.
+ */
+template <typename T>
+class TimingWheel : private boost::noncopyable
+{
+public:
+    typedef boost::uint64_t TimeType;
+
+    /** items with the tick they are scheduled for, to be scheduled together (see scheduleAll()) */
+    typedef std::vector< std::pair<TimeType, T> > Batch;
+
+    /** identifies a scheduled item, to cancel it */
+    struct Handle
+    {
+        Handle() : index(0xFFFFFFFF), generation(0)
+        {}
+
+        boost::uint32_t index;
+        boost::uint32_t generation;
+    };
+
+    /**
+     * @param time the current tick; items can be scheduled for the ticks after it
+     */
+    explicit TimingWheel(TimeType time = 0) : time(time), numItems(0), numEntries(0), freeHandles(NIL)
+    {
+        std::fill(wheelSizes, wheelSizes + NUM_WHEELS, 0);
+    }
+
+    /**
+     * schedules an item
+     * @param at tick at which the item is due; an item scheduled for the current tick or before is due at the next
+     *      advance()
+     * @param item the item
+     * @return the handle of the item
+     */
+    Handle schedule(TimeType at, const T& item)
+    {
+        Handle handle;
+        handle.index = allocateHandle();
+        handle.generation = handles[handle.index].generation;
+
+        Entry entry;
+        entry.at = at;
+        entry.handle = handle.index;
+        entry.item = item;
+        insert(entry);
+        numItems++;
+        return handle;
+    }
+
+    /**
+     * schedules the items of a batch, and empties the batch
+     * @param batch the items
+     */
+    void scheduleAll(Batch& batch)
+    {
+        for (typename Batch::iterator it = batch.begin(); it != batch.end(); ++it)
+        {
+            schedule(it->first, it->second);
+        }
+        batch.clear();
+    }
+
+    /**
+     * cancels a scheduled item
+     * @param handle handle of the item
+     * @return false if the item was already handed back or cancelled
+     */
+    bool cancel(Handle handle)
+    {
+        if (handle.index >= handles.size() || handles[handle.index].generation != handle.generation
+            || !handles[handle.index].live)
+        {
+            return false;
+        }
+        handles[handle.index].live = false;
+        numItems--;
+        return true;
+    }
+
+    /**
+     * advances the time, handing back the items which become due
+     * @param to the new current tick
+     * @param handler called with each item due at or before the new tick, in the order of their ticks. It may
+     *      schedule and cancel items; those it schedules for the tick being handed back or before are handed back
+     *      during the same call.
+     */
+    template <typename Handler>
+    void advance(TimeType to, Handler& handler)
+    {
+        drain(DUE_LIST, handler);
+        while (time < to)
+        {
+            if (numItems == 0)
+            {
+                //Only cancelled items, if any, are left
+                dropAll();
+                time = to;
+                break;
+            }
+
+            //While the inner wheels are empty, nothing is due before the next cascade of the first non-empty wheel
+            unsigned int numEmpty = 0;
+            while (numEmpty < NUM_WHEELS && wheelSizes[numEmpty] == 0)
+            {
+                numEmpty++;
+            }
+            const TimeType lastEmpty = (((time >> (SLOT_BITS * numEmpty)) + 1) << (SLOT_BITS * numEmpty)) - 1;
+            if (numEmpty > 0 && lastEmpty > time)
+            {
+                time = std::min(to, lastEmpty);
+                continue;
+            }
+
+            time++;
+            cascade();
+            drain(static_cast<unsigned int>(time & SLOT_MASK), handler);
+            drain(DUE_LIST, handler);
+        }
+    }
+
+    /** drops all the scheduled items */
+    void clear()
+    {
+        dropAll();
+        numItems = 0;
+    }
+
+    /**
+     * @return the current tick
+     */
+    TimeType getTime() const
+    {
+        return time;
+    }
+
+    /**
+     * @return the number of scheduled items
+     */
+    std::size_t size() const
+    {
+        return numItems;
+    }
+
+private:
+    static const unsigned int SLOT_BITS = 8;
+    static const unsigned int NUM_SLOTS = 1 << SLOT_BITS;
+    static const TimeType SLOT_MASK = NUM_SLOTS - 1;
+    static const unsigned int NUM_WHEELS = 4;
+
+    /** slot of the items further away than the outermost wheel */
+    static const unsigned int OVERFLOW_LIST = NUM_WHEELS * NUM_SLOTS;
+
+    /** slot of the items due at the next advance() */
+    static const unsigned int DUE_LIST = OVERFLOW_LIST + 1;
+
+    static const unsigned int NUM_LISTS = DUE_LIST + 1;
+
+    static const boost::uint32_t NIL = 0xFFFFFFFF;
+
+    /** a scheduled item */
+    struct Entry
+    {
+        TimeType at;
+        boost::uint32_t handle;
+        T item;
+    };
+
+    /** state of a handle */
+    struct HandleState
+    {
+        HandleState() : generation(0), live(false), nextFree(NIL)
+        {}
+
+        /** incremented whenever the handle is freed, which invalidates the previous handles */
+        boost::uint32_t generation;
+
+        /** false once the item is cancelled */
+        bool live;
+
+        boost::uint32_t nextFree;
+    };
+
+    boost::uint32_t allocateHandle()
+    {
+        boost::uint32_t index = freeHandles;
+        if (index == NIL)
+        {
+            index = static_cast<boost::uint32_t>(handles.size());
+            handles.push_back(HandleState());
+        }
+        else
+        {
+            freeHandles = handles[index].nextFree;
+        }
+        handles[index].live = true;
+        return index;
+    }
+
+    /** frees the handle of an item which has left the wheel */
+    void releaseHandle(boost::uint32_t index)
+    {
+        HandleState& state = handles[index];
+        state.generation++;
+        state.live = false;
+        state.nextFree = freeHandles;
+        freeHandles = index;
+    }
+
+    /** @return the slot of a tick */
+    unsigned int getList(TimeType at) const
+    {
+        if (at <= time)
+        {
+            return DUE_LIST;
+        }
+        const TimeType delta = at - time;
+        for (unsigned int wheel = 0; wheel < NUM_WHEELS; wheel++)
+        {
+            if (delta < (static_cast<TimeType>(1) << (SLOT_BITS * (wheel + 1))))
+            {
+                return wheel * NUM_SLOTS + static_cast<unsigned int>((at >> (SLOT_BITS * wheel)) & SLOT_MASK);
+            }
+        }
+        return OVERFLOW_LIST;
+    }
+
+    void insert(const Entry& entry)
+    {
+        append(getList(entry.at), entry);
+    }
+
+    void append(unsigned int list, const Entry& entry)
+    {
+        if (list < OVERFLOW_LIST)
+        {
+            wheelSizes[list >> SLOT_BITS]++;
+        }
+        lists[list].push_back(entry);
+        numEntries++;
+    }
+
+    /** empties a slot, returning its entries in the cascade buffer */
+    void detach(unsigned int list)
+    {
+        if (list < OVERFLOW_LIST)
+        {
+            wheelSizes[list >> SLOT_BITS] -= lists[list].size();
+        }
+        numEntries -= lists[list].size();
+        cascading.clear();
+        cascading.swap(lists[list]);
+    }
+
+    /** moves the items of the outer wheels whose range starts at the current tick to the inner wheels */
+    void cascade()
+    {
+        //The outermost wheels first, so that their items can cascade further
+        unsigned int numWheels = 1;
+        while (numWheels < NUM_WHEELS && ((time >> (SLOT_BITS * numWheels)) << (SLOT_BITS * numWheels)) == time)
+        {
+            numWheels++;
+        }
+        if (numWheels == NUM_WHEELS && ((time >> (SLOT_BITS * NUM_WHEELS)) << (SLOT_BITS * NUM_WHEELS)) == time)
+        {
+            reinsert(OVERFLOW_LIST);
+        }
+        for (unsigned int wheel = numWheels - 1; wheel > 0; wheel--)
+        {
+            reinsert(wheel * NUM_SLOTS + static_cast<unsigned int>((time >> (SLOT_BITS * wheel)) & SLOT_MASK));
+        }
+    }
+
+    void reinsert(unsigned int list)
+    {
+        detach(list);
+        for (typename std::vector<Entry>::iterator it = cascading.begin(); it != cascading.end(); ++it)
+        {
+            //Due now: the slot of the current tick is handed back right after the cascade
+            append((it->at == time) ? static_cast<unsigned int>(time & SLOT_MASK) : getList(it->at), *it);
+        }
+        cascading.clear();
+    }
+
+    /** hands back the items of a slot */
+    template <typename Handler>
+    void drain(unsigned int list, Handler& handler)
+    {
+        //The handler may add items to the slot of the due items, hence the size read at each step
+        std::vector<Entry>& entries = lists[list];
+        for (std::size_t i = 0; i < entries.size(); i++)
+        {
+            const boost::uint32_t handle = entries[i].handle;
+            if (handles[handle].live)
+            {
+                T item;
+                std::swap(item, entries[i].item);
+                releaseHandle(handle);
+                numItems--;
+                handler(item);
+            }
+            else
+            {
+                releaseHandle(handle);
+            }
+        }
+        if (list < OVERFLOW_LIST)
+        {
+            wheelSizes[list >> SLOT_BITS] -= entries.size();
+        }
+        numEntries -= entries.size();
+        entries.clear();
+    }
+
+    /** drops the entries of all the slots */
+    void dropAll()
+    {
+        if (numEntries == 0)
+        {
+            return;
+        }
+        for (unsigned int list = 0; list < NUM_LISTS; list++)
+        {
+            for (typename std::vector<Entry>::const_iterator it = lists[list].begin(); it != lists[list].end(); ++it)
+            {
+                releaseHandle(it->handle);
+            }
+            lists[list].clear();
+        }
+        std::fill(wheelSizes, wheelSizes + NUM_WHEELS, 0);
+        numEntries = 0;
+    }
+
+    TimeType time;
+
+    /** number of scheduled items, leaving out the cancelled ones */
+    std::size_t numItems;
+
+    /** number of entries in the slots, cancelled items included */
+    std::size_t numEntries;
+
+    std::vector<Entry> lists[NUM_LISTS];
+
+    /** number of entries in each wheel */
+    std::size_t wheelSizes[NUM_WHEELS];
+
+    std::vector<HandleState> handles;
+    boost::uint32_t freeHandles;
+
+    /** entries of the slot being cascaded */
+    std::vector<Entry> cascading;
+};
+
+/**
+ * Timing wheel which any thread can schedule items into, advanced by a single thread.
+ *
+ * Each scheduling thread appends its items to its own buffer, guarded by a mutex of its own, so that the threads
+ * do not contend with each other. advance() moves the buffered items into the wheel before handing back the due
+ * ones. Items buffered by a thread cannot be cancelled.
+ */
+template <typename T>
+class ConcurrentTimingWheel : private boost::noncopyable
+{
+public:
+    typedef typename TimingWheel<T>::TimeType TimeType;
+
+    explicit ConcurrentTimingWheel(TimeType time = 0) : wheel(time), id(nextId()++)
+    {}
+
+    ~ConcurrentTimingWheel()
+    {
+        for (typename std::vector<Buffer*>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+        {
+            delete *it;
+        }
+    }
+
+    /**
+     * schedules an item; may be called by any thread
+     * @param at tick at which the item is due (see TimingWheel::schedule())
+     * @param item the item
+     */
+    void schedule(TimeType at, const T& item)
+    {
+        Buffer* buffer = getLocalBuffer();
+        boost::lock_guard<boost::mutex> lock(buffer->mutex);
+        buffer->items.push_back(std::make_pair(at, item));
+    }
+
+    /**
+     * advances the time, handing back the items which become due (see TimingWheel::advance()); must always be called
+     * by the same thread, or by threads taking turns
+     */
+    template <typename Handler>
+    void advance(TimeType to, Handler& handler)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(buffersMutex);
+            for (typename std::vector<Buffer*>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+            {
+                //The buffered items are swapped out, so as to hold the lock of the thread for as short as possible
+                {
+                    boost::lock_guard<boost::mutex> bufferLock((*it)->mutex);
+                    (*it)->items.swap(pending);
+                }
+                wheel.scheduleAll(pending);
+            }
+        }
+        wheel.advance(to, handler);
+    }
+
+    /**
+     * @return the current tick; must be called by the thread advancing the wheel
+     */
+    TimeType getTime() const
+    {
+        return wheel.getTime();
+    }
+
+    /**
+     * @return the number of items in the wheel, leaving out those still buffered; must be called by the thread
+     *      advancing the wheel
+     */
+    std::size_t size() const
+    {
+        return wheel.size();
+    }
+
+private:
+    struct Buffer
+    {
+        boost::mutex mutex;
+        typename TimingWheel<T>::Batch items;
+    };
+
+    /** @return the counter of the ids of the wheels */
+    static boost::atomic<boost::uint64_t>& nextId()
+    {
+        static boost::atomic<boost::uint64_t> counter(0);
+        return counter;
+    }
+
+    /** @return the buffer of the calling thread, created on the first call */
+    Buffer* getLocalBuffer()
+    {
+        //Buffers of the wheels the thread has scheduled items into. The ids of the wheels are never reused, so the
+        //entries of the wheels destroyed since are never looked up again.
+        static thread_local std::vector< std::pair<boost::uint64_t, Buffer*> > localBuffers;
+        for (typename std::vector< std::pair<boost::uint64_t, Buffer*> >::const_iterator it = localBuffers.begin();
+             it != localBuffers.end(); ++it)
+        {
+            if (it->first == id)
+            {
+                return it->second;
+            }
+        }
+
+        Buffer* buffer = new Buffer();
+        {
+            boost::lock_guard<boost::mutex> lock(buffersMutex);
+            buffers.push_back(buffer);
+        }
+        localBuffers.push_back(std::make_pair(id, buffer));
+        return buffer;
+    }
+
+    TimingWheel<T> wheel;
+
+    /** unique id of the wheel, identifying its buffers among those of the thread */
+    const boost::uint64_t id;
+
+    /** buffer of each thread, owned by the wheel */
+    std::vector<Buffer*> buffers;
+    boost::mutex buffersMutex;
+
+    /** items moved out of a buffer; swapped with the buffers so that their capacities are reused */
+    typename TimingWheel<T>::Batch pending;
+};
+
+}
@@ -0,0 +1,183 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include "util/RandomService.hpp"
+
+namespace sim_mob
+{
+
+/**
+ * Merges the first C elements of several sequences, each of which is ordered by a key.
+ *
+ * At each of the first C steps, the head with the smallest key among the heads of the sequences is moved to the
+ * output; ties between heads of equal keys are broken by a uniform draw from a random stream, among the tied heads in
+ * the order in which their sequences were added. Heads whose key is NaN or greater than the largest double are never
+ * picked. The heads are kept in a binary heap ordered by key and sequence, so that a step takes logarithmic time.
+ *
+ * The buffers of the merger are kept across merges; once they have grown to the largest number of sequences merged,
+ * merging does not allocate memory.
+ */
+template <typename Iterator>
+class TopCMerge
+{
+public:
+    typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+
+    /** drops the sequences */
+    void clear()
+    {
+        cursors.clear();
+        heap.clear();
+    }
+
+    /**
+     * adds a sequence to merge; the sequence must stay valid until the end of the merge
+     * @param begin first element of the sequence
+     * @param end end of the sequence
+     */
+    void addSequence(Iterator begin, Iterator end)
+    {
+        Cursor cursor;
+        cursor.position = begin;
+        cursor.end = end;
+        cursors.push_back(cursor);
+    }
+
+    /**
+     * moves the first elements of the sequences to the output, in merged order
+     * @param count number of elements to merge
+     * @param key functor giving the key (a double) of an element
+     * @param random stream drawing the ties
+     * @param merged output, which the elements are appended to
+     * @return false if fewer than count elements could be picked
+     */
+    template <typename Key>
+    bool mergeTopC(std::size_t count, const Key& key, RandomStream& random, std::vector<ValueType>& merged)
+    {
+        heap.clear();
+        for (boost::uint32_t seq = 0; seq < cursors.size(); seq++)
+        {
+            pushHead(seq, key);
+        }
+        std::make_heap(heap.begin(), heap.end(), LaterHead());
+
+        for (std::size_t c = 0; c < count; c++)
+        {
+            if (heap.empty())
+            {
+                return false;
+            }
+
+            //The tied heads leave the heap in the order of their sequences
+            ties.clear();
+            const double minKey = heap.front().key;
+            do
+            {
+                std::pop_heap(heap.begin(), heap.end(), LaterHead());
+                ties.push_back(heap.back().seq);
+                heap.pop_back();
+            }
+            while (!heap.empty() && heap.front().key == minKey);
+
+            std::size_t chosen = 0;
+            if (ties.size() > 1)
+            {
+                chosen = random.uniformInt(0, ties.size() - 1);
+                for (std::size_t i = 0; i < ties.size(); i++)
+                {
+                    if (i != chosen)
+                    {
+                        Head head;
+                        head.key = minKey;
+                        head.seq = ties[i];
+                        heap.push_back(head);
+                        std::push_heap(heap.begin(), heap.end(), LaterHead());
+                    }
+                }
+            }
+
+            Cursor& cursor = cursors[ties[chosen]];
+            merged.push_back(*cursor.position);
+            ++cursor.position;
+            if (pushHead(ties[chosen], key))
+            {
+                std::push_heap(heap.begin(), heap.end(), LaterHead());
+            }
+        }
+        return true;
+    }
+
+    /**
+     * appends the elements not merged yet to the output, sequence after sequence
+     * @param merged output
+     */
+    void appendRest(std::vector<ValueType>& merged) const
+    {
+        for (typename std::vector<Cursor>::const_iterator it = cursors.begin(); it != cursors.end(); ++it)
+        {
+            merged.insert(merged.end(), it->position, it->end);
+        }
+    }
+
+private:
+    struct Cursor
+    {
+        Iterator position;
+        Iterator end;
+    };
+
+    struct Head
+    {
+        double key;
+        boost::uint32_t seq;
+    };
+
+    /** heap order: the smallest key first, then the first sequence */
+    struct LaterHead
+    {
+        bool operator()(const Head& x, const Head& y) const
+        {
+            return x.key > y.key || (x.key == y.key && x.seq > y.seq);
+        }
+    };
+
+    /**
+     * appends the head of a sequence to the heap storage, if it can be picked
+     * @return true if the head was appended
+     */
+    template <typename Key>
+    bool pushHead(boost::uint32_t seq, const Key& key)
+    {
+        const Cursor& cursor = cursors[seq];
+        if (cursor.position == cursor.end)
+        {
+            return false;
+        }
+        Head head;
+        head.key = key(*cursor.position);
+        head.seq = seq;
+        if (!(head.key <= std::numeric_limits<double>::max()))
+        {
+            return false;
+        }
+        heap.push_back(head);
+        return true;
+    }
+
+    std::vector<Cursor> cursors;
+    std::vector<Head> heap;
+
+    /** sequences of the heads tied at the current step */
+    std::vector<boost::uint32_t> ties;
+};
+
+}
@@ -15,76 +15,34 @@
 #include <fstream>
 #include <stdexcept>
 #include <proj_api.h>
-#include <boost/random.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/thread/thread.hpp>
-#include <boost/thread/tss.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/regex.hpp>
 #include "util/LangHelpers.hpp"
+#include "util/RandomService.hpp"
 #include "logging/Log.hpp"
 #include "conf/ConfigManager.hpp"
 
 using namespace sim_mob;
 
-// Thread local random numbers. 
-boost::thread_specific_ptr<boost::mt19937> floatProvider;
-boost::thread_specific_ptr<boost::mt19937> intProvider;
-
-inline void initRandomProvider(boost::thread_specific_ptr<boost::mt19937>& provider) {
-    // The first time called by the current thread then just create one.
-    if (!provider.get()) {
-
-        ConfigManager& cfg = ConfigManager::GetInstanceRW();
-        unsigned int seedValue = cfg.FullConfig().simulation.seedValue;
-        provider.reset(new boost::mt19937(seedValue));
-    }
-}
-
 float Utils::generateFloat(float min, float max) {
     if (min == max){
         return min;
     }
-//    initRandomProvider(floatProvider);
-    typedef boost::mt19937 RNGType;
-          RNGType rng(time(0));
-    boost::uniform_real<float> distribution(min, max);
-    boost::variate_generator<boost::mt19937&, boost::uniform_real<float> > 
-        dice(rng,distribution);
-//        gen(*(floatProvider.get()), distribution);
-    return dice();
+    return static_cast<float>(RandomService::current().uniform(min, max));
 }
 
 int Utils::generateInt(int min, int max) {
-    initRandomProvider(intProvider);
-    boost::uniform_int<int> distribution(min, max);
-    boost::variate_generator<boost::mt19937&, boost::uniform_int<int> > 
-        gen(*(intProvider.get()), distribution);
-    return gen();
+    return RandomService::current().uniformInt(min, max);
 }
 
 double Utils::uRandom() {
-//  initRandomProvider(floatProvider);
-//  boost::uniform_int<> dist(0, RAND_MAX);
-//  long int seed_ = dist(floatProvider.get());
-    long int seed_ = Utils::generateInt(0,RAND_MAX);
-
-    const long int M = 2147483647; // M = modulus (2^31)
-    const long int A = 48271; // A = multiplier (was 16807)
-    const long int Q = M / A;
-    const long int R = M % A;
-    seed_ = A * (seed_ % Q) - R * (seed_ / Q);
-    seed_ = (seed_ > 0) ? (seed_) : (seed_ + M);
-    return (double) seed_ / (double) M;
+    return RandomService::current().uniform();
 }
 
 double Utils::nRandom(double mean, double stddev) {
-    double r1 = uRandom(), r2 = uRandom();
-    double r = -2.0 * log(r1);
-    if (r > 0.0)
-        return (mean + stddev * sqrt(r) * sin(2 * 3.1415926 * r2));
-    else
-        return (mean);
+    return RandomService::current().normal(mean, stddev);
 }
 
 std::string sim_mob::Utils::getNumberFromAimsunId(std::string &aimsunid)
@@ -219,11 +177,11 @@ void Utils::convertStringToArray(std::string& str,std::vector<double>& array)
 }
 double Utils::urandom()
 {
-    return generateFloat(0,1);
+    return RandomService::current().uniform();
 }
 int Utils::brandom(double prob)
 {
-    if (urandom() < prob) return (1);
+    if (RandomService::current().bernoulli(prob)) return (1);
            else return 0;
 }
 StopWatch::StopWatch() : now(0), end(0), running(false) {
@@ -0,0 +1,78 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Variable length encoding of integers, 7 bits per byte, least significant bits first. The high bit of a byte is set
+ * when another byte follows.
+ */
+namespace varint
+{
+
+/**
+ * appends an unsigned integer
+ * @param value the integer
+ * @param bytes output buffer
+ */
+inline void writeUnsigned(boost::uint64_t value, std::vector<boost::uint8_t>& bytes)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<boost::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<boost::uint8_t>(value));
+}
+
+/**
+ * appends a signed integer, zigzag-encoded so that integers of small magnitude take few bytes whatever their sign
+ * @param value the integer
+ * @param bytes output buffer
+ */
+inline void writeSigned(boost::int64_t value, std::vector<boost::uint8_t>& bytes)
+{
+    writeUnsigned((static_cast<boost::uint64_t>(value) << 1) ^ static_cast<boost::uint64_t>(value >> 63), bytes);
+}
+
+/**
+ * reads an integer written by writeUnsigned, and advances past it
+ * @param next position of the integer; moved to the following byte
+ * @return the integer
+ */
+inline boost::uint64_t readUnsigned(const boost::uint8_t*& next)
+{
+    boost::uint64_t value = 0;
+    unsigned int shift = 0;
+    while (*next & 0x80)
+    {
+        value |= static_cast<boost::uint64_t>(*next & 0x7F) << shift;
+        shift += 7;
+        ++next;
+    }
+    value |= static_cast<boost::uint64_t>(*next) << shift;
+    ++next;
+    return value;
+}
+
+/**
+ * reads an integer written by writeSigned, and advances past it
+ * @param next position of the integer; moved to the following byte
+ * @return the integer
+ */
+inline boost::int64_t readSigned(const boost::uint8_t*& next)
+{
+    boost::uint64_t value = readUnsigned(next);
+    return static_cast<boost::int64_t>(value >> 1) ^ -static_cast<boost::int64_t>(value & 1);
+}
+
+}
+
+}
@@ -553,9 +553,28 @@ std::string ProcessValueString(xercesc::DOMElement* node)
     return ParseString(GetNamedAttributeValue(node, "value"));
 }
 
-}
-
-
+void ParseWorkerBarrier(xercesc::DOMElement* node, bool& spinBarrier, unsigned int& spinCount)
+{
+    spinBarrier = false;
+    if (!node)
+    {
+        return;
+    }
 
+    std::string strategy = ParseString(GetNamedAttributeValue(node, "strategy", false), "blocking");
+    if (strategy == "spin_then_block")
+    {
+        spinBarrier = true;
+    }
+    else if (strategy != "blocking")
+    {
+        std::stringstream msg;
+        msg << "Invalid value for <barrier strategy=\"" << strategy
+            << "\">. Expected: \"blocking\" or \"spin_then_block\"";
+        throw std::runtime_error(msg.str());
+    }
 
+    spinCount = ParseUnsignedInt(GetNamedAttributeValue(node, "spin_count", false), 4000);
+}
 
+}
@@ -185,4 +185,15 @@ unsigned int ParseTimegranAsMs(const XMLCh* amount, const XMLCh* units, unsigned
 unsigned int ParseTimegranAsMs(const XMLCh* amount, const XMLCh* units);
 unsigned int ParseTimegranAsSecond(const XMLCh* amount, const XMLCh* units, unsigned int defValue);
 std::string ProcessValueString(xercesc::DOMElement* node);
+
+/**
+ * Helper: parse the worker <barrier strategy="..." spin_count="..."/> element shared by the
+ * short-term and mid-term configs. Both attributes are optional; a missing element selects the
+ * blocking barrier.
+ * @param node the barrier element (may be null)
+ * @param spinBarrier set to true for "spin_then_block", false for "blocking"
+ * @param spinCount set to the spin_count attribute (default 4000)
+ * \throws std::runtime_error if the strategy is not recognised
+ */
+void ParseWorkerBarrier(xercesc::DOMElement* node, bool& spinBarrier, unsigned int& spinCount);
 }
@@ -0,0 +1,307 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+using namespace sim_mob;
+
+WorkStealingPool::WorkStealingPool(std::size_t numItems, std::size_t numWorkers, std::size_t chunkSize) :
+        numItems(numItems), chunkSize(chunkSize), aborted(false), persistent(false), runNumber(0), activeWorkers(0),
+        runningHelpers(0), currentWorker(nullptr), stopping(false)
+{
+    if (numWorkers == 0 || chunkSize == 0)
+    {
+        throw std::runtime_error("WorkStealingPool: number of workers and chunk size must be positive");
+    }
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(boost::shared_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+}
+
+WorkStealingPool::WorkStealingPool(std::size_t numWorkers) :
+        numItems(0), chunkSize(1), aborted(false), persistent(true), runNumber(0), activeWorkers(0), runningHelpers(0),
+        currentWorker(nullptr), stopping(false)
+{
+    if (numWorkers == 0)
+    {
+        throw std::runtime_error("WorkStealingPool: number of workers must be positive");
+    }
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(boost::shared_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        boost::mutex::scoped_lock lock(runMutex);
+        stopping = true;
+    }
+    runStarted.notify_all();
+    helpers.join_all();
+}
+
+void WorkStealingPool::run(const WorkerFunction& worker)
+{
+    if (persistent)
+    {
+        run(numItems, chunkSize, workers.size(), worker);
+        return;
+    }
+
+    const std::size_t numWorkers = workers.size();
+    prepareRun(numWorkers);
+
+    if (numWorkers == 1)
+    {
+        runWorker(worker, 0);
+    }
+    else
+    {
+        boost::thread_group threadGroup;
+        for (std::size_t w = 0; w < numWorkers; ++w)
+        {
+            threadGroup.create_thread(boost::bind(&WorkStealingPool::runWorker, this, boost::cref(worker), w));
+        }
+        threadGroup.join_all();
+    }
+
+    finishRun();
+}
+
+void WorkStealingPool::run(std::size_t numItems, std::size_t chunkSize, std::size_t numActive,
+        const WorkerFunction& worker)
+{
+    if (!persistent)
+    {
+        throw std::runtime_error("WorkStealingPool: the items of a run can only be given to a persistent pool");
+    }
+    if (chunkSize == 0 || numActive == 0 || numActive > workers.size())
+    {
+        throw std::runtime_error("WorkStealingPool: chunk size must be positive and at most "
+                "getNumWorkers() workers can be active");
+    }
+    this->numItems = numItems;
+    this->chunkSize = chunkSize;
+    prepareRun(numActive);
+
+    if (numActive > 1)
+    {
+        if (helpers.size() == 0)
+        {
+            for (std::size_t w = 1; w < workers.size(); ++w)
+            {
+                helpers.create_thread(boost::bind(&WorkStealingPool::helperLoop, this, w));
+            }
+        }
+        {
+            boost::mutex::scoped_lock lock(runMutex);
+            activeWorkers = numActive;
+            runningHelpers = numActive - 1;
+            currentWorker = &worker;
+            ++runNumber;
+        }
+        runStarted.notify_all();
+    }
+
+    runWorker(worker, 0);
+
+    if (numActive > 1)
+    {
+        boost::mutex::scoped_lock lock(runMutex);
+        while (runningHelpers > 0)
+        {
+            helpersDone.wait(lock);
+        }
+        currentWorker = nullptr;
+    }
+
+    finishRun();
+}
+
+void WorkStealingPool::prepareRun(std::size_t numActive)
+{
+    const std::size_t numChunks = (numItems + chunkSize - 1) / chunkSize;
+    for (std::size_t w = 0; w < workers.size(); ++w)
+    {
+        // contiguous share of the chunks, as in a static split
+        std::deque<Chunk>& chunks = workers[w]->chunks;
+        chunks.clear();
+        for (std::size_t c = w * numChunks / numActive; w < numActive && c < (w + 1) * numChunks / numActive; ++c)
+        {
+            std::size_t first = c * chunkSize;
+            chunks.push_back(Chunk(first, std::min(first + chunkSize, numItems)));
+        }
+    }
+    stats.assign(numActive, WorkerStats());
+    doneSeconds.assign(numActive, -1.0);
+    aborted = false;
+    error = std::exception_ptr();
+    start = boost::chrono::steady_clock::now();
+}
+
+void WorkStealingPool::finishRun()
+{
+    const double end = elapsedSeconds();
+    for (std::size_t w = 0; w < stats.size(); ++w)
+    {
+        stats[w].busySeconds = doneSeconds[w];
+        stats[w].idleSeconds = end - doneSeconds[w];
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkStealingPool::helperLoop(std::size_t workerId)
+{
+    std::size_t lastRun = 0;
+    while (true)
+    {
+        const WorkerFunction* worker = nullptr;
+        {
+            boost::mutex::scoped_lock lock(runMutex);
+            while (!stopping && (runNumber == lastRun || workerId >= activeWorkers))
+            {
+                // a helper left out of a run waits for the next one
+                lastRun = runNumber;
+                runStarted.wait(lock);
+            }
+            if (stopping)
+            {
+                return;
+            }
+            lastRun = runNumber;
+            worker = currentWorker;
+        }
+
+        runWorker(*worker, workerId);
+
+        boost::mutex::scoped_lock lock(runMutex);
+        if (--runningHelpers == 0)
+        {
+            helpersDone.notify_one();
+        }
+    }
+}
+
+void WorkStealingPool::runWorker(const WorkerFunction& worker, std::size_t workerId)
+{
+    try
+    {
+        worker(*this, workerId);
+    }
+    catch (...)
+    {
+        boost::mutex::scoped_lock lock(errorMutex);
+        if (!error)
+        {
+            error = std::current_exception();
+        }
+        aborted = true;
+    }
+
+    // a worker may also return before taking all chunks, e.g. when it fails
+    if (doneSeconds[workerId] < 0)
+    {
+        doneSeconds[workerId] = elapsedSeconds();
+    }
+}
+
+bool WorkStealingPool::nextChunk(std::size_t workerId, std::size_t& first, std::size_t& last)
+{
+    WorkerStats& workerStats = stats.at(workerId);
+    Chunk chunk;
+    bool found = false;
+    if (!aborted)
+    {
+        WorkerQueue& own = *workers[workerId];
+        boost::mutex::scoped_lock lock(own.mutex);
+        if (!own.chunks.empty())
+        {
+            chunk = own.chunks.front();
+            own.chunks.pop_front();
+            found = true;
+        }
+    }
+
+    // steal from the worker with the most chunks left, which is the one most likely to finish last
+    while (!found && !aborted)
+    {
+        std::size_t victim = workerId;
+        std::size_t mostChunks = 0;
+        for (std::size_t w = 0; w < workers.size(); ++w)
+        {
+            if (w == workerId)
+            {
+                continue;
+            }
+            boost::mutex::scoped_lock lock(workers[w]->mutex);
+            if (workers[w]->chunks.size() > mostChunks)
+            {
+                mostChunks = workers[w]->chunks.size();
+                victim = w;
+            }
+        }
+        if (mostChunks == 0)
+        {
+            // no chunks are ever added during a run, so there is nothing left to do
+            break;
+        }
+
+        boost::mutex::scoped_lock lock(workers[victim]->mutex);
+        if (!workers[victim]->chunks.empty())
+        {
+            chunk = workers[victim]->chunks.back();
+            workers[victim]->chunks.pop_back();
+            ++workerStats.stolenChunks;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        if (doneSeconds[workerId] < 0)
+        {
+            doneSeconds[workerId] = elapsedSeconds();
+        }
+        return false;
+    }
+
+    first = chunk.first;
+    last = chunk.second;
+    ++workerStats.chunks;
+    workerStats.items += last - first;
+    return true;
+}
+
+void WorkStealingPool::printStats(std::ostream& os, const std::string& label) const
+{
+    for (std::size_t w = 0; w < stats.size(); ++w)
+    {
+        const WorkerStats& workerStats = stats[w];
+        std::ostringstream line;
+        line << label << " worker " << w << std::fixed << std::setprecision(3)
+             << " | busy: " << workerStats.busySeconds << "s | idle: " << workerStats.idleSeconds << "s"
+             << " | chunks: " << workerStats.chunks << " (" << workerStats.stolenChunks << " stolen)"
+             << " | items: " << workerStats.items << "\n";
+        os << line.str();
+    }
+}
+
+double WorkStealingPool::elapsedSeconds() const
+{
+    return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,206 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace sim_mob
+{
+
+/**
+ * Distributes the items [0, numItems) of a batch job over a fixed number of worker threads.
+ *
+ * The items are cut into chunks of chunkSize consecutive items. Each worker starts with its own contiguous share
+ * of the chunks, which it processes in order; a worker which runs out of chunks steals the last chunk of another
+ * worker. Items whose processing cost varies a lot are thus balanced over the workers without giving up the
+ * locality of the static split.
+ *
+ * Unlike ThreadPool, a worker is a single call which keeps running until no chunk is left, so that per thread
+ * resources (database connections, output files, ...) are set up once per worker:
+ *
+ *     void work(WorkStealingPool& pool, std::size_t workerId)
+ *     {
+ *         // per thread setup
+ *         std::size_t first, last;
+ *         while (pool.nextChunk(workerId, first, last))
+ *         {
+ *             // process items [first, last)
+ *         }
+ *     }
+ *
+ * Busy and idle time of every worker are recorded for load balance reporting (see printStats()).
+ *
+ * A pool built for a single job starts its threads in every run(). A persistent pool, for jobs run every time step,
+ * starts numWorkers - 1 helper threads at its first run and keeps them waiting for the next run until it is
+ * destroyed; the thread calling run() is worker 0.
+ */
+class WorkStealingPool
+{
+public:
+    /** per worker statistics of the last run() */
+    struct WorkerStats
+    {
+        WorkerStats() : busySeconds(0), idleSeconds(0), chunks(0), items(0), stolenChunks(0)
+        {}
+
+        /** time from the start of the run until the worker found no chunk left */
+        double busySeconds;
+        /** time from then until the last worker finished */
+        double idleSeconds;
+        /** number of chunks processed, including stolen ones */
+        std::size_t chunks;
+        /** number of items processed */
+        std::size_t items;
+        /** number of chunks stolen from other workers */
+        std::size_t stolenChunks;
+    };
+
+    typedef boost::function<void (WorkStealingPool&, std::size_t)> WorkerFunction;
+
+    /**
+     * @param numItems number of items to process
+     * @param numWorkers number of worker threads; at least 1
+     * @param chunkSize number of items per chunk; at least 1
+     */
+    WorkStealingPool(std::size_t numItems, std::size_t numWorkers, std::size_t chunkSize);
+
+    /**
+     * creates a persistent pool; the items and the chunk size are given to each run
+     * @param numWorkers maximum number of workers, including the thread calling run(); at least 1
+     */
+    explicit WorkStealingPool(std::size_t numWorkers);
+
+    /** stops the helper threads of a persistent pool */
+    ~WorkStealingPool();
+
+    /**
+     * processes all items. Runs worker on numWorkers threads (on the calling thread if numWorkers is 1) and waits
+     * for all of them to return. If a worker throws, the other workers stop taking chunks and the first exception
+     * is rethrown after all of them have returned.
+     * @param worker function called with this pool and the worker id (0 to numWorkers - 1)
+     */
+    void run(const WorkerFunction& worker);
+
+    /**
+     * processes the items [0, numItems) on the first numActive workers of a persistent pool, as run(worker).
+     * Worker 0 runs on the calling thread; the other active workers on the helper threads.
+     * @param numItems number of items to process
+     * @param chunkSize number of items per chunk; at least 1
+     * @param numActive number of workers taking part; from 1 to getNumWorkers()
+     * @param worker function called with this pool and the worker id (0 to numActive - 1)
+     */
+    void run(std::size_t numItems, std::size_t chunkSize, std::size_t numActive, const WorkerFunction& worker);
+
+    /**
+     * fetches the next chunk for a worker: the next chunk of its own share, or a chunk stolen from another worker
+     * @param workerId id of the calling worker
+     * @param first output first item of the chunk
+     * @param last output item after the last item of the chunk
+     * @return false if no chunk is left; true otherwise
+     */
+    bool nextChunk(std::size_t workerId, std::size_t& first, std::size_t& last);
+
+    std::size_t getNumWorkers() const
+    {
+        return workers.size();
+    }
+
+    /**
+     * @return per worker statistics of the last run()
+     */
+    const std::vector<WorkerStats>& getStats() const
+    {
+        return stats;
+    }
+
+    /**
+     * prints one line per worker with its busy and idle time, chunk and item counts
+     * @param os output stream
+     * @param label name of the job, prefixed to each line
+     */
+    void printStats(std::ostream& os, const std::string& label) const;
+
+private:
+    typedef std::pair<std::size_t, std::size_t> Chunk;
+
+    /** chunks of one worker; the owner takes from the front, thieves from the back */
+    struct WorkerQueue
+    {
+        boost::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    /** hands the chunks out to the first numActive workers and resets the statistics */
+    void prepareRun(std::size_t numActive);
+
+    /** completes the statistics of a run; rethrows the first exception of a worker */
+    void finishRun();
+
+    /** runs worker as workerId and records its statistics */
+    void runWorker(const WorkerFunction& worker, std::size_t workerId);
+
+    /** body of a helper thread of a persistent pool: runs workerId in every run which needs it */
+    void helperLoop(std::size_t workerId);
+
+    /** @return seconds since the start of the current run */
+    double elapsedSeconds() const;
+
+    std::size_t numItems;
+    std::size_t chunkSize;
+
+    std::vector< boost::shared_ptr<WorkerQueue> > workers;
+    std::vector<WorkerStats> stats;
+
+    /** time at which each worker found no chunk left, in seconds since the start of the run; negative until then */
+    std::vector<double> doneSeconds;
+
+    /** start of the current run */
+    boost::chrono::steady_clock::time_point start;
+
+    /** set when a worker threw; the remaining workers then get no more chunks */
+    boost::atomic<bool> aborted;
+
+    /** first exception thrown by a worker */
+    std::exception_ptr error;
+    boost::mutex errorMutex;
+
+    /** true for a persistent pool */
+    bool persistent;
+
+    /** helper threads of a persistent pool, running workers 1 to numWorkers - 1; started at the first run */
+    boost::thread_group helpers;
+
+    /** the fields below are guarded by runMutex */
+    boost::mutex runMutex;
+    /** signals helpers that a run started, or that the pool is being destroyed */
+    boost::condition_variable runStarted;
+    /** signals the calling thread that the last active helper finished */
+    boost::condition_variable helpersDone;
+    /** number of the current run, which helpers wait to change */
+    std::size_t runNumber;
+    /** number of workers taking part in the current run */
+    std::size_t activeWorkers;
+    /** number of active helpers which have not finished the current run yet */
+    std::size_t runningHelpers;
+    /** worker function of the current run */
+    const WorkerFunction* currentWorker;
+    /** set by the destructor */
+    bool stopping;
+};
+
+}
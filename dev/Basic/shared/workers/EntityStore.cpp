@@ -0,0 +1,55 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#include "EntityStore.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include "entities/Entity.hpp"
+
+using namespace sim_mob;
+
+EntityStore::EntityStore(unsigned int slot) : slot(slot)
+{
+    if (slot >= Entity::NUM_STORE_SLOTS)
+    {
+        std::stringstream msg;
+        msg << "EntityStore: invalid position slot " << slot << "; entities have " << Entity::NUM_STORE_SLOTS;
+        throw std::runtime_error(msg.str());
+    }
+}
+
+bool EntityStore::add(Entity* entity)
+{
+    if (contains(entity))
+    {
+        return false;
+    }
+    entity->storePositions[slot] = entities.size();
+    entities.push_back(entity);
+    return true;
+}
+
+bool EntityStore::remove(Entity* entity)
+{
+    if (!contains(entity))
+    {
+        return false;
+    }
+
+    //Move the last entity into the freed position
+    const std::size_t position = entity->storePositions[slot];
+    Entity* last = entities.back();
+    entities[position] = last;
+    last->storePositions[slot] = position;
+    entities.pop_back();
+    return true;
+}
+
+bool EntityStore::contains(const Entity* entity) const
+{
+    //The position of an entity which is not part of the store is meaningless, hence the check of the entity found there
+    const std::size_t position = entity->storePositions[slot];
+    return position < entities.size() && entities[position] == entity;
+}
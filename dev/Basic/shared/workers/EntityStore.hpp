@@ -0,0 +1,99 @@
+//Copyright (c) 2013 Singapore-MIT Alliance for Research and Technology
+//Licensed under the terms of the MIT License, as described in the file:
+//   license.txt   (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sim_mob
+{
+
+class Entity;
+
+/**
+ * Dense storage of the entities managed by a worker.
+ *
+ * The entities are kept contiguously in a vector, which is what the update loop of the worker walks through.
+ * An entity is its own handle: its position in the vector is kept in the entity itself (one slot per store it
+ * can be part of), so finding and removing it takes constant time. A removal moves the last entity into the
+ * freed position, so the order of the entities is not preserved.
+ */
+class EntityStore
+{
+public:
+    typedef std::vector<Entity*>::const_iterator const_iterator;
+
+    /**
+     * @param slot position slot of the entities used by this store; entities can be part of stores with
+     *      different slots at the same time (see Entity::NUM_STORE_SLOTS)
+     */
+    explicit EntityStore(unsigned int slot);
+
+    /**
+     * adds an entity
+     * @param entity the entity
+     * @return false if the entity was already part of the store
+     */
+    bool add(Entity* entity);
+
+    /**
+     * removes an entity
+     * @param entity the entity
+     * @return false if the entity was not part of the store
+     */
+    bool remove(Entity* entity);
+
+    /**
+     * @param entity the entity
+     * @return true if the entity is part of the store
+     */
+    bool contains(const Entity* entity) const;
+
+    std::size_t size() const
+    {
+        return entities.size();
+    }
+
+    bool empty() const
+    {
+        return entities.empty();
+    }
+
+    Entity* operator[](std::size_t index) const
+    {
+        return entities[index];
+    }
+
+    Entity* back() const
+    {
+        return entities.back();
+    }
+
+    const_iterator begin() const
+    {
+        return entities.begin();
+    }
+
+    const_iterator end() const
+    {
+        return entities.end();
+    }
+
+    /**
+     * @return the entities of the store
+     */
+    const std::vector<Entity*>& getEntities() const
+    {
+        return entities;
+    }
+
+private:
+    /** slot of Entity::storePositions used by this store */
+    const unsigned int slot;
+
+    std::vector<Entity*> entities;
+};
+
+}
@@ -333,6 +333,38 @@ bool sim_mob::WorkGroup::assignWorker(Entity* ag, unsigned int workerId)
     return true;
 }
 
+bool sim_mob::WorkGroup::migrateEntity(Entity* ag, unsigned int workerId)
+{
+    if (!ag || workerId >= workers.size())
+    {
+        return false;
+    }
+
+    for (vector<Worker*>::iterator it = workers.begin(); it != workers.end(); it++)
+    {
+        if (*it == ag->currWorkerProvider)
+        {
+            (*it)->migrateEntityTo(*ag, *workers[workerId]);
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<Entity*>& sim_mob::WorkGroup::getWorkerEntities(unsigned int workerId) const
+{
+    return workers.at(workerId)->getEntities();
+}
+
+void sim_mob::WorkGroup::collectWorkerUpdateTimes(std::vector<double>& updateTimes)
+{
+    updateTimes.resize(workers.size());
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        updateTimes[i] = workers[i]->collectUpdateTime().count();
+    }
+}
+
 size_t sim_mob::WorkGroup::size() const
 {
     return workers.size();
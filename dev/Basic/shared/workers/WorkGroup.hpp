@@ -112,6 +112,34 @@ public:
      */
     bool assignWorker(Entity* ag, unsigned int workerId);
 
+    /**
+     * moves an entity from the worker currently managing it to another worker of this group.
+     * NOTE: must be called only while all workers are waiting on a barrier (e.g. by the main thread between frame ticks)
+     *
+     * @param ag the entity to move
+     * @param workerId index of the destination worker in workers list
+     *
+     * @return true if the entity was moved; false if workerId is invalid or the entity is not managed by a worker of this group
+     */
+    bool migrateEntity(Entity* ag, unsigned int workerId);
+
+    /**
+     * gets the entities managed by a worker
+     *
+     * @param workerId index of worker in workers list
+     *
+     * @return entities managed by the worker
+     */
+    const std::vector<Entity*>& getWorkerEntities(unsigned int workerId) const;
+
+    /**
+     * collects the wall-clock time spent by each worker in updating its entities since the previous call
+     * NOTE: must be called only while all workers are waiting on a barrier
+     *
+     * @param updateTimes output vector; element i is set to the update time of worker i in microseconds
+     */
+    void collectWorkerUpdateTimes(std::vector<double>& updateTimes);
+
     /**
      * processes multi-update entities
      *
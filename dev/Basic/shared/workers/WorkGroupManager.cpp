@@ -102,6 +102,22 @@ void sim_mob::WorkGroupManager::setSingleThreadMode(bool enable)
     singleThreaded = enable;
 }
 
+void sim_mob::WorkGroupManager::setBarrierStrategy(FlexiBarrier::Strategy strategy, unsigned int spinCount)
+{
+    if (!(currState.test(INIT) || currState.test(CREATE)))
+    {
+        throw std::runtime_error("Can't change the barrier strategy once barriers have been established.");
+    }
+
+    barrierStrategy = strategy;
+    barrierSpinCount = spinCount;
+}
+
+void sim_mob::WorkGroupManager::setFlipBuffersCallback(const FlipBuffersCallback& callback)
+{
+    flipBuffersCallback = callback;
+}
+
 void sim_mob::WorkGroupManager::initAllGroups()
 {
     // Registers the main thread for message bus.
@@ -118,9 +134,9 @@ void sim_mob::WorkGroupManager::initAllGroups()
     if (!singleThreaded)
     {
         //Create a barrier for each of the three shared phases (aura manager optional)
-        frameTickBarr = new FlexiBarrier(currBarrierCount);
-        buffFlipBarr = new FlexiBarrier(currBarrierCount);
-        msgBusBarr = new FlexiBarrier(currBarrierCount);
+        frameTickBarr = new FlexiBarrier(currBarrierCount, barrierStrategy, barrierSpinCount);
+        buffFlipBarr = new FlexiBarrier(currBarrierCount, barrierStrategy, barrierSpinCount);
+        msgBusBarr = new FlexiBarrier(currBarrierCount, barrierStrategy, barrierSpinCount);
 
         //Initialize each WorkGroup with these new barriers.
         for (vector<WorkGroup*>::iterator it = registeredWorkGroups.begin(); it != registeredWorkGroups.end(); it++)
@@ -223,6 +239,12 @@ void sim_mob::WorkGroupManager::waitAllGroups_FlipBuffers(std::set<Entity*>* rem
     {
         buffFlipBarr->wait();
     }
+
+    if (flipBuffersCallback)
+    {
+        flipBuffersCallback(numFlips);
+    }
+    numFlips++;
 }
 
 void sim_mob::WorkGroupManager::waitAllGroups_MacroTimeTick()
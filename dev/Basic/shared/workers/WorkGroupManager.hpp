@@ -8,6 +8,7 @@
 #include <set>
 #include <string>
 #include <vector>
+#include <boost/function.hpp>
 #include "entities/Entity.hpp"
 #include "entities/PersonLoader.hpp"
 #include "util/FlexiBarrier.hpp"
@@ -31,8 +32,12 @@ class WorkGroup;
 class WorkGroupManager
 {
 public:
+    /** called with the number of the tick whose buffers have just been flipped */
+    typedef boost::function<void (unsigned int)> FlipBuffersCallback;
+
     WorkGroupManager() : currBarrierCount(1), frameTickBarr(nullptr), buffFlipBarr(nullptr), msgBusBarr(nullptr),
-    singleThreaded(false), currState(INIT), simulationStartDay(0)
+    singleThreaded(false), barrierStrategy(FlexiBarrier::BLOCKING), barrierSpinCount(FlexiBarrier::DEFAULT_SPIN_COUNT),
+    numFlips(0), currState(INIT), simulationStartDay(0)
     {
     }
 
@@ -44,6 +49,23 @@ public:
      */
     void setSingleThreadMode(bool enable);
 
+    /**
+     * Select how threads wait on the shared frame tick, flip buffer and message bus barriers.
+     * This must be done before initAllGroups().
+     *
+     * @param strategy barrier wait strategy
+     * @param spinCount maximum number of spins before yielding (spin-then-block only)
+     */
+    void setBarrierStrategy(FlexiBarrier::Strategy strategy, unsigned int spinCount = FlexiBarrier::DEFAULT_SPIN_COUNT);
+
+    /**
+     * Set a function to be run by the main thread after each flip buffers barrier, before the messages are distributed.
+     * No agent is updated while it runs: the workers are waiting on the message bus barrier.
+     *
+     * @param callback the function, called with the number of the tick (0 for the first one)
+     */
+    void setFlipBuffersCallback(const FlipBuffersCallback& callback);
+
     /**
      * Retrieve a list of (output) file names
      * @return list of output file names
@@ -137,6 +159,18 @@ private:
     /** Are we operating in "single-threaded" mode? Default is false. */
     bool singleThreaded;
 
+    /** wait strategy of the shared barriers. Default is blocking */
+    FlexiBarrier::Strategy barrierStrategy;
+
+    /** maximum spins of the shared barriers before yielding (spin-then-block only) */
+    unsigned int barrierSpinCount;
+
+    /** run after each flip buffers barrier; may be empty */
+    FlipBuffersCallback flipBuffersCallback;
+
+    /** number of flip buffers barriers passed so far */
+    unsigned int numFlips;
+
     //Our shared barriers for the main three barriers (macro barriers are handled internal to each WorkGroup).
     /** frame tick barrier */
     sim_mob::FlexiBarrier* frameTickBarr;
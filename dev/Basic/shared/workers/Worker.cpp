@@ -31,7 +31,6 @@
 #include "message/MessageBus.hpp"
 #include "logging/ControllerLog.hpp"
 
-using std::set;
 using std::vector;
 using std::priority_queue;
 using boost::barrier;
@@ -41,9 +40,9 @@ using namespace sim_mob::event;
 
 typedef Entity::UpdateStatus UpdateStatus;
 
-UpdateEventArgs::UpdateEventArgs(const sim_mob::Entity *entity): entity(entity){};
-const Entity * UpdateEventArgs::GetEntity()const {
-    return entity;
+UpdateEventArgs::UpdateEventArgs(const std::vector<const sim_mob::Entity*>& entities): entities(entities){};
+const std::vector<const Entity*>& UpdateEventArgs::GetEntities()const {
+    return entities;
 }
 UpdateEventArgs::~UpdateEventArgs(){};
 
@@ -68,22 +67,24 @@ sim_mob::Worker::Worker(WorkGroup* parent, std::ostream* logFile,  FlexiBarrier*
                         std::vector<Entity*>* entityRemovalList, std::vector<Entity*>* entityBredList, uint32_t endTick, uint32_t tickStep, uint32_t _simulationStartDay)
                        :logFile(logFile), frame_tick_barr(frame_tick), buff_flip_barr(buff_flip), aura_mgr_barr(aura_mgr), macro_tick_barr(macro_tick),
                         endTick(endTick), tickStep(tickStep), parent(parent), entityRemovalList(entityRemovalList), entityBredList(entityBredList),
-                        profile(nullptr),pathSetMgr(nullptr), simulationStartDay(_simulationStartDay)
+                        profile(nullptr),pathSetMgr(nullptr), simulationStartDay(_simulationStartDay), updateTime(0), messageContext(nullptr),
+                        managedEntities(0), managedMultiUpdateEntities(1)
 {
     //Initialize our profile builder, if applicable.
     if (ConfigManager::GetInstance().CMakeConfig().ProfileWorkerUpdates()) {
         profile = new ProfileBuilder();
     }
+
+    setArenaBuffering(ConfigManager::GetInstance().FullConfig().simulation.arenaBuffering);
     //thread_id = auto_matical_thread_id;
     //auto_matical_thread_id++;
-    srand(std::time(0));
 }
 
 sim_mob::Worker::~Worker()
 {
     //Clear all tracked entitites
-    while (managedEntities.begin() != managedEntities.end()) {
-        remEntity(*managedEntities.begin());
+    while (!managedEntities.empty()) {
+        remEntity(managedEntities.back());
     }
     /*while (!managedEntities.empty()) {
         remEntity(managedEntities.front());
@@ -102,29 +103,21 @@ sim_mob::Worker::~Worker()
 
 void sim_mob::Worker::addEntity(Entity* entity)
 {
-    managedEntities.insert(entity);
+    managedEntities.add(entity);
     if(entity->isMultiUpdate())
     {
-        managedMultiUpdateEntities.insert(entity);
+        managedMultiUpdateEntities.add(entity);
     }
 }
 
 
 void sim_mob::Worker::remEntity(Entity* entity)
 {
-    //Remove this entity from the data vector.
-    std::set<Entity*>::iterator it = managedEntities.find(entity);
-    if (it != managedEntities.end())
-    {
-        managedEntities.erase(it);
-    }
+    //Remove this entity from the data vectors.
+    managedEntities.remove(entity);
     if (entity->isMultiUpdate())
     {
-        std::set<Entity*>::iterator it = managedMultiUpdateEntities.find(entity);
-        if (it != managedMultiUpdateEntities.end())
-        {
-            managedMultiUpdateEntities.erase(it);
-        }
+        managedMultiUpdateEntities.remove(entity);
     }
 }
 
@@ -133,9 +126,9 @@ UpdatePublisher & sim_mob::Worker::GetUpdatePublisher()
     return updatePublisher;
 }
 
-const std::set<Entity*>& sim_mob::Worker::getEntities() const
+const std::vector<Entity*>& sim_mob::Worker::getEntities() const
 {
-    return managedEntities;
+    return managedEntities.getEntities();
 }
 
 
@@ -288,7 +281,9 @@ void sim_mob::Worker::perform_frame_tick()
     addPendingEntities();
 
     //Perform all our Agent updates, etc.
+    boost::chrono::steady_clock::time_point updateStart = boost::chrono::steady_clock::now();
     update_entities(timeslice(par.currTick, par.currTick*par.msPerFrame));
+    updateTime += boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - updateStart);
 
 
     //Remove Agents as requires
@@ -336,7 +331,8 @@ void sim_mob::Worker::threaded_function_loop()
 {
     // Register thread on MessageBus.
     messaging::MessageBus::RegisterThread();
-    
+    messageContext = messaging::MessageBus::GetCurrentContext();
+
     ///NOTE: Please keep this function simple. In fact, you should not have to add anything to it.
     ///      Instead, add functionality into the sub-functions (perform_frame_tick(), etc.).
     ///      This is needed so that singleThreaded mode can be implemented easily. ~Seth
@@ -404,101 +400,10 @@ void sim_mob::Worker::threaded_function_loop()
     messaging::MessageBus::UnRegisterThread();
 }
 
-namespace {
-
-///This class performs the operator() function on an Entity, and is meant to be used inside of a for_each loop.
-struct EntityUpdater
-{
-    EntityUpdater(Worker& wrk, timeslice currTime) :
-            wrk(wrk), currTime(currTime)
-    {
-    }
-    virtual ~EntityUpdater()
-    {
-    }
-
-    Worker& wrk;
-    timeslice currTime;
-
-    virtual void operator()(sim_mob::Entity* entity)
-    {
-        UpdateStatus res = entity->update(currTime);
-
-        if (ConfigManager::GetInstance().FullConfig().isWorkerPublisherEnabled())
-        {
-            Worker::GetUpdatePublisher().publish(event::EVT_CORE_AGENT_UPDATED, (void*) event::CXT_CORE_AGENT_UPDATE, UpdateEventArgs(entity));
-        }
-        switch(res.status)
-        {
-            case UpdateStatus::RS_DONE:
-            {
-                //This Entity is done; schedule for deletion.
-                wrk.scheduleForRemoval(entity);
-                break;
-            }
-            case UpdateStatus::RS_CONTINUE:
-            {
-                //Still going, but we may have properties to start/stop managing
-                for (set<BufferedBase*>::iterator it = res.toRemove.begin(); it != res.toRemove.end(); it++)
-                {
-                    wrk.stopManaging(*it);
-                }
-                for (set<BufferedBase*>::iterator it = res.toAdd.begin(); it != res.toAdd.end(); it++)
-                {
-                    wrk.beginManaging(*it);
-                }
-                break;
-            }
-            case UpdateStatus::RS_CONTINUE_INCOMPLETE:
-            {
-                break;
-            }
-            default:
-            {
-                throw std::runtime_error("Unknown/unexpected update() return status.");
-            }
-        }
-    }
-};
-
-///This class extends EntityUpdater, allowing it to skip calling operator() on a certain Entity sub-class
-///  (which is tested for using a dynamic_cast).
-template <class Restricted>
-struct RestrictedEntityUpdater : public EntityUpdater {
-    RestrictedEntityUpdater(Worker& wrk, timeslice currTime) : EntityUpdater(wrk, currTime) {}
-    virtual ~RestrictedEntityUpdater() {}
-
-    virtual void operator() (sim_mob::Entity* entity) {
-        //Exclude the restricted type.
-        if(!dynamic_cast<Restricted*>(entity)) {
-            EntityUpdater::operator ()(entity);
-            {
-                Agent * agent = dynamic_cast<Agent*>(entity);//no choice but to dynamic_cast. And this is the least expensive place
-                if(agent)
-                {
-                    Worker::GetUpdatePublisher().publish(event::EVT_CORE_AGENT_UPDATED,(void*)event::CXT_CORE_AGENT_UPDATE,UpdateEventArgs(agent));
-                            std::cout << "tick: " << currTime.frame() << " : Entity update-done published for agent [" << entity->getId() << "] " << std::endl;
-                }
-            }
-        }
-    }
-};
-
-template <typename T>
-struct ContainerDeleter {
-    ContainerDeleter() {}
-    virtual ~ContainerDeleter() {}
-
-    virtual void operator() (T* t) {
-        safe_delete_item(t);
-    }
-};
-} //End un-named namespace.
-
 void sim_mob::Worker::migrateAllOut()
 {
     while (!managedEntities.empty()) {
-        migrateOut(**managedEntities.begin());
+        migrateOut(*managedEntities.back());
     }
 }
 
@@ -550,16 +455,101 @@ void sim_mob::Worker::migrateIn(Entity& ag)
     }
 }
 
+void sim_mob::Worker::migrateEntityTo(Entity& ent, Worker& destination)
+{
+    if (&destination == this)
+    {
+        return;
+    }
+
+    migrateOut(ent);
+    ent.onWorkerExit();
+
+    destination.migrateIn(ent);
+
+    //Messages to the entity must be handled by the destination thread from now on.
+    if (destination.messageContext && ent.GetContext())
+    {
+        messaging::MessageBus::ReRegisterHandler(&ent, destination.messageContext);
+    }
+    ent.onWorkerEnter();
+}
+
+boost::chrono::microseconds sim_mob::Worker::collectUpdateTime()
+{
+    boost::chrono::microseconds res = updateTime;
+    updateTime = boost::chrono::microseconds(0);
+    return res;
+}
+
 //TODO: It seems that beginManaging() and stopManaging() can also be called during update?
 //      May want to dig into this a bit more. ~Seth
 void sim_mob::Worker::update_entities(timeslice currTime)
 {
-    std::for_each(managedEntities.begin(), managedEntities.end(), EntityUpdater(*this, currTime));
+    updateEntities(managedEntities, currTime);
 }
 
 void sim_mob::Worker::processMultiUpdateEntities(uint32_t currTick)
 {
     const unsigned int msPerFrame = ConfigManager::GetInstance().FullConfig().baseGranMS();
     timeslice currTime = timeslice(currTick, currTick*msPerFrame);
-    std::for_each(managedMultiUpdateEntities.begin(), managedMultiUpdateEntities.end(), EntityUpdater(*this, currTime));
+    updateEntities(managedMultiUpdateEntities, currTime);
+}
+
+void sim_mob::Worker::updateEntities(const EntityStore& entities, timeslice currTime)
+{
+    const bool publish = ConfigManager::GetInstance().FullConfig().isWorkerPublisherEnabled();
+    UpdateStatus::DeltaBuffer::Scope deltaScope(updateDeltas);
+
+    //NOTE: Entities are only scheduled for removal here, so the store does not change while it is walked through.
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        Entity* entity = entities[i];
+        UpdateStatus res = entity->update(currTime);
+
+        if (publish)
+        {
+            updatedEntities.push_back(entity);
+        }
+        switch(res.status)
+        {
+            case UpdateStatus::RS_DONE:
+            {
+                //This Entity is done; schedule for deletion.
+                scheduleForRemoval(entity);
+                break;
+            }
+            case UpdateStatus::RS_CONTINUE:
+            {
+                //Still going, but we may have properties to start/stop managing
+                BufferedBase* const* toRemove = updateDeltas.getToRemove(res);
+                for (unsigned int j = 0; j < res.numToRemove; j++)
+                {
+                    stopManaging(toRemove[j]);
+                }
+                BufferedBase* const* toAdd = updateDeltas.getToAdd(res);
+                for (unsigned int j = 0; j < res.numToAdd; j++)
+                {
+                    beginManaging(toAdd[j]);
+                }
+                break;
+            }
+            case UpdateStatus::RS_CONTINUE_INCOMPLETE:
+            {
+                break;
+            }
+            default:
+            {
+                throw std::runtime_error("Unknown/unexpected update() return status.");
+            }
+        }
+    }
+    updateDeltas.clear();
+
+    //A single notification for the whole pass
+    if (!updatedEntities.empty())
+    {
+        GetUpdatePublisher().publish(event::EVT_CORE_AGENT_UPDATED, (void*) event::CXT_CORE_AGENT_UPDATE, UpdateEventArgs(updatedEntities));
+        updatedEntities.clear();
+    }
 }
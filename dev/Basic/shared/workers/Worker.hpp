@@ -7,13 +7,16 @@
 #include <ostream>
 #include <vector>
 #include <set>
+#include <boost/chrono.hpp>
 #include <boost/random.hpp>
 #include <boost/thread.hpp>
 #include "buffering/BufferedDataManager.hpp"
+#include "entities/Entity.hpp"
 #include "metrics/Frame.hpp"
 #include "event/EventPublisher.hpp"
 #include "event/SystemEvents.hpp"
 #include "event/args/EventArgs.hpp"
+#include "workers/EntityStore.hpp"
 //#include "event/EventListener.hpp"
 
 namespace sim_mob {
@@ -37,11 +40,14 @@ public:
 
 
 
+/**
+ * Arguments of EVT_CORE_AGENT_UPDATED, which a worker publishes once per update pass with all the entities it updated.
+ */
 class UpdateEventArgs: public sim_mob::event::EventArgs {
-    const sim_mob::Entity *entity;
+    const std::vector<const sim_mob::Entity*>& entities;
 public:
-    const Entity * GetEntity()const;
-    UpdateEventArgs(const sim_mob::Entity *agent);
+    const std::vector<const Entity*>& GetEntities()const;
+    UpdateEventArgs(const std::vector<const sim_mob::Entity*>& entities);
     virtual ~UpdateEventArgs();
 };
 
@@ -55,10 +61,6 @@ public:
  */
 class WorkerProvider : public BufferedDataManager
 {
-protected:
-    /**Worker specific random number generator*/
-    boost::mt19937 gen;
-
 public:
     //NOTE: Allowing access to the BufferedDataManager is somewhat risky; we need it for Roles, but we might
     //      want to organize this differently.
@@ -68,17 +70,9 @@ public:
 
     virtual void scheduleForBred(Entity* entity) = 0;
 
-    virtual const std::set<Entity*>& getEntities() const = 0;
+    virtual const std::vector<Entity*>& getEntities() const = 0;
 
     virtual ProfileBuilder* getProfileBuilder() const = 0;
-
-    /**
-     * Note: Calling this function from another worker is extremely dangerous if you don't know what you're doing
-     */
-    boost::mt19937& getGenerator()
-    {
-        return gen;
-    }
 };
 
 
@@ -122,11 +116,27 @@ private:
     int getAgentSize(bool includeToBeAdded=false);
     void migrateAllOut();
 
+    /**
+     * Moves an entity managed by this worker to another worker. The entity's Buffered<> types and
+     * message handler follow it to the destination.
+     * NOTE: This must only be called while both workers are waiting on a barrier.
+     *
+     * \param ent the entity to move
+     * \param destination worker which must manage the entity from now on
+     */
+    void migrateEntityTo(Entity& ent, Worker& destination);
+
+    /**
+     * Returns the wall-clock time spent in update_entities() since the last call, and restarts the count.
+     * NOTE: This must only be called while this worker is waiting on a barrier.
+     */
+    boost::chrono::microseconds collectUpdateTime();
+
 public:
     virtual ~Worker();
     static UpdatePublisher & GetUpdatePublisher();
     //Removing entities and scheduling them for removal is allowed (but adding is restricted).
-    const std::set<Entity*>& getEntities() const;
+    const std::vector<Entity*>& getEntities() const;
     void remEntity(Entity* entity);
     void scheduleForRemoval(Entity* entity);
     void scheduleForBred(Entity* entity);
@@ -174,6 +184,12 @@ private:
     //Helper functions for various update functionality.
     virtual void update_entities(timeslice currTime);
 
+    /**
+     * Updates the given entities, applies the changes to the managed Buffered<> types they return and publishes
+     * the agent-updated event for all of them at once (if enabled).
+     */
+    void updateEntities(const EntityStore& entities, timeslice currTime);
+
     void migrateOut(Entity& ent);
     void migrateIn(Entity& ent);
 
@@ -226,14 +242,20 @@ private:
     MgmtParams loop_params;
 
     ///Simple Entities managed by this worker
-    std::set<Entity*> managedEntities;
+    EntityStore managedEntities;
 
     ///Some Entities need to be updated multiple times in each time step.
     ///This typically happens when part of the update of an Entity depends on the partial update of other entities.
     ///Confluxes in mid-term are a good example of multi-update entities
-    ///NOTE: The entities in this set also belong to managedEntities set.
+    ///NOTE: The entities in this store also belong to managedEntities.
     ///      In other words, managedMultiUpdateEntities is a subset of managedEntities containing only multi-update entities
-    std::set<Entity*> managedMultiUpdateEntities;
+    EntityStore managedMultiUpdateEntities;
+
+    ///Scratch buffer holding the Buffered<> types to start/stop managing returned by the entities during an update pass
+    Entity::UpdateStatus::DeltaBuffer updateDeltas;
+
+    ///Entities updated during an update pass, published at the end of the pass
+    std::vector<const Entity*> updatedEntities;
 
     ///If non-null, used for profiling.
     sim_mob::ProfileBuilder* profile;
@@ -242,6 +264,12 @@ private:
 
     uint32_t simulationStartDay;
 
+    ///Wall-clock time spent in update_entities() since the last call to collectUpdateTime()
+    boost::chrono::microseconds updateTime;
+
+    ///MessageBus context of the thread running this worker. Null until the thread starts (and in single-threaded mode)
+    void* messageContext;
+
 public:
 
     /// each worker has its own path set manager
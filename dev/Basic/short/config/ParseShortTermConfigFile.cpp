@@ -383,14 +383,25 @@ void ParseShortTermConfigFile::processAuraManagerImpNode(DOMElement *node)
         {
             stCfg.auraManagerImplementation = AuraManager::IMPL_SIMTREE;
         }
+        else if(value == "incremental-tree")
+        {
+            stCfg.auraManagerImplementation = AuraManager::IMPL_INCREMENTAL;
+        }
+        else if(value == "lane-index")
+        {
+            stCfg.auraManagerImplementation = AuraManager::IMPL_LANE;
+        }
         else
         {
             stringstream msg;
             msg << "Invalid value for <aura_manager_impl value=\""
-                << value << "\">. Expected: \"packing-tree\" or \"rstar\" or \"rdu\" or \"simtree\"";
+                << value << "\">. Expected: \"packing-tree\" or \"rstar\" or \"rdu\" or \"simtree\" or \"incremental-tree\" or \"lane-index\"";
             throw runtime_error(msg.str());
         }
     }
+
+    stCfg.auraManagerTraceFile = ParseString(GetNamedAttributeValue(node, "record", false), "");
+    stCfg.auraManagerReplayFile = ParseString(GetNamedAttributeValue(node, "replay", false), "");
 }
 
 void ParseShortTermConfigFile::processLoadAgentsOrder(DOMElement *node)
@@ -539,6 +550,7 @@ void ParseShortTermConfigFile::processWorkersNode(xercesc::DOMElement* node)
     processWorkerSignalNode(GetSingleElementByName(node, "signal", true));
     processWorkerIntMgrNode(GetSingleElementByName(node, "intersection_manager", true));
     processWorkerCommunicationNode(GetSingleElementByName(node, "communication", true));
+    processWorkerBarrierNode(GetSingleElementByName(node, "barrier"));
 }
 
 void ParseShortTermConfigFile::processWorkerPersonNode(xercesc::DOMElement* node)
@@ -571,6 +583,11 @@ void ParseShortTermConfigFile::processWorkerCommunicationNode(xercesc::DOMElemen
     }
 }
 
+void ParseShortTermConfigFile::processWorkerBarrierNode(xercesc::DOMElement* node)
+{
+    ParseWorkerBarrier(node, stCfg.workers.spinBarrier, stCfg.workers.barrierSpinCount);
+}
+
 void ParseShortTermConfigFile::processPersonCharacteristicsNode(DOMElement *node)
 {
     if (!node)
@@ -155,6 +155,13 @@ private:
      */
     void processWorkerCommunicationNode(xercesc::DOMElement* node);
 
+    /**
+     * Processes the (optional) barrier element in the config file
+     *
+     * @param node node corresponding to the barrier element in the xml file
+     */
+    void processWorkerBarrierNode(xercesc::DOMElement* node);
+
     /**
      * Processes the personCharacteristics element in the config file
      *
@@ -123,6 +123,10 @@ struct Commsim
 class WorkerParams
 {
 public:
+    WorkerParams() : spinBarrier(false), barrierSpinCount(4000)
+    {
+    }
+
     struct WorkerConf
     {
         WorkerConf() :
@@ -137,6 +141,12 @@ public:
     WorkerConf signal;
     WorkerConf intersectionMgr;
     WorkerConf communication;
+
+    /// should workers spin (then yield, then block) on the tick barriers instead of blocking immediately?
+    bool spinBarrier;
+
+    /// maximum number of spins before a worker yields at a tick barrier (spinBarrier only)
+    unsigned int barrierSpinCount;
 };
 
 /**
@@ -408,6 +418,12 @@ public:
     /// Type of aura-manager used
     AuraManager::AuraManagerImplementation auraManagerImplementation;
 
+    /// File recording the positions of the agents at every update of the aura-manager; empty if not recorded
+    std::string auraManagerTraceFile;
+
+    /// Trace of agent positions replayed through all the aura-manager implementations instead of simulating; empty if none
+    std::string auraManagerReplayFile;
+
     /// Property specific to MPI version; not fully documented.
     int partitioningSolutionId;
 
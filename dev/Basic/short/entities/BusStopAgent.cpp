@@ -104,7 +104,7 @@ Entity::UpdateStatus BusStopAgent::frame_tick(timeslice now)
         waitingCnt.count = waitingPersons.size();
 
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_WAITING_PERSON_COUNT,
-                messaging::MessageBus::MessagePtr(new WaitingCountMessage(waitingCnt)));
+                messaging::MessageBus::MakeMessage<WaitingCountMessage>(waitingCnt));
     }
     
     return UpdateStatus::Continue;
@@ -140,7 +140,7 @@ void BusStopAgent::HandleMessage(messaging::Message::MessageType type, const mes
         for (Person_ST *waitingPerson : waitingPersons)
         {
             messaging::MessageBus::PostMessage(waitingPerson, MSG_WAKEUP_WAITING_PERSON,
-                    messaging::MessageBus::MessagePtr(new BusDriverMessage(busDriverMsg.busDriver)));
+                    messaging::MessageBus::MakeMessage<BusDriverMessage>(busDriverMsg.busDriver));
         }
         break;
     }
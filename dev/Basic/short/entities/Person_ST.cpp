@@ -13,6 +13,7 @@
 #include "path/PT_RouteChoiceLuaProvider.hpp"
 
 #include <entities/roles/driver/OnCallDriverFacets.hpp>
+#include "entities/roles/driver/DriverFacets.hpp"
 #include "entities/roles/pedestrian/PedestrianFacets.hpp"
 
 #include "geospatial/streetdir/RailTransit.hpp"
@@ -86,7 +87,7 @@ void Person_ST::setPersonCharacteristics()
     const int defaultLowerSecs = config.personCharacteristicsParams.DEFAULT_LOWER_SECS;
     const int defaultUpperSecs = config.personCharacteristicsParams.DEFAULT_UPPER_SECS;
     
-    boost::mt19937 gen(getId() * getId());
+    RandomStream personRandom(getId(), RANDOM_BOARDING);
 
     if(!personCharacteristics.empty())
     {
@@ -95,13 +96,8 @@ void Person_ST::setPersonCharacteristics()
         {
             if (this->getAge() >= iter->second.lowerAge && this->getAge() < iter->second.upperAge)
             {
-                boost::uniform_int<> BoardingTime(iter->second.lowerSecs, iter->second.upperSecs);
-                boost::variate_generator<boost::mt19937, boost::uniform_int<int> > varBoardingTime(gen, BoardingTime);
-                boardingTimeSecs = varBoardingTime();
-
-                boost::uniform_int<> AlightingTime(iter->second.lowerSecs, iter->second.upperSecs);
-                boost::variate_generator<boost::mt19937, boost::uniform_int<int> > varAlightingTime(gen, AlightingTime);
-                alightingTimeSecs = varAlightingTime();
+                boardingTimeSecs = personRandom.uniformInt(iter->second.lowerSecs, iter->second.upperSecs);
+                alightingTimeSecs = personRandom.uniformInt(iter->second.lowerSecs, iter->second.upperSecs);
 
                 walkingSpeed = iter->second.walkSpeed;
             }
@@ -109,13 +105,8 @@ void Person_ST::setPersonCharacteristics()
     }
     else
     {
-        boost::uniform_int<> BoardingTime(defaultLowerSecs, defaultUpperSecs);
-        boost::variate_generator < boost::mt19937, boost::uniform_int<int> > varBoardingTime(gen, BoardingTime);
-        boardingTimeSecs = varBoardingTime();
-
-        boost::uniform_int<> AlightingTime(defaultLowerSecs, defaultUpperSecs);
-        boost::variate_generator < boost::mt19937, boost::uniform_int<int> > varAlightingTime(gen, AlightingTime);
-        alightingTimeSecs = varAlightingTime();
+        boardingTimeSecs = personRandom.uniformInt(defaultLowerSecs, defaultUpperSecs);
+        alightingTimeSecs = personRandom.uniformInt(defaultLowerSecs, defaultUpperSecs);
     }
 }
 
@@ -788,7 +779,7 @@ void Person_ST::assignPersonToBusStopAgent()
     
     if (busStopAgent)
     {
-        messaging::MessageBus::SendMessage(busStopAgent, MSG_WAITING_PERSON_ARRIVAL, messaging::MessageBus::MessagePtr(new ArrivalAtStopMessage(this)));
+        messaging::MessageBus::SendMessage(busStopAgent, MSG_WAITING_PERSON_ARRIVAL, messaging::MessageBus::MakeMessage<ArrivalAtStopMessage>(this));
     }
 }
 
@@ -840,6 +831,36 @@ void Person_ST::rerouteWithBlacklist(const std::vector<const Link *> &blackliste
 }
 
 
+bool Person_ST::getLanePosition(WayPoint &wayPoint, double &distance) const
+{
+    if (!currRole)
+    {
+        return false;
+    }
+
+    //Only the drivers know their lane
+    const DriverMovement *movement = dynamic_cast<const DriverMovement *> (currRole->Movement());
+
+    if (!movement || !movement->fwdDriverMovement.isDrivingPathSet() || movement->fwdDriverMovement.isDoneWithEntireRoute())
+    {
+        return false;
+    }
+
+    const DriverPathMover &pathMover = movement->fwdDriverMovement;
+
+    if (pathMover.isInIntersection())
+    {
+        wayPoint = WayPoint(pathMover.getCurrTurning());
+    }
+    else
+    {
+        wayPoint = WayPoint(pathMover.getCurrLane());
+    }
+
+    distance = pathMover.getDistCoveredOnCurrWayPt();
+    return true;
+}
+
 void Person_ST::HandleMessage(messaging::Message::MessageType type, const messaging::Message &message)
 {
     if (currRole)
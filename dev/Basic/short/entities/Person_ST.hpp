@@ -254,6 +254,16 @@ public:
      */
     virtual void rerouteWithBlacklist(const std::vector<const Link *> &blacklisted);
 
+    /**
+     * Retrieves the lane or the turning path on which the person is driving, and the distance covered on it
+     *
+     * @param wayPoint set to the current lane or turning path
+     * @param distance set to the distance covered on the current lane or turning path
+     *
+     * @return true, if the person is driving along a path
+     */
+    virtual bool getLanePosition(WayPoint &wayPoint, double &distance) const;
+
     void handleAMODArrival();
     
     void handleAMODPickup();
@@ -605,8 +605,13 @@ void sim_mob::Broker::agentUpdated(const Agent* target )
 
 void sim_mob::Broker::onAgentUpdate(sim_mob::event::EventId id, sim_mob::event::Context context, sim_mob::event::EventPublisher* sender, const UpdateEventArgs& argums)
 {
-    const Agent* target = dynamic_cast<const Agent*>(argums.GetEntity());
-    agentUpdated(target);
+    const std::vector<const Entity*>& entities = argums.GetEntities();
+    for (std::vector<const Entity*>::const_iterator it = entities.begin(); it != entities.end(); it++) {
+        const Agent* target = dynamic_cast<const Agent*>(*it);
+        if (target) {
+            agentUpdated(target);
+        }
+    }
 }
 
 
@@ -962,7 +967,7 @@ void sim_mob::Broker::setNewClientProps()
             //      the void* for different realizations of the same object may have DIFFERENT pointer values. ~Seth
             messaging::MessageBus::PublishEvent(sim_mob::event::EVT_CORE_COMMSIM_ENABLED_FOR_AGENT,
                 cHand->agent,
-                messaging::MessageBus::EventArgsPtr(new event::EventArgs())
+                messaging::MessageBus::MakeEventArgs<event::EventArgs>()
             );
         } else {
             Warn() <<"Broker::setNewClientProps() -- Client was destroyed before its weak_ptr() could be resolved.\n";
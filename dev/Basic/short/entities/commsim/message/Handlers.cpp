@@ -111,7 +111,7 @@ void sim_mob::RerouteRequestHandler::handle(boost::shared_ptr<ConnectionHandler>
 
     //Now dispatch through the MessageBus.
     sim_mob::messaging::MessageBus::PublishEvent(sim_mob::event::EVT_CORE_COMMSIM_REROUTING_REQUEST,
-        agentHandle->agent, sim_mob::messaging::MessageBus::EventArgsPtr(new sim_mob::event::ReRouteEventArgs(rmMsg.blacklistRegion))
+        agentHandle->agent, sim_mob::messaging::MessageBus::MakeEventArgs<sim_mob::event::ReRouteEventArgs>(rmMsg.blacklistRegion)
     );
 }
 
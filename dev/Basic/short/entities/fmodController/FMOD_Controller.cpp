@@ -718,7 +718,7 @@ void FMOD_Controller::handleScheduleMessage(const std::string& msg)
             {
                 //publisher.publish((event::EventId)sim_mob::FMOD::EVENT_DISPATCH_FMOD_SCHEDULES_REQUEST, (*it), FMOD_RequestEventArgs());
                 messaging::MessageBus::PublishEvent(EVENT_DISPATCH_FMOD_SCHEDULES_REQUEST, (*it),
-                                                    messaging::MessageBus::EventArgsPtr(new sim_mob::FMOD_RequestEventArgs(msgRequest.schedules)));
+                                                    messaging::MessageBus::MakeEventArgs<sim_mob::FMOD_RequestEventArgs>(msgRequest.schedules));
             }
         }
     }
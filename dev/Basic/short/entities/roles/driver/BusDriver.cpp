@@ -93,12 +93,12 @@ void BusDriver::tryBoardingPassenger(Person_ST* passenger)
         currBoardingTime += passenger->getBoardingCharacteristics();
         
         //Send boarding success message to waiting person
-        messaging::MessageBus::PostMessage(passenger, MSG_BOARD_BUS_SUCCESS, messaging::MessageBus::MessagePtr(new BusDriverMessage(this)));
+        messaging::MessageBus::PostMessage(passenger, MSG_BOARD_BUS_SUCCESS, messaging::MessageBus::MakeMessage<BusDriverMessage>(this));
     }
     else
     {
         //Send boarding failed message to the waiting person
-        messaging::MessageBus::PostMessage(passenger, MSG_BOARD_BUS_FAIL, messaging::MessageBus::MessagePtr(new BusDriverMessage(this)));
+        messaging::MessageBus::PostMessage(passenger, MSG_BOARD_BUS_FAIL, messaging::MessageBus::MakeMessage<BusDriverMessage>(this));
     }   
 }
 
@@ -109,7 +109,7 @@ void BusDriver::alightPassenger(Person_ST *passenger)
     
     currAlightingTime += passenger->getAlightingCharacteristics();
     //Send alighting message to passenger
-    messaging::MessageBus::PostMessage(passenger, MSG_ALIGHT_BUS, messaging::MessageBus::MessagePtr(new BusDriverMessage(this)));
+    messaging::MessageBus::PostMessage(passenger, MSG_ALIGHT_BUS, messaging::MessageBus::MakeMessage<BusDriverMessage>(this));
     storeAlightInfo(passenger,getBusLineId());
 }
 
@@ -163,7 +163,6 @@ void BusDriver::storeAlightInfo(Person_ST *passenger,const std::string &BusLineI
         personAlightTimeInfo.alightTime = DailyTime(currMS +
                                                     ConfigManager::GetInstance().FullConfig().simStartTime().getValue()).getStrRepr();;    //person allight time (==current time)
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_ALIGHTING,
-                                           messaging::MessageBus::MessagePtr(
-                                                   new PT_PassengerAlightInfoMessage(personAlightTimeInfo)));
+                                           messaging::MessageBus::MakeMessage<PT_PassengerAlightInfoMessage>(personAlightTimeInfo));
     }
 }
\ No newline at end of file
@@ -186,13 +186,13 @@ void BusDriverMovement::frame_tick()
             for (Person_ST *person : parentBusDriver->passengerList)
             {
                 messaging::MessageBus::PostMessage(person, MSG_WAKEUP_BUS_PAX,
-                        messaging::MessageBus::MessagePtr(new BusStopMessage(*busStopTracker, parentBusDriver)));
+                        messaging::MessageBus::MakeMessage<BusStopMessage>(*busStopTracker, parentBusDriver));
             }
 
             //Signal the bus stop agent to handle the bus arrival
             parentBusDriver->currBusStopAgent = BusStopAgent::getBusStopAgentForStop(*busStopTracker);
             messaging::MessageBus::PostMessage(parentBusDriver->currBusStopAgent, MSG_WAKEUP_WAITING_PERSON,
-                    messaging::MessageBus::MessagePtr(new BusDriverMessage(parentBusDriver)));
+                    messaging::MessageBus::MakeMessage<BusDriverMessage>(parentBusDriver));
 
             //Set default random dwell time and reset the current boarding & alighting times
             params.currentStopPoint.dwellTime = Utils::nRandom(10, 2);
@@ -240,7 +240,7 @@ void BusDriverMovement::frame_tick()
             busArrivalInfo.stopNo = (*busStopTracker)->getStopCode();
 
             messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_BUS_ARRIVAL,
-                    messaging::MessageBus::MessagePtr(new PT_ArrivalTimeMessage(busArrivalInfo)));
+                    messaging::MessageBus::MakeMessage<PT_ArrivalTimeMessage>(busArrivalInfo));
             
             break;
         }
@@ -1324,6 +1324,11 @@ Vehicle* DriverMovement::initializePath(bool createVehicle)
             bool useInSimulationTT = parentDriver->getParent()->usesInSimulationTravelTime();
             path = PrivateTrafficRouteChoice::getInstance()->getPath(*(parentDriver->getParent()->currSubTrip), false, nullptr, useInSimulationTT);
         }
+        else if (parentDriver->getParent()->usesInSimulationTravelTime())
+        {
+            const StreetDirectory& stdir = StreetDirectory::Instance();
+            path = stdir.SearchInSimulationDrivingPath<Node, Node>(*(parentDriver->origin), *(parentDriver->destination));
+        }
         else
         {
             const StreetDirectory& stdir = StreetDirectory::Instance();
@@ -1624,7 +1629,14 @@ void DriverMovement::reRouteToDestination(DriverUpdateParams &params, const Lane
             if (!isPathFound || !ConfigManager::GetInstance().FullConfig().PathSetMode())
             {
                 const StreetDirectory& stdir = StreetDirectory::Instance();
-                path = stdir.SearchShortestDrivingPath<sim_mob::Link, sim_mob::Node>(*nextLink, *(parentDriver->getParent()->destNode.node));
+                if (parentDriver->getParent()->usesInSimulationTravelTime())
+                {
+                    path = stdir.SearchInSimulationDrivingPath<sim_mob::Link, sim_mob::Node>(*nextLink, *(parentDriver->getParent()->destNode.node));
+                }
+                else
+                {
+                    path = stdir.SearchShortestDrivingPath<sim_mob::Link, sim_mob::Node>(*nextLink, *(parentDriver->getParent()->destNode.node));
+                }
 
                 if (path.empty())
                 {
@@ -2106,7 +2118,7 @@ double DriverMovement::getAngle() const
 void DriverMovement::updateNearbyAgents()
 {
     DriverUpdateParams& params = parentDriver->getParams();
-    vector<const Agent *> nearbyAgentsList;
+    nearbyAgentsList.clear();
 
     if (parentDriver->getCurrPosition().getX() > 0 && parentDriver->getCurrPosition().getY() > 0)
     {
@@ -2116,13 +2128,13 @@ void DriverMovement::updateNearbyAgents()
         //th aura manager
         if(fwdDriverMovement.isInIntersection())
         {
-            nearbyAgentsList = AuraManager::instance().nearbyAgents(parentDriver->getCurrPosition(), WayPoint(fwdDriverMovement.getCurrTurning()),
-                                                                    distanceInFront, distanceBehind, parentDriver->getParent());
+            AuraManager::instance().nearbyAgents(parentDriver->getCurrPosition(), WayPoint(fwdDriverMovement.getCurrTurning()),
+                                                 distanceInFront, distanceBehind, parentDriver->getParent(), nearbyAgentsList);
         }
         else
         {
-            nearbyAgentsList = AuraManager::instance().nearbyAgents(parentDriver->getCurrPosition(), WayPoint(fwdDriverMovement.getCurrLane()),
-                                                                    distanceInFront, distanceBehind, parentDriver->getParent());
+            AuraManager::instance().nearbyAgents(parentDriver->getCurrPosition(), WayPoint(fwdDriverMovement.getCurrLane()),
+                                                 distanceInFront, distanceBehind, parentDriver->getParent(), nearbyAgentsList);
         }       
     }
     else
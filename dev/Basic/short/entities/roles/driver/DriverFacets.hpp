@@ -105,6 +105,9 @@ private:
      */
     unsigned int targetLaneIndex;
 
+    /**The agents near the driver, found by the aura manager. Kept to reuse its storage every tick*/
+    std::vector<const Agent *> nearbyAgentsList;
+
     /**Map of road segment vs the aggregate vehicle count over the collection interval*/
     static map<const RoadSegment *, unsigned long> rdSegDensityMap;
 
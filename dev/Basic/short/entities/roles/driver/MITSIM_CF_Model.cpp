@@ -4,8 +4,6 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/trim.hpp>
-#include <boost/nondet_random.hpp>
-#include <boost/random.hpp>
 #include <limits>
 #include <cmath>
 
@@ -13,6 +11,7 @@
 #include "entities/roles/driver/models/CarFollowModel.hpp"
 #include "entities/vehicle/Vehicle.hpp"
 #include "util/Math.hpp"
+#include "util/RandomService.hpp"
 #include "util/Utils.hpp"
 
 using std::numeric_limits;
@@ -145,10 +144,6 @@ void MITSIM_CF_Model::readDriverParameters(DriverUpdateParams &params)
 
     parameterMgr->param(modelName, "driver_signal_perception_distance", signalVisibilityDist, 75.0);
 
-    boost::random_device seed_gen;
-    long int seed = seed_gen();
-    updateSizeRNG = boost::mt19937(seed);
-
     calcUpdateStepSizes();
 
     //Initialise step size, i = 3 is for stopped vehicle
@@ -1571,9 +1566,7 @@ double MITSIM_CF_Model::sampleFromNormalDistribution(UpdateStepSizeParam &stepSi
         return 0;
     }
 
-    boost::lognormal_distribution<double> nor(stepSizeParams.mean, stepSizeParams.stdev);
-    boost::variate_generator<boost::mt19937, boost::lognormal_distribution<double> > dice(updateSizeRNG, nor);
-    double v = dice();
+    double v = RandomService::current().lognormal(stepSizeParams.mean, stepSizeParams.stdev);
 
     if (v < stepSizeParams.lower)
     {
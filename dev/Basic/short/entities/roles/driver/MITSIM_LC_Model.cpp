@@ -2,7 +2,6 @@
 //Licensed under the terms of the MIT License, as described in the file:
 //   license.txt   (http://opensource.org/licenses/MIT)
 
-#include <boost/random.hpp>
 #include <limits>
 
 #include "Driver.hpp"
@@ -11,6 +10,7 @@
 #include "entities/vehicle/Vehicle.hpp"
 #include "geospatial/network/LaneConnector.hpp"
 #include "util/Math.hpp"
+#include "util/RandomService.hpp"
 #include "util/Utils.hpp"
 #include "geospatial/network/RoadNetwork.hpp"
 
@@ -143,9 +143,7 @@ double MITSIM_LC_Model::calcCriticalGapKaziModel(DriverUpdateParams &params, int
     double dvPositive = (diffInSpeed > 0) ? diffInSpeed : 0.0;
     double gap = b[0] + b[1] * rem_dist_impact + b[2] * diffInSpeed + b[3] * dvNegative + b[4] * dvPositive;
 
-    boost::normal_distribution<> nrand(0, b[4]);
-    boost::variate_generator< boost::mt19937, boost::normal_distribution<> > normal(params.gen, nrand);
-    double u = gap + normal();
+    double u = gap + RandomService::current().normal(0, b[4]);
     double criGap = 0;
 
     if (u < -4.0)
@@ -155,7 +155,7 @@ void OnCallDriver::sendStatusMessage()
     for(auto ctrlr : subscribedControllers)
     {
         MessageBus::PostMessage(ctrlr, MSG_DRIVER_SCHEDULE_STATUS,
-                                MessageBus::MessagePtr(new DriverScheduleStatusMsg(parent)));
+                                MessageBus::MakeMessage<DriverScheduleStatusMsg>(parent));
     }
 }
 
@@ -188,7 +188,7 @@ void OnCallDriver::endShift()
     for(auto ctrlr : subscribedControllers)
     {
         MessageBus::PostMessage(ctrlr, MSG_DRIVER_SHIFT_END,
-                                MessageBus::MessagePtr(new DriverShiftCompleted(parent)));
+                                MessageBus::MakeMessage<DriverShiftCompleted>(parent));
     }
 
     isWaitingForUnsubscribeAck = true;
@@ -221,7 +221,7 @@ void OnCallDriver::subscribeToController()
     }
 #endif
 
-    MessageBus::PostMessage(*it, MSG_DRIVER_SUBSCRIBE, MessageBus::MessagePtr(new DriverSubscribeMessage(parent)));
+    MessageBus::PostMessage(*it, MSG_DRIVER_SUBSCRIBE, MessageBus::MakeMessage<DriverSubscribeMessage>(parent));
 
 #ifndef NDEBUG
         ControllerLog() << "OnCallDriver " << parent->getDatabaseId()
@@ -256,7 +256,7 @@ void OnCallDriver::sendAvailableMessage()
     for(auto ctrlr : subscribedControllers)
     {
         MessageBus::PostMessage(ctrlr, MSG_DRIVER_AVAILABLE,
-                                MessageBus::MessagePtr(new DriverAvailableMessage(parent)));
+                                MessageBus::MakeMessage<DriverAvailableMessage>(parent));
     }
 }
 
@@ -265,7 +265,7 @@ void OnCallDriver::sendWakeUpShiftEndMsg()
 {
     unsigned int timeToShiftEnd = (parent->getServiceVehicle().endTime * 1000) - parent->currTick.ms();
     unsigned int tick = ConfigManager::GetInstance().FullConfig().baseGranMS();
-    MessageBus::PostMessage(OnCallDriver::getParent(), MSG_WAKEUP_SHIFT_END, MessageBus::MessagePtr(new PersonMessage(parent)),
+    MessageBus::PostMessage(OnCallDriver::getParent(), MSG_WAKEUP_SHIFT_END, MessageBus::MakeMessage<PersonMessage>(parent),
                             false, timeToShiftEnd / tick);
 }
 void OnCallDriver::collectTravelTime(Person_ST* person)
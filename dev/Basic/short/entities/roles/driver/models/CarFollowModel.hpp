@@ -147,9 +147,6 @@ private:
     /**Defines how close the lead vehicle needs to be in order for the following vehicle to brake (in meter)*/
     double visibilityDistance;
 
-    /**Random number generator for calculating update step sizes*/
-    boost::mt19937 updateSizeRNG;
-
     /**The car following parameters*/
     CarFollowingParams CF_parameters[2];
 
@@ -73,7 +73,7 @@ void Passenger::makeAlightingDecision(const BusStop *nextStop, BusDriver *driver
         setAlightVehicle(true);
         
         //Send alighting message to the bus driver
-        messaging::MessageBus::PostMessage(driver->getParent(), MSG_ALIGHT_BUS, messaging::MessageBus::MessagePtr(new PersonMessage(parent)));
+        messaging::MessageBus::PostMessage(driver->getParent(), MSG_ALIGHT_BUS, messaging::MessageBus::MakeMessage<PersonMessage>(parent));
     }
 }
 
@@ -137,7 +137,7 @@ void Passenger::collectTravelTime()
     }
 
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_TRAVEL_TIME,
-            messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+            messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 }
 
 void Passenger::HandleParentMessage(messaging::Message::MessageType type, const messaging::Message& message)
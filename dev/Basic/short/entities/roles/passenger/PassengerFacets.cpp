@@ -66,7 +66,7 @@ void PassengerMovement::frame_init()
         parentPassenger->setTravelTime(totalTimeToComplete);
         
         unsigned int tick = ConfigManager::GetInstance().FullConfig().baseGranMS();
-        MessageBus::PostMessage(parent, MSG_WAKEUP_MRT_PAX, MessageBus::MessagePtr(new PersonMessage(parent)), false,
+        MessageBus::PostMessage(parent, MSG_WAKEUP_MRT_PAX, MessageBus::MakeMessage<PersonMessage>(parent), false,
                 totalTimeToComplete / tick);
     }
 
@@ -70,7 +70,7 @@ void Pedestrian::collectTravelTime()
         personTravelTime.arrivalTime = DailyTime(activity->getArrivalTime()).getStrRepr();
         
         messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
     }
     
     personTravelTime.tripStartPoint = (*(parent->currTripChainItem))->startLocationId;
@@ -85,5 +85,5 @@ void Pedestrian::collectTravelTime()
     personTravelTime.arrivalTime = DailyTime(parent->getRole()->getArrivalTime()).getStrRepr();
     
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-            STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+            STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 }
@@ -64,7 +64,7 @@ void WaitBusActivity::collectTravelTime()
     personTravelTime.arrivalTime = DailyTime(parent->getRole()->getArrivalTime()).getStrRepr();
     
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(),
-                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MessagePtr(new PersonTravelTimeMessage(personTravelTime)), true);
+                    STORE_PERSON_TRAVEL_TIME, messaging::MessageBus::MakeMessage<PersonTravelTimeMessage>(personTravelTime), true);
 }
 
 void WaitBusActivity::incrementDeniedBoardingCount()
@@ -133,7 +133,7 @@ void WaitBusActivity::HandleParentMessage(messaging::Message::MessageType type,
         activityState = WAITBUS_STATE_WAIT_COMPLETE;
         storeWaitingTime(busDriver->getBusLineId());
         messaging::MessageBus::PostMessage(busDriver->getCurrBusStopAgent(), MSG_BOARD_BUS_SUCCESS,
-                messaging::MessageBus::MessagePtr(new PersonMessage(parent)));
+                messaging::MessageBus::MakeMessage<PersonMessage>(parent));
         break;
     }
 
@@ -165,7 +165,7 @@ void WaitBusActivity::storeWaitingTime(const std::string &busLine)
     personWaitInfo.currentTime = DailyTime(currMS + ConfigManager::GetInstance().FullConfig().simStartTime().getValue()).getStrRepr();
     
     messaging::MessageBus::PostMessage(PT_Statistics::getInstance(), STORE_PERSON_WAITING,
-            messaging::MessageBus::MessagePtr(new PersonWaitingTimeMessage(personWaitInfo)));
+            messaging::MessageBus::MakeMessage<PersonWaitingTimeMessage>(personWaitInfo));
 }
 
 vector<BufferedBase *> WaitBusActivity::getSubscriptionParams()
@@ -53,7 +53,7 @@ void WaitBusActivityMovement::frame_tick()
         //Waiting person has decided to board the bus, send attempting to board message to bus driver
         parentWaitBusActivity->activityState = WAITBUS_STATE_ATTEMPTED_BOARD_BUS;
         messaging::MessageBus::PostMessage(parentWaitBusActivity->busDriver->getParent(), MSG_ATTEMPT_BOARD_BUS,
-                messaging::MessageBus::MessagePtr(new PersonMessage(parentWaitBusActivity->getParent())));              
+                messaging::MessageBus::MakeMessage<PersonMessage>(parentWaitBusActivity->getParent()));              
         break;
         
     case WAITBUS_STATE_ATTEMPTED_BOARD_BUS:
@@ -18,6 +18,8 @@
  * \author Xu Yan
  */
 
+#include <sstream>
+#include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread/thread.hpp>
 
@@ -44,12 +46,15 @@
 #include "entities/roles/pedestrian/Pedestrian.hpp"
 #include "entities/fmodController/FMOD_Controller.hpp"
 #include "geospatial/network/NetworkLoader.hpp"
+#include "geospatial/streetdir/StreetDirectory.hpp"
 #include "logging/ControllerLog.hpp"
 #include "logging/Log.hpp"
 #include "network/CommunicationManager.hpp"
 #include "network/ControlManager.hpp"
 #include "partitions/ParitionDebugOutput.hpp"
 #include "partitions/ShortTermBoundaryProcessor.hpp"
+#include "spatial_trees/AuraComparison.hpp"
+#include "util/SlabPool.hpp"
 #include "util/StateSwitcher.hpp"
 #include "util/Utils.hpp"
 #include "workers/WorkGroupManager.hpp"
@@ -162,6 +167,20 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
     Print() << "\nLoading the configuration files: " << configFileName << ", " << shortConfigFile << "..." << std::endl;
     ExpandShortTermConfigFile expand(stCfg, ConfigManager::GetInstanceRW().FullConfig(), Agent::all_agents, Agent::pending_agents);
 
+    //Replay a trace of agent positions through the aura manager implementations, instead of simulating
+    if (!stCfg.auraManagerReplayFile.empty())
+    {
+        std::vector<AuraFrame> frames;
+        AuraTrace::readTrace(stCfg.auraManagerReplayFile, frames);
+        AuraComparison comparison(&AuraComparison::resolveNetworkWayPoint, stCfg.personWorkGroupSize());
+        AuraComparison::Report report = comparison.replay(frames);
+
+        std::ostringstream comparisonReport;
+        report.print(comparisonReport);
+        Print() << comparisonReport.str();
+        return report.matches();
+    }
+
     if (config.PathSetMode())
     {
         //Initialise path-set manager
@@ -206,6 +225,10 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
     //TODO: WorkGroup scope currently does nothing. We need to re-enable WorkGroup deletion at some later point. ~Seth
     WorkGroupManager wgMgr;
     wgMgr.setSingleThreadMode(false);
+    if (stCfg.workers.spinBarrier)
+    {
+        wgMgr.setBarrierStrategy(FlexiBarrier::SPIN_THEN_BLOCK, stCfg.workers.barrierSpinCount);
+    }
 
     //Work Group specifications
     WorkGroup* personWorkers = wgMgr.newWorkGroup(stCfg.personWorkGroupSize(), config.totalRuntimeTicks, stCfg.granPersonTicks, &AuraManager::instance(), partMgr);
@@ -219,7 +242,12 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
     WorkGroup* communicationWorkers = wgMgr.newWorkGroup(stCfg.commWorkGroupSize(), config.totalRuntimeTicks, stCfg.granCommunicationTicks);
 
     //Initialise the aura manager
-    AuraManager::instance().init(stCfg.aura_manager_impl());
+    AuraManager::instance().init(stCfg.aura_manager_impl(), stCfg.personWorkGroupSize());
+
+    if (!stCfg.auraManagerTraceFile.empty())
+    {
+        AuraManager::instance().recordTrace(stCfg.auraManagerTraceFile);
+    }
 
     //Initialise all work groups (this creates barriers, and locks down creation of new groups).
     wgMgr.initAllGroups();
@@ -308,6 +336,12 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
 
     Print() << "Simulating...\n";
 
+    //Route the InSimulation queries with the link travel times of the interval which just ended
+    if (config.simulation.travelTimeRefreshInterval > 0)
+    {
+        wgMgr.setFlipBuffersCallback(boost::bind(&StreetDirectory::refreshInSimulationTravelTimesAfterTick, &StreetDirectory::Instance(), _1));
+    }
+
     //Start work groups and all threads.
     wgMgr.startAllWorkGroups();
 
@@ -415,6 +449,10 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
     Print() << "Time required for initialisation [Loading configuration, network, demand ...]: "
             << DailyTime((uint32_t) loop_start_offset).getStrRepr() << std::endl;
 
+    std::ostringstream auraStats;
+    AuraManager::instance().printUpdateStats(auraStats);
+    Print() << auraStats.str();
+
     if(config.numPathNotFound > 0)
     {
         Print() << "\nPersons not simulated as the path was not found [Refer to warn.log for more details]: "
@@ -424,6 +462,10 @@ bool performMain(const std::string& configFileName, const std::string& shortConf
     Print() << "\nNumber of trips/activities [demand] loaded: " << config.numTripsLoaded
             << "\nNumber of trips/activities [demand] completed: " << config.numTripsCompleted << "\n";
 
+    std::ostringstream poolStats;
+    SlabPool::printStats(poolStats);
+    Print() << poolStats.str();
+
     size_t numActivities = 0, numBusDriver = 0, numCarPassenger = 0, numDriver = 0, numPassenger = 0, numPedestrian = 0;
     size_t numPersons = 0, numPrivateBusPassenger = 0, numTrainPassenger = 0, numWaitBus = 0, numTaxiPassenger=0;
     size_t numTravelPedestrian = 0, numWaitTaxi = 0;